@@ -996,7 +996,8 @@ int engine_free(Engine *engine, aboolean destroyWindow)
 
 	// construct and log function profiling report
 
-	pfs_buildReport(asgard_getPfs(), &pfsReport, &pfsReportLength);
+	pfs_buildReport(asgard_getPfs(), PFS_REPORT_FLAT, &pfsReport,
+			&pfsReportLength);
 
 	log_logf(&engine->log, LOG_LEVEL_INFO, "%s", pfsReport);
 
@@ -450,7 +450,8 @@ int main(int argc, char *argv[])
 
 	// construct and log function profiling report
 
-	pfs_buildReport(asgard_getPfs(), &pfsReport, &pfsReportLength);
+	pfs_buildReport(asgard_getPfs(), PFS_REPORT_FLAT, &pfsReport,
+			&pfsReportLength);
 
 	log_logf(&state.log, LOG_LEVEL_INFO, "%s", pfsReport);
 
@@ -36,10 +36,15 @@ extern "C" {
 #include <time.h>
 #include <unistd.h>
 
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 //#include <sys/utsname.h>
 
 #include <arpa/inet.h>
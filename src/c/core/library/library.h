@@ -27,6 +27,7 @@ extern "C" {
 
 // library system components
 
+#include "core/library/system/atomic.h"
 #include "core/library/system/file.h"
 #include "core/library/system/dir.h"
 #include "core/library/system/tmf.h"
@@ -36,9 +37,13 @@ extern "C" {
 #include "core/library/types/arraylist.h"
 #include "core/library/types/bptree.h"
 #include "core/library/types/fifostack.h"
+#include "core/library/types/histogram.h"
 #include "core/library/types/integer.h"
+#include "core/library/types/posting.h"
 #include "core/library/types/intersect.h"
+#include "core/library/types/json_reader.h"
 #include "core/library/types/json.h"
+#include "core/library/types/json_writer.h"
 #include "core/library/types/lfbc.h"
 #include "core/library/types/managed_index.h"
 #include "core/library/types/range_index.h"
@@ -16,12 +16,58 @@
 #include "core/library/network/protocols/http.h"
 
 
+// define networking library HTTP protocol private constants
+
+#define HTTP_MAXIMUM_URL_LENGTH						65536
+
+#define HTTP_MAXIMUM_CHUNK_LINE_LENGTH				1024
+
+#define HTTP_CONTENT_LENGTH_LINE_LENGTH				64
+
+#define HTTP_FILE_CACHE_MAXIMUM_LENGTH				256
+
+
+// define networking library HTTP protocol private data types
+
+typedef struct _HttpCachedFile {
+	aboolean isRetired;
+	int references;
+	alint length;
+	double modifiedTime;
+	FileHandle handle;
+} HttpCachedFile;
+
+
 // declare networking library HTTP protocol private functions
 
 static char *buildRandomTempFilename(HttpProtocol *protocol);
 
 static char *getFilenameFromHeader(char *buffer, int length, int offset);
 
+static int findLineEnd(char *buffer, int length, int offset);
+
+static int findHeaderEnd(char *buffer, int length);
+
+static int parseChunkLength(char *buffer, int length);
+
+static aboolean isKeepAliveRequest(char *payload, int payloadLength);
+
+static int frameResponse(char *payload, int payloadLength, alint bodyLength,
+		char *contentLength);
+
+static void freeCachedFile(void *argument, void *memory);
+
+static HttpCachedFile *acquireCachedFile(HttpProtocol *protocol,
+		char *filename);
+
+static void releaseCachedFile(HttpProtocol *protocol, HttpCachedFile *file);
+
+static int writePayloadToTempFile(HttpProtocol *protocol, char **value,
+		int *valueLength, int headerLength);
+
+static HttpTransactionManagerReceive *newReceive(Socket *socket, int sd,
+		char *payload, int payloadLength);
+
 
 // define networking library HTTP protocol private functions
 
@@ -62,6 +108,348 @@ static char *getFilenameFromHeader(char *buffer, int length, int offset)
 		result[nn] = buffer[ii];
 	}
 
+	result[nn] = '\0';
+
+	return result;
+}
+
+
+static int findLineEnd(char *buffer, int length, int offset)
+{
+	int ii = 0;
+
+	for(ii = offset; ii < (length - 1); ii++) {
+		if(((unsigned int)buffer[ii] == 13) &&
+				((unsigned int)buffer[(ii + 1)] == 10)) {
+			return ii;
+		}
+	}
+
+	return -1;
+}
+
+static int findHeaderEnd(char *buffer, int length)
+{
+	int ii = 0;
+
+	for(ii = 0; ii < (length - 3); ii++) {
+		if(((unsigned int)buffer[ii] == 13) &&
+				((unsigned int)buffer[(ii + 1)] == 10) &&
+				((unsigned int)buffer[(ii + 2)] == 13) &&
+				((unsigned int)buffer[(ii + 3)] == 10)) {
+			return ii;
+		}
+	}
+
+	return -1;
+}
+
+static int parseChunkLength(char *buffer, int length)
+{
+	int ii = 0;
+	int digit = 0;
+	int result = 0;
+
+	for(ii = 0; ii < length; ii++) {
+		if((buffer[ii] >= '0') && (buffer[ii] <= '9')) {
+			digit = (int)(buffer[ii] - '0');
+		}
+		else if((buffer[ii] >= 'a') && (buffer[ii] <= 'f')) {
+			digit = (int)((buffer[ii] - 'a') + 10);
+		}
+		else if((buffer[ii] >= 'A') && (buffer[ii] <= 'F')) {
+			digit = (int)((buffer[ii] - 'A') + 10);
+		}
+		else if((buffer[ii] == ';') || (buffer[ii] == ' ') ||
+				(buffer[ii] == '\t')) {
+			break;
+		}
+		else {
+			return -1;
+		}
+
+		if((ii >= 7) || (result > (0x7fffffff >> 4))) {
+			return -1;
+		}
+
+		result = ((result << 4) | digit);
+	}
+
+	if(ii == 0) {
+		return -1;
+	}
+
+	return result;
+}
+
+static aboolean isKeepAliveRequest(char *payload, int payloadLength)
+{
+	aboolean result = afalse;
+	int lineEnd = 0;
+	int headerLength = 0;
+	char *ptr = NULL;
+
+	if((lineEnd = findLineEnd(payload, payloadLength, 0)) < 8) {
+		return afalse;
+	}
+
+	// HTTP/1.1 connections persist unless the client asks to close them,
+	// earlier versions only when the client asks to keep them alive
+
+	if(!strncmp((payload + (lineEnd - 8)), "HTTP/1.1", 8)) {
+		result = atrue;
+	}
+
+	if((headerLength = findHeaderEnd(payload, payloadLength)) < 0) {
+		headerLength = payloadLength;
+	}
+
+	if((ptr = strncasestr(payload, headerLength, "\nConnection:",
+					12)) == NULL) {
+		return result;
+	}
+
+	ptr += 12;
+
+	if((lineEnd = findLineEnd(payload, payloadLength,
+					(int)(ptr - payload))) < 0) {
+		lineEnd = headerLength;
+	}
+
+	if(strncasestr(ptr, (int)((payload + lineEnd) - ptr), "close",
+				5) != NULL) {
+		result = afalse;
+	}
+	else if(strncasestr(ptr, (int)((payload + lineEnd) - ptr),
+				"keep-alive", 10) != NULL) {
+		result = atrue;
+	}
+
+	return result;
+}
+
+static int frameResponse(char *payload, int payloadLength, alint bodyLength,
+		char *contentLength)
+{
+	int headerEnd = 0;
+
+	// only responses with a status line and without their own framing
+	// are given a content length
+
+	if((payloadLength < 5) || (strncmp(payload, "HTTP/", 5))) {
+		return -1;
+	}
+
+	if((headerEnd = findHeaderEnd(payload, payloadLength)) < 0) {
+		return -1;
+	}
+
+	if((strncasestr(payload, headerEnd, "Content-Length:", 15) != NULL) ||
+			(strncasestr(payload, headerEnd, "Transfer-Encoding:",
+						 18) != NULL)) {
+		return -1;
+	}
+
+	snprintf(contentLength, HTTP_CONTENT_LENGTH_LINE_LENGTH,
+			"Content-Length: %lli\r\n",
+			((alint)(payloadLength - (headerEnd + 4)) + bodyLength));
+
+	// the header line belongs after the last header, ahead of the blank line
+
+	return (headerEnd + 2);
+}
+
+static void freeCachedFile(void *argument, void *memory)
+{
+	HttpCachedFile *file = NULL;
+
+	// called with the protocol mutex held, as a file leaves the cache, and
+	// only closed once the last in-flight response has released it
+
+	file = (HttpCachedFile *)memory;
+
+	file->isRetired = atrue;
+
+	if(file->references < 1) {
+		file_free(&file->handle);
+		free(file);
+	}
+}
+
+static HttpCachedFile *acquireCachedFile(HttpProtocol *protocol,
+		char *filename)
+{
+	int filenameLength = 0;
+	alint length = 0;
+	double modifiedTime = 0.0;
+
+	HttpCachedFile *result = NULL;
+
+	if((system_fileLength(filename, &length) < 0) ||
+			(system_fileModifiedTime(filename, &modifiedTime) < 0)) {
+		return NULL;
+	}
+
+	filenameLength = strlen(filename);
+
+	mutex_lock(&protocol->mutex);
+
+	if(bptree_get(&protocol->fileCache, filename, filenameLength,
+				((void *)&result)) == 0) {
+		if((result->length == length) &&
+				(result->modifiedTime == modifiedTime)) {
+			result->references += 1;
+			mutex_unlock(&protocol->mutex);
+			return result;
+		}
+
+		// the file changed on disk, so retire the stale handle
+
+		bptree_remove(&protocol->fileCache, filename, filenameLength);
+
+		protocol->fileCacheLength -= 1;
+	}
+
+	result = (HttpCachedFile *)malloc(sizeof(HttpCachedFile));
+
+	result->isRetired = afalse;
+	result->references = 1;
+	result->length = length;
+	result->modifiedTime = modifiedTime;
+
+	if(file_init(&result->handle, filename, "rb", 0) < 0) {
+		mutex_unlock(&protocol->mutex);
+		file_free(&result->handle);
+		free(result);
+		return NULL;
+	}
+
+	// once the cache is full, further files are opened for a single response
+
+	if((protocol->fileCacheLength < HTTP_FILE_CACHE_MAXIMUM_LENGTH) &&
+			(bptree_put(&protocol->fileCache, filename, filenameLength,
+						(void *)result) == 0)) {
+		protocol->fileCacheLength += 1;
+	}
+	else {
+		result->isRetired = atrue;
+	}
+
+	mutex_unlock(&protocol->mutex);
+
+	return result;
+}
+
+static void releaseCachedFile(HttpProtocol *protocol, HttpCachedFile *file)
+{
+	mutex_lock(&protocol->mutex);
+
+	file->references -= 1;
+
+	if(file->isRetired) {
+		freeCachedFile(protocol, file);
+	}
+
+	mutex_unlock(&protocol->mutex);
+}
+
+static int writePayloadToTempFile(HttpProtocol *protocol, char **value,
+		int *valueLength, int headerLength)
+{
+	int rc = 0;
+	int length = 0;
+	int payloadLength = 0;
+	char *result = NULL;
+	char *filename = NULL;
+	char *errorMessage = NULL;
+
+	FileHandle fh;
+
+	payloadLength = (*valueLength - headerLength);
+
+	mutex_lock(&protocol->mutex);
+
+	if((alint)payloadLength >= (protocol->tempFileSpaceAllowedBytes -
+				protocol->tempFileSpaceInUseBytes)) {
+		mutex_unlock(&protocol->mutex);
+		fprintf(stderr, "[%s():%i] error - payload length %i is greater "
+				"than available temp-file space %0.0f.\n",
+				__FUNCTION__, __LINE__, payloadLength,
+				(double)(protocol->tempFileSpaceAllowedBytes -
+					protocol->tempFileSpaceInUseBytes));
+		return -1;
+	}
+
+	mutex_unlock(&protocol->mutex);
+
+	filename = buildRandomTempFilename(protocol);
+
+	if(((rc = file_init(&fh, filename, "w+b", 0)) < 0) ||
+			((rc = file_write(&fh, (*value + headerLength),
+							payloadLength)) < 0)) {
+		errorMessage = file_getErrorMessage(&fh, rc);
+		fprintf(stderr, "[%s():%i] error - failed to write temp file '%s' "
+				"with '%s'.\n", __FUNCTION__, __LINE__, filename,
+				errorMessage);
+		system_fileDelete(filename);
+		free(filename);
+		free(errorMessage);
+		file_free(&fh);
+		return -1;
+	}
+
+	file_free(&fh);
+
+	length = (headerLength + strlen(filename) + 32);
+	result = (char *)malloc(sizeof(char) * length);
+
+	memcpy(result, *value, headerLength);
+
+	length = (headerLength + snprintf((result + headerLength),
+				(length - headerLength - 1),
+				"Content-in-file: %s\r\n\r\n", filename));
+
+	free(*value);
+	free(filename);
+
+	*value = result;
+	*valueLength = length;
+
+	mutex_lock(&protocol->mutex);
+
+	protocol->tempFileSpaceInUseBytes += (alint)payloadLength;
+
+	mutex_unlock(&protocol->mutex);
+
+	return 0;
+}
+
+static HttpTransactionManagerReceive *newReceive(Socket *socket, int sd,
+		char *payload, int payloadLength)
+{
+	char *ptr = NULL;
+
+	HttpTransactionManagerReceive *result = NULL;
+
+	result = (HttpTransactionManagerReceive *)malloc(
+			sizeof(HttpTransactionManagerReceive));
+
+	result->isContentInFile = afalse;
+	result->isKeepAlive = isKeepAliveRequest(payload, payloadLength);
+	result->payloadLength = payloadLength;
+	result->ipAddress = NULL;
+	result->contentFilename = NULL;
+	result->payload = payload;
+
+	socket_getPeerName(socket, sd, &(result->ipAddress));
+
+	if((ptr = strncasestr(result->payload, result->payloadLength,
+					"Content-in-file:", 16)) != NULL) {
+		result->isContentInFile = atrue;
+		result->contentFilename = getFilenameFromHeader(result->payload,
+				result->payloadLength, (int)((ptr - result->payload) + 17));
+	}
+
 	return result;
 }
 
@@ -86,10 +474,15 @@ void http_protocol_init(HttpProtocol *protocol, aboolean isTempFileMode,
 	mutex_lock(&protocol->mutex);
 
 	protocol->isTempFileMode = isTempFileMode;
+	protocol->idleTimeoutSeconds = HTTP_DEFAULT_IDLE_TIMEOUT_SECONDS;
 	protocol->tempFileThresholdBytes = tempFileThresholdBytes;
 	protocol->tempFileSpaceAllowedBytes = tempFileSpaceAllowedBytes;
 	protocol->tempFileSpaceInUseBytes = tempFileSpaceInUseBytes;
 
+	bptree_init(&protocol->fileCache);
+	bptree_setComplexFreeFunction(&protocol->fileCache, protocol,
+			freeCachedFile);
+
 	if(tempFileBasePath != NULL) {
 		protocol->tempFileBasePath = strdup(tempFileBasePath);
 	}
@@ -113,6 +506,8 @@ void http_protocol_free(HttpProtocol *protocol)
 		free(protocol->tempFileBasePath);
 	}
 
+	bptree_free(&protocol->fileCache);
+
 	mutex_unlock(&protocol->mutex);
 
 	mutex_free(&protocol->mutex);
@@ -163,6 +558,22 @@ int http_protocol_freeTempFile(HttpProtocol *protocol, char *filename)
 	return 0;
 }
 
+int http_protocol_setIdleTimeout(HttpProtocol *protocol, double seconds)
+{
+	if((protocol == NULL) || (seconds <= 0.0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&protocol->mutex);
+
+	protocol->idleTimeoutSeconds = seconds;
+
+	mutex_unlock(&protocol->mutex);
+
+	return 0;
+}
+
 int http_protocol_send(void *context, Socket *socket, int sd, char *value,
 		int valueLength)
 {
@@ -223,14 +634,24 @@ char *http_protocol_receive(void *context, Socket *socket, int sd,
 	value = (char *)malloc(sizeof(char) * valueLength);
 
 	timer = time_getTimeMus();
-	timeout = 5.0;
+
+	if(protocol != NULL) {
+		timeout = protocol->idleTimeoutSeconds;
+	}
+	else {
+		timeout = HTTP_DEFAULT_IDLE_TIMEOUT_SECONDS;
+	}
 
 	memset(chunk, 0, (int)sizeof(chunk));
 
 	do {
 		rc = socket_receive(socket, sd, chunk, 1, timeout);
 
-		while((rc == 0) && (counter < 3)) {
+		// a persistent connection may sit idle for the full timeout before
+		// its next message, or be closed by the peer, so only retry once a
+		// message has started to arrive
+
+		while((rc == 0) && (!firstTime) && (counter < 3)) {
 			time_usleep(16384);
 
 			rc = socket_receive(socket, sd, chunk, 1, timeout);
@@ -314,6 +735,13 @@ char *http_protocol_receive(void *context, Socket *socket, int sd,
 		free(value);
 		return NULL;
 	}
+	else if(valueRef == 0) {
+		// the connection was closed, or went idle, between messages
+
+		value[0] = '\0';
+
+		return value;
+	}
 	else if(valueRef < 4) {
 		fprintf(stderr, "[%s():%i] error(%i) - message too small to be HTTP "
 				"after reading %i bytes "
@@ -595,12 +1023,215 @@ char *http_protocol_receive(void *context, Socket *socket, int sd,
 	return value;
 }
 
+int http_protocol_receiveBuffer(void *context, char *buffer, int bufferLength,
+		char **value, int *valueLength)
+{
+	aboolean foundHeader = afalse;
+	aboolean foundHeaderProtocol = afalse;
+	int ii = 0;
+	int ref = 0;
+	int offset = 0;
+	int lineEnd = 0;
+	int chunkLength = 0;
+	int headerLength = 0;
+	int resultLength = 0;
+	alint payloadLength = 0;
+	unsigned int byteValue = (unsigned int)0;
+	char *ptr = NULL;
+	char *result = NULL;
+
+	HttpProtocol *protocol = NULL;
+
+	if((buffer == NULL) || (bufferLength < 0) || (value == NULL) ||
+			(valueLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	protocol = (HttpProtocol *)context;
+
+	*value = NULL;
+	*valueLength = 0;
+
+	// skip any line breaks left between messages
+
+	while((offset < bufferLength) &&
+			(((unsigned int)buffer[offset] == 10) ||
+			 ((unsigned int)buffer[offset] == 13))) {
+		offset++;
+	}
+
+	// locate the HTTP message header
+
+	for(ii = offset; ii < bufferLength; ii++) {
+		byteValue = (unsigned int)buffer[ii];
+
+		if((byteValue != 10) &&
+				(byteValue != 13) &&
+				((byteValue < 32) ||
+				 (byteValue > 126))) {
+			return -1;
+		}
+
+		if((byteValue == 10) && ((ii - offset) >= 4)) {
+			if(((unsigned int)buffer[(ii - 3)] == 13) &&
+					((unsigned int)buffer[(ii - 2)] == 10) &&
+					((unsigned int)buffer[(ii - 1)] == 13)) {
+				foundHeader = atrue;
+				headerLength = ((ii + 1) - offset);
+				break;
+			}
+		}
+		else if((!foundHeaderProtocol) && (byteValue == 'P') &&
+				((ii - offset) >= 3)) {
+			if(((unsigned int)buffer[(ii - 3)] == 'H') &&
+					((unsigned int)buffer[(ii - 2)] == 'T') &&
+					((unsigned int)buffer[(ii - 1)] == 'T')) {
+				foundHeaderProtocol = atrue;
+			}
+		}
+
+		if((!foundHeaderProtocol) &&
+				((ii - offset) > HTTP_MAXIMUM_URL_LENGTH)) {
+			return -1;
+		}
+	}
+
+	if(!foundHeader) {
+		return 0;
+	}
+	else if(!foundHeaderProtocol) {
+		return -1;
+	}
+
+	// determine if HTTP message payload exists
+
+	if((ptr = strncasestr((buffer + offset), headerLength,
+					"Content-Length:", 15)) != NULL) {
+		if((payloadLength =
+					(alint)atod((char *)((aptrcast)ptr + (alint)16))) < 0) {
+			payloadLength = 0;
+		}
+	}
+	else if((ptr = strncasestr((buffer + offset), headerLength,
+					"Transfer-encoding: chunked", 26)) != NULL) {
+		payloadLength = -1;
+	}
+
+	// assemble the message, provided it has been completely buffered
+
+	if(payloadLength >= 0) {
+		if(payloadLength > (alint)(bufferLength - (offset + headerLength))) {
+			return 0;
+		}
+
+		resultLength = (headerLength + (int)payloadLength);
+		result = (char *)malloc(sizeof(char) * (resultLength + 1));
+
+		memcpy(result, (buffer + offset), resultLength);
+
+		ref = (offset + resultLength);
+	}
+	else {
+		resultLength = headerLength;
+		result = (char *)malloc(sizeof(char) *
+				((bufferLength - offset) + 1));
+
+		memcpy(result, (buffer + offset), headerLength);
+
+		ref = (offset + headerLength);
+
+		do {
+			if((lineEnd = findLineEnd(buffer, bufferLength, ref)) < 0) {
+				free(result);
+
+				if((bufferLength - ref) > HTTP_MAXIMUM_CHUNK_LINE_LENGTH) {
+					return -1;
+				}
+
+				return 0;
+			}
+
+			if((chunkLength = parseChunkLength((buffer + ref),
+							(lineEnd - ref))) < 0) {
+				free(result);
+				return -1;
+			}
+
+			ref = (lineEnd + 2);
+
+			if(chunkLength == 0) {
+				// skip the trailer headers, up to the terminating line
+
+				while((lineEnd = findLineEnd(buffer, bufferLength,
+								ref)) > ref) {
+					ref = (lineEnd + 2);
+				}
+
+				if(lineEnd < 0) {
+					free(result);
+					return 0;
+				}
+
+				ref = (lineEnd + 2);
+
+				break;
+			}
+
+			if(chunkLength > ((bufferLength - ref) - 2)) {
+				free(result);
+				return 0;
+			}
+
+			memcpy((result + resultLength), (buffer + ref), chunkLength);
+
+			resultLength += chunkLength;
+			ref += chunkLength;
+
+			if(((unsigned int)buffer[ref] != 13) ||
+					((unsigned int)buffer[(ref + 1)] != 10)) {
+				free(result);
+				return -1;
+			}
+
+			ref += 2;
+		} while(ref < bufferLength);
+
+		if(chunkLength != 0) {
+			free(result);
+			return 0;
+		}
+	}
+
+	// move large payloads into a temp file
+
+	if((protocol != NULL) &&
+			(protocol->isTempFileMode) &&
+			(resultLength > headerLength) &&
+			((alint)(resultLength - headerLength) >=
+			 protocol->tempFileThresholdBytes)) {
+		if(writePayloadToTempFile(protocol, &result, &resultLength,
+					headerLength) < 0) {
+			free(result);
+			return -1;
+		}
+	}
+
+	result[resultLength] = '\0';
+
+	*value = result;
+	*valueLength = resultLength;
+
+	return ref;
+}
+
 // http protocol transaction managager functions
 
 void *http_protocol_transactionManagerReceive(void *manager, void *context,
 		Socket *socket, int sd, int *bytesReceived, int *errorCode)
 {
-	char *ptr = NULL;
+	int payloadLength = 0;
+	char *payload = NULL;
 
 	HttpTransactionManagerReceive *result = NULL;
 
@@ -621,44 +1252,64 @@ void *http_protocol_transactionManagerReceive(void *manager, void *context,
 	*bytesReceived = 0;
 	*errorCode = 0;
 
-	result = (HttpTransactionManagerReceive *)malloc(
-			sizeof(HttpTransactionManagerReceive));
-
-	result->isContentInFile = afalse;
-	result->payloadLength = 0;
-	result->ipAddress = NULL;
-	result->contentFilename = NULL;
-	result->payload = NULL;
-
-	socket_getPeerName(socket, sd, &(result->ipAddress));
+	payload = http_protocol_receive(context, socket, sd, &payloadLength);
 
-	result->payload = http_protocol_receive(context, socket, sd,
-			&result->payloadLength);
-
-	if(result->payload == NULL) {
+	if(payload == NULL) {
 		*errorCode = TRANSACTION_ERROR_READ;
-		free(result);
 		return NULL;
 	}
-	else if(result->payloadLength < 1) {
+	else if(payloadLength < 1) {
 		*errorCode = TRANSACTION_ERROR_TIMEOUT;
-		free(result->payload);
-		free(result);
+		free(payload);
 		return NULL;
 	}
 
-	if((ptr = strncasestr(result->payload, result->payloadLength,
-					"Content-in-file:", 16)) != NULL) {
-		result->isContentInFile = atrue;
-		result->contentFilename = getFilenameFromHeader(result->payload,
-				result->payloadLength, (int)((ptr - result->payload) + 17));
-	}
+	result = newReceive(socket, sd, payload, payloadLength);
 
 	*bytesReceived = result->payloadLength;
 
 	return result;
 }
 
+void *http_protocol_transactionManagerReceiveBuffer(void *manager,
+		void *context, Socket *socket, int sd, char *buffer, int bufferLength,
+		int *bytesConsumed, int *errorCode)
+{
+	int rc = 0;
+	int payloadLength = 0;
+	char *payload = NULL;
+
+	if((context == NULL) || (socket == NULL) || (sd < 0) ||
+			(buffer == NULL) || (bytesConsumed == NULL) ||
+			(errorCode == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(bytesConsumed != NULL) {
+			*bytesConsumed = 0;
+		}
+		if(errorCode != NULL) {
+			*errorCode = TRANSACTION_ERROR_INVALID_ARGS;
+		}
+
+		return NULL;
+	}
+
+	*bytesConsumed = 0;
+	*errorCode = 0;
+
+	if((rc = http_protocol_receiveBuffer(context, buffer, bufferLength,
+					&payload, &payloadLength)) <= 0) {
+		if(rc < 0) {
+			*errorCode = TRANSACTION_ERROR_READ;
+		}
+		return NULL;
+	}
+
+	*bytesConsumed = rc;
+
+	return newReceive(socket, sd, payload, payloadLength);
+}
+
 void http_protocol_transactionManagerReceiveFree(void *argument, void *memory)
 {
 	HttpTransactionManagerReceive *receive = NULL;
@@ -688,7 +1339,17 @@ void http_protocol_transactionManagerReceiveFree(void *argument, void *memory)
 int http_protocol_transactionManagerSend(void *manager, void *context,
 		Socket *socket, int sd, void *response)
 {
+	int ii = 0;
+	int rc = 0;
+	int split = 0;
+	int segmentCount = 0;
+	alint bodyLength = 0;
+	alint totalLength = 0;
+	char contentLength[HTTP_CONTENT_LENGTH_LINE_LENGTH];
+
+	HttpCachedFile *file = NULL;
 	HttpTransactionManagerSend *send = NULL;
+	SocketSegment segments[4];
 
 	if((socket == NULL) || (sd < 0) || (response == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -697,12 +1358,79 @@ int http_protocol_transactionManagerSend(void *manager, void *context,
 
 	send = (HttpTransactionManagerSend *)response;
 
-	if(http_protocol_send(context, socket, sd, send->payload,
-				send->payloadLength) == 0) {
-		return send->payloadLength;
+	if((send->payload == NULL) || (send->payloadLength < 1) ||
+			((send->bodyFilename != NULL) && (context == NULL))) {
+		DISPLAY_INVALID_ARGS;
+		return TRANSACTION_ERROR_INVALID_ARGS;
+	}
+
+	if(send->bodyFilename != NULL) {
+		if((file = acquireCachedFile((HttpProtocol *)context,
+						send->bodyFilename)) == NULL) {
+			fprintf(stderr, "[%s():%i] error - failed to open response "
+					"body file '%s'.\n", __FUNCTION__, __LINE__,
+					send->bodyFilename);
+			return TRANSACTION_ERROR_WRITE;
+		}
+
+		bodyLength = file->length;
+	}
+	else if(send->body != NULL) {
+		bodyLength = (alint)send->bodyLength;
+	}
+
+	memset(segments, 0, (int)sizeof(segments));
+
+	// a response on a persistent connection must be delimited, so add a
+	// content length to any response built without one
+
+	if((split = frameResponse(send->payload, send->payloadLength,
+					bodyLength, contentLength)) > 0) {
+		segments[0].value = send->payload;
+		segments[0].length = (alint)split;
+		segments[1].value = contentLength;
+		segments[1].length = (alint)strlen(contentLength);
+		segments[2].value = (send->payload + split);
+		segments[2].length = (alint)(send->payloadLength - split);
+		segmentCount = 3;
+	}
+	else {
+		segments[0].value = send->payload;
+		segments[0].length = (alint)send->payloadLength;
+		segmentCount = 1;
+	}
+
+	if(file != NULL) {
+		segments[segmentCount].file = file->handle.fd;
+		segments[segmentCount].fileOffset = 0;
+		segments[segmentCount].length = bodyLength;
+		segmentCount++;
+	}
+	else if(bodyLength > 0) {
+		segments[segmentCount].value = send->body;
+		segments[segmentCount].length = bodyLength;
+		segmentCount++;
+	}
+
+	for(ii = 0; ii < segmentCount; ii++) {
+		totalLength += segments[ii].length;
+	}
+
+	rc = socket_sendSegments(socket, sd, segments, segmentCount);
+
+	if(file != NULL) {
+		releaseCachedFile((HttpProtocol *)context, file);
+	}
+
+	if(rc < 0) {
+		return TRANSACTION_ERROR_WRITE;
+	}
+
+	if(totalLength > (alint)INT_MAX) {
+		return INT_MAX;
 	}
 
-	return TRANSACTION_ERROR_WRITE;
+	return (int)totalLength;
 }
 
 void http_protocol_transactionManagerSendFree(void *argument, void *memory)
@@ -720,9 +1448,28 @@ void http_protocol_transactionManagerSendFree(void *argument, void *memory)
 		free(send->payload);
 	}
 
+	if(send->body != NULL) {
+		free(send->body);
+	}
+
+	if(send->bodyFilename != NULL) {
+		free(send->bodyFilename);
+	}
+
 	free(send);
 }
 
+aboolean http_protocol_transactionManagerKeepAliveFunction(void *context,
+		void *request)
+{
+	if(request == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	return ((HttpTransactionManagerReceive *)request)->isKeepAlive;
+}
+
 char *http_protocol_transactionManagerIdFunction(void *context, void *request,
 		int *messageIdLength)
 {
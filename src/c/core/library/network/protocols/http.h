@@ -24,28 +24,46 @@ extern "C" {
 #endif // __cplusplus
 
 
+// define networking library HTTP protocol public constants
+
+#define HTTP_DEFAULT_IDLE_TIMEOUT_SECONDS				5.0
+
+
 // define networking library HTTP protocol public datatypes
 
 typedef struct _HttpProtocol {
 	aboolean isTempFileMode;
+	int fileCacheLength;
+	double idleTimeoutSeconds;
 	alint tempFileThresholdBytes;
 	alint tempFileSpaceAllowedBytes;
 	alint tempFileSpaceInUseBytes;
 	char *tempFileBasePath;
+	Bptree fileCache;
 	Mutex mutex;
 } HttpProtocol;
 
 typedef struct _HttpTransactionManagerReceive {
 	aboolean isContentInFile;
+	aboolean isKeepAlive;
 	int payloadLength;
 	char *ipAddress;
 	char *contentFilename;
 	char *payload;
 } HttpTransactionManagerReceive;
 
+/*
+ * The payload is either the complete response, or just its headers when the
+ * response carries a separate body, which is sent from memory (body) or
+ * straight from a file (bodyFilename) without being copied into the payload.
+ */
+
 typedef struct _HttpTransactionManagerSend {
 	int payloadLength;
+	int bodyLength;
 	char *payload;
+	char *body;
+	char *bodyFilename;
 } HttpTransactionManagerSend;
 
 
@@ -61,17 +79,26 @@ void http_protocol_free(HttpProtocol *protocol);
 
 int http_protocol_freeTempFile(HttpProtocol *protocol, char *filename);
 
+int http_protocol_setIdleTimeout(HttpProtocol *protocol, double seconds);
+
 int http_protocol_send(void *context, Socket *socket, int sd, char *value,
 		int valueLength);
 
 char *http_protocol_receive(void *context, Socket *socket, int sd,
 		int *receiveLength);
 
+int http_protocol_receiveBuffer(void *context, char *buffer, int bufferLength,
+		char **value, int *valueLength);
+
 // http protocol transaction managager functions
 
 void *http_protocol_transactionManagerReceive(void *manager, void *context,
 		Socket *socket, int sd, int *bytesReceived, int *errorCode);
 
+void *http_protocol_transactionManagerReceiveBuffer(void *manager,
+		void *context, Socket *socket, int sd, char *buffer, int bufferLength,
+		int *bytesConsumed, int *errorCode);
+
 void http_protocol_transactionManagerReceiveFree(void *argument, void *memory);
 
 int http_protocol_transactionManagerSend(void *manager, void *context,
@@ -79,6 +106,9 @@ int http_protocol_transactionManagerSend(void *manager, void *context,
 
 void http_protocol_transactionManagerSendFree(void *argument, void *memory);
 
+aboolean http_protocol_transactionManagerKeepAliveFunction(void *context,
+		void *request);
+
 char *http_protocol_transactionManagerIdFunction(void *context, void *request,
 		int *messageIdLength);
 
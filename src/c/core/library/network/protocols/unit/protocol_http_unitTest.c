@@ -21,6 +21,17 @@
 
 #define BASIC_FUNCTIONALITY_TESTS						1024
 
+#define KEEP_ALIVE_TEST_PORT							6545
+
+#define KEEP_ALIVE_TEST_IDLE_TIMEOUT					0.25
+
+#define SEGMENTED_SEND_TEST_PORT						6546
+
+#define SEGMENTED_SEND_TEST_BODY_LENGTH					131072
+
+#define SEGMENTED_SEND_TEST_FILENAME					\
+	"protocol.http.unit.test.body"
+
 #define REMOTE_SERVER_CLIENT_TEST_VERBOSE_MODE			atrue
 
 
@@ -28,6 +39,12 @@
 
 static int http_protocol_basicFunctionalityTest();
 
+static int http_protocol_receiveBufferTest();
+
+static int http_protocol_keepAliveTest();
+
+static int http_protocol_segmentedSendTest();
+
 static int http_protocol_remoteServerClientTest();
 
 
@@ -55,6 +72,39 @@ int main()
 
 	timer = time_getTimeMus();
 
+	if(http_protocol_receiveBufferTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit]\t ...PASSED (%0.6f seconds)\n",
+			time_getElapsedMusInSeconds(timer));
+	printf("[unit]\n");
+
+	timer = time_getTimeMus();
+
+	if(http_protocol_keepAliveTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit]\t ...PASSED (%0.6f seconds)\n",
+			time_getElapsedMusInSeconds(timer));
+	printf("[unit]\n");
+
+	timer = time_getTimeMus();
+
+	if(http_protocol_segmentedSendTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit]\t ...PASSED (%0.6f seconds)\n",
+			time_getElapsedMusInSeconds(timer));
+	printf("[unit]\n");
+
+	timer = time_getTimeMus();
+
 	if(http_protocol_remoteServerClientTest() < 0) {
 		printf("[unit]\t ...FAILED\n");
 		return 1;
@@ -450,6 +500,536 @@ static int http_protocol_basicFunctionalityTest()
 	return 0;
 }
 
+static int http_protocol_receiveBufferTest()
+{
+	int ii = 0;
+	int rc = 0;
+	int length = 0;
+	int valueLength = 0;
+	char *value = NULL;
+
+	const char *GET_REQUEST = ""
+		"GET /one HTTP/1.1\x0d\x0a"
+		"Host: localhost\x0d\x0a"
+		"\x0d\x0a";
+
+	const char *POST_REQUEST = ""
+		"\x0d\x0a"
+		"POST /two HTTP/1.1\x0d\x0a"
+		"Content-Length: 5\x0d\x0a"
+		"\x0d\x0a"
+		"hello";
+
+	const char *CHUNKED_REQUEST = ""
+		"POST /three HTTP/1.1\x0d\x0a"
+		"Transfer-encoding: chunked\x0d\x0a"
+		"\x0d\x0a"
+		"5\x0d\x0a"
+		"hello\x0d\x0a"
+		"6;ext=1\x0d\x0a"
+		" world\x0d\x0a"
+		"0\x0d\x0a"
+		"\x0d\x0a";
+
+	const char *CHUNKED_RESULT = ""
+		"POST /three HTTP/1.1\x0d\x0a"
+		"Transfer-encoding: chunked\x0d\x0a"
+		"\x0d\x0a"
+		"hello world";
+
+	const char *INVALID_REQUEST = ""
+		"POST /four HTTP/1.1\x0d\x0a"
+		"Transfer-encoding: chunked\x0d\x0a"
+		"\x0d\x0a"
+		"zz\x0d\x0a";
+
+	printf("[unit]\t HTTP protocol receive buffer test...\n");
+
+	// every prefix of a message is incomplete, the whole is consumed
+
+	length = strlen(GET_REQUEST);
+
+	for(ii = 0; ii < length; ii++) {
+		if(http_protocol_receiveBuffer(NULL, (char *)GET_REQUEST, ii,
+					&value, &valueLength) != 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if((http_protocol_receiveBuffer(NULL, (char *)GET_REQUEST, length,
+					&value, &valueLength) != length) ||
+			(valueLength != length) ||
+			(strcmp(value, GET_REQUEST))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(value);
+
+	// a content-length payload, behind a stray line break
+
+	length = strlen(POST_REQUEST);
+
+	if(http_protocol_receiveBuffer(NULL, (char *)POST_REQUEST, (length - 1),
+				&value, &valueLength) != 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if((http_protocol_receiveBuffer(NULL, (char *)POST_REQUEST, length,
+					&value, &valueLength) != length) ||
+			(valueLength != (length - 2)) ||
+			(strcmp(value, (POST_REQUEST + 2)))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(value);
+
+	// a chunked payload is decoded
+
+	length = strlen(CHUNKED_REQUEST);
+
+	for(ii = 0; ii < length; ii++) {
+		if(http_protocol_receiveBuffer(NULL, (char *)CHUNKED_REQUEST, ii,
+					&value, &valueLength) != 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if((http_protocol_receiveBuffer(NULL, (char *)CHUNKED_REQUEST, length,
+					&value, &valueLength) != length) ||
+			(strcmp(value, CHUNKED_RESULT))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(value);
+
+	// an invalid chunk length is rejected
+
+	rc = http_protocol_receiveBuffer(NULL, (char *)INVALID_REQUEST,
+			strlen(INVALID_REQUEST), &value, &valueLength);
+
+	if((rc >= 0) || (value != NULL)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int http_protocol_keepAliveTest()
+{
+	int ii = 0;
+	int clientSd = 0;
+	int serverChildSd = 0;
+	int errorCode = 0;
+	int valueLength = 0;
+	int bytesReceived = 0;
+	double timer = 0.0;
+	char *value = NULL;
+
+	const char *PIPELINED_REQUESTS = ""
+		"GET /one HTTP/1.1\x0d\x0a"
+		"Host: localhost\x0d\x0a"
+		"\x0d\x0a"
+		"GET /two HTTP/1.0\x0d\x0a"
+		"\x0d\x0a"
+		"GET /three HTTP/1.0\x0d\x0a"
+		"Connection: Keep-Alive\x0d\x0a"
+		"\x0d\x0a"
+		"POST /four HTTP/1.1\x0d\x0a"
+		"Connection: close\x0d\x0a"
+		"Content-Length: 4\x0d\x0a"
+		"\x0d\x0a"
+		"four";
+
+	const char *EXPECTED_IDS[] = {
+		"/one",
+		"/two",
+		"/three",
+		"/four"
+	};
+
+	const aboolean EXPECTED_KEEP_ALIVE[] = {
+		atrue,
+		afalse,
+		atrue,
+		afalse
+	};
+
+	const char *RESPONSE = ""
+		"HTTP/1.1 200 OK\x0d\x0a"
+		"Server: Asgard HTTP Protocol Unit Test Server\x0d\x0a"
+		"\x0d\x0a"
+		"hello";
+
+	const char *FRAMED_RESPONSE = ""
+		"HTTP/1.1 200 OK\x0d\x0a"
+		"Server: Asgard HTTP Protocol Unit Test Server\x0d\x0a"
+		"Content-Length: 5\x0d\x0a"
+		"\x0d\x0a"
+		"hello";
+
+	Socket clientSocket;
+	Socket serverSocket;
+
+	HttpProtocol protocol;
+	HttpTransactionManagerSend send;
+	HttpTransactionManagerReceive *receive = NULL;
+
+	printf("[unit]\t HTTP protocol keep-alive test...\n");
+
+	http_protocol_init(&protocol, afalse, 0, 0, 0, NULL);
+
+	if(http_protocol_setIdleTimeout(&protocol,
+				KEEP_ALIVE_TEST_IDLE_TIMEOUT) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if((socket_init(&serverSocket, SOCKET_MODE_SERVER, SOCKET_PROTOCOL_TCPIP,
+					"127.0.0.1", KEEP_ALIVE_TEST_PORT) < 0) ||
+			(socket_open(&serverSocket) < 0) ||
+			(socket_listen(&serverSocket) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if((socket_init(&clientSocket, SOCKET_MODE_CLIENT, SOCKET_PROTOCOL_TCPIP,
+					"127.0.0.1", KEEP_ALIVE_TEST_PORT) < 0) ||
+			(socket_open(&clientSocket) < 0) ||
+			((clientSd = socket_getSocketDescriptor(&clientSocket)) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// pipeline every request on a single connection
+
+	if(socket_send(&clientSocket, clientSd, (char *)PIPELINED_REQUESTS,
+				strlen(PIPELINED_REQUESTS)) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(socket_accept(&serverSocket, &serverChildSd, 2097152) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < 4; ii++) {
+		receive = (HttpTransactionManagerReceive *)
+			http_protocol_transactionManagerReceive(NULL, &protocol,
+					&serverSocket, serverChildSd, &bytesReceived,
+					&errorCode);
+
+		if((receive == NULL) || (errorCode != 0)) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		value = http_protocol_transactionManagerIdFunction(&protocol,
+				receive, &valueLength);
+
+		if((value == NULL) || (strcmp(value, EXPECTED_IDS[ii])) ||
+				(http_protocol_transactionManagerKeepAliveFunction(
+					&protocol, receive) != EXPECTED_KEEP_ALIVE[ii])) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		free(value);
+
+		http_protocol_transactionManagerReceiveFree(&protocol, receive);
+	}
+
+	// an idle connection times out without a message
+
+	timer = time_getTimeMus();
+
+	receive = (HttpTransactionManagerReceive *)
+		http_protocol_transactionManagerReceive(NULL, &protocol,
+				&serverSocket, serverChildSd, &bytesReceived, &errorCode);
+
+	if((receive != NULL) || (errorCode != TRANSACTION_ERROR_TIMEOUT) ||
+			(time_getElapsedMusInSeconds(timer) >
+			 (KEEP_ALIVE_TEST_IDLE_TIMEOUT * 4.0))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// a response without its own framing is given a content length
+
+	send.payload = (char *)RESPONSE;
+	send.payloadLength = strlen(RESPONSE);
+	send.bodyLength = 0;
+	send.body = NULL;
+	send.bodyFilename = NULL;
+
+	if(http_protocol_transactionManagerSend(NULL, &protocol, &serverSocket,
+				serverChildSd, &send) != (int)strlen(FRAMED_RESPONSE)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	value = http_protocol_receive(&protocol, &clientSocket, clientSd,
+			&valueLength);
+
+	if((value == NULL) || (valueLength != (int)strlen(FRAMED_RESPONSE)) ||
+			(strcmp(value, FRAMED_RESPONSE))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(value);
+
+	// a connection closed by the client is noticed without waiting out
+	// the idle timeout
+
+	socket_close(&clientSocket);
+
+	http_protocol_setIdleTimeout(&protocol, 8.0);
+
+	timer = time_getTimeMus();
+
+	receive = (HttpTransactionManagerReceive *)
+		http_protocol_transactionManagerReceive(NULL, &protocol,
+				&serverSocket, serverChildSd, &bytesReceived, &errorCode);
+
+	if((receive != NULL) || (errorCode != TRANSACTION_ERROR_TIMEOUT) ||
+			(time_getElapsedMusInSeconds(timer) > 4.0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	socket_closeChildSocket(&serverSocket, serverChildSd);
+	socket_close(&serverSocket);
+
+	socket_free(&clientSocket);
+	socket_free(&serverSocket);
+
+	http_protocol_free(&protocol);
+
+	return 0;
+}
+
+static int sendAndCompareSegmentedResponse(HttpProtocol *protocol,
+		Socket *serverSocket, int serverChildSd, Socket *clientSocket,
+		int clientSd, HttpTransactionManagerSend *send, char *body,
+		int bodyLength)
+{
+	int length = 0;
+	int valueLength = 0;
+	char *value = NULL;
+	char *expected = NULL;
+
+	expected = (char *)malloc(sizeof(char) *
+			(send->payloadLength + bodyLength + 64));
+
+	length = (send->payloadLength - 2);
+
+	memcpy(expected, send->payload, length);
+
+	length += sprintf((expected + length), "Content-Length: %i\x0d\x0a"
+			"\x0d\x0a", bodyLength);
+
+	memcpy((expected + length), body, bodyLength);
+
+	length += bodyLength;
+
+	if(http_protocol_transactionManagerSend(NULL, protocol, serverSocket,
+				serverChildSd, send) != length) {
+		free(expected);
+		return -1;
+	}
+
+	value = http_protocol_receive(protocol, clientSocket, clientSd,
+			&valueLength);
+
+	if((value == NULL) || (valueLength != length) ||
+			(memcmp(value, expected, length))) {
+		if(value != NULL) {
+			free(value);
+		}
+		free(expected);
+		return -1;
+	}
+
+	free(value);
+	free(expected);
+
+	return 0;
+}
+
+static int http_protocol_segmentedSendTest()
+{
+	int ii = 0;
+	int clientSd = 0;
+	int serverChildSd = 0;
+	char *body = NULL;
+
+	const char *HEADERS = ""
+		"HTTP/1.1 200 OK\x0d\x0a"
+		"Server: Asgard HTTP Protocol Unit Test Server\x0d\x0a"
+		"\x0d\x0a";
+
+	FileHandle fh;
+	Socket clientSocket;
+	Socket serverSocket;
+
+	HttpProtocol protocol;
+	HttpTransactionManagerSend send;
+
+	printf("[unit]\t HTTP protocol segmented send test...\n");
+
+	http_protocol_init(&protocol, afalse, 0, 0, 0, NULL);
+
+	if((socket_init(&serverSocket, SOCKET_MODE_SERVER, SOCKET_PROTOCOL_TCPIP,
+					"127.0.0.1", SEGMENTED_SEND_TEST_PORT) < 0) ||
+			(socket_open(&serverSocket) < 0) ||
+			(socket_listen(&serverSocket) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if((socket_init(&clientSocket, SOCKET_MODE_CLIENT, SOCKET_PROTOCOL_TCPIP,
+					"127.0.0.1", SEGMENTED_SEND_TEST_PORT) < 0) ||
+			(socket_open(&clientSocket) < 0) ||
+			((clientSd = socket_getSocketDescriptor(&clientSocket)) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(socket_accept(&serverSocket, &serverChildSd, 2097152) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	body = (char *)malloc(sizeof(char) * SEGMENTED_SEND_TEST_BODY_LENGTH);
+
+	for(ii = 0; ii < SEGMENTED_SEND_TEST_BODY_LENGTH; ii++) {
+		body[ii] = (char)((ii % 26) + 'a');
+	}
+
+	send.payload = (char *)HEADERS;
+	send.payloadLength = strlen(HEADERS);
+
+	// a body held in memory is sent behind the headers
+
+	send.bodyLength = SEGMENTED_SEND_TEST_BODY_LENGTH;
+	send.body = body;
+	send.bodyFilename = NULL;
+
+	if(sendAndCompareSegmentedResponse(&protocol, &serverSocket,
+				serverChildSd, &clientSocket, clientSd, &send, body,
+				SEGMENTED_SEND_TEST_BODY_LENGTH) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// a body held in a file is sent from a cached file handle
+
+	if((file_init(&fh, SEGMENTED_SEND_TEST_FILENAME, "wb", 0) < 0) ||
+			(file_write(&fh, body, SEGMENTED_SEND_TEST_BODY_LENGTH) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	file_free(&fh);
+
+	send.bodyLength = 0;
+	send.body = NULL;
+	send.bodyFilename = SEGMENTED_SEND_TEST_FILENAME;
+
+	for(ii = 0; ii < 2; ii++) {
+		if(sendAndCompareSegmentedResponse(&protocol, &serverSocket,
+					serverChildSd, &clientSocket, clientSd, &send, body,
+					SEGMENTED_SEND_TEST_BODY_LENGTH) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if(protocol.fileCacheLength != 1) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// a file changed on disk replaces its cached file handle
+
+	if((file_init(&fh, SEGMENTED_SEND_TEST_FILENAME, "wb", 0) < 0) ||
+			(file_write(&fh, (body + 1),
+						(SEGMENTED_SEND_TEST_BODY_LENGTH / 2)) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	file_free(&fh);
+
+	if((sendAndCompareSegmentedResponse(&protocol, &serverSocket,
+					serverChildSd, &clientSocket, clientSd, &send,
+					(body + 1),
+					(SEGMENTED_SEND_TEST_BODY_LENGTH / 2)) < 0) ||
+			(protocol.fileCacheLength != 1)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// a missing file fails the send
+
+	system_fileDelete(SEGMENTED_SEND_TEST_FILENAME);
+
+	if(http_protocol_transactionManagerSend(NULL, &protocol, &serverSocket,
+				serverChildSd, &send) != TRANSACTION_ERROR_WRITE) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(body);
+
+	socket_closeChildSocket(&serverSocket, serverChildSd);
+	socket_close(&clientSocket);
+	socket_close(&serverSocket);
+
+	socket_free(&clientSocket);
+	socket_free(&serverSocket);
+
+	http_protocol_free(&protocol);
+
+	return 0;
+}
+
 static int http_protocol_remoteServerClientTest()
 {
 	int sd = 0;
@@ -17,6 +17,24 @@
 #include "core/library/network/server.h"
 
 
+// define server private constants
+
+#define SERVER_EVENT_WAIT_LENGTH						256
+
+#define SERVER_EVENT_WAIT_MILLIS						64
+
+#define SERVER_EVENT_READ_LENGTH						16384
+
+#define SERVER_EVENT_MAX_BUFFER_LENGTH				\
+	SOCKET_DEFAULT_MAX_RECEIVE_LENGTH
+
+#define SERVER_EVENT_MIN_NAP_MICROS						64
+
+#define SERVER_EVENT_MAX_NAP_MICROS						1024
+
+#define SERVER_EVENT_REAP_INTERVAL_SECONDS				1.0
+
+
 // define server private data types
 
 typedef struct _WorkerThreadArgs {
@@ -33,7 +51,9 @@ static void recordError(Server *server, int type);
 
 static void recordMetric(Server *server, int type, double timing);
 
-static void recordTracking(Server *server, double timing);
+static void updateTracking(Server *server, int *trackingRef);
+
+static void recordTransactionError(Server *server, int rc);
 
 // server status functions
 
@@ -42,6 +62,16 @@ static ServerStatus *newServerStatus(char *key, char *name, char *value,
 
 static void freeServerStatus(void *memory);
 
+static void addLatencyStatus(ArrayList *list, char *key, char *name,
+		char *description, Histogram *histogram);
+
+static void escapePrometheusLabel(char *value, char *buffer,
+		int bufferLength);
+
+static char *appendPrometheusSummary(char *string, int *stringRef,
+		int *stringLength, char *metric, char *labels,
+		Histogram *histogram);
+
 // thread functions
 
 static aboolean isWorkerRequired(Server *server);
@@ -50,10 +80,48 @@ static int pickAvailableThread(Server *server);
 
 static aboolean isWorkerShutdownRequired(Server *server, int *threadId);
 
+static TmfThreadFunction pickWorkerFunction(Server *server);
+
 static void *manageServerThread(void *threadContext, void *argument);
 
 static void *serverWorkerThread(void *threadContext, void *argument);
 
+// event mode functions
+
+#if defined(__linux__)
+
+static ServerConnection *newConnection(Server *server, int sd);
+
+static void unlinkConnection(Server *server, ServerConnection *connection);
+
+static void releaseConnection(Server *server, ServerConnection *connection);
+
+static void closeConnection(Server *server, ServerConnection *connection);
+
+static void reapIdleConnections(Server *server);
+
+static void closeAllConnections(Server *server);
+
+static int armConnection(Server *server, ServerConnection *connection);
+
+static int readConnection(Server *server, ServerConnection *connection);
+
+static int frameConnection(Server *server, ServerConnection *connection);
+
+static void executeConnection(Server *server, ServerConnection *connection);
+
+static void acceptConnections(Server *server);
+
+static int startEventMode(Server *server);
+
+static void stopEventMode(Server *server);
+
+static void *eventReactorThread(void *threadContext, void *argument);
+
+static void *eventWorkerThread(void *threadContext, void *argument);
+
+#endif // __linux__
+
 
 // define server private functions
 
@@ -67,47 +135,107 @@ static void recordError(Server *server, int type)
 		return;
 	}
 
-	mutex_lock(&server->errors.mutex);
-
-	server->errors.counter[SERVER_ERROR_TOTAL] += 1;
-	server->errors.counter[type] += 1;
-
-	mutex_unlock(&server->errors.mutex);
+	atomic_addAlint(&server->errors.counter[SERVER_ERROR_TOTAL], 1);
+	atomic_addAlint(&server->errors.counter[type], 1);
 }
 
 static void recordMetric(Server *server, int type, double timing)
 {
+	alint value = 0;
+
 	if((type <= SERVER_METRIC_TOTAL) || (type >= SERVER_METRIC_LENGTH)) {
 		fprintf(stderr, "[%s():%i] error - unable to record metric for type "
 				"%i.\n", __FUNCTION__, __LINE__, type);
 		return;
 	}
 
-	mutex_lock(&server->metrics.mutex);
+	value = (alint)(timing * REAL_ONE_MILLION);
+
+	histogram_record(&server->metrics.latencies[type], value);
+	histogram_record(&server->metrics.latencies[SERVER_METRIC_TOTAL], value);
+}
+
+static void updateTracking(Server *server, int *trackingRef)
+{
+	int ii = 0;
+	alint timing = 0;
+	alint counter = 0;
+
+	Histogram *histogram = NULL;
+
+	histogram = &server->metrics.latencies[SERVER_METRIC_TRANSACTION];
+
+	timing = histogram_getSum(histogram);
+	counter = histogram_getCount(histogram);
+
+	mutex_lock(&server->tracking.mutex);
+
+	*trackingRef += 1;
+	if(*trackingRef > SERVER_TRACKING_ENTRY_LENGTH) {
+		*trackingRef = SERVER_TRACKING_ENTRY_LENGTH;
+	}
+
+	for(ii = (SERVER_TRACKING_ENTRY_LENGTH - 1); ii > 0; ii--) {
+		server->tracking.timings[ii] = server->tracking.timings[(ii - 1)];
+		server->tracking.counts[ii] = server->tracking.counts[(ii - 1)];
+	}
 
-	server->metrics.transactionCounter += 1;
+	// the transactions of the last second are the histogram's growth since
+	// the last update
 
-	server->metrics.counter[type] += 1;
-	server->metrics.timings[type] += timing;
+	server->tracking.timings[0] =
+		((double)(timing - server->tracking.lastTiming) / REAL_ONE_MILLION);
+	server->tracking.counts[0] =
+		(double)(counter - server->tracking.lastCounter);
 
-	server->metrics.counter[SERVER_METRIC_TOTAL] += 1;
-	server->metrics.timings[SERVER_METRIC_TOTAL] += timing;
+	server->tracking.lastTiming = timing;
+	server->tracking.lastCounter = counter;
 
-	mutex_unlock(&server->metrics.mutex);
+	server->tracking.timingAverage = 0.0;
+	server->tracking.countAverage = 0.0;
 
-	if(type == SERVER_METRIC_TRANSACTION) {
-		recordTracking(server, timing);
+	for(ii = 0; ii < *trackingRef; ii++) {
+		server->tracking.timingAverage += server->tracking.timings[ii];
+		server->tracking.countAverage += server->tracking.counts[ii];
 	}
+
+	server->tracking.countAverage /= (double)*trackingRef;
+
+	server->tracking.timingAverage /= (double)*trackingRef;
+
+	server->tracking.timingAverage /= server->tracking.countAverage;
+
+	mutex_unlock(&server->tracking.mutex);
 }
 
-static void recordTracking(Server *server, double timing)
+static void recordTransactionError(Server *server, int rc)
 {
-	mutex_lock(&server->tracking.mutex);
+	switch(rc) {
+		case TRANSACTION_ERROR_READ:
+			recordError(server, SERVER_ERROR_SOCKET_READ);
+			break;
 
-	server->tracking.timing += timing;
-	server->tracking.counter += 1.0;
+		case TRANSACTION_ERROR_WRITE:
+			recordError(server, SERVER_ERROR_SOCKET_WRITE);
+			break;
 
-	mutex_unlock(&server->tracking.mutex);
+		case TRANSACTION_ERROR_CLOSE:
+			recordError(server, SERVER_ERROR_SOCKET_CLOSE);
+			break;
+
+		case TRANSACTION_ERROR_TIMEOUT:
+			recordError(server, SERVER_ERROR_SOCKET_TIMEOUT);
+			break;
+
+		case TRANSACTION_ERROR_INVALID_ARGS:
+		case TRANSACTION_ERROR_FAILED_IDENT:
+		case TRANSACTION_ERROR_MISSING_HANDLER:
+		case TRANSACTION_ERROR_INVALID_HANDLER:
+		case TRANSACTION_ERROR_NULL_RESULT:
+		case TRANSACTION_ERROR_INVALID_RESULT:
+		default:
+			recordError(server, SERVER_ERROR_TRANSACTION);
+	}
 }
 
 // server status functions
@@ -156,6 +284,96 @@ static void freeServerStatus(void *memory)
 	free(status);
 }
 
+static void addLatencyStatus(ArrayList *list, char *key, char *name,
+		char *description, Histogram *histogram)
+{
+	int ii = 0;
+	char statusKey[1024];
+	char statusName[1024];
+	char value[1024];
+
+	const char *KEYS[] = { "P50", "P99", "P999", "Max" };
+	const char *NAMES[] = {
+		"50th Percentile",
+		"99th Percentile",
+		"99.9th Percentile",
+		"Maximum"
+	};
+	const double PERCENTILES[] = { 50.0, 99.0, 99.9, 100.0 };
+
+	for(ii = 0; ii < (int)(sizeof(PERCENTILES) / sizeof(double)); ii++) {
+		snprintf(statusKey, ((int)sizeof(statusKey) - 1), "%s%s", key,
+				KEYS[ii]);
+
+		snprintf(statusName, ((int)sizeof(statusName) - 1), "%s %s", name,
+				NAMES[ii]);
+
+		snprintf(value, ((int)sizeof(value) - 1), "%0.6f",
+				((double)histogram_getPercentile(histogram, PERCENTILES[ii]) /
+				 REAL_ONE_MILLION));
+
+		arraylist_add(list, newServerStatus(statusKey, statusName, value,
+					description));
+	}
+}
+
+static void escapePrometheusLabel(char *value, char *buffer,
+		int bufferLength)
+{
+	int ii = 0;
+	int nn = 0;
+
+	for(ii = 0, nn = 0; (value[ii] != '\0') && (nn < (bufferLength - 3));
+			ii++) {
+		if((value[ii] == '\\') || (value[ii] == '"')) {
+			buffer[nn++] = '\\';
+			buffer[nn++] = value[ii];
+		}
+		else if(value[ii] == '\n') {
+			buffer[nn++] = '\\';
+			buffer[nn++] = 'n';
+		}
+		else {
+			buffer[nn++] = value[ii];
+		}
+	}
+
+	buffer[nn] = '\0';
+}
+
+static char *appendPrometheusSummary(char *string, int *stringRef,
+		int *stringLength, char *metric, char *labels,
+		Histogram *histogram)
+{
+	int ii = 0;
+	int bufferLength = 0;
+	char buffer[2048];
+
+	const char *QUANTILES[] = { "0.5", "0.99", "0.999" };
+	const double PERCENTILES[] = { 50.0, 99.0, 99.9 };
+
+	for(ii = 0; ii < (int)(sizeof(PERCENTILES) / sizeof(double)); ii++) {
+		bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+				"%s{%s,quantile=\"%s\"} %0.6f\n", metric, labels,
+				QUANTILES[ii],
+				((double)histogram_getPercentile(histogram, PERCENTILES[ii]) /
+				 REAL_ONE_MILLION));
+
+		string = strxpndcat(string, stringRef, stringLength, buffer,
+				bufferLength);
+	}
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"%s_sum{%s} %0.6f\n"
+			"%s_count{%s} %lli\n",
+			metric, labels,
+			((double)histogram_getSum(histogram) / REAL_ONE_MILLION),
+			metric, labels,
+			histogram_getCount(histogram));
+
+	return strxpndcat(string, stringRef, stringLength, buffer, bufferLength);
+}
+
 // thread functions
 
 static aboolean isWorkerRequired(Server *server)
@@ -294,6 +512,17 @@ static aboolean isWorkerShutdownRequired(Server *server, int *threadId)
 	return afalse;
 }
 
+static TmfThreadFunction pickWorkerFunction(Server *server)
+{
+#if defined(__linux__)
+	if(server->mode == SERVER_MODE_EVENT) {
+		return eventWorkerThread;
+	}
+#endif // __linux__
+
+	return serverWorkerThread;
+}
+
 static void *manageServerThread(void *threadContext, void *argument)
 {
 	aboolean tookAction = afalse;
@@ -333,43 +562,7 @@ static void *manageServerThread(void *threadContext, void *argument)
 		// update the tracking information
 
 		if(time_getElapsedMusInSeconds(trackingTimestamp) >= 1.0) {
-			mutex_lock(&server->tracking.mutex);
-
-			trackingRef += 1;
-			if(trackingRef > SERVER_TRACKING_ENTRY_LENGTH) {
-				trackingRef = SERVER_TRACKING_ENTRY_LENGTH;
-			}
-
-			for(ii = (SERVER_TRACKING_ENTRY_LENGTH - 1); ii >= 0; ii--) {
-				server->tracking.timings[ii] =
-					server->tracking.timings[(ii - 1)];
-
-				server->tracking.counts[ii] = server->tracking.counts[(ii - 1)];
-			}
-
-			server->tracking.timings[0] = server->tracking.timing;
-			server->tracking.counts[0] = server->tracking.counter;
-
-			server->tracking.timingAverage = 0.0;
-			server->tracking.countAverage = 0.0;
-
-			for(ii = 0; ii < trackingRef; ii++) {
-				server->tracking.timingAverage +=
-					server->tracking.timings[ii];
-				server->tracking.countAverage +=
-					server->tracking.counts[ii];
-			}
-
-			server->tracking.countAverage /= (double)trackingRef;
-
-			server->tracking.timingAverage /= (double)trackingRef;
-
-			server->tracking.timingAverage /= server->tracking.countAverage;
-
-			server->tracking.timing = 0.0;
-			server->tracking.counter = 0.0;
-
-			mutex_unlock(&server->tracking.mutex);
+			updateTracking(server, &trackingRef);
 
 			trackingTimestamp = time_getTimeMus();
 		}
@@ -391,7 +584,7 @@ static void *manageServerThread(void *threadContext, void *argument)
 			currentThreadPoolLength = server->threads.currentThreadPoolLength;
 
 			if(tmf_spawnThread(&server->tmf,
-						serverWorkerThread,
+						pickWorkerFunction(server),
 						(void *)&worker,
 						&(server->threads.list[serverThreadId].id)) < 0) {
 				mutex_unlock(&server->threads.mutex);
@@ -538,6 +731,7 @@ static void *serverWorkerThread(void *threadContext, void *argument)
 	aboolean shutdownRequested = afalse;
 	int rc = 0;
 	int sd = 0;
+	int requestCount = 0;
 	int serverThreadId = 0;
 	double timer = 0.0;
 	double timing = 0.0;
@@ -678,6 +872,8 @@ static void *serverWorkerThread(void *threadContext, void *argument)
 
 		// execute transaction manager
 
+		requestCount = 0;
+
 		do {
 			isSocketLeftOpen = afalse;
 
@@ -687,38 +883,22 @@ static void *serverWorkerThread(void *threadContext, void *argument)
 							&server->socket,
 							sd,
 							&isSocketLeftOpen)) < 0) {
+				if((rc == TRANSACTION_ERROR_TIMEOUT) && (requestCount > 0)) {
+					log_logf(server->log, LOG_LEVEL_DEBUG,
+							"worker #%i closing idle connection #%i after "
+							"%i requests", serverThreadId, sd, requestCount);
+					break;
+				}
+
 				log_logf(server->log, LOG_LEVEL_ERROR,
 						"worker #%i transaction manager execution failure '%s'",
 						serverThreadId, transactionManager_getErrorString(rc));
 
-				switch(rc) {
-					case TRANSACTION_ERROR_READ:
-						recordError(server, SERVER_ERROR_SOCKET_READ);
-						break;
-
-					case TRANSACTION_ERROR_WRITE:
-						recordError(server, SERVER_ERROR_SOCKET_WRITE);
-						break;
-
-					case TRANSACTION_ERROR_CLOSE:
-						recordError(server, SERVER_ERROR_SOCKET_CLOSE);
-						break;
-
-					case TRANSACTION_ERROR_TIMEOUT:
-						recordError(server, SERVER_ERROR_SOCKET_TIMEOUT);
-						break;
-
-					case TRANSACTION_ERROR_INVALID_ARGS:
-					case TRANSACTION_ERROR_FAILED_IDENT:
-					case TRANSACTION_ERROR_MISSING_HANDLER:
-					case TRANSACTION_ERROR_INVALID_HANDLER:
-					case TRANSACTION_ERROR_NULL_RESULT:
-					case TRANSACTION_ERROR_INVALID_RESULT:
-					default:
-						recordError(server, SERVER_ERROR_TRANSACTION);
-				}
+				recordTransactionError(server, rc);
 			}
 
+			requestCount++;
+
 			timing = time_getElapsedMusInSeconds(timer);
 
 			recordMetric(server, SERVER_METRIC_TRANSACTION, timing);
@@ -742,15 +922,708 @@ static void *serverWorkerThread(void *threadContext, void *argument)
 			mutex_unlock(&server->threads.mutex);
 		}
 
-		// close the socket
+		// close the socket
+
+		if(socket_closeChildSocket(&server->socket, sd) < 0) {
+			log_logf(server->log, LOG_LEVEL_ERROR,
+					"worker #%i failed to close child socket on %i",
+					serverThreadId, sd);
+
+			recordError(server, SERVER_ERROR_SOCKET_CLOSE);
+		}
+
+		// set status to napping
+
+		mutex_lock(&server->threads.mutex);
+		mutex_lock(thread->mutex);
+
+		thread->status = THREAD_STATUS_NAPPING;
+		server->threads.list[serverThreadId].status = (int)thread->status;
+		server->threads.list[serverThreadId].signal = (int)thread->signal;
+
+		mutex_unlock(thread->mutex);
+		mutex_unlock(&server->threads.mutex);
+	}
+
+	if(shutdownRequested) {
+		while((thread->state == THREAD_STATE_RUNNING) &&
+				(thread->signal == THREAD_SIGNAL_OK)) {
+			time_usleep(1024);
+		}
+	}
+
+	if(thread->state == THREAD_STATE_RUNNING) {
+		mutex_lock(thread->mutex);
+		thread->state = THREAD_STATE_HALT;
+		mutex_unlock(thread->mutex);
+	}
+
+	mutex_lock(&server->threads.mutex);
+
+	server->threads.list[serverThreadId].state = THREAD_STATE_INIT;
+	server->threads.list[serverThreadId].status = THREAD_STATUS_INIT;
+	server->threads.list[serverThreadId].signal = THREAD_SIGNAL_OK;
+	server->threads.list[serverThreadId].id = 0;
+
+	if(server->threads.list[serverThreadId].ip != NULL) {
+		free(server->threads.list[serverThreadId].ip);
+	}
+
+	server->threads.list[serverThreadId].ip = NULL;
+
+	server->threads.currentThreadPoolLength -= 1;
+
+	mutex_unlock(&server->threads.mutex);
+
+	log_logf(server->log, LOG_LEVEL_INFO,
+			"server '%s' worker #%i thread #%i (%i) shut down",
+			server->name, serverThreadId, thread->uid, thread->systemId);
+
+	return NULL;
+}
+
+
+// event mode functions
+
+#if defined(__linux__)
+
+static ServerConnection *newConnection(Server *server, int sd)
+{
+	ServerConnection *result = NULL;
+
+	result = (ServerConnection *)malloc(sizeof(ServerConnection));
+
+	result->isArmed = atrue;
+	result->sd = sd;
+	result->bufferRef = 0;
+	result->bufferLength = 0;
+	result->idleTimestamp = time_getTimeMus();
+	result->ip = NULL;
+	result->buffer = NULL;
+	result->request = NULL;
+	result->prev = NULL;
+	result->next = NULL;
+
+	if(server->socket.protocol == SOCKET_PROTOCOL_TCPIP) {
+		socket_getPeerName(&server->socket, sd, &result->ip);
+	}
+
+	mutex_lock(&server->event.mutex);
+
+	if(server->event.connections != NULL) {
+		server->event.connections->prev = (void *)result;
+		result->next = (void *)server->event.connections;
+	}
+
+	server->event.connections = result;
+	server->event.connectionCount += 1;
+
+	mutex_unlock(&server->event.mutex);
+
+	return result;
+}
+
+static void unlinkConnection(Server *server, ServerConnection *connection)
+{
+	ServerConnection *prev = NULL;
+	ServerConnection *next = NULL;
+
+	prev = (ServerConnection *)connection->prev;
+	next = (ServerConnection *)connection->next;
+
+	if(prev != NULL) {
+		prev->next = (void *)next;
+	}
+	else {
+		server->event.connections = next;
+	}
+
+	if(next != NULL) {
+		next->prev = (void *)prev;
+	}
+
+	connection->prev = NULL;
+	connection->next = NULL;
+
+	server->event.connectionCount -= 1;
+}
+
+static void releaseConnection(Server *server, ServerConnection *connection)
+{
+	epoll_ctl(server->event.descriptor, EPOLL_CTL_DEL, connection->sd, NULL);
+
+	if(socket_closeChildSocket(&server->socket, connection->sd) < 0) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"failed to close event connection on %i", connection->sd);
+
+		recordError(server, SERVER_ERROR_SOCKET_CLOSE);
+	}
+
+	if(connection->request != NULL) {
+		server->manager->recvFreeFunction(server->manager->receiveContext,
+				connection->request);
+	}
+
+	if(connection->ip != NULL) {
+		free(connection->ip);
+	}
+
+	if(connection->buffer != NULL) {
+		free(connection->buffer);
+	}
+
+	free(connection);
+}
+
+static void closeConnection(Server *server, ServerConnection *connection)
+{
+	mutex_lock(&server->event.mutex);
+
+	unlinkConnection(server, connection);
+
+	mutex_unlock(&server->event.mutex);
+
+	releaseConnection(server, connection);
+}
+
+static void reapIdleConnections(Server *server)
+{
+	double timestamp = 0.0;
+
+	ServerConnection *node = NULL;
+	ServerConnection *next = NULL;
+	ServerConnection *reaped = NULL;
+
+	timestamp = time_getTimeMus();
+
+	// only armed connections are idle, and only the reactor disarms them, so
+	// they can be unlinked here and released once the list is unlocked
+
+	mutex_lock(&server->event.mutex);
+
+	node = server->event.connections;
+
+	while(node != NULL) {
+		next = (ServerConnection *)node->next;
+
+		if((node->isArmed) &&
+				(((timestamp - node->idleTimestamp) / REAL_ONE_MILLION) >=
+				 server->event.idleTimeoutSeconds)) {
+			unlinkConnection(server, node);
+
+			node->next = (void *)reaped;
+			reaped = node;
+		}
+
+		node = next;
+	}
+
+	mutex_unlock(&server->event.mutex);
+
+	while(reaped != NULL) {
+		next = (ServerConnection *)reaped->next;
+
+		log_logf(server->log, LOG_LEVEL_DEBUG,
+				"reactor closed idle connection #%i", reaped->sd);
+
+		releaseConnection(server, reaped);
+
+		reaped = next;
+	}
+}
+
+static void closeAllConnections(Server *server)
+{
+	void *item = NULL;
+
+	mutex_lock(&server->event.mutex);
+
+	do {
+		fifostack_pop(&server->event.queue, &item);
+	} while(item != NULL);
+
+	mutex_unlock(&server->event.mutex);
+
+	while(server->event.connections != NULL) {
+		closeConnection(server, server->event.connections);
+	}
+}
+
+static int armConnection(Server *server, ServerConnection *connection)
+{
+	struct epoll_event event;
+
+	memset(&event, 0, (int)(sizeof(struct epoll_event)));
+
+	event.events = (EPOLLIN | EPOLLRDHUP | EPOLLONESHOT);
+	event.data.ptr = (void *)connection;
+
+	mutex_lock(&server->event.mutex);
+
+	connection->isArmed = atrue;
+	connection->idleTimestamp = time_getTimeMus();
+
+	mutex_unlock(&server->event.mutex);
+
+	if(epoll_ctl(server->event.descriptor, EPOLL_CTL_MOD, connection->sd,
+				&event) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static int readConnection(Server *server, ServerConnection *connection)
+{
+	int rc = 0;
+
+	do {
+		if((connection->bufferLength - connection->bufferRef) <
+				SERVER_EVENT_READ_LENGTH) {
+			if((connection->bufferRef + SERVER_EVENT_READ_LENGTH) >
+					SERVER_EVENT_MAX_BUFFER_LENGTH) {
+				log_logf(server->log, LOG_LEVEL_ERROR,
+						"event connection on %i exceeded the maximum "
+						"buffer length of %i bytes",
+						connection->sd, SERVER_EVENT_MAX_BUFFER_LENGTH);
+
+				recordError(server, SERVER_ERROR_SOCKET_READ);
+
+				return -1;
+			}
+
+			if(connection->buffer == NULL) {
+				connection->bufferLength = SERVER_EVENT_READ_LENGTH;
+				connection->buffer = (char *)malloc(sizeof(char) *
+						connection->bufferLength);
+			}
+			else {
+				connection->bufferLength *= 2;
+				connection->buffer = (char *)realloc(connection->buffer,
+						(sizeof(char) * connection->bufferLength));
+			}
+		}
+
+		rc = recv(connection->sd,
+				(connection->buffer + connection->bufferRef),
+				(connection->bufferLength - connection->bufferRef),
+				MSG_DONTWAIT);
+
+		if(rc > 0) {
+			connection->bufferRef += rc;
+
+			mutex_lock(&server->socket.metrics.mutex);
+
+			server->socket.metrics.bytesReceived += (alint)rc;
+			server->socket.metrics.readsAttempted += 1;
+			server->socket.metrics.readsCompleted += 1;
+
+			mutex_unlock(&server->socket.metrics.mutex);
+		}
+	} while(rc > 0);
+
+	if((rc < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+				(errno == EINTR))) {
+		return 0;
+	}
+
+	// the peer closed the connection, or the read failed
+
+	return -1;
+}
+
+static int frameConnection(Server *server, ServerConnection *connection)
+{
+	int errorCode = 0;
+	int bytesConsumed = 0;
+
+	if(connection->bufferRef < 1) {
+		return 0;
+	}
+
+	connection->request = transactionManager_receiveBuffer(server->manager,
+			&server->socket,
+			connection->sd,
+			connection->buffer,
+			connection->bufferRef,
+			&bytesConsumed,
+			&errorCode);
+
+	if(connection->request == NULL) {
+		if(errorCode < 0) {
+			recordTransactionError(server, errorCode);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	if(bytesConsumed < connection->bufferRef) {
+		memmove(connection->buffer, (connection->buffer + bytesConsumed),
+				(connection->bufferRef - bytesConsumed));
+	}
+
+	connection->bufferRef -= bytesConsumed;
+
+	return 1;
+}
+
+static void executeConnection(Server *server, ServerConnection *connection)
+{
+	aboolean isSocketLeftOpen = afalse;
+	int rc = 0;
+	double timer = 0.0;
+	double timing = 0.0;
+
+	do {
+		isSocketLeftOpen = afalse;
+
+		timer = time_getTimeMus();
+
+		if((rc = transactionManager_executeRequest(server->manager,
+						&server->socket,
+						connection->sd,
+						connection->request,
+						&isSocketLeftOpen)) < 0) {
+			log_logf(server->log, LOG_LEVEL_ERROR,
+					"event connection on %i transaction manager execution "
+					"failure '%s'",
+					connection->sd, transactionManager_getErrorString(rc));
+
+			recordTransactionError(server, rc);
+		}
+
+		connection->request = NULL;
+
+		timing = time_getElapsedMusInSeconds(timer);
+
+		recordMetric(server, SERVER_METRIC_TRANSACTION, timing);
+
+		if((rc < 0) || (!isSocketLeftOpen)) {
+			closeConnection(server, connection);
+			return;
+		}
+
+		// execute any requests pipelined behind the one just answered
+
+		rc = frameConnection(server, connection);
+	} while((rc > 0) && (server->state == SERVER_STATE_RUNNING));
+
+	if((rc < 0) || (server->state != SERVER_STATE_RUNNING) ||
+			(armConnection(server, connection) < 0)) {
+		closeConnection(server, connection);
+	}
+}
+
+static void acceptConnections(Server *server)
+{
+	int sd = 0;
+	int listenSd = 0;
+
+	struct epoll_event event;
+
+	ServerConnection *connection = NULL;
+
+	listenSd = socket_getSocketDescriptor(&server->socket);
+
+	while((sd = accept(listenSd, NULL, NULL)) >= 0) {
+		if(server->event.connectionCount >=
+				server->event.maxConnectionLength) {
+			log_logf(server->log, LOG_LEVEL_ERROR,
+					"refused connection #%i, server is at its maximum of %i "
+					"connections", sd, server->event.maxConnectionLength);
+
+			recordError(server, SERVER_ERROR_SOCKET_ACCEPT);
+
+			socket_closeChildSocket(&server->socket, sd);
+
+			continue;
+		}
+
+		connection = newConnection(server, sd);
+
+		memset(&event, 0, (int)(sizeof(struct epoll_event)));
+
+		event.events = (EPOLLIN | EPOLLRDHUP | EPOLLONESHOT);
+		event.data.ptr = (void *)connection;
+
+		if(epoll_ctl(server->event.descriptor, EPOLL_CTL_ADD, sd,
+					&event) < 0) {
+			log_logf(server->log, LOG_LEVEL_ERROR,
+					"failed to register connection #%i with the reactor", sd);
+
+			recordError(server, SERVER_ERROR_SOCKET_ACCEPT);
+
+			closeConnection(server, connection);
+
+			continue;
+		}
+
+		log_logf(server->log, LOG_LEVEL_DEBUG,
+				"reactor accepted socket connection #%i", sd);
+	}
+
+	if((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"reactor failed to accept socket connection");
+
+		recordError(server, SERVER_ERROR_SOCKET_ACCEPT);
+	}
+}
+
+static int startEventMode(Server *server)
+{
+	int listenSd = 0;
+	int isNonBlocking = 1;
+
+	struct epoll_event event;
+
+	if(!transactionManager_isReceiveBufferEnabled(server->manager)) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"event mode requires a transaction manager receive buffer "
+				"function");
+		return -1;
+	}
+
+	if(server->socket.protocol != SOCKET_PROTOCOL_TCPIP) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"event mode requires a TCP/IP socket");
+		return -1;
+	}
+
+	listenSd = socket_getSocketDescriptor(&server->socket);
+
+	if(ioctl(listenSd, FIONBIO, &isNonBlocking) < 0) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"failed to set the listening socket to non-blocking");
+		return -1;
+	}
+
+	if((server->event.descriptor = epoll_create(
+					server->event.maxConnectionLength)) < 0) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"failed to create the reactor event descriptor");
+		return -1;
+	}
+
+	memset(&event, 0, (int)(sizeof(struct epoll_event)));
+
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;
+
+	if(epoll_ctl(server->event.descriptor, EPOLL_CTL_ADD, listenSd,
+				&event) < 0) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"failed to register the listening socket with the reactor");
+		close(server->event.descriptor);
+		server->event.descriptor = -1;
+		return -1;
+	}
+
+	if(tmf_spawnThread(&server->tmf,
+				eventReactorThread,
+				(void *)server,
+				&server->event.reactorThreadId) < 0) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"failed to spawn reactor thread");
+		close(server->event.descriptor);
+		server->event.descriptor = -1;
+		return -1;
+	}
+
+	return 0;
+}
+
+static void stopEventMode(Server *server)
+{
+	if(server->event.descriptor < 0) {
+		return;
+	}
+
+	closeAllConnections(server);
+
+	close(server->event.descriptor);
+
+	server->event.descriptor = -1;
+}
+
+static void *eventReactorThread(void *threadContext, void *argument)
+{
+	int ii = 0;
+	int rc = 0;
+	int result = 0;
+	int eventCount = 0;
+	double reapTimer = 0.0;
+
+	struct epoll_event events[SERVER_EVENT_WAIT_LENGTH];
+
+	TmfThread *thread = NULL;
+	Server *server = NULL;
+	ServerConnection *connection = NULL;
+
+	thread = (TmfThread *)threadContext;
+	server = (Server *)argument;
+
+	log_logf(server->log, LOG_LEVEL_INFO,
+			"server '%s' reactor thread #%i (%i) started",
+			server->name, thread->uid, thread->systemId);
+
+	mutex_lock(thread->mutex);
+	thread->status = THREAD_STATUS_BUSY;
+	mutex_unlock(thread->mutex);
+
+	reapTimer = time_getTimeMus();
+
+	while((thread->state == THREAD_STATE_RUNNING) &&
+			(thread->signal == THREAD_SIGNAL_OK) &&
+			(server->state == SERVER_STATE_RUNNING)) {
+		if((eventCount = epoll_wait(server->event.descriptor, events,
+						SERVER_EVENT_WAIT_LENGTH,
+						SERVER_EVENT_WAIT_MILLIS)) < 0) {
+			if(errno != EINTR) {
+				log_logf(server->log, LOG_LEVEL_ERROR,
+						"reactor failed to wait on event descriptor");
+				time_usleep(1024);
+			}
+			continue;
+		}
+
+		for(ii = 0; ii < eventCount; ii++) {
+			if(events[ii].data.ptr == NULL) {
+				acceptConnections(server);
+				continue;
+			}
+
+			connection = (ServerConnection *)events[ii].data.ptr;
+
+			// the event disarmed the connection, and the reactor is the only
+			// thread to observe the flag while it is disarmed
+
+			connection->isArmed = afalse;
+
+			// buffer whatever has arrived, then hand complete requests to
+			// the worker pool; the connection stays disarmed until then
+
+			rc = readConnection(server, connection);
+
+			if((result = frameConnection(server, connection)) > 0) {
+				mutex_lock(&server->event.mutex);
+				fifostack_push(&server->event.queue, (void *)connection);
+				mutex_unlock(&server->event.mutex);
+			}
+			else if((rc < 0) || (result < 0) ||
+					(armConnection(server, connection) < 0)) {
+				closeConnection(server, connection);
+			}
+		}
+
+		// close persistent connections left idle past the timeout
+
+		if(time_getElapsedMusInSeconds(reapTimer) >=
+				SERVER_EVENT_REAP_INTERVAL_SECONDS) {
+			reapIdleConnections(server);
+
+			reapTimer = time_getTimeMus();
+		}
+	}
+
+	log_logf(server->log, LOG_LEVEL_INFO,
+			"server '%s' reactor thread #%i (%i) shut down",
+			server->name, thread->uid, thread->systemId);
+
+	if(thread->state == THREAD_STATE_RUNNING) {
+		mutex_lock(thread->mutex);
+		thread->state = THREAD_STATE_HALT;
+		mutex_unlock(thread->mutex);
+	}
+
+	return NULL;
+}
+
+static void *eventWorkerThread(void *threadContext, void *argument)
+{
+	int serverThreadId = 0;
+	int napMicros = 0;
+
+	TmfThread *thread = NULL;
+	Server *server = NULL;
+	WorkerThreadArgs *worker = NULL;
+	ServerConnection *connection = NULL;
+
+	if((threadContext == NULL) || (argument == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	thread = (TmfThread *)threadContext;
+	worker = (WorkerThreadArgs *)argument;
+	server = worker->server;
+	serverThreadId = worker->serverThreadId;
+
+	log_logf(server->log, LOG_LEVEL_INFO,
+			"server '%s' event worker #%i thread #%i (%i) started",
+			server->name, serverThreadId, thread->uid, thread->systemId);
+
+	mutex_lock(&server->threads.mutex);
+	mutex_lock(thread->mutex);
+
+	thread->status = THREAD_STATUS_NAPPING;
+
+	server->threads.list[serverThreadId].state = (int)thread->state;
+	server->threads.list[serverThreadId].status = (int)thread->status;
+	server->threads.list[serverThreadId].signal = (int)thread->signal;
+	server->threads.list[serverThreadId].id = (int)thread->uid;
+
+	mutex_unlock(thread->mutex);
+
+	server->threads.currentThreadPoolLength += 1;
+
+	mutex_unlock(&server->threads.mutex);
+
+	napMicros = SERVER_EVENT_MIN_NAP_MICROS;
+
+	while((thread->state == THREAD_STATE_RUNNING) &&
+			(thread->signal == THREAD_SIGNAL_OK) &&
+			(server->state == SERVER_STATE_RUNNING)) {
+		// obtain the next connection with a buffered request
+
+		mutex_lock(&server->event.mutex);
+		fifostack_pop(&server->event.queue, (void *)&connection);
+		mutex_unlock(&server->event.mutex);
+
+		if(connection == NULL) {
+			time_usleep(napMicros);
+
+			if(napMicros < SERVER_EVENT_MAX_NAP_MICROS) {
+				napMicros *= 2;
+			}
+
+			continue;
+		}
+
+		napMicros = SERVER_EVENT_MIN_NAP_MICROS;
+
+		// set status to busy
+
+		mutex_lock(&server->threads.mutex);
+		mutex_lock(thread->mutex);
+
+		thread->status = THREAD_STATUS_BUSY;
+		server->threads.list[serverThreadId].status = (int)thread->status;
+
+		if(server->threads.list[serverThreadId].ip != NULL) {
+			free(server->threads.list[serverThreadId].ip);
+			server->threads.list[serverThreadId].ip = NULL;
+		}
+
+		if(connection->ip != NULL) {
+			server->threads.list[serverThreadId].ip = strdup(connection->ip);
+		}
 
-		if(socket_closeChildSocket(&server->socket, sd) < 0) {
-			log_logf(server->log, LOG_LEVEL_ERROR,
-					"worker #%i failed to close child socket on %i",
-					serverThreadId, sd);
+		mutex_unlock(thread->mutex);
+		mutex_unlock(&server->threads.mutex);
 
-			recordError(server, SERVER_ERROR_SOCKET_CLOSE);
-		}
+		executeConnection(server, connection);
 
 		// set status to napping
 
@@ -765,13 +1638,6 @@ static void *serverWorkerThread(void *threadContext, void *argument)
 		mutex_unlock(&server->threads.mutex);
 	}
 
-	if(shutdownRequested) {
-		while((thread->state == THREAD_STATE_RUNNING) &&
-				(thread->signal == THREAD_SIGNAL_OK)) {
-			time_usleep(1024);
-		}
-	}
-
 	if(thread->state == THREAD_STATE_RUNNING) {
 		mutex_lock(thread->mutex);
 		thread->state = THREAD_STATE_HALT;
@@ -796,17 +1662,21 @@ static void *serverWorkerThread(void *threadContext, void *argument)
 	mutex_unlock(&server->threads.mutex);
 
 	log_logf(server->log, LOG_LEVEL_INFO,
-			"server '%s' worker #%i thread #%i (%i) shut down",
+			"server '%s' event worker #%i thread #%i (%i) shut down",
 			server->name, serverThreadId, thread->uid, thread->systemId);
 
 	return NULL;
 }
 
+#endif // __linux__
+
 
 // define server public functions
 
 int server_init(Server *server, Log *log)
 {
+	int ii = 0;
+
 	if(server == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
@@ -831,9 +1701,9 @@ int server_init(Server *server, Log *log)
 	server->startTimestamp = 0.0;
 	server->name = strdup("Asgard Server");
 
-	mutex_init(&server->errors.mutex);
-
-	mutex_init(&server->metrics.mutex);
+	for(ii = 0; ii < SERVER_METRIC_LENGTH; ii++) {
+		histogram_init(&server->metrics.latencies[ii]);
+	}
 
 	mutex_init(&server->tracking.mutex);
 
@@ -843,6 +1713,16 @@ int server_init(Server *server, Log *log)
 
 	mutex_init(&server->packets.mutex);
 
+	server->mode = SERVER_MODE_THREADED;
+
+	server->event.descriptor = -1;
+	server->event.maxConnectionLength = SERVER_DEFAULT_MAX_CONNECTION_LENGTH;
+	server->event.idleTimeoutSeconds = SERVER_DEFAULT_IDLE_TIMEOUT_SECONDS;
+
+	fifostack_init(&server->event.queue);
+
+	mutex_init(&server->event.mutex);
+
 	server->manager = NULL;
 
 	tmf_init(&server->tmf);
@@ -890,6 +1770,10 @@ int server_free(Server *server)
 			mutex_unlock(&server->mutex);
 		}
 
+#if defined(__linux__)
+		stopEventMode(server);
+#endif // __linux__
+
 		mutex_lock(&server->mutex);
 
 		if(socket_close(&server->socket) < 0) {
@@ -944,16 +1828,16 @@ int server_free(Server *server)
 		free(server->log);
 	}
 
-	mutex_free(&server->errors.mutex);
-
-	mutex_free(&server->metrics.mutex);
-
 	mutex_free(&server->tracking.mutex);
 
 	mutex_free(&server->threads.mutex);
 
 	mutex_free(&server->packets.mutex);
 
+	fifostack_free(&server->event.queue);
+
+	mutex_free(&server->event.mutex);
+
 	mutex_unlock(&server->mutex);
 
 	mutex_free(&server->mutex);
@@ -995,6 +1879,27 @@ char *server_getServerStateString(ServerStates state)
 	return result;
 }
 
+char *server_getServerModeString(ServerModes mode)
+{
+	char *result = NULL;
+
+	switch(mode) {
+		case SERVER_MODE_THREADED:
+			result = "Threaded";
+			break;
+
+		case SERVER_MODE_EVENT:
+			result = "Event";
+			break;
+
+		case SERVER_MODE_UNKNOWN:
+		default:
+			result = "Unknown";
+	}
+
+	return result;
+}
+
 char *server_getServerErrorString(ServerErrors error)
 {
 	char *result = NULL;
@@ -1097,6 +2002,108 @@ int server_setName(Server *server, char *name)
 	return 0;
 }
 
+ServerModes server_getServerMode(Server *server)
+{
+	ServerModes result = SERVER_MODE_UNKNOWN;
+
+	if(server == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return SERVER_MODE_UNKNOWN;
+	}
+
+	mutex_lock(&server->mutex);
+
+	result = (ServerModes)server->mode;
+
+	mutex_unlock(&server->mutex);
+
+	return result;
+}
+
+int server_setServerMode(Server *server, ServerModes mode)
+{
+	if((server == NULL) ||
+			((mode != SERVER_MODE_THREADED) && (mode != SERVER_MODE_EVENT))) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+#if !defined(__linux__)
+	if(mode == SERVER_MODE_EVENT) {
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"event mode is not available on this platform");
+		return -1;
+	}
+#endif // !__linux__
+
+	mutex_lock(&server->mutex);
+
+	if(server->state != SERVER_STATE_INIT) {
+		mutex_unlock(&server->mutex);
+
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"unable to set server mode when not in init mode");
+
+		return -1;
+	}
+
+	server->mode = (int)mode;
+
+	mutex_unlock(&server->mutex);
+
+	return 0;
+}
+
+int server_setMaxConnectionLength(Server *server, int maxConnectionLength)
+{
+	if((server == NULL) || (maxConnectionLength < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&server->mutex);
+
+	if(server->state != SERVER_STATE_INIT) {
+		mutex_unlock(&server->mutex);
+
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"unable to set max connection length when not in init mode");
+
+		return -1;
+	}
+
+	server->event.maxConnectionLength = maxConnectionLength;
+
+	mutex_unlock(&server->mutex);
+
+	return 0;
+}
+
+int server_setIdleTimeout(Server *server, double seconds)
+{
+	if((server == NULL) || (seconds <= 0.0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&server->mutex);
+
+	if(server->state != SERVER_STATE_INIT) {
+		mutex_unlock(&server->mutex);
+
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"unable to set idle timeout when not in init mode");
+
+		return -1;
+	}
+
+	server->event.idleTimeoutSeconds = seconds;
+
+	mutex_unlock(&server->mutex);
+
+	return 0;
+}
+
 int server_setThreadPoolOptions(Server *server,
 		aboolean isThreadPoolShrinkEnabled, int minThreadPoolLength,
 		int maxThreadPoolLength)
@@ -1505,14 +2512,28 @@ int server_start(Server *server)
 	}
 
 	log_logf(server->log, LOG_LEVEL_INFO,
-			"server '%s' started on '%s:%i' using protocol '%s'",
+			"server '%s' started on '%s:%i' using protocol '%s' in "
+			"'%s' mode",
 			server->name,
 			server->socket.hostname,
 			server->socket.port,
-			socket_socketProtocolToString(server->socket.protocol));
+			socket_socketProtocolToString(server->socket.protocol),
+			server_getServerModeString((ServerModes)server->mode));
 
 	server->state = SERVER_STATE_RUNNING;
 
+#if defined(__linux__)
+	if((server->mode == SERVER_MODE_EVENT) && (startEventMode(server) < 0)) {
+		server->state = SERVER_STATE_ERROR;
+		mutex_unlock(&server->mutex);
+
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"failed to start event mode");
+
+		return -1;
+	}
+#endif // __linux__
+
 	if(tmf_spawnThread(&server->tmf,
 				manageServerThread,
 				(void *)server,
@@ -1601,6 +2622,10 @@ int server_stop(Server *server)
 
 	tmf_init(&server->tmf);
 
+#if defined(__linux__)
+	stopEventMode(server);
+#endif // __linux__
+
 	log_logf(server->log, LOG_LEVEL_INFO, "closing socket");
 
 	if(socket_close(&server->socket) < 0) {
@@ -1622,18 +2647,23 @@ ArrayList *server_getStatus(Server *server)
 {
 	int ii = 0;
 	int id = 0;
+	int handlerLength = 0;
 	int currentThreadCount = 0;
 	int activeThreadCount = 0;
+	alint metricCount = 0;
 	alint transactionsExecuted = 0;
 	double elapsedTime = 0.0;
+	double metricTiming = 0.0;
 	double totalTransactionTime = 0;
 	char key[1024];
 	char name[1024];
 	char value[1024];
 	char description[1024];
 
+	Histogram *histogram = NULL;
 	ArrayList *result = NULL;
 	ServerStatus *entry = NULL;
+	TransactionHandler **handlers = NULL;
 
 	if(server == NULL) {
 		DISPLAY_INVALID_ARGS;
@@ -1699,9 +2729,28 @@ ArrayList *server_getStatus(Server *server)
 			"The name of the server instance.");
 	arraylist_add(result, entry);
 
-	// server errors
+	// server mode & open connections
+
+	entry = newServerStatus("serverMode",
+			"Server Mode",
+			server_getServerModeString((ServerModes)server->mode),
+			"The connection handling mode of the server.");
+	arraylist_add(result, entry);
 
-	mutex_lock(&server->errors.mutex);
+	mutex_lock(&server->event.mutex);
+
+	snprintf(value, ((int)sizeof(value) - 1), "%i",
+			server->event.connectionCount);
+
+	mutex_unlock(&server->event.mutex);
+
+	entry = newServerStatus("serverOpenConnections",
+			"Server Open Connections",
+			value,
+			"The number of connections held open by the event reactor.");
+	arraylist_add(result, entry);
+
+	// server errors
 
 	for(ii = 0; ii < SERVER_ERROR_LENGTH; ii++) {
 		switch(ii) {
@@ -1751,13 +2800,14 @@ ArrayList *server_getStatus(Server *server)
 		arraylist_add(result, entry);
 	}
 
-	mutex_unlock(&server->errors.mutex);
-
 	// server metrics
 
-	mutex_lock(&server->metrics.mutex);
-
 	for(ii = 0; ii < SERVER_METRIC_LENGTH; ii++) {
+		histogram = &server->metrics.latencies[ii];
+		metricCount = histogram_getCount(histogram);
+		metricTiming = ((double)histogram_getSum(histogram) /
+				REAL_ONE_MILLION);
+
 		switch(ii) {
 			case SERVER_METRIC_TOTAL:
 				strcpy(key, "metricTotalCount");
@@ -1776,8 +2826,7 @@ ArrayList *server_getStatus(Server *server)
 		snprintf(name, ((int)sizeof(name) - 1), "Metric %s Count",
 				server_getServerMetricString((ServerMetrics)ii));
 
-		snprintf(value, ((int)sizeof(value) - 1), "%lli",
-				server->metrics.counter[ii]);
+		snprintf(value, ((int)sizeof(value) - 1), "%lli", metricCount);
 
 		entry = newServerStatus(key, name, value,
 				"A total count metric tracked by the server instance.");
@@ -1802,8 +2851,7 @@ ArrayList *server_getStatus(Server *server)
 		snprintf(name, ((int)sizeof(name) - 1), "Metric %s Timing",
 				server_getServerMetricString((ServerMetrics)ii));
 
-		snprintf(value, ((int)sizeof(value) - 1), "%0.6f",
-				server->metrics.timings[ii]);
+		snprintf(value, ((int)sizeof(value) - 1), "%0.6f", metricTiming);
 
 		entry = newServerStatus(key, name, value,
 				"A total timing metric tracked by the server instance.");
@@ -1829,17 +2877,37 @@ ArrayList *server_getStatus(Server *server)
 				server_getServerMetricString((ServerMetrics)ii));
 
 		snprintf(value, ((int)sizeof(value) - 1), "%0.6f",
-				(server->metrics.timings[ii] /
-				 (double)server->metrics.counter[ii]));
+				(metricTiming / (double)metricCount));
 
 		entry = newServerStatus(key, name, value,
 				"An averaged performance metric tracked by the server "
 				"instance.");
 
 		arraylist_add(result, entry);
-	}
 
-	mutex_unlock(&server->metrics.mutex);
+		switch(ii) {
+			case SERVER_METRIC_TOTAL:
+				strcpy(key, "metricTotalLatency");
+				break;
+
+			case SERVER_METRIC_TRANSACTION:
+				strcpy(key, "metricTransactionLatency");
+				break;
+
+			case SERVER_METRIC_LENGTH:
+			case SERVER_METRIC_UNKNOWN:
+			default:
+				strcpy(key, "metricUnknownLatency");
+		}
+
+		snprintf(name, ((int)sizeof(name) - 1), "Metric %s Latency",
+				server_getServerMetricString((ServerMetrics)ii));
+
+		addLatencyStatus(result, key, name,
+				"A latency percentile, in seconds, tracked by the server "
+				"instance.",
+				histogram);
+	}
 
 	// server tracking
 
@@ -2106,9 +3174,46 @@ ArrayList *server_getStatus(Server *server)
 
 	arraylist_add(result, entry);
 
-	// transaction manager errors
+	// transaction handler metrics, by message ID
+
+	handlers = transactionManager_getHandlers(server->manager,
+			&handlerLength);
+
+	for(ii = 0; ii < handlerLength; ii++) {
+		histogram = &handlers[ii]->metrics.latency;
+
+		snprintf(key, ((int)sizeof(key) - 1), "transactionHandler[%s]Count",
+				handlers[ii]->messageId);
+
+		snprintf(name, ((int)sizeof(name) - 1),
+				"Transaction Handler '%s' Count", handlers[ii]->messageId);
+
+		snprintf(value, ((int)sizeof(value) - 1), "%lli",
+				histogram_getCount(histogram));
+
+		entry = newServerStatus(key, name, value,
+				"The number of executions of a transaction manager "
+				"handler.");
+
+		arraylist_add(result, entry);
+
+		snprintf(key, ((int)sizeof(key) - 1), "transactionHandler[%s]",
+				handlers[ii]->messageId);
+
+		snprintf(name, ((int)sizeof(name) - 1),
+				"Transaction Handler '%s' Latency", handlers[ii]->messageId);
+
+		addLatencyStatus(result, key, name,
+				"A latency percentile, in seconds, of a transaction manager "
+				"handler.",
+				histogram);
+	}
+
+	if(handlers != NULL) {
+		free(handlers);
+	}
 
-	mutex_lock(&server->manager->errors.mutex);
+	// transaction manager errors
 
 	for(ii = 0; ii < TRANSACTION_ERROR_LENGTH; ii++) {
 		if(ii == (TRANSACTION_ERROR_LENGTH - 1)) {
@@ -2181,8 +3286,6 @@ ArrayList *server_getStatus(Server *server)
 		arraylist_add(result, entry);
 	}
 
-	mutex_unlock(&server->manager->errors.mutex);
-
 	// server socket
 
 	entry = newServerStatus("socketState",
@@ -2428,6 +3531,176 @@ ArrayList *server_getStatus(Server *server)
 	return result;
 }
 
+char *server_getPrometheusStatus(Server *server, int *statusLength)
+{
+	int ii = 0;
+	int id = 0;
+	int handlerLength = 0;
+	int bufferLength = 0;
+	int resultRef = 0;
+	int resultLength = 0;
+	char serverName[256];
+	char labelValue[256];
+	char labels[1024];
+	char buffer[2048];
+	char *result = NULL;
+
+	TransactionHandler **handlers = NULL;
+
+	if((server == NULL) || (statusLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(statusLength != NULL) {
+			*statusLength = 0;
+		}
+
+		return NULL;
+	}
+
+	*statusLength = 0;
+
+	mutex_lock(&server->mutex);
+
+	if(server->state != SERVER_STATE_RUNNING) {
+		mutex_unlock(&server->mutex);
+
+		log_logf(server->log, LOG_LEVEL_ERROR,
+				"unable to obtain status in current server state");
+
+		return NULL;
+	}
+
+	escapePrometheusLabel(server->name, serverName, (int)sizeof(serverName));
+
+	mutex_unlock(&server->mutex);
+
+	resultRef = 0;
+	resultLength = 8192;
+	result = (char *)malloc(sizeof(char) * resultLength);
+	result[0] = '\0';
+
+	// server uptime and connections
+
+	mutex_lock(&server->event.mutex);
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"# HELP asgard_server_uptime_seconds The server uptime.\n"
+			"# TYPE asgard_server_uptime_seconds gauge\n"
+			"asgard_server_uptime_seconds{server=\"%s\"} %0.6f\n"
+			"# HELP asgard_server_open_connections The connections held "
+			"open by the event reactor.\n"
+			"# TYPE asgard_server_open_connections gauge\n"
+			"asgard_server_open_connections{server=\"%s\"} %i\n",
+			serverName,
+			time_getElapsedMusInSeconds(server->startTimestamp),
+			serverName,
+			server->event.connectionCount);
+
+	mutex_unlock(&server->event.mutex);
+
+	result = strxpndcat(result, &resultRef, &resultLength, buffer,
+			bufferLength);
+
+	// server errors, the total is left to the query
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"# HELP asgard_server_errors_total The errors tracked by the "
+			"server instance.\n"
+			"# TYPE asgard_server_errors_total counter\n");
+
+	result = strxpndcat(result, &resultRef, &resultLength, buffer,
+			bufferLength);
+
+	for(ii = (SERVER_ERROR_TOTAL + 1); ii < SERVER_ERROR_LENGTH; ii++) {
+		bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+				"asgard_server_errors_total{server=\"%s\",type=\"%s\"} "
+				"%lli\n",
+				serverName,
+				server_getServerErrorString((ServerErrors)ii),
+				server->errors.counter[ii]);
+
+		result = strxpndcat(result, &resultRef, &resultLength, buffer,
+				bufferLength);
+	}
+
+	// server metrics
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"# HELP asgard_server_latency_seconds The latency of the metrics "
+			"tracked by the server instance.\n"
+			"# TYPE asgard_server_latency_seconds summary\n");
+
+	result = strxpndcat(result, &resultRef, &resultLength, buffer,
+			bufferLength);
+
+	for(ii = (SERVER_METRIC_TOTAL + 1); ii < SERVER_METRIC_LENGTH; ii++) {
+		snprintf(labels, ((int)sizeof(labels) - 1),
+				"server=\"%s\",metric=\"%s\"", serverName,
+				server_getServerMetricString((ServerMetrics)ii));
+
+		result = appendPrometheusSummary(result, &resultRef, &resultLength,
+				"asgard_server_latency_seconds", labels,
+				&server->metrics.latencies[ii]);
+	}
+
+	// transaction handler metrics, by message ID
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"# HELP asgard_transaction_handler_latency_seconds The latency "
+			"of each transaction manager handler.\n"
+			"# TYPE asgard_transaction_handler_latency_seconds summary\n");
+
+	result = strxpndcat(result, &resultRef, &resultLength, buffer,
+			bufferLength);
+
+	handlers = transactionManager_getHandlers(server->manager,
+			&handlerLength);
+
+	for(ii = 0; ii < handlerLength; ii++) {
+		escapePrometheusLabel(handlers[ii]->messageId, labelValue,
+				(int)sizeof(labelValue));
+
+		snprintf(labels, ((int)sizeof(labels) - 1),
+				"server=\"%s\",message_id=\"%s\"", serverName, labelValue);
+
+		result = appendPrometheusSummary(result, &resultRef, &resultLength,
+				"asgard_transaction_handler_latency_seconds", labels,
+				&handlers[ii]->metrics.latency);
+	}
+
+	if(handlers != NULL) {
+		free(handlers);
+	}
+
+	// transaction manager errors
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"# HELP asgard_transaction_manager_errors_total The errors "
+			"tracked by the transaction manager.\n"
+			"# TYPE asgard_transaction_manager_errors_total counter\n");
+
+	result = strxpndcat(result, &resultRef, &resultLength, buffer,
+			bufferLength);
+
+	for(ii = 0; ii < (TRANSACTION_ERROR_LENGTH - 1); ii++) {
+		id = ((ii + 1) * -1);
+
+		bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+				"asgard_transaction_manager_errors_total{server=\"%s\","
+				"type=\"%s\"} %lli\n",
+				serverName,
+				transactionManager_getErrorString((TransactionErrors)id),
+				server->manager->errors.counter[ii]);
+
+		result = strxpndcat(result, &resultRef, &resultLength, buffer,
+				bufferLength);
+	}
+
+	*statusLength = resultRef;
+
+	return result;
+}
+
 void server_dumpPacket(void *context, char *packet, int packetLength)
 {
 	int rc = 0;
@@ -34,6 +34,12 @@ typedef enum _ServerStates {
 	SERVER_STATE_ERROR = -1
 } ServerStates;
 
+typedef enum _ServerModes {
+	SERVER_MODE_THREADED = 1,
+	SERVER_MODE_EVENT,
+	SERVER_MODE_UNKNOWN = -1
+} ServerModes;
+
 typedef enum _ServerErrors {
 	SERVER_ERROR_TOTAL = 0,
 	SERVER_ERROR_SOCKET_ACCEPT,
@@ -55,26 +61,33 @@ typedef enum _ServerMetrics {
 
 #define SERVER_TRACKING_ENTRY_LENGTH						30
 
+#define SERVER_DEFAULT_MAX_CONNECTION_LENGTH				65536
+
+#define SERVER_DEFAULT_IDLE_TIMEOUT_SECONDS				5.0
+
 
 // define server data types
 
+/*
+ * Errors and metrics are recorded by the worker threads without a lock, the
+ * errors with atomic increments and the metrics into sharded latency
+ * histograms (in microseconds). The tracking averages are derived from the
+ * transaction histogram by the management thread, once per second.
+ */
+
 typedef struct _ServerError {
 	alint counter[SERVER_ERROR_LENGTH];
-	Mutex mutex;
 } ServerError;
 
 typedef struct _ServerMetric {
-	alint transactionCounter;
-	alint counter[SERVER_METRIC_LENGTH];
-	double timings[SERVER_METRIC_LENGTH];
-	Mutex mutex;
+	Histogram latencies[SERVER_METRIC_LENGTH];
 } ServerMetric;
 
 typedef struct _ServerTracking {
-	double timing;
+	alint lastTiming;
+	alint lastCounter;
 	double timingAverage;
 	double timings[SERVER_TRACKING_ENTRY_LENGTH];
-	double counter;
 	double counts[SERVER_TRACKING_ENTRY_LENGTH];
 	double countAverage;
 	Mutex mutex;
@@ -108,6 +121,36 @@ typedef struct _ServerPacket {
 	Mutex mutex;
 } ServerPacket;
 
+/*
+ * In event mode a reactor thread owns the listening socket and every idle
+ * connection, handing connections with a completely buffered request to the
+ * worker pool through the ready queue.
+ */
+
+typedef struct _ServerConnection {
+	aboolean isArmed;
+	int sd;
+	int bufferRef;
+	int bufferLength;
+	double idleTimestamp;
+	char *ip;
+	char *buffer;
+	void *request;
+	void *prev;
+	void *next;
+} ServerConnection;
+
+typedef struct _ServerEvent {
+	int descriptor;
+	int reactorThreadId;
+	int maxConnectionLength;
+	int connectionCount;
+	double idleTimeoutSeconds;
+	ServerConnection *connections;
+	FifoStack queue;
+	Mutex mutex;
+} ServerEvent;
+
 typedef struct _ServerStatus {
 	char *key;
 	char *name;
@@ -119,6 +162,7 @@ typedef struct _Server {
 	aboolean isSocketInit;
 	aboolean isLogInternallyAllocated;
 	int state;
+	int mode;
 	int managerThreadId;
 	double startTimestamp;
 	char *name;
@@ -127,6 +171,7 @@ typedef struct _Server {
 	ServerTracking tracking;
 	ServerThreadList threads;
 	ServerPacket packets;
+	ServerEvent event;
 	TransactionManager *manager;
 	TmfContext tmf;
 	Socket socket;
@@ -144,6 +189,8 @@ int server_free(Server *server);
 
 char *server_getServerStateString(ServerStates state);
 
+char *server_getServerModeString(ServerModes mode);
+
 char *server_getServerErrorString(ServerErrors error);
 
 char *server_getServerMetricString(ServerMetrics metric);
@@ -152,6 +199,14 @@ char *server_getName(Server *server);
 
 int server_setName(Server *server, char *name);
 
+ServerModes server_getServerMode(Server *server);
+
+int server_setServerMode(Server *server, ServerModes mode);
+
+int server_setMaxConnectionLength(Server *server, int maxConnectionLength);
+
+int server_setIdleTimeout(Server *server, double seconds);
+
 int server_setThreadPoolOptions(Server *server,
 		aboolean isThreadPoolShrinkEnabled, int minThreadPoolLength,
 		int maxThreadPoolLength);
@@ -184,6 +239,8 @@ int server_stop(Server *server);
 
 ArrayList *server_getStatus(Server *server);
 
+char *server_getPrometheusStatus(Server *server, int *statusLength);
+
 void server_dumpPacket(void *context, char *packet, int packetLength);
 
 
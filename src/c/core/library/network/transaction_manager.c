@@ -35,8 +35,13 @@ typedef struct _DefaultResponseContext {
 
 // general functions
 
+static void recordTiming(TransactionHandler *handler, double timer);
+
 static int recordError(TransactionManager *manager, int type);
 
+static int executeRequest(TransactionManager *manager, Socket *socket,
+		int sd, void *request, double timer, aboolean *isSocketLeftOpen);
+
 // default transaction functions
 
 void *transactionManager_defaultReceiveFunction(void *manager, void *context,
@@ -78,6 +83,13 @@ static void handler_free(void *memory);
 
 // general functions
 
+static void recordTiming(TransactionHandler *handler, double timer)
+{
+	histogram_record(&handler->metrics.latency,
+			(alint)(time_getElapsedMusInSeconds(timer) *
+				REAL_ONE_MILLION));
+}
+
 static int recordError(TransactionManager *manager, int type)
 {
 	int id = 0;
@@ -89,18 +101,219 @@ static int recordError(TransactionManager *manager, int type)
 		return TRANSACTION_ERROR_INVALID_ARGS;
 	}
 
-	mutex_lock(&manager->errors.mutex);
-
 	id = ((type * -1) - 1);
 
-	manager->errors.counter[id] += 1;
-	manager->errors.counter[TRANSACTION_ERROR_TOTAL] += 1;
-
-	mutex_unlock(&manager->errors.mutex);
+	atomic_addAlint(&manager->errors.counter[id], 1);
+	atomic_addAlint(&manager->errors.counter[TRANSACTION_ERROR_TOTAL], 1);
 
 	return type;
 }
 
+static int executeRequest(TransactionManager *manager, Socket *socket,
+		int sd, void *request, double timer, aboolean *isSocketLeftOpen)
+{
+	aboolean isCached = afalse;
+	aboolean isInCache = afalse;
+	int rc = 0;
+	int hashLength = 0;
+	int messageIdLength = 0;
+	int memorySizeOfResponse = 0;
+	char *hash = NULL;
+	char *messageId = NULL;
+	void *result = NULL;
+	void *response = NULL;
+
+	TransactionHandler *handler = NULL;
+
+	messageId = manager->idFunction(manager->idContext, request,
+			&messageIdLength);
+
+	if((messageId == NULL) || (messageIdLength < 1)) {
+		if(messageId != NULL) {
+			free(messageId);
+		}
+
+		manager->recvFreeFunction(manager->receiveContext, request);
+
+		log_logf(manager->log, LOG_LEVEL_ERROR,
+				"tm failed to identify message");
+
+		return recordError(manager, TRANSACTION_ERROR_FAILED_IDENT);
+	}
+
+	log_logf(manager->log, LOG_LEVEL_DEBUG,
+			"tm identified request as '%s'", messageId);
+
+	if(manager->isCacheEnabled) {
+		hash = manager->hashFunction(manager->hashContext, request,
+				&hashLength);
+		if((hash != NULL) && (hashLength > 0)) {
+			if((managedIndex_get(&manager->cache, hash, hashLength,
+							(void *)&response) == 0) &&
+					(response != NULL)) {
+				result = manager->cloneFunction(manager->cloneContext,
+						response, &memorySizeOfResponse);
+			}
+		}
+
+		if(result != NULL) {
+			log_logf(manager->log, LOG_LEVEL_DEBUG,
+					"tm obtained cached result for message '%s' hash '%s'",
+					messageId, hash);
+
+			isInCache = atrue;
+		}
+		else {
+			log_logf(manager->log, LOG_LEVEL_DEBUG,
+					"tm has no cache entry for message '%s' hash '%s'",
+					messageId, hash);
+		}
+
+		if(hash != NULL) {
+			free(hash);
+		}
+	}
+
+	if(bptree_get(&manager->index, messageId, messageIdLength,
+				(void *)&handler) < 0) {
+		if(bptree_get(&manager->index, "default", 7,
+					(void *)&handler) < 0) {
+			manager->recvFreeFunction(manager->receiveContext, request);
+
+				log_logf(manager->log, LOG_LEVEL_ERROR,
+					"tm failed to locate handler for '%s'",
+					messageId);
+
+			free(messageId);
+
+			return recordError(manager, TRANSACTION_ERROR_MISSING_HANDLER);
+		}
+	}
+
+	if(handler == NULL) {
+		manager->recvFreeFunction(manager->receiveContext, request);
+
+		log_logf(manager->log, LOG_LEVEL_ERROR,
+				"tm obtained NULL handler for '%s'",
+				messageId);
+
+		free(messageId);
+
+		return recordError(manager, TRANSACTION_ERROR_INVALID_HANDLER);
+	}
+
+	*isSocketLeftOpen = handler->isSocketLeftOpen;
+
+	if((*isSocketLeftOpen) && (manager->keepAliveFunction != NULL)) {
+		*isSocketLeftOpen = manager->keepAliveFunction(
+				manager->keepAliveContext, request);
+	}
+
+	if(handler->functionName != NULL) {
+		log_logf(manager->log, LOG_LEVEL_DEBUG,
+				"tm using handler '%s' at 0x%lx for messsage '%s'",
+				handler->functionName, (aptrcast)handler, messageId);
+	}
+	else {
+		log_logf(manager->log, LOG_LEVEL_DEBUG,
+				"tm using handler 0x%lx for messsage '%s'",
+				(aptrcast)handler, messageId);
+	}
+
+	if(result == NULL) {
+		result = handler->function(handler->context, request,
+				&memorySizeOfResponse);
+
+		log_logf(manager->log, LOG_LEVEL_DEBUG,
+				"tm obtained result 0x%lx of %i bytes from "
+				"handler 0x%lx for message '%s'",
+				(aptrcast)result, memorySizeOfResponse,
+				(aptrcast)handler, messageId);
+
+		if((result != NULL) && (memorySizeOfResponse > 0) &&
+				(manager->isCacheEnabled)) {
+			hash = manager->hashFunction(manager->hashContext, request,
+					&hashLength);
+			if((hash != NULL) && (hashLength > 0)) {
+				if(managedIndex_put(&manager->cache, hash, hashLength,
+							(void *)result, memorySizeOfResponse) < 0) {
+					isCached = afalse;
+				}
+				else {
+					log_logf(manager->log, LOG_LEVEL_DEBUG,
+							"tm cached result 0x%lx of %i "
+							"bytes for message '%s' hash '%s'",
+							(aptrcast)result, memorySizeOfResponse,
+							messageId, hash);
+
+					isCached = atrue;
+				}
+			}
+
+			if(hash != NULL) {
+				free(hash);
+			}
+		}
+	}
+
+	manager->recvFreeFunction(manager->receiveContext, request);
+
+	if(result != NULL) {
+		log_logf(manager->log, LOG_LEVEL_DEBUG,
+				"tm sending response 0x%lx for message '%s'",
+				(aptrcast)result, messageId);
+
+		if((rc = manager->sendFunction(manager, manager->sendContext, socket,
+						sd, result)) < 0) {
+			log_logf(manager->log, LOG_LEVEL_ERROR,
+					"tm failed to send response 0x%lx for message '%s'",
+					(aptrcast)result, messageId);
+
+			rc = TRANSACTION_ERROR_WRITE;
+		}
+		else {
+			log_logf(manager->log, LOG_LEVEL_DEBUG,
+					"tm sent response 0x%lx of %i bytes for message '%s'",
+					(aptrcast)result, rc, messageId);
+		}
+
+		if(!isCached) {
+			manager->sendFreeFunction(manager->sendContext, result);
+		}
+	}
+	else {
+		log_logf(manager->log, LOG_LEVEL_ERROR,
+				"tm obtained NULL result, no response sent to client");
+
+		rc = TRANSACTION_ERROR_NULL_RESULT;
+	}
+
+	if((handler != NULL) && (!isInCache)) {
+		recordTiming(handler, timer);
+
+		if(handler->functionName != NULL) {
+			log_logf(manager->log, LOG_LEVEL_DEBUG,
+					"tm updated metrics for handler '%s' at 0x%lx for "
+					"message '%s'", handler->functionName, (aptrcast)handler,
+					messageId);
+		}
+		else {
+			log_logf(manager->log, LOG_LEVEL_DEBUG,
+					"tm updated metrics for handler 0x%lx for message '%s'",
+					(aptrcast)handler, messageId);
+		}
+	}
+
+	free(messageId);
+
+	if(rc < 0) {
+		return recordError(manager, rc);
+	}
+
+	return 0;
+}
+
+
 // default transaction functions
 
 void *transactionManager_defaultReceiveFunction(void *manager, void *context,
@@ -446,7 +659,7 @@ static TransactionHandler *handler_new(aboolean isSocketLeftOpen,
 	result->function = function;
 	result->context = context;
 
-	mutex_init(&result->metrics.mutex);
+	histogram_init(&result->metrics.latency);
 
 	return result;
 }
@@ -470,8 +683,6 @@ static void handler_free(void *memory)
 		free(handler->functionName);
 	}
 
-	mutex_free(&handler->metrics.mutex);
-
 	free(handler);
 }
 
@@ -503,8 +714,6 @@ int transactionManager_init(TransactionManager *manager, Log *log)
 	manager->hashContext = manager;
 	manager->cloneContext = manager;
 
-	mutex_init(&manager->errors.mutex);
-
 	bptree_init(&manager->index);
 	bptree_setFreeFunction(&manager->index, handler_free);
 
@@ -549,8 +758,6 @@ int transactionManager_free(TransactionManager *manager)
 		free(manager->tables);
 	}
 
-	mutex_free(&manager->errors.mutex);
-
 	bptree_free(&manager->index);
 
 	if(manager->isCacheEnabled) {
@@ -638,7 +845,7 @@ int transactionManager_enableCache(TransactionManager *manager,
 
 	spinlock_writeLock(&manager->lock);
 
-	managedIndex_init(&manager->cache, afalse);
+	managedIndex_init(&manager->cache, afalse, afalse);
 
 	if(freeFunction != NULL) {
 		managedIndex_setFreeFunction(&manager->cache, manager->sendContext,
@@ -904,26 +1111,28 @@ int transactionManager_setReceiveFunctionByName(TransactionManager *manager,
 	return result;
 }
 
-int transactionManager_setSendFunction(TransactionManager *manager,
-		void *context, TransactionManagerSendFunction sendFunction)
+int transactionManager_setReceiveBufferFunction(TransactionManager *manager,
+		void *context,
+		TransactionManagerReceiveBufferFunction receiveBufferFunction)
 {
-	if((manager == NULL) || (context == NULL) || (sendFunction == NULL)) {
+	if((manager == NULL) || (context == NULL) ||
+			(receiveBufferFunction == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
 	spinlock_writeLock(&manager->lock);
 
-	manager->sendFunction = sendFunction;
-	manager->sendContext = context;
+	manager->receiveBufferFunction = receiveBufferFunction;
+	manager->receiveBufferContext = context;
 
 	spinlock_writeUnlock(&manager->lock);
 
 	return 0;
 }
 
-int transactionManager_setSendFunctionByName(TransactionManager *manager,
-		void *context, char *functionName)
+int transactionManager_setReceiveBufferFunctionByName(
+		TransactionManager *manager, void *context, char *functionName)
 {
 	int ii = 0;
 	int result = 0;
@@ -942,9 +1151,9 @@ int transactionManager_setSendFunctionByName(TransactionManager *manager,
 		for(ii = 0; ii < manager->tableLength; ii++) {
 			if(dl_lookup(manager->tables[ii].handle, functionName,
 						&function) == 0) {
-				manager->sendFunction =
-					(TransactionManagerSendFunction)function;
-				manager->sendContext = context;
+				manager->receiveBufferFunction =
+					(TransactionManagerReceiveBufferFunction)function;
+				manager->receiveBufferContext = context;
 				result = 0;
 				break;
 			}
@@ -953,13 +1162,13 @@ int transactionManager_setSendFunctionByName(TransactionManager *manager,
 
 	if(result == 0) {
 		log_logf(manager->log, LOG_LEVEL_INFO,
-				"set transaction manager send function '%s()'",
+				"set transaction manager receive buffer function '%s()'",
 				functionName);
 	}
 	else {
 		log_logf(manager->log, LOG_LEVEL_ERROR,
-				"failed to set transaction manager send function '%s()'",
-				functionName);
+				"failed to set transaction manager receive buffer "
+				"function '%s()'", functionName);
 	}
 
 	spinlock_writeUnlock(&manager->lock);
@@ -967,25 +1176,45 @@ int transactionManager_setSendFunctionByName(TransactionManager *manager,
 	return result;
 }
 
-int transactionManager_setIdFunction(TransactionManager *manager,
-		void *context, TransactionManagerIdFunction idFunction)
+aboolean transactionManager_isReceiveBufferEnabled(TransactionManager *manager)
 {
-	if((manager == NULL) || (context == NULL) || (idFunction == NULL)) {
+	aboolean result = afalse;
+
+	if(manager == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	spinlock_readLock(&manager->lock);
+
+	if(manager->receiveBufferFunction != NULL) {
+		result = atrue;
+	}
+
+	spinlock_readUnlock(&manager->lock);
+
+	return result;
+}
+
+int transactionManager_setSendFunction(TransactionManager *manager,
+		void *context, TransactionManagerSendFunction sendFunction)
+{
+	if((manager == NULL) || (context == NULL) || (sendFunction == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
 	spinlock_writeLock(&manager->lock);
 
-	manager->idFunction = idFunction;
-	manager->idContext = context;
+	manager->sendFunction = sendFunction;
+	manager->sendContext = context;
 
 	spinlock_writeUnlock(&manager->lock);
 
 	return 0;
 }
 
-int transactionManager_setIdFunctionByName(TransactionManager *manager,
+int transactionManager_setSendFunctionByName(TransactionManager *manager,
 		void *context, char *functionName)
 {
 	int ii = 0;
@@ -1005,8 +1234,9 @@ int transactionManager_setIdFunctionByName(TransactionManager *manager,
 		for(ii = 0; ii < manager->tableLength; ii++) {
 			if(dl_lookup(manager->tables[ii].handle, functionName,
 						&function) == 0) {
-				manager->idFunction = (TransactionManagerIdFunction)function;
-				manager->idContext = context;
+				manager->sendFunction =
+					(TransactionManagerSendFunction)function;
+				manager->sendContext = context;
 				result = 0;
 				break;
 			}
@@ -1015,12 +1245,12 @@ int transactionManager_setIdFunctionByName(TransactionManager *manager,
 
 	if(result == 0) {
 		log_logf(manager->log, LOG_LEVEL_INFO,
-				"set transaction manager ID function '%s()'",
+				"set transaction manager send function '%s()'",
 				functionName);
 	}
 	else {
 		log_logf(manager->log, LOG_LEVEL_ERROR,
-				"failed to set transaction manager ID function '%s()'",
+				"failed to set transaction manager send function '%s()'",
 				functionName);
 	}
 
@@ -1029,10 +1259,136 @@ int transactionManager_setIdFunctionByName(TransactionManager *manager,
 	return result;
 }
 
-int transactionManager_setRecvFreeFunction(TransactionManager *manager,
-		ManagedIndexFreeFunction freeFunction)
+int transactionManager_setKeepAliveFunction(TransactionManager *manager,
+		void *context, TransactionManagerKeepAliveFunction keepAliveFunction)
 {
-	if((manager == NULL) || (freeFunction == NULL)) {
+	if((manager == NULL) || (context == NULL) ||
+			(keepAliveFunction == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	spinlock_writeLock(&manager->lock);
+
+	manager->keepAliveFunction = keepAliveFunction;
+	manager->keepAliveContext = context;
+
+	spinlock_writeUnlock(&manager->lock);
+
+	return 0;
+}
+
+int transactionManager_setKeepAliveFunctionByName(TransactionManager *manager,
+		void *context, char *functionName)
+{
+	int ii = 0;
+	int result = 0;
+	void *function = NULL;
+
+	if((manager == NULL) || (context == NULL) || (functionName == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	spinlock_writeLock(&manager->lock);
+
+	result = -1;
+
+	if(manager->tables != NULL) {
+		for(ii = 0; ii < manager->tableLength; ii++) {
+			if(dl_lookup(manager->tables[ii].handle, functionName,
+						&function) == 0) {
+				manager->keepAliveFunction =
+					(TransactionManagerKeepAliveFunction)function;
+				manager->keepAliveContext = context;
+				result = 0;
+				break;
+			}
+		}
+	}
+
+	if(result == 0) {
+		log_logf(manager->log, LOG_LEVEL_INFO,
+				"set transaction manager keep-alive function '%s()'",
+				functionName);
+	}
+	else {
+		log_logf(manager->log, LOG_LEVEL_ERROR,
+				"failed to set transaction manager keep-alive function "
+				"'%s()'", functionName);
+	}
+
+	spinlock_writeUnlock(&manager->lock);
+
+	return result;
+}
+
+int transactionManager_setIdFunction(TransactionManager *manager,
+		void *context, TransactionManagerIdFunction idFunction)
+{
+	if((manager == NULL) || (context == NULL) || (idFunction == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	spinlock_writeLock(&manager->lock);
+
+	manager->idFunction = idFunction;
+	manager->idContext = context;
+
+	spinlock_writeUnlock(&manager->lock);
+
+	return 0;
+}
+
+int transactionManager_setIdFunctionByName(TransactionManager *manager,
+		void *context, char *functionName)
+{
+	int ii = 0;
+	int result = 0;
+	void *function = NULL;
+
+	if((manager == NULL) || (context == NULL) || (functionName == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	spinlock_writeLock(&manager->lock);
+
+	result = -1;
+
+	if(manager->tables != NULL) {
+		for(ii = 0; ii < manager->tableLength; ii++) {
+			if(dl_lookup(manager->tables[ii].handle, functionName,
+						&function) == 0) {
+				manager->idFunction = (TransactionManagerIdFunction)function;
+				manager->idContext = context;
+				result = 0;
+				break;
+			}
+		}
+	}
+
+	if(result == 0) {
+		log_logf(manager->log, LOG_LEVEL_INFO,
+				"set transaction manager ID function '%s()'",
+				functionName);
+	}
+	else {
+		log_logf(manager->log, LOG_LEVEL_ERROR,
+				"failed to set transaction manager ID function '%s()'",
+				functionName);
+	}
+
+	spinlock_writeUnlock(&manager->lock);
+
+	return result;
+}
+
+int transactionManager_setRecvFreeFunction(TransactionManager *manager,
+		ManagedIndexFreeFunction freeFunction)
+{
+	if((manager == NULL) || (freeFunction == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
@@ -1303,19 +1659,78 @@ int transactionManager_getMetrics(TransactionManager *manager,
 		key = strdup(handler->messageId);
 		keyLength = strlen(key);
 
-		mutex_lock(&handler->metrics.mutex);
+		*transactionsExecuted += histogram_getCount(
+				&handler->metrics.latency);
+		*totalTransactionTime += ((double)histogram_getSum(
+					&handler->metrics.latency) / REAL_ONE_MILLION);
+	}
+
+	free(key);
+
+	spinlock_readUnlock(&manager->lock);
+
+	return 0;
+}
+
+TransactionHandler **transactionManager_getHandlers(
+		TransactionManager *manager, int *handlerLength)
+{
+	int keyLength = 0;
+	int resultLength = 0;
+	char *key = NULL;
+
+	TransactionHandler *handler = NULL;
+	TransactionHandler **result = NULL;
+
+	if((manager == NULL) || (handlerLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(handlerLength != NULL) {
+			*handlerLength = 0;
+		}
+
+		return NULL;
+	}
+
+	*handlerLength = 0;
+
+	spinlock_readLock(&manager->lock);
+
+	keyLength = 1;
+	key = (char *)malloc(sizeof(char) * (keyLength + 1));
+
+	memset(key, 0, (int)(sizeof(char) * (keyLength + 1)));
+
+	// handlers are never removed while the manager exists, so the caller may
+	// read their metrics after the lock is released
+
+	while(bptree_getNext(&manager->index, key, keyLength,
+				((void *)&handler)) == 0) {
+		free(key);
+
+		key = strdup(handler->messageId);
+		keyLength = strlen(key);
 
-		*transactionsExecuted += handler->metrics.transactionsExecuted;
-		*totalTransactionTime += handler->metrics.totalTransactionTime;
+		if(result == NULL) {
+			resultLength = 8;
+			result = (TransactionHandler **)malloc(
+					sizeof(TransactionHandler *) * resultLength);
+		}
+		else if(*handlerLength >= resultLength) {
+			resultLength *= 2;
+			result = (TransactionHandler **)realloc(result,
+					(sizeof(TransactionHandler *) * resultLength));
+		}
 
-		mutex_unlock(&handler->metrics.mutex);
+		result[*handlerLength] = handler;
+		*handlerLength += 1;
 	}
 
 	free(key);
 
 	spinlock_readUnlock(&manager->lock);
 
-	return 0;
+	return result;
 }
 
 char *transactionManager_execIdFunction(TransactionManager *manager,
@@ -1445,10 +1860,7 @@ void *transactionManager_execFunction(TransactionManager *manager,
 		}
 	}
 
-	mutex_lock(&handler->metrics.mutex);
-	handler->metrics.transactionsExecuted += 1;
-	handler->metrics.totalTransactionTime += time_getElapsedMusInSeconds(timer);
-	mutex_unlock(&handler->metrics.mutex);
+	recordTiming(handler, timer);
 
 	log_logf(manager->log, LOG_LEVEL_DEBUG,
 			"executed transaction manager exec function");
@@ -1460,257 +1872,138 @@ void *transactionManager_execFunction(TransactionManager *manager,
 	return result;
 }
 
-int transactionManager_execute(TransactionManager *manager, Socket *socket,
-		int sd, aboolean *isSocketLeftOpen)
+void *transactionManager_receiveBuffer(TransactionManager *manager,
+		Socket *socket, int sd, char *buffer, int bufferLength,
+		int *bytesConsumed, int *errorCode)
 {
-	aboolean isCached = afalse;
-	aboolean isInCache = afalse;
-	int rc = 0;
-	int errorCode = 0;
-	int hashLength = 0;
-	int bytesReceived = 0;
-	int messageIdLength = 0;
-	int memorySizeOfResponse = 0;
-	char *hash = NULL;
-	char *messageId = NULL;
-	double timer = 0.0;
 	void *result = NULL;
-	void *request = NULL;
-	void *response = NULL;
-
-	TransactionHandler *handler = NULL;
 
 	if((manager == NULL) || (socket == NULL) || (sd < 0) ||
-			(isSocketLeftOpen == NULL)) {
+			(buffer == NULL) || (bufferLength < 0) ||
+			(bytesConsumed == NULL) || (errorCode == NULL)) {
 		DISPLAY_INVALID_ARGS;
-		return recordError(manager, TRANSACTION_ERROR_INVALID_ARGS);
-	}
-
-	*isSocketLeftOpen = afalse;
-
-	spinlock_readLock(&manager->lock);
-
-	timer = time_getTimeMus();
-
-	request = manager->receiveFunction(manager, manager->receiveContext,
-			socket, sd, &bytesReceived, &errorCode);
-	if(request == NULL) {
-		spinlock_readUnlock(&manager->lock);
 
-		if(errorCode >= 0) {
-			errorCode = TRANSACTION_ERROR_READ;
+		if(bytesConsumed != NULL) {
+			*bytesConsumed = 0;
+		}
+		if(errorCode != NULL) {
+			*errorCode = TRANSACTION_ERROR_INVALID_ARGS;
 		}
 
-		log_logf(manager->log, LOG_LEVEL_ERROR, "tm failed to receive message");
-
-		return recordError(manager, errorCode);
+		return NULL;
 	}
 
-	log_logf(manager->log, LOG_LEVEL_DEBUG,
-			"tm received %i bytes from socket connection #%i",
-			bytesReceived, sd);
-
-	messageId = manager->idFunction(manager->idContext, request,
-			&messageIdLength);
-
-	if((messageId == NULL) || (messageIdLength < 1)) {
-		if(messageId != NULL) {
-			free(messageId);
-		}
+	*bytesConsumed = 0;
+	*errorCode = 0;
 
-		manager->recvFreeFunction(manager->receiveContext, request);
+	spinlock_readLock(&manager->lock);
 
+	if(manager->receiveBufferFunction == NULL) {
 		spinlock_readUnlock(&manager->lock);
 
 		log_logf(manager->log, LOG_LEVEL_ERROR,
-				"tm failed to identify message");
+				"tm has no receive buffer function");
 
-		return recordError(manager, TRANSACTION_ERROR_FAILED_IDENT);
-	}
-
-	log_logf(manager->log, LOG_LEVEL_DEBUG,
-			"tm identified request as '%s'", messageId);
+		*errorCode = recordError(manager, TRANSACTION_ERROR_READ);
 
-	if(manager->isCacheEnabled) {
-		hash = manager->hashFunction(manager->hashContext, request,
-				&hashLength);
-		if((hash != NULL) && (hashLength > 0)) {
-			if((managedIndex_get(&manager->cache, hash, hashLength,
-							(void *)&response) == 0) &&
-					(response != NULL)) {
-				result = manager->cloneFunction(manager->cloneContext,
-						response, &memorySizeOfResponse);
-			}
-		}
-
-		if(result != NULL) {
-			log_logf(manager->log, LOG_LEVEL_DEBUG,
-					"tm obtained cached result for message '%s' hash '%s'",
-					messageId, hash);
-
-			isInCache = atrue;
-		}
-		else {
-			log_logf(manager->log, LOG_LEVEL_DEBUG,
-					"tm has no cache entry for message '%s' hash '%s'",
-					messageId, hash);
-		}
-
-		if(hash != NULL) {
-			free(hash);
-		}
+		return NULL;
 	}
 
-	if(bptree_get(&manager->index, messageId, messageIdLength,
-				(void *)&handler) < 0) {
-		if(bptree_get(&manager->index, "default", 7,
-					(void *)&handler) < 0) {
-			manager->recvFreeFunction(manager->receiveContext, request);
-
-			spinlock_readUnlock(&manager->lock);
+	result = manager->receiveBufferFunction(manager,
+			manager->receiveBufferContext, socket, sd, buffer, bufferLength,
+			bytesConsumed, errorCode);
 
-			log_logf(manager->log, LOG_LEVEL_ERROR,
-					"tm failed to locate handler for '%s'",
-					messageId);
+	spinlock_readUnlock(&manager->lock);
 
-			free(messageId);
+	if((result == NULL) && (*errorCode < 0)) {
+		log_logf(manager->log, LOG_LEVEL_ERROR,
+				"tm failed to receive buffered message");
 
-			return recordError(manager, TRANSACTION_ERROR_MISSING_HANDLER);
-		}
+		*errorCode = recordError(manager, *errorCode);
+	}
+	else if(result != NULL) {
+		log_logf(manager->log, LOG_LEVEL_DEBUG,
+				"tm received %i buffered bytes from socket connection #%i",
+				*bytesConsumed, sd);
 	}
 
-	if(handler == NULL) {
-		manager->recvFreeFunction(manager->receiveContext, request);
-
-		spinlock_readUnlock(&manager->lock);
-
-		log_logf(manager->log, LOG_LEVEL_ERROR,
-				"tm obtained NULL handler for '%s'",
-				messageId);
+	return result;
+}
 
-		free(messageId);
+int transactionManager_executeRequest(TransactionManager *manager,
+		Socket *socket, int sd, void *request, aboolean *isSocketLeftOpen)
+{
+	int result = 0;
 
-		return recordError(manager, TRANSACTION_ERROR_INVALID_HANDLER);
+	if((manager == NULL) || (socket == NULL) || (sd < 0) ||
+			(request == NULL) || (isSocketLeftOpen == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return recordError(manager, TRANSACTION_ERROR_INVALID_ARGS);
 	}
 
-	*isSocketLeftOpen = handler->isSocketLeftOpen;
+	*isSocketLeftOpen = afalse;
 
-	if(handler->functionName != NULL) {
-		log_logf(manager->log, LOG_LEVEL_DEBUG,
-				"tm using handler '%s' at 0x%lx for messsage '%s'",
-				handler->functionName, (aptrcast)handler, messageId);
-	}
-	else {
-		log_logf(manager->log, LOG_LEVEL_DEBUG,
-				"tm using handler 0x%lx for messsage '%s'",
-				(aptrcast)handler, messageId);
-	}
+	spinlock_readLock(&manager->lock);
 
-	if(result == NULL) {
-		result = handler->function(handler->context, request,
-				&memorySizeOfResponse);
+	result = executeRequest(manager, socket, sd, request, time_getTimeMus(),
+			isSocketLeftOpen);
 
-		log_logf(manager->log, LOG_LEVEL_DEBUG,
-				"tm obtained result 0x%lx of %i bytes from "
-				"handler 0x%lx for message '%s'",
-				(aptrcast)result, memorySizeOfResponse,
-				(aptrcast)handler, messageId);
+	spinlock_readUnlock(&manager->lock);
 
-		if((result != NULL) && (memorySizeOfResponse > 0) &&
-				(manager->isCacheEnabled)) {
-			hash = manager->hashFunction(manager->hashContext, request,
-					&hashLength);
-			if((hash != NULL) && (hashLength > 0)) {
-				if(managedIndex_put(&manager->cache, hash, hashLength,
-							(void *)result, memorySizeOfResponse) < 0) {
-					isCached = afalse;
-				}
-				else {
-					log_logf(manager->log, LOG_LEVEL_DEBUG,
-							"tm cached result 0x%lx of %i "
-							"bytes for message '%s' hash '%s'",
-							(aptrcast)result, memorySizeOfResponse,
-							messageId, hash);
+	return result;
+}
 
-					isCached = atrue;
-				}
-			}
+int transactionManager_execute(TransactionManager *manager, Socket *socket,
+		int sd, aboolean *isSocketLeftOpen)
+{
+	int result = 0;
+	int errorCode = 0;
+	int bytesReceived = 0;
+	double timer = 0.0;
+	void *request = NULL;
 
-			if(hash != NULL) {
-				free(hash);
-			}
-		}
+	if((manager == NULL) || (socket == NULL) || (sd < 0) ||
+			(isSocketLeftOpen == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return recordError(manager, TRANSACTION_ERROR_INVALID_ARGS);
 	}
 
-	manager->recvFreeFunction(manager->receiveContext, request);
+	*isSocketLeftOpen = afalse;
 
-	if(result != NULL) {
-		log_logf(manager->log, LOG_LEVEL_DEBUG,
-				"tm sending response 0x%lx for message '%s'",
-				(aptrcast)result, messageId);
+	spinlock_readLock(&manager->lock);
 
-		if((rc = manager->sendFunction(manager, manager->sendContext, socket,
-						sd, result)) < 0) {
-			log_logf(manager->log, LOG_LEVEL_ERROR,
-					"tm failed to send response 0x%lx for message '%s'",
-					(aptrcast)result, messageId);
+	timer = time_getTimeMus();
 
-			rc = TRANSACTION_ERROR_WRITE;
-		}
-		else {
-			log_logf(manager->log, LOG_LEVEL_DEBUG,
-					"tm sent response 0x%lx of %i bytes for message '%s'",
-					(aptrcast)result, rc, messageId);
-		}
+	request = manager->receiveFunction(manager, manager->receiveContext,
+			socket, sd, &bytesReceived, &errorCode);
+	if(request == NULL) {
+		spinlock_readUnlock(&manager->lock);
 
-		if(!isCached) {
-			manager->sendFreeFunction(manager->sendContext, result);
+		if(errorCode >= 0) {
+			errorCode = TRANSACTION_ERROR_READ;
 		}
-	}
-	else {
-		log_logf(manager->log, LOG_LEVEL_ERROR,
-				"tm obtained NULL result, no response sent to client");
 
-		rc = TRANSACTION_ERROR_NULL_RESULT;
-	}
-
-	spinlock_readUnlock(&manager->lock);
-
-	if((handler != NULL) && (!isInCache)) {
-		mutex_lock(&handler->metrics.mutex);
-		handler->metrics.transactionsExecuted += 1;
-		handler->metrics.totalTransactionTime +=
-			time_getElapsedMusInSeconds(timer);
-		mutex_unlock(&handler->metrics.mutex);
-
-		if(handler->functionName != NULL) {
+		if(errorCode == TRANSACTION_ERROR_TIMEOUT) {
 			log_logf(manager->log, LOG_LEVEL_DEBUG,
-					"tm updated metrics for handler '%s' at 0x%lx with %0.6f "
-					"avg execution time for %i transactions for message '%s'",
-					handler->functionName, (aptrcast)handler,
-					(handler->metrics.totalTransactionTime /
-					 (double)handler->metrics.transactionsExecuted),
-					handler->metrics.transactionsExecuted,
-					messageId);
+					"tm timed out waiting for a message on #%i", sd);
 		}
 		else {
-			log_logf(manager->log, LOG_LEVEL_DEBUG,
-					"tm updated metrics for handler 0x%lx with %0.6f "
-					"avg execution time for %i transactions for message '%s'",
-					(aptrcast)handler,
-					(handler->metrics.totalTransactionTime /
-					 (double)handler->metrics.transactionsExecuted),
-					handler->metrics.transactionsExecuted,
-					messageId);
+			log_logf(manager->log, LOG_LEVEL_ERROR,
+					"tm failed to receive message");
 		}
+
+		return recordError(manager, errorCode);
 	}
 
-	free(messageId);
+	log_logf(manager->log, LOG_LEVEL_DEBUG,
+			"tm received %i bytes from socket connection #%i",
+			bytesReceived, sd);
 
-	if(rc < 0) {
-		return recordError(manager, rc);
-	}
+	result = executeRequest(manager, socket, sd, request, timer,
+			isSocketLeftOpen);
 
-	return 0;
+	spinlock_readUnlock(&manager->lock);
+
+	return result;
 }
 
@@ -52,9 +52,27 @@ typedef void *(*TransactionManagerReceiveFunction)(void *manager,
 		void *context, Socket *socket, int sd, int *bytesReceived,
 		int *errorCode);
 
+/*
+ * A buffered receive function parses one complete request from the front of
+ * the buffer, setting the bytes consumed, or returns NULL with an error code
+ * of zero when the buffer does not yet hold a complete request.
+ */
+
+typedef void *(*TransactionManagerReceiveBufferFunction)(void *manager,
+		void *context, Socket *socket, int sd, char *buffer, int bufferLength,
+		int *bytesConsumed, int *errorCode);
+
 typedef int (*TransactionManagerSendFunction)(void *manager, void *context,
 		Socket *socket, int sd, void *response);
 
+/*
+ * A keep-alive function reports whether the client asked for its connection
+ * to persist, and is consulted only for handlers that leave the socket open.
+ */
+
+typedef aboolean (*TransactionManagerKeepAliveFunction)(void *context,
+		void *request);
+
 typedef char *(*TransactionManagerIdFunction)(void *context, void *request,
 		int *messageIdLength);
 
@@ -67,10 +85,13 @@ typedef char *(*TransactionManagerHashFunction)(void *context, void *request,
 typedef void *(*TransactionManagerCloneFunction)(void *context, void *response,
 		int *memorySizeOfResponse);
 
+/*
+ * Transaction latencies are recorded in microseconds, without a lock, into a
+ * histogram per handler (and therefore per message ID).
+ */
+
 typedef struct _TransactionMetrics {
-	alint transactionsExecuted;
-	double totalTransactionTime;
-	Mutex mutex;
+	Histogram latency;
 } TransactionMetrics;
 
 typedef struct _TransactionHandler {
@@ -89,7 +110,6 @@ typedef struct _TransactionTable {
 
 typedef struct _TransactionErrorMetrics {
 	alint counter[TRANSACTION_ERROR_LENGTH];
-	Mutex mutex;
 } TransactionErrorMetrics;
 
 typedef struct _TransactionManager {
@@ -100,7 +120,9 @@ typedef struct _TransactionManager {
 	TransactionErrorMetrics errors;
 	TransactionManagerPacketDumpFunction packetDumpFunction;
 	TransactionManagerReceiveFunction receiveFunction;
+	TransactionManagerReceiveBufferFunction receiveBufferFunction;
 	TransactionManagerSendFunction sendFunction;
+	TransactionManagerKeepAliveFunction keepAliveFunction;
 	TransactionManagerIdFunction idFunction;
 	TransactionManagerHashFunction hashFunction;
 	TransactionManagerCloneFunction cloneFunction;
@@ -112,7 +134,9 @@ typedef struct _TransactionManager {
 	Log *log;
 	void *packetDumpContext;
 	void *receiveContext;
+	void *receiveBufferContext;
 	void *sendContext;
+	void *keepAliveContext;
 	void *idContext;
 	void *hashContext;
 	void *cloneContext;
@@ -153,12 +177,27 @@ int transactionManager_setReceiveFunction(TransactionManager *manager,
 int transactionManager_setReceiveFunctionByName(TransactionManager *manager,
 		void *context, char *functionName);
 
+int transactionManager_setReceiveBufferFunction(TransactionManager *manager,
+		void *context,
+		TransactionManagerReceiveBufferFunction receiveBufferFunction);
+
+int transactionManager_setReceiveBufferFunctionByName(
+		TransactionManager *manager, void *context, char *functionName);
+
+aboolean transactionManager_isReceiveBufferEnabled(TransactionManager *manager);
+
 int transactionManager_setSendFunction(TransactionManager *manager,
 		void *context, TransactionManagerSendFunction sendFunction);
 
 int transactionManager_setSendFunctionByName(TransactionManager *manager,
 		void *context, char *functionName);
 
+int transactionManager_setKeepAliveFunction(TransactionManager *manager,
+		void *context, TransactionManagerKeepAliveFunction keepAliveFunction);
+
+int transactionManager_setKeepAliveFunctionByName(TransactionManager *manager,
+		void *context, char *functionName);
+
 int transactionManager_setIdFunction(TransactionManager *manager,
 		void *context, TransactionManagerIdFunction idFunction);
 
@@ -188,12 +227,22 @@ int transactionManager_addHandlerByName(TransactionManager *manager,
 int transactionManager_getMetrics(TransactionManager *manager,
 		alint *transactionsExecuted, double *totalTransactionTime);
 
+TransactionHandler **transactionManager_getHandlers(
+		TransactionManager *manager, int *handlerLength);
+
 char *transactionManager_execIdFunction(TransactionManager *manager,
 		void *request, int *messageIdLength);
 
 void *transactionManager_execFunction(TransactionManager *manager,
 		void *request);
 
+void *transactionManager_receiveBuffer(TransactionManager *manager,
+		Socket *socket, int sd, char *buffer, int bufferLength,
+		int *bytesConsumed, int *errorCode);
+
+int transactionManager_executeRequest(TransactionManager *manager,
+		Socket *socket, int sd, void *request, aboolean *isSocketLeftOpen);
+
 int transactionManager_execute(TransactionManager *manager, Socket *socket,
 		int sd, aboolean *isSocketLeftOpen);
 
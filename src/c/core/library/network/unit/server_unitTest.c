@@ -53,6 +53,34 @@
 
 #define BASIC_FUNCTIONALITY_PORT						6543
 
+#define EVENT_MODE_HOSTNAME								"127.0.0.1"
+
+#define EVENT_MODE_PORT									6544
+
+#define EVENT_MODE_CONNECTIONS							64
+
+#define EVENT_MODE_MIN_THREADS							2
+
+#define EVENT_MODE_MAX_THREADS							4
+
+#define EVENT_MODE_IDLE_TIMEOUT							1.0
+
+#define EVENT_MODE_REQUEST								\
+	"GET /event HTTP/1.1\x0d\x0a"							\
+	"Host: localhost\x0d\x0a"								\
+	"\x0d\x0a"
+
+#define EVENT_MODE_CLOSE_REQUEST						\
+	"GET /event HTTP/1.1\x0d\x0a"							\
+	"Connection: close\x0d\x0a"								\
+	"\x0d\x0a"
+
+#define EVENT_MODE_RESPONSE								\
+	"HTTP/1.1 200 OK\x0d\x0a"								\
+	"Content-Length: 2\x0d\x0a"								\
+	"\x0d\x0a"												\
+	"OK"
+
 
 // declare server unit test data types
 
@@ -77,6 +105,13 @@ static int executeClientTransaction();
 
 static int server_basicFunctionalityTest();
 
+static void *eventMode_handleRequest(void *context, void *request,
+		int *memorySizeOfResponse);
+
+static int eventMode_receiveResponse(Socket *socket, int sd);
+
+static int server_eventModeTest();
+
 
 // main function
 
@@ -96,6 +131,11 @@ int main()
 		return 1;
 	}
 
+	if(server_eventModeTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
 	printf("[unit]\t ...PASSED (%0.6f seconds)\n",
 			time_getElapsedMusInSeconds(timer));
 	printf("[unit] ...PASSED\n");
@@ -324,6 +364,8 @@ static int executeClientTransaction()
 static int server_basicFunctionalityTest()
 {
 	int ii = 0;
+	int statusLength = 0;
+	char *status = NULL;
 	void *handle = NULL;
 	void *hashFunction = NULL;
 	void *cloneFunction = NULL;
@@ -530,6 +572,23 @@ static int server_basicFunctionalityTest()
 	arraylist_free(serverStatus);
 	free(serverStatus);
 
+	// every transaction is counted by the latency histograms
+
+	if(((status = server_getPrometheusStatus(&server,
+						&statusLength)) == NULL) ||
+			(statusLength != strlen(status)) ||
+			(strstr(status, "asgard_server_latency_seconds_count{") ==
+			 NULL) ||
+			(histogram_getCount(&server.metrics.latencies[
+					SERVER_METRIC_TRANSACTION]) !=
+			 BASIC_FUNCTIONALITY_TESTS)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(status);
+
 	if(server_stop(&server) < 0) {
 		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
 				__LINE__);
@@ -553,3 +612,288 @@ static int server_basicFunctionalityTest()
 	return 0;
 }
 
+static void *eventMode_handleRequest(void *context, void *request,
+		int *memorySizeOfResponse)
+{
+	HttpTransactionManagerSend *result = NULL;
+
+	result = (HttpTransactionManagerSend *)malloc(
+			sizeof(HttpTransactionManagerSend));
+
+	result->payload = strdup(EVENT_MODE_RESPONSE);
+	result->payloadLength = strlen(result->payload);
+	result->bodyLength = 0;
+	result->body = NULL;
+	result->bodyFilename = NULL;
+
+	*memorySizeOfResponse = (int)(sizeof(HttpTransactionManagerSend) +
+			result->payloadLength);
+
+	return result;
+}
+
+static int eventMode_receiveResponse(Socket *socket, int sd)
+{
+	int length = 0;
+	char buffer[1024];
+
+	length = strlen(EVENT_MODE_RESPONSE);
+
+	if(socket_receive(socket, sd, buffer, length, 2.048) != length) {
+		return -1;
+	}
+
+	if(strncmp(buffer, EVENT_MODE_RESPONSE, length)) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static int server_eventModeTest()
+{
+	int ii = 0;
+	int length = 0;
+	int sd[EVENT_MODE_CONNECTIONS];
+	double timer = 0.0;
+	char *request = NULL;
+
+	HttpProtocol protocol;
+	TransactionManager manager;
+	Server server;
+	Socket clients[EVENT_MODE_CONNECTIONS];
+	Log log;
+
+	printf("[unit]\t server event mode test...\n");
+
+	log_init(&log, LOG_OUTPUT_STDOUT, NULL, BASIC_FUNCTIONALITY_LOG_LEVEL);
+
+	http_protocol_init(&protocol, afalse, 0, 0, 0, NULL);
+
+	transactionManager_init(&manager, &log);
+
+	if((transactionManager_setReceiveFunction(&manager, &protocol,
+					http_protocol_transactionManagerReceive) < 0) ||
+			(transactionManager_setReceiveBufferFunction(&manager, &protocol,
+					http_protocol_transactionManagerReceiveBuffer) < 0) ||
+			(transactionManager_setRecvFreeFunction(&manager,
+					http_protocol_transactionManagerReceiveFree) < 0) ||
+			(transactionManager_setSendFunction(&manager, &protocol,
+					http_protocol_transactionManagerSend) < 0) ||
+			(transactionManager_setSendFreeFunction(&manager,
+					http_protocol_transactionManagerSendFree) < 0) ||
+			(transactionManager_setKeepAliveFunction(&manager, &protocol,
+					http_protocol_transactionManagerKeepAliveFunction) < 0) ||
+			(transactionManager_setIdFunction(&manager, &protocol,
+					http_protocol_transactionManagerIdFunction) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(transactionManager_addHandler(&manager,
+				atrue,
+				"default",
+				"eventMode_handleRequest",
+				eventMode_handleRequest,
+				&protocol) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	server_init(&server, &log);
+
+	if(server_setServerMode(&server, SERVER_MODE_EVENT) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(server_setIdleTimeout(&server, EVENT_MODE_IDLE_TIMEOUT) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(server_setThreadPoolOptions(&server,
+				atrue,
+				EVENT_MODE_MIN_THREADS,
+				EVENT_MODE_MAX_THREADS) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(server_setTransactionManager(&server, &manager) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(server_setSocketOptions(&server,
+				EVENT_MODE_HOSTNAME,
+				EVENT_MODE_PORT,
+				SOCKET_PROTOCOL_TCPIP) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(server_start(&server) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// open more idle connections than there are worker threads
+
+	for(ii = 0; ii < EVENT_MODE_CONNECTIONS; ii++) {
+		if((socket_init(&clients[ii], SOCKET_MODE_CLIENT,
+						SOCKET_PROTOCOL_TCPIP, EVENT_MODE_HOSTNAME,
+						EVENT_MODE_PORT) < 0) ||
+				(socket_open(&clients[ii]) < 0) ||
+				((sd[ii] = socket_getSocketDescriptor(&clients[ii])) < 0)) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	// send each request in two partial writes
+
+	request = EVENT_MODE_REQUEST;
+	length = strlen(request);
+
+	for(ii = 0; ii < EVENT_MODE_CONNECTIONS; ii++) {
+		if(socket_send(&clients[ii], sd[ii], request, (length / 2)) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	time_usleep(16384);
+
+	for(ii = 0; ii < EVENT_MODE_CONNECTIONS; ii++) {
+		if(socket_send(&clients[ii], sd[ii], (request + (length / 2)),
+					(length - (length / 2))) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	for(ii = 0; ii < EVENT_MODE_CONNECTIONS; ii++) {
+		if(eventMode_receiveResponse(&clients[ii], sd[ii]) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	// pipeline two requests in a single write on each connection
+
+	request = EVENT_MODE_REQUEST EVENT_MODE_REQUEST;
+	length = strlen(request);
+
+	for(ii = 0; ii < EVENT_MODE_CONNECTIONS; ii++) {
+		if((socket_send(&clients[ii], sd[ii], request, length) < 0) ||
+				(eventMode_receiveResponse(&clients[ii], sd[ii]) < 0) ||
+				(eventMode_receiveResponse(&clients[ii], sd[ii]) < 0)) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if(server.event.connectionCount != EVENT_MODE_CONNECTIONS) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t\t open connections     : %i\n",
+			server.event.connectionCount);
+	printf("[unit]\t\t worker threads       : %i\n",
+			server.threads.currentThreadPoolLength);
+
+	if(server.threads.currentThreadPoolLength > EVENT_MODE_MAX_THREADS) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// a client asking to close is answered, then disconnected
+
+	request = EVENT_MODE_CLOSE_REQUEST;
+	length = strlen(request);
+
+	if((socket_send(&clients[0], sd[0], request, length) < 0) ||
+			(eventMode_receiveResponse(&clients[0], sd[0]) < 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	timer = time_getTimeMus();
+
+	while((server.event.connectionCount == EVENT_MODE_CONNECTIONS) &&
+			(time_getElapsedMusInSeconds(timer) <
+			 EVENT_MODE_IDLE_TIMEOUT)) {
+		time_usleep(1024);
+	}
+
+	if(server.event.connectionCount != (EVENT_MODE_CONNECTIONS - 1)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// the remaining connections are closed once idle past the timeout
+
+	timer = time_getTimeMus();
+
+	while((server.event.connectionCount > 0) &&
+			(time_getElapsedMusInSeconds(timer) <
+			 (EVENT_MODE_IDLE_TIMEOUT * 4.0))) {
+		time_usleep(16384);
+	}
+
+	printf("[unit]\t\t idle connections     : %i (after %0.6f seconds)\n",
+			server.event.connectionCount,
+			time_getElapsedMusInSeconds(timer));
+
+	if(server.event.connectionCount != 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < EVENT_MODE_CONNECTIONS; ii++) {
+		socket_close(&clients[ii]);
+		socket_free(&clients[ii]);
+	}
+
+	if(server_stop(&server) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(server_free(&server) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	transactionManager_free(&manager);
+
+	http_protocol_free(&protocol);
+
+	log_free(&log);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * atomic.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library atomic operations.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#define _CORE_LIBRARY_SYSTEM_COMPONENT
+#include "core/library/system/atomic.h"
+
+
+// define atomic public functions
+
+int atomic_addInt(int *target, int value)
+{
+#if defined(_MSC_VER)
+	return (InterlockedExchangeAdd((volatile long *)target, value) + value);
+#else // !_MSC_VER
+	return __sync_add_and_fetch(target, value);
+#endif // _MSC_VER
+}
+
+alint atomic_addAlint(alint *target, alint value)
+{
+#if defined(_MSC_VER)
+	return (InterlockedExchangeAdd64(target, value) + value);
+#else // !_MSC_VER
+	return __sync_add_and_fetch(target, value);
+#endif // _MSC_VER
+}
+
+aboolean atomic_compareInt(int *target, int compare, int value)
+{
+#if defined(_MSC_VER)
+	return (aboolean)(InterlockedCompareExchange((volatile long *)target,
+				(long)value, (long)compare) == (long)compare);
+#else // !_MSC_VER
+	return (aboolean)__sync_bool_compare_and_swap(target, compare, value);
+#endif // _MSC_VER
+}
+
+aboolean atomic_compareAlint(alint *target, alint compare, alint value)
+{
+#if defined(_MSC_VER)
+	return (aboolean)(InterlockedCompareExchange64(target, value,
+				compare) == compare);
+#else // !_MSC_VER
+	return (aboolean)__sync_bool_compare_and_swap(target, compare, value);
+#endif // _MSC_VER
+}
+
+aboolean atomic_comparePointer(void **target, void *compare, void *value)
+{
+#if defined(_MSC_VER)
+	return (aboolean)(InterlockedCompareExchangePointer(target, value,
+				compare) == compare);
+#else // !_MSC_VER
+	return (aboolean)__sync_bool_compare_and_swap(target, compare, value);
+#endif // _MSC_VER
+}
+
+void *atomic_swapPointer(void **target, void *value)
+{
+#if defined(_MSC_VER)
+	return InterlockedExchangePointer(target, value);
+#else // !_MSC_VER
+	// the exchange is only an acquire barrier, so precede it with a full one
+
+	__sync_synchronize();
+	return __sync_lock_test_and_set(target, value);
+#endif // _MSC_VER
+}
+
+void atomic_barrier()
+{
+#if defined(_MSC_VER)
+	MemoryBarrier();
+#else // !_MSC_VER
+	__sync_synchronize();
+#endif // _MSC_VER
+}
+
+unsigned int atomic_getThreadStripe()
+{
+	int threadId = 0;
+
+	thread_self(&threadId);
+
+	// spread the threads across striped data, since thread IDs are often
+	// aligned addresses
+
+	return (((unsigned int)threadId * 2654435761U) >> 16);
+}
+
@@ -0,0 +1,55 @@
+/*
+ * atomic.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library atomic operations, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_CORE_LIBRARY_SYSTEM_ATOMIC_H)
+
+#define _CORE_LIBRARY_SYSTEM_ATOMIC_H
+
+#if !defined(_CORE_H) && !defined(_CORE_LIBRARY_H) && \
+		!defined(_CORE_LIBRARY_SYSTEM_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _CORE_H || _CORE_LIBRARY_H || _CORE_LIBRARY_SYSTEM_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// declare atomic public functions
+
+/*
+ * The add functions return the value after the addition. Every operation
+ * is a full memory barrier.
+ */
+
+int atomic_addInt(int *target, int value);
+
+alint atomic_addAlint(alint *target, alint value);
+
+aboolean atomic_compareInt(int *target, int compare, int value);
+
+aboolean atomic_compareAlint(alint *target, alint compare, alint value);
+
+aboolean atomic_comparePointer(void **target, void *compare, void *value);
+
+void *atomic_swapPointer(void **target, void *value);
+
+void atomic_barrier();
+
+unsigned int atomic_getThreadStripe();
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _CORE_LIBRARY_SYSTEM_ATOMIC_H
+
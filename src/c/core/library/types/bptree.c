@@ -20,6 +20,8 @@
 #define SEARCH_DIRECTION_NEXT						1
 #define SEARCH_DIRECTION_PREVIOUS					0
 
+#define BULK_LOAD_FILL_PERCENT						75
+
 
 // declare b+tree private functions
 
@@ -32,16 +34,33 @@ static void bptreeInternalComplexFree(void *argument, void *memory);
 static int bptreeInternalCompareKeys(char *keyAlpha, int keyAlphaLength,
 		char *keyBeta, int keyBetaLength);
 
+static int bptreeInternalCompareIntegerKeys(char *keyAlpha,
+		int keyAlphaLength, char *keyBeta, int keyBetaLength);
+
+static aulint buildKeyPrefix(Bptree *tree, char *key, int keyLength);
+
+static int compareLink(Bptree *tree, char *key, int keyLength, aulint prefix,
+		BptreeLink *link);
+
+static int findLowerBound(Bptree *tree, BptreeNode *node, char *key,
+		int keyLength, aulint prefix);
+
+static int findUpperBound(Bptree *tree, BptreeNode *node, char *key,
+		int keyLength, aulint prefix);
+
+static int findChild(Bptree *tree, BptreeNode *node, char *key,
+		int keyLength, aulint prefix);
+
 static void displayNode(Bptree *tree, const char *function, BptreeNode *node,
 		int keyLength, int count);
 
 // tree-node functions
 
-static BptreeNode *newNode();
+static BptreeNode *newNode(Bptree *tree);
 
-static BptreeNode *splitNode(BptreeNode *node);
+static BptreeNode *splitNode(Bptree *tree, BptreeNode *node);
 
-static int validateNode(BptreeNode *node, int currentDepth);
+static int validateNode(Bptree *tree, BptreeNode *node, int currentDepth);
 
 // tree-depth functions
 
@@ -56,25 +75,37 @@ static int calculateTreeDepth(Bptree *tree);
 static void freeTree(Bptree *tree, BptreeNode *node, int currentDepth);
 
 static BptreeNode *insertLeaf(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, void *value, int currentDepth);
+		int keyLength, aulint prefix, void *value, int currentDepth);
 
 static aboolean searchTree(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, void **value);
+		int keyLength, aulint prefix, int currentDepth, void **value);
 
 static char *directionalTreeSearch(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, int direction);
+		int keyLength, aulint prefix, int currentDepth, int direction);
 
 static int exciseNode(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, int mode);
+		int keyLength, aulint prefix, int currentDepth, int mode);
 
 static int removeNode(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, int mode);
+		int keyLength, aulint prefix, int currentDepth, int mode);
 
 static void treeToArray(Bptree *tree, BptreeNode *node, int currentDepth,
 		int *listRef, int *keyListLengths, char **keyList, void **valueList);
 
 static int validateTree(Bptree *tree, BptreeNode *node, int count);
 
+static BptreeNode **bulkLoadLevel(Bptree *tree, int length,
+		BptreeNode **children, int *keyLengths, char **keys, void **values,
+		int *nodeLength);
+
+// cursor functions
+
+static int cursorPrepare(BptreeCursor *cursor);
+
+static void cursorDescend(BptreeCursor *cursor, int depth, int direction);
+
+static int cursorStep(BptreeCursor *cursor, int direction);
+
 
 // define b+tree private functions
 
@@ -134,6 +165,166 @@ static int bptreeInternalCompareKeys(char *keyAlpha, int keyAlphaLength,
 	return 0;
 }
 
+static int bptreeInternalCompareIntegerKeys(char *keyAlpha,
+		int keyAlphaLength, char *keyBeta, int keyBetaLength)
+{
+	int alphaInteger = 0;
+	int betaInteger = 0;
+
+	if((keyAlpha != NULL) && (keyAlphaLength >= SIZEOF_INT)) {
+		serialize_decodeInt(keyAlpha, keyAlphaLength, &alphaInteger);
+	}
+
+	if((keyBeta != NULL) && (keyBetaLength >= SIZEOF_INT)) {
+		serialize_decodeInt(keyBeta, keyBetaLength, &betaInteger);
+	}
+
+	if(alphaInteger < betaInteger) {
+		return -1;
+	}
+	else if(alphaInteger > betaInteger) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static aulint buildKeyPrefix(Bptree *tree, char *key, int keyLength)
+{
+	int ii = 0;
+	int intValue = 0;
+	aulint result = 0;
+
+	/*
+	 * String keys keep their first bytes packed big-endian, so that an
+	 * integer comparison of two prefixes orders them exactly as the byte
+	 * comparison of the keys would. Integer keys keep their decoded value,
+	 * biased so that negative values order before positive ones.
+	 */
+
+	if(tree->keyMode == BPTREE_KEY_MODE_STRING) {
+		for(ii = 0; ii < BPTREE_KEY_PREFIX_LENGTH; ii++) {
+			result <<= 8;
+			if(ii < keyLength) {
+				result |= (aulint)((unsigned char)key[ii]);
+			}
+		}
+	}
+	else if(tree->keyMode == BPTREE_KEY_MODE_INTEGER) {
+		if(keyLength >= SIZEOF_INT) {
+			serialize_decodeInt(key, keyLength, &intValue);
+		}
+		result = (aulint)((unsigned int)intValue ^ 0x80000000U);
+	}
+
+	return result;
+}
+
+static int compareLink(Bptree *tree, char *key, int keyLength, aulint prefix,
+		BptreeLink *link)
+{
+	if(tree->keyMode == BPTREE_KEY_MODE_CUSTOM) {
+		return tree->compareFunc(key, keyLength, link->key, link->keyLength);
+	}
+
+	if(prefix < link->prefix) {
+		return -1;
+	}
+	else if(prefix > link->prefix) {
+		return 1;
+	}
+
+	if(tree->keyMode == BPTREE_KEY_MODE_INTEGER) {
+		return 0;
+	}
+
+	/*
+	 * with equal prefixes, a key that fits entirely within the prefix is
+	 * a leading substring of the other key, so only the lengths decide
+	 */
+
+	if((keyLength <= BPTREE_KEY_PREFIX_LENGTH) ||
+			(link->keyLength <= BPTREE_KEY_PREFIX_LENGTH)) {
+		if(keyLength < link->keyLength) {
+			return -1;
+		}
+		else if(keyLength > link->keyLength) {
+			return 1;
+		}
+		return 0;
+	}
+
+	return bptreeInternalCompareKeys(
+			(key + BPTREE_KEY_PREFIX_LENGTH),
+			(keyLength - BPTREE_KEY_PREFIX_LENGTH),
+			(link->key + BPTREE_KEY_PREFIX_LENGTH),
+			(link->keyLength - BPTREE_KEY_PREFIX_LENGTH));
+}
+
+static int findLowerBound(Bptree *tree, BptreeNode *node, char *key,
+		int keyLength, aulint prefix)
+{
+	int low = 0;
+	int high = 0;
+	int middle = 0;
+
+	high = node->length;
+
+	while(low < high) {
+		middle = (low + ((high - low) / 2));
+		if(compareLink(tree, key, keyLength, prefix,
+					&node->links[middle]) > 0) {
+			low = (middle + 1);
+		}
+		else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+static int findUpperBound(Bptree *tree, BptreeNode *node, char *key,
+		int keyLength, aulint prefix)
+{
+	int low = 0;
+	int high = 0;
+	int middle = 0;
+
+	high = node->length;
+
+	while(low < high) {
+		middle = (low + ((high - low) / 2));
+		if(compareLink(tree, key, keyLength, prefix,
+					&node->links[middle]) < 0) {
+			high = middle;
+		}
+		else {
+			low = (middle + 1);
+		}
+	}
+
+	return low;
+}
+
+static int findChild(Bptree *tree, BptreeNode *node, char *key,
+		int keyLength, aulint prefix)
+{
+	int result = 0;
+
+	/*
+	 * descend into the last link whose key is not greater than the search
+	 * key, or the first link when the search key precedes every link
+	 */
+
+	result = (findUpperBound(tree, node, key, keyLength, prefix) - 1);
+	if(result < 0) {
+		result = 0;
+	}
+
+	return result;
+}
+
 static void displayNode(Bptree *tree, const char *function, BptreeNode *node,
 		int keyLength, int count)
 {
@@ -189,59 +380,40 @@ static void displayNode(Bptree *tree, const char *function, BptreeNode *node,
 
 // tree-node functions
 
-static BptreeNode *newNode()
+static BptreeNode *newNode(Bptree *tree)
 {
-	int ii = 0;
-
 	BptreeNode *node = NULL;
 
-	node = (BptreeNode *)malloc(sizeof(BptreeNode));
+	// allocate the node header and its link array as a single block
+
+	node = (BptreeNode *)malloc(sizeof(BptreeNode) +
+			(sizeof(BptreeLink) * tree->nodeElements));
 
 	node->length = 0;
-	for(ii = 0; ii < BPTREE_NODE_ELEMENTS; ii++) {
-		node->links[ii].key = NULL;
-		node->links[ii].keyLength = 0;
-		node->links[ii].value = NULL;
-		node->links[ii].next = NULL;
-	}
+	node->links = (BptreeLink *)((char *)node + sizeof(BptreeNode));
+
+	memset(node->links, 0, (sizeof(BptreeLink) * tree->nodeElements));
 
 	return node;
 }
 
-static BptreeNode *splitNode(BptreeNode *node)
+static BptreeNode *splitNode(Bptree *tree, BptreeNode *node)
 {
-	int ii = 0;
 	int nodeLength = 0;
 
 	BptreeNode *localNode = NULL;
 
-	if(node == NULL) {
+	if((tree == NULL) || (node == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		exit(1);
 	}
 
-	nodeLength = (BPTREE_NODE_ELEMENTS / 2);
-	localNode = newNode();
+	nodeLength = (tree->nodeElements / 2);
+	localNode = newNode(tree);
 
-	for(ii = 0; ii < BPTREE_NODE_ELEMENTS; ii++) {
-		if(ii < nodeLength) {
-			localNode->links[ii].key = node->links[(nodeLength + ii)].key;
-			localNode->links[ii].keyLength =
-				node->links[(nodeLength + ii)].keyLength;
-			localNode->links[ii].value = node->links[(nodeLength + ii)].value;
-			localNode->links[ii].next = node->links[(nodeLength + ii)].next;
-		}
-		else {
-			localNode->links[ii].key = NULL;
-			localNode->links[ii].keyLength = 0;
-			localNode->links[ii].value = NULL;
-			localNode->links[ii].next = NULL;
-			node->links[ii].key = NULL;
-			node->links[ii].keyLength = 0;
-			node->links[ii].value = NULL;
-			node->links[ii].next = NULL;
-		}
-	}
+	memcpy(localNode->links, &node->links[nodeLength],
+			(sizeof(BptreeLink) * nodeLength));
+	memset(&node->links[nodeLength], 0, (sizeof(BptreeLink) * nodeLength));
 
 	node->length = nodeLength;
 	localNode->length = nodeLength;
@@ -249,7 +421,7 @@ static BptreeNode *splitNode(BptreeNode *node)
 	return localNode;
 }
 
-static int validateNode(BptreeNode *node, int currentDepth)
+static int validateNode(Bptree *tree, BptreeNode *node, int currentDepth)
 {
 	int ii = 0;
 
@@ -284,6 +456,14 @@ static int validateNode(BptreeNode *node, int currentDepth)
 					(aptrcast)node, ii);
 			return -5;
 		}
+		if((ii > 0) && (compareLink(tree, node->links[ii].key,
+						node->links[ii].keyLength, node->links[ii].prefix,
+						&node->links[(ii - 1)]) <= 0)) {
+			fprintf(stderr, "[%s():%i] error - detected node 0x%lx has "
+					"out-of-order key for link %i.\n", __FUNCTION__,
+					__LINE__, (aptrcast)node, ii);
+			return -6;
+		}
 	}
 
 	return 0;
@@ -411,10 +591,9 @@ static void freeTree(Bptree *tree, BptreeNode *node, int currentDepth)
 }
 
 static BptreeNode *insertLeaf(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, void *value, int currentDepth)
+		int keyLength, aulint prefix, void *value, int currentDepth)
 {
 	int ii = 0;
-	int nn = 0;
 
 	BptreeLink link;
 	BptreeNode *localNode = NULL;
@@ -431,57 +610,55 @@ static BptreeNode *insertLeaf(Bptree *tree, BptreeNode *node, char *key,
 
 	memset((void *)&link, 0, sizeof(BptreeLink));
 
-	link.key = copyKey(key, keyLength);
-	link.keyLength = keyLength;
-	link.value = value;
-	link.next = NULL;
-
 	if(currentDepth == 0) {
-		for(ii = 0; ii < node->length; ii++) {
-			if(tree->compareFunc(key, keyLength, node->links[ii].key,
-						node->links[ii].keyLength) == -1) {
-				break;
-			}
-		}
+		ii = findUpperBound(tree, node, key, keyLength, prefix);
+
+		link.prefix = prefix;
+		link.key = copyKey(key, keyLength);
+		link.keyLength = keyLength;
+		link.value = value;
+		link.next = NULL;
 	}
 	else if(currentDepth > 0) {
-		for(ii = 0; ii < node->length; ii++) {
-			if(((ii + 1) == node->length) ||
-					(tree->compareFunc(key, keyLength,
-							node->links[(ii + 1)].key,
-							node->links[(ii + 1)].keyLength) == -1)) {
-				localNode = (BptreeNode *)insertLeaf(tree, node->links[ii].next,
-						key, keyLength, value, (currentDepth - 1));
-				free(link.key);
-				if(localNode == NULL) {
-					return NULL;
-				}
+		ii = findChild(tree, node, key, keyLength, prefix);
 
-				link.key = copyKey(localNode->links[0].key,
-						localNode->links[0].keyLength);
-				link.keyLength = localNode->links[0].keyLength;
-				link.value = NULL;
-				link.next = localNode;
-				ii++;
+		// keep the first link key as the lower bound of its subtree, so
+		// that link keys remain ordered for the binary searches
 
-				break;
-			}
+		if((ii == 0) && (compareLink(tree, key, keyLength, prefix,
+						&node->links[0]) < 0)) {
+			free(node->links[0].key);
+			node->links[0].prefix = prefix;
+			node->links[0].key = copyKey(key, keyLength);
+			node->links[0].keyLength = keyLength;
+		}
+
+		localNode = (BptreeNode *)insertLeaf(tree, node->links[ii].next,
+				key, keyLength, prefix, value, (currentDepth - 1));
+		if(localNode == NULL) {
+			return NULL;
 		}
+
+		link.prefix = localNode->links[0].prefix;
+		link.key = copyKey(localNode->links[0].key,
+				localNode->links[0].keyLength);
+		link.keyLength = localNode->links[0].keyLength;
+		link.value = NULL;
+		link.next = localNode;
+		ii++;
 	}
 
 	addToTreeDepth(tree, currentDepth);
 
-	for(nn = node->length; nn > ii; nn--) {
-		node->links[nn] = node->links[(nn - 1)];
+	if(ii < node->length) {
+		memmove(&node->links[(ii + 1)], &node->links[ii],
+				(sizeof(BptreeLink) * (node->length - ii)));
 	}
 
 	node->length++;
-	node->links[ii].key = link.key;
-	node->links[ii].keyLength = link.keyLength;
-	node->links[ii].value = link.value;
-	node->links[ii].next = link.next;
+	node->links[ii] = link;
 
-	if(node->length < BPTREE_NODE_ELEMENTS) {
+	if(node->length < tree->nodeElements) {
 		return NULL;
 	}
 
@@ -494,11 +671,11 @@ static BptreeNode *insertLeaf(Bptree *tree, BptreeNode *node, char *key,
 		addToTreeDepth(tree, currentDepth + 1);
 	}
 
-	return splitNode(node);
+	return splitNode(tree, node);
 }
 
 static aboolean searchTree(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, void **value)
+		int keyLength, aulint prefix, int currentDepth, void **value)
 {
 	int ii = 0;
 
@@ -508,36 +685,39 @@ static aboolean searchTree(Bptree *tree, BptreeNode *node, char *key,
 		exit(1);
 	}
 
+	while(currentDepth > 0) {
+		if(tree->debugMode) {
+			displayNode(tree, __FUNCTION__, node, keyLength, currentDepth);
+		}
+
+		if(node->length < 1) {
+			return afalse;
+		}
+
+		ii = findChild(tree, node, key, keyLength, prefix);
+
+		node = (BptreeNode *)node->links[ii].next;
+		currentDepth--;
+	}
+
 	if(tree->debugMode) {
 		displayNode(tree, __FUNCTION__, node, keyLength, currentDepth);
 	}
 
-	if(currentDepth == 0) {
-		for(ii = 0; ii < node->length; ii++) {
-			if(tree->compareFunc(key, keyLength, node->links[ii].key,
-						node->links[ii].keyLength) == 0) {
-				*value = node->links[ii].value;
-				return atrue;
-			}
-		}
-	}
-	else if(currentDepth > 0) {
-		for(ii = 0; ii < node->length; ii++) {
-			if(((ii + 1) == node->length) ||
-					(tree->compareFunc(key, keyLength,
-							node->links[(ii + 1)].key,
-							node->links[(ii + 1)].keyLength) == -1)) {
-				return searchTree(tree, (BptreeNode *)node->links[ii].next,
-						key, keyLength, (currentDepth - 1), value);
-			}
-		}
+	ii = findLowerBound(tree, node, key, keyLength, prefix);
+
+	if((ii < node->length) &&
+			(compareLink(tree, key, keyLength, prefix,
+						 &node->links[ii]) == 0)) {
+		*value = node->links[ii].value;
+		return atrue;
 	}
 
 	return afalse;
 }
 
 static char *directionalTreeSearch(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, int direction)
+		int keyLength, aulint prefix, int currentDepth, int direction)
 {
 	int ii = 0;
 	char *result = NULL;
@@ -554,62 +734,54 @@ static char *directionalTreeSearch(Bptree *tree, BptreeNode *node, char *key,
 		displayNode(tree, __FUNCTION__, node, keyLength, currentDepth);
 	}
 
+	if(node->length < 1) {
+		return NULL;
+	}
+
 	if(currentDepth == 0) {
 		if(direction == SEARCH_DIRECTION_NEXT) {
-			for(ii = 0; ii < node->length; ii++) {
-				if(tree->compareFunc(node->links[ii].key,
-							node->links[ii].keyLength, key, keyLength) == 1) {
-					return node->links[ii].value;
-				}
+			ii = findUpperBound(tree, node, key, keyLength, prefix);
+			if(ii < node->length) {
+				return node->links[ii].value;
 			}
 		}
 		else if(direction == SEARCH_DIRECTION_PREVIOUS) {
-			for(ii = (node->length - 1); ii > -1; ii--) {
-				if(tree->compareFunc(node->links[ii].key,
-							node->links[ii].keyLength, key,
-							keyLength) == -1) {
-					return node->links[ii].value;
-				}
+			ii = (findLowerBound(tree, node, key, keyLength, prefix) - 1);
+			if(ii > -1) {
+				return node->links[ii].value;
 			}
 		}
 	}
 	else if(currentDepth > 0) {
-		for(ii = 0; ii < node->length; ii++) {
-			if(((ii + 1) == node->length) ||
-					(tree->compareFunc(key, keyLength,
-							node->links[(ii + 1)].key,
-							node->links[(ii + 1)].keyLength) == -1)) {
-				while((result = directionalTreeSearch(tree,
-								node->links[ii].next, key, keyLength,
-								(currentDepth - 1), direction)) == NULL) {
-					if(direction == SEARCH_DIRECTION_NEXT) {
-						ii++;
-						if(ii >= node->length) {
-							break;
-						}
-					}
-					else if(direction == SEARCH_DIRECTION_PREVIOUS) {
-						ii--;
-						if(ii < 0) {
-							break;
-						}
-					}
-				}
+		ii = findChild(tree, node, key, keyLength, prefix);
 
-				return result;
+		while((result = directionalTreeSearch(tree, node->links[ii].next,
+						key, keyLength, prefix, (currentDepth - 1),
+						direction)) == NULL) {
+			if(direction == SEARCH_DIRECTION_NEXT) {
+				ii++;
+				if(ii >= node->length) {
+					break;
+				}
+			}
+			else if(direction == SEARCH_DIRECTION_PREVIOUS) {
+				ii--;
+				if(ii < 0) {
+					break;
+				}
 			}
 		}
+
+		return result;
 	}
 
 	return NULL;
 }
 
 static int exciseNode(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, int mode)
+		int keyLength, aulint prefix, int currentDepth, int mode)
 {
 	int ii = 0;
-	int nn = 0;
-	int jj = 0;
 	int foundNode = 0;
 
 	BptreeNode *localNode = NULL;
@@ -624,93 +796,70 @@ static int exciseNode(Bptree *tree, BptreeNode *node, char *key,
 		displayNode(tree, __FUNCTION__, node, keyLength, currentDepth);
 	}
 
-	for(ii = 0; ii < node->length; ii++) {
-		if(tree->compareFunc(key, keyLength, node->links[ii].key,
-					node->links[ii].keyLength) == 0) {
-			// validate that this is not simply a matching node on a
-			// non-leaf node
+	// matching links are contiguous, starting at the lower bound
 
-			if((mode == 1) && (node->links[ii].next != NULL)) {
-				continue;
-			}
+	ii = findLowerBound(tree, node, key, keyLength, prefix);
 
-			// validate that the remove link contains less than 1 items
+	for(; ii < node->length; ii++) {
+		if(compareLink(tree, key, keyLength, prefix,
+					&node->links[ii]) != 0) {
+			break;
+		}
 
-			if((mode == 1) && (node->links[ii].value != NULL)) {
-				localNode = (BptreeNode *)node->links[ii].next;
-				if(localNode != NULL) {
-					if(localNode->length > 0) {
-						fprintf(stderr, "error - node length is %i, "
-								"aborting\n", localNode->length);
-						continue;
-					}
-				}
-			}
+		// validate that this is not simply a matching node on a
+		// non-leaf node
 
-			// remove the node from the link array
-
-			foundNode = 1;
-			jj = 0;
-			for(nn = 0; nn < node->length; nn++) {
-				if(jj >= BPTREE_NODE_ELEMENTS) {
-					fprintf(stderr, "PANIC - iterator exceeded tree "
-							"order with %i of %i, aborting.\n", jj,
-							BPTREE_NODE_ELEMENTS);
-					fflush(NULL);
-					exit(1);
-				}
-				if(nn != ii) {
-					node->links[nn].key = node->links[jj].key;
-					node->links[nn].keyLength =
-						node->links[jj].keyLength;
-					node->links[nn].value = node->links[jj].value;
-					node->links[nn].next = node->links[jj].next;
-					jj++;
-				}
-				else {
-					free(node->links[jj].key);
-					node->links[jj].key = NULL;
-					node->links[jj].keyLength = 0;
-					if((node->links[jj].value != NULL) &&
-							(mode == 0)) {
-						if(tree->isComplexFree) {
-							tree->complexFreeFunc(tree->complexFreeArgument,
-									node->links[jj].value);
-						}
-						else if(tree->freeFunc ==
-								(BptreeFreeFunction)MEMORY_FREE_FUNCTION) {
-							MEMORY_FREE_FUNCTION(node->links[jj].value,
-									__FILE__, __FUNCTION__, __LINE__);
-						}
-						else {
-							tree->freeFunc(node->links[jj].value);
-						}
-					}
-					node->links[jj].value = NULL;
-					node->links[jj].next = NULL;
-					jj++;
-					node->links[nn].key = node->links[jj].key;
-					node->links[nn].keyLength =
-						node->links[jj].keyLength;
-					node->links[nn].value = node->links[jj].value;
-					node->links[nn].next = node->links[jj].next;
-					jj++;
+		if((mode == 1) && (node->links[ii].next != NULL)) {
+			continue;
+		}
+
+		// validate that the remove link contains less than 1 items
+
+		if((mode == 1) && (node->links[ii].value != NULL)) {
+			localNode = (BptreeNode *)node->links[ii].next;
+			if(localNode != NULL) {
+				if(localNode->length > 0) {
+					fprintf(stderr, "error - node length is %i, "
+							"aborting\n", localNode->length);
+					continue;
 				}
 			}
+		}
 
-			node->length -= 1;
+		// remove the node from the link array
 
-			// initialize any remaining link array items
+		foundNode = 1;
 
-			for(nn = node->length; nn < BPTREE_NODE_ELEMENTS; nn++) {
-				node->links[nn].key = NULL;
-				node->links[nn].keyLength = 0;
-				node->links[nn].value = NULL;
-				node->links[nn].next = NULL;
+		free(node->links[ii].key);
+		if((node->links[ii].value != NULL) && (mode == 0)) {
+			if(tree->isComplexFree) {
+				tree->complexFreeFunc(tree->complexFreeArgument,
+						node->links[ii].value);
+			}
+			else if(tree->freeFunc ==
+					(BptreeFreeFunction)MEMORY_FREE_FUNCTION) {
+				MEMORY_FREE_FUNCTION(node->links[ii].value, __FILE__,
+						__FUNCTION__, __LINE__);
 			}
+			else {
+				tree->freeFunc(node->links[ii].value);
+			}
+		}
 
-			break;
+		if((ii + 1) < node->length) {
+			memmove(&node->links[ii], &node->links[(ii + 1)],
+					(sizeof(BptreeLink) * (node->length - (ii + 1))));
 		}
+
+		node->length -= 1;
+
+		// initialize any remaining link array items
+
+		memset(&node->links[node->length], 0,
+				(sizeof(BptreeLink) *
+				 (tree->nodeElements - node->length)));
+
+		break;
 	}
 
 	return foundNode;
@@ -718,7 +867,7 @@ static int exciseNode(Bptree *tree, BptreeNode *node, char *key,
 
 
 static int removeNode(Bptree *tree, BptreeNode *node, char *key,
-		int keyLength, int currentDepth, int mode)
+		int keyLength, aulint prefix, int currentDepth, int mode)
 {
 	int ii = 0;
 	int found = 0;
@@ -737,11 +886,12 @@ static int removeNode(Bptree *tree, BptreeNode *node, char *key,
 
 	if((currentDepth == 0) || (mode == 1)) {
 		if(node->length > 1) {
-			found = exciseNode(tree, node, key, keyLength, currentDepth, mode);
+			found = exciseNode(tree, node, key, keyLength, prefix,
+					currentDepth, mode);
 		}
 		else if(node->length == 1) {
-			if(tree->compareFunc(key, keyLength, node->links[0].key,
-						node->links[0].keyLength) == 0) {
+			if(compareLink(tree, key, keyLength, prefix,
+						&node->links[0]) == 0) {
 				found = 1;
 				node->length = 0;
 				free(node->links[0].key);
@@ -787,38 +937,33 @@ static int removeNode(Bptree *tree, BptreeNode *node, char *key,
 				tree->depthLength = 1;
 				tree->depthCounts = (int *)malloc(
 						sizeof(int) * tree->depthLength);
-				tree->root = newNode();
+				tree->root = newNode(tree);
 			}
 		}
 
 		return 0;
 	}
-	else if(currentDepth > 0) {
-		for(ii = 0; ii < node->length; ii++) {
-			if(((ii + 1) == node->length) ||
-					(tree->compareFunc(key, keyLength,
-						node->links[(ii + 1)].key,
-						node->links[(ii + 1)].keyLength) == -1)) {
-				localNode = (BptreeNode *)node->links[ii].next;
-
-				if(removeNode(tree, (BptreeNode *)node->links[ii].next,
-							key, keyLength, (currentDepth - 1), 0) < 0) {
-					return -1;
-				}
+	else if((currentDepth > 0) && (node->length > 0)) {
+		ii = findChild(tree, node, key, keyLength, prefix);
 
-				if(localNode->length == 0) {
-					free(localNode);
-					node->links[ii].next = NULL;
-					if(removeNode(tree, node, node->links[ii].key,
-								node->links[ii].keyLength,
-								currentDepth, 1) < 0) {
-						return -1;
-					}
-				}
+		localNode = (BptreeNode *)node->links[ii].next;
+
+		if(removeNode(tree, localNode, key, keyLength, prefix,
+					(currentDepth - 1), 0) < 0) {
+			return -1;
+		}
 
-				return 0;
+		if(localNode->length == 0) {
+			free(localNode);
+			node->links[ii].next = NULL;
+			if(removeNode(tree, node, node->links[ii].key,
+						node->links[ii].keyLength, node->links[ii].prefix,
+						currentDepth, 1) < 0) {
+				return -1;
 			}
 		}
+
+		return 0;
 	}
 
 	return -1;
@@ -875,7 +1020,7 @@ static int validateTree(Bptree *tree, BptreeNode *node, int count)
 		return 0;
 	}
 
-	if((result = validateNode(node, count)) < 0) {
+	if((result = validateNode(tree, node, count)) < 0) {
 		if(result == -2) {
 			displayNode(tree, __FUNCTION__, node, -1, count);
 		}
@@ -893,6 +1038,160 @@ static int validateTree(Bptree *tree, BptreeNode *node, int count)
 	return 0;
 }
 
+static BptreeNode **bulkLoadLevel(Bptree *tree, int length,
+		BptreeNode **children, int *keyLengths, char **keys, void **values,
+		int *nodeLength)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int fill = 0;
+	int base = 0;
+	int extra = 0;
+
+	BptreeNode *node = NULL;
+	BptreeNode *child = NULL;
+	BptreeNode **result = NULL;
+
+	/*
+	 * spread the links evenly across the fewest partially-filled nodes,
+	 * building leaf links from the key & value arrays, or internal links
+	 * from the first key of each child node
+	 */
+
+	fill = ((tree->nodeElements * BULK_LOAD_FILL_PERCENT) / 100);
+	if(fill < 2) {
+		fill = 2;
+	}
+
+	*nodeLength = ((length + (fill - 1)) / fill);
+
+	base = (length / *nodeLength);
+	extra = (length % *nodeLength);
+
+	result = (BptreeNode **)malloc(sizeof(BptreeNode *) * (*nodeLength));
+
+	for(ii = 0; ii < *nodeLength; ii++) {
+		node = newNode(tree);
+		node->length = (base + ((ii < extra) ? 1 : 0));
+
+		for(nn = 0; nn < node->length; nn++, ref++) {
+			if(children == NULL) {
+				node->links[nn].prefix = buildKeyPrefix(tree, keys[ref],
+						keyLengths[ref]);
+				node->links[nn].key = copyKey(keys[ref], keyLengths[ref]);
+				node->links[nn].keyLength = keyLengths[ref];
+				node->links[nn].value = values[ref];
+				node->links[nn].next = NULL;
+				continue;
+			}
+
+			child = children[ref];
+
+			node->links[nn].prefix = child->links[0].prefix;
+			node->links[nn].key = copyKey(child->links[0].key,
+					child->links[0].keyLength);
+			node->links[nn].keyLength = child->links[0].keyLength;
+			node->links[nn].value = NULL;
+			node->links[nn].next = child;
+		}
+
+		result[ii] = node;
+	}
+
+	return result;
+}
+
+// cursor functions
+
+static int cursorPrepare(BptreeCursor *cursor)
+{
+	Bptree *tree = NULL;
+
+	tree = cursor->tree;
+
+	if(cursor->indexes == NULL) {
+		cursor->indexes = (int *)malloc(sizeof(int) *
+				(tree->treeDepth + 1));
+		cursor->nodes = (BptreeNode **)malloc(sizeof(BptreeNode *) *
+				(tree->treeDepth + 1));
+	}
+	else if((tree->treeDepth + 1) > cursor->depth) {
+		cursor->indexes = (int *)realloc(cursor->indexes,
+				(sizeof(int) * (tree->treeDepth + 1)));
+		cursor->nodes = (BptreeNode **)realloc(cursor->nodes,
+				(sizeof(BptreeNode *) * (tree->treeDepth + 1)));
+	}
+
+	cursor->depth = (tree->treeDepth + 1);
+	cursor->modificationCount = tree->modificationCount;
+	cursor->nodes[tree->treeDepth] = tree->root;
+
+	if(tree->root->length < 1) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static void cursorDescend(BptreeCursor *cursor, int depth, int direction)
+{
+	int ii = 0;
+
+	BptreeNode *node = NULL;
+
+	/*
+	 * walk down from the link selected at the given depth to its first
+	 * (or last) leaf, leaving the cursor before the first (or after the
+	 * last) leaf link
+	 */
+
+	for(ii = depth; ii > 0; ii--) {
+		node = (BptreeNode *)cursor->nodes[ii]->links[
+			cursor->indexes[ii]].next;
+
+		cursor->nodes[(ii - 1)] = node;
+
+		if(direction == SEARCH_DIRECTION_NEXT) {
+			cursor->indexes[(ii - 1)] = 0;
+		}
+		else if(ii > 1) {
+			cursor->indexes[(ii - 1)] = (node->length - 1);
+		}
+		else {
+			cursor->indexes[(ii - 1)] = node->length;
+		}
+	}
+}
+
+static int cursorStep(BptreeCursor *cursor, int direction)
+{
+	int ii = 0;
+
+	// find the closest ancestor with a sibling link in the given direction
+
+	for(ii = 1; ii < cursor->depth; ii++) {
+		if(direction == SEARCH_DIRECTION_NEXT) {
+			if((cursor->indexes[ii] + 1) < cursor->nodes[ii]->length) {
+				cursor->indexes[ii] += 1;
+				break;
+			}
+		}
+		else if(cursor->indexes[ii] > 0) {
+			cursor->indexes[ii] -= 1;
+			break;
+		}
+	}
+
+	if(ii >= cursor->depth) {
+		return -1;
+	}
+
+	cursorDescend(cursor, ii, direction);
+
+	return 0;
+}
+
 
 // define b+tree public functions
 
@@ -907,12 +1206,14 @@ int bptree_init(Bptree *tree)
 
 	tree->debugMode = afalse;
 	tree->isComplexFree = afalse;
+	tree->nodeElements = BPTREE_NODE_ELEMENTS;
 	tree->treeDepth = 0;
 	tree->leafCount = 0;
 	tree->depthLength = 1;
 	tree->depthCounts = (int *)malloc(sizeof(int) * tree->depthLength);
 	tree->complexFreeArgument = NULL;
-	tree->root = newNode();
+	tree->keyMode = BPTREE_KEY_MODE_STRING;
+	tree->root = newNode(tree);
 	tree->freeFunc = (BptreeFreeFunction)MEMORY_FREE_FUNCTION;
 	tree->complexFreeFunc =
 		(BptreeComplexFreeFunction)bptreeInternalComplexFree;
@@ -971,6 +1272,7 @@ int bptree_setCompareKeysFunction(Bptree *tree,
 		return -1;
 	}
 
+	tree->keyMode = BPTREE_KEY_MODE_CUSTOM;
 	tree->compareFunc = compareFunc;
 
 	return 0;
@@ -988,6 +1290,62 @@ int bptree_setDebugMode(Bptree *tree, aboolean debugMode)
 	return 0;
 }
 
+int bptree_setNodeElements(Bptree *tree, int nodeElements)
+{
+	if((tree == NULL) || (nodeElements < BPTREE_MINIMUM_NODE_ELEMENTS) ||
+			(nodeElements > BPTREE_MAXIMUM_NODE_ELEMENTS)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((tree->leafCount > 0) || (tree->treeDepth > 0)) {
+		fprintf(stderr, "[%s():%i] error - unable to change the node size "
+				"of a tree with %i leaves.\n", __FUNCTION__, __LINE__,
+				tree->leafCount);
+		return -1;
+	}
+
+	// splits divide a full node in half, so keep the node size even
+
+	if((nodeElements % 2) != 0) {
+		nodeElements++;
+	}
+
+	freeTree(tree, tree->root, tree->treeDepth);
+
+	tree->nodeElements = nodeElements;
+	tree->root = newNode(tree);
+
+	return 0;
+}
+
+int bptree_setKeyMode(Bptree *tree, BptreeKeyModes keyMode)
+{
+	if((tree == NULL) || ((keyMode != BPTREE_KEY_MODE_STRING) &&
+				(keyMode != BPTREE_KEY_MODE_INTEGER))) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(tree->leafCount > 0) {
+		fprintf(stderr, "[%s():%i] error - unable to change the key mode "
+				"of a tree with %i leaves.\n", __FUNCTION__, __LINE__,
+				tree->leafCount);
+		return -1;
+	}
+
+	tree->keyMode = keyMode;
+
+	if(keyMode == BPTREE_KEY_MODE_STRING) {
+		tree->compareFunc = bptreeInternalCompareKeys;
+	}
+	else {
+		tree->compareFunc = bptreeInternalCompareIntegerKeys;
+	}
+
+	return 0;
+}
+
 int bptree_getLeafCount(Bptree *tree, int *leafCount)
 {
 	if((tree == NULL) || (leafCount == NULL)) {
@@ -1026,9 +1384,12 @@ int bptree_clear(Bptree *tree)
 	freeTree(tree, tree->root, tree->treeDepth);
 	free(tree->depthCounts);
 
+	tree->treeDepth = 0;
+	tree->leafCount = 0;
+	tree->modificationCount += 1;
 	tree->depthLength = 1;
 	tree->depthCounts = (int *)malloc(sizeof(int) * tree->depthLength);
-	tree->root = newNode();
+	tree->root = newNode(tree);
 
 	return 0;
 }
@@ -1042,7 +1403,8 @@ int bptree_get(Bptree *tree, char *key, int keyLength, void **value)
 
 	*value = NULL;
 
-	if(!searchTree(tree, tree->root, key, keyLength, tree->treeDepth,
+	if(!searchTree(tree, tree->root, key, keyLength,
+				buildKeyPrefix(tree, key, keyLength), tree->treeDepth,
 				value)) {
 		return -1;
 	}
@@ -1058,7 +1420,8 @@ int bptree_getNext(Bptree *tree, char *key, int keyLength, void **value)
 	}
 
 	*value = directionalTreeSearch(tree, tree->root, key, keyLength,
-			tree->treeDepth, SEARCH_DIRECTION_NEXT);
+			buildKeyPrefix(tree, key, keyLength), tree->treeDepth,
+			SEARCH_DIRECTION_NEXT);
 	if(*value == NULL) {
 		return -1;
 	}
@@ -1074,7 +1437,8 @@ int bptree_getPrevious(Bptree *tree, char *key, int keyLength, void **value)
 	}
 
 	*value = directionalTreeSearch(tree, tree->root, key, keyLength,
-			tree->treeDepth, SEARCH_DIRECTION_PREVIOUS);
+			buildKeyPrefix(tree, key, keyLength), tree->treeDepth,
+			SEARCH_DIRECTION_PREVIOUS);
 	if(*value == NULL) {
 		return -1;
 	}
@@ -1085,6 +1449,7 @@ int bptree_getPrevious(Bptree *tree, char *key, int keyLength, void **value)
 int bptree_put(Bptree *tree, char *key, int keyLength, void *value)
 {
 	aboolean found = afalse;
+	aulint prefix = 0;
 	void *searchResult = NULL;
 
 	BptreeNode *current = NULL;
@@ -1095,30 +1460,35 @@ int bptree_put(Bptree *tree, char *key, int keyLength, void *value)
 		return -1;
 	}
 
-	found = searchTree(tree, tree->root, key, keyLength, tree->treeDepth,
-			&searchResult);
+	prefix = buildKeyPrefix(tree, key, keyLength);
+
+	found = searchTree(tree, tree->root, key, keyLength, prefix,
+			tree->treeDepth, &searchResult);
 
 	if(found) {
 		return -1;
 	}
 
 	tree->leafCount += 1;
-	newnode = insertLeaf(tree, tree->root, key, keyLength, value,
+	tree->modificationCount += 1;
+	newnode = insertLeaf(tree, tree->root, key, keyLength, prefix, value,
 			tree->treeDepth);
 
 	if(newnode == NULL) {
 		return 0;
 	}
 
-	current = newNode();
+	current = newNode(tree);
 	current->length = 2;
 
+	current->links[0].prefix = tree->root->links[0].prefix;
 	current->links[0].key = copyKey(tree->root->links[0].key,
 			tree->root->links[0].keyLength);
 	current->links[0].keyLength = tree->root->links[0].keyLength;
 	current->links[0].value = NULL;
 	current->links[0].next = tree->root;
 
+	current->links[1].prefix = newnode->links[0].prefix;
 	current->links[1].key = copyKey(newnode->links[0].key,
 			newnode->links[0].keyLength);
 	current->links[1].keyLength = newnode->links[0].keyLength;
@@ -1140,7 +1510,12 @@ int bptree_remove(Bptree *tree, char *key, int keyLength)
 		return -1;
 	}
 
-	result = removeNode(tree, tree->root, key, keyLength, tree->treeDepth, 0);
+	result = removeNode(tree, tree->root, key, keyLength,
+			buildKeyPrefix(tree, key, keyLength), tree->treeDepth, 0);
+
+	if(result == 0) {
+		tree->modificationCount += 1;
+	}
 
 	return result;
 }
@@ -1188,3 +1563,297 @@ int bptree_performInternalTest(Bptree *tree)
 	return result;
 }
 
+int bptree_bulkLoad(Bptree *tree, int arrayLength, int *keyLengths,
+		char **keys, void **values)
+{
+	int ii = 0;
+	int level = 0;
+	int nodeLength = 0;
+	int childLength = 0;
+
+	BptreeNode **nodes = NULL;
+	BptreeNode **children = NULL;
+
+	if((tree == NULL) || (arrayLength < 0) ||
+			((arrayLength > 0) &&
+			 ((keyLengths == NULL) || (keys == NULL) || (values == NULL)))) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((tree->leafCount > 0) || (tree->treeDepth > 0)) {
+		fprintf(stderr, "[%s():%i] error - unable to bulk-load a tree with "
+				"%i leaves.\n", __FUNCTION__, __LINE__, tree->leafCount);
+		return -1;
+	}
+
+	if(arrayLength == 0) {
+		return 0;
+	}
+
+	// validate that the keys are unique and in ascending order
+
+	for(ii = 0; ii < arrayLength; ii++) {
+		if((keys[ii] == NULL) || (keyLengths[ii] < 1)) {
+			fprintf(stderr, "[%s():%i] error - invalid key at %i.\n",
+					__FUNCTION__, __LINE__, ii);
+			return -1;
+		}
+
+		if((ii > 0) && (tree->compareFunc(keys[(ii - 1)],
+						keyLengths[(ii - 1)], keys[ii], keyLengths[ii]) >= 0)) {
+			fprintf(stderr, "[%s():%i] error - key %i is not in ascending "
+					"order.\n", __FUNCTION__, __LINE__, ii);
+			return -1;
+		}
+	}
+
+	// build the leaf nodes
+
+	nodes = bulkLoadLevel(tree, arrayLength, NULL, keyLengths, keys, values,
+			&nodeLength);
+
+	free(tree->root);
+	free(tree->depthCounts);
+
+	tree->leafCount = arrayLength;
+	tree->depthLength = 1;
+	tree->depthCounts = (int *)malloc(sizeof(int) * tree->depthLength);
+	tree->depthCounts[0] = arrayLength;
+
+	// build the internal levels until a single root node remains
+
+	level = 0;
+
+	while(nodeLength > 1) {
+		level++;
+
+		children = nodes;
+		childLength = nodeLength;
+
+		nodes = bulkLoadLevel(tree, childLength, children, NULL, NULL, NULL,
+				&nodeLength);
+
+		free(children);
+
+		increaseTreeDepthMemory(tree, level);
+		tree->depthCounts[level] = childLength;
+	}
+
+	tree->root = nodes[0];
+	tree->treeDepth = level;
+	tree->modificationCount += 1;
+
+	free(nodes);
+
+	return 0;
+}
+
+// cursor functions
+
+int bptree_cursorInit(BptreeCursor *cursor, Bptree *tree)
+{
+	if((cursor == NULL) || (tree == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(cursor, 0, sizeof(BptreeCursor));
+
+	cursor->depth = 0;
+	cursor->modificationCount = -1;
+	cursor->indexes = NULL;
+	cursor->nodes = NULL;
+	cursor->tree = tree;
+
+	return 0;
+}
+
+int bptree_cursorFree(BptreeCursor *cursor)
+{
+	if(cursor == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(cursor->indexes != NULL) {
+		free(cursor->indexes);
+	}
+
+	if(cursor->nodes != NULL) {
+		free(cursor->nodes);
+	}
+
+	memset(cursor, 0, sizeof(BptreeCursor));
+
+	return 0;
+}
+
+int bptree_cursorFirst(BptreeCursor *cursor)
+{
+	if(cursor == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(cursorPrepare(cursor) < 0) {
+		cursor->modificationCount = -1;
+		return -1;
+	}
+
+	cursor->indexes[cursor->tree->treeDepth] = 0;
+
+	if(cursor->tree->treeDepth > 0) {
+		cursorDescend(cursor, cursor->tree->treeDepth, SEARCH_DIRECTION_NEXT);
+	}
+
+	return 0;
+}
+
+int bptree_cursorLast(BptreeCursor *cursor)
+{
+	if(cursor == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(cursorPrepare(cursor) < 0) {
+		cursor->modificationCount = -1;
+		return -1;
+	}
+
+	if(cursor->tree->treeDepth > 0) {
+		cursor->indexes[cursor->tree->treeDepth] =
+			(cursor->tree->root->length - 1);
+		cursorDescend(cursor, cursor->tree->treeDepth,
+				SEARCH_DIRECTION_PREVIOUS);
+	}
+	else {
+		cursor->indexes[0] = cursor->tree->root->length;
+	}
+
+	return 0;
+}
+
+int bptree_cursorSeek(BptreeCursor *cursor, char *key, int keyLength,
+		aboolean isInclusive)
+{
+	int ii = 0;
+	aulint prefix = 0;
+
+	Bptree *tree = NULL;
+	BptreeNode *node = NULL;
+
+	if((cursor == NULL) || (key == NULL) || (keyLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(cursorPrepare(cursor) < 0) {
+		cursor->modificationCount = -1;
+		return -1;
+	}
+
+	tree = cursor->tree;
+	prefix = buildKeyPrefix(tree, key, keyLength);
+
+	// position the cursor before the first key at or beyond the search key
+
+	node = tree->root;
+
+	for(ii = tree->treeDepth; ii > 0; ii--) {
+		cursor->nodes[ii] = node;
+		cursor->indexes[ii] = findChild(tree, node, key, keyLength, prefix);
+		node = (BptreeNode *)node->links[cursor->indexes[ii]].next;
+	}
+
+	cursor->nodes[0] = node;
+
+	if(isInclusive) {
+		cursor->indexes[0] = findLowerBound(tree, node, key, keyLength,
+				prefix);
+	}
+	else {
+		cursor->indexes[0] = findUpperBound(tree, node, key, keyLength,
+				prefix);
+	}
+
+	return 0;
+}
+
+int bptree_cursorNext(BptreeCursor *cursor, char **key, int *keyLength,
+		void **value)
+{
+	BptreeLink *link = NULL;
+
+	if((cursor == NULL) || (value == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	*value = NULL;
+
+	if((cursor->tree == NULL) ||
+			(cursor->modificationCount != cursor->tree->modificationCount)) {
+		return -1;
+	}
+
+	while(cursor->indexes[0] >= cursor->nodes[0]->length) {
+		if(cursorStep(cursor, SEARCH_DIRECTION_NEXT) < 0) {
+			return -1;
+		}
+	}
+
+	link = &cursor->nodes[0]->links[cursor->indexes[0]];
+	cursor->indexes[0] += 1;
+
+	if(key != NULL) {
+		*key = link->key;
+	}
+	if(keyLength != NULL) {
+		*keyLength = link->keyLength;
+	}
+
+	*value = link->value;
+
+	return 0;
+}
+
+int bptree_cursorPrevious(BptreeCursor *cursor, char **key, int *keyLength,
+		void **value)
+{
+	BptreeLink *link = NULL;
+
+	if((cursor == NULL) || (value == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	*value = NULL;
+
+	if((cursor->tree == NULL) ||
+			(cursor->modificationCount != cursor->tree->modificationCount)) {
+		return -1;
+	}
+
+	while(cursor->indexes[0] < 1) {
+		if(cursorStep(cursor, SEARCH_DIRECTION_PREVIOUS) < 0) {
+			return -1;
+		}
+	}
+
+	cursor->indexes[0] -= 1;
+	link = &cursor->nodes[0]->links[cursor->indexes[0]];
+
+	if(key != NULL) {
+		*key = link->key;
+	}
+	if(keyLength != NULL) {
+		*keyLength = link->keyLength;
+	}
+
+	*value = link->value;
+
+	return 0;
+}
+
@@ -25,7 +25,20 @@ extern "C" {
 
 // define b+tree public constants
 
-#define BPTREE_NODE_ELEMENTS							8
+#define BPTREE_NODE_ELEMENTS							64
+
+#define BPTREE_MINIMUM_NODE_ELEMENTS					4
+
+#define BPTREE_MAXIMUM_NODE_ELEMENTS					4096
+
+#define BPTREE_KEY_PREFIX_LENGTH						8
+
+typedef enum _BptreeKeyModes {
+	BPTREE_KEY_MODE_STRING = 1,
+	BPTREE_KEY_MODE_INTEGER,
+	BPTREE_KEY_MODE_CUSTOM,
+	BPTREE_KEY_MODE_UNKNOWN = -1
+} BptreeKeyModes;
 
 
 // declare b+tree public data types
@@ -38,6 +51,7 @@ typedef int (*BptreeCompareKeysFunction)(char *keyAlpha, int keyAlphaLength,
 		char *keyBeta, int keyBetaLength);
 
 typedef struct _BptreeLink {
+	aulint prefix;
 	char *key;
 	int keyLength;
 	void *value;
@@ -46,23 +60,34 @@ typedef struct _BptreeLink {
 
 typedef struct _BptreeNode {
 	int length;
-	BptreeLink links[BPTREE_NODE_ELEMENTS];
+	BptreeLink *links;
 } BptreeNode;
 
 typedef struct _Bptree {
 	aboolean debugMode;
 	aboolean isComplexFree;
+	int nodeElements;
 	int treeDepth;
 	int leafCount;
+	int modificationCount;
 	int depthLength;
 	int *depthCounts;
 	void *complexFreeArgument;
+	BptreeKeyModes keyMode;
 	BptreeNode *root;
 	BptreeFreeFunction freeFunc;
 	BptreeComplexFreeFunction complexFreeFunc;
 	BptreeCompareKeysFunction compareFunc;
 } Bptree;
 
+typedef struct _BptreeCursor {
+	int depth;
+	int modificationCount;
+	int *indexes;
+	BptreeNode **nodes;
+	Bptree *tree;
+} BptreeCursor;
+
 
 // declare b+tree public functions
 
@@ -80,6 +105,10 @@ int bptree_setCompareKeysFunction(Bptree *tree,
 
 int bptree_setDebugMode(Bptree *tree, aboolean debugMode);
 
+int bptree_setNodeElements(Bptree *tree, int nodeElements);
+
+int bptree_setKeyMode(Bptree *tree, BptreeKeyModes keyMode);
+
 int bptree_getLeafCount(Bptree *tree, int *leafCount);
 
 int bptree_getTreeDepth(Bptree *tree, int *treeDepth);
@@ -99,8 +128,30 @@ int bptree_remove(Bptree *tree, char *key, int keyLength);
 int bptree_toArray(Bptree *tree, int *arrayLength, int **keyLengths,
 		char ***keys, void ***values);
 
+int bptree_bulkLoad(Bptree *tree, int arrayLength, int *keyLengths,
+		char **keys, void **values);
+
 int bptree_performInternalTest(Bptree *tree);
 
+// cursor functions
+
+int bptree_cursorInit(BptreeCursor *cursor, Bptree *tree);
+
+int bptree_cursorFree(BptreeCursor *cursor);
+
+int bptree_cursorFirst(BptreeCursor *cursor);
+
+int bptree_cursorLast(BptreeCursor *cursor);
+
+int bptree_cursorSeek(BptreeCursor *cursor, char *key, int keyLength,
+		aboolean isInclusive);
+
+int bptree_cursorNext(BptreeCursor *cursor, char **key, int *keyLength,
+		void **value);
+
+int bptree_cursorPrevious(BptreeCursor *cursor, char **key, int *keyLength,
+		void **value);
+
 
 #if defined(__cplusplus)
 };
@@ -0,0 +1,243 @@
+/*
+ * histogram.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library sharded log-linear latency histogram.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#define _CORE_LIBRARY_TYPES_COMPONENT
+#include "core/library/types/histogram.h"
+
+
+// declare histogram private functions
+
+static HistogramShard *getShard(Histogram *histogram);
+
+static int valueToIndex(alint value);
+
+static alint indexToValue(int index);
+
+
+// define histogram private functions
+
+static HistogramShard *getShard(Histogram *histogram)
+{
+	return &histogram->shards[(atomic_getThreadStripe() %
+				HISTOGRAM_SHARD_COUNT)];
+}
+
+static int valueToIndex(alint value)
+{
+	int magnitude = 0;
+
+	if(value < HISTOGRAM_SUB_BUCKET_COUNT) {
+		if(value < 0) {
+			return 0;
+		}
+		return (int)value;
+	}
+
+	magnitude = HISTOGRAM_SUB_BUCKET_BITS;
+
+	while((value >> magnitude) > 1) {
+		magnitude++;
+	}
+
+	if(magnitude > HISTOGRAM_MAX_MAGNITUDE) {
+		return (HISTOGRAM_BUCKET_COUNT - 1);
+	}
+
+	return (((magnitude - HISTOGRAM_SUB_BUCKET_BITS + 1) *
+				HISTOGRAM_SUB_BUCKET_COUNT) +
+			(int)((value >> (magnitude - HISTOGRAM_SUB_BUCKET_BITS)) &
+				(HISTOGRAM_SUB_BUCKET_COUNT - 1)));
+}
+
+static alint indexToValue(int index)
+{
+	int shift = 0;
+	alint result = 0;
+
+	// the highest value counted by the bucket
+
+	if(index < HISTOGRAM_SUB_BUCKET_COUNT) {
+		return (alint)index;
+	}
+
+	shift = ((index / HISTOGRAM_SUB_BUCKET_COUNT) - 1);
+
+	result = ((alint)(HISTOGRAM_SUB_BUCKET_COUNT +
+				(index % HISTOGRAM_SUB_BUCKET_COUNT)) << shift);
+
+	return (result + ((alint)1 << shift) - 1);
+}
+
+
+// define histogram public functions
+
+int histogram_init(Histogram *histogram)
+{
+	if(histogram == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(histogram, 0, (int)(sizeof(Histogram)));
+
+	return 0;
+}
+
+int histogram_reset(Histogram *histogram)
+{
+	return histogram_init(histogram);
+}
+
+int histogram_record(Histogram *histogram, alint value)
+{
+	alint maximum = 0;
+
+	HistogramShard *shard = NULL;
+
+	if(histogram == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(value < 0) {
+		value = 0;
+	}
+
+	shard = getShard(histogram);
+
+	atomic_addAlint(&shard->buckets[valueToIndex(value)], 1);
+	atomic_addAlint(&shard->sum, value);
+	atomic_addAlint(&shard->count, 1);
+
+	while((maximum = shard->maximum) < value) {
+		if(atomic_compareAlint(&shard->maximum, maximum, value)) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+alint histogram_getCount(Histogram *histogram)
+{
+	int ii = 0;
+	alint result = 0;
+
+	if(histogram == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return 0;
+	}
+
+	for(ii = 0; ii < HISTOGRAM_SHARD_COUNT; ii++) {
+		result += histogram->shards[ii].count;
+	}
+
+	return result;
+}
+
+alint histogram_getSum(Histogram *histogram)
+{
+	int ii = 0;
+	alint result = 0;
+
+	if(histogram == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return 0;
+	}
+
+	for(ii = 0; ii < HISTOGRAM_SHARD_COUNT; ii++) {
+		result += histogram->shards[ii].sum;
+	}
+
+	return result;
+}
+
+alint histogram_getMaximum(Histogram *histogram)
+{
+	int ii = 0;
+	alint result = 0;
+
+	if(histogram == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return 0;
+	}
+
+	for(ii = 0; ii < HISTOGRAM_SHARD_COUNT; ii++) {
+		if(histogram->shards[ii].maximum > result) {
+			result = histogram->shards[ii].maximum;
+		}
+	}
+
+	return result;
+}
+
+alint histogram_getPercentile(Histogram *histogram, double percentile)
+{
+	int ii = 0;
+	int nn = 0;
+	alint rank = 0;
+	alint total = 0;
+	alint maximum = 0;
+	alint counted = 0;
+	alint buckets[HISTOGRAM_BUCKET_COUNT];
+
+	if((histogram == NULL) || (percentile < 0.0) || (percentile > 100.0)) {
+		DISPLAY_INVALID_ARGS;
+		return 0;
+	}
+
+	// aggregate the shards once, so that the buckets and the rank agree
+
+	memset(buckets, 0, (int)(sizeof(buckets)));
+
+	for(ii = 0; ii < HISTOGRAM_SHARD_COUNT; ii++) {
+		for(nn = 0; nn < HISTOGRAM_BUCKET_COUNT; nn++) {
+			buckets[nn] += histogram->shards[ii].buckets[nn];
+		}
+
+		if(histogram->shards[ii].maximum > maximum) {
+			maximum = histogram->shards[ii].maximum;
+		}
+	}
+
+	for(nn = 0; nn < HISTOGRAM_BUCKET_COUNT; nn++) {
+		total += buckets[nn];
+	}
+
+	if(total < 1) {
+		return 0;
+	}
+
+	rank = (alint)ceil(((double)total * percentile) / 100.0);
+
+	if(rank < 1) {
+		rank = 1;
+	}
+
+	for(nn = 0; nn < HISTOGRAM_BUCKET_COUNT; nn++) {
+		counted += buckets[nn];
+
+		if(counted >= rank) {
+			break;
+		}
+	}
+
+	if((nn >= (HISTOGRAM_BUCKET_COUNT - 1)) ||
+			(indexToValue(nn) > maximum)) {
+		return maximum;
+	}
+
+	return indexToValue(nn);
+}
+
@@ -0,0 +1,89 @@
+/*
+ * histogram.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library sharded log-linear latency histogram, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_CORE_LIBRARY_TYPES_HISTOGRAM_H)
+
+#define _CORE_LIBRARY_TYPES_HISTOGRAM_H
+
+#if !defined(_CORE_H) && !defined(_CORE_LIBRARY_H) && \
+		!defined(_CORE_LIBRARY_TYPES_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _CORE_H || _CORE_LIBRARY_H || _CORE_LIBRARY_TYPES_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define histogram public constants
+
+#define HISTOGRAM_SHARD_COUNT							8
+
+#define HISTOGRAM_SUB_BUCKET_BITS						4
+
+#define HISTOGRAM_SUB_BUCKET_COUNT						\
+	(1 << HISTOGRAM_SUB_BUCKET_BITS)
+
+#define HISTOGRAM_MAX_MAGNITUDE						36
+
+#define HISTOGRAM_BUCKET_COUNT							\
+	((HISTOGRAM_MAX_MAGNITUDE - HISTOGRAM_SUB_BUCKET_BITS + 2) * \
+	 HISTOGRAM_SUB_BUCKET_COUNT)
+
+
+// declare histogram public data types
+
+/*
+ * Values (typically microseconds) below the sub-bucket count are counted
+ * exactly; above it every power of two is split into sixteen linear
+ * sub-buckets, keeping the relative error under 6.25%. Values beyond the
+ * largest magnitude are counted in the last bucket.
+ *
+ * Writers pick a shard by thread ID and only ever add atomically, so that
+ * recording never takes a lock; readers aggregate the shards, and may
+ * observe a recording in progress.
+ */
+
+typedef struct _HistogramShard {
+	alint count;
+	alint sum;
+	alint maximum;
+	alint buckets[HISTOGRAM_BUCKET_COUNT];
+} HistogramShard;
+
+typedef struct _Histogram {
+	HistogramShard shards[HISTOGRAM_SHARD_COUNT];
+} Histogram;
+
+
+// delcare histogram public functions
+
+int histogram_init(Histogram *histogram);
+
+int histogram_reset(Histogram *histogram);
+
+int histogram_record(Histogram *histogram, alint value);
+
+alint histogram_getCount(Histogram *histogram);
+
+alint histogram_getSum(Histogram *histogram);
+
+alint histogram_getMaximum(Histogram *histogram);
+
+alint histogram_getPercentile(Histogram *histogram, double percentile);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _CORE_LIBRARY_TYPES_HISTOGRAM_H
+
@@ -18,6 +18,28 @@
 #define _CORE_LIBRARY_TYPES_COMPONENT
 #include "core/library/types/intersect.h"
 
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#elif defined(__SSE2__)
+#	include <emmintrin.h>
+#endif // __AVX2__ || __SSE2__
+
+
+// define intersect private constants
+
+/*
+ * when one list is this many times longer than the other, walk the shorter
+ * list and gallop through the longer one instead of merging the two
+ */
+
+#define INTERSECT_GALLOP_RATIO							32
+
+#if defined(__AVX2__)
+#	define INTERSECT_BLOCK_LENGTH						8
+#elif defined(__SSE2__)
+#	define INTERSECT_BLOCK_LENGTH						4
+#endif // __AVX2__ || __SSE2__
+
 
 // declare intersect private functions
 
@@ -25,6 +47,38 @@ static int ascendingIntegerComparison(const void *left, const void *right);
 
 static void ascendingSort(IntersectIntegerBuffer *buffer);
 
+static void bufferFree(Intersect *intersect, IntersectIntegerBuffer *buffer);
+
+static void bufferDetach(Intersect *intersect,
+		IntersectIntegerBuffer *buffer);
+
+static void bufferDecode(Intersect *intersect,
+		IntersectIntegerBuffer *buffer);
+
+static int gallopSearch(int *array, int start, int length, int item);
+
+static int filterByGallop(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output);
+
+static int filterByGallopRuns(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output);
+
+#if defined(INTERSECT_BLOCK_LENGTH)
+static int blockCompare(int *alpha, int *beta);
+#endif // INTERSECT_BLOCK_LENGTH
+
+static int filterByMerge(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output);
+
+static int filterBuffer(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output);
+
+static int filterAgainst(IntersectIntegerBuffer *buffer, int *alpha,
+		int alphaLength, int *output);
+
+static int execAndBySearch(Intersect *intersect, aboolean isCleanMode,
+		int maxLength);
+
 
 // define intersect private functions
 
@@ -45,16 +99,395 @@ static int ascendingIntegerComparison(const void *left, const void *right)
 
 static void ascendingSort(IntersectIntegerBuffer *buffer)
 {
+	int ii = 0;
+
 	if((buffer == NULL) || (buffer->isSorted) || (buffer->length < 2) ||
 			(buffer->array == NULL)) {
 		return;
 	}
 
+	// posting lists usually arrive in order, so check before sorting
+
+	for(ii = 1; ii < buffer->length; ii++) {
+		if(buffer->array[ii] < buffer->array[(ii - 1)]) {
+			break;
+		}
+	}
+
+	if(ii >= buffer->length) {
+		buffer->isSorted = atrue;
+		return;
+	}
+
 	qsort((void *)buffer->array, buffer->length, sizeof(int),
 			ascendingIntegerComparison);
 	buffer->isSorted = atrue;
 }
 
+static void bufferFree(Intersect *intersect, IntersectIntegerBuffer *buffer)
+{
+	if(buffer->view != NULL) {
+		posting_releaseView(buffer->view);
+		buffer->view = NULL;
+	}
+	else if(buffer->isArenaBuffer) {
+		arenaFree(intersect->arena, buffer->array);
+	}
+	else {
+		free(buffer->array);
+	}
+
+	buffer->isArenaBuffer = afalse;
+	buffer->array = NULL;
+}
+
+static void bufferDetach(Intersect *intersect, IntersectIntegerBuffer *buffer)
+{
+	int *array = NULL;
+
+	if(buffer->view == NULL) {
+		return;
+	}
+
+	// a shared view is immutable, so take a private copy before changing it
+
+	array = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * buffer->length));
+
+	memcpy(array, buffer->array, (sizeof(int) * buffer->length));
+
+	posting_releaseView(buffer->view);
+
+	buffer->isArenaBuffer = (intersect->arena != NULL);
+	buffer->array = array;
+	buffer->view = NULL;
+}
+
+static void bufferDecode(Intersect *intersect, IntersectIntegerBuffer *buffer)
+{
+	if((buffer->array != NULL) || (buffer->posting == NULL) ||
+			(buffer->length < 1)) {
+		return;
+	}
+
+	buffer->isArenaBuffer = (intersect->arena != NULL);
+	buffer->array = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * buffer->length));
+	buffer->length = posting_decode(buffer->posting, buffer->array);
+}
+
+/*
+ * Note: the filter functions below all emit, in order, every element of the
+ * sorted alpha list (duplicates included) that is present in the sorted beta
+ * list. Because an element is never written before it has been read, the
+ * output may safely be the alpha list itself.
+ */
+
+static int gallopSearch(int *array, int start, int length, int item)
+{
+	int low = 0;
+	int high = 0;
+	int step = 1;
+	int middle = 0;
+
+	// find the first position at or after start holding a value >= item
+
+	low = start;
+	high = start;
+
+	while((high < length) && (array[high] < item)) {
+		low = (high + 1);
+		high += step;
+		step <<= 1;
+	}
+
+	if(high > length) {
+		high = length;
+	}
+
+	while(low < high) {
+		middle = (low + ((high - low) >> 1));
+		if(array[middle] < item) {
+			low = (middle + 1);
+		}
+		else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+static int filterByGallop(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+
+	// walk the short alpha list, galloping through the long beta list
+
+	for(ii = 0; ii < alphaLength; ii++) {
+		nn = gallopSearch(beta, nn, betaLength, alpha[ii]);
+		if(nn >= betaLength) {
+			break;
+		}
+
+		if(beta[nn] == alpha[ii]) {
+			output[ref] = alpha[ii];
+			ref++;
+		}
+	}
+
+	return ref;
+}
+
+static int filterByGallopRuns(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+
+	// walk the short beta list, galloping through the long alpha list and
+	// emitting each run of matching alpha values
+
+	for(nn = 0; nn < betaLength; nn++) {
+		if((nn > 0) && (beta[nn] == beta[(nn - 1)])) {
+			continue;
+		}
+
+		ii = gallopSearch(alpha, ii, alphaLength, beta[nn]);
+		if(ii >= alphaLength) {
+			break;
+		}
+
+		while((ii < alphaLength) && (alpha[ii] == beta[nn])) {
+			output[ref] = alpha[ii];
+			ref++;
+			ii++;
+		}
+	}
+
+	return ref;
+}
+
+#if defined(INTERSECT_BLOCK_LENGTH)
+static int blockCompare(int *alpha, int *beta)
+{
+#if defined(__AVX2__)
+	int ii = 0;
+	__m256i rotate;
+	__m256i alphaBlock;
+	__m256i betaBlock;
+	__m256i matches;
+
+	// compare every alpha lane against every beta lane, rotating beta
+
+	rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+	alphaBlock = _mm256_loadu_si256((__m256i *)alpha);
+	betaBlock = _mm256_loadu_si256((__m256i *)beta);
+	matches = _mm256_cmpeq_epi32(alphaBlock, betaBlock);
+
+	for(ii = 1; ii < INTERSECT_BLOCK_LENGTH; ii++) {
+		betaBlock = _mm256_permutevar8x32_epi32(betaBlock, rotate);
+		matches = _mm256_or_si256(matches,
+				_mm256_cmpeq_epi32(alphaBlock, betaBlock));
+	}
+
+	return _mm256_movemask_ps(_mm256_castsi256_ps(matches));
+#else // !__AVX2__
+	__m128i alphaBlock;
+	__m128i betaBlock;
+	__m128i matches;
+
+	// compare every alpha lane against every beta lane, rotating beta
+
+	alphaBlock = _mm_loadu_si128((__m128i *)alpha);
+	betaBlock = _mm_loadu_si128((__m128i *)beta);
+
+	matches = _mm_or_si128(
+			_mm_or_si128(
+				_mm_cmpeq_epi32(alphaBlock, betaBlock),
+				_mm_cmpeq_epi32(alphaBlock,
+					_mm_shuffle_epi32(betaBlock, _MM_SHUFFLE(0, 3, 2, 1)))),
+			_mm_or_si128(
+				_mm_cmpeq_epi32(alphaBlock,
+					_mm_shuffle_epi32(betaBlock, _MM_SHUFFLE(1, 0, 3, 2))),
+				_mm_cmpeq_epi32(alphaBlock,
+					_mm_shuffle_epi32(betaBlock, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+	return _mm_movemask_ps(_mm_castsi128_ps(matches));
+#endif // __AVX2__
+}
+#endif // INTERSECT_BLOCK_LENGTH
+
+static int filterByMerge(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int mask = 0;
+
+#if defined(INTERSECT_BLOCK_LENGTH)
+	int jj = 0;
+
+	/*
+	 * Compare whole blocks at a time, accumulating the matched lanes of the
+	 * current alpha block until the block is retired. On equal block maxima
+	 * only alpha advances, so duplicated alpha values still find their match
+	 * in the following alpha block.
+	 */
+
+	while(((ii + INTERSECT_BLOCK_LENGTH) <= alphaLength) &&
+			((nn + INTERSECT_BLOCK_LENGTH) <= betaLength)) {
+		mask |= blockCompare(&alpha[ii], &beta[nn]);
+
+		if(alpha[(ii + INTERSECT_BLOCK_LENGTH - 1)] <=
+				beta[(nn + INTERSECT_BLOCK_LENGTH - 1)]) {
+			for(jj = 0; jj < INTERSECT_BLOCK_LENGTH; jj++) {
+				if(mask & (1 << jj)) {
+					output[ref] = alpha[(ii + jj)];
+					ref++;
+				}
+			}
+			mask = 0;
+			ii += INTERSECT_BLOCK_LENGTH;
+		}
+		else {
+			nn += INTERSECT_BLOCK_LENGTH;
+		}
+	}
+#endif // INTERSECT_BLOCK_LENGTH
+
+	// merge the remainder, honoring any lanes already matched above
+
+	while((ii < alphaLength) && ((nn < betaLength) || (mask != 0))) {
+		if(mask & 0x01) {
+			output[ref] = alpha[ii];
+			ref++;
+		}
+		else {
+			while((nn < betaLength) && (beta[nn] < alpha[ii])) {
+				nn++;
+			}
+
+			if((nn < betaLength) && (beta[nn] == alpha[ii])) {
+				output[ref] = alpha[ii];
+				ref++;
+			}
+		}
+
+		mask >>= 1;
+		ii++;
+	}
+
+	return ref;
+}
+
+static int filterBuffer(int *alpha, int alphaLength, int *beta,
+		int betaLength, int *output)
+{
+	if((alphaLength < 1) || (betaLength < 1)) {
+		return 0;
+	}
+
+	if((betaLength / alphaLength) >= INTERSECT_GALLOP_RATIO) {
+		return filterByGallop(alpha, alphaLength, beta, betaLength, output);
+	}
+
+	if((alphaLength / betaLength) >= INTERSECT_GALLOP_RATIO) {
+		return filterByGallopRuns(alpha, alphaLength, beta, betaLength,
+				output);
+	}
+
+	return filterByMerge(alpha, alphaLength, beta, betaLength, output);
+}
+
+static int filterAgainst(IntersectIntegerBuffer *buffer, int *alpha,
+		int alphaLength, int *output)
+{
+	// probe a still-compressed posting list without decoding all of it
+
+	if((buffer->array == NULL) && (buffer->posting != NULL)) {
+		return posting_filter(buffer->posting, alpha, alphaLength, output);
+	}
+
+	return filterBuffer(alpha, alphaLength, buffer->array, buffer->length,
+			output);
+}
+
+static int execAndBySearch(Intersect *intersect, aboolean isCleanMode,
+		int maxLength)
+{
+	aboolean isFound = afalse;
+	int ii = 0;
+	int nn = 0;
+	int jj = 0;
+	int ref = 0;
+	int *thresholds = NULL;
+
+	thresholds = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * intersect->length));
+
+	for(ii = 0; ii < intersect->length; ii++) {
+		thresholds[ii] = 0;
+	}
+
+	for(ii = 0; ii < intersect->length; ii++) {
+		for(nn = 0; nn < intersect->buffers[ii].length; nn++) {
+			isFound = atrue;
+
+			for(jj = 0; jj < intersect->length; jj++) {
+				if(jj == ii) {
+					continue;
+				}
+
+				if(intersect->buffers[jj].length <= 0) {
+					isFound = afalse;
+					break;
+				}
+
+				if(integer_binarySearch(intersect->buffers[jj].array,
+							thresholds[jj],
+							intersect->buffers[jj].length,
+							intersect->buffers[ii].array[nn]) < 0) {
+					isFound = afalse;
+					break;
+				}
+				else {
+					thresholds[ii] = (nn + 1);
+				}
+			}
+
+			if(isFound) {
+				intersect->result.array[ref] = intersect->buffers[ii].array[nn];
+
+				if((isCleanMode) &&
+						(((maxLength > 1) && (ref > 0)) ||
+						 ((maxLength == 1) && (ref == 0))) &&
+						(intersect->result.array[ref] == 0)) {
+					break;
+				}
+
+				ref++;
+
+				if(ref >= intersect->result.length) {
+					fprintf(stderr, "[%s():%i] error - exceeded max result "
+							"size %i at %i of %i, aborting.\n", __FUNCTION__,
+							__LINE__, intersect->result.length, ii, nn);
+					break;
+				}
+			}
+		}
+	}
+
+	arenaFree(intersect->arena, thresholds);
+
+	return ref;
+}
+
 
 // define intersect public functions
 
@@ -69,8 +502,24 @@ void intersect_init(Intersect *intersect)
 	intersect->length = 0;
 	intersect->buffers = NULL;
 	intersect->result.isSorted = afalse;
+	intersect->result.isArenaBuffer = afalse;
 	intersect->result.length = 0;
 	intersect->result.array = NULL;
+	intersect->result.posting = NULL;
+	intersect->result.view = NULL;
+	intersect->arena = NULL;
+}
+
+void intersect_initWithArena(Intersect *intersect, MemoryArena *arena)
+{
+	if(intersect == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	intersect_init(intersect);
+
+	intersect->arena = arena;
 }
 
 void intersect_free(Intersect *intersect)
@@ -85,15 +534,15 @@ void intersect_free(Intersect *intersect)
 	if(intersect->buffers != NULL) {
 		for(ii = 0; ii < intersect->length; ii++) {
 			if(intersect->buffers[ii].array != NULL) {
-				free(intersect->buffers[ii].array);
+				bufferFree(intersect, &intersect->buffers[ii]);
 			}
 		}
 
-		free(intersect->buffers);
+		arenaFree(intersect->arena, intersect->buffers);
 	}
 
 	if(intersect->result.array != NULL) {
-		free(intersect->result.array);
+		bufferFree(intersect, &intersect->result);
 	}
 }
 
@@ -151,6 +600,8 @@ void intersect_display(void *stream, Intersect *intersect)
 		fprintf(stream, "\t\t length     : %i\n",
 				intersect->buffers[ii].length);
 
+		bufferDecode(intersect, &intersect->buffers[ii]);
+
 		for(nn = 0; nn < intersect->buffers[ii].length; nn++) {
 			fprintf(stream, "\t\t\t %03i : %i\n",
 					nn, intersect->buffers[ii].array[nn]);
@@ -187,6 +638,8 @@ int intersect_get(Intersect *intersect, int id, int position)
 		return 0;
 	}
 
+	bufferDecode(intersect, &intersect->buffers[id]);
+
 	return intersect->buffers[id].array[position];
 }
 
@@ -203,6 +656,8 @@ int *intersect_getArray(Intersect *intersect, int id, int *length)
 		return NULL;
 	}
 
+	bufferDecode(intersect, &intersect->buffers[id]);
+
 	*length = intersect->buffers[id].length;
 
 	return intersect->buffers[id].array;
@@ -224,34 +679,49 @@ int intersect_put(Intersect *intersect, int id, int value)
 		intersect->length = (id + 1);
 
 		if(intersect->buffers == NULL) {
-			intersect->buffers = (IntersectIntegerBuffer *)malloc(
-					sizeof(IntersectIntegerBuffer) * intersect->length);
+			intersect->buffers = (IntersectIntegerBuffer *)arenaMalloc(
+					intersect->arena,
+					(sizeof(IntersectIntegerBuffer) * intersect->length));
 		}
 		else {
-			intersect->buffers = (IntersectIntegerBuffer *)realloc(
-					intersect->buffers,
+			intersect->buffers = (IntersectIntegerBuffer *)arenaRealloc(
+					intersect->arena, intersect->buffers,
 					(sizeof(IntersectIntegerBuffer) * intersect->length));
 		}
 
 		for(ii = length; ii < intersect->length; ii++) {
 			intersect->buffers[ii].isSorted = afalse;
+			intersect->buffers[ii].isArenaBuffer = afalse;
 			intersect->buffers[ii].length = 0;
 			intersect->buffers[ii].array = NULL;
+			intersect->buffers[ii].posting = NULL;
+			intersect->buffers[ii].view = NULL;
 		}
 	}
 
+	bufferDecode(intersect, &intersect->buffers[id]);
+	bufferDetach(intersect, &intersect->buffers[id]);
+
 	if(intersect->buffers[id].array == NULL) {
 		bufferId = 0;
 		intersect->buffers[id].length = 1;
-		intersect->buffers[id].array = (int *)malloc(sizeof(int) *
-				intersect->buffers[id].length);
+		intersect->buffers[id].isArenaBuffer = (intersect->arena != NULL);
+		intersect->buffers[id].array = (int *)arenaMalloc(intersect->arena,
+				(sizeof(int) * intersect->buffers[id].length));
 	}
 	else {
 		bufferId = intersect->buffers[id].length;
 		intersect->buffers[id].length += 1;
-		intersect->buffers[id].array = (int *)realloc(
-				intersect->buffers[id].array,
-				(sizeof(int) * intersect->buffers[id].length));
+		if(intersect->buffers[id].isArenaBuffer) {
+			intersect->buffers[id].array = (int *)arenaRealloc(
+					intersect->arena, intersect->buffers[id].array,
+					(sizeof(int) * intersect->buffers[id].length));
+		}
+		else {
+			intersect->buffers[id].array = (int *)realloc(
+					intersect->buffers[id].array,
+					(sizeof(int) * intersect->buffers[id].length));
+		}
 	}
 
 	intersect->buffers[id].isSorted = afalse;
@@ -273,20 +743,26 @@ int intersect_putArray(Intersect *intersect, aboolean isSorted, int *array,
 	if(intersect->buffers == NULL) {
 		id = 0;
 		intersect->length = 1;
-		intersect->buffers = (IntersectIntegerBuffer *)malloc(
-				sizeof(IntersectIntegerBuffer) * intersect->length);
+		intersect->buffers = (IntersectIntegerBuffer *)arenaMalloc(
+				intersect->arena,
+				(sizeof(IntersectIntegerBuffer) * intersect->length));
 	}
 	else {
 		id = intersect->length;
 		intersect->length += 1;
-		intersect->buffers = (IntersectIntegerBuffer *)realloc(
-				intersect->buffers,
+		intersect->buffers = (IntersectIntegerBuffer *)arenaRealloc(
+				intersect->arena, intersect->buffers,
 				(sizeof(IntersectIntegerBuffer) * intersect->length));
 	}
 
 	intersect->buffers[id].isSorted = isSorted;
+	intersect->buffers[id].isArenaBuffer = (intersect->arena != NULL);
 	intersect->buffers[id].length = length;
-	intersect->buffers[id].array = (int *)malloc(sizeof(int) * length);
+	intersect->buffers[id].array = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * length));
+
+	intersect->buffers[id].posting = NULL;
+	intersect->buffers[id].view = NULL;
 
 	memcpy(intersect->buffers[id].array, array, (sizeof(int) * length));
 
@@ -306,20 +782,169 @@ int intersect_putArrayStatic(Intersect *intersect, aboolean isSorted,
 	if(intersect->buffers == NULL) {
 		id = 0;
 		intersect->length = 1;
-		intersect->buffers = (IntersectIntegerBuffer *)malloc(
-				sizeof(IntersectIntegerBuffer) * intersect->length);
+		intersect->buffers = (IntersectIntegerBuffer *)arenaMalloc(
+				intersect->arena,
+				(sizeof(IntersectIntegerBuffer) * intersect->length));
 	}
 	else {
 		id = intersect->length;
 		intersect->length += 1;
-		intersect->buffers = (IntersectIntegerBuffer *)realloc(
-				intersect->buffers,
+		intersect->buffers = (IntersectIntegerBuffer *)arenaRealloc(
+				intersect->arena, intersect->buffers,
 				(sizeof(IntersectIntegerBuffer) * intersect->length));
 	}
 
 	intersect->buffers[id].isSorted = isSorted;
+	intersect->buffers[id].isArenaBuffer = afalse;
 	intersect->buffers[id].length = length;
 	intersect->buffers[id].array = array;
+	intersect->buffers[id].posting = NULL;
+	intersect->buffers[id].view = NULL;
+
+	return 0;
+}
+
+int intersect_putPosting(Intersect *intersect, PostingList *posting)
+{
+	int id = 0;
+
+	if((intersect == NULL) || (posting == NULL) || (posting->length < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(intersect->buffers == NULL) {
+		id = 0;
+		intersect->length = 1;
+		intersect->buffers = (IntersectIntegerBuffer *)arenaMalloc(
+				intersect->arena,
+				(sizeof(IntersectIntegerBuffer) * intersect->length));
+	}
+	else {
+		id = intersect->length;
+		intersect->length += 1;
+		intersect->buffers = (IntersectIntegerBuffer *)arenaRealloc(
+				intersect->arena, intersect->buffers,
+				(sizeof(IntersectIntegerBuffer) * intersect->length));
+	}
+
+	/*
+	 * The posting list is referenced, not copied, and is only decoded where
+	 * an operation needs its values as an array; the caller must keep it
+	 * unchanged until the intersection is freed.
+	 */
+
+	intersect->buffers[id].isSorted = atrue;
+	intersect->buffers[id].isArenaBuffer = afalse;
+	intersect->buffers[id].length = posting->length;
+	intersect->buffers[id].array = NULL;
+	intersect->buffers[id].posting = posting;
+	intersect->buffers[id].view = NULL;
+
+	return 0;
+}
+
+int intersect_putView(Intersect *intersect, PostingView *view)
+{
+	int id = 0;
+
+	if((intersect == NULL) || (view == NULL) || (view->length < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(intersect->buffers == NULL) {
+		id = 0;
+		intersect->length = 1;
+		intersect->buffers = (IntersectIntegerBuffer *)arenaMalloc(
+				intersect->arena,
+				(sizeof(IntersectIntegerBuffer) * intersect->length));
+	}
+	else {
+		id = intersect->length;
+		intersect->length += 1;
+		intersect->buffers = (IntersectIntegerBuffer *)arenaRealloc(
+				intersect->arena, intersect->buffers,
+				(sizeof(IntersectIntegerBuffer) * intersect->length));
+	}
+
+	/*
+	 * As with a static array, the view's array is used in place, and the
+	 * caller's reference to the view passes to the intersection, which
+	 * releases it when the buffer is freed.
+	 */
+
+	intersect->buffers[id].isSorted = atrue;
+	intersect->buffers[id].isArenaBuffer = afalse;
+	intersect->buffers[id].length = view->length;
+	intersect->buffers[id].array = view->array;
+	intersect->buffers[id].posting = NULL;
+	intersect->buffers[id].view = view;
+
+	return 0;
+}
+
+int intersect_moveBuffers(Intersect *intersect, Intersect *source)
+{
+	int ii = 0;
+	int id = 0;
+
+	IntersectIntegerBuffer *buffer = NULL;
+
+	if((intersect == NULL) || (source == NULL) || (intersect == source)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((source->buffers == NULL) || (source->length < 1)) {
+		return 0;
+	}
+
+	if(intersect->buffers == NULL) {
+		intersect->length = 0;
+		intersect->buffers = (IntersectIntegerBuffer *)arenaMalloc(
+				intersect->arena,
+				(sizeof(IntersectIntegerBuffer) * source->length));
+	}
+	else {
+		intersect->buffers = (IntersectIntegerBuffer *)arenaRealloc(
+				intersect->arena, intersect->buffers,
+				(sizeof(IntersectIntegerBuffer) *
+				 (intersect->length + source->length)));
+	}
+
+	for(ii = 0; ii < source->length; ii++) {
+		id = (intersect->length + ii);
+		buffer = &source->buffers[ii];
+
+		intersect->buffers[id] = *buffer;
+
+		// heap arrays and posting references change hands as they are, but
+		// arena memory is only shared by intersections on the same arena
+
+		if((buffer->isArenaBuffer) && (buffer->array != NULL) &&
+				(source->arena != intersect->arena)) {
+			intersect->buffers[id].isArenaBuffer = (intersect->arena != NULL);
+			intersect->buffers[id].array = (int *)arenaMalloc(
+					intersect->arena, (sizeof(int) * buffer->length));
+
+			memcpy(intersect->buffers[id].array, buffer->array,
+					(sizeof(int) * buffer->length));
+
+			arenaFree(source->arena, buffer->array);
+		}
+
+		buffer->array = NULL;
+		buffer->posting = NULL;
+		buffer->view = NULL;
+	}
+
+	intersect->length += source->length;
+
+	arenaFree(source->arena, source->buffers);
+
+	source->length = 0;
+	source->buffers = NULL;
 
 	return 0;
 }
@@ -339,7 +964,7 @@ aboolean intersect_isReady(Intersect *intersect)
 	}
 
 	if(intersect->result.array != NULL) {
-		free(intersect->result.array);
+		bufferFree(intersect, &intersect->result);
 	}
 
 	intersect->result.isSorted = afalse;
@@ -408,13 +1033,15 @@ void intersect_sort(Intersect *intersect)
 
 void intersect_execAnd(Intersect *intersect, aboolean isCleanMode)
 {
-	aboolean isFound = afalse;
 	int ii = 0;
 	int nn = 0;
-	int jj = 0;
+	int id = 0;
 	int ref = 0;
 	int maxLength = 0;
-	int *thresholds = NULL;
+	int *order = NULL;
+	int *swap = NULL;
+	int *scratch = NULL;
+	IntersectIntegerBuffer *buffer = NULL;
 
 	if(intersect == NULL) {
 		DISPLAY_INVALID_ARGS;
@@ -433,7 +1060,7 @@ void intersect_execAnd(Intersect *intersect, aboolean isCleanMode)
 	// cleanup any old results
 
 	if(intersect->result.array != NULL) {
-		free(intersect->result.array);
+		bufferFree(intersect, &intersect->result);
 	}
 
 	intersect->result.isSorted = afalse;
@@ -448,72 +1075,103 @@ void intersect_execAnd(Intersect *intersect, aboolean isCleanMode)
 
 	// execute a Boolean 'and' intersection
 
-	thresholds = (int *)malloc(sizeof(int) * intersect->length);
+	order = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * intersect->length));
 
 	for(ii = 0; ii < intersect->length; ii++) {
-		thresholds[ii] = 0;
-
 		if(intersect->buffers[ii].length > maxLength) {
 			maxLength = intersect->buffers[ii].length;
 		}
+
+		// order the buffers smallest-first, so that the running result is
+		// as short as possible from the start
+
+		for(nn = ii; (nn > 0) &&
+				(intersect->buffers[order[(nn - 1)]].length >
+				 intersect->buffers[ii].length); nn--) {
+			order[nn] = order[(nn - 1)];
+		}
+		order[nn] = ii;
 	}
 
 	intersect->result.length = (maxLength + 1);
-	intersect->result.array = (int *)malloc(sizeof(int) *
-			intersect->result.length);
+	intersect->result.isArenaBuffer = (intersect->arena != NULL);
+	intersect->result.array = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * intersect->result.length));
+
+	/*
+	 * The result is every element of the first buffer, duplicates included,
+	 * that is present in all of the other buffers. The running result is
+	 * filtered against each buffer in turn, except that when the first buffer
+	 * is reached it is filtered against the running result instead, to carry
+	 * over its duplicates.
+	 */
+
+	buffer = &intersect->buffers[order[0]];
+
+	if(intersect->length == 1) {
+		bufferDecode(intersect, buffer);
+		ref = buffer->length;
+		memcpy(intersect->result.array, buffer->array, (sizeof(int) * ref));
+	}
+	else if(order[1] == 0) {
+		bufferDecode(intersect, &intersect->buffers[0]);
+		ref = filterAgainst(buffer, intersect->buffers[0].array,
+				intersect->buffers[0].length, intersect->result.array);
+	}
+	else {
+		bufferDecode(intersect, buffer);
+		ref = filterAgainst(&intersect->buffers[order[1]], buffer->array,
+				buffer->length, intersect->result.array);
+	}
 
-	for(ii = 0; ii < intersect->length; ii++) {
-		for(nn = 0; nn < intersect->buffers[ii].length; nn++) {
-			isFound = atrue;
+	for(ii = 2; ((ii < intersect->length) && (ref > 0)); ii++) {
+		id = order[ii];
 
-			for(jj = 0; jj < intersect->length; jj++) {
-				if(jj == ii) {
-					continue;
-				}
+		if(id == 0) {
+			scratch = (int *)arenaMalloc(intersect->arena,
+					(sizeof(int) * intersect->result.length));
 
-				if(intersect->buffers[jj].length <= 0) {
-					isFound = afalse;
-					break;
-				}
+			bufferDecode(intersect, &intersect->buffers[0]);
 
-				if(integer_binarySearch(intersect->buffers[jj].array,
-							thresholds[jj],
-							intersect->buffers[jj].length,
-							intersect->buffers[ii].array[nn]) < 0) {
-					isFound = afalse;
-					break;
-				}
-				else {
-					thresholds[ii] = (nn + 1);
-				}
-			}
+			ref = filterBuffer(intersect->buffers[0].array,
+					intersect->buffers[0].length, intersect->result.array,
+					ref, scratch);
 
-			if(isFound) {
-				intersect->result.array[ref] = intersect->buffers[ii].array[nn];
+			swap = intersect->result.array;
+			intersect->result.array = scratch;
+			scratch = swap;
 
-				if((isCleanMode) &&
-						(((maxLength > 1) && (ref > 0)) ||
-						 ((maxLength == 1) && (ref == 0))) &&
-						(intersect->result.array[ref] == 0)) {
-					break;
-				}
+			arenaFree(intersect->arena, scratch);
+		}
+		else {
+			ref = filterAgainst(&intersect->buffers[id],
+					intersect->result.array, ref, intersect->result.array);
+		}
+	}
 
-				ref++;
+	arenaFree(intersect->arena, order);
 
-				if(ref >= intersect->result.length) {
-					fprintf(stderr, "[%s():%i] error - exceeded max result "
-							"size %i at %i of %i, aborting.\n", __FUNCTION__,
-							__LINE__, intersect->result.length, ii, nn);
-					break;
+	// clean mode truncates on a stray zero in ways that depend upon the
+	// search order, so defer to the exhaustive search when one is present
+
+	if(isCleanMode) {
+		for(ii = 0; ii < ref; ii++) {
+			if((intersect->result.array[ii] == 0) &&
+					(((maxLength > 1) && (ii > 0)) ||
+					 ((maxLength == 1) && (ii == 0)))) {
+				for(nn = 0; nn < intersect->length; nn++) {
+					bufferDecode(intersect, &intersect->buffers[nn]);
 				}
+
+				ref = execAndBySearch(intersect, isCleanMode, maxLength);
+				break;
 			}
 		}
 	}
 
 	intersect->result.length = ref;
 	intersect->state = INTERSECT_STATE_DONE;
-
-	free(thresholds);
 }
 
 void intersect_execOr(Intersect *intersect)
@@ -541,7 +1199,7 @@ void intersect_execOr(Intersect *intersect)
 	// cleanup any old results
 
 	if(intersect->result.array != NULL) {
-		free(intersect->result.array);
+		bufferFree(intersect, &intersect->result);
 	}
 
 	intersect->result.isSorted = afalse;
@@ -554,9 +1212,14 @@ void intersect_execOr(Intersect *intersect)
 		return;
 	}
 
+	for(ii = 0; ii < intersect->length; ii++) {
+		bufferDecode(intersect, &intersect->buffers[ii]);
+	}
+
 	// execute a Boolean 'or' intersection
 
-	index = (int *)malloc(sizeof(int) * intersect->length);
+	index = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * intersect->length));
 
 	// calculate maximum length of and initialize result
 
@@ -566,8 +1229,9 @@ void intersect_execOr(Intersect *intersect)
 		intersect->result.length += intersect->buffers[ii].length;
 	}
 
-	intersect->result.array = (int *)malloc(
-			sizeof(int) * intersect->result.length);
+	intersect->result.isArenaBuffer = (intersect->arena != NULL);
+	intersect->result.array = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * intersect->result.length));
 
 	// execute 'or' intersection logic
 
@@ -619,7 +1283,7 @@ void intersect_execOr(Intersect *intersect)
 	intersect->result.length = resultRef;
 	intersect->state = INTERSECT_STATE_DONE;
 
-	free(index);
+	arenaFree(intersect->arena, index);
 }
 
 void intersect_execNot(Intersect *intersect, aboolean isCleanMode)
@@ -648,13 +1312,17 @@ void intersect_execNot(Intersect *intersect, aboolean isCleanMode)
 	// cleanup any old results
 
 	if(intersect->result.array != NULL) {
-		free(intersect->result.array);
+		bufferFree(intersect, &intersect->result);
 	}
 
 	intersect->result.isSorted = afalse;
 	intersect->result.length = 0;
 	intersect->result.array = NULL;
 
+	for(ii = 0; ii < intersect->length; ii++) {
+		bufferDecode(intersect, &intersect->buffers[ii]);
+	}
+
 	// execute a Boolean 'and' intersection
 
 	for(ii = 0; ii < intersect->length; ii++) {
@@ -664,8 +1332,9 @@ void intersect_execNot(Intersect *intersect, aboolean isCleanMode)
 	}
 
 	intersect->result.length = (maxLength + 1);
-	intersect->result.array = (int *)malloc(sizeof(int) *
-			intersect->result.length);
+	intersect->result.isArenaBuffer = (intersect->arena != NULL);
+	intersect->result.array = (int *)arenaMalloc(intersect->arena,
+			(sizeof(int) * intersect->result.length));
 
 	for(ii = 0; ii < intersect->length; ii++) {
 		for(nn = 0; nn < intersect->buffers[ii].length; nn++) {
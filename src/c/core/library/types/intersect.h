@@ -45,8 +45,11 @@ typedef enum _IntersectModes {
 
 typedef struct _IntersectIntegerBuffer {
 	aboolean isSorted;
+	aboolean isArenaBuffer;
 	int length;
 	int *array;
+	PostingList *posting;
+	PostingView *view;
 } IntersectIntegerBuffer;
 
 typedef struct _Intersect {
@@ -54,6 +57,7 @@ typedef struct _Intersect {
 	int length;
 	IntersectIntegerBuffer *buffers;
 	IntersectIntegerBuffer result;
+	MemoryArena *arena;
 } Intersect;
 
 
@@ -61,6 +65,8 @@ typedef struct _Intersect {
 
 void intersect_init(Intersect *intersect);
 
+void intersect_initWithArena(Intersect *intersect, MemoryArena *arena);
+
 void intersect_free(Intersect *intersect);
 
 char *intersect_stateToString(IntersectStates state);
@@ -81,6 +87,12 @@ int intersect_putArray(Intersect *intersect, aboolean isSorted, int *array,
 int intersect_putArrayStatic(Intersect *intersect, aboolean isSorted,
 		int *array, int length);
 
+int intersect_putPosting(Intersect *intersect, PostingList *posting);
+
+int intersect_putView(Intersect *intersect, PostingView *view);
+
+int intersect_moveBuffers(Intersect *intersect, Intersect *source);
+
 aboolean intersect_isReady(Intersect *intersect);
 
 void intersect_setIsSorted(Intersect *intersect);
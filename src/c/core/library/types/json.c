@@ -16,6 +16,11 @@
 #include "core/library/types/json.h"
 
 
+// define json private constants
+
+#define JSON_DEFAULT_CAPACITY							4
+
+
 // delcare json private functions
 
 // generic functions
@@ -24,17 +29,18 @@ static char *buildStringIndent(int indentLevel, int *indentLength);
 
 // element functions
 
-static JsonElement *element_search(Json *object, char *name);
+static void element_buildHashes(Json *object);
 
-static int element_add(Json *object, int type, char *name, void *value);
+static JsonElement *element_search(Json *object, char *name);
 
-static int element_addElement(Json *object, JsonElement *element);
+static void element_insert(Json *object, int type, char *name,
+		int nameLength, void *value);
 
-static void element_freeValue(int type, void *value);
+static int element_add(Json *object, int type, char *name, void *value);
 
-static void element_free(JsonElement *element);
+static void element_freeValue(MemoryArena *arena, int type, void *value);
 
-static void element_freePtr(JsonElement *element);
+static void element_free(MemoryArena *arena, JsonElement *element);
 
 static char *element_toString(JsonElement *element, char *string,
 		int *stringRef, int *stringLength, int indentLevel,
@@ -44,7 +50,11 @@ static char *element_toString(JsonElement *element, char *string,
 
 static JsonArray *array_getFromElement(Json *object, char *name, int index);
 
-static int array_add(JsonArray *array, int type, void *value);
+static void array_insert(MemoryArena *arena, JsonArray *array, int type,
+		void *value);
+
+static int array_add(MemoryArena *arena, JsonArray *array, int type,
+		void *value);
 
 static char *array_toString(JsonArray *array, char *string,
 		int *stringRef, int *stringLength, int indentLevel);
@@ -55,17 +65,12 @@ static char *object_toString(Json *object, int *stringLength, int indentLevel);
 
 // parsing functions
 
-static void parse_consume(char **ptr, int *consumedBytes, int bytes);
-
-static double parse_number(char *string, int *consumedBytes,
-		aboolean *hasError);
+static void *parse_value(MemoryArena *arena, JsonReader *reader,
+		JsonReaderEvents event, int *type);
 
-static char *parse_string(char *string, int *consumedBytes);
+static JsonArray *parse_array(MemoryArena *arena, JsonReader *reader);
 
-static JsonElement *parse_value(char *string, int *consumedBytes,
-		aboolean *hasError);
-
-static Json *parse_json(char *string, int stringLength, int *consumedBytes);
+static Json *parse_object(MemoryArena *arena, JsonReader *reader);
 
 
 // define json private functions
@@ -90,25 +95,142 @@ static char *buildStringIndent(int indentLevel, int *indentLength)
 
 // element functions
 
-static JsonElement *element_search(Json *object, char *name)
+static void element_buildHashes(Json *object)
 {
 	int ii = 0;
+	unsigned int slot = 0;
+	unsigned int mask = 0;
 
-	JsonElement *result = NULL;
+	if(object->hashes != NULL) {
+		arenaFree(object->arena, object->hashes);
+	}
+
+	object->hashLength = 16;
+
+	while(object->hashLength < (object->elementCapacity * 2)) {
+		object->hashLength *= 2;
+	}
+
+	object->hashes = (int *)arenaMalloc(object->arena,
+			(sizeof(int) * object->hashLength));
+
+	memset(object->hashes, 0, (sizeof(int) * object->hashLength));
+
+	mask = (unsigned int)(object->hashLength - 1);
 
 	for(ii = 0; ii < object->elementLength; ii++) {
-		if(!strcmp(name, object->elements[ii].name)) {
-			result = &(object->elements[ii]);
-			break;
+		object->elements[ii].nameHash = crc32_calculateHash(
+				object->elements[ii].name,
+				object->elements[ii].nameLength);
+
+		slot = (object->elements[ii].nameHash & mask);
+
+		while(object->hashes[slot] != 0) {
+			slot = ((slot + 1) & mask);
 		}
+
+		object->hashes[slot] = (ii + 1);
 	}
+}
 
-	return result;
+static JsonElement *element_search(Json *object, char *name)
+{
+	int ii = 0;
+	int nameLength = 0;
+	unsigned int hash = 0;
+	unsigned int slot = 0;
+	unsigned int mask = 0;
+
+	JsonElement *element = NULL;
+
+	nameLength = strlen(name);
+
+	if(object->hashes == NULL) {
+		for(ii = 0; ii < object->elementLength; ii++) {
+			if((object->elements[ii].nameLength == nameLength) &&
+					(!strcmp(name, object->elements[ii].name))) {
+				return &(object->elements[ii]);
+			}
+		}
+
+		return NULL;
+	}
+
+	hash = crc32_calculateHash(name, nameLength);
+	mask = (unsigned int)(object->hashLength - 1);
+	slot = (hash & mask);
+
+	while(object->hashes[slot] != 0) {
+		element = &(object->elements[(object->hashes[slot] - 1)]);
+
+		if((element->nameHash == hash) &&
+				(element->nameLength == nameLength) &&
+				(!strcmp(name, element->name))) {
+			return element;
+		}
+
+		slot = ((slot + 1) & mask);
+	}
+
+	return NULL;
 }
 
-static int element_add(Json *object, int type, char *name, void *value)
+static void element_insert(Json *object, int type, char *name,
+		int nameLength, void *value)
 {
 	int ref = 0;
+	unsigned int slot = 0;
+	unsigned int mask = 0;
+
+	if(object->elements == NULL) {
+		object->elementCapacity = JSON_DEFAULT_CAPACITY;
+		object->elements = (JsonElement *)arenaMalloc(object->arena,
+				(sizeof(JsonElement) * object->elementCapacity));
+	}
+	else if(object->elementLength >= object->elementCapacity) {
+		object->elementCapacity *= 2;
+		object->elements = (JsonElement *)arenaRealloc(object->arena,
+				object->elements,
+				(sizeof(JsonElement) * object->elementCapacity));
+	}
+
+	ref = object->elementLength;
+	object->elementLength += 1;
+
+	object->elements[ref].type = type;
+	object->elements[ref].nameLength = nameLength;
+	object->elements[ref].nameHash = 0;
+	object->elements[ref].name = name;
+	object->elements[ref].value = value;
+
+	// index the element names once the object is large enough to need it
+
+	if(object->hashes == NULL) {
+		if(object->elementLength >= JSON_ELEMENT_HASH_THRESHOLD) {
+			element_buildHashes(object);
+		}
+		return;
+	}
+
+	if((object->elementLength * 2) > object->hashLength) {
+		element_buildHashes(object);
+		return;
+	}
+
+	object->elements[ref].nameHash = crc32_calculateHash(name, nameLength);
+
+	mask = (unsigned int)(object->hashLength - 1);
+	slot = (object->elements[ref].nameHash & mask);
+
+	while(object->hashes[slot] != 0) {
+		slot = ((slot + 1) & mask);
+	}
+
+	object->hashes[slot] = (ref + 1);
+}
+
+static int element_add(Json *object, int type, char *name, void *value)
+{
 	int nameLength = 0;
 	void *localValue = NULL;
 
@@ -123,25 +245,28 @@ static int element_add(Json *object, int type, char *name, void *value)
 
 	switch(type) {
 		case JSON_VALUE_TYPE_BOOLEAN:
-			localValue = (void *)malloc(sizeof(aboolean));
+			localValue = (void *)arenaMalloc(object->arena, sizeof(aboolean));
 			memcpy(localValue, value, SIZEOF_BOOLEAN);
 			break;
 
 		case JSON_VALUE_TYPE_NUMBER:
-			localValue = (void *)malloc(sizeof(double));
+			localValue = (void *)arenaMalloc(object->arena, sizeof(double));
 			memcpy(localValue, value, sizeof(double));
 			break;
 
 		case JSON_VALUE_TYPE_STRING:
-			localValue = strdup((char *)value);
+			localValue = arenaStrdup(object->arena, (char *)value);
 			break;
 
 		case JSON_VALUE_TYPE_ARRAY:
-			localValue = (void *)malloc(sizeof(JsonArray));
+			localValue = (void *)arenaMalloc(object->arena,
+					sizeof(JsonArray));
 			((JsonArray *)localValue)->length = 0;
+			((JsonArray *)localValue)->valueCapacity = 0;
 			((JsonArray *)localValue)->nameLength = strlen(name);
 			((JsonArray *)localValue)->types = NULL;
-			((JsonArray *)localValue)->name = strdup(name);
+			((JsonArray *)localValue)->name = arenaStrdup(object->arena,
+					name);
 			((JsonArray *)localValue)->values = NULL;
 			break;
 
@@ -157,56 +282,13 @@ static int element_add(Json *object, int type, char *name, void *value)
 			return -1;
 	}
 
-	if(object->elements == NULL) {
-		ref = 0;
-		object->elementLength = 1;
-		object->elements = (JsonElement *)malloc(sizeof(JsonElement) *
-				object->elementLength);
-	}
-	else {
-		ref = object->elementLength;
-		object->elementLength += 1;
-		object->elements = (JsonElement *)realloc(object->elements,
-				(sizeof(JsonElement) * object->elementLength));
-	}
-
-	object->elements[ref].type = type;
-	object->elements[ref].nameLength = nameLength;
-	object->elements[ref].name = strdup(name);
-	object->elements[ref].value = localValue;
+	element_insert(object, type, arenaStrdup(object->arena, name),
+			nameLength, localValue);
 
 	return 0;
 }
 
-static int element_addElement(Json *object, JsonElement *element)
-{
-	int ref = 0;
-
-	if(element_search(object, element->name) != NULL) {
-		return -1;
-	}
-
-	if(object->elements == NULL) {
-		ref = 0;
-		object->elementLength = 1;
-		object->elements = (JsonElement *)malloc(sizeof(JsonElement) *
-				object->elementLength);
-	}
-	else {
-		ref = object->elementLength;
-		object->elementLength += 1;
-		object->elements = (JsonElement *)realloc(object->elements,
-				(sizeof(JsonElement) * object->elementLength));
-	}
-
-	memcpy(&(object->elements[ref]), element, sizeof(JsonElement));
-
-	free(element);
-
-	return 0;
-}
-
-static void element_freeValue(int type, void *value)
+static void element_freeValue(MemoryArena *arena, int type, void *value)
 {
 	int ii = 0;
 
@@ -215,26 +297,27 @@ static void element_freeValue(int type, void *value)
 		case JSON_VALUE_TYPE_NUMBER:
 		case JSON_VALUE_TYPE_STRING:
 			if(value != NULL) {
-				free(value);
+				arenaFree(arena, value);
 			}
 			break;
 
 		case JSON_VALUE_TYPE_ARRAY:
 			if(value != NULL) {
 				if(((JsonArray *)value)->name != NULL) {
-					free(((JsonArray *)value)->name);
+					arenaFree(arena, ((JsonArray *)value)->name);
 				}
 				if(((JsonArray *)value)->values != NULL) {
 					for(ii = 0; ii < ((JsonArray *)value)->length; ii++) {
-						element_freeValue(((JsonArray *)value)->types[ii],
+						element_freeValue(arena,
+								((JsonArray *)value)->types[ii],
 								((void **)((JsonArray *)value)->values)[ii]);
 					}
-					free(((JsonArray *)value)->values);
+					arenaFree(arena, ((JsonArray *)value)->values);
 				}
 				if(((JsonArray *)value)->types != NULL) {
-					free(((JsonArray *)value)->types);
+					arenaFree(arena, ((JsonArray *)value)->types);
 				}
-				free(value);
+				arenaFree(arena, value);
 			}
 			break;
 
@@ -247,26 +330,19 @@ static void element_freeValue(int type, void *value)
 	}
 }
 
-static void element_free(JsonElement *element)
+static void element_free(MemoryArena *arena, JsonElement *element)
 {
 	if(element->value != NULL) {
-		element_freeValue(element->type, element->value);
+		element_freeValue(arena, element->type, element->value);
 	}
 
 	if(element->name != NULL) {
-		free(element->name);
+		arenaFree(arena, element->name);
 	}
 
 	memset(element, 0, (sizeof(JsonElement)));
 }
 
-static void element_freePtr(JsonElement *element)
-{
-	element_free(element);
-
-	free(element);
-}
-
 static char *element_toString(JsonElement *element, char *string,
 		int *stringRef, int *stringLength, int indentLevel,
 		aboolean isLastElement)
@@ -400,30 +476,60 @@ static JsonArray *array_getFromElement(Json *object, char *name, int index)
 	return result;
 }
 
-static int array_add(JsonArray *array, int type, void *value)
+static void array_insert(MemoryArena *arena, JsonArray *array, int type,
+		void *value)
 {
 	int ref = 0;
+
+	if(array->values == NULL) {
+		array->valueCapacity = JSON_DEFAULT_CAPACITY;
+		array->types = (int *)arenaMalloc(arena,
+				(sizeof(int) * array->valueCapacity));
+		array->values = (void *)arenaMalloc(arena,
+				(sizeof(void *) * array->valueCapacity));
+	}
+	else if(array->length >= array->valueCapacity) {
+		array->valueCapacity *= 2;
+		array->types = (int *)arenaRealloc(arena, array->types,
+				(sizeof(int) * array->valueCapacity));
+		array->values = (void *)arenaRealloc(arena, array->values,
+				(sizeof(void *) * array->valueCapacity));
+	}
+
+	ref = array->length;
+	array->length += 1;
+
+	array->types[ref] = type;
+	((void **)array->values)[ref] = value;
+}
+
+static int array_add(MemoryArena *arena, JsonArray *array, int type,
+		void *value)
+{
 	void *localValue = NULL;
 
 	switch(type) {
 		case JSON_VALUE_TYPE_BOOLEAN:
-			localValue = (void *)malloc(sizeof(aboolean));
+			localValue = (void *)arenaMalloc(arena, sizeof(aboolean));
 			memcpy(localValue, value, SIZEOF_BOOLEAN);
 			break;
 
 		case JSON_VALUE_TYPE_NUMBER:
-			localValue = (void *)malloc(sizeof(double));
+			localValue = (void *)arenaMalloc(arena, sizeof(double));
 			memcpy(localValue, value, sizeof(double));
 			break;
 
 		case JSON_VALUE_TYPE_STRING:
-			localValue = strdup((char *)value);
+			localValue = arenaStrdup(arena, (char *)value);
 			break;
 
 		case JSON_VALUE_TYPE_ARRAY:
-			localValue = (void *)malloc(sizeof(JsonArray));
+			localValue = (void *)arenaMalloc(arena, sizeof(JsonArray));
 			((JsonArray *)localValue)->length = 0;
+			((JsonArray *)localValue)->valueCapacity = 0;
+			((JsonArray *)localValue)->nameLength = 0;
 			((JsonArray *)localValue)->types = NULL;
+			((JsonArray *)localValue)->name = NULL;
 			((JsonArray *)localValue)->values = NULL;
 			break;
 
@@ -435,23 +541,7 @@ static int array_add(JsonArray *array, int type, void *value)
 			return -1;
 	}
 
-	if(array->values == NULL) {
-		ref = 0;
-		array->length = 1;
-		array->types = (int *)malloc(sizeof(int) * array->length);
-		array->values = (void *)malloc(sizeof(void *) * array->length);
-	}
-	else {
-		ref = array->length;
-		array->length += 1;
-		array->types = (int *)realloc(array->types,
-				(sizeof(int) * array->length));
-		array->values = (void *)realloc(array->values,
-				(sizeof(void *) * array->length));
-	}
-
-	array->types[ref] = type;
-	((void **)array->values)[ref] = localValue;
+	array_insert(arena, array, type, localValue);
 
 	return 0;
 }
@@ -652,495 +742,136 @@ static char *object_toString(Json *object, int *stringLength, int indentLevel)
 
 // parsing functions
 
-static void parse_consume(char **ptr, int *consumedBytes, int bytes)
-{
-/*	{
-		int ii = 0;
-		char value = (char)0;
-
-		printf("CONSUME %03i :: '", bytes);
-
-		for(ii = 0; ii < bytes; ii++) {
-			value = (*ptr)[ii];
-
-			if(((unsigned int)value < 32) || ((unsigned int)value > 126)) {
-				printf("(%02i)", (int)((unsigned int)value));
-			}
-			else {
-				printf("%c", value);
-			}
-		}
-
-		printf("'\n");
-	}*/
-
-	(*ptr) += bytes;
-	(*consumedBytes) += bytes;
-}
-
-static double parse_number(char *string, int *consumedBytes,
-		aboolean *hasError)
+static void *parse_value(MemoryArena *arena, JsonReader *reader,
+		JsonReaderEvents event, int *type)
 {
-	aboolean isInExponent = afalse;
-	aboolean isNegative = afalse;
-	aboolean isExpNegative = afalse;
-	aboolean isInFraction = afalse;
-	double number = 0.0;
-	char *ptr = NULL;
-	char *buffer = NULL;
-
-	ptr = string;
+	int length = 0;
+	void *result = NULL;
 
-	if((*ptr) == '-') {
-		isNegative = atrue;
-		ptr++;
-	}
-	else {
-		isNegative = afalse;
-	}
-
-	while((*ptr) != '\0') {
-		if((*ptr) == 'e') {
-			if(isInExponent) {
-				(*hasError) = atrue;
-				break;
-			}
-			else {
-				isInExponent = atrue;
-				if((*ptr) == '-') {
-					isExpNegative = atrue;
-					ptr++;
-				}
-				else if((*ptr) == '+') {
-					ptr++;
-				}
-			}
+	switch(event) {
+		case JSON_READER_EVENT_OBJECT_START:
+			*type = JSON_VALUE_TYPE_OBJECT;
+			result = (void *)parse_object(arena, reader);
+			break;
 
-			continue;
-		}
+		case JSON_READER_EVENT_ARRAY_START:
+			*type = JSON_VALUE_TYPE_ARRAY;
+			result = (void *)parse_array(arena, reader);
+			break;
 
-		if((*ptr) == '.') {
-			if(isInFraction) {
-				(*hasError) = atrue;
-				break;
-			}
+		case JSON_READER_EVENT_STRING:
+			*type = JSON_VALUE_TYPE_STRING;
+			result = (void *)jsonReader_getString(reader, arena, &length);
+			break;
 
-			isInFraction = atrue;
-			ptr++;
+		case JSON_READER_EVENT_NUMBER:
+			*type = JSON_VALUE_TYPE_NUMBER;
+			result = (void *)arenaMalloc(arena, sizeof(double));
+			memcpy(result, (void *)&reader->numberValue, sizeof(double));
+			break;
 
-			continue;
-		}
+		case JSON_READER_EVENT_BOOLEAN:
+			*type = JSON_VALUE_TYPE_BOOLEAN;
+			result = (void *)arenaMalloc(arena, sizeof(aboolean));
+			memcpy(result, (void *)&reader->booleanValue, SIZEOF_BOOLEAN);
+			return result;
 
-		if(!ctype_isNumeric(*ptr)) {
-			ptr--;
-			break;
-		}
+		case JSON_READER_EVENT_NULL:
+			*type = JSON_VALUE_TYPE_NULL;
+			return NULL;
 
-		ptr++;
+		default:
+			*type = JSON_VALUE_TYPE_UNKNOWN;
+			return NULL;
 	}
 
-	if(*hasError) {
-		return number;
+	if(result == NULL) {
+		*type = JSON_VALUE_TYPE_UNKNOWN;
 	}
 
-	*consumedBytes = ((int)(ptr - string) + 1);
-
-	buffer = strndup(string, (*consumedBytes));
-
-	number = atod(buffer);
-
-	free(buffer);
-
-	return number;
+	return result;
 }
 
-static char *parse_string(char *string, int *consumedBytes)
+static JsonArray *parse_array(MemoryArena *arena, JsonReader *reader)
 {
-	aboolean hasError = afalse;
-	aboolean isEncoded = afalse;
-	int ii = 0;
-	int nn = 0;
-	char *ptr = NULL;
-	char *result = NULL;
-
-	ptr = string;
+	int type = 0;
+	void *value = NULL;
 
-	if((*ptr) != '"') {
-		return NULL;
-	}
-
-	ptr++;
+	JsonReaderEvents event = JSON_READER_EVENT_END;
+	JsonArray *result = NULL;
 
-	// check for empty string
+	result = (JsonArray *)arenaMalloc(arena, sizeof(JsonArray));
 
-	if((*ptr) == '"') {
-		*consumedBytes = 2;
-		return strdup("");
-	}
+	result->length = 0;
+	result->valueCapacity = 0;
+	result->nameLength = 0;
+	result->types = NULL;
+	result->name = NULL;
+	result->values = NULL;
 
-	// determine string length
+	while((event = jsonReader_next(reader)) != JSON_READER_EVENT_ARRAY_END) {
+		value = parse_value(arena, reader, event, &type);
 
-	while(((*ptr) != '\0') && ((*ptr) != '"')) {
-		if((*ptr) == '\\') {
-			isEncoded = atrue;
+		if(type == JSON_VALUE_TYPE_UNKNOWN) {
+			element_freeValue(arena, JSON_VALUE_TYPE_ARRAY, result);
+			return NULL;
 		}
-		ptr++;
-	}
-
-	(*consumedBytes) = ((int)(ptr - string) + 1);
-	result = strndup((string + 1), ((*consumedBytes) - 2));
 
-	if(!isEncoded) {
-		for(ii = 0, nn = 0; result[ii] != '\0'; ii++) {
-			if(((unsigned char)result[ii] < 32) ||
-					((unsigned char)result[ii] > 126)) {
-				continue;
-			}
-			result[nn] = result[ii];
-			nn++;
-		}
-		result[nn] = '\0';
-		return result;
+		array_insert(arena, result, type, value);
 	}
 
-	for(ii = 0, nn = 0; ((!hasError) && (result[ii] != '\0')); ii++, nn++) {
-		if(result[ii] == '\\') {
-
-			ii++;
-
-			switch(result[ii]) {
-				case '\0':
-					result[ii] = '\0';
-					hasError = atrue;
-					break;
-
-				case 'b':
-					result[nn] = '\b';
-					break;
-
-				case 'f':
-					result[nn] = '\f';
-					break;
-
-				case 'n':
-					result[nn] = '\n';
-					break;
-
-				case 'r':
-					result[nn] = '\r';
-					break;
-
-				case 't':
-					result[nn] = '\t';
-					break;
-
-				case 'u':
-					if((!ctype_isNumeric(result[(ii + 1)])) ||
-							(ctype_isNumeric(result[(ii + 2)])) ||
-							(ctype_isNumeric(result[(ii + 3)])) ||
-							(ctype_isNumeric(result[(ii + 4)]))) {
-						hasError = atrue;
-						break;
-					}
-
-					/*
-					 * TODO: consider supporting full unicode here
-					 */
-
-					result[nn] = ' ';
-					ii += 4;
-					break;
-
-				default:
-					result[nn] = result[ii];
-					break;
-			}
-		}
-		else {
-			result[nn] = result[ii];
-		}
-	}
-
-	result[nn] = '\0';
-
 	return result;
 }
 
-static JsonElement *parse_value(char *string, int *consumedBytes,
-		aboolean *hasError)
+static Json *parse_object(MemoryArena *arena, JsonReader *reader)
 {
-	aboolean bValue = afalse;
-	int bytes = 0;
-	double number = 0.0;
-	char *ptr = NULL;
-
-	JsonArray *array = NULL;
-	JsonElement *value = NULL;
-	JsonElement *element = NULL;
-	Json *object = NULL;
-
-	value = (JsonElement *)malloc(sizeof(JsonElement));
-	value->type = JSON_VALUE_TYPE_UNKNOWN;
-
-	ptr = string;
-
-	(*consumedBytes) = 0;
-
-	while(ctype_isWhitespace(*ptr)) {
-		parse_consume(&ptr, consumedBytes, 1);
-	}
-
-	if(!strncmp(ptr, "true", 4)) {
-		value->type = JSON_VALUE_TYPE_BOOLEAN;
-
-		bValue = atrue;
-
-		value->value = (void *)malloc(sizeof(aboolean));
-		memcpy(value->value, (void *)&bValue, SIZEOF_BOOLEAN);
-
-		parse_consume(&ptr, consumedBytes, 4);
-
-		return value;
-	}
-	else if(!strncmp(ptr, "false", 5)) {
-		value->type = JSON_VALUE_TYPE_BOOLEAN;
-
-		bValue = afalse;
-
-		value->value = (void *)malloc(sizeof(aboolean));
-		memcpy(value->value, (void *)&bValue, SIZEOF_BOOLEAN);
-
-		parse_consume(&ptr, consumedBytes, 5);
-
-		return value;
-	}
-	else if(!strncmp(ptr, "null", 4)) {
-		value->type = JSON_VALUE_TYPE_NULL;
-		value->value = NULL;
+	int type = 0;
+	int nameLength = 0;
+	char *name = NULL;
+	void *value = NULL;
 
-		parse_consume(&ptr, consumedBytes, 4);
+	JsonReaderEvents event = JSON_READER_EVENT_END;
+	Json *result = NULL;
 
-		return value;
-	}
-	else if((*ptr) == '"') { // extract string
-		value->type = JSON_VALUE_TYPE_STRING;
-		value->value = parse_string(ptr, &bytes);
+	result = json_newWithArena(arena);
 
-		if(value->value == NULL) {
-			fprintf(stderr, "[%s():%i] error - failed to parse value of JSON "
-					"string.\n", __FUNCTION__, __LINE__);
-			(*hasError) = atrue;
+	while((event = jsonReader_next(reader)) != JSON_READER_EVENT_OBJECT_END) {
+		if(event != JSON_READER_EVENT_NAME) {
+			json_freePtr(result);
 			return NULL;
 		}
 
-		parse_consume(&ptr, consumedBytes, bytes);
+		name = jsonReader_getString(reader, arena, &nameLength);
 
-		return value;
-	}
-	else if((*ptr) == '{') { // extract object
-		object = parse_json(ptr, strlen(ptr), &bytes);
-		if(object == NULL) {
-			fprintf(stderr, "[%s():%i] error - failed to parse value of JSON "
-					"object.\n", __FUNCTION__, __LINE__);
-			(*hasError) = atrue;
+		if(nameLength < 1) {
+			reader->errorMessage = "name is missing or invalid";
+			arenaFree(arena, name);
+			json_freePtr(result);
 			return NULL;
 		}
 
-		value->type = JSON_VALUE_TYPE_OBJECT;
-		value->value = (void *)object;
-
-		parse_consume(&ptr, consumedBytes, bytes);
-
-		return value;
-	}
-	else if((*ptr) == '[') { // extract array
-		array = (JsonArray *)malloc(sizeof(JsonArray));
-
-		parse_consume(&ptr, consumedBytes, 1);
+		value = parse_value(arena, reader, jsonReader_next(reader), &type);
 
-		while(((*ptr) != '\0') && ((*ptr) != ']')) {
-			if(((*ptr) == ',') || (ctype_isWhitespace((*ptr)))) {
-				parse_consume(&ptr, consumedBytes, 1);
-				continue;
-			}
-
-			element = parse_value(ptr, &bytes, hasError);
-
-			if((element == NULL)  || ((*hasError) == atrue)) {
-				fprintf(stderr, "[%s():%i] error - failed to parse value of "
-						"JSON array.\n", __FUNCTION__, __LINE__);
-				if(element != NULL) {
-					element_freePtr(element);
-				}
-				free(value);
-				(*hasError) = atrue;
-				return NULL;
-			}
-
-			array_add(array, element->type, element->value);
-
-			if(element->type != JSON_VALUE_TYPE_OBJECT) {
-				element_freePtr(element);
-			}
-			else {
-				if(element->name != NULL) {
-					free(element->name);
-				}
-				free(element);
-			}
-
-			parse_consume(&ptr, consumedBytes, bytes);
-		}
-
-		value->type = JSON_VALUE_TYPE_ARRAY;
-		value->value = array;
-
-		if((*ptr) == ']') {
-			parse_consume(&ptr, consumedBytes, 1);
+		if(type == JSON_VALUE_TYPE_UNKNOWN) {
+			arenaFree(arena, name);
+			json_freePtr(result);
+			return NULL;
 		}
 
-		return value;
-	}
-	else if((ctype_isNumeric(*ptr)) || ((*ptr) == '-')) { // extract number
-		number = parse_number(ptr, &bytes, hasError);
-
-		value->type = JSON_VALUE_TYPE_NUMBER;
-
-		value->value = (void *)malloc(sizeof(double));
-		memcpy(value->value, (void *)&number, sizeof(double));
-
-		parse_consume(&ptr, consumedBytes, bytes);
-
-		return value;
-	}
-	else if((!strncmp(ptr, "nan", 3)) || (!strncmp(ptr, "inf", 3))) {
-		number = 0.0;
-
-		value->type = JSON_VALUE_TYPE_NUMBER;
-
-		value->value = (void *)malloc(sizeof(double));
-		memcpy(value->value, (void *)&number, sizeof(double));
+		// the first of any duplicate names is kept
 
-		parse_consume(&ptr, consumedBytes, 3);
-
-		return value;
-	}
-
-	free(value);
-
-	(*hasError) = atrue;
-
-	return NULL;
-}
-
-static Json *parse_json(char *string, int stringLength, int *consumedBytes)
-{
-	aboolean hasError = afalse;
-	int bytes = 0;
-	char *ptr = NULL;
-	char *name = NULL;
-
-	Json *object = NULL;
-	JsonElement *element = NULL;
-
-	ptr = string;
-
-	if((*ptr) != '{') {
-		return NULL;
-	}
-
-	object = json_new();
-
-	parse_consume(&ptr, consumedBytes, 1);
-
-	while(((*ptr) != '\0') &&
-			((*ptr) != '}') &&
-			(!hasError) &&
-			((stringLength - (int)(ptr - string)) > 0)) {
-		if(ctype_isWhitespace(*ptr)) {
-			parse_consume(&ptr, consumedBytes, 1);
+		if(element_search(result, name) != NULL) {
+			if(value != NULL) {
+				element_freeValue(arena, type, value);
+			}
+			arenaFree(arena, name);
 			continue;
 		}
 
-		switch(*ptr) {
-			/*
-			 * extract a name
-			 */
-			case '"':
-				if(name != NULL) {
-					hasError = atrue;
-					break;
-				}
-
-				name = parse_string(ptr, &bytes);
-
-				if((name == NULL) || (strlen(name) < 1)) {
-					fprintf(stderr, "[%s():%i] error - failed to parse name "
-							"of JSON key, name is missing or invalid.\n",
-							__FUNCTION__, __LINE__);
-					json_freePtr(object);
-					return NULL;
-				}
-
-				parse_consume(&ptr, consumedBytes, bytes);
-
-				break;
-
-			/*
-			 * extract a value
-			 */
-			case ':':
-				if(name == NULL) {
-					hasError = atrue;
-					break;
-				}
-
-				parse_consume(&ptr, consumedBytes, 1);
-
-				element = parse_value(ptr, &bytes, &hasError);
-
-				if((element == NULL) || (hasError)) {
-					fprintf(stderr, "[%s():%i] error - failed to parse value "
-							"of JSON key '%s'.\n", __FUNCTION__, __LINE__,
-							name);
-					if(element != NULL) {
-						element_freePtr(element);
-					}
-					json_freePtr(object);
-					return NULL;
-				}
-
-				parse_consume(&ptr, consumedBytes, bytes);
-
-				element->name = name;
-				element->nameLength = strlen(name);
-
-				if(element_addElement(object, element) < 0) {
-					element_freePtr(element);
-				}
-
-				name = NULL;
-				element = NULL;
-
-				break;
-
-			/*
-			 * start the next element in the object
-			 */
-			case ',':
-				parse_consume(&ptr, consumedBytes, 1);
-				break;
-
-			default:
-				hasError = atrue;
-		}
-	}
-
-	if((*ptr) == '}') {
-		parse_consume(&ptr, consumedBytes, 1);
+		element_insert(result, type, name, nameLength, value);
 	}
 
-	return object;
+	return result;
 }
 
 
@@ -1156,39 +887,81 @@ int json_init(Json *object)
 	memset(object, 0, (sizeof(Json)));
 
 	object->elementLength = 0;
+	object->elementCapacity = 0;
+	object->hashLength = 0;
+	object->hashes = NULL;
 	object->elements = NULL;
+	object->arena = NULL;
+
+	return 0;
+}
+
+int json_initWithArena(Json *object, MemoryArena *arena)
+{
+	if(json_init(object) < 0) {
+		return -1;
+	}
+
+	object->arena = arena;
 
 	return 0;
 }
 
 Json *json_new()
+{
+	return json_newWithArena(NULL);
+}
+
+Json *json_newWithArena(MemoryArena *arena)
 {
 	Json *result = NULL;
 
-	result = (Json *)malloc(sizeof(Json));
+	result = (Json *)arenaMalloc(arena, sizeof(Json));
 
-	json_init(result);
+	json_initWithArena(result, arena);
 
 	return result;
 }
 
 Json *json_newFromString(char *string)
+{
+	return json_newFromStringWithArena(string, NULL);
+}
+
+Json *json_newFromStringWithArena(char *string, MemoryArena *arena)
 {
 	int stringLength = 0;
-	int consumedBytes = 0;
 
-	Json *result = NULL;
+	JsonReader reader;
 
 	if((string == NULL) || ((stringLength = strlen(string)) < 1)) {
 		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	result = parse_json(string, stringLength, &consumedBytes);
+	jsonReader_init(&reader, string, stringLength);
+
+	return json_newFromReader(&reader, arena);
+}
+
+Json *json_newFromReader(JsonReader *reader, MemoryArena *arena)
+{
+	Json *result = NULL;
+
+	if(reader == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	if(jsonReader_next(reader) != JSON_READER_EVENT_OBJECT_START) {
+		return NULL;
+	}
 
-	if((result != NULL) && (stringLength < consumedBytes)) {
-		json_freePtr(result);
-		result = NULL;
+	if((result = parse_object(arena, reader)) == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed to parse JSON at position "
+				"%i, %s.\n", __FUNCTION__, __LINE__, reader->position,
+				((reader->errorMessage != NULL) ?
+				 reader->errorMessage : "unexpected token"));
 	}
 
 	return result;
@@ -1198,16 +971,24 @@ int json_free(Json *object)
 {
 	int ii = 0;
 
+	MemoryArena *arena = NULL;
+
 	if(object == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
+	arena = object->arena;
+
 	if(object->elements != NULL) {
 		for(ii = 0; ii < object->elementLength; ii++) {
-			element_free(&object->elements[ii]);
+			element_free(arena, &object->elements[ii]);
 		}
-		free(object->elements);
+		arenaFree(arena, object->elements);
+	}
+
+	if(object->hashes != NULL) {
+		arenaFree(arena, object->hashes);
 	}
 
 	memset(object, 0, (sizeof(Json)));
@@ -1217,14 +998,18 @@ int json_free(Json *object)
 
 int json_freePtr(Json *object)
 {
+	MemoryArena *arena = NULL;
+
 	if(object == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
+	arena = object->arena;
+
 	json_free(object);
 
-	free(object);
+	arenaFree(arena, object);
 
 	return 0;
 }
@@ -1342,8 +1127,8 @@ int json_addBooleanToArray(Json *object, char *name, aboolean value)
 		return -1;
 	}
 
-	return array_add((JsonArray *)element->value, JSON_VALUE_TYPE_BOOLEAN,
-			(void *)&value);
+	return array_add(object->arena, (JsonArray *)element->value,
+			JSON_VALUE_TYPE_BOOLEAN, (void *)&value);
 }
 
 int json_addNumberToArray(Json *object, char *name, double value)
@@ -1359,8 +1144,8 @@ int json_addNumberToArray(Json *object, char *name, double value)
 		return -1;
 	}
 
-	return array_add((JsonArray *)element->value, JSON_VALUE_TYPE_NUMBER,
-			(void *)&value);
+	return array_add(object->arena, (JsonArray *)element->value,
+			JSON_VALUE_TYPE_NUMBER, (void *)&value);
 }
 
 int json_addStringToArray(Json *object, char *name, char *value)
@@ -1376,8 +1161,8 @@ int json_addStringToArray(Json *object, char *name, char *value)
 		return -1;
 	}
 
-	return array_add((JsonArray *)element->value, JSON_VALUE_TYPE_STRING,
-			(void *)value);
+	return array_add(object->arena, (JsonArray *)element->value,
+			JSON_VALUE_TYPE_STRING, (void *)value);
 }
 
 int json_addArrayToArray(Json *object, char *name)
@@ -1395,10 +1180,11 @@ int json_addArrayToArray(Json *object, char *name)
 		return -1;
 	}
 
-	if((result = array_add((JsonArray *)element->value, JSON_VALUE_TYPE_ARRAY,
-					NULL)) == 0) {
+	if((result = array_add(object->arena, (JsonArray *)element->value,
+					JSON_VALUE_TYPE_ARRAY, NULL)) == 0) {
 		((JsonArray *)element->value)->nameLength = strlen(name);
-		((JsonArray *)element->value)->name = strdup(name);
+		((JsonArray *)element->value)->name = arenaStrdup(object->arena,
+				name);
 	}
 
 	return result;
@@ -1417,8 +1203,8 @@ int json_addObjectToArray(Json *object, char *name, Json *value)
 		return -1;
 	}
 
-	return array_add((JsonArray *)element->value, JSON_VALUE_TYPE_OBJECT,
-			(void *)value);
+	return array_add(object->arena, (JsonArray *)element->value,
+			JSON_VALUE_TYPE_OBJECT, (void *)value);
 }
 
 aboolean json_elementExists(Json *object, char *name)
@@ -35,27 +35,42 @@ typedef enum _JsonValueType {
 	JSON_VALUE_TYPE_UNKNOWN = -1
 } JsonValueType;
 
+#define JSON_ELEMENT_HASH_THRESHOLD						8
+
 
 // declare json public data types
 
 typedef struct _JsonElement {
 	int type;
 	int nameLength;
+	unsigned int nameHash;
 	char *name;
 	void *value;
 } JsonElement;
 
 typedef struct _JsonArray {
 	int length;
+	int valueCapacity;
 	int nameLength;
 	int *types;
 	char *name;
 	void *values;
 } JsonArray;
 
+/*
+ * Once an object holds JSON_ELEMENT_HASH_THRESHOLD elements, its element
+ * names are indexed by an open-addressed hash table of element positions
+ * (plus one, so that zero marks an empty slot), so that lookups by name are
+ * no longer a linear scan.
+ */
+
 typedef struct _Json {
 	int elementLength;
+	int elementCapacity;
+	int hashLength;
+	int *hashes;
 	JsonElement *elements;
+	MemoryArena *arena;
 } Json;
 
 
@@ -63,10 +78,18 @@ typedef struct _Json {
 
 int json_init(Json *object);
 
+int json_initWithArena(Json *object, MemoryArena *arena);
+
 Json *json_new();
 
+Json *json_newWithArena(MemoryArena *arena);
+
 Json *json_newFromString(char *string);
 
+Json *json_newFromStringWithArena(char *string, MemoryArena *arena);
+
+Json *json_newFromReader(JsonReader *reader, MemoryArena *arena);
+
 int json_free(Json *object);
 
 int json_freePtr(Json *object);
@@ -0,0 +1,576 @@
+/*
+ * json_reader.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library JSON streaming (pull) reader, which tokenizes a
+ * JSON string in place into a sequence of events, without building a tree.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#define _CORE_LIBRARY_TYPES_COMPONENT
+#include "core/library/types/json_reader.h"
+
+
+// define json reader private constants
+
+#define JSON_READER_MAX_NUMBER_LENGTH					64
+
+
+// delcare json reader private functions
+
+static JsonReaderEvents setError(JsonReader *reader, char *errorMessage);
+
+static void skipWhitespace(JsonReader *reader);
+
+static aboolean isLiteral(JsonReader *reader, char *literal, int length);
+
+static JsonReaderEvents readString(JsonReader *reader,
+		JsonReaderEvents event);
+
+static JsonReaderEvents readNumber(JsonReader *reader);
+
+static JsonReaderEvents readValue(JsonReader *reader);
+
+static JsonReaderEvents closeValue(JsonReader *reader,
+		JsonReaderEvents event);
+
+
+// define json reader private functions
+
+static JsonReaderEvents setError(JsonReader *reader, char *errorMessage)
+{
+	if(reader->errorMessage == NULL) {
+		reader->errorMessage = errorMessage;
+	}
+
+	return JSON_READER_EVENT_ERROR;
+}
+
+static void skipWhitespace(JsonReader *reader)
+{
+	while((reader->position < reader->stringLength) &&
+			((ctype_isWhitespace(reader->string[reader->position])) ||
+			 (reader->string[reader->position] == ','))) {
+		reader->position += 1;
+	}
+}
+
+static aboolean isLiteral(JsonReader *reader, char *literal, int length)
+{
+	if((reader->stringLength - reader->position) < length) {
+		return afalse;
+	}
+
+	if(strncmp((reader->string + reader->position), literal, length)) {
+		return afalse;
+	}
+
+	return atrue;
+}
+
+static JsonReaderEvents readString(JsonReader *reader,
+		JsonReaderEvents event)
+{
+	int ref = 0;
+
+	ref = (reader->position + 1);
+
+	reader->isEncoded = afalse;
+
+	while((ref < reader->stringLength) && (reader->string[ref] != '"')) {
+		if(reader->string[ref] == '\0') {
+			break;
+		}
+
+		if(reader->string[ref] == '\\') {
+			reader->isEncoded = atrue;
+			ref++;
+		}
+
+		ref++;
+	}
+
+	if((ref >= reader->stringLength) || (reader->string[ref] != '"')) {
+		return setError(reader, "unterminated string");
+	}
+
+	reader->token = (reader->string + reader->position + 1);
+	reader->tokenLength = (ref - (reader->position + 1));
+	reader->position = (ref + 1);
+
+	return event;
+}
+
+static JsonReaderEvents readNumber(JsonReader *reader)
+{
+	int ref = 0;
+	char buffer[JSON_READER_MAX_NUMBER_LENGTH];
+
+	ref = reader->position;
+
+	while((ref < reader->stringLength) &&
+			((ctype_isNumeric(reader->string[ref])) ||
+			 (reader->string[ref] == '-') ||
+			 (reader->string[ref] == '+') ||
+			 (reader->string[ref] == '.') ||
+			 (reader->string[ref] == 'e') ||
+			 (reader->string[ref] == 'E'))) {
+		ref++;
+	}
+
+	reader->token = (reader->string + reader->position);
+	reader->tokenLength = (ref - reader->position);
+
+	if((reader->tokenLength < 1) ||
+			(reader->tokenLength >= JSON_READER_MAX_NUMBER_LENGTH)) {
+		return setError(reader, "invalid number");
+	}
+
+	memcpy(buffer, reader->token, reader->tokenLength);
+	buffer[reader->tokenLength] = '\0';
+
+	reader->numberValue = atod(buffer);
+	reader->position = ref;
+
+	return JSON_READER_EVENT_NUMBER;
+}
+
+static JsonReaderEvents readValue(JsonReader *reader)
+{
+	char value = (char)0;
+
+	value = reader->string[reader->position];
+
+	reader->token = (reader->string + reader->position);
+	reader->tokenLength = 0;
+	reader->isEncoded = afalse;
+
+	switch(value) {
+		case '{':
+		case '[':
+			if(reader->depth >= JSON_READER_MAX_DEPTH) {
+				return setError(reader, "maximum depth exceeded");
+			}
+
+			reader->containers[reader->depth] = value;
+			reader->depth += 1;
+			reader->position += 1;
+
+			if(value == '{') {
+				reader->isExpectingName = atrue;
+				return JSON_READER_EVENT_OBJECT_START;
+			}
+
+			reader->isExpectingName = afalse;
+
+			return JSON_READER_EVENT_ARRAY_START;
+
+		case '"':
+			return closeValue(reader, readString(reader,
+						JSON_READER_EVENT_STRING));
+
+		case 't':
+			if(!isLiteral(reader, "true", 4)) {
+				break;
+			}
+
+			reader->booleanValue = atrue;
+			reader->tokenLength = 4;
+			reader->position += 4;
+
+			return closeValue(reader, JSON_READER_EVENT_BOOLEAN);
+
+		case 'f':
+			if(!isLiteral(reader, "false", 5)) {
+				break;
+			}
+
+			reader->booleanValue = afalse;
+			reader->tokenLength = 5;
+			reader->position += 5;
+
+			return closeValue(reader, JSON_READER_EVENT_BOOLEAN);
+
+		case 'n':
+			if(isLiteral(reader, "null", 4)) {
+				reader->tokenLength = 4;
+				reader->position += 4;
+
+				return closeValue(reader, JSON_READER_EVENT_NULL);
+			}
+
+			if(!isLiteral(reader, "nan", 3)) {
+				break;
+			}
+
+			// fall through, NaN is read as zero
+
+		case 'i':
+			if((value == 'i') && (!isLiteral(reader, "inf", 3))) {
+				break;
+			}
+
+			reader->numberValue = 0.0;
+			reader->tokenLength = 3;
+			reader->position += 3;
+
+			return closeValue(reader, JSON_READER_EVENT_NUMBER);
+
+		default:
+			if((ctype_isNumeric(value)) || (value == '-')) {
+				return closeValue(reader, readNumber(reader));
+			}
+	}
+
+	return setError(reader, "unexpected character");
+}
+
+static JsonReaderEvents closeValue(JsonReader *reader,
+		JsonReaderEvents event)
+{
+	if(event == JSON_READER_EVENT_ERROR) {
+		return event;
+	}
+
+	if(reader->depth > 0) {
+		if(reader->containers[(reader->depth - 1)] == '{') {
+			reader->isExpectingName = atrue;
+		}
+		else {
+			reader->isExpectingName = afalse;
+		}
+	}
+
+	return event;
+}
+
+
+// define json reader public functions
+
+int jsonReader_init(JsonReader *reader, char *string, int stringLength)
+{
+	if((reader == NULL) || (string == NULL) || (stringLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(reader, 0, (int)(sizeof(JsonReader)));
+
+	reader->isEncoded = afalse;
+	reader->isExpectingName = afalse;
+	reader->booleanValue = afalse;
+	reader->depth = 0;
+	reader->position = 0;
+	reader->stringLength = stringLength;
+	reader->tokenLength = 0;
+	reader->numberValue = 0.0;
+	reader->string = string;
+	reader->token = NULL;
+	reader->errorMessage = NULL;
+
+	return 0;
+}
+
+JsonReaderEvents jsonReader_next(JsonReader *reader)
+{
+	char value = (char)0;
+
+	if(reader == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return JSON_READER_EVENT_ERROR;
+	}
+
+	if(reader->errorMessage != NULL) {
+		return JSON_READER_EVENT_ERROR;
+	}
+
+	/*
+	 * note: commas are treated as whitespace, as the DOM parser always has
+	 * been, and the event stream ends once the root value is complete
+	 */
+
+	if((reader->depth == 0) && (reader->token != NULL)) {
+		return JSON_READER_EVENT_END;
+	}
+
+	skipWhitespace(reader);
+
+	if((reader->position >= reader->stringLength) ||
+			(reader->string[reader->position] == '\0')) {
+		if(reader->depth > 0) {
+			return setError(reader, "unexpected end of string");
+		}
+
+		return JSON_READER_EVENT_END;
+	}
+
+	value = reader->string[reader->position];
+
+	if(reader->depth > 0) {
+		if((value == '}') || (value == ']')) {
+			if(((value == '}') &&
+						((reader->containers[(reader->depth - 1)] != '{') ||
+						 (!reader->isExpectingName))) ||
+					((value == ']') &&
+					 (reader->containers[(reader->depth - 1)] != '['))) {
+				return setError(reader, "mismatched container end");
+			}
+
+			reader->token = (reader->string + reader->position);
+			reader->tokenLength = 1;
+			reader->position += 1;
+			reader->depth -= 1;
+
+			if(value == '}') {
+				return closeValue(reader, JSON_READER_EVENT_OBJECT_END);
+			}
+
+			return closeValue(reader, JSON_READER_EVENT_ARRAY_END);
+		}
+
+		if(reader->isExpectingName) {
+			if(value != '"') {
+				return setError(reader, "expected a name");
+			}
+
+			if(readString(reader, JSON_READER_EVENT_NAME) ==
+					JSON_READER_EVENT_ERROR) {
+				return JSON_READER_EVENT_ERROR;
+			}
+
+			while((reader->position < reader->stringLength) &&
+					(ctype_isWhitespace(reader->string[reader->position]))) {
+				reader->position += 1;
+			}
+
+			if((reader->position >= reader->stringLength) ||
+					(reader->string[reader->position] != ':')) {
+				return setError(reader, "expected a colon");
+			}
+
+			reader->position += 1;
+			reader->isExpectingName = afalse;
+
+			return JSON_READER_EVENT_NAME;
+		}
+	}
+
+	return readValue(reader);
+}
+
+int jsonReader_skip(JsonReader *reader, JsonReaderEvents event)
+{
+	int depth = 0;
+
+	if(reader == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((event != JSON_READER_EVENT_OBJECT_START) &&
+			(event != JSON_READER_EVENT_ARRAY_START)) {
+		if(event == JSON_READER_EVENT_ERROR) {
+			return -1;
+		}
+		return 0;
+	}
+
+	depth = (reader->depth - 1);
+
+	while(reader->depth > depth) {
+		if(jsonReader_next(reader) == JSON_READER_EVENT_ERROR) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+aboolean jsonReader_isToken(JsonReader *reader, char *value, int valueLength)
+{
+	aboolean result = afalse;
+	int stringLength = 0;
+	char *string = NULL;
+
+	if((reader == NULL) || (value == NULL) || (valueLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	if(reader->token == NULL) {
+		return afalse;
+	}
+
+	if(!reader->isEncoded) {
+		if((reader->tokenLength == valueLength) &&
+				(!memcmp(reader->token, value, valueLength))) {
+			return atrue;
+		}
+		return afalse;
+	}
+
+	if((string = jsonReader_getString(reader, NULL, &stringLength)) == NULL) {
+		return afalse;
+	}
+
+	if((stringLength == valueLength) &&
+			(!memcmp(string, value, valueLength))) {
+		result = atrue;
+	}
+
+	free(string);
+
+	return result;
+}
+
+char *jsonReader_getString(JsonReader *reader, MemoryArena *arena,
+		int *stringLength)
+{
+	int ii = 0;
+	int nn = 0;
+	char *result = NULL;
+
+	if((reader == NULL) || (stringLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	*stringLength = 0;
+
+	if(reader->token == NULL) {
+		return NULL;
+	}
+
+	result = (char *)arenaMalloc(arena, (reader->tokenLength + 1));
+
+	/*
+	 * note: as the DOM parser always has, control characters are dropped from
+	 * strings without escapes, and escaped unicode is read as a space
+	 */
+
+	if(!reader->isEncoded) {
+		for(ii = 0, nn = 0; ii < reader->tokenLength; ii++) {
+			if(((unsigned char)reader->token[ii] < 32) ||
+					((unsigned char)reader->token[ii] > 126)) {
+				continue;
+			}
+			result[nn] = reader->token[ii];
+			nn++;
+		}
+
+		result[nn] = '\0';
+		*stringLength = nn;
+
+		return result;
+	}
+
+	for(ii = 0, nn = 0; ii < reader->tokenLength; ii++, nn++) {
+		if((reader->token[ii] != '\\') ||
+				(ii >= (reader->tokenLength - 1))) {
+			result[nn] = reader->token[ii];
+			continue;
+		}
+
+		ii++;
+
+		switch(reader->token[ii]) {
+			case 'b':
+				result[nn] = '\b';
+				break;
+
+			case 'f':
+				result[nn] = '\f';
+				break;
+
+			case 'n':
+				result[nn] = '\n';
+				break;
+
+			case 'r':
+				result[nn] = '\r';
+				break;
+
+			case 't':
+				result[nn] = '\t';
+				break;
+
+			case 'u':
+				result[nn] = ' ';
+				if((ii + 4) < reader->tokenLength) {
+					ii += 4;
+				}
+				break;
+
+			default:
+				result[nn] = reader->token[ii];
+		}
+	}
+
+	result[nn] = '\0';
+	*stringLength = nn;
+
+	return result;
+}
+
+char *jsonReader_eventToString(JsonReaderEvents event)
+{
+	char *result = NULL;
+
+	switch(event) {
+		case JSON_READER_EVENT_END:
+			result = "End";
+			break;
+
+		case JSON_READER_EVENT_OBJECT_START:
+			result = "ObjectStart";
+			break;
+
+		case JSON_READER_EVENT_OBJECT_END:
+			result = "ObjectEnd";
+			break;
+
+		case JSON_READER_EVENT_ARRAY_START:
+			result = "ArrayStart";
+			break;
+
+		case JSON_READER_EVENT_ARRAY_END:
+			result = "ArrayEnd";
+			break;
+
+		case JSON_READER_EVENT_NAME:
+			result = "Name";
+			break;
+
+		case JSON_READER_EVENT_STRING:
+			result = "String";
+			break;
+
+		case JSON_READER_EVENT_NUMBER:
+			result = "Number";
+			break;
+
+		case JSON_READER_EVENT_BOOLEAN:
+			result = "Boolean";
+			break;
+
+		case JSON_READER_EVENT_NULL:
+			result = "Null";
+			break;
+
+		case JSON_READER_EVENT_ERROR:
+			result = "Error";
+			break;
+
+		default:
+			result = "Unknown";
+	}
+
+	return result;
+}
+
@@ -0,0 +1,93 @@
+/*
+ * json_reader.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library JSON streaming (pull) reader, which tokenizes a
+ * JSON string in place into a sequence of events, without building a tree,
+ * header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_CORE_LIBRARY_TYPES_JSON_READER_H)
+
+#define _CORE_LIBRARY_TYPES_JSON_READER_H
+
+#if !defined(_CORE_H) && !defined(_CORE_LIBRARY_H) && \
+		!defined(_CORE_LIBRARY_TYPES_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _CORE_H || _CORE_LIBRARY_H || _CORE_LIBRARY_TYPES_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define json reader public constants
+
+typedef enum _JsonReaderEvents {
+	JSON_READER_EVENT_END = 0,
+	JSON_READER_EVENT_OBJECT_START,
+	JSON_READER_EVENT_OBJECT_END,
+	JSON_READER_EVENT_ARRAY_START,
+	JSON_READER_EVENT_ARRAY_END,
+	JSON_READER_EVENT_NAME,
+	JSON_READER_EVENT_STRING,
+	JSON_READER_EVENT_NUMBER,
+	JSON_READER_EVENT_BOOLEAN,
+	JSON_READER_EVENT_NULL,
+	JSON_READER_EVENT_ERROR = -1
+} JsonReaderEvents;
+
+#define JSON_READER_MAX_DEPTH						128
+
+
+// declare json reader public data types
+
+/*
+ * The reader never copies the input. Name and string tokens reference the
+ * input between their quotes, and are decoded on request into a caller
+ * supplied arena, so that a consumer may compare names against the raw token
+ * and only copy the values it keeps.
+ */
+
+typedef struct _JsonReader {
+	aboolean isEncoded;
+	aboolean isExpectingName;
+	aboolean booleanValue;
+	int depth;
+	int position;
+	int stringLength;
+	int tokenLength;
+	double numberValue;
+	char *string;
+	char *token;
+	char *errorMessage;
+	char containers[JSON_READER_MAX_DEPTH];
+} JsonReader;
+
+
+// delcare json reader public functions
+
+int jsonReader_init(JsonReader *reader, char *string, int stringLength);
+
+JsonReaderEvents jsonReader_next(JsonReader *reader);
+
+int jsonReader_skip(JsonReader *reader, JsonReaderEvents event);
+
+aboolean jsonReader_isToken(JsonReader *reader, char *value, int valueLength);
+
+char *jsonReader_getString(JsonReader *reader, MemoryArena *arena,
+		int *stringLength);
+
+char *jsonReader_eventToString(JsonReaderEvents event);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _CORE_LIBRARY_TYPES_JSON_READER_H
+
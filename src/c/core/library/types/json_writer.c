@@ -0,0 +1,473 @@
+/*
+ * json_writer.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library JSON streaming writer, which appends compact JSON
+ * directly to a growable output buffer.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#define _CORE_LIBRARY_TYPES_COMPONENT
+#include "core/library/types/json_writer.h"
+
+
+// delcare json writer private functions
+
+static void ensureLength(JsonWriter *writer, int length);
+
+static void append(JsonWriter *writer, char *value, int valueLength);
+
+static int separate(JsonWriter *writer);
+
+static int writeValue(JsonWriter *writer, int type, void *value);
+
+static int writeArray(JsonWriter *writer, JsonArray *array);
+
+
+// define json writer private functions
+
+static void ensureLength(JsonWriter *writer, int length)
+{
+	if((writer->length + length + 1) <= writer->bufferLength) {
+		return;
+	}
+
+	if(writer->buffer == NULL) {
+		writer->bufferLength = JSON_WRITER_DEFAULT_BUFFER_LENGTH;
+
+		while((writer->length + length + 1) > writer->bufferLength) {
+			writer->bufferLength *= 2;
+		}
+
+		writer->buffer = (char *)malloc(sizeof(char) * writer->bufferLength);
+		return;
+	}
+
+	while((writer->length + length + 1) > writer->bufferLength) {
+		writer->bufferLength *= 2;
+	}
+
+	writer->buffer = (char *)realloc(writer->buffer,
+			(sizeof(char) * writer->bufferLength));
+}
+
+static void append(JsonWriter *writer, char *value, int valueLength)
+{
+	ensureLength(writer, valueLength);
+
+	memcpy((writer->buffer + writer->length), value, valueLength);
+
+	writer->length += valueLength;
+	writer->buffer[writer->length] = '\0';
+}
+
+static int separate(JsonWriter *writer)
+{
+	if(writer->isAfterName) {
+		writer->isAfterName = afalse;
+		return 0;
+	}
+
+	if(writer->depth > 0) {
+		if(writer->hasValues[(writer->depth - 1)]) {
+			append(writer, ",", 1);
+		}
+
+		writer->hasValues[(writer->depth - 1)] = (char)atrue;
+	}
+
+	return 0;
+}
+
+static int writeValue(JsonWriter *writer, int type, void *value)
+{
+	switch(type) {
+		case JSON_VALUE_TYPE_BOOLEAN:
+			return jsonWriter_writeBoolean(writer, *((aboolean *)value));
+
+		case JSON_VALUE_TYPE_NUMBER:
+			return jsonWriter_writeNumber(writer, *((double *)value));
+
+		case JSON_VALUE_TYPE_STRING:
+			return jsonWriter_writeString(writer, (char *)value,
+					strlen((char *)value));
+
+		case JSON_VALUE_TYPE_ARRAY:
+			return writeArray(writer, (JsonArray *)value);
+
+		case JSON_VALUE_TYPE_OBJECT:
+			return jsonWriter_writeJson(writer, (Json *)value);
+
+		case JSON_VALUE_TYPE_NULL:
+			return jsonWriter_writeNull(writer);
+	}
+
+	return -1;
+}
+
+static int writeArray(JsonWriter *writer, JsonArray *array)
+{
+	int ii = 0;
+
+	if(jsonWriter_beginArray(writer) < 0) {
+		return -1;
+	}
+
+	if(array != NULL) {
+		for(ii = 0; ii < array->length; ii++) {
+			if(writeValue(writer, array->types[ii],
+						((void **)array->values)[ii]) < 0) {
+				return -1;
+			}
+		}
+	}
+
+	return jsonWriter_endArray(writer);
+}
+
+
+// define json writer public functions
+
+int jsonWriter_init(JsonWriter *writer)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(writer, 0, (int)(sizeof(JsonWriter)));
+
+	writer->isAfterName = afalse;
+	writer->depth = 0;
+	writer->length = 0;
+	writer->bufferLength = JSON_WRITER_DEFAULT_BUFFER_LENGTH;
+	writer->buffer = (char *)malloc(sizeof(char) * writer->bufferLength);
+	writer->buffer[0] = '\0';
+
+	return 0;
+}
+
+int jsonWriter_free(JsonWriter *writer)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(writer->buffer != NULL) {
+		free(writer->buffer);
+	}
+
+	memset(writer, 0, (int)(sizeof(JsonWriter)));
+
+	return 0;
+}
+
+int jsonWriter_beginObject(JsonWriter *writer)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(writer->depth >= JSON_WRITER_MAX_DEPTH) {
+		return -1;
+	}
+
+	separate(writer);
+
+	append(writer, "{", 1);
+
+	writer->hasValues[writer->depth] = (char)afalse;
+	writer->depth += 1;
+
+	return 0;
+}
+
+int jsonWriter_endObject(JsonWriter *writer)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((writer->depth < 1) || (writer->isAfterName)) {
+		return -1;
+	}
+
+	append(writer, "}", 1);
+
+	writer->depth -= 1;
+
+	return 0;
+}
+
+int jsonWriter_beginArray(JsonWriter *writer)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(writer->depth >= JSON_WRITER_MAX_DEPTH) {
+		return -1;
+	}
+
+	separate(writer);
+
+	append(writer, "[", 1);
+
+	writer->hasValues[writer->depth] = (char)afalse;
+	writer->depth += 1;
+
+	return 0;
+}
+
+int jsonWriter_endArray(JsonWriter *writer)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(writer->depth < 1) {
+		return -1;
+	}
+
+	append(writer, "]", 1);
+
+	writer->depth -= 1;
+
+	return 0;
+}
+
+int jsonWriter_writeName(JsonWriter *writer, char *name)
+{
+	if((writer == NULL) || (name == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((writer->depth < 1) || (writer->isAfterName)) {
+		return -1;
+	}
+
+	jsonWriter_writeString(writer, name, strlen(name));
+
+	append(writer, ":", 1);
+
+	writer->isAfterName = atrue;
+
+	return 0;
+}
+
+int jsonWriter_writeString(JsonWriter *writer, char *value, int valueLength)
+{
+	int ii = 0;
+	int ref = 0;
+	char buffer[8];
+
+	if((writer == NULL) || (value == NULL) || (valueLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	separate(writer);
+
+	// reserve for the common case, where nothing needs to be escaped
+
+	ensureLength(writer, (valueLength + 2));
+
+	append(writer, "\"", 1);
+
+	for(ii = 0, ref = 0; ii < valueLength; ii++) {
+		if(((unsigned char)value[ii] >= 32) && (value[ii] != '"') &&
+				(value[ii] != '\\')) {
+			continue;
+		}
+
+		if(ii > ref) {
+			append(writer, (value + ref), (ii - ref));
+		}
+
+		ref = (ii + 1);
+
+		switch(value[ii]) {
+			case '"':
+				append(writer, "\\\"", 2);
+				break;
+
+			case '\\':
+				append(writer, "\\\\", 2);
+				break;
+
+			case '\b':
+				append(writer, "\\b", 2);
+				break;
+
+			case '\f':
+				append(writer, "\\f", 2);
+				break;
+
+			case '\n':
+				append(writer, "\\n", 2);
+				break;
+
+			case '\r':
+				append(writer, "\\r", 2);
+				break;
+
+			case '\t':
+				append(writer, "\\t", 2);
+				break;
+
+			default:
+				snprintf(buffer, sizeof(buffer), "\\u%04x",
+						(unsigned int)((unsigned char)value[ii]));
+				append(writer, buffer, 6);
+		}
+	}
+
+	if(ii > ref) {
+		append(writer, (value + ref), (ii - ref));
+	}
+
+	append(writer, "\"", 1);
+
+	return 0;
+}
+
+int jsonWriter_writeNumber(JsonWriter *writer, double value)
+{
+	int bufferLength = 0;
+	char buffer[1024];
+
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	separate(writer);
+
+	// formatted as the DOM has always written its numbers
+
+	if((double)((int)value) == value) {
+		bufferLength = snprintf(buffer, (sizeof(buffer) - 1), "%i",
+				(int)value);
+	}
+	else if((double)((alint)value) == value) {
+		bufferLength = snprintf(buffer, (sizeof(buffer) - 1), "%lli",
+				(alint)value);
+	}
+	else {
+		bufferLength = snprintf(buffer, (sizeof(buffer) - 1), "%f", value);
+	}
+
+	append(writer, buffer, bufferLength);
+
+	return 0;
+}
+
+int jsonWriter_writeBoolean(JsonWriter *writer, aboolean value)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	separate(writer);
+
+	if(value) {
+		append(writer, "true", 4);
+	}
+	else {
+		append(writer, "false", 5);
+	}
+
+	return 0;
+}
+
+int jsonWriter_writeNull(JsonWriter *writer)
+{
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	separate(writer);
+
+	append(writer, "null", 4);
+
+	return 0;
+}
+
+int jsonWriter_writeJson(JsonWriter *writer, Json *object)
+{
+	if((writer == NULL) || (object == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(jsonWriter_beginObject(writer) < 0) {
+		return -1;
+	}
+
+	if(jsonWriter_writeJsonMembers(writer, object) < 0) {
+		return -1;
+	}
+
+	return jsonWriter_endObject(writer);
+}
+
+int jsonWriter_writeJsonMembers(JsonWriter *writer, Json *object)
+{
+	int ii = 0;
+
+	if((writer == NULL) || (object == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	for(ii = 0; ii < object->elementLength; ii++) {
+		if(jsonWriter_writeName(writer, object->elements[ii].name) < 0) {
+			return -1;
+		}
+
+		if(writeValue(writer, object->elements[ii].type,
+					object->elements[ii].value) < 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+char *jsonWriter_release(JsonWriter *writer, int *stringLength)
+{
+	char *result = NULL;
+
+	if((writer == NULL) || (stringLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	result = writer->buffer;
+	*stringLength = writer->length;
+
+	// the writer may be reused, and allocates a new buffer on demand
+
+	writer->isAfterName = afalse;
+	writer->depth = 0;
+	writer->length = 0;
+	writer->bufferLength = 0;
+	writer->buffer = NULL;
+
+	return result;
+}
+
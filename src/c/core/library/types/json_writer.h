@@ -0,0 +1,88 @@
+/*
+ * json_writer.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library JSON streaming writer, which appends compact JSON
+ * directly to a growable output buffer, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_CORE_LIBRARY_TYPES_JSON_WRITER_H)
+
+#define _CORE_LIBRARY_TYPES_JSON_WRITER_H
+
+#if !defined(_CORE_H) && !defined(_CORE_LIBRARY_H) && \
+		!defined(_CORE_LIBRARY_TYPES_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _CORE_H || _CORE_LIBRARY_H || _CORE_LIBRARY_TYPES_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define json writer public constants
+
+#define JSON_WRITER_MAX_DEPTH						128
+
+#define JSON_WRITER_DEFAULT_BUFFER_LENGTH			4096
+
+
+// declare json writer public data types
+
+/*
+ * The writer inserts the separators itself, so that callers only emit names
+ * and values in order. The buffer is always NUL-terminated, and may be handed
+ * off with jsonWriter_release(), e.g. as the body of an HTTP response.
+ */
+
+typedef struct _JsonWriter {
+	aboolean isAfterName;
+	int depth;
+	int length;
+	int bufferLength;
+	char *buffer;
+	char hasValues[JSON_WRITER_MAX_DEPTH];
+} JsonWriter;
+
+
+// delcare json writer public functions
+
+int jsonWriter_init(JsonWriter *writer);
+
+int jsonWriter_free(JsonWriter *writer);
+
+int jsonWriter_beginObject(JsonWriter *writer);
+
+int jsonWriter_endObject(JsonWriter *writer);
+
+int jsonWriter_beginArray(JsonWriter *writer);
+
+int jsonWriter_endArray(JsonWriter *writer);
+
+int jsonWriter_writeName(JsonWriter *writer, char *name);
+
+int jsonWriter_writeString(JsonWriter *writer, char *value, int valueLength);
+
+int jsonWriter_writeNumber(JsonWriter *writer, double value);
+
+int jsonWriter_writeBoolean(JsonWriter *writer, aboolean value);
+
+int jsonWriter_writeNull(JsonWriter *writer);
+
+int jsonWriter_writeJson(JsonWriter *writer, Json *object);
+
+int jsonWriter_writeJsonMembers(JsonWriter *writer, Json *object);
+
+char *jsonWriter_release(JsonWriter *writer, int *stringLength);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _CORE_LIBRARY_TYPES_JSON_WRITER_H
+
@@ -5,7 +5,8 @@
  * intellectual property of Joshua S. English, all rights reserved.
  *
  * The Asgard core library background thread managed indexing system, using a
- * B+Tree index, type library.
+ * set of lock-striped hash shards with CLOCK eviction, and an optional B+Tree
+ * index for ordered access, type library.
  *
  * Written by Josh English.
  */
@@ -21,13 +22,7 @@
 
 #define MANAGED_INDEX_VERBOSE_MODE						afalse
 
-
-// define managed index private data types
-
-typedef struct _EntryKey {
-	int keyLength;
-	char *key;
-} EntryKey;
+#define MANAGED_INDEX_EVICTION_BATCH_LENGTH				1024
 
 
 // declare managed index private functions
@@ -36,9 +31,41 @@ static void managedIndexDefaultFree(void *argument, void *memory);
 
 static void managedIndexFree(void *argument, void *memory);
 
+static void managedIndexOrderedFree(void *memory);
+
 static void *managedIndexWorkerThread(void *threadContext, void *argument);
 
-static void freeEntryKey(void *memory);
+static int lockShard(ManagedIndex *index, ManagedIndexShard *shard,
+		aboolean isWrite);
+
+static int unlockShard(ManagedIndex *index, ManagedIndexShard *shard,
+		aboolean isWrite);
+
+static int lockOrdered(ManagedIndex *index, aboolean isWrite);
+
+static int unlockOrdered(ManagedIndex *index, aboolean isWrite);
+
+static ManagedIndexShard *getShard(ManagedIndex *index, unsigned int hash);
+
+static ManagedIndexEntry *findEntry(ManagedIndex *index,
+		ManagedIndexShard *shard, unsigned int hash, char *key,
+		int keyLength);
+
+static void rehashShard(ManagedIndex *index, ManagedIndexShard *shard);
+
+static void attachEntry(ManagedIndex *index, ManagedIndexShard *shard,
+		ManagedIndexEntry *entry);
+
+static void detachEntry(ManagedIndex *index, ManagedIndexShard *shard,
+		ManagedIndexEntry *entry);
+
+static ManagedIndexEntry *evictEntry(ManagedIndex *index,
+		ManagedIndexShard *shard);
+
+static int putEntry(ManagedIndex *index, ManagedIndexEntry *entry);
+
+static ManagedIndexEntry *getOrderedEntry(ManagedIndex *index, char *key,
+		int keyLength, aboolean isNext);
 
 
 // define managed index private functions
@@ -98,43 +125,20 @@ static void managedIndexFree(void *argument, void *memory)
 	mutex_unlock(&index->mutex);
 }
 
-static void freeEntryKey(void *memory)
+static void managedIndexOrderedFree(void *memory)
 {
-	EntryKey *key = NULL;
-
-	if(memory == NULL) {
-		DISPLAY_INVALID_ARGS;
-		return;
-	}
-
-	key = (EntryKey *)memory;
-
-	if(key->key != NULL) {
-		free(key->key);
-	}
-
-	free(key);
+	// the ordered index only references the entries owned by the shards
 }
 
 static void *managedIndexWorkerThread(void *threadContext, void *argument)
 {
-	aboolean isEmpty = afalse;
-	aboolean isDeleted = afalse;
+	int ii = 0;
+	int ref = 0;
 	int counter = 0;
-	int keyLength = 0;
-	alint stackItemCount = 0;
-	alint cachedItemCount = 0;
-	alint cachedItemTicks = 0;
-	alint cachedMemoryLength = 0;
-	double cachedTimeout = 0.0;
-	double elapsedTime = 0.0;
-	char *key = NULL;
-
-	FifoStack stack;
-
-	EntryKey *entryKey = NULL;
+
 	TmfThread *thread = NULL;
 	ManagedIndex *index = NULL;
+	ManagedIndexShard *shard = NULL;
 	ManagedIndexEntry *entry = NULL;
 
 	if(MANAGED_INDEX_VERBOSE_MODE) {
@@ -156,210 +160,35 @@ static void *managedIndexWorkerThread(void *threadContext, void *argument)
 		thread->status = THREAD_STATUS_BUSY;
 		mutex_unlock(thread->mutex);
 
-		if((index->cachedMemoryLength >= index->maxCachedMemoryLength) ||
-				(index->cachedItemCount >= index->maxCachedItemCount)) {
-			counter = 0;
-			stackItemCount = 0;
-			cachedItemCount = 0;
-			cachedItemTicks = 0;
-			cachedMemoryLength = 0;
-			cachedTimeout = 0.0;
-
-			fifostack_init(&stack);
-			fifostack_setFreeFunction(&stack, freeEntryKey);
-
-			keyLength = 1;
-			key = (char *)malloc(sizeof(char) * (keyLength + 1));
-
-			memset(key, 0, (int)(sizeof(char) * (keyLength + 1)));
-
-			if(index->isSpinlockMode) {
-				spinlock_readLock(&index->spinlock);
-			}
-			else {
-				mutex_lock(&index->dataMutex);
-			}
-
-			while((thread->state == THREAD_STATE_RUNNING) &&
-					(thread->signal == THREAD_SIGNAL_OK) &&
-					(stackItemCount < 1024) &&
-					(bptree_getNext(&index->index, key, keyLength,
-									((void *)&entry)) == 0)) {
-				free(key);
-
-				keyLength = entry->keyLength;
-				key = strndup(entry->key, entry->keyLength);
-
-				isDeleted = afalse;
-
-				if(index->timeoutSeconds > 0.0) {
-					elapsedTime = time_getElapsedMusInSeconds(entry->timestamp);
-					if(elapsedTime >= index->timeoutSeconds) {
-						entryKey = (EntryKey *)malloc(sizeof(EntryKey));
-						entryKey->keyLength = entry->keyLength;
-						entryKey->key = strndup(entry->key, entry->keyLength);
-
-						if(fifostack_push(&stack, entryKey) == 0) {
-							stackItemCount++;
-							isDeleted = atrue;
-						}
-					}
-				}
-
-				if(!isDeleted) {
-					cachedItemTicks += entry->ticks;
-					cachedMemoryLength += (alint)entry->memorySize;
-					cachedTimeout += elapsedTime;
-					cachedItemCount++;
-				}
-
-				counter++;
-
-				if((counter % 8) == 0) {
-					if(index->isSpinlockMode) {
-						spinlock_readUnlock(&index->spinlock);
-					}
-					else {
-						mutex_unlock(&index->dataMutex);
-					}
-
-					time_usleep(1024);
-
-					if(index->isSpinlockMode) {
-						spinlock_readLock(&index->spinlock);
-					}
-					else {
-						mutex_lock(&index->dataMutex);
-					}
-				}
-			}
-
-			free(key);
+		// evict from the fullest shard, until within the cache limits
 
-			if(index->isSpinlockMode) {
-				spinlock_readUnlock(&index->spinlock);
-			}
-			else {
-				mutex_unlock(&index->dataMutex);
-			}
+		counter = 0;
 
-			fifostack_isEmpty(&stack, &isEmpty);
+		while((thread->state == THREAD_STATE_RUNNING) &&
+				(thread->signal == THREAD_SIGNAL_OK) &&
+				(counter < MANAGED_INDEX_EVICTION_BATCH_LENGTH) &&
+				((index->cachedMemoryLength >= index->maxCachedMemoryLength) ||
+				 (index->cachedItemCount >= index->maxCachedItemCount))) {
+			shard = NULL;
 
-			if(!isEmpty) {
-				while((thread->state == THREAD_STATE_RUNNING) &&
-						(thread->signal == THREAD_SIGNAL_OK) &&
-						(fifostack_pop(&stack, ((void *)&entryKey)) == 0) &&
-						(entryKey != NULL)) {
-					managedIndex_remove(index, entryKey->key,
-							entryKey->keyLength);
+			for(ii = 0; ii < index->shardLength; ii++) {
+				ref = ((index->clockRef + ii) % index->shardLength);
 
-					free(entryKey->key);
-					free(entryKey);
+				if((shard == NULL) ||
+						(index->shards[ref].entryCount > shard->entryCount)) {
+					shard = &(index->shards[ref]);
 				}
 			}
 
-			if((thread->state == THREAD_STATE_RUNNING) &&
-					(thread->signal == THREAD_SIGNAL_OK) &&
-					(cachedItemCount > 0) &&
-					(stackItemCount < 1024) &&
-					((index->cachedMemoryLength >=
-					  index->maxCachedMemoryLength) ||
-					 (index->cachedItemCount >=
-					  index->maxCachedItemCount))) {
-				cachedItemTicks /= cachedItemCount;
-				cachedMemoryLength /= cachedItemCount;
-				cachedTimeout /= (double)cachedItemCount;
-
-				stackItemCount = 0;
-				cachedItemCount = 0;
-
-				keyLength = 1;
-				key = (char *)malloc(sizeof(char) * (keyLength + 1));
+			index->clockRef = ((index->clockRef + 1) % index->shardLength);
 
-				memset(key, 0, (int)(sizeof(char) * (keyLength + 1)));
-
-				if(index->isSpinlockMode) {
-					spinlock_readLock(&index->spinlock);
-				}
-				else {
-					mutex_lock(&index->dataMutex);
-				}
-
-				while((thread->state == THREAD_STATE_RUNNING) &&
-						(thread->signal == THREAD_SIGNAL_OK) &&
-						(stackItemCount < 1024) &&
-						(bptree_getNext(&index->index, key, keyLength,
-										((void *)&entry)) == 0)) {
-					free(key);
-
-					keyLength = entry->keyLength;
-					key = strndup(entry->key, entry->keyLength);
-
-					if(index->timeoutSeconds > 0.0) {
-						elapsedTime = time_getElapsedMusInSeconds(
-								entry->timestamp);
-						if((elapsedTime >= index->timeoutSeconds) ||
-								((entry->memorySize >= cachedMemoryLength) &&
-								 (entry->ticks <= cachedItemTicks)) ||
-								((elapsedTime >= cachedTimeout) &&
-								 (entry->ticks <= cachedItemTicks))) {
-							entryKey = (EntryKey *)malloc(sizeof(EntryKey));
-							entryKey->keyLength = entry->keyLength;
-							entryKey->key = strndup(entry->key,
-									entry->keyLength);
-
-							stackItemCount++;
-							fifostack_push(&stack, entryKey);
-						}
-					}
-
-					cachedItemCount++;
-
-					if((cachedItemCount % 8) == 0) {
-						if(index->isSpinlockMode) {
-							spinlock_readUnlock(&index->spinlock);
-						}
-						else {
-							mutex_unlock(&index->dataMutex);
-						}
-
-						time_usleep(1024);
-
-						if(index->isSpinlockMode) {
-							spinlock_readLock(&index->spinlock);
-						}
-						else {
-							mutex_lock(&index->dataMutex);
-						}
-					}
-				}
-
-				free(key);
-
-				if(index->isSpinlockMode) {
-					spinlock_readUnlock(&index->spinlock);
-				}
-				else {
-					mutex_unlock(&index->dataMutex);
-				}
+			if((entry = evictEntry(index, shard)) == NULL) {
+				break;
 			}
 
-			while((thread->state == THREAD_STATE_RUNNING) &&
-					(thread->signal == THREAD_SIGNAL_OK) &&
-					(fifostack_pop(&stack, ((void *)&entryKey)) == 0) &&
-					(entryKey != NULL) &&
-					((index->cachedMemoryLength >=
-					  index->maxCachedMemoryLength) ||
-					 (index->cachedItemCount >=
-					  index->maxCachedItemCount))) {
-				managedIndex_remove(index, entryKey->key,
-						entryKey->keyLength);
-
-				free(entryKey->key);
-				free(entryKey);
-			}
+			managedIndexFree(index, entry);
 
-			fifostack_free(&stack);
+			counter++;
 		}
 
 		mutex_lock(thread->mutex);
@@ -388,13 +217,334 @@ static void *managedIndexWorkerThread(void *threadContext, void *argument)
 	return NULL;
 }
 
+static int lockShard(ManagedIndex *index, ManagedIndexShard *shard,
+		aboolean isWrite)
+{
+	if(!index->isSpinlockMode) {
+		mutex_lock(&shard->mutex);
+		return 0;
+	}
+
+	if(isWrite) {
+		return spinlock_writeLock(&shard->spinlock);
+	}
+
+	return spinlock_readLock(&shard->spinlock);
+}
+
+static int unlockShard(ManagedIndex *index, ManagedIndexShard *shard,
+		aboolean isWrite)
+{
+	if(!index->isSpinlockMode) {
+		mutex_unlock(&shard->mutex);
+		return 0;
+	}
+
+	if(isWrite) {
+		return spinlock_writeUnlock(&shard->spinlock);
+	}
+
+	return spinlock_readUnlock(&shard->spinlock);
+}
+
+static int lockOrdered(ManagedIndex *index, aboolean isWrite)
+{
+	if(!index->isSpinlockMode) {
+		mutex_lock(&index->dataMutex);
+		return 0;
+	}
+
+	if(isWrite) {
+		return spinlock_writeLock(&index->spinlock);
+	}
+
+	return spinlock_readLock(&index->spinlock);
+}
+
+static int unlockOrdered(ManagedIndex *index, aboolean isWrite)
+{
+	if(!index->isSpinlockMode) {
+		mutex_unlock(&index->dataMutex);
+		return 0;
+	}
+
+	if(isWrite) {
+		return spinlock_writeUnlock(&index->spinlock);
+	}
+
+	return spinlock_readUnlock(&index->spinlock);
+}
+
+static ManagedIndexShard *getShard(ManagedIndex *index, unsigned int hash)
+{
+	return &(index->shards[(hash % (unsigned int)index->shardLength)]);
+}
+
+static ManagedIndexEntry *findEntry(ManagedIndex *index,
+		ManagedIndexShard *shard, unsigned int hash, char *key,
+		int keyLength)
+{
+	ManagedIndexEntry *entry = NULL;
+
+	entry = shard->buckets[((hash / (unsigned int)index->shardLength) &
+			(unsigned int)(shard->bucketLength - 1))];
+
+	while(entry != NULL) {
+		if((entry->hash == hash) && (entry->keyLength == keyLength) &&
+				(!memcmp(entry->key, key, keyLength))) {
+			return entry;
+		}
+
+		entry = entry->chain;
+	}
+
+	return NULL;
+}
+
+static void rehashShard(ManagedIndex *index, ManagedIndexShard *shard)
+{
+	int ii = 0;
+	int bucketLength = 0;
+	unsigned int bucket = 0;
+
+	ManagedIndexEntry *entry = NULL;
+	ManagedIndexEntry *next = NULL;
+	ManagedIndexEntry **buckets = NULL;
+
+	bucketLength = (shard->bucketLength * 2);
+
+	buckets = (ManagedIndexEntry **)malloc(sizeof(ManagedIndexEntry *) *
+			bucketLength);
+
+	memset(buckets, 0, (int)(sizeof(ManagedIndexEntry *) * bucketLength));
+
+	for(ii = 0; ii < shard->bucketLength; ii++) {
+		entry = shard->buckets[ii];
+
+		while(entry != NULL) {
+			next = entry->chain;
+
+			bucket = ((entry->hash / (unsigned int)index->shardLength) &
+					(unsigned int)(bucketLength - 1));
+
+			entry->chain = buckets[bucket];
+			buckets[bucket] = entry;
+
+			entry = next;
+		}
+	}
+
+	free(shard->buckets);
+
+	shard->bucketLength = bucketLength;
+	shard->buckets = buckets;
+}
+
+static void attachEntry(ManagedIndex *index, ManagedIndexShard *shard,
+		ManagedIndexEntry *entry)
+{
+	unsigned int bucket = 0;
+
+	if(shard->entryCount >= shard->bucketLength) {
+		rehashShard(index, shard);
+	}
+
+	bucket = ((entry->hash / (unsigned int)index->shardLength) &
+			(unsigned int)(shard->bucketLength - 1));
+
+	entry->chain = shard->buckets[bucket];
+	shard->buckets[bucket] = entry;
+
+	// new entries join the ring just behind the hand, to be visited last
+
+	if(shard->clockHand == NULL) {
+		entry->clockNext = entry;
+		entry->clockPrevious = entry;
+		shard->clockHand = entry;
+	}
+	else {
+		entry->clockNext = shard->clockHand;
+		entry->clockPrevious = shard->clockHand->clockPrevious;
+		shard->clockHand->clockPrevious->clockNext = entry;
+		shard->clockHand->clockPrevious = entry;
+	}
+
+	shard->entryCount += 1;
+}
+
+static void detachEntry(ManagedIndex *index, ManagedIndexShard *shard,
+		ManagedIndexEntry *entry)
+{
+	unsigned int bucket = 0;
+
+	ManagedIndexEntry *node = NULL;
+
+	bucket = ((entry->hash / (unsigned int)index->shardLength) &
+			(unsigned int)(shard->bucketLength - 1));
+
+	if(shard->buckets[bucket] == entry) {
+		shard->buckets[bucket] = entry->chain;
+	}
+	else {
+		node = shard->buckets[bucket];
+
+		while((node != NULL) && (node->chain != entry)) {
+			node = node->chain;
+		}
+
+		if(node != NULL) {
+			node->chain = entry->chain;
+		}
+	}
+
+	if(entry->clockNext == entry) {
+		shard->clockHand = NULL;
+	}
+	else {
+		entry->clockPrevious->clockNext = entry->clockNext;
+		entry->clockNext->clockPrevious = entry->clockPrevious;
+
+		if(shard->clockHand == entry) {
+			shard->clockHand = entry->clockNext;
+		}
+	}
+
+	entry->chain = NULL;
+	entry->clockNext = NULL;
+	entry->clockPrevious = NULL;
+
+	shard->entryCount -= 1;
+
+	if(index->isOrderedMode) {
+		lockOrdered(index, atrue);
+		bptree_remove(&index->index, entry->key, entry->keyLength);
+		unlockOrdered(index, atrue);
+	}
+}
+
+static ManagedIndexEntry *evictEntry(ManagedIndex *index,
+		ManagedIndexShard *shard)
+{
+	int counter = 0;
+
+	ManagedIndexEntry *entry = NULL;
+	ManagedIndexEntry *result = NULL;
+
+	if(lockShard(index, shard, atrue) < 0) {
+		return NULL;
+	}
+
+	/*
+	 * note: a full turn of the hand clears every reference bit, so a victim
+	 * is always located within two turns
+	 */
+
+	while((shard->clockHand != NULL) &&
+			(counter <= (shard->entryCount * 2))) {
+		entry = shard->clockHand;
+		shard->clockHand = entry->clockNext;
+
+		if((!entry->isReferenced) ||
+				((index->timeoutSeconds > 0.0) &&
+				 (time_getElapsedMusInSeconds(entry->timestamp) >=
+				  index->timeoutSeconds))) {
+			detachEntry(index, shard, entry);
+			result = entry;
+			break;
+		}
+
+		entry->isReferenced = afalse;
+
+		counter++;
+	}
+
+	unlockShard(index, shard, atrue);
+
+	return result;
+}
+
+static int putEntry(ManagedIndex *index, ManagedIndexEntry *entry)
+{
+	int result = 0;
+
+	ManagedIndexShard *shard = NULL;
+
+	shard = getShard(index, entry->hash);
+
+	if(lockShard(index, shard, atrue) < 0) {
+		return -1;
+	}
+
+	// determine if key already exists
+
+	if(findEntry(index, shard, entry->hash, entry->key,
+				entry->keyLength) != NULL) {
+		result = -1;
+	}
+	else {
+		if(index->isOrderedMode) {
+			lockOrdered(index, atrue);
+			if(bptree_put(&index->index, entry->key, entry->keyLength,
+						(void *)entry) < 0) {
+				result = -1;
+			}
+			unlockOrdered(index, atrue);
+		}
+
+		if(result == 0) {
+			attachEntry(index, shard, entry);
+		}
+	}
+
+	if(result == 0) {
+		mutex_lock(&index->mutex);
+		index->cachedItemCount += (alint)1;
+		index->cachedMemoryLength += (alint)entry->memorySize;
+		mutex_unlock(&index->mutex);
+	}
+
+	unlockShard(index, shard, atrue);
+
+	return result;
+}
+
+static ManagedIndexEntry *getOrderedEntry(ManagedIndex *index, char *key,
+		int keyLength, aboolean isNext)
+{
+	int rc = 0;
+
+	ManagedIndexEntry *entry = NULL;
+
+	if(isNext) {
+		rc = bptree_getNext(&index->index, key, keyLength, ((void *)&entry));
+	}
+	else {
+		rc = bptree_getPrevious(&index->index, key, keyLength,
+				((void *)&entry));
+	}
+
+	if((rc < 0) || (entry == NULL)) {
+		return NULL;
+	}
+
+	entry->isReferenced = atrue;
+	entry->ticks += 1;
+	entry->timestamp = time_getTimeMus();
+
+	return entry;
+}
+
 
 // define managed index public functions
 
-int managedIndex_init(ManagedIndex *index, aboolean isSpinlockMode)
+int managedIndex_init(ManagedIndex *index, aboolean isSpinlockMode,
+		aboolean isOrderedMode)
 {
+	int ii = 0;
 	int threadId = 0;
 
+	ManagedIndexShard *shard = NULL;
+
 	if(index == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
@@ -403,6 +553,9 @@ int managedIndex_init(ManagedIndex *index, aboolean isSpinlockMode)
 	memset(index, 0, (int)(sizeof(ManagedIndex)));
 
 	index->isSpinlockMode = isSpinlockMode;
+	index->isOrderedMode = isOrderedMode;
+	index->shardLength = MANAGED_INDEX_DEFAULT_SHARD_LENGTH;
+	index->clockRef = 0;
 	index->cachedItemCount = 0;
 	index->maxCachedItemCount = MANAGED_INDEX_DEFAULT_MAX_CACHED_ITEM_COUNT;
 	index->cachedMemoryLength = 0;
@@ -412,9 +565,27 @@ int managedIndex_init(ManagedIndex *index, aboolean isSpinlockMode)
 	index->freeArgument = NULL;
 	index->freeFunction = (ManagedIndexFreeFunction)managedIndexDefaultFree;
 
+	index->shards = (ManagedIndexShard *)malloc(sizeof(ManagedIndexShard) *
+			index->shardLength);
+
+	for(ii = 0; ii < index->shardLength; ii++) {
+		shard = &(index->shards[ii]);
+
+		shard->entryCount = 0;
+		shard->bucketLength = MANAGED_INDEX_DEFAULT_BUCKET_LENGTH;
+		shard->buckets = (ManagedIndexEntry **)malloc(
+				sizeof(ManagedIndexEntry *) * shard->bucketLength);
+		shard->clockHand = NULL;
+
+		memset(shard->buckets, 0,
+				(int)(sizeof(ManagedIndexEntry *) * shard->bucketLength));
+
+		spinlock_init(&shard->spinlock);
+		mutex_init(&shard->mutex);
+	}
+
 	bptree_init(&index->index);
-	bptree_setComplexFreeFunction(&index->index, index,
-			(BptreeComplexFreeFunction)managedIndexFree);
+	bptree_setFreeFunction(&index->index, managedIndexOrderedFree);
 
 	tmf_init(&index->tmf);
 
@@ -438,52 +609,43 @@ int managedIndex_init(ManagedIndex *index, aboolean isSpinlockMode)
 
 int managedIndex_free(ManagedIndex *index)
 {
+	int ii = 0;
 	int result = 0;
 
+	ManagedIndexShard *shard = NULL;
+
 	if(index == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
-	mutex_lock(&index->mutex);
+	// stop the worker thread, which takes the mutex to account for evictions
 
 	if(tmf_free(&index->tmf) < 0) {
 		result = -1;
 	}
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeLock(&index->spinlock) < 0) {
-			mutex_unlock(&index->mutex);
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	if(managedIndex_clear(index) < 0) {
+		result = -1;
 	}
 
-	mutex_unlock(&index->mutex);
+	for(ii = 0; ii < index->shardLength; ii++) {
+		shard = &(index->shards[ii]);
 
-	if(bptree_free(&index->index) < 0) {
-		result = -1;
+		free(shard->buckets);
+
+		spinlock_free(&shard->spinlock);
+		mutex_free(&shard->mutex);
 	}
 
-	mutex_lock(&index->mutex);
+	free(index->shards);
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeUnlock(&index->spinlock) < 0) {
-			mutex_unlock(&index->mutex);
-			return -1;
-		}
-	}
-	else {
-		mutex_unlock(&index->dataMutex);
+	if(bptree_free(&index->index) < 0) {
+		result = -1;
 	}
 
 	spinlock_free(&index->spinlock);
 	mutex_free(&index->dataMutex);
-
-	mutex_unlock(&index->mutex);
-
 	mutex_free(&index->mutex);
 
 	memset(index, 0, (int)(sizeof(ManagedIndex)));
@@ -580,31 +742,27 @@ int managedIndex_getCacheStatus(ManagedIndex *index, alint *cachedItemCount,
 
 int managedIndex_getLeafCount(ManagedIndex *index, int *leafCount)
 {
-	int result = 0;
+	int ii = 0;
+
+	ManagedIndexShard *shard = NULL;
 
 	if((index == NULL) || (leafCount == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
-	}
+	*leafCount = 0;
 
-	result = bptree_getLeafCount(&index->index, leafCount);
+	for(ii = 0; ii < index->shardLength; ii++) {
+		shard = &(index->shards[ii]);
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
+		if(lockShard(index, shard, afalse) < 0) {
 			return -1;
 		}
-	}
-	else {
-		mutex_unlock(&index->dataMutex);
+
+		*leafCount += shard->entryCount;
+
+		unlockShard(index, shard, afalse);
 	}
 
 	return 0;
@@ -612,49 +770,53 @@ int managedIndex_getLeafCount(ManagedIndex *index, int *leafCount)
 
 int managedIndex_clear(ManagedIndex *index)
 {
-	int result = 0;
+	int ii = 0;
+
+	ManagedIndexShard *shard = NULL;
+	ManagedIndexEntry *entry = NULL;
+	ManagedIndexEntry *list = NULL;
 
 	if(index == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
-	mutex_lock(&index->mutex);
+	for(ii = 0; ii < index->shardLength; ii++) {
+		shard = &(index->shards[ii]);
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeLock(&index->spinlock) < 0) {
-			mutex_unlock(&index->mutex);
+		if(lockShard(index, shard, atrue) < 0) {
 			return -1;
 		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
-	}
 
-	if(bptree_clear(&index->index) < 0) {
-		result = -1;
-	}
+		// detach every entry of the shard, to be freed outside of the lock
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeUnlock(&index->spinlock) < 0) {
-			mutex_unlock(&index->mutex);
-			return -1;
+		list = NULL;
+
+		while((entry = shard->clockHand) != NULL) {
+			detachEntry(index, shard, entry);
+
+			entry->chain = list;
+			list = entry;
 		}
-	}
-	else {
-		mutex_unlock(&index->dataMutex);
-	}
 
-	mutex_unlock(&index->mutex);
+		unlockShard(index, shard, atrue);
 
-	return result;
+		while((entry = list) != NULL) {
+			list = entry->chain;
+			managedIndexFree(index, entry);
+		}
+	}
+
+	return 0;
 }
 
 int managedIndex_get(ManagedIndex *index, char *key, int keyLength,
 		void **value)
 {
 	int result = 0;
+	unsigned int hash = 0;
 
+	ManagedIndexShard *shard = NULL;
 	ManagedIndexEntry *entry = NULL;
 	ManagedIndexSimpleEntry *simpleEntry = NULL;
 
@@ -666,17 +828,15 @@ int managedIndex_get(ManagedIndex *index, char *key, int keyLength,
 
 	*value = NULL;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	hash = crc32_calculateHash(key, keyLength);
+	shard = getShard(index, hash);
+
+	if(lockShard(index, shard, afalse) < 0) {
+		return -1;
 	}
 
-	if((result = bptree_get(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
+	if((entry = findEntry(index, shard, hash, key, keyLength)) != NULL) {
+		entry->isReferenced = atrue;
 		entry->ticks += 1;
 		entry->timestamp = time_getTimeMus();
 		if(entry->isSimpleEntry) {
@@ -687,14 +847,12 @@ int managedIndex_get(ManagedIndex *index, char *key, int keyLength,
 			*value = entry->value;
 		}
 	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
 	else {
-		mutex_unlock(&index->dataMutex);
+		result = -1;
+	}
+
+	if(unlockShard(index, shard, afalse) < 0) {
+		return -1;
 	}
 
 	return result;
@@ -704,7 +862,9 @@ int managedIndex_getSimple(ManagedIndex *index, char *key, int keyLength,
 		char **value, int *valueLength)
 {
 	int result = 0;
+	unsigned int hash = 0;
 
+	ManagedIndexShard *shard = NULL;
 	ManagedIndexEntry *entry = NULL;
 	ManagedIndexSimpleEntry *simpleEntry = NULL;
 
@@ -717,17 +877,15 @@ int managedIndex_getSimple(ManagedIndex *index, char *key, int keyLength,
 	*value = NULL;
 	*valueLength = 0;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	hash = crc32_calculateHash(key, keyLength);
+	shard = getShard(index, hash);
+
+	if(lockShard(index, shard, afalse) < 0) {
+		return -1;
 	}
 
-	if((result = bptree_get(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
+	if((entry = findEntry(index, shard, hash, key, keyLength)) != NULL) {
+		entry->isReferenced = atrue;
 		entry->ticks += 1;
 		entry->timestamp = time_getTimeMus();
 		if(entry->isSimpleEntry) {
@@ -739,14 +897,12 @@ int managedIndex_getSimple(ManagedIndex *index, char *key, int keyLength,
 			result = -1;
 		}
 	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
 	else {
-		mutex_unlock(&index->dataMutex);
+		result = -1;
+	}
+
+	if(unlockShard(index, shard, afalse) < 0) {
+		return -1;
 	}
 
 	return result;
@@ -760,27 +916,19 @@ int managedIndex_getNext(ManagedIndex *index, char *key, int keyLength,
 	ManagedIndexEntry *entry = NULL;
 	ManagedIndexSimpleEntry *simpleEntry = NULL;
 
-	if((index == NULL) || (key == NULL) || (keyLength < 1) ||
-			(value == NULL)) {
+	if((index == NULL) || (!index->isOrderedMode) || (key == NULL) ||
+			(keyLength < 1) || (value == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
 	*value = NULL;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	if(lockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
-	if((result = bptree_getNext(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
-		entry->ticks += 1;
-		entry->timestamp = time_getTimeMus();
+	if((entry = getOrderedEntry(index, key, keyLength, atrue)) != NULL) {
 		if(entry->isSimpleEntry) {
 			simpleEntry = (ManagedIndexSimpleEntry *)entry->value;
 			*value = simpleEntry->value;
@@ -789,14 +937,12 @@ int managedIndex_getNext(ManagedIndex *index, char *key, int keyLength,
 			*value = entry->value;
 		}
 	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
 	else {
-		mutex_unlock(&index->dataMutex);
+		result = -1;
+	}
+
+	if(unlockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
 	return result;
@@ -810,8 +956,8 @@ int managedIndex_getNextSimple(ManagedIndex *index, char *key, int keyLength,
 	ManagedIndexEntry *entry = NULL;
 	ManagedIndexSimpleEntry *simpleEntry = NULL;
 
-	if((index == NULL) || (key == NULL) || (keyLength < 1) ||
-			(value == NULL) || (valueLength == NULL)) {
+	if((index == NULL) || (!index->isOrderedMode) || (key == NULL) ||
+			(keyLength < 1) || (value == NULL) || (valueLength == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
@@ -819,19 +965,11 @@ int managedIndex_getNextSimple(ManagedIndex *index, char *key, int keyLength,
 	*value = NULL;
 	*valueLength = 0;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	if(lockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
-	if((result = bptree_getNext(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
-		entry->ticks += 1;
-		entry->timestamp = time_getTimeMus();
+	if((entry = getOrderedEntry(index, key, keyLength, atrue)) != NULL) {
 		if(entry->isSimpleEntry) {
 			simpleEntry = (ManagedIndexSimpleEntry *)entry->value;
 			*value = simpleEntry->value;
@@ -841,14 +979,12 @@ int managedIndex_getNextSimple(ManagedIndex *index, char *key, int keyLength,
 			result = -1;
 		}
 	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
 	else {
-		mutex_unlock(&index->dataMutex);
+		result = -1;
+	}
+
+	if(unlockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
 	return result;
@@ -862,27 +998,19 @@ int managedIndex_getPrevious(ManagedIndex *index, char *key, int keyLength,
 	ManagedIndexEntry *entry = NULL;
 	ManagedIndexSimpleEntry *simpleEntry = NULL;
 
-	if((index == NULL) || (key == NULL) || (keyLength < 1) ||
-			(value == NULL)) {
+	if((index == NULL) || (!index->isOrderedMode) || (key == NULL) ||
+			(keyLength < 1) || (value == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
 	*value = NULL;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	if(lockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
-	if((result = bptree_getPrevious(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
-		entry->ticks += 1;
-		entry->timestamp = time_getTimeMus();
+	if((entry = getOrderedEntry(index, key, keyLength, afalse)) != NULL) {
 		if(entry->isSimpleEntry) {
 			simpleEntry = (ManagedIndexSimpleEntry *)entry->value;
 			*value = simpleEntry->value;
@@ -891,14 +1019,12 @@ int managedIndex_getPrevious(ManagedIndex *index, char *key, int keyLength,
 			*value = entry->value;
 		}
 	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
 	else {
-		mutex_unlock(&index->dataMutex);
+		result = -1;
+	}
+
+	if(unlockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
 	return result;
@@ -912,8 +1038,8 @@ int managedIndex_getPreviousSimple(ManagedIndex *index, char *key,
 	ManagedIndexEntry *entry = NULL;
 	ManagedIndexSimpleEntry *simpleEntry = NULL;
 
-	if((index == NULL) || (key == NULL) || (keyLength < 1) ||
-			(value == NULL) || (valueLength == NULL)) {
+	if((index == NULL) || (!index->isOrderedMode) || (key == NULL) ||
+			(keyLength < 1) || (value == NULL) || (valueLength == NULL)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
@@ -921,19 +1047,11 @@ int managedIndex_getPreviousSimple(ManagedIndex *index, char *key,
 	*value = NULL;
 	*valueLength = 0;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	if(lockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
-	if((result = bptree_getPrevious(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
-		entry->ticks += 1;
-		entry->timestamp = time_getTimeMus();
+	if((entry = getOrderedEntry(index, key, keyLength, afalse)) != NULL) {
 		if(entry->isSimpleEntry) {
 			simpleEntry = (ManagedIndexSimpleEntry *)entry->value;
 			*value = simpleEntry->value;
@@ -943,14 +1061,12 @@ int managedIndex_getPreviousSimple(ManagedIndex *index, char *key,
 			result = -1;
 		}
 	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
 	else {
-		mutex_unlock(&index->dataMutex);
+		result = -1;
+	}
+
+	if(unlockOrdered(index, afalse) < 0) {
+		return -1;
 	}
 
 	return result;
@@ -959,8 +1075,6 @@ int managedIndex_getPreviousSimple(ManagedIndex *index, char *key,
 int managedIndex_put(ManagedIndex *index, char *key, int keyLength,
 		void *value, int memorySizeOfValue)
 {
-	int result = 0;
-
 	ManagedIndexEntry *entry = NULL;
 
 	if((index == NULL) || (key == NULL) || (keyLength < 1) ||
@@ -969,90 +1083,33 @@ int managedIndex_put(ManagedIndex *index, char *key, int keyLength,
 		return -1;
 	}
 
-	// determine if key already exists
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
-	}
-
-	if((result = bptree_get(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
-		result = -1;
-	}
-	else {
-		result = 0;
-	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_unlock(&index->dataMutex);
-	}
-
-	if(result < 0) {
-		return result;
-	}
-
-	// add entry to index
-
 	entry = (ManagedIndexEntry *)malloc(sizeof(ManagedIndexEntry));
 
 	entry->isSimpleEntry = afalse;
+	entry->isReferenced = atrue;
 	entry->keyLength = keyLength;
 	entry->memorySize = (keyLength + memorySizeOfValue);
+	entry->hash = crc32_calculateHash(key, keyLength);
 	entry->ticks = 0;
 	entry->timestamp = time_getTimeMus();
 	entry->key = strndup(key, keyLength);
 	entry->value = value;
+	entry->chain = NULL;
+	entry->clockNext = NULL;
+	entry->clockPrevious = NULL;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeLock(&index->spinlock) < 0) {
-			managedIndexFree(index, entry);
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
-	}
-
-	result = bptree_put(&index->index, key, keyLength, (void *)entry);
-
-	if(index->isSpinlockMode) {
-		if(spinlock_writeUnlock(&index->spinlock) < 0) {
-			managedIndexFree(index, entry);
-			return -1;
-		}
-	}
-	else {
-		mutex_unlock(&index->dataMutex);
-	}
-
-	if(result < 0) {
-		managedIndexFree(index, entry);
-	}
-	else {
-		mutex_lock(&index->mutex);
-		index->cachedItemCount += (alint)1;
-		index->cachedMemoryLength += (alint)entry->memorySize;
-		mutex_unlock(&index->mutex);
+	if(putEntry(index, entry) < 0) {
+		free(entry->key);
+		free(entry);
+		return -1;
 	}
 
-	return result;
+	return 0;
 }
 
 int managedIndex_putSimple(ManagedIndex *index, char *key, int keyLength,
 		char *value, int valueLength)
 {
-	int result = 0;
-
 	ManagedIndexEntry *entry = NULL;
 	ManagedIndexSimpleEntry *simpleEntry = NULL;
 
@@ -1062,40 +1119,6 @@ int managedIndex_putSimple(ManagedIndex *index, char *key, int keyLength,
 		return -1;
 	}
 
-	// determine if key already exists
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
-	}
-
-	if((result = bptree_get(&index->index, key, keyLength,
-					((void *)&entry))) == 0) {
-		result = -1;
-	}
-	else {
-		result = 0;
-	}
-
-	if(index->isSpinlockMode) {
-		if(spinlock_readUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_unlock(&index->dataMutex);
-	}
-
-	if(result < 0) {
-		return result;
-	}
-
-	// add simple entry to index
-
 	simpleEntry = (ManagedIndexSimpleEntry *)malloc(
 			sizeof(ManagedIndexSimpleEntry));
 
@@ -1105,79 +1128,65 @@ int managedIndex_putSimple(ManagedIndex *index, char *key, int keyLength,
 	entry = (ManagedIndexEntry *)malloc(sizeof(ManagedIndexEntry));
 
 	entry->isSimpleEntry = atrue;
+	entry->isReferenced = atrue;
 	entry->keyLength = keyLength;
 	entry->memorySize = (keyLength +
 			sizeof(ManagedIndexSimpleEntry) +
 			simpleEntry->length);
+	entry->hash = crc32_calculateHash(key, keyLength);
 	entry->ticks = 0;
 	entry->timestamp = time_getTimeMus();
 	entry->key = strndup(key, keyLength);
 	entry->value = (void *)simpleEntry;
+	entry->chain = NULL;
+	entry->clockNext = NULL;
+	entry->clockPrevious = NULL;
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeLock(&index->spinlock) < 0) {
-			managedIndexFree(index, entry);
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
-	}
-
-	result = bptree_put(&index->index, key, keyLength, (void *)entry);
-
-	if(index->isSpinlockMode) {
-		if(spinlock_writeUnlock(&index->spinlock) < 0) {
-			managedIndexFree(index, entry);
-			return -1;
-		}
-	}
-	else {
-		mutex_unlock(&index->dataMutex);
-	}
-
-	if(result < 0) {
-		managedIndexFree(index, entry);
-	}
-	else {
-		mutex_lock(&index->mutex);
-		index->cachedItemCount += (alint)1;
-		index->cachedMemoryLength += (alint)entry->memorySize;
-		mutex_unlock(&index->mutex);
+	if(putEntry(index, entry) < 0) {
+		free(entry->key);
+		free(entry);
+		free(simpleEntry);
+		return -1;
 	}
 
-	return result;
+	return 0;
 }
 
 int managedIndex_remove(ManagedIndex *index, char *key, int keyLength)
 {
-	int result = 0;
+	unsigned int hash = 0;
+
+	ManagedIndexShard *shard = NULL;
+	ManagedIndexEntry *entry = NULL;
 
 	if((index == NULL) || (key == NULL) || (keyLength < 1)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeLock(&index->spinlock) < 0) {
-			return -1;
-		}
-	}
-	else {
-		mutex_lock(&index->dataMutex);
+	hash = crc32_calculateHash(key, keyLength);
+	shard = getShard(index, hash);
+
+	if(lockShard(index, shard, atrue) < 0) {
+		return -1;
 	}
 
-	result = bptree_remove(&index->index, key, keyLength);
+	if((entry = findEntry(index, shard, hash, key, keyLength)) != NULL) {
+		detachEntry(index, shard, entry);
+	}
 
-	if(index->isSpinlockMode) {
-		if(spinlock_writeUnlock(&index->spinlock) < 0) {
-			return -1;
-		}
+	if(unlockShard(index, shard, atrue) < 0) {
+		return -1;
 	}
-	else {
-		mutex_unlock(&index->dataMutex);
+
+	if(entry == NULL) {
+		return -1;
 	}
 
-	return result;
+	// free the entry outside of the shard lock
+
+	managedIndexFree(index, entry);
+
+	return 0;
 }
 
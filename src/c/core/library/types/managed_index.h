@@ -5,7 +5,8 @@
  * intellectual property of Joshua S. English, all rights reserved.
  *
  * The Asgard core library background thread managed indexing system, using a
- * B+Tree index, type library, header file.
+ * set of lock-striped hash shards with CLOCK eviction, and an optional B+Tree
+ * index for ordered access, type library, header file.
  *
  * Written by Josh English.
  */
@@ -32,6 +33,9 @@ extern "C" {
 
 #define MANAGED_INDEX_DEFAULT_TIMEOUT_SECONDS					300.0
 
+#define MANAGED_INDEX_DEFAULT_SHARD_LENGTH						16
+
+#define MANAGED_INDEX_DEFAULT_BUCKET_LENGTH						64
 
 
 // declare managed index public data types
@@ -43,18 +47,49 @@ typedef struct _ManagedIndexSimpleEntry {
 	char *value;
 } ManagedIndexSimpleEntry;
 
+/*
+ * Each entry is chained into the hash bucket of its shard, and into the CLOCK
+ * ring of the shard, in order of insertion. A get only sets the reference bit
+ * of the entry, and the worker thread advances the clock hand past referenced
+ * entries (clearing the bit) to the first unreferenced or timed-out entry to
+ * evict.
+ */
+
 typedef struct _ManagedIndexEntry {
 	aboolean isSimpleEntry;
+	aboolean isReferenced;
 	int keyLength;
 	int memorySize;
+	unsigned int hash;
 	alint ticks;
 	double timestamp;
 	char *key;
 	void *value;
+	struct _ManagedIndexEntry *chain;
+	struct _ManagedIndexEntry *clockNext;
+	struct _ManagedIndexEntry *clockPrevious;
 } ManagedIndexEntry;
 
+typedef struct _ManagedIndexShard {
+	int entryCount;
+	int bucketLength;
+	ManagedIndexEntry **buckets;
+	ManagedIndexEntry *clockHand;
+	Spinlock spinlock;
+	Mutex mutex;
+} ManagedIndexShard;
+
+/*
+ * The B+Tree index of keys is only maintained in ordered mode, as required by
+ * the get-next & get-previous functions, and is guarded by the spinlock (or
+ * data mutex), always locked after the shard of the entry.
+ */
+
 typedef struct _ManagedIndex {
 	aboolean isSpinlockMode;
+	aboolean isOrderedMode;
+	int shardLength;
+	int clockRef;
 	alint cachedItemCount;
 	alint maxCachedItemCount;
 	alint cachedMemoryLength;
@@ -62,6 +97,7 @@ typedef struct _ManagedIndex {
 	double timeoutSeconds;
 	void *freeArgument;
 	ManagedIndexFreeFunction freeFunction;
+	ManagedIndexShard *shards;
 	Bptree index;
 	TmfContext tmf;
 	Spinlock spinlock;
@@ -72,7 +108,8 @@ typedef struct _ManagedIndex {
 
 // declare managed index public functions
 
-int managedIndex_init(ManagedIndex *index, aboolean isSpinlockMode);
+int managedIndex_init(ManagedIndex *index, aboolean isSpinlockMode,
+		aboolean isOrderedMode);
 
 int managedIndex_free(ManagedIndex *index);
 
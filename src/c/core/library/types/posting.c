@@ -0,0 +1,1006 @@
+/*
+ * posting.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * An API for managing compressed, sorted lists of unique 32-bit integers
+ * (posting lists).
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#define _CORE_LIBRARY_TYPES_COMPONENT
+#include "core/library/types/posting.h"
+
+#if defined(__SSE2__)
+#	include <emmintrin.h>
+#endif // __SSE2__
+
+
+// define posting private constants
+
+#define POSTING_LANES									4
+
+#define POSTING_DECODE_LENGTH							\
+	(POSTING_MAXIMUM_BLOCK_LENGTH + POSTING_LANES)
+
+
+// declare posting private functions
+
+static int lowerBound(int *array, int start, int length, int value);
+
+static int bitWidth(unsigned int value);
+
+static void blockFree(PostingBlock *block);
+
+static void blockEncode(PostingBlock *block, int *array, int length);
+
+static int blockDecode(PostingBlock *block, int *array);
+
+static aboolean blockContains(PostingBlock *block, int value);
+
+static int findBlock(PostingList *posting, int start, int value);
+
+static PostingBlock *insertBlock(PostingList *posting, int position);
+
+static void deleteBlock(PostingList *posting, int position);
+
+static void sealTail(PostingList *posting);
+
+static int tailPut(PostingList *posting, int value);
+
+static int tailRemove(PostingList *posting, int value);
+
+static int putValue(PostingList *posting, int value);
+
+static int removeValue(PostingList *posting, int value);
+
+static void retireView(PostingList *posting);
+
+
+// define posting private functions
+
+static int lowerBound(int *array, int start, int length, int value)
+{
+	int middle = 0;
+
+	while(start < length) {
+		middle = (start + ((length - start) >> 1));
+		if(array[middle] < value) {
+			start = (middle + 1);
+		}
+		else {
+			length = middle;
+		}
+	}
+
+	return start;
+}
+
+static int bitWidth(unsigned int value)
+{
+	int result = 0;
+
+	while(value > 0) {
+		value >>= 1;
+		result++;
+	}
+
+	return result;
+}
+
+static void blockFree(PostingBlock *block)
+{
+	if(block->data != NULL) {
+		free(block->data);
+	}
+
+	memset(block, 0, (int)(sizeof(PostingBlock)));
+}
+
+static void blockEncode(PostingBlock *block, int *array, int length)
+{
+	int ii = 0;
+	int bit = 0;
+	int word = 0;
+	int shift = 0;
+	int width = 0;
+	int packedLength = 0;
+	int bitmapLength = 0;
+	unsigned int delta = 0;
+	unsigned int maxDelta = 0;
+
+	if(block->data != NULL) {
+		free(block->data);
+		block->data = NULL;
+	}
+
+	block->length = length;
+	block->minimum = array[0];
+	block->maximum = array[(length - 1)];
+
+	for(ii = 1; ii < length; ii++) {
+		delta = ((unsigned int)array[ii] - (unsigned int)array[(ii - 1)]);
+		if(delta > maxDelta) {
+			maxDelta = delta;
+		}
+	}
+
+	width = bitWidth(maxDelta);
+
+	packedLength = (((((length + (POSTING_LANES - 1)) / POSTING_LANES) *
+					width) + 31) / 32) * POSTING_LANES;
+
+	bitmapLength = (int)((((aulint)((unsigned int)block->maximum -
+						(unsigned int)block->minimum)) + 32) / 32);
+
+	// dense blocks are cheaper to hold as a bitmap
+
+	if(bitmapLength < packedLength) {
+		block->type = POSTING_BLOCK_TYPE_BITMAP;
+		block->bitWidth = 0;
+		block->dataLength = bitmapLength;
+		block->data = (unsigned int *)malloc(sizeof(unsigned int) *
+				bitmapLength);
+
+		memset(block->data, 0, (sizeof(unsigned int) * bitmapLength));
+
+		for(ii = 0; ii < length; ii++) {
+			delta = ((unsigned int)array[ii] - (unsigned int)block->minimum);
+			block->data[(delta >> 5)] |= (1U << (delta & 31));
+		}
+
+		return;
+	}
+
+	/*
+	 * Pack each delta into the lane given by its position modulo the lane
+	 * count, so that a single SIMD load decodes four consecutive deltas.
+	 */
+
+	block->type = POSTING_BLOCK_TYPE_PACKED;
+	block->bitWidth = width;
+	block->dataLength = packedLength;
+
+	if(packedLength < 1) {
+		return;
+	}
+
+	block->data = (unsigned int *)malloc(sizeof(unsigned int) *
+			packedLength);
+
+	memset(block->data, 0, (sizeof(unsigned int) * packedLength));
+
+	for(ii = 1; ii < length; ii++) {
+		delta = ((unsigned int)array[ii] - (unsigned int)array[(ii - 1)]);
+
+		bit = ((ii / POSTING_LANES) * width);
+		word = (((bit >> 5) * POSTING_LANES) + (ii % POSTING_LANES));
+		shift = (bit & 31);
+
+		block->data[word] |= (delta << shift);
+
+		if((shift + width) > 32) {
+			block->data[(word + POSTING_LANES)] |= (delta >> (32 - shift));
+		}
+	}
+}
+
+static int blockDecode(PostingBlock *block, int *array)
+{
+	int ii = 0;
+	int nn = 0;
+	int bit = 0;
+	int word = 0;
+	int shift = 0;
+	unsigned int bits = 0;
+	unsigned int mask = 0;
+#if defined(__SSE2__)
+	int rows = 0;
+#else // !__SSE2__
+	unsigned int value = 0;
+#endif // __SSE2__
+
+	if(block->type == POSTING_BLOCK_TYPE_BITMAP) {
+		for(ii = 0, nn = 0; ii < block->dataLength; ii++) {
+			bits = block->data[ii];
+			for(bit = 0; bits != 0; bit++, bits >>= 1) {
+				if(bits & 0x01) {
+					array[nn] = (int)((unsigned int)block->minimum +
+							(unsigned int)((ii * 32) + bit));
+					nn++;
+				}
+			}
+		}
+
+		return nn;
+	}
+
+	if(block->bitWidth < 1) {
+		array[0] = block->minimum;
+		return 1;
+	}
+
+	if(block->bitWidth >= 32) {
+		mask = 0xffffffff;
+	}
+	else {
+		mask = ((1U << block->bitWidth) - 1);
+	}
+
+#if defined(__SSE2__)
+	{
+		__m128i deltas;
+		__m128i next;
+		__m128i base;
+		__m128i lanes;
+
+		// each row yields four consecutive deltas, which are prefix-summed
+		// in the register; the array holds room for one partial row
+
+		rows = ((block->length + (POSTING_LANES - 1)) / POSTING_LANES);
+		base = _mm_set1_epi32(block->minimum);
+		lanes = _mm_set1_epi32((int)mask);
+
+		for(ii = 0; ii < rows; ii++) {
+			bit = (ii * block->bitWidth);
+			word = ((bit >> 5) * POSTING_LANES);
+			shift = (bit & 31);
+
+			deltas = _mm_srl_epi32(
+					_mm_loadu_si128((__m128i *)&block->data[word]),
+					_mm_cvtsi32_si128(shift));
+
+			if((shift + block->bitWidth) > 32) {
+				next = _mm_loadu_si128(
+						(__m128i *)&block->data[(word + POSTING_LANES)]);
+				deltas = _mm_or_si128(deltas,
+						_mm_sll_epi32(next, _mm_cvtsi32_si128(32 - shift)));
+			}
+
+			deltas = _mm_and_si128(deltas, lanes);
+			deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+			deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+			deltas = _mm_add_epi32(deltas, base);
+
+			_mm_storeu_si128((__m128i *)&array[(ii * POSTING_LANES)], deltas);
+
+			base = _mm_shuffle_epi32(deltas, _MM_SHUFFLE(3, 3, 3, 3));
+		}
+	}
+#else // !__SSE2__
+	value = (unsigned int)block->minimum;
+
+	for(ii = 0; ii < block->length; ii++) {
+		bit = ((ii / POSTING_LANES) * block->bitWidth);
+		word = (((bit >> 5) * POSTING_LANES) + (ii % POSTING_LANES));
+		shift = (bit & 31);
+
+		bits = (block->data[word] >> shift);
+
+		if((shift + block->bitWidth) > 32) {
+			bits |= (block->data[(word + POSTING_LANES)] << (32 - shift));
+		}
+
+		value += (bits & mask);
+		array[ii] = (int)value;
+	}
+#endif // __SSE2__
+
+	return block->length;
+}
+
+static aboolean blockContains(PostingBlock *block, int value)
+{
+	int length = 0;
+	unsigned int delta = 0;
+	int array[POSTING_DECODE_LENGTH];
+
+	if((value < block->minimum) || (value > block->maximum)) {
+		return afalse;
+	}
+
+	if(block->type == POSTING_BLOCK_TYPE_BITMAP) {
+		delta = ((unsigned int)value - (unsigned int)block->minimum);
+		return (aboolean)((block->data[(delta >> 5)] >> (delta & 31)) & 0x01);
+	}
+
+	length = blockDecode(block, array);
+
+	length = lowerBound(array, 0, length, value);
+
+	return (aboolean)(array[length] == value);
+}
+
+static int findBlock(PostingList *posting, int start, int value)
+{
+	int middle = 0;
+	int length = 0;
+
+	// find the first block, at or after start, whose maximum is >= value
+
+	length = posting->blockCount;
+
+	while(start < length) {
+		middle = (start + ((length - start) >> 1));
+		if(posting->blocks[middle].maximum < value) {
+			start = (middle + 1);
+		}
+		else {
+			length = middle;
+		}
+	}
+
+	return start;
+}
+
+static PostingBlock *insertBlock(PostingList *posting, int position)
+{
+	posting->blockCount += 1;
+
+	if(posting->blocks == NULL) {
+		posting->blocks = (PostingBlock *)malloc(sizeof(PostingBlock) *
+				posting->blockCount);
+	}
+	else {
+		posting->blocks = (PostingBlock *)realloc(posting->blocks,
+				(sizeof(PostingBlock) * posting->blockCount));
+	}
+
+	if(position < (posting->blockCount - 1)) {
+		memmove(&posting->blocks[(position + 1)], &posting->blocks[position],
+				(sizeof(PostingBlock) *
+				 ((posting->blockCount - 1) - position)));
+	}
+
+	memset(&posting->blocks[position], 0, (int)(sizeof(PostingBlock)));
+
+	return &posting->blocks[position];
+}
+
+static void deleteBlock(PostingList *posting, int position)
+{
+	blockFree(&posting->blocks[position]);
+
+	if(position < (posting->blockCount - 1)) {
+		memmove(&posting->blocks[position], &posting->blocks[(position + 1)],
+				(sizeof(PostingBlock) *
+				 ((posting->blockCount - 1) - position)));
+	}
+
+	posting->blockCount -= 1;
+
+	if(posting->blockCount < 1) {
+		free(posting->blocks);
+		posting->blocks = NULL;
+	}
+}
+
+static void sealTail(PostingList *posting)
+{
+	PostingBlock *block = NULL;
+
+	block = insertBlock(posting, posting->blockCount);
+
+	blockEncode(block, posting->tail, posting->tailLength);
+
+	free(posting->tail);
+
+	posting->tail = NULL;
+	posting->tailLength = 0;
+	posting->tailAllocated = 0;
+}
+
+static int tailPut(PostingList *posting, int value)
+{
+	int position = 0;
+
+	position = lowerBound(posting->tail, 0, posting->tailLength, value);
+
+	if((position < posting->tailLength) &&
+			(posting->tail[position] == value)) {
+		return -1;
+	}
+
+	if(posting->tailLength >= posting->tailAllocated) {
+		posting->tailAllocated += POSTING_ALLOCATION_BLOCK_SIZE;
+
+		if(posting->tail == NULL) {
+			posting->tail = (int *)malloc(sizeof(int) *
+					posting->tailAllocated);
+		}
+		else {
+			posting->tail = (int *)realloc(posting->tail,
+					(sizeof(int) * posting->tailAllocated));
+		}
+	}
+
+	if(position < posting->tailLength) {
+		memmove(&posting->tail[(position + 1)], &posting->tail[position],
+				(sizeof(int) * (posting->tailLength - position)));
+	}
+
+	posting->tail[position] = value;
+	posting->tailLength += 1;
+	posting->length += 1;
+
+	if(posting->tailLength >= POSTING_BLOCK_LENGTH) {
+		sealTail(posting);
+	}
+
+	return 0;
+}
+
+static int tailRemove(PostingList *posting, int value)
+{
+	int position = 0;
+
+	position = lowerBound(posting->tail, 0, posting->tailLength, value);
+
+	if((position >= posting->tailLength) ||
+			(posting->tail[position] != value)) {
+		return -1;
+	}
+
+	if(position < (posting->tailLength - 1)) {
+		memmove(&posting->tail[position], &posting->tail[(position + 1)],
+				(sizeof(int) * ((posting->tailLength - 1) - position)));
+	}
+
+	posting->tailLength -= 1;
+	posting->length -= 1;
+
+	if(posting->tailLength < 1) {
+		free(posting->tail);
+		posting->tail = NULL;
+		posting->tailAllocated = 0;
+	}
+	else if((posting->tailAllocated - posting->tailLength) >
+			POSTING_ALLOCATION_BLOCK_SIZE) {
+		posting->tailAllocated -= POSTING_ALLOCATION_BLOCK_SIZE;
+		posting->tail = (int *)realloc(posting->tail,
+				(sizeof(int) * posting->tailAllocated));
+	}
+
+	return 0;
+}
+
+
+static int putValue(PostingList *posting, int value)
+{
+	int length = 0;
+	int position = 0;
+	int blockId = 0;
+	unsigned int delta = 0;
+	int array[POSTING_DECODE_LENGTH];
+
+	PostingBlock *block = NULL;
+
+	// values beyond the last block append to the uncompressed tail
+
+	if((posting->blockCount < 1) ||
+			(value > posting->blocks[(posting->blockCount - 1)].maximum)) {
+		return tailPut(posting, value);
+	}
+
+	blockId = findBlock(posting, 0, value);
+	block = &posting->blocks[blockId];
+
+	// a value within a bitmap block's range only needs its bit set
+
+	if((block->type == POSTING_BLOCK_TYPE_BITMAP) &&
+			(value >= block->minimum) &&
+			(block->length < POSTING_MAXIMUM_BLOCK_LENGTH)) {
+		delta = ((unsigned int)value - (unsigned int)block->minimum);
+
+		if((block->data[(delta >> 5)] >> (delta & 31)) & 0x01) {
+			return -1;
+		}
+
+		block->data[(delta >> 5)] |= (1U << (delta & 31));
+		block->length += 1;
+		posting->length += 1;
+
+		return 0;
+	}
+
+	length = blockDecode(block, array);
+
+	position = lowerBound(array, 0, length, value);
+
+	if((position < length) && (array[position] == value)) {
+		return -1;
+	}
+
+	if(position < length) {
+		memmove(&array[(position + 1)], &array[position],
+				(sizeof(int) * (length - position)));
+	}
+
+	array[position] = value;
+	length++;
+
+	if(length > POSTING_MAXIMUM_BLOCK_LENGTH) {
+		blockEncode(block, array, (length / 2));
+
+		block = insertBlock(posting, (blockId + 1));
+
+		blockEncode(block, &array[(length / 2)], (length - (length / 2)));
+	}
+	else {
+		blockEncode(block, array, length);
+	}
+
+	posting->length += 1;
+
+	return 0;
+}
+
+static int removeValue(PostingList *posting, int value)
+{
+	int length = 0;
+	int position = 0;
+	int blockId = 0;
+	int array[(POSTING_DECODE_LENGTH * 2)];
+
+	PostingBlock *block = NULL;
+
+	if((posting->blockCount < 1) ||
+			(value > posting->blocks[(posting->blockCount - 1)].maximum)) {
+		return tailRemove(posting, value);
+	}
+
+	blockId = findBlock(posting, 0, value);
+	block = &posting->blocks[blockId];
+
+	length = blockDecode(block, array);
+
+	position = lowerBound(array, 0, length, value);
+
+	if((position >= length) || (array[position] != value)) {
+		return -1;
+	}
+
+	if(position < (length - 1)) {
+		memmove(&array[position], &array[(position + 1)],
+				(sizeof(int) * ((length - 1) - position)));
+	}
+
+	length--;
+	posting->length -= 1;
+
+	if(length < 1) {
+		deleteBlock(posting, blockId);
+		return 0;
+	}
+
+	// fold an under-filled block into its successor
+
+	if((length < (POSTING_BLOCK_LENGTH / 2)) &&
+			(blockId < (posting->blockCount - 1)) &&
+			((length + posting->blocks[(blockId + 1)].length) <=
+			 POSTING_MAXIMUM_BLOCK_LENGTH)) {
+		length += blockDecode(&posting->blocks[(blockId + 1)],
+				&array[length]);
+
+		deleteBlock(posting, (blockId + 1));
+
+		block = &posting->blocks[blockId];
+	}
+
+	blockEncode(block, array, length);
+
+	return 0;
+}
+
+static void retireView(PostingList *posting)
+{
+	PostingView *view = NULL;
+
+	// readers holding the view keep it alive, it is never modified in place
+
+	if((view = posting->view) != NULL) {
+		posting->view = NULL;
+		posting_releaseView(view);
+	}
+}
+
+
+// define posting public functions
+
+void posting_init(PostingList *posting)
+{
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	memset(posting, 0, (int)(sizeof(PostingList)));
+
+	posting->length = 0;
+	posting->blockCount = 0;
+	posting->tailLength = 0;
+	posting->tailAllocated = 0;
+	posting->tail = NULL;
+	posting->blocks = NULL;
+	posting->view = NULL;
+}
+
+PostingList *posting_new()
+{
+	PostingList *result = NULL;
+
+	result = (PostingList *)malloc(sizeof(PostingList));
+
+	posting_init(result);
+
+	return result;
+}
+
+void posting_free(PostingList *posting)
+{
+	int ii = 0;
+
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	if(posting->blocks != NULL) {
+		for(ii = 0; ii < posting->blockCount; ii++) {
+			blockFree(&posting->blocks[ii]);
+		}
+
+		free(posting->blocks);
+	}
+
+	if(posting->tail != NULL) {
+		free(posting->tail);
+	}
+
+	retireView(posting);
+
+	memset(posting, 0, (int)(sizeof(PostingList)));
+}
+
+void posting_freePtr(PostingList *posting)
+{
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	posting_free(posting);
+	free(posting);
+}
+
+int posting_getLength(PostingList *posting)
+{
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	return posting->length;
+}
+
+alint posting_getMemoryLength(PostingList *posting)
+{
+	int ii = 0;
+	alint result = 0;
+
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	result = (alint)(sizeof(PostingList) +
+			(sizeof(int) * posting->tailAllocated) +
+			(sizeof(PostingBlock) * posting->blockCount));
+
+	for(ii = 0; ii < posting->blockCount; ii++) {
+		result += (alint)(sizeof(unsigned int) *
+				posting->blocks[ii].dataLength);
+	}
+
+	if(posting->view != NULL) {
+		result += (alint)(sizeof(PostingView) +
+				(sizeof(int) * posting->view->length));
+	}
+
+	return result;
+}
+
+int posting_contains(PostingList *posting, int value)
+{
+	int position = 0;
+
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((posting->blockCount > 0) &&
+			(value <= posting->blocks[(posting->blockCount - 1)].maximum)) {
+		position = findBlock(posting, 0, value);
+		if(blockContains(&posting->blocks[position], value)) {
+			return 0;
+		}
+		return -1;
+	}
+
+	position = lowerBound(posting->tail, 0, posting->tailLength, value);
+
+	if((position < posting->tailLength) &&
+			(posting->tail[position] == value)) {
+		return 0;
+	}
+
+	return -1;
+}
+
+int posting_put(PostingList *posting, int value)
+{
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(putValue(posting, value) < 0) {
+		return -1;
+	}
+
+	retireView(posting);
+
+	return 0;
+}
+
+int posting_remove(PostingList *posting, int value)
+{
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(removeValue(posting, value) < 0) {
+		return -1;
+	}
+
+	retireView(posting);
+
+	return 0;
+}
+
+int posting_decode(PostingList *posting, int *array)
+{
+	int ii = 0;
+	int ref = 0;
+	int block[POSTING_DECODE_LENGTH];
+
+	if((posting == NULL) || (array == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	// decode by way of a local buffer, since packed blocks decode whole rows
+
+	for(ii = 0; ii < posting->blockCount; ii++) {
+		blockDecode(&posting->blocks[ii], block);
+
+		memcpy(&array[ref], block,
+				(sizeof(int) * posting->blocks[ii].length));
+
+		ref += posting->blocks[ii].length;
+	}
+
+	if(posting->tailLength > 0) {
+		memcpy(&array[ref], posting->tail,
+				(sizeof(int) * posting->tailLength));
+
+		ref += posting->tailLength;
+	}
+
+	return ref;
+}
+
+int *posting_toArray(PostingList *posting, int *length)
+{
+	int *result = NULL;
+
+	if((posting == NULL) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(length != NULL) {
+			*length = 0;
+		}
+
+		return NULL;
+	}
+
+	*length = 0;
+
+	if(posting->length < 1) {
+		return NULL;
+	}
+
+	result = (int *)malloc(sizeof(int) * posting->length);
+
+	*length = posting_decode(posting, result);
+
+	return result;
+}
+
+int posting_filter(PostingList *posting, int *array, int length,
+		int *output)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int blockId = 0;
+	unsigned int delta = 0;
+	int block[POSTING_DECODE_LENGTH];
+
+	PostingBlock *current = NULL;
+
+	if((posting == NULL) || (array == NULL) || (length < 0) ||
+			(output == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	/*
+	 * Emit, in order, each element of the sorted array (duplicates included)
+	 * that is present in the posting list. Only blocks that overlap a
+	 * candidate value are decoded, and the output may be the array itself.
+	 */
+
+	while((ii < length) && (blockId < posting->blockCount)) {
+		blockId = findBlock(posting, blockId, array[ii]);
+		if(blockId >= posting->blockCount) {
+			break;
+		}
+
+		current = &posting->blocks[blockId];
+
+		if(array[ii] < current->minimum) {
+			ii = lowerBound(array, ii, length, current->minimum);
+			continue;
+		}
+
+		if(current->type == POSTING_BLOCK_TYPE_BITMAP) {
+			for(; ((ii < length) && (array[ii] <= current->maximum)); ii++) {
+				delta = ((unsigned int)array[ii] -
+						(unsigned int)current->minimum);
+				if((current->data[(delta >> 5)] >> (delta & 31)) & 0x01) {
+					output[ref] = array[ii];
+					ref++;
+				}
+			}
+		}
+		else {
+			blockDecode(current, block);
+
+			for(nn = 0; ((ii < length) && (array[ii] <= current->maximum));
+					ii++) {
+				while(block[nn] < array[ii]) {
+					nn++;
+				}
+
+				if(block[nn] == array[ii]) {
+					output[ref] = array[ii];
+					ref++;
+				}
+			}
+		}
+
+		blockId++;
+	}
+
+	// merge whatever remains against the uncompressed tail
+
+	for(nn = 0; ((ii < length) && (nn < posting->tailLength)); ii++) {
+		while((nn < posting->tailLength) && (posting->tail[nn] < array[ii])) {
+			nn++;
+		}
+
+		if((nn < posting->tailLength) && (posting->tail[nn] == array[ii])) {
+			output[ref] = array[ii];
+			ref++;
+		}
+	}
+
+	return ref;
+}
+
+PostingView *posting_newView(int *array, int length)
+{
+	PostingView *result = NULL;
+
+	if((array == NULL) || (length < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	// the view takes ownership of the array
+
+	result = (PostingView *)malloc(sizeof(PostingView));
+
+	result->references = 1;
+	result->length = length;
+	result->array = array;
+
+	return result;
+}
+
+PostingView *posting_getView(PostingList *posting)
+{
+	int length = 0;
+	int *array = NULL;
+
+	PostingView *view = NULL;
+
+	if(posting == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	if(posting->length < 1) {
+		return NULL;
+	}
+
+	if((view = posting->view) != NULL) {
+		posting_pinView(view);
+		return view;
+	}
+
+	/*
+	 * Concurrent readers may each decode the list, so the view is published
+	 * with a compare-and-swap, holding one reference for the list and one for
+	 * the reader; a reader that loses the race uses the winner's view.
+	 */
+
+	array = (int *)malloc(sizeof(int) * posting->length);
+	length = posting_decode(posting, array);
+
+	view = posting_newView(array, length);
+	view->references = 2;
+
+	if(!atomic_comparePointer((void **)&posting->view, NULL, (void *)view)) {
+		free(view->array);
+		free(view);
+
+		view = posting->view;
+		posting_pinView(view);
+	}
+
+	return view;
+}
+
+void posting_pinView(PostingView *view)
+{
+	if(view == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	atomic_addInt(&view->references, 1);
+}
+
+void posting_releaseView(PostingView *view)
+{
+	if(view == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	if(atomic_addInt(&view->references, -1) > 0) {
+		return;
+	}
+
+	free(view->array);
+	free(view);
+}
@@ -0,0 +1,131 @@
+/*
+ * posting.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * An API for managing compressed, sorted lists of unique 32-bit integers
+ * (posting lists), header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_CORE_LIBRARY_TYPES_POSTING_H)
+
+#define _CORE_LIBRARY_TYPES_POSTING_H
+
+#if !defined(_CORE_H) && !defined(_CORE_LIBRARY_H) && \
+		!defined(_CORE_LIBRARY_TYPES_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _CORE_H || _CORE_LIBRARY_H || _CORE_LIBRARY_TYPES_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define posting public constants
+
+#define POSTING_BLOCK_LENGTH						128
+
+#define POSTING_MAXIMUM_BLOCK_LENGTH				(POSTING_BLOCK_LENGTH * 2)
+
+#define POSTING_ALLOCATION_BLOCK_SIZE				8
+
+typedef enum _PostingBlockTypes {
+	POSTING_BLOCK_TYPE_PACKED = 1,
+	POSTING_BLOCK_TYPE_BITMAP,
+	POSTING_BLOCK_TYPE_UNKNOWN = -1
+} PostingBlockTypes;
+
+
+// define posting public data types
+
+/*
+ * A block holds between one and POSTING_MAXIMUM_BLOCK_LENGTH values, either
+ * as deltas from the minimum bit-packed across four interleaved 32-bit lanes,
+ * or as a bitmap over [minimum, maximum] when the block is dense.
+ */
+
+typedef struct _PostingBlock {
+	PostingBlockTypes type;
+	int length;
+	int bitWidth;
+	int minimum;
+	int maximum;
+	int dataLength;
+	unsigned int *data;
+} PostingBlock;
+
+/*
+ * A view is an immutable, decoded snapshot of a posting list, shared by
+ * reference count. Readers pin the list's current view while holding the
+ * lock that serializes changes to the list, and may use it after that lock
+ * is released. A change to the list retires its view, rather than modifying
+ * it, and the view is freed when its last reader releases it.
+ */
+
+typedef struct _PostingView {
+	int references;
+	int length;
+	int *array;
+} PostingView;
+
+/*
+ * Values greater than the maximum of the last block collect, uncompressed,
+ * in the tail until it fills and is sealed into a new block.
+ */
+
+typedef struct _PostingList {
+	int length;
+	int blockCount;
+	int tailLength;
+	int tailAllocated;
+	int *tail;
+	PostingBlock *blocks;
+	PostingView *view;
+} PostingList;
+
+
+// declare posting public functions
+
+void posting_init(PostingList *posting);
+
+PostingList *posting_new();
+
+void posting_free(PostingList *posting);
+
+void posting_freePtr(PostingList *posting);
+
+int posting_getLength(PostingList *posting);
+
+alint posting_getMemoryLength(PostingList *posting);
+
+int posting_contains(PostingList *posting, int value);
+
+int posting_put(PostingList *posting, int value);
+
+int posting_remove(PostingList *posting, int value);
+
+int posting_decode(PostingList *posting, int *array);
+
+int *posting_toArray(PostingList *posting, int *length);
+
+int posting_filter(PostingList *posting, int *array, int length,
+		int *output);
+
+PostingView *posting_newView(int *array, int length);
+
+PostingView *posting_getView(PostingList *posting);
+
+void posting_pinView(PostingView *view);
+
+void posting_releaseView(PostingView *view);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _CORE_LIBRARY_TYPES_POSTING_H
+
@@ -23,11 +23,7 @@ static RangeIndexEntry *entryNew(int value, char *key, int keyLength);
 
 static void entryFree(void *memory);
 
-static int compareIndexKeys(char *keyAlpha, int keyAlphaLength, char *keyBeta,
-		int keyBetaLength);
-
-static void buildResultSet(int **index, int *indexLength, int *list,
-		int listLength);
+static void buildResultSet(int **index, int *indexLength, PostingList *list);
 
 static int ascendingIntegerComparison(const void *left, const void *right);
 
@@ -48,7 +44,7 @@ static RangeIndexEntry *entryNew(int value, char *key, int keyLength)
 
 	result->value = value;
 	result->key = strndup(key, keyLength);
-	integer_init(&result->list);
+	posting_init(&result->list);
 
 	return result;
 }
@@ -74,69 +70,31 @@ static void entryFree(void *memory)
 
 	free(entry->key);
 
-	integer_free(&entry->list);
+	posting_free(&entry->list);
 
 	free(entry);
 }
 
-static int compareIndexKeys(char *keyAlpha, int keyAlphaLength, char *keyBeta,
-		int keyBetaLength)
-{
-	int alphaInteger = 0;
-	int betaInteger = 0;
-
-	if(keyAlpha == NULL) {
-		if(keyBeta == NULL) {
-			return 0;
-		}
-		return -1;
-	}
-	if(keyBeta == NULL) {
-		return 1;
-	}
-
-	if(serialize_decodeInt(keyAlpha, keyAlphaLength, &alphaInteger) < 0) {
-		alphaInteger = 0;
-	}
-
-	if(serialize_decodeInt(keyBeta, keyBetaLength, &betaInteger) < 0) {
-		betaInteger = 0;
-	}
-
-	if(alphaInteger < betaInteger) {
-		return -1;
-	}
-	else if(alphaInteger > betaInteger) {
-		return 1;
-	}
-
-	return 0;
-}
-
-static void buildResultSet(int **index, int *indexLength, int *list,
-		int listLength)
+static void buildResultSet(int **index, int *indexLength, PostingList *list)
 {
 	int localLength = 0;
 	int *local = NULL;
 	void *ptr = NULL;
 
 	if(*index == NULL) {
-		local = (int *)malloc(sizeof(int) * listLength);
-		memcpy(local, list, (sizeof(int) * listLength));
-		localLength = listLength;
+		local = (int *)malloc(sizeof(int) * list->length);
+		localLength = posting_decode(list, local);
 	}
 	else {
 		local = *index;
 		localLength = *indexLength;
 
 		local = (int *)realloc(local,
-				(sizeof(int) * (localLength + listLength)));
+				(sizeof(int) * (localLength + list->length)));
 
 		ptr = (void *)((aptrcast *)local + (localLength * sizeof(int)));
 
-		memcpy(ptr, list, (sizeof(int) * listLength));
-
-		localLength += listLength;
+		localLength += posting_decode(list, (int *)ptr);
 	}
 
 	*indexLength = localLength;
@@ -165,20 +123,24 @@ static int *searchGreaterThan(RangeIndex *range, int value, int *length)
 	int *result = NULL;
 	char key[SIZEOF_INT];
 
+	BptreeCursor cursor;
 	RangeIndexEntry *entry = NULL;
 
 	if(serialize_encodeInt(value, key) < 0) {
 		return NULL;
 	}
 
-	while(bptree_getNext(&range->index, key, keyLength,
-				((void *)&entry)) == 0) {
-		memcpy(key, entry->key, keyLength);
+	bptree_cursorInit(&cursor, &range->index);
 
-		buildResultSet(&result, &resultLength, entry->list.array,
-				entry->list.length);
+	if(bptree_cursorSeek(&cursor, key, keyLength, afalse) == 0) {
+		while(bptree_cursorNext(&cursor, NULL, NULL,
+					((void *)&entry)) == 0) {
+			buildResultSet(&result, &resultLength, &entry->list);
+		}
 	}
 
+	bptree_cursorFree(&cursor);
+
 	if((result != NULL) && (resultLength > 1)) {
 		qsort((void *)result, resultLength, sizeof(int),
 				ascendingIntegerComparison);
@@ -204,20 +166,24 @@ static int *searchLessThan(RangeIndex *range, int value, int *length)
 	int *result = NULL;
 	char key[SIZEOF_INT];
 
+	BptreeCursor cursor;
 	RangeIndexEntry *entry = NULL;
 
 	if(serialize_encodeInt(value, key) < 0) {
 		return NULL;
 	}
 
-	while(bptree_getPrevious(&range->index, key, keyLength,
-				((void *)&entry)) == 0) {
-		memcpy(key, entry->key, keyLength);
+	bptree_cursorInit(&cursor, &range->index);
 
-		buildResultSet(&result, &resultLength, entry->list.array,
-				entry->list.length);
+	if(bptree_cursorSeek(&cursor, key, keyLength, atrue) == 0) {
+		while(bptree_cursorPrevious(&cursor, NULL, NULL,
+					((void *)&entry)) == 0) {
+			buildResultSet(&result, &resultLength, &entry->list);
+		}
 	}
 
+	bptree_cursorFree(&cursor);
+
 	if((result != NULL) && (resultLength > 1)) {
 		qsort((void *)result, resultLength, sizeof(int),
 				ascendingIntegerComparison);
@@ -243,29 +209,28 @@ static int *searchBetween(RangeIndex *range, int start, int end, int *length)
 	int *result = NULL;
 	char key[SIZEOF_INT];
 
+	BptreeCursor cursor;
 	RangeIndexEntry *entry = NULL;
 
 	if(serialize_encodeInt(start, key) < 0) {
 		return NULL;
 	}
 
-	if(bptree_get(&range->index, key, keyLength, ((void *)&entry)) == 0) {
-		buildResultSet(&result, &resultLength, entry->list.array,
-				entry->list.length);
-	}
-
-	while(bptree_getNext(&range->index, key, keyLength,
-				((void *)&entry)) == 0) {
-		if(entry->value > end) {
-			break;
-		}
+	bptree_cursorInit(&cursor, &range->index);
 
-		memcpy(key, entry->key, keyLength);
+	if(bptree_cursorSeek(&cursor, key, keyLength, atrue) == 0) {
+		while(bptree_cursorNext(&cursor, NULL, NULL,
+					((void *)&entry)) == 0) {
+			if(entry->value > end) {
+				break;
+			}
 
-		buildResultSet(&result, &resultLength, entry->list.array,
-				entry->list.length);
+			buildResultSet(&result, &resultLength, &entry->list);
+		}
 	}
 
+	bptree_cursorFree(&cursor);
+
 	if((result != NULL) && (resultLength > 1)) {
 		qsort((void *)result, resultLength, sizeof(int),
 				ascendingIntegerComparison);
@@ -300,7 +265,7 @@ int rangeIndex_init(RangeIndex *range, char *name)
 
 	bptree_init(&range->index);
 	bptree_setFreeFunction(&range->index, entryFree);
-	bptree_setCompareKeysFunction(&range->index, compareIndexKeys);
+	bptree_setKeyMode(&range->index, BPTREE_KEY_MODE_INTEGER);
 
 	return 0;
 }
@@ -393,11 +358,34 @@ int *range_get(RangeIndex *range, int value, int *length)
 		return NULL;
 	}
 
-	buildResultSet(&result, length, entry->list.array, entry->list.length);
+	buildResultSet(&result, length, &entry->list);
 
 	return result;
 }
 
+PostingView *rangeIndex_getView(RangeIndex *range, int value)
+{
+	int keyLength = SIZEOF_INT;
+	char key[SIZEOF_INT];
+
+	RangeIndexEntry *entry = NULL;
+
+	if(range == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	if(serialize_encodeInt(value, key) < 0) {
+		return NULL;
+	}
+
+	if(bptree_get(&range->index, key, keyLength, ((void *)&entry)) < 0) {
+		return NULL;
+	}
+
+	return posting_getView(&entry->list);
+}
+
 int rangeIndex_put(RangeIndex *range, int value, int uid)
 {
 	int keyLength = SIZEOF_INT;
@@ -424,7 +412,7 @@ int rangeIndex_put(RangeIndex *range, int value, int uid)
 		}
 	}
 
-	if(integer_put(&entry->list, uid) < 0) {
+	if(posting_put(&entry->list, uid) < 0) {
 		if(EXPLICIT_ERRORS) {
 			fprintf(stderr, "[%s():%i] error - failed to add UID %i to index "
 					"'%i'.\n", __FUNCTION__, __LINE__, uid, value);
@@ -462,7 +450,7 @@ int rangeIndex_remove(RangeIndex *range, int value, int uid)
 		}
 	}
 	else {
-		if(integer_remove(&entry->list, uid) < 0) {
+		if(posting_remove(&entry->list, uid) < 0) {
 			if(EXPLICIT_ERRORS) {
 				fprintf(stderr, "[%s():%i] error - unable to remove UID %i "
 						"from index '%i'.\n", __FUNCTION__, __LINE__,
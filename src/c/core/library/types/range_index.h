@@ -39,7 +39,7 @@ typedef enum _RangeIndexSearchTypes {
 typedef struct _RangeIndexEntry {
 	int value;
 	char *key;
-	IntegerArray list;
+	PostingList list;
 } RangeIndexEntry;
 
 typedef struct _RangeIndex {
@@ -62,6 +62,8 @@ int rangeIndex_setName(RangeIndex *range, char *name);
 
 int *range_get(RangeIndex *range, int value, int *length);
 
+PostingView *rangeIndex_getView(RangeIndex *range, int value);
+
 int rangeIndex_put(RangeIndex *range, int value, int uid);
 
 int rangeIndex_remove(RangeIndex *range, int value, int uid);
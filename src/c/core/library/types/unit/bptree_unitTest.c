@@ -21,6 +21,10 @@
 
 #define BPTREE_PERFORMANCE_TEST_LENGTH				262144
 
+#define BPTREE_NODE_LAYOUT_TEST_LENGTH				16384
+
+#define BPTREE_BULK_LOAD_TEST_LENGTH				131072
+
 
 // define b+tree unit test data types
 
@@ -45,6 +49,10 @@ static char *generateRandomString(int minLength, int maxLength,
 
 static int bptree_basicPerformanceTest();
 
+static int bptree_nodeLayoutTest();
+
+static int bptree_bulkLoadCursorTest();
+
 
 // define b+tree unit test global variables
 
@@ -74,6 +82,16 @@ int main()
 		return 1;
 	}
 
+	if(bptree_nodeLayoutTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(bptree_bulkLoadCursorTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
 	printf("[unit] ...PASSED\n");
 
 	return 0;
@@ -627,3 +645,473 @@ static int bptree_basicPerformanceTest()
 	return 0;
 }
 
+static int bptree_nodeLayoutTest()
+{
+	int ii = 0;
+	int nn = 0;
+	int pass = 0;
+	int keyLength = 0;
+	int intValue = 0;
+	int treeDepth = 0;
+	int nodeElements[4] = { 4, 17, 64, 512 };
+	char *key = NULL;
+	char *value = NULL;
+	char buffer[1024];
+
+	Bptree index;
+
+	printf("[unit]\t b+tree node layout test...\n");
+
+	for(pass = 0; pass < 8; pass++) {
+		if(bptree_init(&index) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		if(bptree_setNodeElements(&index, nodeElements[(pass % 4)]) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		if(pass >= 4) {
+			if(bptree_setKeyMode(&index, BPTREE_KEY_MODE_INTEGER) < 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		// insert the keys in a scattered or descending order, sharing long
+		// prefixes
+
+		for(ii = 0; ii < BPTREE_NODE_LAYOUT_TEST_LENGTH; ii++) {
+			nn = ((ii * 7919) % BPTREE_NODE_LAYOUT_TEST_LENGTH);
+			if((pass % 2) == 1) {
+				nn = (BPTREE_NODE_LAYOUT_TEST_LENGTH - (ii + 1));
+			}
+
+			if(pass >= 4) {
+				serialize_encodeInt((nn - (BPTREE_NODE_LAYOUT_TEST_LENGTH / 2)),
+						buffer);
+				keyLength = SIZEOF_INT;
+			}
+			else {
+				keyLength = snprintf(buffer, sizeof(buffer),
+						"bptree/layout/%08i", nn);
+				if((nn % 3) == 0) {
+					keyLength = snprintf(buffer, sizeof(buffer), "%i", nn);
+				}
+			}
+
+			value = (char *)malloc(sizeof(int));
+			memcpy(value, &nn, sizeof(int));
+
+			if(bptree_put(&index, buffer, keyLength, (void *)value) < 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		if(bptree_setNodeElements(&index, 128) == 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		if(bptree_performInternalTest(&index) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		bptree_getTreeDepth(&index, &treeDepth);
+
+		printf("[unit]\t\t node elements %4i, %s keys, tree depth %i\n",
+				index.nodeElements, ((pass >= 4) ? "integer" : "string"),
+				treeDepth);
+
+		// walk the integer keys in order, and look up every key
+
+		for(ii = 0; ii < BPTREE_NODE_LAYOUT_TEST_LENGTH; ii++) {
+			if(pass >= 4) {
+				serialize_encodeInt((ii - (BPTREE_NODE_LAYOUT_TEST_LENGTH / 2)),
+						buffer);
+				keyLength = SIZEOF_INT;
+
+				if(ii < (BPTREE_NODE_LAYOUT_TEST_LENGTH - 1)) {
+					if(bptree_getNext(&index, buffer, keyLength,
+								((void *)&value)) < 0) {
+						printf("[unit]\t\t ...ERROR, failed at line %i, "
+								"aborting.\n", __LINE__);
+						return -1;
+					}
+
+					memcpy(&intValue, value, sizeof(int));
+
+					if(intValue != (ii + 1)) {
+						printf("[unit]\t\t ...ERROR, failed at line %i, "
+								"aborting.\n", __LINE__);
+						return -1;
+					}
+				}
+
+				if(ii > 0) {
+					if(bptree_getPrevious(&index, buffer, keyLength,
+								((void *)&value)) < 0) {
+						printf("[unit]\t\t ...ERROR, failed at line %i, "
+								"aborting.\n", __LINE__);
+						return -1;
+					}
+
+					memcpy(&intValue, value, sizeof(int));
+
+					if(intValue != (ii - 1)) {
+						printf("[unit]\t\t ...ERROR, failed at line %i, "
+								"aborting.\n", __LINE__);
+						return -1;
+					}
+				}
+			}
+			else {
+				keyLength = snprintf(buffer, sizeof(buffer),
+						"bptree/layout/%08i", ii);
+				if((ii % 3) == 0) {
+					keyLength = snprintf(buffer, sizeof(buffer), "%i", ii);
+				}
+			}
+
+			if(bptree_get(&index, buffer, keyLength, ((void *)&value)) < 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+
+			memcpy(&intValue, value, sizeof(int));
+
+			if(intValue != ii) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		// string keys sharing a full prefix must still resolve exactly
+
+		if(pass < 4) {
+			key = "bptree/layout/0000000";
+
+			if(bptree_get(&index, key, (int)strlen(key),
+						((void *)&value)) == 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+
+			if(bptree_getNext(&index, key, (int)strlen(key),
+						((void *)&value)) < 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+
+			memcpy(&intValue, value, sizeof(int));
+
+			if(intValue != 1) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		// remove half of the keys, and validate the remaining tree
+
+		for(ii = 0; ii < BPTREE_NODE_LAYOUT_TEST_LENGTH; ii += 2) {
+			if(pass >= 4) {
+				serialize_encodeInt((ii - (BPTREE_NODE_LAYOUT_TEST_LENGTH / 2)),
+						buffer);
+				keyLength = SIZEOF_INT;
+			}
+			else {
+				keyLength = snprintf(buffer, sizeof(buffer),
+						"bptree/layout/%08i", ii);
+				if((ii % 3) == 0) {
+					keyLength = snprintf(buffer, sizeof(buffer), "%i", ii);
+				}
+			}
+
+			if(bptree_remove(&index, buffer, keyLength) < 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+
+			if(bptree_get(&index, buffer, keyLength, ((void *)&value)) == 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		if(bptree_performInternalTest(&index) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		if(bptree_free(&index) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int bptree_bulkLoadCursorTest()
+{
+	int ii = 0;
+	int pass = 0;
+	int length = 0;
+	int keyLength = 0;
+	int treeDepth = 0;
+	int *keyLengths = NULL;
+	double timestamp = 0.0;
+	double loadTime = 0.0;
+	double walkTime = 0.0;
+	char *key = NULL;
+	char *value = NULL;
+	char **keys = NULL;
+	void **values = NULL;
+	char buffer[1024];
+
+	Bptree index;
+	BptreeCursor cursor;
+
+	printf("[unit]\t b+tree bulk-load & cursor test...\n");
+
+	keys = (char **)malloc(sizeof(char *) * BPTREE_BULK_LOAD_TEST_LENGTH);
+	keyLengths = (int *)malloc(sizeof(int) * BPTREE_BULK_LOAD_TEST_LENGTH);
+	values = (void **)malloc(sizeof(void *) * BPTREE_BULK_LOAD_TEST_LENGTH);
+
+	for(pass = 0; pass < 4; pass++) {
+		length = (1 << (pass * 5));
+		if(length > BPTREE_BULK_LOAD_TEST_LENGTH) {
+			length = BPTREE_BULK_LOAD_TEST_LENGTH;
+		}
+
+		for(ii = 0; ii < length; ii++) {
+			keyLengths[ii] = snprintf(buffer, sizeof(buffer),
+					"bptree/bulk/%08i", (ii * 2));
+			keys[ii] = strdup(buffer);
+			values[ii] = strdup(buffer);
+		}
+
+		bptree_init(&index);
+
+		timestamp = time_getTimeMus();
+
+		if(bptree_bulkLoad(&index, length, keyLengths, keys,
+					values) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		loadTime = time_getElapsedMusInSeconds(timestamp);
+
+		for(ii = 0; ii < length; ii++) {
+			free(keys[ii]);
+		}
+
+		if(bptree_performInternalTest(&index) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		// walk the tree forwards, and then backwards
+
+		timestamp = time_getTimeMus();
+
+		bptree_cursorInit(&cursor, &index);
+
+		if(bptree_cursorFirst(&cursor) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		for(ii = 0; bptree_cursorNext(&cursor, &key, &keyLength,
+					((void *)&value)) == 0; ii++) {
+			snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i", (ii * 2));
+
+			if((keyLength != (int)strlen(buffer)) ||
+					(strncmp(key, buffer, keyLength)) ||
+					(strcmp(value, buffer))) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		walkTime = time_getElapsedMusInSeconds(timestamp);
+
+		if(ii != length) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		for(ii = (length - 1); bptree_cursorPrevious(&cursor, NULL, NULL,
+					((void *)&value)) == 0; ii--) {
+			snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i", (ii * 2));
+
+			if(strcmp(value, buffer)) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		if(ii != -1) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		// seek to keys present in the tree, and to the gaps between them
+
+		for(ii = 0; ii < (length * 2); ii += 7) {
+			snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i", ii);
+
+			bptree_cursorSeek(&cursor, buffer, (int)strlen(buffer), atrue);
+
+			if(bptree_cursorNext(&cursor, NULL, NULL,
+						((void *)&value)) == 0) {
+				snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i",
+						(ii + (ii % 2)));
+				if(strcmp(value, buffer)) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+			}
+			else if((ii + (ii % 2)) < (length * 2)) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+
+			snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i", ii);
+
+			bptree_cursorSeek(&cursor, buffer, (int)strlen(buffer), afalse);
+
+			if(bptree_cursorNext(&cursor, NULL, NULL,
+						((void *)&value)) == 0) {
+				snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i",
+						(ii + 2 - (ii % 2)));
+				if(strcmp(value, buffer)) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+			}
+			else if((ii + 2 - (ii % 2)) < (length * 2)) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		// modifying the tree invalidates the cursor
+
+		bptree_cursorFirst(&cursor);
+
+		snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i", 1);
+
+		if(bptree_put(&index, buffer, (int)strlen(buffer),
+					(void *)strdup(buffer)) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		if(bptree_cursorNext(&cursor, NULL, NULL, ((void *)&value)) == 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		bptree_cursorFree(&cursor);
+
+		// the bulk-loaded tree must remain fully mutable
+
+		for(ii = 0; ii < length; ii++) {
+			snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i",
+					((ii * 2) + 3));
+
+			if(bptree_put(&index, buffer, (int)strlen(buffer),
+						(void *)strdup(buffer)) < 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+
+			snprintf(buffer, sizeof(buffer), "bptree/bulk/%08i", (ii * 2));
+
+			if(bptree_remove(&index, buffer, (int)strlen(buffer)) < 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		if(bptree_performInternalTest(&index) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		bptree_getTreeDepth(&index, &treeDepth);
+
+		printf("[unit]\t\t %6i keys, depth %i, load %0.6f seconds, "
+				"walk %0.6f seconds\n", length, treeDepth, loadTime,
+				walkTime);
+
+		bptree_free(&index);
+	}
+
+	// unordered keys are rejected
+
+	bptree_init(&index);
+
+	keyLengths[0] = 1;
+	keys[0] = "b";
+	values[0] = NULL;
+	keyLengths[1] = 1;
+	keys[1] = "a";
+	values[1] = NULL;
+
+	if(bptree_bulkLoad(&index, 2, keyLengths, keys, values) == 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	bptree_free(&index);
+
+	free(keys);
+	free(keyLengths);
+	free(values);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
@@ -0,0 +1,245 @@
+/*
+ * histogram_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library sharded log-linear latency histogram, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+
+
+// define histogram unit test constants
+
+#define HISTOGRAM_TEST_VALUE_LENGTH						100000
+
+#define HISTOGRAM_TEST_THREAD_LENGTH					8
+
+#define HISTOGRAM_TEST_THREAD_VALUE_LENGTH				65536
+
+
+// declare histogram unit tests
+
+static int histogram_basicFunctionalityTest();
+
+static int histogram_percentileTest();
+
+static int histogram_threadTest();
+
+
+// declare histogram unit test private functions
+
+static void *threadTestThread(void *argument);
+
+
+// main function
+
+int main()
+{
+	signal_registerDefault();
+
+	printf("[unit] histogram unit test (Asgard Ver %s on %s)\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	if(histogram_basicFunctionalityTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(histogram_percentileTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(histogram_threadTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+
+// define histogram unit test private functions
+
+static void *threadTestThread(void *argument)
+{
+	int ii = 0;
+
+	Histogram *histogram = (Histogram *)argument;
+
+	for(ii = 0; ii < HISTOGRAM_TEST_THREAD_VALUE_LENGTH; ii++) {
+		histogram_record(histogram, (alint)(ii % 1000));
+	}
+
+	return NULL;
+}
+
+
+// define histogram unit tests
+
+static int histogram_basicFunctionalityTest()
+{
+	int ii = 0;
+
+	Histogram histogram;
+
+	printf("[unit]\t histogram basic functionality test...\n");
+
+	if(histogram_init(&histogram) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if((histogram_getCount(&histogram) != 0) ||
+			(histogram_getPercentile(&histogram, 50.0) != 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// values below the sub-bucket count are exact
+
+	for(ii = 0; ii < HISTOGRAM_SUB_BUCKET_COUNT; ii++) {
+		histogram_record(&histogram, (alint)ii);
+	}
+
+	if((histogram_getCount(&histogram) != HISTOGRAM_SUB_BUCKET_COUNT) ||
+			(histogram_getSum(&histogram) != 120) ||
+			(histogram_getMaximum(&histogram) != 15) ||
+			(histogram_getPercentile(&histogram, 50.0) != 7) ||
+			(histogram_getPercentile(&histogram, 100.0) != 15)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// negative values count as zero, and huge values land in the last bucket
+
+	histogram_reset(&histogram);
+
+	histogram_record(&histogram, -5);
+	histogram_record(&histogram, ((alint)1 << 50));
+
+	if((histogram_getCount(&histogram) != 2) ||
+			(histogram_getPercentile(&histogram, 50.0) != 0) ||
+			(histogram_getPercentile(&histogram, 100.0) !=
+			 ((alint)1 << 50))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if((histogram_record(NULL, 1) == 0) ||
+			(histogram_getPercentile(&histogram, 101.0) != 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int histogram_percentileTest()
+{
+	int ii = 0;
+	alint value = 0;
+	alint expected = 0;
+	double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+	Histogram histogram;
+
+	printf("[unit]\t histogram percentile test...\n");
+
+	histogram_init(&histogram);
+
+	for(ii = 1; ii <= HISTOGRAM_TEST_VALUE_LENGTH; ii++) {
+		histogram_record(&histogram, (alint)ii);
+	}
+
+	if((histogram_getCount(&histogram) != HISTOGRAM_TEST_VALUE_LENGTH) ||
+			(histogram_getSum(&histogram) !=
+			 (((alint)HISTOGRAM_TEST_VALUE_LENGTH *
+			   (alint)(HISTOGRAM_TEST_VALUE_LENGTH + 1)) / 2)) ||
+			(histogram_getMaximum(&histogram) !=
+			 HISTOGRAM_TEST_VALUE_LENGTH)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// each percentile is reported as the top of its bucket, which is never
+	// under, and never more than a sub-bucket over, the exact value
+
+	for(ii = 0; ii < (int)(sizeof(percentiles) / sizeof(double)); ii++) {
+		value = histogram_getPercentile(&histogram, percentiles[ii]);
+		expected = (alint)((double)HISTOGRAM_TEST_VALUE_LENGTH *
+				percentiles[ii] / 100.0);
+
+		if((value < expected) ||
+				(value > (expected + (expected /
+						(alint)HISTOGRAM_SUB_BUCKET_COUNT)))) {
+			printf("[unit]\t\t ...ERROR, p%0.1f found %lli, expected "
+					"%lli.\n", percentiles[ii], value, expected);
+			return -1;
+		}
+	}
+
+	if(histogram_getPercentile(&histogram, 100.0) !=
+			HISTOGRAM_TEST_VALUE_LENGTH) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int histogram_threadTest()
+{
+	int ii = 0;
+	void *exitValue = NULL;
+
+	Histogram *histogram = NULL;
+	Thread threads[HISTOGRAM_TEST_THREAD_LENGTH];
+
+	printf("[unit]\t histogram thread test...\n");
+
+	histogram = (Histogram *)malloc(sizeof(Histogram));
+
+	histogram_init(histogram);
+
+	for(ii = 0; ii < HISTOGRAM_TEST_THREAD_LENGTH; ii++) {
+		thread_init(&threads[ii]);
+		thread_create(&threads[ii], threadTestThread, (void *)histogram);
+	}
+
+	for(ii = 0; ii < HISTOGRAM_TEST_THREAD_LENGTH; ii++) {
+		thread_join(&threads[ii], &exitValue);
+	}
+
+	// no recording is lost across the shards
+
+	if((histogram_getCount(histogram) != ((alint)HISTOGRAM_TEST_THREAD_LENGTH *
+					(alint)HISTOGRAM_TEST_THREAD_VALUE_LENGTH)) ||
+			(histogram_getMaximum(histogram) != 999) ||
+			(histogram_getPercentile(histogram, 100.0) != 999)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(histogram);
+
+	return 0;
+}
+
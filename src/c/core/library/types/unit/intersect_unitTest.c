@@ -26,6 +26,10 @@
 
 #define ENTRY_SEED										131072
 
+#define KERNEL_TEST_ITERATIONS							512
+
+#define KERNEL_TEST_MAX_BUFFERS							5
+
 
 // declare intersect unit test private functions
 
@@ -46,6 +50,12 @@ static int intersect_binarySearchSanityTest();
 
 static int intersect_strictUnitTest();
 
+static int intersect_kernelUnitTest();
+
+static int intersect_moveUnitTest();
+
+static int intersect_viewUnitTest();
+
 
 // main function
 
@@ -81,6 +91,21 @@ int main()
 		return 1;
 	}
 
+	if(intersect_kernelUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(intersect_moveUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(intersect_viewUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
 	printf("[unit] ...PASSED\n");
 
 	return 0;
@@ -504,3 +529,290 @@ static int intersect_strictUnitTest()
 	return 0;
 }
 
+
+static int intersect_kernelUnitTest()
+{
+	aboolean isFound = afalse;
+	int ii = 0;
+	int nn = 0;
+	int jj = 0;
+	int ref = 0;
+	int range = 0;
+	int length = 0;
+	int bufferCount = 0;
+	int lengths[KERNEL_TEST_MAX_BUFFERS];
+	int *arrays[KERNEL_TEST_MAX_BUFFERS];
+	int *result = NULL;
+	int *expected = NULL;
+	double timer = 0.0;
+	double elapsed = 0.0;
+
+	Intersect intersect;
+
+	printf("[unit]\t intersect kernel unit test (%i iterations)...\n",
+			KERNEL_TEST_ITERATIONS);
+
+	system_pickRandomSeed();
+
+	for(ii = 0; ii < KERNEL_TEST_ITERATIONS; ii++) {
+		bufferCount = ((rand() % (KERNEL_TEST_MAX_BUFFERS - 1)) + 2);
+		range = ((rand() % 4096) + 16);
+
+		// mix short and long lists, with duplicates, to reach every path
+
+		for(nn = 0; nn < bufferCount; nn++) {
+			if((rand() % 3) == 0) {
+				lengths[nn] = ((rand() % 16) + 1);
+			}
+			else {
+				lengths[nn] = ((rand() % (range * 2)) + 1);
+			}
+
+			arrays[nn] = (int *)malloc(sizeof(int) * (lengths[nn] + 1));
+
+			for(jj = 0; jj < lengths[nn]; jj++) {
+				arrays[nn][jj] = ((rand() % range) + 1);
+			}
+
+			qsort(arrays[nn], lengths[nn], sizeof(int),
+					ascendingIntegerComparison);
+		}
+
+		// determine the expected result by brute force
+
+		expected = (int *)malloc(sizeof(int) * (lengths[0] + 1));
+
+		for(jj = 0, ref = 0; jj < lengths[0]; jj++) {
+			isFound = atrue;
+
+			for(nn = 1; nn < bufferCount; nn++) {
+				if((lengths[nn] < 1) ||
+						(bsearch(&arrays[0][jj], arrays[nn], lengths[nn],
+								 sizeof(int),
+								 ascendingIntegerComparison) == NULL)) {
+					isFound = afalse;
+					break;
+				}
+			}
+
+			if(isFound) {
+				expected[ref] = arrays[0][jj];
+				ref++;
+			}
+		}
+
+		intersect_init(&intersect);
+
+		for(nn = 0; nn < bufferCount; nn++) {
+			if(intersect_putArray(&intersect, atrue, arrays[nn],
+						lengths[nn]) < 0) {
+				fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+						__FUNCTION__, __LINE__);
+				return -1;
+			}
+		}
+
+		timer = time_getTimeMus();
+
+		intersect_execAnd(&intersect, (aboolean)(ii % 2));
+
+		elapsed += time_getElapsedMusInSeconds(timer);
+
+		result = intersect_getResult(&intersect, &length);
+
+		if(length != ref) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		for(jj = 0; jj < ref; jj++) {
+			if(result[jj] != expected[jj]) {
+				fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+						__FUNCTION__, __LINE__);
+				return -1;
+			}
+		}
+
+		intersect_free(&intersect);
+
+		for(nn = 0; nn < bufferCount; nn++) {
+			free(arrays[nn]);
+		}
+
+		free(expected);
+	}
+
+	printf("[unit]\t\t boolean-and intersect time: %0.6f seconds\n",
+			elapsed);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int intersect_moveUnitTest()
+{
+	int ii = 0;
+	int arrayOne[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	int arrayTwo[5] = { 1, 3, 5, 7, 9 };
+	int arrayThree[4] = { 3, 5, 7, 11 };
+
+	MemoryArena arena;
+	MemoryArena sourceArena;
+	PostingList posting;
+	Intersect intersect;
+	Intersect heapSource;
+	Intersect arenaSource;
+
+	printf("[unit]\t intersect move unit test...\n");
+
+	memory_arenaInit(&arena, 4096);
+	memory_arenaInit(&sourceArena, 4096);
+
+	posting_init(&posting);
+
+	for(ii = 0; ii < 4; ii++) {
+		posting_put(&posting, arrayThree[ii]);
+	}
+
+	intersect_initWithArena(&intersect, &arena);
+	intersect_init(&heapSource);
+	intersect_initWithArena(&arenaSource, &sourceArena);
+
+	intersect_putArray(&intersect, atrue, arrayOne, 10);
+	intersect_putArray(&heapSource, atrue, arrayTwo, 5);
+	intersect_putPosting(&heapSource, &posting);
+	intersect_putArray(&arenaSource, atrue, arrayThree, 4);
+
+	// heap buffers and posting references move, arena buffers are copied
+	// across arenas
+
+	if((intersect_moveBuffers(&intersect, &heapSource) < 0) ||
+			(intersect_moveBuffers(&intersect, &arenaSource) < 0) ||
+			(intersect.length != 4) ||
+			(heapSource.length != 0) || (heapSource.buffers != NULL) ||
+			(arenaSource.length != 0) || (arenaSource.buffers != NULL) ||
+			(intersect.buffers[1].isArenaBuffer) ||
+			(intersect.buffers[2].posting != &posting) ||
+			(!intersect.buffers[3].isArenaBuffer)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_free(&heapSource);
+	intersect_free(&arenaSource);
+
+	memory_arenaFree(&sourceArena);
+
+	intersect_execAnd(&intersect, atrue);
+
+	if((intersect.result.length != 3) ||
+			(intersect.result.array[0] != 3) ||
+			(intersect.result.array[1] != 5) ||
+			(intersect.result.array[2] != 7)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_free(&intersect);
+
+	memory_arenaFree(&arena);
+
+	posting_free(&posting);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int intersect_viewUnitTest()
+{
+	int ii = 0;
+	int arrayOne[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	int arrayTwo[4] = { 3, 5, 7, 11 };
+
+	PostingList posting;
+	PostingView *view = NULL;
+	Intersect intersect;
+	Intersect source;
+
+	printf("[unit]\t intersect view unit test...\n");
+
+	posting_init(&posting);
+
+	for(ii = 0; ii < 4; ii++) {
+		posting_put(&posting, arrayTwo[ii]);
+	}
+
+	view = posting_getView(&posting);
+
+	// the view is used in place, and travels with its buffer
+
+	posting_pinView(view);
+
+	intersect_init(&intersect);
+	intersect_init(&source);
+
+	intersect_putArray(&intersect, atrue, arrayOne, 10);
+	intersect_putView(&source, view);
+
+	if((source.buffers[0].array != view->array) ||
+			(intersect_moveBuffers(&intersect, &source) < 0) ||
+			(intersect.buffers[1].view != view) ||
+			(view->references != 3)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_free(&source);
+
+	intersect_execAnd(&intersect, atrue);
+
+	if((intersect.result.length != 3) ||
+			(intersect.result.array[0] != 3) ||
+			(intersect.result.array[2] != 7)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a put copies the buffer, rather than changing the shared view
+
+	intersect_put(&intersect, 1, 13);
+
+	if((intersect.buffers[1].view != NULL) ||
+			(intersect.buffers[1].length != 5) ||
+			(view->references != 2) || (view->length != 4)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_free(&intersect);
+
+	// a view released by its intersection survives the list it came from
+
+	intersect_init(&intersect);
+	intersect_putView(&intersect, view);
+
+	posting_free(&posting);
+
+	intersect_execOr(&intersect);
+
+	if((view->references != 1) || (intersect.result.length != 4) ||
+			(intersect.result.array[3] != 11)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_free(&intersect);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
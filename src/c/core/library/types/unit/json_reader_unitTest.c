@@ -0,0 +1,363 @@
+/*
+ * json_reader_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library JSON streaming (pull) reader, which tokenizes a
+ * JSON string in place into a sequence of events, without building a tree,
+ * unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+
+
+// define json reader unit test constants
+
+#define JSON_READER_TEST_ELEMENT_LENGTH					256
+
+
+// declare json reader unit tests
+
+static int jsonReader_eventTest();
+
+static int jsonReader_errorTest();
+
+static int jsonReader_objectTest();
+
+
+// main function
+
+int main()
+{
+	signal_registerDefault();
+
+	printf("[unit] json reader unit test (Asgard Ver %s on %s)\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	if(jsonReader_eventTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(jsonReader_errorTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(jsonReader_objectTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+
+// define json reader unit tests
+
+static int jsonReader_eventTest()
+{
+	int ii = 0;
+	int stringLength = 0;
+	char *string = NULL;
+
+	JsonReaderEvents event = JSON_READER_EVENT_END;
+	JsonReader reader;
+
+	const char *SOURCE = ""
+		"{\"messageName\": \"search\", \"uid\": -12.5e1,\n"
+		"\t\"isEnabled\": true, \"skipped\": {\"a\": [1, {\"b\": []}]},\n"
+		"\t\"list\": [\"one\", false, null], \"quoted\": \"say \\\"hi\\\"\"}"
+		" trailing content is ignored";
+
+	const JsonReaderEvents EVENTS[] = {
+		JSON_READER_EVENT_OBJECT_START,
+		JSON_READER_EVENT_NAME,
+		JSON_READER_EVENT_STRING,
+		JSON_READER_EVENT_NAME,
+		JSON_READER_EVENT_NUMBER,
+		JSON_READER_EVENT_NAME,
+		JSON_READER_EVENT_BOOLEAN,
+		JSON_READER_EVENT_NAME,
+		JSON_READER_EVENT_OBJECT_START,
+		JSON_READER_EVENT_NAME,
+		JSON_READER_EVENT_ARRAY_START,
+		JSON_READER_EVENT_STRING,
+		JSON_READER_EVENT_BOOLEAN,
+		JSON_READER_EVENT_NULL,
+		JSON_READER_EVENT_ARRAY_END,
+		JSON_READER_EVENT_NAME,
+		JSON_READER_EVENT_STRING,
+		JSON_READER_EVENT_OBJECT_END,
+		JSON_READER_EVENT_END
+	};
+
+	printf("[unit]\t json reader event test...\n");
+
+	if(jsonReader_init(&reader, (char *)SOURCE, strlen(SOURCE)) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < (int)(sizeof(EVENTS) / sizeof(JsonReaderEvents));
+			ii++) {
+		event = jsonReader_next(&reader);
+
+		if(event != EVENTS[ii]) {
+			printf("[unit]\t\t ...ERROR, expected event '%s', found '%s' "
+					"at %i.\n", jsonReader_eventToString(EVENTS[ii]),
+					jsonReader_eventToString(event), ii);
+			return -1;
+		}
+
+		switch(ii) {
+			case 1:
+				if(!jsonReader_isToken(&reader, "messageName", 11)) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+				break;
+
+			case 2:
+				if((!jsonReader_isToken(&reader, "search", 6)) ||
+						(jsonReader_isToken(&reader, "searc", 5))) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+				break;
+
+			case 4:
+				if(reader.numberValue != -125.0) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+				break;
+
+			case 6:
+				if(!reader.booleanValue) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+				break;
+
+			case 8:
+				// skip the entire object, and its nested values
+
+				if(jsonReader_skip(&reader, event) < 0) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+				break;
+
+			case 16:
+				if(!jsonReader_isToken(&reader, "say \"hi\"", 8)) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+
+				string = jsonReader_getString(&reader, NULL, &stringLength);
+
+				if((string == NULL) || (stringLength != 8) ||
+						(strcmp(string, "say \"hi\""))) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+
+				free(string);
+				break;
+		}
+
+		// the skipped object's events are not in the list
+
+		if(ii == 8) {
+			ii++;
+			event = jsonReader_next(&reader);
+
+			if((event != JSON_READER_EVENT_NAME) ||
+					(!jsonReader_isToken(&reader, "list", 4))) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+						__LINE__);
+				return -1;
+			}
+		}
+	}
+
+	if(jsonReader_next(&reader) != JSON_READER_EVENT_END) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int jsonReader_errorTest()
+{
+	int ii = 0;
+	int nn = 0;
+
+	JsonReaderEvents event = JSON_READER_EVENT_END;
+	JsonReader reader;
+
+	const char *SOURCES[] = {
+		"{\"name\": \"unterminated}",
+		"{\"name\": [1, 2}",
+		"{\"name\" 1}",
+		"{name: 1}",
+		"{\"name\": tru}",
+		"{\"name\": {\"truncated\": 1"
+	};
+
+	printf("[unit]\t json reader error test...\n");
+
+	for(ii = 0; ii < (int)(sizeof(SOURCES) / sizeof(char *)); ii++) {
+		jsonReader_init(&reader, (char *)SOURCES[ii], strlen(SOURCES[ii]));
+
+		for(nn = 0; nn < 16; nn++) {
+			if(((event = jsonReader_next(&reader)) ==
+						JSON_READER_EVENT_ERROR) ||
+					(event == JSON_READER_EVENT_END)) {
+				break;
+			}
+		}
+
+		if((event != JSON_READER_EVENT_ERROR) ||
+				(reader.errorMessage == NULL)) {
+			printf("[unit]\t\t ...ERROR, failed to detect error in '%s'.\n",
+					SOURCES[ii]);
+			return -1;
+		}
+
+		// errors are sticky
+
+		if(jsonReader_next(&reader) != JSON_READER_EVENT_ERROR) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		if(json_newFromString((char *)SOURCES[ii]) != NULL) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int jsonReader_objectTest()
+{
+	int ii = 0;
+	int stringRef = 0;
+	int stringLength = 0;
+	char *string = NULL;
+	char name[128];
+	char buffer[128];
+
+	Json *object = NULL;
+	JsonArray *array = NULL;
+
+	printf("[unit]\t json reader object test...\n");
+
+	// build an object large enough to index its element names
+
+	stringRef = 0;
+	stringLength = 1024;
+	string = (char *)malloc(sizeof(char) * stringLength);
+
+	string = strxpndcat(string, &stringRef, &stringLength, "{", 1);
+
+	for(ii = 0; ii < JSON_READER_TEST_ELEMENT_LENGTH; ii++) {
+		snprintf(buffer, (sizeof(buffer) - 1), "\"element%03i\": %i, ", ii,
+				ii);
+		string = strxpndcat(string, &stringRef, &stringLength, buffer,
+				strlen(buffer));
+	}
+
+	snprintf(buffer, (sizeof(buffer) - 1), "\"element000\": \"duplicate\", "
+			"\"nested\": [[1, 2], [3]]}");
+	string = strxpndcat(string, &stringRef, &stringLength, buffer,
+			strlen(buffer));
+
+	if((object = json_newFromString(string)) == NULL) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(string);
+
+	if((object->elementLength != (JSON_READER_TEST_ELEMENT_LENGTH + 1)) ||
+			(object->hashes == NULL)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < JSON_READER_TEST_ELEMENT_LENGTH; ii++) {
+		snprintf(name, (sizeof(name) - 1), "element%03i", ii);
+
+		if((json_getElementType(object, name) != JSON_VALUE_TYPE_NUMBER) ||
+				(json_getNumber(object, name) != (double)ii)) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if(json_elementExists(object, "element999")) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// nested arrays keep their values
+
+	if(json_getArrayLength(object, "nested") != 2) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	array = (JsonArray *)((void **)((JsonArray *)object->elements[
+				JSON_READER_TEST_ELEMENT_LENGTH].value)->values)[0];
+
+	if((array->length != 2) ||
+			(*((double *)((void **)array->values)[1]) != 2.0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// elements added after parsing remain indexed
+
+	if((json_addString(object, "added", "value") < 0) ||
+			(json_addString(object, "added", "again") == 0) ||
+			(strcmp(json_getString(object, "added"), "value"))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	json_freePtr(object);
+
+	return 0;
+}
+
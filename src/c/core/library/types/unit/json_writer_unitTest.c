@@ -0,0 +1,366 @@
+/*
+ * json_writer_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The Asgard core library JSON streaming writer, which appends compact JSON
+ * directly to a growable output buffer, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+
+
+// define json writer unit test constants
+
+#define JSON_WRITER_TEST_ARRAY_LENGTH					8192
+
+
+// declare json writer unit tests
+
+static int jsonWriter_compactTest();
+
+static int jsonWriter_escapeTest();
+
+static int jsonWriter_domTest();
+
+static int jsonWriter_growthTest();
+
+
+// main function
+
+int main()
+{
+	signal_registerDefault();
+
+	printf("[unit] json writer unit test (Asgard Ver %s on %s)\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	if(jsonWriter_compactTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(jsonWriter_escapeTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(jsonWriter_domTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(jsonWriter_growthTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+
+// define json writer unit tests
+
+static int jsonWriter_compactTest()
+{
+	int stringLength = 0;
+	char *string = NULL;
+
+	JsonWriter writer;
+
+	const char *EXPECTED = ""
+		"{\"messageName\":\"searchResponse\",\"resultCode\":0,"
+		"\"resultSet\":[{\"uid\":1,\"distanceInMiles\":1.500000},{},[]],"
+		"\"isEnabled\":false,\"missing\":null}";
+
+	printf("[unit]\t json writer compact test...\n");
+
+	if(jsonWriter_init(&writer) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	jsonWriter_beginObject(&writer);
+
+	jsonWriter_writeName(&writer, "messageName");
+	jsonWriter_writeString(&writer, "searchResponse", 14);
+	jsonWriter_writeName(&writer, "resultCode");
+	jsonWriter_writeNumber(&writer, 0.0);
+
+	jsonWriter_writeName(&writer, "resultSet");
+	jsonWriter_beginArray(&writer);
+
+	jsonWriter_beginObject(&writer);
+	jsonWriter_writeName(&writer, "uid");
+	jsonWriter_writeNumber(&writer, 1.0);
+	jsonWriter_writeName(&writer, "distanceInMiles");
+	jsonWriter_writeNumber(&writer, 1.5);
+	jsonWriter_endObject(&writer);
+
+	jsonWriter_beginObject(&writer);
+	jsonWriter_endObject(&writer);
+
+	jsonWriter_beginArray(&writer);
+	jsonWriter_endArray(&writer);
+
+	jsonWriter_endArray(&writer);
+
+	jsonWriter_writeName(&writer, "isEnabled");
+	jsonWriter_writeBoolean(&writer, afalse);
+	jsonWriter_writeName(&writer, "missing");
+	jsonWriter_writeNull(&writer);
+
+	if(jsonWriter_endObject(&writer) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if((writer.depth != 0) ||
+			(jsonWriter_endObject(&writer) == 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	string = jsonWriter_release(&writer, &stringLength);
+
+	if((string == NULL) || (stringLength != strlen(EXPECTED)) ||
+			(strcmp(string, EXPECTED))) {
+		printf("[unit]\t\t ...ERROR, found '%s', expected '%s'.\n",
+				string, EXPECTED);
+		return -1;
+	}
+
+	free(string);
+
+	// the writer may be reused after its buffer is released, and a value must
+	// follow a name, which may only be written into an object
+
+	if((jsonWriter_writeName(&writer, "outside") == 0) ||
+			(jsonWriter_beginObject(&writer) < 0) ||
+			(jsonWriter_writeName(&writer, "name") < 0) ||
+			(jsonWriter_writeName(&writer, "again") == 0) ||
+			(jsonWriter_endObject(&writer) == 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(jsonWriter_release(&writer, &stringLength));
+
+	jsonWriter_beginArray(&writer);
+	jsonWriter_writeNumber(&writer, 4294967296.0);
+	jsonWriter_endArray(&writer);
+
+	if(strcmp(writer.buffer, "[4294967296]")) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	jsonWriter_free(&writer);
+
+	return 0;
+}
+
+static int jsonWriter_escapeTest()
+{
+	int stringLength = 0;
+	char *string = NULL;
+	char *value = NULL;
+
+	JsonReader reader;
+	JsonWriter writer;
+
+	const char *SOURCE = "quote \" slash \\ tab \t newline \n end";
+
+	printf("[unit]\t json writer escape test...\n");
+
+	jsonWriter_init(&writer);
+
+	jsonWriter_beginArray(&writer);
+	jsonWriter_writeString(&writer, (char *)SOURCE, strlen(SOURCE));
+	jsonWriter_writeString(&writer, "bell \x07", 6);
+	jsonWriter_endArray(&writer);
+
+	string = jsonWriter_release(&writer, &stringLength);
+
+	if(strcmp(string, "[\"quote \\\" slash \\\\ tab \\t newline \\n end\","
+				"\"bell \\u0007\"]")) {
+		printf("[unit]\t\t ...ERROR, found '%s', aborting.\n", string);
+		return -1;
+	}
+
+	// the reader decodes the escaped string back to the original
+
+	jsonReader_init(&reader, string, stringLength);
+
+	if((jsonReader_next(&reader) != JSON_READER_EVENT_ARRAY_START) ||
+			(jsonReader_next(&reader) != JSON_READER_EVENT_STRING)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	value = jsonReader_getString(&reader, NULL, &stringLength);
+
+	if((value == NULL) || (stringLength != strlen(SOURCE)) ||
+			(strcmp(value, SOURCE))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(value);
+	free(string);
+
+	jsonWriter_free(&writer);
+
+	return 0;
+}
+
+static int jsonWriter_domTest()
+{
+	int domLength = 0;
+	int stringLength = 0;
+	char *dom = NULL;
+	char *string = NULL;
+
+	Json *object = NULL;
+	JsonWriter writer;
+
+	const char *SOURCE = ""
+		"{\"messageName\": \"searchResponse\", \"resultCode\": \"0\", "
+		"\"resultSet\": [{\"uid\": 12, \"name\": \"one\"}, "
+		"{\"uid\": 13, \"list\": [1.25, true, \"two\"]}], "
+		"\"resultSetLength\": 2}";
+
+	printf("[unit]\t json writer dom test...\n");
+
+	if((object = json_newFromString((char *)SOURCE)) == NULL) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// the writer produces what the DOM produces, once minimized
+
+	dom = json_toString(object, &domLength);
+	domLength = json_minimizeJsonString(dom, domLength, atrue);
+
+	jsonWriter_init(&writer);
+	jsonWriter_writeJson(&writer, object);
+
+	string = jsonWriter_release(&writer, &stringLength);
+
+	if((stringLength != domLength) || (strcmp(string, dom))) {
+		printf("[unit]\t\t ...ERROR, found '%s', expected '%s'.\n",
+				string, dom);
+		return -1;
+	}
+
+	free(string);
+	free(dom);
+
+	// members may be written into an object still open for more members
+
+	jsonWriter_beginObject(&writer);
+	jsonWriter_writeJsonMembers(&writer, object);
+	jsonWriter_writeName(&writer, "execTimeSeconds");
+	jsonWriter_writeNumber(&writer, 0.5);
+	jsonWriter_endObject(&writer);
+
+	if((strncmp(writer.buffer, "{\"messageName\":", 15)) ||
+			(strstr(writer.buffer, ",\"resultSetLength\":2,"
+					"\"execTimeSeconds\":0.500000}") == NULL)) {
+		printf("[unit]\t\t ...ERROR, found '%s', aborting.\n",
+				writer.buffer);
+		return -1;
+	}
+
+	jsonWriter_free(&writer);
+
+	json_freePtr(object);
+
+	return 0;
+}
+
+static int jsonWriter_growthTest()
+{
+	int ii = 0;
+	int stringLength = 0;
+	char *string = NULL;
+
+	JsonArray *array = NULL;
+	Json *object = NULL;
+	JsonWriter writer;
+
+	printf("[unit]\t json writer growth test...\n");
+
+	jsonWriter_init(&writer);
+
+	jsonWriter_beginObject(&writer);
+	jsonWriter_writeName(&writer, "resultSet");
+	jsonWriter_beginArray(&writer);
+
+	for(ii = 0; ii < JSON_WRITER_TEST_ARRAY_LENGTH; ii++) {
+		jsonWriter_beginObject(&writer);
+		jsonWriter_writeName(&writer, "uid");
+		jsonWriter_writeNumber(&writer, (double)ii);
+		jsonWriter_endObject(&writer);
+	}
+
+	jsonWriter_endArray(&writer);
+	jsonWriter_endObject(&writer);
+
+	if(writer.bufferLength <= JSON_WRITER_DEFAULT_BUFFER_LENGTH) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	string = jsonWriter_release(&writer, &stringLength);
+
+	if((stringLength != strlen(string)) ||
+			((object = json_newFromString(string)) == NULL)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(string);
+
+	if(json_getArrayLength(object, "resultSet") !=
+			JSON_WRITER_TEST_ARRAY_LENGTH) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	array = (JsonArray *)object->elements[0].value;
+
+	if(json_getNumber((Json *)((void **)array->values)[
+				(JSON_WRITER_TEST_ARRAY_LENGTH - 1)], "uid") !=
+			(double)(JSON_WRITER_TEST_ARRAY_LENGTH - 1)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	json_freePtr(object);
+
+	jsonWriter_free(&writer);
+
+	return 0;
+}
+
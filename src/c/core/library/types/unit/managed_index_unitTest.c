@@ -22,6 +22,9 @@
 //#define MANAGED_INDEX_TEST_IS_SPINLOCK_MODE					afalse
 #define MANAGED_INDEX_TEST_IS_SPINLOCK_MODE					atrue
 
+//#define MANAGED_INDEX_TEST_IS_ORDERED_MODE					afalse
+#define MANAGED_INDEX_TEST_IS_ORDERED_MODE					atrue
+
 #define MANAGED_INDEX_BASIC_TEST_LENGTH						65536
 
 #define MANAGED_INDEX_PERFORMANCE_TEST_LENGTH				262144
@@ -54,6 +57,8 @@ static int managedIndex_basicPerformanceTest();
 
 static int managedIndex_basicManagementTest();
 
+static int managedIndex_orderedTest();
+
 
 // define managed index unit test global variables
 
@@ -88,6 +93,11 @@ int main()
 		return 1;
 	}
 
+	if(managedIndex_orderedTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
 	printf("[unit] ...PASSED\n");
 
 	return 0;
@@ -165,7 +175,19 @@ static int managedIndex_basicFunctionalityTest()
 
 	printf("[unit]\t managed index basic functionality test...\n");
 
-	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE) < 0) {
+	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE,
+				MANAGED_INDEX_TEST_IS_ORDERED_MODE) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// the entries must remain cached for the duration of the test
+
+	if((managedIndex_setMaxCachedItemCount(&index,
+					MANAGED_INDEX_PERFORMANCE_TEST_LENGTH) < 0) ||
+			(managedIndex_setMaxCachedMemoryLength(&index,
+					(alint)MANAGED_INDEX_PERFORMANCE_TEST_LENGTH * 4096) < 0)) {
 		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
 				__LINE__);
 		return -1;
@@ -262,7 +284,19 @@ static int managedIndex_basicFunctionalityTest()
 		return -1;
 	}
 
-	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE) < 0) {
+	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE,
+				MANAGED_INDEX_TEST_IS_ORDERED_MODE) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// the entries must remain cached for the duration of the test
+
+	if((managedIndex_setMaxCachedItemCount(&index,
+					MANAGED_INDEX_PERFORMANCE_TEST_LENGTH) < 0) ||
+			(managedIndex_setMaxCachedMemoryLength(&index,
+					(alint)MANAGED_INDEX_PERFORMANCE_TEST_LENGTH * 4096) < 0)) {
 		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
 				__LINE__);
 		return -1;
@@ -387,7 +421,19 @@ static int managedIndex_basicFunctionalityTest()
 		return -1;
 	}
 
-	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE) < 0) {
+	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE,
+				MANAGED_INDEX_TEST_IS_ORDERED_MODE) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// the entries must remain cached for the duration of the test
+
+	if((managedIndex_setMaxCachedItemCount(&index,
+					MANAGED_INDEX_PERFORMANCE_TEST_LENGTH) < 0) ||
+			(managedIndex_setMaxCachedMemoryLength(&index,
+					(alint)MANAGED_INDEX_PERFORMANCE_TEST_LENGTH * 4096) < 0)) {
 		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
 				__LINE__);
 		return -1;
@@ -575,7 +621,19 @@ static int managedIndex_basicPerformanceTest()
 	printf("[unit]\t managed index basic performance test (%i iterations)...\n",
 			MANAGED_INDEX_PERFORMANCE_TEST_LENGTH);
 
-	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE) < 0) {
+	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE,
+				MANAGED_INDEX_TEST_IS_ORDERED_MODE) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// the entries must remain cached for the duration of the test
+
+	if((managedIndex_setMaxCachedItemCount(&index,
+					MANAGED_INDEX_PERFORMANCE_TEST_LENGTH) < 0) ||
+			(managedIndex_setMaxCachedMemoryLength(&index,
+					(alint)MANAGED_INDEX_PERFORMANCE_TEST_LENGTH * 4096) < 0)) {
 		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
 				__LINE__);
 		return -1;
@@ -672,7 +730,8 @@ static int managedIndex_basicManagementTest()
 	printf("[unit]\t managed index basic management test (%i iterations)...\n",
 			MANAGED_INDEX_MANAGEMENT_TEST_LENGTH);
 
-	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE) < 0) {
+	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE,
+				MANAGED_INDEX_TEST_IS_ORDERED_MODE) < 0) {
 		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
 				__LINE__);
 		return -1;
@@ -791,3 +850,121 @@ static int managedIndex_basicManagementTest()
 	return 0;
 }
 
+static int managedIndex_orderedTest()
+{
+	int ii = 0;
+	int keyLength = 0;
+	char *value = NULL;
+	char key[128];
+	char buffer[128];
+
+	ManagedIndex index;
+
+	printf("[unit]\t managed index ordered test...\n");
+
+	// an unordered index does not support ordered access
+
+	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE,
+				afalse) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(managedIndex_put(&index, "key", 3, strdup("value"), 6) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(managedIndex_getNext(&index, "\0", 1, ((void *)&value)) == 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(managedIndex_free(&index) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// an ordered index returns every key in order, across all shards
+
+	if(managedIndex_init(&index, MANAGED_INDEX_TEST_IS_SPINLOCK_MODE,
+				atrue) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = (MANAGED_INDEX_BASIC_TEST_LENGTH / 64); ii > 0; ii--) {
+		snprintf(buffer, sizeof(buffer), "ordered test key %08i", ii);
+
+		if(managedIndex_put(&index, buffer, (int)strlen(buffer),
+					strdup(buffer), (int)(strlen(buffer) + 1)) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	keyLength = 1;
+	memset(key, 0, (int)(sizeof(key)));
+
+	for(ii = 1; ii <= (MANAGED_INDEX_BASIC_TEST_LENGTH / 64); ii++) {
+		if(managedIndex_getNext(&index, key, keyLength,
+					((void *)&value)) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		snprintf(buffer, sizeof(buffer), "ordered test key %08i", ii);
+
+		if(strcmp(buffer, value)) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		keyLength = snprintf(key, sizeof(key), "%s", value);
+	}
+
+	if(managedIndex_getNext(&index, key, keyLength, ((void *)&value)) == 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// removed keys are no longer returned
+
+	snprintf(buffer, sizeof(buffer), "ordered test key %08i", 2);
+
+	if(managedIndex_remove(&index, buffer, (int)strlen(buffer)) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	snprintf(key, sizeof(key), "ordered test key %08i", 1);
+
+	if((managedIndex_getNext(&index, key, (int)strlen(key),
+					((void *)&value)) < 0) ||
+			(strcmp(value, "ordered test key 00000003"))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(managedIndex_free(&index) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
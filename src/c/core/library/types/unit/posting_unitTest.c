@@ -0,0 +1,584 @@
+/*
+ * posting_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * An API for managing compressed, sorted lists of unique 32-bit integers
+ * (posting lists), unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+
+
+// declare posting unit test constants
+
+#define BASIC_TEST_LENGTH								65536
+
+#define FILTER_TEST_ITERATIONS							256
+
+#define MEMORY_TEST_LENGTH								1048576
+
+
+// declare posting unit test private functions
+
+static int pickValue(int mode);
+
+static int ascendingIntegerComparison(const void *left, const void *right);
+
+static int compareToReference(PostingList *posting, IntegerArray *reference);
+
+static int posting_basicTest(int mode);
+
+static int posting_filterTest();
+
+static int posting_memoryTest();
+
+static int posting_viewTest();
+
+
+// main function
+
+int main()
+{
+	signal_registerDefault();
+
+	printf("[unit] Posting Library Unit Test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	if(posting_basicTest(0) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(posting_basicTest(1) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(posting_basicTest(2) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(posting_filterTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(posting_memoryTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(posting_viewTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+
+// define posting unit test private functions
+
+static int pickValue(int mode)
+{
+	int result = 0;
+
+	switch(mode) {
+		// dense values, which favor bitmap blocks
+		case 0:
+			result = (rand() % (BASIC_TEST_LENGTH * 2));
+			break;
+
+		// sparse values, which favor packed blocks
+		case 1:
+			result = ((rand() % BASIC_TEST_LENGTH) * 4096);
+			break;
+
+		// the full 32-bit range, including negative values
+		default:
+			result = (int)(((unsigned int)rand() << 16) ^
+					(unsigned int)rand());
+	}
+
+	return result;
+}
+
+static int ascendingIntegerComparison(const void *left, const void *right)
+{
+	int iLeft = 0;
+	int iRight = 0;
+
+	if((left == NULL) || (right == NULL)) {
+		return 0;
+	}
+
+	iLeft = *((int *)left);
+	iRight = *((int *)right);
+
+	if(iLeft < iRight) {
+		return -1;
+	}
+	else if(iLeft > iRight) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static int compareToReference(PostingList *posting, IntegerArray *reference)
+{
+	int ii = 0;
+	int length = 0;
+	int *array = NULL;
+
+	if(posting_getLength(posting) != reference->length) {
+		return -1;
+	}
+
+	array = posting_toArray(posting, &length);
+
+	if(length != reference->length) {
+		return -1;
+	}
+
+	for(ii = 0; ii < length; ii++) {
+		if(array[ii] != reference->array[ii]) {
+			free(array);
+			return -1;
+		}
+	}
+
+	if(array != NULL) {
+		free(array);
+	}
+
+	return 0;
+}
+
+static int posting_basicTest(int mode)
+{
+	int ii = 0;
+	int pick = 0;
+	int expected = 0;
+	double timer = 0.0;
+	double putTime = 0.0;
+	double containsTime = 0.0;
+	double removeTime = 0.0;
+
+	IntegerArray reference;
+	PostingList posting;
+
+	printf("[unit]\t posting basic test (mode %i)...\n", mode);
+
+	system_pickRandomSeed();
+
+	integer_init(&reference);
+	posting_init(&posting);
+
+	// add values, both in order and at random
+
+	for(ii = 0; ii < BASIC_TEST_LENGTH; ii++) {
+		if((ii % 2) == 0) {
+			pick = pickValue(mode);
+		}
+		else if(reference.length > 0) {
+			pick = (int)((unsigned int)reference.array[
+					(reference.length - 1)] + ((rand() % 8) + 1));
+		}
+
+		expected = 0;
+		if(integer_put(&reference, pick) < 0) {
+			expected = -1;
+		}
+
+		timer = time_getTimeMus();
+
+		if(posting_put(&posting, pick) != expected) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		putTime += time_getElapsedMusInSeconds(timer);
+	}
+
+	if(compareToReference(&posting, &reference) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// search for present and absent values
+
+	for(ii = 0; ii < BASIC_TEST_LENGTH; ii++) {
+		pick = pickValue(mode);
+
+		timer = time_getTimeMus();
+
+		if((posting_contains(&posting, pick) == 0) !=
+				(integer_contains(&reference, pick) >= 0)) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		containsTime += time_getElapsedMusInSeconds(timer);
+	}
+
+	// remove most of the values, with some misses along the way
+
+	while(reference.length > (BASIC_TEST_LENGTH / 16)) {
+		if((rand() % 8) == 0) {
+			pick = pickValue(mode);
+		}
+		else {
+			pick = reference.array[(rand() % reference.length)];
+		}
+
+		expected = 0;
+		if(integer_remove(&reference, pick) < 0) {
+			expected = -1;
+		}
+
+		timer = time_getTimeMus();
+
+		if(posting_remove(&posting, pick) != expected) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		removeTime += time_getElapsedMusInSeconds(timer);
+	}
+
+	if(compareToReference(&posting, &reference) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	while(reference.length > 0) {
+		pick = reference.array[(reference.length - 1)];
+
+		integer_remove(&reference, pick);
+
+		if(posting_remove(&posting, pick) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if((posting_getLength(&posting) != 0) || (posting.blockCount != 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t\t put time            : %0.6f seconds\n", putTime);
+	printf("[unit]\t\t contains time       : %0.6f seconds\n", containsTime);
+	printf("[unit]\t\t remove time         : %0.6f seconds\n", removeTime);
+
+	integer_free(&reference);
+	posting_free(&posting);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int posting_filterTest()
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int range = 0;
+	int length = 0;
+	int listLength = 0;
+	int resultLength = 0;
+	int arrayLength = 0;
+	int *list = NULL;
+	int *array = NULL;
+	int *output = NULL;
+	int *result = NULL;
+	double timer = 0.0;
+	double filterTime = 0.0;
+	double intersectTime = 0.0;
+
+	PostingList posting;
+	Intersect intersect;
+
+	printf("[unit]\t posting filter test (%i iterations)...\n",
+			FILTER_TEST_ITERATIONS);
+
+	system_pickRandomSeed();
+
+	for(ii = 0; ii < FILTER_TEST_ITERATIONS; ii++) {
+		posting_init(&posting);
+
+		range = ((rand() % 65536) + 64);
+		length = ((rand() % range) + 1);
+
+		for(nn = 0; nn < length; nn++) {
+			posting_put(&posting, (rand() % range));
+		}
+
+		// build a sorted probe array, with duplicates
+
+		arrayLength = ((rand() % (range / 4)) + 1);
+		array = (int *)malloc(sizeof(int) * arrayLength);
+		output = (int *)malloc(sizeof(int) * arrayLength);
+
+		for(nn = 0; nn < arrayLength; nn++) {
+			array[nn] = ((rand() % (range + 32)) - 16);
+		}
+
+		qsort(array, arrayLength, sizeof(int), ascendingIntegerComparison);
+
+		timer = time_getTimeMus();
+
+		length = posting_filter(&posting, array, arrayLength, output);
+
+		filterTime += time_getElapsedMusInSeconds(timer);
+
+		for(nn = 0, ref = 0; nn < arrayLength; nn++) {
+			if(posting_contains(&posting, array[nn]) == 0) {
+				if((ref >= length) || (output[ref] != array[nn])) {
+					printf("[unit]\t\t ...ERROR, failed at line %i, "
+							"aborting.\n", __LINE__);
+					return -1;
+				}
+				ref++;
+			}
+		}
+
+		if(ref != length) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		// a Boolean 'and' against the posting list must match the same
+		// intersection against its decoded copy
+
+		list = posting_toArray(&posting, &listLength);
+
+		intersect_init(&intersect);
+		intersect_putArray(&intersect, atrue, array, arrayLength);
+		intersect_putPosting(&intersect, &posting);
+
+		timer = time_getTimeMus();
+
+		intersect_execAnd(&intersect, afalse);
+
+		intersectTime += time_getElapsedMusInSeconds(timer);
+
+		result = intersect_getResultCopy(&intersect, &resultLength);
+
+		intersect_free(&intersect);
+
+		intersect_init(&intersect);
+		intersect_putArray(&intersect, atrue, array, arrayLength);
+		intersect_putArray(&intersect, atrue, list, listLength);
+		intersect_execAnd(&intersect, afalse);
+
+		if(resultLength != intersect.result.length) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		for(nn = 0; nn < resultLength; nn++) {
+			if(result[nn] != intersect.result.array[nn]) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+						__LINE__);
+				return -1;
+			}
+		}
+
+		intersect_free(&intersect);
+
+		if(result != NULL) {
+			free(result);
+		}
+
+		free(list);
+		free(array);
+		free(output);
+
+		posting_free(&posting);
+	}
+
+	printf("[unit]\t\t filter time         : %0.6f seconds\n", filterTime);
+	printf("[unit]\t\t intersect time      : %0.6f seconds\n", intersectTime);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int posting_memoryTest()
+{
+	int ii = 0;
+	int pick = 0;
+
+	IntegerArray reference;
+	PostingList posting;
+
+	printf("[unit]\t posting memory test (%i values)...\n",
+			MEMORY_TEST_LENGTH);
+
+	system_pickRandomSeed();
+
+	integer_init(&reference);
+	posting_init(&posting);
+
+	// uids arrive mostly in order, with gaps for deleted documents
+
+	for(ii = 0, pick = 0; ii < MEMORY_TEST_LENGTH; ii++) {
+		pick += ((rand() % 16) + 1);
+
+		integer_put(&reference, pick);
+
+		if(posting_put(&posting, pick) < 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if(compareToReference(&posting, &reference) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t\t integer array memory : %lli bytes\n",
+			(alint)(sizeof(IntegerArray) +
+				(sizeof(int) * reference.allocated)));
+	printf("[unit]\t\t posting list memory  : %lli bytes\n",
+			posting_getMemoryLength(&posting));
+
+	if(posting_getMemoryLength(&posting) >=
+			(alint)(sizeof(int) * reference.length)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	integer_free(&reference);
+	posting_free(&posting);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int posting_viewTest()
+{
+	int ii = 0;
+	int length = 0;
+	int *array = NULL;
+
+	PostingList posting;
+	PostingView *view = NULL;
+	PostingView *current = NULL;
+
+	printf("[unit]\t posting view test...\n");
+
+	posting_init(&posting);
+
+	if(posting_getView(&posting) != NULL) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < (POSTING_BLOCK_LENGTH * 4); ii++) {
+		posting_put(&posting, (ii * 3));
+	}
+
+	array = posting_toArray(&posting, &length);
+
+	// readers share the list's view, until the list changes
+
+	view = posting_getView(&posting);
+
+	if((view == NULL) || (view->length != length) ||
+			(view->references != 2) || (posting.view != view) ||
+			(memcmp(view->array, array, (sizeof(int) * length))) ||
+			(posting_getView(&posting) != view) ||
+			(view->references != 3)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	posting_releaseView(view);
+
+	free(array);
+
+	// a failed change keeps the view, a change retires it, and readers keep
+	// the snapshot they pinned
+
+	if((posting_put(&posting, 0) == 0) || (posting.view != view) ||
+			(posting_put(&posting, 1) < 0) || (posting.view != NULL) ||
+			(view->references != 1) || (view->length != length) ||
+			(view->array[1] != 3)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	current = posting_getView(&posting);
+
+	if((current == NULL) || (current == view) ||
+			(current->length != (length + 1)) || (current->array[1] != 1)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	posting_releaseView(view);
+
+	// freeing the list leaves the view to its last reader
+
+	posting_free(&posting);
+
+	if((current->references != 1) || (current->array[0] != 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	posting_releaseView(current);
+
+	// a view may also take ownership of a newly built array
+
+	array = (int *)malloc(sizeof(int) * 2);
+	array[0] = 4;
+	array[1] = 8;
+
+	if(((view = posting_newView(array, 2)) == NULL) ||
+			(view->references != 1) || (view->array != array)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	posting_releaseView(view);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
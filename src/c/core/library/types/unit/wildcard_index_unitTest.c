@@ -278,6 +278,7 @@ static int wildcardIndex_strictUnitTest()
 {
 	int length = 0;
 	int *result = NULL;
+	char **strings = NULL;
 
 	WildcardIndex wildcard;
 
@@ -296,7 +297,11 @@ static int wildcardIndex_strictUnitTest()
 		return -1;
 	}
 
-	if(wildcardIndex_getIndexCount(&wildcard) != 13) {
+	// one term, with the grams of "^porcupine$" & its bounded first & last
+	// characters
+
+	if((wildcardIndex_getIndexCount(&wildcard) != 1) ||
+			(wildcardIndex_getGramCount(&wildcard) != 11)) {
 		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
 				__FUNCTION__, __LINE__);
 		return -1;
@@ -361,6 +366,42 @@ static int wildcardIndex_strictUnitTest()
 
 	free(result);
 
+	// prefixes & suffixes, but not infixes, of the wildcard terms
+
+	result = wildcardIndex_get(&wildcard, "ree", &length);
+	if((result == NULL) || (length != 1) || (result[0] != 1)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(result);
+
+	if(((result = wildcardIndex_get(&wildcard, "cupi", &length)) != NULL) ||
+			((result = wildcardIndex_get(&wildcard, "ridge",
+										 &length)) == NULL) ||
+			(length != 1) || (result[0] != 2)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(result);
+
+	if(((strings = wildcardIndex_getTerms(&wildcard, "PINE",
+						&length)) == NULL) ||
+			(length != 2) ||
+			(strcmp(strings[0], "porcupine")) ||
+			(strcmp(strings[1], "pinetree"))) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(strings[0]);
+	free(strings[1]);
+	free(strings);
+
 	if(wildcardIndex_remove(&wildcard, "pinetree", 1) < 0) {
 		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
 				__FUNCTION__, __LINE__);
@@ -419,7 +460,8 @@ static int wildcardIndex_strictUnitTest()
 		return -1;
 	}
 
-	if(wildcardIndex_getIndexCount(&wildcard) != 13) {
+	if((wildcardIndex_getIndexCount(&wildcard) != 1) ||
+			(wildcardIndex_getGramCount(&wildcard) != 11)) {
 		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
 				__FUNCTION__, __LINE__);
 		return -1;
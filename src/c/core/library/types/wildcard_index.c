@@ -19,21 +19,66 @@
 
 // declare wildcard index private functions
 
-static int updateWorkspace(WildcardIndex *wildcard, char *string);
+static char *normalizeString(WildcardIndex *wildcard, char *string,
+		char *buffer, int *length);
+
+static void freeString(char *string, char *buffer);
 
 static void freeWildcardEntry(void *memory);
 
-static int updateWildcardEntry(WildcardIndex *wildcard, int index,
+static void freeWildcardTerm(void *memory);
+
+static int compareIntegers(const void *left, const void *right);
+
+static int uniqueUids(int *uids, int length);
+
+static void buildGram(char *gram, char *key, int keyLength, int position,
+		int gramLength);
+
+static int updateGram(WildcardIndex *wildcard, char *gram, int gramLength,
+		int id, aboolean isAddition);
+
+static int updateTermGrams(WildcardIndex *wildcard, WildcardIndexTerm *term,
 		aboolean isAddition);
 
+static WildcardIndexTerm *getTerm(WildcardIndex *wildcard, char *key,
+		int keyLength, aboolean isCreate);
+
+static int setWildcardTerm(WildcardIndex *wildcard, WildcardIndexTerm *term);
+
+static void releaseTerm(WildcardIndex *wildcard, WildcardIndexTerm *term);
+
+static int *findCandidates(WildcardIndex *wildcard, char *key, int keyLength,
+		aboolean isPrefix, int *length);
+
+static int *findTerms(WildcardIndex *wildcard, char *key, int keyLength,
+		int *length);
+
+static PostingList **findPostings(WildcardIndex *wildcard, char *string,
+		int *length, int *uidLength);
+
 
 // define wildcard index private functions
 
-static int updateWorkspace(WildcardIndex *wildcard, char *string)
+static char *normalizeString(WildcardIndex *wildcard, char *string,
+		char *buffer, int *length)
 {
 	int ii = 0;
 	int nn = 0;
 	int cValue = 0;
+	char *result = NULL;
+
+	*length = 0;
+
+	// normalize into the caller's buffer, so that lookups share no state
+
+	if((wildcard->maxStringLength + 1) > WILDCARD_INDEX_STRING_LENGTH) {
+		result = (char *)malloc(sizeof(char) *
+				(wildcard->maxStringLength + 1));
+	}
+	else {
+		result = buffer;
+	}
 
 	for(ii = 0, nn = 0;
 			((string[ii] != '\0') && (nn < wildcard->maxStringLength));
@@ -41,149 +86,597 @@ static int updateWorkspace(WildcardIndex *wildcard, char *string)
 		cValue = ctype_ctoi(string[ii]);
 
 		if((cValue < 32) || (cValue > 126)) { // non-printable
-			wildcard->workspace[nn] = ' ';
+			result[nn] = ' ';
 			nn++;
 		}
 		else if(cValue == 32) { // space
-			wildcard->workspace[nn] = ' ';
+			result[nn] = ' ';
 			nn++;
 		}
 		else if((cValue > 64) && (cValue < 91)) { // uppercase letters
-			wildcard->workspace[nn] = (char)(cValue + 32);
+			result[nn] = (char)(cValue + 32);
 			nn++;
 		}
 		else if(((cValue > 47) && (cValue < 58)) || // numbers
 				((cValue > 96) && (cValue < 123)) // lower-case
 				) {
-			wildcard->workspace[nn] = string[ii];
+			result[nn] = string[ii];
 			nn++;
 		}
 	}
 
 	if(nn < wildcard->minStringLength) {
-		return -1;
+		if(EXPLICIT_ERRORS) {
+			fprintf(stderr, "[%s():%i] error - normalized string length %i is "
+					"out-of-bounds.\n", __FUNCTION__, __LINE__, nn);
+		}
+
+		freeString(result, buffer);
+
+		return NULL;
 	}
 
-	wildcard->workspace[nn] = '\0';
-	wildcard->workspaceLength = nn;
+	result[nn] = '\0';
+	*length = nn;
 
-	return wildcard->workspaceLength;
+	return result;
+}
+
+static void freeString(char *string, char *buffer)
+{
+	if((string != NULL) && (string != buffer)) {
+		free(string);
+	}
 }
 
 static void freeWildcardEntry(void *memory)
 {
-	IntegerArray *entry = NULL;
+	PostingList *entry = NULL;
 
 	if(memory == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return;
 	}
 
-	entry = (IntegerArray *)memory;
+	entry = (PostingList *)memory;
+
+	posting_freePtr(entry);
+}
+
+static void freeWildcardTerm(void *memory)
+{
+	// terms are owned by the term array, and freed from there
+
+	if(memory == NULL) {
+		DISPLAY_INVALID_ARGS;
+	}
+}
+
+static int compareIntegers(const void *left, const void *right)
+{
+	if(*((int *)left) < *((int *)right)) {
+		return -1;
+	}
+	else if(*((int *)left) > *((int *)right)) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static int uniqueUids(int *uids, int length)
+{
+	int ii = 0;
+	int nn = 0;
+	int minimum = 0;
+	int maximum = 0;
+	int bitmapLength = 0;
+	unsigned int word = 0;
+	unsigned int delta = 0;
+	unsigned int *bitmap = NULL;
+
+	if(length < 2) {
+		return length;
+	}
+
+	minimum = uids[0];
+	maximum = uids[0];
+
+	for(ii = 1; ii < length; ii++) {
+		if(uids[ii] < minimum) {
+			minimum = uids[ii];
+		}
+		else if(uids[ii] > maximum) {
+			maximum = uids[ii];
+		}
+	}
+
+	// dense UIDs are ordered through a bitmap, and sparse ones are sorted
+
+	if(((alint)maximum - (alint)minimum) >= ((alint)length * 32)) {
+		qsort(uids, length, sizeof(int), compareIntegers);
+
+		for(ii = 1, nn = 1; ii < length; ii++) {
+			if(uids[ii] != uids[(nn - 1)]) {
+				uids[nn] = uids[ii];
+				nn++;
+			}
+		}
+
+		return nn;
+	}
+
+	bitmapLength = ((int)(((unsigned int)maximum -
+					(unsigned int)minimum) / 32) + 1);
+	bitmap = (unsigned int *)malloc(sizeof(unsigned int) * bitmapLength);
+
+	memset(bitmap, 0, (sizeof(unsigned int) * bitmapLength));
+
+	for(ii = 0; ii < length; ii++) {
+		delta = ((unsigned int)uids[ii] - (unsigned int)minimum);
+		bitmap[(delta / 32)] |= (1U << (delta % 32));
+	}
+
+	for(ii = 0, nn = 0; ii < bitmapLength; ii++) {
+		for(word = bitmap[ii], delta = 0; word != 0; word >>= 1, delta++) {
+			if(word & 1) {
+				uids[nn] = (int)((unsigned int)minimum +
+						((unsigned int)ii * 32) + delta);
+				nn++;
+			}
+		}
+	}
+
+	free(bitmap);
+
+	return nn;
+}
+
+static void buildGram(char *gram, char *key, int keyLength, int position,
+		int gramLength)
+{
+	int ii = 0;
+
+	// positions before & after the key are its '^' & '$' bounds
+
+	for(ii = 0; ii < gramLength; ii++, position++) {
+		if(position < 0) {
+			gram[ii] = '^';
+		}
+		else if(position >= keyLength) {
+			gram[ii] = '$';
+		}
+		else {
+			gram[ii] = key[position];
+		}
+	}
+
+	gram[gramLength] = '\0';
+}
+
+static int updateGram(WildcardIndex *wildcard, char *gram, int gramLength,
+		int id, aboolean isAddition)
+{
+	PostingList *entry = NULL;
+
+	if(bptree_get(&wildcard->grams, gram, gramLength, ((void *)&entry)) < 0) {
+		if(!isAddition) {
+			return 0;
+		}
+
+		entry = posting_new();
+
+		posting_put(entry, id);
+
+		if(bptree_put(&wildcard->grams, gram, gramLength,
+					(void *)entry) < 0) {
+			posting_freePtr(entry);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	// a gram repeated within the term is already indexed, or removed
+
+	if(isAddition) {
+		posting_put(entry, id);
+	}
+	else if((posting_remove(entry, id) == 0) && (entry->length == 0)) {
+		if(bptree_remove(&wildcard->grams, gram, gramLength) < 0) {
+			return -1;
+		}
+	}
 
-	integer_freePtr(entry);
+	return 0;
 }
 
-static int updateWildcardEntry(WildcardIndex *wildcard, int index,
+static int updateTermGrams(WildcardIndex *wildcard, WildcardIndexTerm *term,
 		aboolean isAddition)
 {
 	int ii = 0;
-	int length = 0;
 	int result = 0;
-	char *ptr = NULL;
+	char gram[(WILDCARD_INDEX_GRAM_LENGTH + 1)];
 
-	IntegerArray *entry = NULL;
+	if(term->keyLength < 1) {
+		return 0;
+	}
+
+	// every gram of the bounded term, '^' + key + '$'
 
-	// create sub-strings from beginning-of-string & take action
+	for(ii = -1; ii < (term->keyLength - 1); ii++) {
+		buildGram(gram, term->key, term->keyLength, ii,
+				WILDCARD_INDEX_GRAM_LENGTH);
 
-	for(ii = 1; ii < wildcard->workspaceLength; ii++) {
-		if((length = (wildcard->workspaceLength - ii)) <
-				wildcard->minStringLength) {
-			break;
+		if(updateGram(wildcard, gram, WILDCARD_INDEX_GRAM_LENGTH, term->id,
+					isAddition) < 0) {
+			result = -1;
 		}
+	}
 
-		ptr = (wildcard->workspace + ii);
+	// the bounded first & last characters, for single-character searches
 
-		if(bptree_get(&wildcard->index, ptr, length, ((void *)&entry)) < 0) {
-			if(isAddition) {
-				entry = integer_new();
+	buildGram(gram, term->key, term->keyLength, -1, 2);
 
-				integer_put(entry, index);
+	if(updateGram(wildcard, gram, 2, term->id, isAddition) < 0) {
+		result = -1;
+	}
 
-				if(bptree_put(&wildcard->index, ptr, length,
-							(void *)entry) < 0) {
-					result = -1;
-				}
+	buildGram(gram, term->key, term->keyLength, (term->keyLength - 1), 2);
+
+	if(updateGram(wildcard, gram, 2, term->id, isAddition) < 0) {
+		result = -1;
+	}
+
+	return result;
+}
+
+static WildcardIndexTerm *getTerm(WildcardIndex *wildcard, char *key,
+		int keyLength, aboolean isCreate)
+{
+	int ii = 0;
+	int id = 0;
+
+	WildcardIndexTerm *result = NULL;
+
+	if(bptree_get(&wildcard->dictionary, key, keyLength,
+				((void *)&result)) == 0) {
+		return result;
+	}
+
+	if(!isCreate) {
+		return NULL;
+	}
+
+	// assign the term an id, re-using those of removed terms
+
+	if(wildcard->freeIdLength > 0) {
+		wildcard->freeIdLength -= 1;
+		id = wildcard->freeIds[wildcard->freeIdLength];
+	}
+	else {
+		if(wildcard->termLength >= wildcard->termAllocated) {
+			if(wildcard->terms == NULL) {
+				wildcard->termAllocated = WILDCARD_INDEX_DEFAULT_TERM_LENGTH;
+				wildcard->terms = (WildcardIndexTerm **)malloc(
+						sizeof(WildcardIndexTerm *) *
+						wildcard->termAllocated);
+				wildcard->freeIds = (int *)malloc(sizeof(int) *
+						wildcard->termAllocated);
 			}
 			else {
-				continue;
+				wildcard->termAllocated *= 2;
+				wildcard->terms = (WildcardIndexTerm **)realloc(
+						wildcard->terms,
+						(sizeof(WildcardIndexTerm *) *
+						 wildcard->termAllocated));
+				wildcard->freeIds = (int *)realloc(wildcard->freeIds,
+						(sizeof(int) * wildcard->termAllocated));
 			}
-		}
-		else {
-			if(isAddition) {
-				if(integer_put(entry, index) < 0) {
-					result = -1;
-				}
+
+			for(ii = wildcard->termLength; ii < wildcard->termAllocated;
+					ii++) {
+				wildcard->terms[ii] = NULL;
 			}
-			else {
-				if(integer_remove(entry, index) == 0) {
-					if(entry->length == 0) {
-						if(bptree_remove(&wildcard->index, ptr, length) < 0) {
-							result = -1;
-						}
-					}
-				}
+		}
+
+		id = wildcard->termLength;
+		wildcard->termLength += 1;
+	}
+
+	result = (WildcardIndexTerm *)malloc(sizeof(WildcardIndexTerm));
+
+	result->isWildcard = afalse;
+	result->id = id;
+	result->references = 0;
+	result->keyLength = keyLength;
+	result->key = (char *)malloc(sizeof(char) * (keyLength + 1));
+	result->uids = NULL;
+
+	memcpy(result->key, key, keyLength);
+	result->key[keyLength] = '\0';
+
+	if(bptree_put(&wildcard->dictionary, result->key, result->keyLength,
+				(void *)result) < 0) {
+		wildcard->freeIds[wildcard->freeIdLength] = id;
+		wildcard->freeIdLength += 1;
+		free(result->key);
+		free(result);
+		return NULL;
+	}
+
+	wildcard->terms[id] = result;
+
+	return result;
+}
+
+static int setWildcardTerm(WildcardIndex *wildcard, WildcardIndexTerm *term)
+{
+	if(term->isWildcard) {
+		return 0;
+	}
+
+	term->isWildcard = atrue;
+
+	return updateTermGrams(wildcard, term, atrue);
+}
+
+static void releaseTerm(WildcardIndex *wildcard, WildcardIndexTerm *term)
+{
+	term->references -= 1;
+
+	if(term->references > 0) {
+		return;
+	}
+
+	if(term->isWildcard) {
+		updateTermGrams(wildcard, term, afalse);
+	}
+
+	bptree_remove(&wildcard->dictionary, term->key, term->keyLength);
+
+	wildcard->terms[term->id] = NULL;
+	wildcard->freeIds[wildcard->freeIdLength] = term->id;
+	wildcard->freeIdLength += 1;
+
+	free(term->key);
+	free(term);
+}
+
+static int *findCandidates(WildcardIndex *wildcard, char *key, int keyLength,
+		aboolean isPrefix, int *length)
+{
+	int ii = 0;
+	int first = 0;
+	int gramLength = 0;
+	int gramCount = 0;
+	int smallest = 0;
+	int *result = NULL;
+	char gram[(WILDCARD_INDEX_GRAM_LENGTH + 1)];
+
+	PostingList **entries = NULL;
+
+	*length = 0;
+
+	// the grams of '^' + key for a prefix, or of key + '$' for a suffix
+
+	if(keyLength >= (WILDCARD_INDEX_GRAM_LENGTH - 1)) {
+		gramLength = WILDCARD_INDEX_GRAM_LENGTH;
+		gramCount = (keyLength - (WILDCARD_INDEX_GRAM_LENGTH - 2));
+	}
+	else {
+		gramLength = 2;
+		gramCount = 1;
+	}
+
+	first = (isPrefix ? -1 : 0);
+
+	entries = (PostingList **)malloc(sizeof(PostingList *) * gramCount);
+
+	for(ii = 0; ii < gramCount; ii++) {
+		buildGram(gram, key, keyLength, (first + ii), gramLength);
+
+		if(bptree_get(&wildcard->grams, gram, gramLength,
+					((void *)&entries[ii])) < 0) {
+			free(entries);
+			return NULL;
+		}
+
+		if(entries[ii]->length < entries[smallest]->length) {
+			smallest = ii;
+		}
+	}
+
+	// intersect the gram postings, starting from the shortest
+
+	if((result = posting_toArray(entries[smallest], length)) != NULL) {
+		for(ii = 0; ((ii < gramCount) && (*length > 0)); ii++) {
+			if(ii != smallest) {
+				*length = posting_filter(entries[ii], result, *length,
+						result);
 			}
 		}
 	}
 
-	// create sub-strings from end-of-string & take action
+	free(entries);
+
+	if((result != NULL) && (*length < 1)) {
+		free(result);
+		result = NULL;
+		*length = 0;
+	}
+
+	return result;
+}
+
+static int *findTerms(WildcardIndex *wildcard, char *key, int keyLength,
+		int *length)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int exactId = 0;
+	int candidateLength = 0;
+	int matchLengths[2];
+	int *result = NULL;
+	int *candidates = NULL;
+	int *matches[2];
 
-	for(ii = (wildcard->workspaceLength - 1);
-			ii >= wildcard->minStringLength;
-			ii--) {
-		ptr = wildcard->workspace;
+	WildcardIndexTerm *term = NULL;
 
-		ptr[ii] = '\0';
-		length = ii;
+	*length = 0;
 
-		if(bptree_get(&wildcard->index, ptr, length, ((void *)&entry)) < 0) {
-			if(isAddition) {
-				entry = integer_new();
+	exactId = -1;
 
-				integer_put(entry, index);
+	if((term = getTerm(wildcard, key, keyLength, afalse)) != NULL) {
+		exactId = term->id;
+	}
 
-				if(bptree_put(&wildcard->index, ptr, length,
-							(void *)entry) < 0) {
-					result = -1;
+	// verify the prefix, and then the suffix, candidates in id order
+
+	for(nn = 0; nn < 2; nn++) {
+		matches[nn] = NULL;
+		matchLengths[nn] = 0;
+
+		if((keyLength < 1) ||
+				((candidates = findCandidates(wildcard, key, keyLength,
+											  (aboolean)(nn == 0),
+											  &candidateLength)) == NULL)) {
+			continue;
+		}
+
+		for(ii = 0, ref = 0; ii < candidateLength; ii++) {
+			if(((term = wildcard->terms[candidates[ii]]) == NULL) ||
+					(!term->isWildcard) ||
+					(term->keyLength <= keyLength)) {
+				continue;
+			}
+
+			if(nn == 0) {
+				if(memcmp(term->key, key, keyLength)) {
+					continue;
 				}
 			}
-			else {
+			else if(memcmp((term->key + (term->keyLength - keyLength)), key,
+						keyLength)) {
 				continue;
 			}
+
+			candidates[ref] = term->id;
+			ref++;
+		}
+
+		matches[nn] = candidates;
+		matchLengths[nn] = ref;
+	}
+
+	// merge the exact term, prefixes & suffixes into one ordered set
+
+	result = (int *)malloc(sizeof(int) *
+			(matchLengths[0] + matchLengths[1] + 1));
+
+	ii = 0;
+	nn = 0;
+	ref = 0;
+
+	while((ii < matchLengths[0]) || (nn < matchLengths[1])) {
+		if((nn >= matchLengths[1]) ||
+				((ii < matchLengths[0]) && (matches[0][ii] < matches[1][nn]))) {
+			result[ref] = matches[0][ii];
+			ii++;
+		}
+		else if((ii >= matchLengths[0]) ||
+				(matches[1][nn] < matches[0][ii])) {
+			result[ref] = matches[1][nn];
+			nn++;
 		}
 		else {
-			if(isAddition) {
-				if(integer_put(entry, index) < 0) {
-					result = -1;
-				}
-			}
-			else {
-				if(integer_remove(entry, index) == 0) {
-					if(entry->length == 0) {
-						if(bptree_remove(&wildcard->index, ptr, length) < 0) {
-							result = -1;
-						}
-					}
-				}
-			}
+			result[ref] = matches[0][ii];
+			ii++;
+			nn++;
+		}
+
+		ref++;
+	}
+
+	if(exactId >= 0) {
+		for(ii = ref; ((ii > 0) && (result[(ii - 1)] > exactId)); ii--) {
+			result[ii] = result[(ii - 1)];
+		}
+
+		result[ii] = exactId;
+		ref++;
+	}
+
+	for(nn = 0; nn < 2; nn++) {
+		if(matches[nn] != NULL) {
+			free(matches[nn]);
 		}
 	}
 
+	if(ref < 1) {
+		free(result);
+		return NULL;
+	}
+
+	*length = ref;
+
 	return result;
 }
 
 
+static PostingList **findPostings(WildcardIndex *wildcard, char *string,
+		int *length, int *uidLength)
+{
+	int ii = 0;
+	int keyLength = 0;
+	int idLength = 0;
+	int *ids = NULL;
+	char *key = NULL;
+	char buffer[WILDCARD_INDEX_STRING_LENGTH];
+
+	PostingList *entry = NULL;
+	PostingList **result = NULL;
+	WildcardIndexTerm *term = NULL;
+
+	*length = 0;
+	*uidLength = 0;
+
+	wildcard->ticks += 1;
+
+	if((key = normalizeString(wildcard, string, buffer, &keyLength)) == NULL) {
+		return NULL;
+	}
+
+	ids = findTerms(wildcard, key, keyLength, &idLength);
+
+	freeString(key, buffer);
+
+	if(ids == NULL) {
+		return NULL;
+	}
+
+	// collect the UID postings of every matching term
+
+	result = (PostingList **)malloc(sizeof(PostingList *) * idLength);
+
+	for(ii = 0; ii < idLength; ii++) {
+		term = wildcard->terms[ids[ii]];
+
+		if(((entry = term->uids) == NULL) || (entry->length < 1)) {
+			continue;
+		}
+
+		result[*length] = entry;
+		*length += 1;
+		*uidLength += entry->length;
+	}
+
+	free(ids);
+
+	return result;
+}
+
 // define wildcard index public functions
 
 int wildcardIndex_init(WildcardIndex *wildcard, int minStringLength,
@@ -199,28 +692,54 @@ int wildcardIndex_init(WildcardIndex *wildcard, int minStringLength,
 
 	wildcard->minStringLength = minStringLength;
 	wildcard->maxStringLength = maxStringLength;
+	wildcard->termLength = 0;
+	wildcard->termAllocated = 0;
+	wildcard->freeIdLength = 0;
+	wildcard->freeIds = NULL;
 	wildcard->ticks = 0;
-	wildcard->workspaceLength = 0;
-	wildcard->workspace = (char *)malloc(sizeof(char) * (maxStringLength + 8));
+	wildcard->terms = NULL;
 
 	bptree_init(&wildcard->index);
 	bptree_setFreeFunction(&wildcard->index, freeWildcardEntry);
 
+	bptree_init(&wildcard->dictionary);
+	bptree_setFreeFunction(&wildcard->dictionary, freeWildcardTerm);
+
+	bptree_init(&wildcard->grams);
+	bptree_setFreeFunction(&wildcard->grams, freeWildcardEntry);
+
 	return 0;
 }
 
 int wildcardIndex_free(WildcardIndex *wildcard)
 {
+	int ii = 0;
+
 	if(wildcard == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
-	if(wildcard->workspace != NULL) {
-		free(wildcard->workspace);
+	bptree_free(&wildcard->index);
+	bptree_free(&wildcard->dictionary);
+	bptree_free(&wildcard->grams);
+
+	if(wildcard->terms != NULL) {
+		for(ii = 0; ii < wildcard->termLength; ii++) {
+			if(wildcard->terms[ii] != NULL) {
+				free(wildcard->terms[ii]->key);
+				free(wildcard->terms[ii]);
+			}
+		}
+
+		free(wildcard->terms);
+	}
+
+	if(wildcard->freeIds != NULL) {
+		free(wildcard->freeIds);
 	}
 
-	bptree_free(&wildcard->index);
+	memset(wildcard, 0, (int)(sizeof(WildcardIndex)));
 
 	return 0;
 }
@@ -267,6 +786,22 @@ int wildcardIndex_getIndexDepth(WildcardIndex *wildcard)
 	return result;
 }
 
+int wildcardIndex_getGramCount(WildcardIndex *wildcard)
+{
+	int result = 0;
+
+	if(wildcard == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(bptree_getLeafCount(&wildcard->grams, &result) < 0) {
+		return -2;
+	}
+
+	return result;
+}
+
 int wildcardIndex_setStringThresholds(WildcardIndex *wildcard,
 		int minStringLength, int maxStringLength)
 {
@@ -279,23 +814,96 @@ int wildcardIndex_setStringThresholds(WildcardIndex *wildcard,
 	wildcard->minStringLength = minStringLength;
 	wildcard->maxStringLength = maxStringLength;
 
-	wildcard->workspaceLength = 0;
+	return 0;
+}
+
+char *wildcardIndex_buildKey(WildcardIndex *wildcard, char *string,
+		int *keyLength)
+{
+	char *key = NULL;
+	char *result = NULL;
+	char buffer[WILDCARD_INDEX_STRING_LENGTH];
+
+	if((wildcard == NULL) || (string == NULL) || (keyLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(keyLength != NULL) {
+			*keyLength = 0;
+		}
+
+		return NULL;
+	}
+
+	*keyLength = 0;
 
-	if(wildcard->workspace != NULL) {
-		free(wildcard->workspace);
+	if((key = normalizeString(wildcard, string, buffer, keyLength)) == NULL) {
+		return NULL;
 	}
 
-	wildcard->workspace = (char *)malloc(sizeof(char) * (maxStringLength + 8));
+	result = strndup(key, *keyLength);
 
-	return 0;
+	freeString(key, buffer);
+
+	return result;
+}
+
+char **wildcardIndex_getTerms(WildcardIndex *wildcard, char *string,
+		int *length)
+{
+	int ii = 0;
+	int keyLength = 0;
+	int idLength = 0;
+	int *ids = NULL;
+	char *key = NULL;
+	char **result = NULL;
+	char buffer[WILDCARD_INDEX_STRING_LENGTH];
+
+	WildcardIndexTerm *term = NULL;
+
+	if((wildcard == NULL) || (string == NULL) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(length != NULL) {
+			*length = 0;
+		}
+
+		return NULL;
+	}
+
+	*length = 0;
+
+	if((key = normalizeString(wildcard, string, buffer, &keyLength)) == NULL) {
+		return NULL;
+	}
+
+	ids = findTerms(wildcard, key, keyLength, &idLength);
+
+	freeString(key, buffer);
+
+	if(ids != NULL) {
+		result = (char **)malloc(sizeof(char *) * idLength);
+
+		for(ii = 0; ii < idLength; ii++) {
+			term = wildcard->terms[ids[ii]];
+			result[ii] = strndup(term->key, term->keyLength);
+		}
+
+		*length = idLength;
+
+		free(ids);
+	}
+
+	return result;
 }
 
 int *wildcardIndex_get(WildcardIndex *wildcard, char *string, int *length)
 {
-	int resultLength = 0;
-	int *result = 0;
+	int ii = 0;
+	int ref = 0;
+	int listLength = 0;
+	int *result = NULL;
 
-	IntegerArray *entry = NULL;
+	PostingList **entries = NULL;
 
 	if((wildcard == NULL) || (string == NULL) || (length == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -309,32 +917,65 @@ int *wildcardIndex_get(WildcardIndex *wildcard, char *string, int *length)
 
 	*length = 0;
 
-	wildcard->ticks += 1;
+	if((entries = findPostings(wildcard, string, &listLength, &ref)) ==
+			NULL) {
+		return NULL;
+	}
 
-	if((updateWorkspace(wildcard, string) < 0) ||
-			(wildcard->workspaceLength < wildcard->minStringLength) ||
-			(wildcard->workspaceLength > wildcard->maxStringLength)) {
-		if(EXPLICIT_ERRORS) {
-			fprintf(stderr, "[%s():%i] error - normalized string length %i is "
-					"out-of-bounds.\n", __FUNCTION__, __LINE__,
-					wildcard->workspaceLength);
+	if(listLength == 1) {
+		result = posting_toArray(entries[0], length);
+	}
+	else if(listLength > 1) {
+		result = (int *)malloc(sizeof(int) * ref);
+
+		for(ii = 0, ref = 0; ii < listLength; ii++) {
+			ref += posting_decode(entries[ii], (result + ref));
 		}
+
+		*length = uniqueUids(result, ref);
+	}
+
+	free(entries);
+
+	return result;
+}
+
+PostingView *wildcardIndex_getView(WildcardIndex *wildcard, char *string)
+{
+	int ii = 0;
+	int ref = 0;
+	int listLength = 0;
+	int *uids = NULL;
+
+	PostingView *result = NULL;
+	PostingList **entries = NULL;
+
+	if((wildcard == NULL) || (string == NULL)) {
+		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	if((bptree_get(&wildcard->index, wildcard->workspace,
-					wildcard->workspaceLength, ((void *)&entry)) < 0) ||
-			(entry == NULL)) {
+	if((entries = findPostings(wildcard, string, &listLength, &ref)) ==
+			NULL) {
 		return NULL;
 	}
 
-	resultLength = entry->length;
+	// a single matching term is shared as it is, a union is built once
 
-	result = (int *)malloc(sizeof(int) * resultLength);
+	if(listLength == 1) {
+		result = posting_getView(entries[0]);
+	}
+	else if(listLength > 1) {
+		uids = (int *)malloc(sizeof(int) * ref);
+
+		for(ii = 0, ref = 0; ii < listLength; ii++) {
+			ref += posting_decode(entries[ii], (uids + ref));
+		}
 
-	memcpy(result, entry->array, (int)(sizeof(int) * resultLength));
+		result = posting_newView(uids, uniqueUids(uids, ref));
+	}
 
-	*length = resultLength;
+	free(entries);
 
 	return result;
 }
@@ -343,8 +984,12 @@ int wildcardIndex_put(WildcardIndex *wildcard, int type, char *string,
 		int index)
 {
 	int result = 0;
+	int keyLength = 0;
+	char *key = NULL;
+	char buffer[WILDCARD_INDEX_STRING_LENGTH];
 
-	IntegerArray *entry = NULL;
+	PostingList *entry = NULL;
+	WildcardIndexTerm *term = NULL;
 
 	if((wildcard == NULL) ||
 			((type != WILDCARD_INDEX_TYPE_STANDARD) &&
@@ -356,46 +1001,49 @@ int wildcardIndex_put(WildcardIndex *wildcard, int type, char *string,
 
 	wildcard->ticks += 1;
 
-	if((updateWorkspace(wildcard, string) < 0) ||
-			(wildcard->workspaceLength < wildcard->minStringLength) ||
-			(wildcard->workspaceLength > wildcard->maxStringLength)) {
-		if(EXPLICIT_ERRORS) {
-			fprintf(stderr, "[%s():%i] error - normalized string length %i is "
-					"out-of-bounds.\n", __FUNCTION__, __LINE__,
-					wildcard->workspaceLength);
-		}
+	if((key = normalizeString(wildcard, string, buffer, &keyLength)) == NULL) {
 		return -1;
 	}
 
-	if(bptree_get(&wildcard->index, wildcard->workspace,
-				wildcard->workspaceLength, ((void *)&entry)) < 0) {
-		if((entry = integer_new()) == NULL) {
+	if(bptree_get(&wildcard->index, key, keyLength, ((void *)&entry)) < 0) {
+		if((entry = posting_new()) == NULL) {
+			freeString(key, buffer);
 			return -1;
 		}
 
-		if(integer_put(entry, index) == 0) {
-			if(bptree_put(&wildcard->index, wildcard->workspace,
-						wildcard->workspaceLength, (void *)entry) < 0) {
-				return -1;
-			}
+		if((posting_put(entry, index) < 0) ||
+				(bptree_put(&wildcard->index, key, keyLength,
+							(void *)entry) < 0)) {
+			posting_freePtr(entry);
+			freeString(key, buffer);
+			return -1;
 		}
-		else {
-			integer_freePtr(entry);
+
+		if((term = getTerm(wildcard, key, keyLength, atrue)) == NULL) {
+			freeString(key, buffer);
 			return -1;
 		}
+
+		term->references += 1;
+		term->uids = entry;
 	}
 	else {
-		if(integer_put(entry, index) < 0) {
+		// as it always has, an exact put of an indexed UID is not an error
+
+		if((posting_put(entry, index) < 0) &&
+				(type == WILDCARD_INDEX_TYPE_STANDARD)) {
 			result = -1;
 		}
-	}
 
-	if(type == WILDCARD_INDEX_TYPE_EXACT) {
-		return 0;
+		term = getTerm(wildcard, key, keyLength, afalse);
 	}
 
-	if(updateWildcardEntry(wildcard, index, atrue) < 0) {
-		return -1;
+	freeString(key, buffer);
+
+	if((type == WILDCARD_INDEX_TYPE_STANDARD) && (term != NULL)) {
+		if(setWildcardTerm(wildcard, term) < 0) {
+			return -1;
+		}
 	}
 
 	return result;
@@ -403,7 +1051,13 @@ int wildcardIndex_put(WildcardIndex *wildcard, int type, char *string,
 
 int wildcardIndex_remove(WildcardIndex *wildcard, char *string, int index)
 {
-	IntegerArray *entry = NULL;
+	int result = 0;
+	int keyLength = 0;
+	char *key = NULL;
+	char buffer[WILDCARD_INDEX_STRING_LENGTH];
+
+	PostingList *entry = NULL;
+	WildcardIndexTerm *term = NULL;
 
 	if((wildcard == NULL) || (string == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -412,30 +1066,73 @@ int wildcardIndex_remove(WildcardIndex *wildcard, char *string, int index)
 
 	wildcard->ticks += 1;
 
-	if((updateWorkspace(wildcard, string) < 0) ||
-			(wildcard->workspaceLength < wildcard->minStringLength) ||
-			(wildcard->workspaceLength > wildcard->maxStringLength)) {
-		if(EXPLICIT_ERRORS) {
-			fprintf(stderr, "[%s():%i] error - normalized string length %i is "
-					"out-of-bounds.\n", __FUNCTION__, __LINE__,
-					wildcard->workspaceLength);
-		}
+	if((key = normalizeString(wildcard, string, buffer, &keyLength)) == NULL) {
 		return -1;
 	}
 
-	if(bptree_get(&wildcard->index, wildcard->workspace,
-				wildcard->workspaceLength, ((void *)&entry)) == 0) {
-		if(integer_remove(entry, index) < 0) {
-			return -1;
+	if(bptree_get(&wildcard->index, key, keyLength, ((void *)&entry)) == 0) {
+		if(posting_remove(entry, index) < 0) {
+			result = -1;
 		}
 		else if(entry->length == 0) {
-			if(bptree_remove(&wildcard->index, wildcard->workspace,
-						wildcard->workspaceLength) < 0) {
-				return -1;
+			if((term = getTerm(wildcard, key, keyLength, afalse)) != NULL) {
+				term->uids = NULL;
+			}
+
+			if(bptree_remove(&wildcard->index, key, keyLength) < 0) {
+				result = -1;
+			}
+			else if(term != NULL) {
+				releaseTerm(wildcard, term);
 			}
 		}
 	}
 
-	return updateWildcardEntry(wildcard, index, afalse);
+	freeString(key, buffer);
+
+	return result;
+}
+
+int wildcardIndex_putTerm(WildcardIndex *wildcard, char *key, int keyLength)
+{
+	WildcardIndexTerm *term = NULL;
+
+	if((wildcard == NULL) || (key == NULL) || (keyLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	/*
+	 * note: the key of a term held elsewhere, e.g. in an index segment, is
+	 * already normalized, and is added to the dictionary (and grams) without
+	 * any UIDs, so that wildcard searches find it
+	 */
+
+	if((term = getTerm(wildcard, key, keyLength, atrue)) == NULL) {
+		return -1;
+	}
+
+	term->references += 1;
+
+	return setWildcardTerm(wildcard, term);
+}
+
+int wildcardIndex_removeTerm(WildcardIndex *wildcard, char *key,
+		int keyLength)
+{
+	WildcardIndexTerm *term = NULL;
+
+	if((wildcard == NULL) || (key == NULL) || (keyLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((term = getTerm(wildcard, key, keyLength, afalse)) == NULL) {
+		return -1;
+	}
+
+	releaseTerm(wildcard, term);
+
+	return 0;
 }
 
@@ -32,16 +32,46 @@ typedef enum _WildcardIndexTypes {
 	WILDCARD_INDEX_TYPE_UNKNOWN = -1
 } WildcardIndexTypes;
 
+#define WILDCARD_INDEX_GRAM_LENGTH						3
+
+#define WILDCARD_INDEX_DEFAULT_TERM_LENGTH				1024
+
+#define WILDCARD_INDEX_STRING_LENGTH					256
+
 
 // define wildcard index public data types
 
+/*
+ * Each distinct normalized string is a term, with its UIDs in the index tree.
+ * The terms put for wildcard searches are also split into the grams of the
+ * term bounded by '^' and '$', each of which holds the ids of its terms, so
+ * that a prefix or suffix is found by intersecting the postings of its grams
+ * and verifying the candidate terms. A term's UIDs are shared with the index
+ * tree, and are NULL for a term only held elsewhere (e.g. in an index
+ * segment). Lookups only read the index.
+ */
+
+typedef struct _WildcardIndexTerm {
+	aboolean isWildcard;
+	int id;
+	int references;
+	int keyLength;
+	char *key;
+	PostingList *uids;
+} WildcardIndexTerm;
+
 typedef struct _WildcardIndex {
 	int minStringLength;
 	int maxStringLength;
+	int termLength;
+	int termAllocated;
+	int freeIdLength;
+	int *freeIds;
 	alint ticks;
-	int workspaceLength;
-	char *workspace;
+	WildcardIndexTerm **terms;
 	Bptree index;
+	Bptree dictionary;
+	Bptree grams;
 } WildcardIndex;
 
 
@@ -58,16 +88,31 @@ int wildcardIndex_getIndexCount(WildcardIndex *wildcard);
 
 int wildcardIndex_getIndexDepth(WildcardIndex *wildcard);
 
+int wildcardIndex_getGramCount(WildcardIndex *wildcard);
+
 int wildcardIndex_setStringThresholds(WildcardIndex *wildcard,
 		int minStringLength, int maxStringLength);
 
+char *wildcardIndex_buildKey(WildcardIndex *wildcard, char *string,
+		int *keyLength);
+
+char **wildcardIndex_getTerms(WildcardIndex *wildcard, char *string,
+		int *length);
+
 int *wildcardIndex_get(WildcardIndex *wildcard, char *string, int *length);
 
+PostingView *wildcardIndex_getView(WildcardIndex *wildcard, char *string);
+
 int wildcardIndex_put(WildcardIndex *wildcard, int type, char *string,
 		int index);
 
 int wildcardIndex_remove(WildcardIndex *wildcard, char *string, int index);
 
+int wildcardIndex_putTerm(WildcardIndex *wildcard, char *key, int keyLength);
+
+int wildcardIndex_removeTerm(WildcardIndex *wildcard, char *key,
+		int keyLength);
+
 
 #if defined(__cplusplus)
 };
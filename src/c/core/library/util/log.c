@@ -17,6 +17,360 @@
 #include "core/library/util/log.h"
 
 
+// declare log private functions
+
+static void *getStream(Log *log);
+
+static char *levelToLogString(int logLevel);
+
+static int asyncPut(Log *log, int logLevel, const char *format,
+		va_list vaArgs);
+
+static void asyncWrite(Log *log, void *stream, char *batch, int length);
+
+static void asyncRotate(Log *log);
+
+static int asyncDrain(Log *log, char *batch);
+
+static void *asyncWriter(void *argument);
+
+
+// define log private functions
+
+static void *getStream(Log *log)
+{
+	void *result = NULL;
+
+	switch(log->output) {
+		case LOG_OUTPUT_STDERR:
+			result = stderr;
+			break;
+
+		case LOG_OUTPUT_FILE:
+			result = log->fh.fd;
+			break;
+
+		case LOG_OUTPUT_STDOUT:
+		default:
+			result = stdout;
+	}
+
+	return result;
+}
+
+static char *levelToLogString(int logLevel)
+{
+	char *result = NULL;
+
+	switch(logLevel) {
+		case LOG_LEVEL_DEBUG:
+			result = "DEBUG";
+			break;
+
+		case LOG_LEVEL_INFO:
+			result = "INFO";
+			break;
+
+		case LOG_LEVEL_FINE:
+			result = "FINE";
+			break;
+
+		case LOG_LEVEL_WARNING:
+			result = "WARNING";
+			break;
+
+		case LOG_LEVEL_ERROR:
+			result = "ERROR";
+			break;
+
+		case LOG_LEVEL_SEVERE:
+			result = "SEVERE";
+			break;
+
+		case LOG_LEVEL_PANIC:
+			result = "PANIC";
+			break;
+
+		default:
+			result = "UNKNOWN";
+	}
+
+	return result;
+}
+
+static int asyncPut(Log *log, int logLevel, const char *format,
+		va_list vaArgs)
+{
+	int threadId = 0;
+	int length = 0;
+	unsigned int mask = 0;
+	unsigned int position = 0;
+	unsigned int sequence = 0;
+
+	va_list vaCopy;
+
+	LogAsync *async = NULL;
+	LogRing *ring = NULL;
+	LogRecord *record = NULL;
+
+	async = log->async;
+
+	thread_self(&threadId);
+
+	ring = &async->rings[(atomic_getThreadStripe() % LOG_ASYNC_RING_COUNT)];
+
+	mask = (unsigned int)(async->ringLength - 1);
+
+	/*
+	 * A record is free to claim when its sequence equals the ring position,
+	 * and ready to write once its sequence is one past it; the writer hands
+	 * it back by advancing its sequence a full ring ahead.
+	 */
+
+	while(atrue) {
+		position = *((volatile unsigned int *)&ring->head);
+		record = &ring->records[(position & mask)];
+		sequence = *((volatile unsigned int *)&record->sequence);
+
+		if(sequence == position) {
+			if(atomic_compareInt((int *)&ring->head, (int)position,
+						(int)(position + 1))) {
+				break;
+			}
+		}
+		else if((int)(sequence - position) < 0) {
+			if(async->overflow == LOG_OVERFLOW_DROP) {
+				atomic_addAlint(&async->droppedCount, 1);
+				return 0;
+			}
+
+			time_usleep(LOG_ASYNC_IDLE_MICROSECONDS);
+		}
+	}
+
+	record->level = logLevel;
+	record->threadId = threadId;
+	record->heapMessage = NULL;
+
+	time_getTimestamp(record->timestamp);
+
+	va_copy(vaCopy, vaArgs);
+
+	length = vsnprintf(record->message, LOG_ASYNC_MESSAGE_LENGTH, format,
+			vaArgs);
+
+	if(length >= LOG_ASYNC_MESSAGE_LENGTH) {
+		record->heapMessage = vaprintf(format, vaCopy, &length);
+	}
+	else if(length < 0) {
+		length = 0;
+		record->message[0] = '\0';
+	}
+
+	va_end(vaCopy);
+
+	record->length = length;
+
+	atomic_barrier();
+
+	record->sequence = (position + 1);
+
+	atomic_addAlint(&async->publishedCount, 1);
+
+	return 0;
+}
+
+static void asyncWrite(Log *log, void *stream, char *batch, int length)
+{
+	if(length < 1) {
+		return;
+	}
+
+	fwrite(batch, 1, length, (FILE *)stream);
+
+	log->async->fileLength += (alint)length;
+}
+
+static void asyncRotate(Log *log)
+{
+	aboolean exists = afalse;
+	int ii = 0;
+	int seconds = 0;
+	int rotatedLength = 0;
+	char *filename = NULL;
+	char *rotated = NULL;
+
+	LogAsync *async = NULL;
+
+	async = log->async;
+	seconds = time_getTimeSeconds();
+
+	if((log->output != LOG_OUTPUT_FILE) || (log->fh.filename == NULL) ||
+			(((async->rotateFileLength < 1) ||
+			  (async->fileLength < async->rotateFileLength)) &&
+			 ((async->rotateSeconds < 1) ||
+			  ((seconds - async->openedSeconds) < async->rotateSeconds)))) {
+		return;
+	}
+
+	// rename the current file after the time of rotation, and reopen it
+
+	filename = strdup(log->fh.filename);
+
+	rotatedLength = (strlen(filename) + 32);
+	rotated = (char *)malloc(sizeof(char) * rotatedLength);
+
+	snprintf(rotated, rotatedLength, "%s.%i", filename, seconds);
+
+	for(ii = 1, system_fileExists(rotated, &exists); exists; ii++) {
+		snprintf(rotated, rotatedLength, "%s.%i.%i", filename, seconds, ii);
+		system_fileExists(rotated, &exists);
+	}
+
+	file_free(&log->fh);
+
+	system_fileMove(filename, rotated);
+
+	if(file_init(&log->fh, filename, "ab", 524288) < 0) {
+		file_free(&log->fh);
+		log->output = LOG_OUTPUT_STDOUT;
+	}
+
+	async->fileLength = 0;
+	async->openedSeconds = seconds;
+
+	free(rotated);
+	free(filename);
+}
+
+static int asyncDrain(Log *log, char *batch)
+{
+	int ii = 0;
+	int count = 0;
+	int length = 0;
+	int batchLength = 0;
+	char *message = NULL;
+	void *stream = NULL;
+
+	LogAsync *async = NULL;
+	LogRing *ring = NULL;
+	LogRecord *record = NULL;
+
+	async = log->async;
+
+	mutex_lock(&async->mutex);
+
+	stream = getStream(log);
+
+	for(ii = 0; ii < LOG_ASYNC_RING_COUNT; ii++) {
+		ring = &async->rings[ii];
+
+		while(atrue) {
+			record = &ring->records[(ring->tail &
+					(unsigned int)(async->ringLength - 1))];
+
+			if(*((volatile unsigned int *)&record->sequence) !=
+					(ring->tail + 1)) {
+				break;
+			}
+
+			atomic_barrier();
+
+			if(record->heapMessage != NULL) {
+				message = record->heapMessage;
+			}
+			else {
+				message = record->message;
+			}
+
+			// the header is at most 64 bytes, flush the batch rather than
+			// split a line across writes
+
+			if((batchLength + record->length + 64) > LOG_ASYNC_BATCH_LENGTH) {
+				asyncWrite(log, stream, batch, batchLength);
+				batchLength = 0;
+			}
+
+			if((record->length + 64) > LOG_ASYNC_BATCH_LENGTH) {
+				length = fprintf((FILE *)stream, "[%s] (%u) {%s} %s\n",
+						record->timestamp, (unsigned int)record->threadId,
+						levelToLogString(record->level), message);
+
+				if(length > 0) {
+					async->fileLength += (alint)length;
+				}
+			}
+			else {
+				batchLength += snprintf((batch + batchLength),
+						(LOG_ASYNC_BATCH_LENGTH - batchLength),
+						"[%s] (%u) {%s} %s\n", record->timestamp,
+						(unsigned int)record->threadId,
+						levelToLogString(record->level), message);
+			}
+
+			if(record->heapMessage != NULL) {
+				free(record->heapMessage);
+				record->heapMessage = NULL;
+			}
+
+			atomic_barrier();
+
+			record->sequence = (ring->tail + (unsigned int)async->ringLength);
+			ring->tail += 1;
+			count++;
+		}
+	}
+
+	asyncWrite(log, stream, batch, batchLength);
+
+	if(count > 0) {
+		fflush((FILE *)stream);
+
+		atomic_addAlint(&async->writtenCount, (alint)count);
+	}
+
+	asyncRotate(log);
+
+	mutex_unlock(&async->mutex);
+
+	return count;
+}
+
+static void *asyncWriter(void *argument)
+{
+	aboolean isRunning = afalse;
+	char *batch = NULL;
+
+	Log *log = NULL;
+
+	log = (Log *)argument;
+
+	batch = (char *)malloc(sizeof(char) * LOG_ASYNC_BATCH_LENGTH);
+
+	// keep draining until a pass after the log is stopped finds nothing
+
+	while(atrue) {
+		isRunning = *((volatile aboolean *)&log->async->isRunning);
+
+		atomic_barrier();
+
+		if(asyncDrain(log, batch) > 0) {
+			continue;
+		}
+
+		if(!isRunning) {
+			break;
+		}
+
+		time_usleep(LOG_ASYNC_IDLE_MICROSECONDS);
+	}
+
+	free(batch);
+
+	return NULL;
+}
+
+
 // define log public functions
 
 int log_init(Log *log, int logOutput, char *filename, int logLevel)
@@ -76,6 +430,12 @@ int log_free(Log *log)
 		return -1;
 	}
 
+	// every message logged so far is written before the output is closed
+
+	if(log->async != NULL) {
+		log_disableAsync(log);
+	}
+
 	switch(log->output) {
 		case LOG_OUTPUT_NULL:
 		case LOG_OUTPUT_UNKNOWN:
@@ -300,6 +660,11 @@ int log_setOutput(Log *log, int logOutput, char *filename)
 		return -1;
 	}
 
+	if(log->async != NULL) {
+		log_flush(log);
+		mutex_lock(&log->async->mutex);
+	}
+
 	if(log->output == LOG_OUTPUT_FILE) {
 		file_free(&log->fh);
 	}
@@ -317,10 +682,24 @@ int log_setOutput(Log *log, int logOutput, char *filename)
 			}
 			file_free(&log->fh);
 			log->output = LOG_OUTPUT_STDOUT;
-			return -1;
 		}
 	}
 
+	if(log->async != NULL) {
+		log->async->fileLength = 0;
+		log->async->openedSeconds = time_getTimeSeconds();
+
+		if(log->output == LOG_OUTPUT_FILE) {
+			log->async->fileLength = file_getFileLengthOnFilename(filename);
+		}
+
+		mutex_unlock(&log->async->mutex);
+	}
+
+	if(rc < 0) {
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -360,6 +739,20 @@ int log_logf(Log *log, int logLevel, const char *format, ...)
 		output = log->output;
 		isFlushOutput = log->isFlushOutput;
 		isPeriodicFlush = log->isPeriodicFlush;
+
+		// the writer thread flushes each batch, a panic waits for it
+
+		if(log->async != NULL) {
+			va_start(vaArgs, format);
+			asyncPut(log, logLevel, format, vaArgs);
+			va_end(vaArgs);
+
+			if(logLevel == LOG_LEVEL_PANIC) {
+				log_flush(log);
+			}
+
+			return 0;
+		}
 	}
 
 	va_start(vaArgs, format);
@@ -388,38 +781,7 @@ int log_logf(Log *log, int logLevel, const char *format, ...)
 			stream = stdout;
 	}
 
-	switch(logLevel) {
-		case LOG_LEVEL_DEBUG:
-			logLevelString = "DEBUG";
-			break;
-
-		case LOG_LEVEL_INFO:
-			logLevelString = "INFO";
-			break;
-
-		case LOG_LEVEL_FINE:
-			logLevelString = "FINE";
-			break;
-
-		case LOG_LEVEL_WARNING:
-			logLevelString = "WARNING";
-			break;
-
-		case LOG_LEVEL_ERROR:
-			logLevelString = "ERROR";
-			break;
-
-		case LOG_LEVEL_SEVERE:
-			logLevelString = "SEVERE";
-			break;
-
-		case LOG_LEVEL_PANIC:
-			logLevelString = "PANIC";
-			break;
-
-		default:
-			logLevelString = "UNKNOWN";
-	}
+	logLevelString = levelToLogString(logLevel);
 
 	time_getTimestamp(timestamp);
 	thread_self(&threadId);
@@ -455,6 +817,7 @@ int log_logf(Log *log, int logLevel, const char *format, ...)
 
 int log_flush(Log *log)
 {
+	alint target = 0;
 	void *stream = NULL;
 
 	LogOutput output = LOG_OUTPUT_STDOUT;
@@ -464,6 +827,23 @@ int log_flush(Log *log)
 			return 0;
 		}
 
+		// wait for the writer thread to catch up with every message logged
+		// before the flush
+
+		if(log->async != NULL) {
+			target = *((volatile alint *)&log->async->publishedCount);
+
+			while(*((volatile alint *)&log->async->writtenCount) < target) {
+				time_usleep(LOG_ASYNC_IDLE_MICROSECONDS);
+			}
+
+			mutex_lock(&log->async->mutex);
+			fflush((FILE *)getStream(log));
+			mutex_unlock(&log->async->mutex);
+
+			return 0;
+		}
+
 		output = log->output;
 	}
 
@@ -496,3 +876,171 @@ int log_flush(Log *log)
 	return 0;
 }
 
+aboolean log_isAsync(Log *log)
+{
+	if(log == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	return (aboolean)(log->async != NULL);
+}
+
+int log_enableAsync(Log *log, int ringLength, LogOverflow overflow)
+{
+	int ii = 0;
+	int nn = 0;
+
+	LogAsync *async = NULL;
+
+	if((log == NULL) ||
+			((overflow != LOG_OVERFLOW_DROP) &&
+			 (overflow != LOG_OVERFLOW_BLOCK))) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+#if defined(__ANDROID__)
+	return -1;
+#endif // __ANDROID__
+
+	if(log->async != NULL) {
+		log_disableAsync(log);
+	}
+
+	async = (LogAsync *)malloc(sizeof(LogAsync));
+
+	memset(async, 0, (int)(sizeof(LogAsync)));
+
+	// the rings are indexed by mask, so their length is a power of two
+
+	async->ringLength = 2;
+
+	while(async->ringLength < ringLength) {
+		async->ringLength *= 2;
+	}
+
+	if(ringLength < 1) {
+		async->ringLength = LOG_ASYNC_DEFAULT_RING_LENGTH;
+	}
+
+	async->isRunning = atrue;
+	async->rotateSeconds = 0;
+	async->openedSeconds = time_getTimeSeconds();
+	async->rotateFileLength = 0;
+	async->fileLength = 0;
+	async->publishedCount = 0;
+	async->writtenCount = 0;
+	async->droppedCount = 0;
+	async->overflow = overflow;
+
+	if((log->output == LOG_OUTPUT_FILE) && (log->fh.filename != NULL)) {
+		fflush(log->fh.fd);
+		async->fileLength = file_getFileLengthOnFilename(log->fh.filename);
+	}
+
+	for(ii = 0; ii < LOG_ASYNC_RING_COUNT; ii++) {
+		async->rings[ii].head = 0;
+		async->rings[ii].tail = 0;
+		async->rings[ii].records = (LogRecord *)malloc(sizeof(LogRecord) *
+				async->ringLength);
+
+		for(nn = 0; nn < async->ringLength; nn++) {
+			async->rings[ii].records[nn].sequence = (unsigned int)nn;
+			async->rings[ii].records[nn].heapMessage = NULL;
+		}
+	}
+
+	mutex_init(&async->mutex);
+	thread_init(&async->thread);
+
+	log->async = async;
+
+	if(thread_create(&async->thread, asyncWriter, (void *)log) < 0) {
+		log->async = NULL;
+
+		for(ii = 0; ii < LOG_ASYNC_RING_COUNT; ii++) {
+			free(async->rings[ii].records);
+		}
+
+		mutex_free(&async->mutex);
+		free(async);
+
+		return -1;
+	}
+
+	return 0;
+}
+
+int log_disableAsync(Log *log)
+{
+	int ii = 0;
+	void *exitValue = NULL;
+
+	LogAsync *async = NULL;
+
+	if(log == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if((async = log->async) == NULL) {
+		return 0;
+	}
+
+	// the writer drains every ring before it exits
+
+	async->isRunning = afalse;
+
+	atomic_barrier();
+
+	thread_join(&async->thread, &exitValue);
+
+	log->async = NULL;
+
+	for(ii = 0; ii < LOG_ASYNC_RING_COUNT; ii++) {
+		free(async->rings[ii].records);
+	}
+
+	mutex_free(&async->mutex);
+	free(async);
+
+	return 0;
+}
+
+int log_setRotation(Log *log, alint maxFileLength, int maxFileSeconds)
+{
+	if((log == NULL) || (maxFileLength < 0) || (maxFileSeconds < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	// files are only rotated by the asynchronous writer
+
+	if(log->async == NULL) {
+		return -1;
+	}
+
+	mutex_lock(&log->async->mutex);
+
+	log->async->rotateFileLength = maxFileLength;
+	log->async->rotateSeconds = maxFileSeconds;
+
+	mutex_unlock(&log->async->mutex);
+
+	return 0;
+}
+
+alint log_getDroppedCount(Log *log)
+{
+	if(log == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(log->async == NULL) {
+		return 0;
+	}
+
+	return *((volatile alint *)&log->async->droppedCount);
+}
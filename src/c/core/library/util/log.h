@@ -44,9 +44,65 @@ typedef enum _LogOutput {
 	LOG_OUTPUT_UNKNOWN = -1
 } LogOutput;
 
+typedef enum _LogOverflow {
+	LOG_OVERFLOW_DROP = 1,
+	LOG_OVERFLOW_BLOCK,
+	LOG_OVERFLOW_UNKNOWN = -1
+} LogOverflow;
+
+#define LOG_ASYNC_RING_COUNT						16
+
+#define LOG_ASYNC_DEFAULT_RING_LENGTH				256
+
+#define LOG_ASYNC_MESSAGE_LENGTH					464
+
+#define LOG_ASYNC_BATCH_LENGTH						65536
+
+#define LOG_ASYNC_IDLE_MICROSECONDS					1000
+
 
 // define log public data types
 
+/*
+ * In asynchronous mode each message is formatted by the calling thread into
+ * a record in one of several bounded rings, chosen by thread, which callers
+ * claim with a compare-and-swap. A single writer thread drains the rings in
+ * batches, and is the only thread to write to, flush, or rotate the output.
+ * Messages longer than a record are kept on the heap.
+ */
+
+typedef struct _LogRecord {
+	unsigned int sequence;
+	int level;
+	int threadId;
+	int length;
+	char *heapMessage;
+	char timestamp[32];
+	char message[LOG_ASYNC_MESSAGE_LENGTH];
+} LogRecord;
+
+typedef struct _LogRing {
+	unsigned int head;
+	unsigned int tail;
+	LogRecord *records;
+} LogRing;
+
+typedef struct _LogAsync {
+	aboolean isRunning;
+	int ringLength;
+	int rotateSeconds;
+	int openedSeconds;
+	alint rotateFileLength;
+	alint fileLength;
+	alint publishedCount;
+	alint writtenCount;
+	alint droppedCount;
+	LogOverflow overflow;
+	LogRing rings[LOG_ASYNC_RING_COUNT];
+	Mutex mutex;
+	Thread thread;
+} LogAsync;
+
 typedef struct _Log {
 	aboolean isFlushOutput;
 	aboolean isPeriodicFlush;
@@ -55,6 +111,7 @@ typedef struct _Log {
 	LogLevel level;
 	LogOutput output;
 	FileHandle fh;
+	LogAsync *async;
 } Log;
 
 
@@ -91,6 +148,16 @@ int log_setOutput(Log *log, int logOutput, char *filename);
 
 int log_logf(Log *log, int logLevel, const char *format, ...);
 
+aboolean log_isAsync(Log *log);
+
+int log_enableAsync(Log *log, int ringLength, LogOverflow overflow);
+
+int log_disableAsync(Log *log);
+
+int log_setRotation(Log *log, alint maxFileLength, int maxFileSeconds);
+
+alint log_getDroppedCount(Log *log);
+
 int log_flush(Log *log);
 
 
@@ -15,50 +15,539 @@
 #define _CORE_LIBRARY_TYPES_COMPONENT
 #include "core/library/util/pfs.h"
 
+#if defined(__linux__) || defined(__APPLE__)
+#	include <errno.h>
+#	include <signal.h>
+#	include <sys/time.h>
+#endif // __linux__ || __APPLE__
+
+// define pfs private data types
+
+typedef struct _PfsAggregate {
+	const char *file;
+	const char *function;
+	alint calls;
+	alint samples;
+	alint totalMus;
+	alint selfMus;
+	alint maxMus;
+} PfsAggregate;
+
+// define pfs private global variables
+
+/*
+ * The profiling timer, and its signal, are process-wide, so that only one
+ * profiler may be sampling at a time.
+ */
+
+static Pfs *samplingPfs = NULL;
+
+#if defined(__linux__) || defined(__APPLE__)
+static struct sigaction samplingPreviousAction;
+#endif // __linux__ || __APPLE__
+
 // define pfs private functions
 
-static void buildKey(const char *file, const char *function, char key[1024],
-		int *keyLength)
+static PfsThread *getThread(Pfs *pfs, aboolean isCreate)
 {
-	*keyLength = snprintf(key, 1024, "p/%s/%s", (char *)file,
-			(char *)function);
+	int ii = 0;
+	int threadId = 0;
+	unsigned int hash = 0;
+
+	PfsThread *thread = NULL;
+
+	thread_self(&threadId);
+
+	hash = atomic_getThreadStripe();
+
+	for(ii = 0; ii < PFS_THREAD_LENGTH; ii++) {
+		thread = &pfs->threads[((hash + (unsigned int)ii) %
+				PFS_THREAD_LENGTH)];
+
+		if(thread->isReady) {
+			if(thread->threadId == threadId) {
+				return thread;
+			}
+			continue;
+		}
+
+		if(!thread->isClaimed) {
+			if(!isCreate) {
+				return NULL;
+			}
+
+			if(!atomic_compareInt(&thread->isClaimed, 0, 1)) {
+				continue;
+			}
+
+			// only the claiming thread allocates, and thereafter writes,
+			// the buffer
+
+			thread->threadId = threadId;
+			thread->depth = 0;
+			thread->nodeCount = 0;
+
+			thread->table = (int *)malloc(sizeof(int) *
+					PFS_THREAD_TABLE_LENGTH);
+			thread->nodes = (PfsNode *)malloc(sizeof(PfsNode) *
+					PFS_THREAD_NODE_LENGTH);
+
+			memset(thread->table, 0,
+					(int)(sizeof(int) * PFS_THREAD_TABLE_LENGTH));
+
+			atomic_barrier();
+
+			thread->isReady = atrue;
+
+			return thread;
+		}
+	}
+
+	return NULL;
 }
 
-static PfsEntry *newEntry(const char *file, const char *function)
+static int getNode(PfsThread *thread, int parent, const char *file,
+		const char *function)
 {
-	PfsEntry *result = NULL;
+	int ii = 0;
+	int ref = 0;
+	int result = 0;
+	unsigned int hash = 0;
+
+	PfsNode *node = NULL;
+
+	hash = (((unsigned int)((aptrcast)function >> 3) * 2654435761U) ^
+			((unsigned int)(parent + 1) * 40503U));
+
+	for(ii = 0; ii < PFS_THREAD_TABLE_LENGTH; ii++) {
+		ref = (int)((hash + (unsigned int)ii) % PFS_THREAD_TABLE_LENGTH);
+
+		if(thread->table[ref] == 0) {
+			break;
+		}
+
+		node = &thread->nodes[(thread->table[ref] - 1)];
+
+		if((node->parent == parent) && (node->function == function) &&
+				(node->file == file)) {
+			return (thread->table[ref] - 1);
+		}
+	}
+
+	if((ii >= PFS_THREAD_TABLE_LENGTH) ||
+			(thread->nodeCount >= PFS_THREAD_NODE_LENGTH)) {
+		return -1;
+	}
+
+	result = thread->nodeCount;
+
+	node = &thread->nodes[result];
 
-	result = (PfsEntry *)malloc(sizeof(PfsEntry));
+	memset(node, 0, (int)(sizeof(PfsNode)));
 
-	result->ticks = 0;
-	result->file = strdup((char *)file);
-	result->function = strdup((char *)function);
+	node->parent = parent;
+	node->file = file;
+	node->function = function;
+
+	thread->table[ref] = (result + 1);
+
+	// publish the node to the report only once it is complete
+
+	atomic_barrier();
+
+	thread->nodeCount += 1;
 
 	return result;
 }
 
-static void freeEntry(void *memory)
+static int getParentNode(PfsThread *thread)
 {
-	PfsEntry *entry = NULL;
+	if(thread->depth < 1) {
+		return -1;
+	}
+
+	if(thread->depth > PFS_SCOPE_MAX_DEPTH) {
+		return thread->stack[(PFS_SCOPE_MAX_DEPTH - 1)].node;
+	}
+
+	return thread->stack[(thread->depth - 1)].node;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+static void handleSamplingSignal(int signalNumber)
+{
+	int node = 0;
+	int errorNumber = 0;
+
+	Pfs *pfs = NULL;
+	PfsThread *thread = NULL;
+
+	// attribute the sample to the innermost scope of the interrupted thread,
+	// without allocating or locking
+
+	errorNumber = errno;
+
+	if((pfs = samplingPfs) != NULL) {
+		if((thread = getThread(pfs, afalse)) == NULL) {
+			atomic_addAlint(&pfs->samples, 1);
+		}
+		else if((node = getParentNode(thread)) >= 0) {
+			thread->nodes[node].samples += 1;
+		}
+		else {
+			thread->samples += 1;
+		}
+	}
+
+	errno = errorNumber;
+}
+#endif // __linux__ || __APPLE__
 
+static void freeAggregate(void *memory)
+{
 	if(memory == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return;
 	}
 
-	entry = (PfsEntry *)memory;
+	free(memory);
+}
+
+static int compareAggregates(const void *left, const void *right)
+{
+	PfsAggregate *leftAggregate = NULL;
+	PfsAggregate *rightAggregate = NULL;
+
+	leftAggregate = *((PfsAggregate **)left);
+	rightAggregate = *((PfsAggregate **)right);
+
+	// the most expensive scopes first
+
+	if(leftAggregate->selfMus != rightAggregate->selfMus) {
+		if(leftAggregate->selfMus > rightAggregate->selfMus) {
+			return -1;
+		}
+		return 1;
+	}
+
+	if(leftAggregate->samples != rightAggregate->samples) {
+		if(leftAggregate->samples > rightAggregate->samples) {
+			return -1;
+		}
+		return 1;
+	}
+
+	if(leftAggregate->calls > rightAggregate->calls) {
+		return -1;
+	}
+	else if(leftAggregate->calls < rightAggregate->calls) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static char *buildFlatReport(Pfs *pfs, int *reportLength)
+{
+	int ii = 0;
+	int nn = 0;
+	int keyLength = 0;
+	int nodeCount = 0;
+	int threadId = 0;
+	int resultRef = 0;
+	int resultLength = 0;
+	int arrayLength = 0;
+	int bufferLength = 0;
+	int *keyLengths = NULL;
+	alint samples = 0;
+	alint droppedCount = 0;
+	char key[1024];
+	char buffer[2048];
+	char *result = NULL;
+	char **keys = NULL;
+	void **values = NULL;
+
+	Bptree index;
+	PfsNode *node = NULL;
+	PfsThread *thread = NULL;
+	PfsAggregate *aggregate = NULL;
+
+	bptree_init(&index);
+	bptree_setFreeFunction(&index, freeAggregate);
+
+	samples = pfs->samples;
+	droppedCount = pfs->droppedCount;
+
+	// aggregate the calling contexts of every thread by scope
+
+	for(ii = 0; ii < PFS_THREAD_LENGTH; ii++) {
+		thread = &pfs->threads[ii];
+
+		if(!thread->isReady) {
+			continue;
+		}
+
+		samples += thread->samples;
+		droppedCount += thread->droppedCount;
+
+		nodeCount = thread->nodeCount;
+
+		atomic_barrier();
+
+		for(nn = 0; nn < nodeCount; nn++) {
+			node = &thread->nodes[nn];
+
+			keyLength = snprintf(key, ((int)sizeof(key) - 1), "%s:%s",
+					node->file, node->function);
+
+			if(keyLength >= ((int)sizeof(key) - 1)) {
+				keyLength = ((int)sizeof(key) - 2);
+			}
+
+			if(bptree_get(&index, key, keyLength,
+						((void *)&aggregate)) < 0) {
+				aggregate = (PfsAggregate *)malloc(sizeof(PfsAggregate));
+
+				memset(aggregate, 0, (int)(sizeof(PfsAggregate)));
+
+				aggregate->file = node->file;
+				aggregate->function = node->function;
+
+				if(bptree_put(&index, key, keyLength,
+							(void *)aggregate) < 0) {
+					free(aggregate);
+					continue;
+				}
+			}
+
+			aggregate->calls += node->calls;
+			aggregate->samples += node->samples;
+			aggregate->totalMus += node->totalMus;
+			aggregate->selfMus += node->selfMus;
+
+			if(node->maxMus > aggregate->maxMus) {
+				aggregate->maxMus = node->maxMus;
+			}
+		}
+	}
+
+	if(bptree_toArray(&index, &arrayLength, &keyLengths, &keys,
+				&values) < 0) {
+		arrayLength = 0;
+	}
+
+	if(arrayLength > 1) {
+		qsort(values, arrayLength, sizeof(void *), compareAggregates);
+	}
+
+	thread_self(&threadId);
+
+	resultRef = 0;
+	resultLength = (1024 + (arrayLength * 256));
+	result = (char *)malloc(sizeof(char) * resultLength);
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"Profile-Function System Report (pid %i):\n"
+			"----------------------------------------------------------------\n"
+			"%12s %12s %12s %10s %10s  %s\n",
+			threadId, "self (s)", "total (s)", "max (s)", "calls",
+			"samples", "scope");
+
+	result = strxpndcat(result, &resultRef, &resultLength, buffer,
+			bufferLength);
+
+	for(ii = 0; ii < arrayLength; ii++) {
+		aggregate = (PfsAggregate *)values[ii];
+
+		bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+				"%12.6f %12.6f %12.6f %10lli %10lli  %s:%s()\n",
+				((double)aggregate->selfMus / REAL_ONE_MILLION),
+				((double)aggregate->totalMus / REAL_ONE_MILLION),
+				((double)aggregate->maxMus / REAL_ONE_MILLION),
+				aggregate->calls,
+				aggregate->samples,
+				aggregate->file,
+				aggregate->function);
+
+		result = strxpndcat(result, &resultRef, &resultLength, buffer,
+				bufferLength);
+	}
+
+	bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+			"----------------------------------------------------------------\n"
+			"samples outside of a scope: %lli, scopes dropped: %lli\n"
+			"\n",
+			samples, droppedCount);
+
+	result = strxpndcat(result, &resultRef, &resultLength, buffer,
+			bufferLength);
 
-	if(entry->file != NULL) {
-		free(entry->file);
+	if(keys != NULL) {
+		for(ii = 0; ii < arrayLength; ii++) {
+			free(keys[ii]);
+		}
+
+		free(keys);
 	}
 
-	if(entry->function != NULL) {
-		free(entry->function);
+	if(keyLengths != NULL) {
+		free(keyLengths);
 	}
 
-	memset(entry, 0, sizeof(PfsEntry));
+	if(values != NULL) {
+		free(values);
+	}
+
+	bptree_free(&index);
+
+	*reportLength = resultRef;
 
-	free(entry);
+	return result;
+}
+
+static char *buildCollapsedReport(Pfs *pfs, aboolean isSamples,
+		int *reportLength)
+{
+	int ii = 0;
+	int nn = 0;
+	int depth = 0;
+	int parent = 0;
+	int keyRef = 0;
+	int nodeCount = 0;
+	int resultRef = 0;
+	int resultLength = 0;
+	int arrayLength = 0;
+	int bufferLength = 0;
+	int *keyLengths = NULL;
+	alint value = 0;
+	alint samples = 0;
+	alint *weight = NULL;
+	char key[4096];
+	char buffer[4160];
+	char *result = NULL;
+	char **keys = NULL;
+	void **values = NULL;
+	const char *functions[PFS_SCOPE_MAX_DEPTH];
+
+	Bptree index;
+	PfsNode *node = NULL;
+	PfsThread *thread = NULL;
+
+	bptree_init(&index);
+	bptree_setFreeFunction(&index, freeAggregate);
+
+	samples = pfs->samples;
+
+	// one line per distinct stack, merged across threads, weighted by the
+	// self time in microseconds, or by the samples taken within it
+
+	for(ii = 0; ii < PFS_THREAD_LENGTH; ii++) {
+		thread = &pfs->threads[ii];
+
+		if(!thread->isReady) {
+			continue;
+		}
+
+		samples += thread->samples;
+
+		nodeCount = thread->nodeCount;
+
+		atomic_barrier();
+
+		for(nn = 0; nn < nodeCount; nn++) {
+			node = &thread->nodes[nn];
+
+			if(isSamples) {
+				value = node->samples;
+			}
+			else {
+				value = node->selfMus;
+			}
+
+			if(value < 1) {
+				continue;
+			}
+
+			depth = 0;
+			parent = nn;
+
+			while((parent >= 0) && (depth < PFS_SCOPE_MAX_DEPTH)) {
+				functions[depth] = thread->nodes[parent].function;
+				parent = thread->nodes[parent].parent;
+				depth++;
+			}
+
+			for(keyRef = 0; depth > 0; depth--) {
+				keyRef += snprintf((key + keyRef),
+						((int)sizeof(key) - keyRef - 1), "%s%s",
+						((keyRef > 0) ? ";" : ""), functions[(depth - 1)]);
+
+				if(keyRef >= ((int)sizeof(key) - 1)) {
+					keyRef = ((int)sizeof(key) - 2);
+					break;
+				}
+			}
+
+			if(bptree_get(&index, key, keyRef, ((void *)&weight)) < 0) {
+				weight = (alint *)malloc(sizeof(alint));
+				*weight = 0;
+
+				if(bptree_put(&index, key, keyRef, (void *)weight) < 0) {
+					free(weight);
+					continue;
+				}
+			}
+
+			*weight += value;
+		}
+	}
+
+	if(bptree_toArray(&index, &arrayLength, &keyLengths, &keys,
+				&values) < 0) {
+		arrayLength = 0;
+	}
+
+	resultRef = 0;
+	resultLength = (1024 + (arrayLength * 128));
+	result = (char *)malloc(sizeof(char) * resultLength);
+	result[0] = '\0';
+
+	for(ii = 0; ii < arrayLength; ii++) {
+		bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+				"%.*s %lli\n", keyLengths[ii], keys[ii],
+				*((alint *)values[ii]));
+
+		result = strxpndcat(result, &resultRef, &resultLength, buffer,
+				bufferLength);
+
+		free(keys[ii]);
+	}
+
+	if((isSamples) && (samples > 0)) {
+		bufferLength = snprintf(buffer, ((int)sizeof(buffer) - 1),
+				"(unscoped) %lli\n", samples);
+
+		result = strxpndcat(result, &resultRef, &resultLength, buffer,
+				bufferLength);
+	}
+
+	if(keys != NULL) {
+		free(keys);
+	}
+
+	if(keyLengths != NULL) {
+		free(keyLengths);
+	}
+
+	if(values != NULL) {
+		free(values);
+	}
+
+	bptree_free(&index);
+
+	*reportLength = resultRef;
+
+	return result;
 }
 
 // define pfs public functions
@@ -72,13 +561,10 @@ int pfs_init(Pfs *pfs, aboolean writeLog, char *filename)
 
 	memset(pfs, 0, sizeof(Pfs));
 
-	if(bptree_init(&pfs->index) < 0) {
-		return -1;
-	}
-
-	if(bptree_setFreeFunction(&pfs->index, freeEntry) < 0) {
-		return -1;
-	}
+	pfs->isEnabled = atrue;
+	pfs->isSampling = afalse;
+	pfs->writeLog = writeLog;
+	pfs->samplingFrequency = 0;
 
 	if(writeLog) {
 		if(log_init(&pfs->log, LOG_OUTPUT_FILE, filename,
@@ -102,15 +588,27 @@ int pfs_init(Pfs *pfs, aboolean writeLog, char *filename)
 
 int pfs_free(Pfs *pfs)
 {
+	int ii = 0;
+
 	if(pfs == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
+	if(pfs->isSampling) {
+		pfs_stopSampling(pfs);
+	}
+
 	mutex_lock(&pfs->mutex);
 
-	if(bptree_free(&pfs->index) < 0) {
-		return -1;
+	for(ii = 0; ii < PFS_THREAD_LENGTH; ii++) {
+		if(pfs->threads[ii].table != NULL) {
+			free(pfs->threads[ii].table);
+		}
+
+		if(pfs->threads[ii].nodes != NULL) {
+			free(pfs->threads[ii].nodes);
+		}
 	}
 
 	if(log_free(&pfs->log) < 0) {
@@ -126,18 +624,34 @@ int pfs_free(Pfs *pfs)
 	return 0;
 }
 
+int pfs_setEnabled(Pfs *pfs, aboolean isEnabled)
+{
+	if(pfs == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	pfs->isEnabled = isEnabled;
+
+	return 0;
+}
+
 int pfs_profile(Pfs *pfs, const char *file, const char *function)
 {
-	int keyLength = 0;
-	char key[1024];
+	int node = 0;
+	int parent = 0;
 
-	PfsEntry *entry = NULL;
+	PfsThread *thread = NULL;
 
 	if(pfs == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
+	if(!pfs->isEnabled) {
+		return 0;
+	}
+
 	if(file == NULL) {
 		file = "unknown";
 	}
@@ -145,101 +659,266 @@ int pfs_profile(Pfs *pfs, const char *file, const char *function)
 		function = "unknown";
 	}
 
-	buildKey(file, function, key, &keyLength);
+	// count the execution as a call within the current scope, untimed
 
-	mutex_lock(&pfs->mutex);
+	if((thread = getThread(pfs, atrue)) == NULL) {
+		atomic_addAlint(&pfs->droppedCount, 1);
+		return -1;
+	}
 
-	if(bptree_get(&pfs->index, key, keyLength, ((void *)&entry)) < 0) {
-		entry = newEntry(file, function);
-		if(bptree_put(&pfs->index, key, keyLength, (void *)entry) < 0) {
-			mutex_unlock(&pfs->mutex);
-			freeEntry(entry);
-			return -1;
-		}
+	parent = getParentNode(thread);
+
+	if(((thread->depth > 0) && (parent < 0)) ||
+			((node = getNode(thread, parent, file, function)) < 0)) {
+		thread->droppedCount += 1;
+		return -1;
 	}
 
-	entry->ticks += 1;
+	thread->nodes[node].calls += 1;
 
-	mutex_unlock(&pfs->mutex);
+	if(pfs->writeLog) {
+		log_logf(&pfs->log, LOG_LEVEL_DEBUG, "executed %s:%s()",
+				(char *)file, (char *)function);
+	}
+
+	return 0;
+}
+
+int pfs_beginScope(Pfs *pfs, const char *file, const char *function)
+{
+	int node = -1;
+	int parent = 0;
+
+	PfsFrame *frame = NULL;
+	PfsThread *thread = NULL;
+
+	if((pfs == NULL) || (!pfs->isEnabled)) {
+		return 0;
+	}
+
+	if((thread = getThread(pfs, atrue)) == NULL) {
+		atomic_addAlint(&pfs->droppedCount, 1);
+		return -1;
+	}
+
+	// scopes nested too deeply are only counted, so that the ends balance
+
+	if(thread->depth >= PFS_SCOPE_MAX_DEPTH) {
+		thread->droppedCount += 1;
+		thread->depth += 1;
+		return -1;
+	}
+
+	parent = getParentNode(thread);
+
+	if((thread->depth < 1) || (parent >= 0)) {
+		node = getNode(thread, parent, file, function);
+	}
+
+	if(node < 0) {
+		thread->droppedCount += 1;
+	}
+
+	frame = &thread->stack[thread->depth];
+
+	frame->node = node;
+	frame->childMus = 0.0;
+	frame->timestamp = time_getTimeMus();
+
+	// the sampling signal may interrupt this thread at any point, and must
+	// find a complete frame at the top of the stack
 
-	log_logf(&pfs->log, LOG_LEVEL_DEBUG, "executed %s:%s()", (char *)file,
-			(char *)function);
+	atomic_barrier();
+
+	thread->depth += 1;
 
 	return 0;
 }
 
-int pfs_buildReport(Pfs *pfs, char **report, int *reportLength)
+int pfs_endScope(Pfs *pfs)
 {
-	int ii = 0;
-	int threadId = 0;
-	int arrayLength = 0;
-	int bufferLength = 0;
-	int *keyLengths = NULL;
-	char statement[1024];
-	char *buffer = NULL;
-	char **keys = NULL;
-	void **values = NULL;
+	double elapsed = 0.0;
 
-	PfsEntry *entry = NULL;
+	PfsNode *node = NULL;
+	PfsFrame *frame = NULL;
+	PfsThread *thread = NULL;
 
-	const char *template = ""
-		"Profile-Function System Report (pid %i):\n"
-		"----------------------------------------------------------------\n"
-		"%s"
-		"----------------------------------------------------------------\n"
-		"\n";
+	if(pfs == NULL) {
+		return 0;
+	}
 
-	if((pfs == NULL) || (report == NULL) || (reportLength == NULL)) {
+	if(((thread = getThread(pfs, afalse)) == NULL) || (thread->depth < 1)) {
+		return 0;
+	}
+
+	if(thread->depth > PFS_SCOPE_MAX_DEPTH) {
+		thread->depth -= 1;
+		return 0;
+	}
+
+	frame = &thread->stack[(thread->depth - 1)];
+
+	elapsed = (time_getTimeMus() - frame->timestamp);
+	if(elapsed < 0.0) {
+		elapsed = 0.0;
+	}
+
+	thread->depth -= 1;
+
+	if(frame->node >= 0) {
+		node = &thread->nodes[frame->node];
+
+		node->calls += 1;
+		node->totalMus += (alint)elapsed;
+		node->selfMus += (alint)(elapsed - frame->childMus);
+
+		if((alint)elapsed > node->maxMus) {
+			node->maxMus = (alint)elapsed;
+		}
+	}
+
+	if(thread->depth > 0) {
+		thread->stack[(thread->depth - 1)].childMus += elapsed;
+	}
+
+	return 0;
+}
+
+int pfs_startSampling(Pfs *pfs, int frequency)
+{
+#if defined(__linux__) || defined(__APPLE__)
+	int interval = 0;
+
+	struct sigaction action;
+	struct itimerval timer;
+#endif // __linux__ || __APPLE__
+
+	if((pfs == NULL) || (frequency < 1) || (frequency > 10000)) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
+#if defined(__linux__) || defined(__APPLE__)
 	mutex_lock(&pfs->mutex);
 
-	if(bptree_toArray(&pfs->index, &arrayLength, &keyLengths, &keys,
-				&values) < 0) {
+	if((pfs->isSampling) || (samplingPfs != NULL)) {
 		mutex_unlock(&pfs->mutex);
 		return -1;
 	}
 
-	for(ii = 0; ii < arrayLength; ii++) {
-		entry = (PfsEntry *)values[ii];
+	samplingPfs = pfs;
 
-		bufferLength += ((int)strlen(entry->file) +
-				(int)strlen(entry->function) +
-				128);
+	memset(&action, 0, (int)(sizeof(action)));
 
-		free(keys[ii]);
+	action.sa_handler = handleSamplingSignal;
+	action.sa_flags = SA_RESTART;
+
+	sigemptyset(&action.sa_mask);
+
+	if(sigaction(SIGPROF, &action, &samplingPreviousAction) < 0) {
+		samplingPfs = NULL;
+		mutex_unlock(&pfs->mutex);
+		return -1;
 	}
 
-	bufferLength += 1024;
-	buffer = (char *)malloc(sizeof(char) * bufferLength);
+	// the profiling timer counts the process CPU time, and signals whichever
+	// thread is running when it expires
 
-	for(ii = 0; ii < arrayLength; ii++) {
-		entry = (PfsEntry *)values[ii];
+	interval = (1000000 / frequency);
 
-		snprintf(statement, sizeof(statement),
-				"%s:%s() => %lli executions\n",
-				entry->file, entry->function, entry->ticks);
+	timer.it_interval.tv_sec = (interval / 1000000);
+	timer.it_interval.tv_usec = (interval % 1000000);
+	timer.it_value = timer.it_interval;
 
-		strcat(buffer, statement);
+	if(setitimer(ITIMER_PROF, &timer, NULL) < 0) {
+		sigaction(SIGPROF, &samplingPreviousAction, NULL);
+		samplingPfs = NULL;
+		mutex_unlock(&pfs->mutex);
+		return -1;
 	}
 
-	free(keyLengths);
-	free(keys);
-	free(values);
+	pfs->isSampling = atrue;
+	pfs->samplingFrequency = frequency;
 
 	mutex_unlock(&pfs->mutex);
 
-	*reportLength = (bufferLength + (int)strlen((char *)template));
-	*report = (char *)malloc(sizeof(char) * (*reportLength));
+	return 0;
+#else // !__linux__ && !__APPLE__
+	return -1;
+#endif // __linux__ || __APPLE__
+}
 
-	thread_self(&threadId);
+int pfs_stopSampling(Pfs *pfs)
+{
+#if defined(__linux__) || defined(__APPLE__)
+	struct itimerval timer;
+#endif // __linux__ || __APPLE__
+
+	if(pfs == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+#if defined(__linux__) || defined(__APPLE__)
+	mutex_lock(&pfs->mutex);
 
-	*reportLength = snprintf(*report, *reportLength, template, threadId,
-			buffer);
+	if(!pfs->isSampling) {
+		mutex_unlock(&pfs->mutex);
+		return -1;
+	}
+
+	memset(&timer, 0, (int)(sizeof(timer)));
+
+	setitimer(ITIMER_PROF, &timer, NULL);
+
+	sigaction(SIGPROF, &samplingPreviousAction, NULL);
+
+	samplingPfs = NULL;
+
+	pfs->isSampling = afalse;
+
+	mutex_unlock(&pfs->mutex);
 
-	free(buffer);
+	return 0;
+#else // !__linux__ && !__APPLE__
+	return -1;
+#endif // __linux__ || __APPLE__
+}
+
+int pfs_buildReport(Pfs *pfs, PfsReportTypes type, char **report,
+		int *reportLength)
+{
+	if((pfs == NULL) || (report == NULL) || (reportLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	*report = NULL;
+	*reportLength = 0;
+
+	mutex_lock(&pfs->mutex);
+
+	switch(type) {
+		case PFS_REPORT_FLAT:
+			*report = buildFlatReport(pfs, reportLength);
+			break;
+
+		case PFS_REPORT_COLLAPSED:
+			*report = buildCollapsedReport(pfs, afalse, reportLength);
+			break;
+
+		case PFS_REPORT_SAMPLES:
+			*report = buildCollapsedReport(pfs, atrue, reportLength);
+			break;
+
+		case PFS_REPORT_UNKNOWN:
+		default:
+			mutex_unlock(&pfs->mutex);
+			DISPLAY_INVALID_ARGS;
+			return -1;
+	}
+
+	mutex_unlock(&pfs->mutex);
 
 	return 0;
 }
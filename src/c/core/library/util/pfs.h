@@ -22,16 +22,90 @@
 extern "C" {
 #endif // __cplusplus
 
+// define pfs public constants
+
+typedef enum _PfsReportTypes {
+	PFS_REPORT_FLAT = 1,
+	PFS_REPORT_COLLAPSED,
+	PFS_REPORT_SAMPLES,
+	PFS_REPORT_UNKNOWN = -1
+} PfsReportTypes;
+
+#define PFS_THREAD_LENGTH							64
+
+#define PFS_THREAD_NODE_LENGTH						1024
+
+#define PFS_THREAD_TABLE_LENGTH						2048
+
+#define PFS_SCOPE_MAX_DEPTH							32
+
+#define PFS_DEFAULT_SAMPLING_FREQUENCY				97
+
+// define pfs public macros
+
+/*
+ * Scopes are timed between a begin and an end in the same thread, and must
+ * be balanced. The file and scope names are kept by reference, and must have
+ * static storage, e.g. __FILE__ and __FUNCTION__. A NULL profiler records
+ * nothing.
+ */
+
+#define PFS_BEGIN(pfs) \
+	pfs_beginScope((pfs), __FILE__, __FUNCTION__)
+
+#define PFS_BEGIN_NAMED(pfs, name) \
+	pfs_beginScope((pfs), __FILE__, (name))
+
+#define PFS_END(pfs) \
+	pfs_endScope((pfs))
+
 // define pfs public data types
 
-typedef struct _PfsEntry {
-	alint ticks;
-	char *file;
-	char *function;
-} PfsEntry;
+/*
+ * Each thread records into its own buffer, a calling-context tree of the
+ * scopes it has entered, so that recording takes no lock and the flat and
+ * collapsed-stack reports can both be built from it. Only the owning thread
+ * writes its buffer; the report reads it as it is being written.
+ */
+
+typedef struct _PfsNode {
+	int parent;
+	const char *file;
+	const char *function;
+	alint calls;
+	alint samples;
+	alint totalMus;
+	alint selfMus;
+	alint maxMus;
+} PfsNode;
+
+typedef struct _PfsFrame {
+	int node;
+	double timestamp;
+	double childMus;
+} PfsFrame;
+
+typedef struct _PfsThread {
+	int isClaimed;
+	int isReady;
+	int threadId;
+	int depth;
+	int nodeCount;
+	alint samples;
+	alint droppedCount;
+	int *table;
+	PfsNode *nodes;
+	PfsFrame stack[PFS_SCOPE_MAX_DEPTH];
+} PfsThread;
 
 typedef struct _Pfs {
-	Bptree index;
+	aboolean isEnabled;
+	aboolean isSampling;
+	aboolean writeLog;
+	int samplingFrequency;
+	alint samples;
+	alint droppedCount;
+	PfsThread threads[PFS_THREAD_LENGTH];
 	Log log;
 	Mutex mutex;
 } Pfs;
@@ -42,9 +116,20 @@ int pfs_init(Pfs *pfs, aboolean writeLog, char *filename);
 
 int pfs_free(Pfs *pfs);
 
+int pfs_setEnabled(Pfs *pfs, aboolean isEnabled);
+
 int pfs_profile(Pfs *pfs, const char *file, const char *function);
 
-int pfs_buildReport(Pfs *pfs, char **report, int *reportLength);
+int pfs_beginScope(Pfs *pfs, const char *file, const char *function);
+
+int pfs_endScope(Pfs *pfs);
+
+int pfs_startSampling(Pfs *pfs, int frequency);
+
+int pfs_stopSampling(Pfs *pfs);
+
+int pfs_buildReport(Pfs *pfs, PfsReportTypes type, char **report,
+		int *reportLength);
 
 #if defined(__cplusplus)
 };
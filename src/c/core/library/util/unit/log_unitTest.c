@@ -19,11 +19,26 @@
 
 #define LOG_BASIC_TEST_FILENAME					"assets/data/test/testfile.log"
 
+#define LOG_ASYNC_TEST_FILENAME					"assets/data/test/async.log"
+
+#define LOG_ASYNC_TEST_THREADS					4
+
+#define LOG_ASYNC_TEST_MESSAGES					2048
+
 
 // declare log unit tests
 
 static int log_basicFunctionalityTest();
 
+static int log_asyncTest();
+
+
+// declare log unit test private functions
+
+static int countLines(char *filename);
+
+static void *asyncTestThread(void *argument);
+
 
 // main function
 
@@ -39,12 +54,68 @@ int main()
 		return 1;
 	}
 
+	if(log_asyncTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
 	printf("[unit] ...PASSED\n");
 
 	return 0;
 }
 
 
+// define log unit test private functions
+
+static int countLines(char *filename)
+{
+	int value = 0;
+	int result = 0;
+
+	FILE *fd = NULL;
+
+	if((fd = fopen(filename, "rb")) == NULL) {
+		return -1;
+	}
+
+	while((value = fgetc(fd)) != EOF) {
+		if(value == '\n') {
+			result++;
+		}
+	}
+
+	fclose(fd);
+
+	return result;
+}
+
+static void *asyncTestThread(void *argument)
+{
+	int ii = 0;
+	char message[1024];
+
+	Log *log = NULL;
+
+	log = (Log *)argument;
+
+	memset(message, 'x', (sizeof(message) - 1));
+	message[(sizeof(message) - 1)] = '\0';
+
+	// every eighth message is too long for a record
+
+	for(ii = 0; ii < LOG_ASYNC_TEST_MESSAGES; ii++) {
+		if((ii % 8) == 0) {
+			log_logf(log, LOG_LEVEL_INFO, "message %i '%s'", ii, message);
+		}
+		else {
+			log_logf(log, LOG_LEVEL_INFO, "message %i", ii);
+		}
+	}
+
+	return NULL;
+}
+
+
 // define log unit tests
 
 static int log_basicFunctionalityTest()
@@ -155,3 +226,118 @@ static int log_basicFunctionalityTest()
 	return 0;
 }
 
+static int log_asyncTest()
+{
+	aboolean fileExists = afalse;
+	int ii = 0;
+	int seconds = 0;
+	char filename[128];
+	void *exitValue = NULL;
+
+	Log log;
+	Thread threads[LOG_ASYNC_TEST_THREADS];
+
+	printf("[unit]\t log async test...\n");
+
+	system_fileExists(LOG_ASYNC_TEST_FILENAME, &fileExists);
+	if(fileExists) {
+		system_fileDelete(LOG_ASYNC_TEST_FILENAME);
+	}
+
+	seconds = time_getTimeSeconds();
+
+	if((log_init(&log, LOG_OUTPUT_FILE, LOG_ASYNC_TEST_FILENAME,
+					LOG_LEVEL_INFO) < 0) ||
+			(log_setRotation(&log, 1024, 0) == 0) ||
+			(log_enableAsync(&log, 16, LOG_OVERFLOW_BLOCK) < 0) ||
+			(!log_isAsync(&log)) ||
+			(log.async->ringLength != 16)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// with a blocking overflow, every message from every thread is written
+
+	for(ii = 0; ii < LOG_ASYNC_TEST_THREADS; ii++) {
+		thread_init(&threads[ii]);
+		thread_create(&threads[ii], asyncTestThread, (void *)&log);
+	}
+
+	for(ii = 0; ii < LOG_ASYNC_TEST_THREADS; ii++) {
+		thread_join(&threads[ii], &exitValue);
+	}
+
+	log_logf(&log, LOG_LEVEL_DEBUG, "filtered by level");
+
+	if((log_flush(&log) < 0) ||
+			(log_getDroppedCount(&log) != 0) ||
+			(countLines(LOG_ASYNC_TEST_FILENAME) !=
+			 (LOG_ASYNC_TEST_THREADS * LOG_ASYNC_TEST_MESSAGES))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// a file past its rotation length is moved aside by the writer
+
+	if(log_setRotation(&log, 1024, 0) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	log_logf(&log, LOG_LEVEL_INFO, "rotated");
+
+	if((log_flush(&log) < 0) ||
+			(countLines(LOG_ASYNC_TEST_FILENAME) != 0)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// a panic, and freeing the log, wait for the writer
+
+	log_logf(&log, LOG_LEVEL_PANIC, "panic");
+
+	if(countLines(LOG_ASYNC_TEST_FILENAME) != 1) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	log_logf(&log, LOG_LEVEL_INFO, "last");
+
+	if((log_free(&log) < 0) ||
+			(countLines(LOG_ASYNC_TEST_FILENAME) != 2)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// cleanup
+
+	system_fileDelete(LOG_ASYNC_TEST_FILENAME);
+
+	for(; seconds <= time_getTimeSeconds(); seconds++) {
+		for(ii = 0; ii < 8; ii++) {
+			if(ii == 0) {
+				snprintf(filename, sizeof(filename), "%s.%i",
+						LOG_ASYNC_TEST_FILENAME, seconds);
+			}
+			else {
+				snprintf(filename, sizeof(filename), "%s.%i.%i",
+						LOG_ASYNC_TEST_FILENAME, seconds, ii);
+			}
+
+			system_fileExists(filename, &fileExists);
+			if(fileExists) {
+				system_fileDelete(filename);
+			}
+		}
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
@@ -22,6 +22,10 @@
 
 static int pfs_basicFunctionalityTest();
 
+static int pfs_scopeTest();
+
+static int pfs_samplingTest();
+
 // main function
 
 int main()
@@ -36,6 +40,16 @@ int main()
 		return 1;
 	}
 
+	if(pfs_scopeTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(pfs_samplingTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
 	printf("[unit] ...PASSED\n");
 
 	return 0;
@@ -58,6 +72,42 @@ static int pfs_testFunction03(Pfs *pfs)
 	return pfs_profile(pfs, __FILE__, __FUNCTION__);
 }
 
+static void pfs_testSpin(int iterations)
+{
+	int ii = 0;
+	volatile double value = 1.0;
+
+	for(ii = 0; ii < iterations; ii++) {
+		value = ((value * 1.0000001) + 0.5);
+	}
+}
+
+static void pfs_testInner(Pfs *pfs)
+{
+	PFS_BEGIN(pfs);
+
+	pfs_testSpin(10000);
+
+	PFS_END(pfs);
+}
+
+static void pfs_testOuter(Pfs *pfs)
+{
+	PFS_BEGIN(pfs);
+
+	pfs_testSpin(10000);
+
+	pfs_testInner(pfs);
+
+	PFS_BEGIN_NAMED(pfs, "pfs_testNamed");
+
+	pfs_testSpin(10000);
+
+	PFS_END(pfs);
+
+	PFS_END(pfs);
+}
+
 static int pfs_basicFunctionalityTest()
 {
 	aboolean fileExists = afalse;
@@ -119,7 +169,8 @@ static int pfs_basicFunctionalityTest()
 		}
 	}
 
-	if(pfs_buildReport(&pfs, &report, &reportLength) < 0) {
+	if(pfs_buildReport(&pfs, PFS_REPORT_FLAT, &report,
+				&reportLength) < 0) {
 		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
 				__LINE__);
 		return -1;
@@ -142,3 +193,158 @@ static int pfs_basicFunctionalityTest()
 	return 0;
 }
 
+static int pfs_scopeTest()
+{
+	int ii = 0;
+	int reportLength = 0;
+	char *report = NULL;
+
+	Pfs pfs;
+
+	printf("[unit]\t pfs scope test...\n");
+
+	if(pfs_init(&pfs, afalse, NULL) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < 64; ii++) {
+		pfs_testOuter(&pfs);
+	}
+
+	// unbalanced, disabled and NULL profilers record nothing
+
+	pfs_endScope(&pfs);
+
+	pfs_setEnabled(&pfs, afalse);
+	pfs_testOuter(&pfs);
+	pfs_setEnabled(&pfs, atrue);
+
+	pfs_testOuter(NULL);
+
+	if(pfs_buildReport(&pfs, PFS_REPORT_FLAT, &report,
+				&reportLength) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("%s", report);
+
+	if((reportLength != (int)strlen(report)) ||
+			(strstr(report, "pfs_testOuter()") == NULL) ||
+			(strstr(report, "pfs_testInner()") == NULL) ||
+			(strstr(report, "pfs_testNamed()") == NULL) ||
+			(strstr(report, " 64          0  ") == NULL)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(report);
+
+	// the collapsed stacks nest the scopes root first
+
+	if(pfs_buildReport(&pfs, PFS_REPORT_COLLAPSED, &report,
+				&reportLength) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("%s", report);
+
+	if((strstr(report, "pfs_testOuter ") == NULL) ||
+			(strstr(report, "pfs_testOuter;pfs_testInner ") == NULL) ||
+			(strstr(report, "pfs_testOuter;pfs_testNamed ") == NULL) ||
+			(strstr(report, "\npfs_testInner ") != NULL)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(report);
+
+	if(pfs_buildReport(&pfs, PFS_REPORT_UNKNOWN, &report,
+				&reportLength) == 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(pfs_free(&pfs) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int pfs_samplingTest()
+{
+	int ii = 0;
+	int reportLength = 0;
+	char *report = NULL;
+
+	Pfs pfs;
+	Pfs other;
+
+	printf("[unit]\t pfs sampling test...\n");
+
+	pfs_init(&pfs, afalse, NULL);
+	pfs_init(&other, afalse, NULL);
+
+	if(pfs_startSampling(&pfs, 1000) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// only one profiler may sample the process at a time
+
+	if(pfs_startSampling(&other, 1000) == 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < 256; ii++) {
+		pfs_testOuter(&pfs);
+	}
+
+	if(pfs_stopSampling(&pfs) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	if(pfs_buildReport(&pfs, PFS_REPORT_SAMPLES, &report,
+				&reportLength) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("%s", report);
+
+	if(reportLength != (int)strlen(report)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	free(report);
+
+	pfs_free(&other);
+
+	if(pfs_free(&pfs) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
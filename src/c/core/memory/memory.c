@@ -20,8 +20,13 @@
 #include "core/os/dl.h"
 #include "core/os/time.h"
 #include "core/os/types.h"
+#define _CORE_MEMORY_COMPONENT
+#define MEMORY_NATIVE
+#include "core/memory/memory.h"
 #define _CORE_SYSTEM_COMPONENT
 #include "core/system/mutex.h"
+#define _CORE_LIBRARY_SYSTEM_COMPONENT
+#include "core/library/system/atomic.h"
 
 
 // detect compiler environment
@@ -44,6 +49,15 @@
 #endif // MinGW
 
 
+// define thread-local storage & atomic operation support
+
+#if defined(_MSC_VER)
+#	define MEMCACHE_THREAD_LOCAL					__declspec(thread)
+#else // !_MSC_VER
+#	define MEMCACHE_THREAD_LOCAL					__thread
+#endif // _MSC_VER
+
+
 // define memory private constants
 
 #define FREE_ALLOW_CACHE_BYPASS						1
@@ -68,6 +82,20 @@
 
 #define DISPLAY_SLOT_PROFILE						0
 
+#define THREAD_CACHE_ENABLED						1
+
+#define THREAD_CACHE_MAX_LENGTH						8192
+
+#define THREAD_CACHE_SLOT_DEPTH						64
+
+#define THREAD_CACHE_BATCH_LENGTH					16
+
+#define THREAD_CACHE_HANDOFF_LENGTH					64
+
+#define MEMORY_ARENA_ALIGNMENT						8
+
+#define MEMORY_ARENA_MAX_RETAINED_BLOCKS			8
+
 
 // define memory private data types
 
@@ -83,11 +111,35 @@ typedef struct _MemcacheEntry {
 	int inUse;
 	int peak;
 	alint ticks;
+	alint handoffLength;
+	void *handoff;
 	Memlist bucket;
 } MemcacheEntry;
 
+typedef struct _MemcacheThreadSlot {
+	int ref;
+	int inUse;
+	alint ticks;
+	void *list[THREAD_CACHE_SLOT_DEPTH];
+} MemcacheThreadSlot;
+
+typedef struct _MemcacheThread {
+	int uid;
+	alint hits;
+	alint misses;
+	alint refills;
+	alint flushes;
+	alint cachedItems;
+	alint cachedMemory;
+	void *owner;
+	MemcacheThreadSlot *slots;
+	struct _MemcacheThread *next;
+} MemcacheThread;
+
 typedef struct _memcache {
 	int cacheLength;
+	int threadSlotLength;
+	int threadUid;
 	int maxMemoryLength;
 	int memoryBlockLength;
 	alint maxCacheMemory;
@@ -96,7 +148,10 @@ typedef struct _memcache {
 	alint cachedMemory;
 	alint totalCachedItems;
 	alint totalSlotTicks;
+	alint retiredHits;
+	alint retiredMisses;
 	MemcacheEntry *cache;
+	MemcacheThread *threads;
 	Mutex mutex;
 } MEMCACHE_STATE;
 
@@ -105,6 +160,16 @@ typedef struct _memcache {
 
 MEMCACHE_STATE *memcache = NULL;
 
+static MEMCACHE_THREAD_LOCAL MemcacheThread *memcacheThread = NULL;
+
+static MEMCACHE_THREAD_LOCAL aboolean memcacheThreadRetired = afalse;
+
+#if defined(__linux__) || defined(__APPLE__)
+static pthread_key_t memcacheThreadKey;
+
+static pthread_once_t memcacheThreadKeyOnce = PTHREAD_ONCE_INIT;
+#endif // __linux__ || __APPLE__
+
 
 // declare memory private functions
 
@@ -131,6 +196,10 @@ int memlist_push(Memlist *list, void *entry);
 
 void *memlist_pop(Memlist *list);
 
+int memlist_pushBatch(Memlist *list, void **entries, int length);
+
+int memlist_popBatch(Memlist *list, void **entries, int length);
+
 // memory caching helper functions
 
 static int memcache_calculateSlotId(int length);
@@ -139,6 +208,45 @@ static void memcache_pruneCache();
 
 static void memcache_freeCache(void);
 
+// memory thread-cache helper functions
+
+static void memcache_handoffPush(MemcacheEntry *entry, void *head,
+		void *tail);
+
+static void memcache_freeHandoff(MemcacheEntry *entry);
+
+static void memcache_returnToSlot(int slot, void **entries, int length);
+
+static MemcacheThread *memcache_getThreadCache();
+
+static void *memcache_threadCachePop(MemcacheThread *thread, int slot);
+
+static void memcache_threadCachePush(MemcacheThread *thread, int slot,
+		void *memory);
+
+static void memcache_threadCacheFlush(MemcacheThread *thread, int slot,
+		int length);
+
+static void memcache_threadCacheRelease(MemcacheThread *thread);
+
+static void memcache_threadCacheFree(MemcacheThread *thread);
+
+#if defined(__linux__) || defined(__APPLE__)
+static void memcache_threadKeyInit(void);
+
+static void memcache_threadKeyDestructor(void *argument);
+#endif // __linux__ || __APPLE__
+
+
+// memory arena helper functions
+
+static int memory_arenaAlign(int length);
+
+static MemoryArenaBlock *memory_arenaNewBlock(MemoryArena *arena, int length,
+		const char *file, const char *function, size_t line);
+
+static char *memory_arenaBlockData(MemoryArenaBlock *block);
+
 
 // declare public memory functions (for compiler heirarchy)
 
@@ -354,6 +462,62 @@ void *memlist_pop(Memlist *list)
 	return result;
 }
 
+int memlist_pushBatch(Memlist *list, void **entries, int length)
+{
+	int ii = 0;
+
+	if((list == NULL) || (entries == NULL) || (length < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&list->mutex);
+
+	if((list->ref + length) >= list->length) {
+		while((list->ref + length) >= list->length) {
+			list->length += MEMLIST_LIST_INCREMENT;
+		}
+		list->list = (void *)local_realloc(list->list,
+				(sizeof(void *) * list->length),
+				__FILE__, __FUNCTION__, __LINE__);
+		for(ii = list->ref; ii < list->length; ii++) {
+			list->list[ii] = NULL;
+		}
+	}
+
+	for(ii = 0; ii < length; ii++) {
+		list->list[list->ref] = entries[ii];
+		list->ref += 1;
+	}
+
+	mutex_unlock(&list->mutex);
+
+	return 0;
+}
+
+int memlist_popBatch(Memlist *list, void **entries, int length)
+{
+	int result = 0;
+
+	if((list == NULL) || (entries == NULL) || (length < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&list->mutex);
+
+	while((list->ref > 0) && (result < length)) {
+		entries[result] = list->list[(list->ref - 1)];
+		list->list[(list->ref - 1)] = NULL;
+		list->ref -= 1;
+		result++;
+	}
+
+	mutex_unlock(&list->mutex);
+
+	return result;
+}
+
 // memory caching helper functions
 
 static int memcache_calculateSlotId(int length)
@@ -444,6 +608,8 @@ static void memcache_pruneCache()
 static void memcache_freeCache(void)
 {
 	int ii = 0;
+	int nn = 0;
+	MemcacheThread *thread = NULL;
 
 	if(memcache == NULL) {
 		return;
@@ -451,8 +617,42 @@ static void memcache_freeCache(void)
 
 	mutex_lock(&memcache->mutex);
 
+	/*
+	 * empty every thread cache, but only free the calling thread's own, since
+	 * other threads may still hold theirs; those are detached from the cache
+	 * and freed by their owning thread
+	 */
+
+	while(memcache->threads != NULL) {
+		thread = memcache->threads;
+		memcache->threads = thread->next;
+
+		for(ii = 0; ii < memcache->threadSlotLength; ii++) {
+			for(nn = 0; nn < thread->slots[ii].ref; nn++) {
+				local_free(thread->slots[ii].list[nn], __FILE__, __FUNCTION__,
+						__LINE__);
+				thread->slots[ii].list[nn] = NULL;
+			}
+			thread->slots[ii].ref = 0;
+		}
+
+		thread->owner = NULL;
+		thread->next = NULL;
+	}
+
+	if(memcacheThread != NULL) {
+		memcache_threadCacheFree(memcacheThread);
+
+#if defined(__linux__) || defined(__APPLE__)
+		pthread_setspecific(memcacheThreadKey, NULL);
+#endif // __linux__ || __APPLE__
+
+		memcacheThread = NULL;
+	}
+
 	if(memcache->cache != NULL) {
 		for(ii = 0; ii < memcache->cacheLength; ii++) {
+			memcache_freeHandoff(&memcache->cache[ii]);
 			memlist_free(&memcache->cache[ii].bucket);
 		}
 
@@ -467,6 +667,404 @@ static void memcache_freeCache(void)
 	local_free(memcache, __FILE__, __FUNCTION__, __LINE__);
 }
 
+// memory thread-cache helper functions
+
+/*
+ * The handoff is a short lock-free singly-linked stack of raw cache blocks per
+ * slot, linked through the first pointer of each block. Chains are only ever
+ * pushed (compare-and-swap) or taken in full (swap), which keeps it free of
+ * the ABA problem without tagged pointers.
+ */
+
+static void memcache_handoffPush(MemcacheEntry *entry, void *head,
+		void *tail)
+{
+	void *current = NULL;
+
+	do {
+		current = entry->handoff;
+		*((void **)tail) = current;
+	} while(!atomic_comparePointer(&entry->handoff, current, head));
+}
+
+static void memcache_freeHandoff(MemcacheEntry *entry)
+{
+	void *next = NULL;
+	void *current = NULL;
+
+	current = atomic_swapPointer(&entry->handoff, NULL);
+
+	while(current != NULL) {
+		next = *((void **)current);
+		local_free(current, __FILE__, __FUNCTION__, __LINE__);
+		current = next;
+	}
+
+	entry->handoffLength = 0;
+}
+
+static void memcache_returnToSlot(int slot, void **entries, int length)
+{
+	alint allocationLength = 0;
+
+	allocationLength = (alint)(memcache->cache[slot].length + (SIZEOF_INT * 3));
+
+	memlist_pushBatch(&memcache->cache[slot].bucket, entries, length);
+
+	mutex_lock(&memcache->mutex);
+	memcache->totalCachedItems += length;
+	memcache->totalSlotTicks += length;
+	memcache->cache[slot].ticks += length;
+	memcache->cachedMemory += ((alint)length * allocationLength);
+	mutex_unlock(&memcache->mutex);
+}
+
+static MemcacheThread *memcache_getThreadCache()
+{
+	MemcacheThread *result = NULL;
+
+	if(!THREAD_CACHE_ENABLED) {
+		return NULL;
+	}
+
+	if(memcacheThread != NULL) {
+		if(memcacheThread->owner == memcache) {
+			return memcacheThread;
+		}
+
+		// a cache detached by freeing the memory cache is freed here, by its
+		// owning thread
+
+		if(memcacheThread->owner == NULL) {
+			memcache_threadCacheFree(memcacheThread);
+
+#if defined(__linux__) || defined(__APPLE__)
+			pthread_setspecific(memcacheThreadKey, NULL);
+#endif // __linux__ || __APPLE__
+
+			memcacheThread = NULL;
+		}
+	}
+
+	if(memcacheThreadRetired) {
+		return NULL;
+	}
+
+	result = (MemcacheThread *)local_malloc(sizeof(MemcacheThread),
+			__FILE__, __FUNCTION__, __LINE__);
+
+	result->owner = memcache;
+	result->slots = (MemcacheThreadSlot *)local_malloc(
+			(sizeof(MemcacheThreadSlot) * memcache->threadSlotLength),
+			__FILE__, __FUNCTION__, __LINE__);
+
+	mutex_lock(&memcache->mutex);
+
+	result->uid = memcache->threadUid;
+	memcache->threadUid += 1;
+	result->next = memcache->threads;
+	memcache->threads = result;
+
+	mutex_unlock(&memcache->mutex);
+
+	memcacheThread = result;
+
+#if defined(__linux__) || defined(__APPLE__)
+	pthread_once(&memcacheThreadKeyOnce, memcache_threadKeyInit);
+	pthread_setspecific(memcacheThreadKey, result);
+#endif // __linux__ || __APPLE__
+
+	return result;
+}
+
+static void *memcache_threadCachePop(MemcacheThread *thread, int slot)
+{
+	int length = 0;
+	int overflowLength = 0;
+	int allocationLength = 0;
+	void *next = NULL;
+	void *chain = NULL;
+	void *result = NULL;
+	void *overflow[THREAD_CACHE_BATCH_LENGTH];
+	MemcacheThreadSlot *local = NULL;
+
+	local = &thread->slots[slot];
+	local->ticks += 1;
+
+	if(local->ref < 1) {
+		allocationLength = (memcache->cache[slot].length + (SIZEOF_INT * 3));
+
+		// drain blocks handed off by other threads without locking
+
+		if(memcache->cache[slot].handoff != NULL) {
+			chain = atomic_swapPointer(&memcache->cache[slot].handoff,
+					NULL);
+			while(chain != NULL) {
+				next = *((void **)chain);
+				if(local->ref < THREAD_CACHE_SLOT_DEPTH) {
+					local->list[local->ref] = chain;
+					local->ref += 1;
+				}
+				else {
+					overflow[overflowLength] = chain;
+					overflowLength++;
+					if(overflowLength >= THREAD_CACHE_BATCH_LENGTH) {
+						memcache_returnToSlot(slot, overflow, overflowLength);
+						overflowLength = 0;
+					}
+				}
+				length++;
+				chain = next;
+			}
+
+			if(overflowLength > 0) {
+				memcache_returnToSlot(slot, overflow, overflowLength);
+			}
+
+			atomic_addAlint(&memcache->cache[slot].handoffLength,
+					-(alint)length);
+		}
+
+		// otherwise refill a batch from the shared slot under a single lock
+
+		if(local->ref < 1) {
+			length = memlist_popBatch(&memcache->cache[slot].bucket,
+					local->list, THREAD_CACHE_BATCH_LENGTH);
+			if(length > 0) {
+				local->ref = length;
+
+				mutex_lock(&memcache->mutex);
+				memcache->totalCachedItems -= length;
+				memcache->totalSlotTicks += length;
+				memcache->cache[slot].ticks += length;
+				memcache->cachedMemory -= ((alint)length *
+						(alint)allocationLength);
+				mutex_unlock(&memcache->mutex);
+			}
+		}
+
+		if(local->ref < 1) {
+			thread->misses += 1;
+			return NULL;
+		}
+
+		thread->refills += 1;
+		thread->cachedItems += local->ref;
+		thread->cachedMemory += ((alint)local->ref *
+				(alint)allocationLength);
+	}
+
+	local->ref -= 1;
+	result = local->list[local->ref];
+	local->list[local->ref] = NULL;
+
+	local->inUse += 1;
+
+	thread->hits += 1;
+	thread->cachedItems -= 1;
+	thread->cachedMemory -= (memcache->cache[slot].length + (SIZEOF_INT * 3));
+
+	return result;
+}
+
+static void memcache_threadCachePush(MemcacheThread *thread, int slot,
+		void *memory)
+{
+	MemcacheThreadSlot *local = NULL;
+
+	local = &thread->slots[slot];
+	local->ticks += 1;
+	local->inUse -= 1;
+
+	/*
+	 * no owner is tracked per block, so a block is cached by whichever thread
+	 * frees it, and any batch flushed beyond the slot depth goes to the
+	 * handoff for the other threads
+	 */
+
+	if(local->ref >= THREAD_CACHE_SLOT_DEPTH) {
+		memcache_threadCacheFlush(thread, slot, THREAD_CACHE_BATCH_LENGTH);
+	}
+
+	local->list[local->ref] = memory;
+	local->ref += 1;
+
+	thread->cachedItems += 1;
+	thread->cachedMemory += (memcache->cache[slot].length + (SIZEOF_INT * 3));
+}
+
+static void memcache_threadCacheFlush(MemcacheThread *thread, int slot,
+		int length)
+{
+	int ii = 0;
+	int allocationLength = 0;
+	void *head = NULL;
+	void *tail = NULL;
+	MemcacheThreadSlot *local = NULL;
+
+	local = &thread->slots[slot];
+
+	if(length > local->ref) {
+		length = local->ref;
+	}
+	if(length < 1) {
+		return;
+	}
+
+	allocationLength = (memcache->cache[slot].length + (SIZEOF_INT * 3));
+
+	thread->flushes += 1;
+	thread->cachedItems -= length;
+	thread->cachedMemory -= ((alint)length * (alint)allocationLength);
+
+	// release to the system once the shared caches are at capacity
+
+	if((memcache->cachedMemory >= memcache->maxCacheMemory) ||
+			(memcache->allocatedMemory >= memcache->targetMemoryFootprint)) {
+		for(ii = 0; ii < length; ii++) {
+			local->ref -= 1;
+			local_free(local->list[local->ref], __FILE__, __FUNCTION__,
+					__LINE__);
+			local->list[local->ref] = NULL;
+		}
+
+		mutex_lock(&memcache->mutex);
+		memcache->allocatedMemory -= ((alint)length * (alint)allocationLength);
+		mutex_unlock(&memcache->mutex);
+
+		return;
+	}
+
+	// once the handoff is full, return the batch to the shared slot
+
+	if(memcache->cache[slot].handoffLength >= THREAD_CACHE_HANDOFF_LENGTH) {
+		local->ref -= length;
+		memcache_returnToSlot(slot, &local->list[local->ref], length);
+		memset(&local->list[local->ref], 0, (sizeof(void *) * length));
+		return;
+	}
+
+	// otherwise chain the blocks and hand them off to the other threads
+
+	tail = local->list[(local->ref - 1)];
+
+	for(ii = 0; ii < length; ii++) {
+		local->ref -= 1;
+		*((void **)local->list[local->ref]) = head;
+		head = local->list[local->ref];
+		local->list[local->ref] = NULL;
+	}
+
+	atomic_addAlint(&memcache->cache[slot].handoffLength, (alint)length);
+
+	memcache_handoffPush(&memcache->cache[slot], head, tail);
+}
+
+static void memcache_threadCacheRelease(MemcacheThread *thread)
+{
+	int ii = 0;
+	MemcacheThread *node = NULL;
+
+	if((thread == NULL) || (thread->owner != memcache)) {
+		return;
+	}
+
+	for(ii = 0; ii < memcache->threadSlotLength; ii++) {
+		memcache_threadCacheFlush(thread, ii, thread->slots[ii].ref);
+	}
+
+	mutex_lock(&memcache->mutex);
+
+	if(memcache->threads == thread) {
+		memcache->threads = thread->next;
+	}
+	else {
+		for(node = memcache->threads; node != NULL; node = node->next) {
+			if(node->next == thread) {
+				node->next = thread->next;
+				break;
+			}
+		}
+	}
+
+	memcache->retiredHits += thread->hits;
+	memcache->retiredMisses += thread->misses;
+
+	for(ii = 0; ii < memcache->threadSlotLength; ii++) {
+		memcache->cache[ii].inUse += thread->slots[ii].inUse;
+		memcache->cache[ii].ticks += thread->slots[ii].ticks;
+		memcache->totalSlotTicks += thread->slots[ii].ticks;
+	}
+
+	mutex_unlock(&memcache->mutex);
+
+	memcache_threadCacheFree(thread);
+}
+
+static void memcache_threadCacheFree(MemcacheThread *thread)
+{
+	local_free(thread->slots, __FILE__, __FUNCTION__, __LINE__);
+	local_free(thread, __FILE__, __FUNCTION__, __LINE__);
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+static void memcache_threadKeyInit(void)
+{
+	pthread_key_create(&memcacheThreadKey, memcache_threadKeyDestructor);
+}
+
+static void memcache_threadKeyDestructor(void *argument)
+{
+	MemcacheThread *thread = NULL;
+
+	thread = (MemcacheThread *)argument;
+
+	if(thread->owner == NULL) {
+		memcache_threadCacheFree(thread);
+	}
+	else if(memcache != NULL) {
+		memcache_threadCacheRelease(thread);
+	}
+
+	memcacheThread = NULL;
+	memcacheThreadRetired = atrue;
+}
+#endif // __linux__ || __APPLE__
+
+
+
+// memory arena helper functions
+
+static int memory_arenaAlign(int length)
+{
+	return ((length + (MEMORY_ARENA_ALIGNMENT - 1)) &
+			~(MEMORY_ARENA_ALIGNMENT - 1));
+}
+
+static MemoryArenaBlock *memory_arenaNewBlock(MemoryArena *arena, int length,
+		const char *file, const char *function, size_t line)
+{
+	MemoryArenaBlock *result = NULL;
+
+	result = (MemoryArenaBlock *)memory_allocate(
+			(memory_arenaAlign((int)sizeof(MemoryArenaBlock)) + length),
+			file, function, line);
+
+	result->length = length;
+	result->ref = 0;
+	result->next = NULL;
+
+	arena->blockCount += 1;
+	arena->allocatedMemory += (alint)length;
+
+	return result;
+}
+
+static char *memory_arenaBlockData(MemoryArenaBlock *block)
+{
+	return ((char *)block + memory_arenaAlign((int)sizeof(MemoryArenaBlock)));
+}
+
 
 // define memory public functions
 
@@ -497,8 +1095,14 @@ void memory_init()
 	memcache->cachedMemory = 0;
 	memcache->totalCachedItems = 0;
 	memcache->totalSlotTicks = 0;
+	memcache->retiredHits = 0;
+	memcache->retiredMisses = 0;
+	memcache->threadUid = 1;
+	memcache->threads = NULL;
 
 	memcache->cacheLength = (memcache_calculateSlotId(MAX_MEMORY_LENGTH) + 1);
+	memcache->threadSlotLength = (memcache_calculateSlotId(
+				THREAD_CACHE_MAX_LENGTH) + 1);
 
 	memcache->cache = (MemcacheEntry *)local_malloc(
 			(sizeof(MemcacheEntry) * memcache->cacheLength),
@@ -534,6 +1138,8 @@ void memory_init()
 		memcache->cache[ii].ticks = 0;
 		memcache->cache[ii].inUse = 0;
 		memcache->cache[ii].peak = 0;
+		memcache->cache[ii].handoffLength = 0;
+		memcache->cache[ii].handoff = NULL;
 
 		memlist_init(&memcache->cache[ii].bucket);
 
@@ -572,6 +1178,7 @@ void *memory_allocate(int length, const char *file, const char *function,
 	int allocationLength = 0;
 	void *ptr = NULL;
 	void *result = NULL;
+	MemcacheThread *thread = NULL;
 
 	if(length < 1) {
 		if(EXPLICIT_ERRORS) {
@@ -607,7 +1214,18 @@ void *memory_allocate(int length, const char *file, const char *function,
 		localLength = length;
 	}
 
-	if(slot != -1) {
+	if((slot != -1) && (slot < memcache->threadSlotLength)) {
+		thread = memcache_getThreadCache();
+	}
+
+	if(thread != NULL) {
+		// small allocations are served from the per-thread front cache, which
+		// refills itself in batches from the shared slot
+
+		result = memcache_threadCachePop(thread, slot);
+		localLength = memcache->cache[slot].length;
+	}
+	else if(slot != -1) {
 		// pick either the slot for the requested length, or the next one
 		// larger
 
@@ -672,6 +1290,19 @@ void *memory_allocate(int length, const char *file, const char *function,
 	ptr = (result + (SIZEOF_INT * 2));
 #endif // WIN32 && !ENV_MINGW
 
+	if(thread != NULL) {
+		// a thread cache miss is counted in use once it is allocated
+
+		if(!obtainedFromCache) {
+			thread->slots[slot].inUse += 1;
+
+			mutex_lock(&memcache->mutex);
+			memcache->allocatedMemory += allocationLength;
+			mutex_unlock(&memcache->mutex);
+		}
+		return ptr;
+	}
+
 	mutex_lock(&memcache->mutex);
 
 	if(obtainedFromCache) {
@@ -874,6 +1505,7 @@ void memory_free(void *value, const char *file, const char *function,
 	int length = 0;
 	int allocationLength = 0;
 	void *ptr = NULL;
+	MemcacheThread *thread = NULL;
 
 	if(value == NULL) {
 		if(EXPLICIT_ERRORS) {
@@ -964,7 +1596,15 @@ void memory_free(void *value, const char *file, const char *function,
 #endif // WIN32 && !ENV_MINGW
 	allocationLength = (length + (SIZEOF_INT * 3));
 
-	if((PRUNE_MEMORY_CACHE) && (slot != -1)) {
+	if((slot != -1) && (slot < memcache->threadSlotLength) &&
+			(memcache->cache[slot].length == length)) {
+		thread = memcache_getThreadCache();
+	}
+
+	if(thread != NULL) {
+		memcache_threadCachePush(thread, slot, ptr);
+	}
+	else if((PRUNE_MEMORY_CACHE) && (slot != -1)) {
 		memlist_push(&memcache->cache[slot].bucket, ptr);
 
 		mutex_lock(&memcache->mutex);
@@ -999,6 +1639,30 @@ void memory_free(void *value, const char *file, const char *function,
 	}
 }
 
+void memory_releaseThreadCache()
+{
+#if defined(MEMCACHE_BYPASS)
+	return;
+#endif // MEMCACHE_BYPASS
+
+	if(memcacheThread == NULL) {
+		return;
+	}
+
+	if(memcacheThread->owner == NULL) {
+		memcache_threadCacheFree(memcacheThread);
+	}
+	else {
+		memcache_threadCacheRelease(memcacheThread);
+	}
+
+#if defined(__linux__) || defined(__APPLE__)
+	pthread_setspecific(memcacheThreadKey, NULL);
+#endif // __linux__ || __APPLE__
+
+	memcacheThread = NULL;
+}
+
 void memory_systemFree(void *value, const char *file, const char *function,
 		size_t line)
 {
@@ -1151,8 +1815,355 @@ char *memory_dtoa(double value, const char *file, const char *function,
 	return result;
 }
 
+int memory_arenaInit(MemoryArena *arena, int blockLength)
+{
+	if((arena == NULL) || (blockLength < 1)) {
+		fprintf(stderr, "[%s():%i] error - invalid or missing argument(s).\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	memset(arena, 0, (int)(sizeof(MemoryArena)));
+
+	arena->blockLength = memory_arenaAlign(blockLength);
+
+	return 0;
+}
+
+void memory_arenaFree(MemoryArena *arena)
+{
+	MemoryArenaBlock *block = NULL;
+	MemoryArenaBlock *next = NULL;
+
+	if(arena == NULL) {
+		fprintf(stderr, "[%s():%i] error - invalid or missing argument(s).\n",
+				__FUNCTION__, __LINE__);
+		return;
+	}
+
+	block = arena->blocks;
+
+	while(block != NULL) {
+		next = block->next;
+		memory_free(block, __FILE__, __FUNCTION__, __LINE__);
+		block = next;
+	}
+
+	memset(arena, 0, (int)(sizeof(MemoryArena)));
+}
+
+void memory_arenaReset(MemoryArena *arena)
+{
+	int retained = 0;
+
+	MemoryArenaBlock *block = NULL;
+	MemoryArenaBlock *next = NULL;
+	MemoryArenaBlock *last = NULL;
+
+	if(arena == NULL) {
+		fprintf(stderr, "[%s():%i] error - invalid or missing argument(s).\n",
+				__FUNCTION__, __LINE__);
+		return;
+	}
+
+	/*
+	 * keep a bounded number of standard-length blocks for the next request,
+	 * and release any oversized blocks back to the memory cache
+	 */
+
+	block = arena->blocks;
+
+	arena->blocks = NULL;
+	arena->current = NULL;
+
+	while(block != NULL) {
+		next = block->next;
+
+		if((block->length > arena->blockLength) ||
+				(retained >= MEMORY_ARENA_MAX_RETAINED_BLOCKS)) {
+			arena->blockCount -= 1;
+			arena->allocatedMemory -= (alint)block->length;
+			memory_free(block, __FILE__, __FUNCTION__, __LINE__);
+		}
+		else {
+			block->ref = 0;
+			block->next = NULL;
+
+			if(last == NULL) {
+				arena->blocks = block;
+			}
+			else {
+				last->next = block;
+			}
+
+			last = block;
+			retained++;
+		}
+
+		block = next;
+	}
+
+	arena->current = arena->blocks;
+	arena->usedMemory = 0;
+	arena->resets += 1;
+}
+
+void *memory_arenaAllocate(MemoryArena *arena, int length, const char *file,
+		const char *function, size_t line)
+{
+	int allocationLength = 0;
+	char *result = NULL;
+
+	MemoryArenaBlock *block = NULL;
+	MemoryArenaBlock *last = NULL;
+
+	if(arena == NULL) {
+		return memory_allocate(length, file, function, line);
+	}
+
+	if(length < 1) {
+		if(EXPLICIT_ERRORS) {
+			fprintf(stderr, "[%s():%i] warning - unable to allocate %i bytes "
+					"from [%s->%s():%i].\n", __FUNCTION__, __LINE__, length,
+					(char *)file, (char *)function, (int)line);
+		}
+		length = 1;
+	}
+
+	allocationLength = (MEMORY_ARENA_ALIGNMENT + memory_arenaAlign(length));
+
+	if(allocationLength > arena->blockLength) {
+		block = memory_arenaNewBlock(arena, allocationLength, file, function,
+				line);
+		block->next = arena->blocks;
+		arena->blocks = block;
+	}
+	else {
+		block = arena->current;
+
+		while((block != NULL) &&
+				((block->ref + allocationLength) > block->length)) {
+			last = block;
+			block = block->next;
+		}
+
+		if(block == NULL) {
+			block = memory_arenaNewBlock(arena, arena->blockLength, file,
+					function, line);
+
+			if(last == NULL) {
+				for(last = arena->blocks; ((last != NULL) &&
+							(last->next != NULL)); last = last->next) {
+					// locate the end of the block list
+				}
+			}
+
+			if(last == NULL) {
+				arena->blocks = block;
+			}
+			else {
+				last->next = block;
+			}
+		}
+
+		arena->current = block;
+	}
+
+	result = (memory_arenaBlockData(block) + block->ref);
+
+	block->ref += allocationLength;
+
+	*((int *)result) = length;
+	result += MEMORY_ARENA_ALIGNMENT;
+
+	memset(result, 0, length);
+
+	arena->allocations += 1;
+	arena->usedMemory += (alint)allocationLength;
+
+	if(arena->usedMemory > arena->peakMemory) {
+		arena->peakMemory = arena->usedMemory;
+	}
+
+	return (void *)result;
+}
+
+void *memory_arenaReallocate(MemoryArena *arena, void *value, int length,
+		const char *file, const char *function, size_t line)
+{
+	int growth = 0;
+	int oldLength = 0;
+	void *result = NULL;
+
+	MemoryArenaBlock *block = NULL;
+
+	if(arena == NULL) {
+		return memory_reallocate(value, length, file, function, line);
+	}
+
+	if(value == NULL) {
+		return memory_arenaAllocate(arena, length, file, function, line);
+	}
+
+	if(length < 1) {
+		if(EXPLICIT_ERRORS) {
+			fprintf(stderr, "[%s():%i] warning - unable to reallocate %i "
+					"bytes from [%s->%s():%i].\n", __FUNCTION__, __LINE__,
+					length, (char *)file, (char *)function, (int)line);
+		}
+		length = 1;
+	}
+
+	oldLength = *((int *)((char *)value - MEMORY_ARENA_ALIGNMENT));
+
+	if(length <= oldLength) {
+		return value;
+	}
+
+	/*
+	 * grow the most recent allocation in place when the current block has
+	 * room, otherwise copy into a new allocation
+	 */
+
+	block = arena->current;
+	growth = (memory_arenaAlign(length) - memory_arenaAlign(oldLength));
+
+	if((block != NULL) &&
+			(((char *)value + memory_arenaAlign(oldLength)) ==
+			 (memory_arenaBlockData(block) + block->ref)) &&
+			((block->ref + growth) <= block->length)) {
+		block->ref += growth;
+
+		memset(((char *)value + oldLength), 0, (length - oldLength));
+
+		*((int *)((char *)value - MEMORY_ARENA_ALIGNMENT)) = length;
+
+		arena->usedMemory += (alint)growth;
+
+		if(arena->usedMemory > arena->peakMemory) {
+			arena->peakMemory = arena->usedMemory;
+		}
+
+		return value;
+	}
+
+	result = memory_arenaAllocate(arena, length, file, function, line);
+
+	memcpy(result, value, oldLength);
+
+	return result;
+}
+
+void memory_arenaRelease(MemoryArena *arena, void *value, const char *file,
+		const char *function, size_t line)
+{
+	int allocationLength = 0;
+
+	MemoryArenaBlock *block = NULL;
+
+	if(arena == NULL) {
+		memory_free(value, file, function, line);
+		return;
+	}
+
+	if(value == NULL) {
+		return;
+	}
+
+	/*
+	 * arena memory is released by a reset, only the most recent allocation
+	 * is reclaimed immediately
+	 */
+
+	block = arena->current;
+	allocationLength = (MEMORY_ARENA_ALIGNMENT +
+			memory_arenaAlign(*((int *)((char *)value -
+						MEMORY_ARENA_ALIGNMENT))));
+
+	if((block != NULL) &&
+			(((char *)value - MEMORY_ARENA_ALIGNMENT + allocationLength) ==
+			 (memory_arenaBlockData(block) + block->ref))) {
+		block->ref -= allocationLength;
+		arena->usedMemory -= (alint)allocationLength;
+	}
+}
+
+char *memory_arenaStrdup(MemoryArena *arena, char *string, const char *file,
+		const char *function, size_t line)
+{
+	int length = 0;
+	char *result = NULL;
+
+	if(arena == NULL) {
+		return memory_strdup(string, file, function, line);
+	}
+
+	if(string == NULL) {
+		if(EXPLICIT_ERRORS) {
+			fprintf(stderr, "[%s():%i] error - unable to duplicate NULL "
+					"string from [%s->%s():%i].\n", __FUNCTION__, __LINE__,
+					(char *)file, (char *)function, (int)line);
+		}
+		string = "";
+	}
+
+	length = (int)strlen(string);
+	result = (char *)memory_arenaAllocate(arena, (sizeof(char) * (length + 1)),
+			file, function, line);
+
+	if(length > 0) {
+		memcpy(result, string, length);
+	}
+
+	return result;
+}
+
+char *memory_arenaStrndup(MemoryArena *arena, char *string, int length,
+		const char *file, const char *function, size_t line)
+{
+	char *result = NULL;
+
+	if(arena == NULL) {
+		return memory_strndup(string, length, file, function, line);
+	}
+
+	if(string == NULL) {
+		if(EXPLICIT_ERRORS) {
+			fprintf(stderr, "[%s():%i] error - unable to duplicate NULL "
+					"string from [%s->%s():%i].\n", __FUNCTION__, __LINE__,
+					(char *)file, (char *)function, (int)line);
+		}
+		string = "";
+	}
+	if(length < 1) {
+		if(EXPLICIT_ERRORS) {
+			fprintf(stderr, "[%s():%i] error - unable to duplicate string "
+					"with length %i from [%s->%s():%i].\n", __FUNCTION__,
+					__LINE__, length, (char *)file, (char *)function,
+					(int)line);
+		}
+		length = (int)strlen(string);
+	}
+
+	result = (char *)memory_arenaAllocate(arena, (sizeof(char) * (length + 1)),
+			file, function, line);
+
+	if(length > 0) {
+		memcpy(result, string, length);
+	}
+
+	return result;
+}
+
 void memory_displayStatus()
 {
+	int ii = 0;
+	alint handoffItems = 0;
+	alint handoffMemory = 0;
+	alint threadCachedItems = 0;
+	alint threadCachedMemory = 0;
+	MemcacheThread *thread = NULL;
+
 #if defined(MEMCACHE_BYPASS)
 	return;
 #endif // MEMCACHE_BYPASS
@@ -1161,6 +2172,21 @@ void memory_displayStatus()
 		memory_init();
 	}
 
+	mutex_lock(&memcache->mutex);
+
+	for(thread = memcache->threads; thread != NULL; thread = thread->next) {
+		threadCachedItems += thread->cachedItems;
+		threadCachedMemory += thread->cachedMemory;
+	}
+
+	mutex_unlock(&memcache->mutex);
+
+	for(ii = 0; ii < memcache->threadSlotLength; ii++) {
+		handoffItems += memcache->cache[ii].handoffLength;
+		handoffMemory += (memcache->cache[ii].handoffLength *
+				(alint)(memcache->cache[ii].length + (SIZEOF_INT * 3)));
+	}
+
 	printf("memcache status:\n");
 
 	printf("    cache length             : %i\n", memcache->cacheLength);
@@ -1171,11 +2197,16 @@ void memory_displayStatus()
 	printf("    target memory footprint  : %lli\n",
 			memcache->targetMemoryFootprint);
 	printf("    allocated memory         : %lli\n", memcache->allocatedMemory);
-	printf("    cached memory            : %lli\n", memcache->cachedMemory);
+	printf("    cached memory            : %lli\n",
+			(memcache->cachedMemory + handoffMemory + threadCachedMemory));
+	printf("    thread cached memory     : %lli\n", threadCachedMemory);
+	printf("    handoff cached memory    : %lli\n", handoffMemory);
 	printf("    in-use memory            : %lli\n",
-			(memcache->allocatedMemory - memcache->cachedMemory));
+			(memcache->allocatedMemory - (memcache->cachedMemory +
+										  handoffMemory +
+										  threadCachedMemory)));
 	printf("    total cached items       : %lli\n",
-			memcache->totalCachedItems);
+			(memcache->totalCachedItems + handoffItems + threadCachedItems));
 	printf("    total slot ticks         : %lli\n", memcache->totalSlotTicks);
 
 	if(DISPLAY_SLOT_PROFILE) {
@@ -1186,6 +2217,14 @@ void memory_displayStatus()
 void memory_displaySlotProfile()
 {
 	int ii = 0;
+	int threadLength = 0;
+	int *inUse = NULL;
+	alint *ticks = NULL;
+	alint totalSlotTicks = 0;
+	alint hits = 0;
+	alint misses = 0;
+	MemcacheThread *thread = NULL;
+	MemcacheThread *threads = NULL;
 
 #if defined(MEMCACHE_BYPASS)
 	return;
@@ -1195,6 +2234,55 @@ void memory_displaySlotProfile()
 		memory_init();
 	}
 
+	/*
+	 * snapshot the slot & thread-cache counters under the lock, since the
+	 * display functions allocate memory
+	 */
+
+	inUse = (int *)local_malloc((sizeof(int) * memcache->cacheLength),
+			__FILE__, __FUNCTION__, __LINE__);
+	ticks = (alint *)local_malloc((sizeof(alint) * memcache->cacheLength),
+			__FILE__, __FUNCTION__, __LINE__);
+
+	mutex_lock(&memcache->mutex);
+
+	for(thread = memcache->threads; thread != NULL; thread = thread->next) {
+		threadLength++;
+	}
+
+	threads = (MemcacheThread *)local_malloc((int)(sizeof(MemcacheThread) *
+				(threadLength + 1)), __FILE__, __FUNCTION__, __LINE__);
+
+	totalSlotTicks = memcache->totalSlotTicks;
+
+	for(ii = 0; ii < memcache->cacheLength; ii++) {
+		inUse[ii] = memcache->cache[ii].inUse;
+		ticks[ii] = memcache->cache[ii].ticks;
+		if(ii < memcache->threadSlotLength) {
+			for(thread = memcache->threads; thread != NULL;
+					thread = thread->next) {
+				inUse[ii] += thread->slots[ii].inUse;
+				ticks[ii] += thread->slots[ii].ticks;
+				totalSlotTicks += thread->slots[ii].ticks;
+			}
+		}
+		if(inUse[ii] > memcache->cache[ii].peak) {
+			memcache->cache[ii].peak = inUse[ii];
+		}
+	}
+
+	for(ii = 0, thread = memcache->threads; thread != NULL;
+			ii++, thread = thread->next) {
+		memcpy(&threads[ii], thread, sizeof(MemcacheThread));
+		hits += thread->hits;
+		misses += thread->misses;
+	}
+
+	hits += memcache->retiredHits;
+	misses += memcache->retiredMisses;
+
+	mutex_unlock(&memcache->mutex);
+
 	printf("memcache slot profile:\n");
 
 	printf("    slot usage:\n");
@@ -1207,11 +2295,38 @@ void memory_displaySlotProfile()
 				memlist_length(&memcache->cache[ii].bucket),
 				(((double)memlist_length(&memcache->cache[ii].bucket) /
 				  (double)memcache->totalCachedItems) * 100.0),
-				memcache->cache[ii].ticks,
-				(((double)memcache->cache[ii].ticks /
-				  (double)memcache->totalSlotTicks) * 100.0),
+				ticks[ii],
+				(((double)ticks[ii] / (double)totalSlotTicks) * 100.0),
 			   memcache->cache[ii].peak);
 	}
+
+	printf("    thread cache usage:\n");
+	printf("        thread              hits            misses   hit-rate"
+		   "     refills     flushes        cached\n");
+	for(ii = 0; ii < threadLength; ii++) {
+		printf("        %6i  %16lli  %16lli  %7.2f %%  %10lli  %10lli  "
+				"%12lli\n",
+				threads[ii].uid,
+				threads[ii].hits,
+				threads[ii].misses,
+				(((double)threads[ii].hits /
+				  (double)((threads[ii].hits + threads[ii].misses) > 0 ?
+					  (threads[ii].hits + threads[ii].misses) : 1)) * 100.0),
+				threads[ii].refills,
+				threads[ii].flushes,
+				threads[ii].cachedMemory);
+	}
+
+	printf("        %6s  %16lli  %16lli  %7.2f %%\n",
+			"total",
+			hits,
+			misses,
+			(((double)hits /
+			  (double)((hits + misses) > 0 ? (hits + misses) : 1)) * 100.0));
+
+	local_free(threads, __FILE__, __FUNCTION__, __LINE__);
+	local_free(ticks, __FILE__, __FUNCTION__, __LINE__);
+	local_free(inUse, __FILE__, __FUNCTION__, __LINE__);
 }
 
 void *memory_getState()
@@ -21,6 +21,27 @@
 extern "C" {
 #endif // __cplusplus
 
+// define memory public data types
+
+typedef struct _MemoryArenaBlock {
+	int length;
+	int ref;
+	struct _MemoryArenaBlock *next;
+} MemoryArenaBlock;
+
+typedef struct _MemoryArena {
+	int blockLength;
+	int blockCount;
+	alint allocations;
+	alint resets;
+	alint allocatedMemory;
+	alint usedMemory;
+	alint peakMemory;
+	MemoryArenaBlock *current;
+	MemoryArenaBlock *blocks;
+} MemoryArena;
+
+
 // delcare memory public functions
 
 void memory_init();
@@ -34,6 +55,8 @@ void *memory_reallocate(void *value, int length, const char *file,
 void memory_free(void *value, const char *file, const char *function,
 		size_t line);
 
+void memory_releaseThreadCache();
+
 void memory_systemFree(void *value, const char *file, const char *function,
 		size_t line);
 
@@ -56,6 +79,29 @@ char *memory_bitoa(alint value, const char *file, const char *function,
 char *memory_dtoa(double value, const char *file, const char *function,
 		size_t line);
 
+// memory arena functions
+
+int memory_arenaInit(MemoryArena *arena, int blockLength);
+
+void memory_arenaFree(MemoryArena *arena);
+
+void memory_arenaReset(MemoryArena *arena);
+
+void *memory_arenaAllocate(MemoryArena *arena, int length, const char *file,
+		const char *function, size_t line);
+
+void *memory_arenaReallocate(MemoryArena *arena, void *value, int length,
+		const char *file, const char *function, size_t line);
+
+void memory_arenaRelease(MemoryArena *arena, void *value, const char *file,
+		const char *function, size_t line);
+
+char *memory_arenaStrdup(MemoryArena *arena, char *string, const char *file,
+		const char *function, size_t line);
+
+char *memory_arenaStrndup(MemoryArena *arena, char *string, int length,
+		const char *file, const char *function, size_t line);
+
 void memory_displayStatus();
 
 void memory_displaySlotProfile();
@@ -126,6 +172,26 @@ int memory_setState(void *state);
 #endif // MEMORY_PROTECT
 
 
+// define memory arena public macros
+
+#define arenaMalloc(arena, length) \
+	memory_arenaAllocate(arena, length, __FILE__, __FUNCTION__, __LINE__)
+
+#define arenaRealloc(arena, addr, length) \
+	memory_arenaReallocate(arena, addr, length, __FILE__, __FUNCTION__, \
+			__LINE__)
+
+#define arenaFree(arena, addr) \
+	memory_arenaRelease(arena, addr, __FILE__, __FUNCTION__, __LINE__)
+
+#define arenaStrdup(arena, string) \
+	memory_arenaStrdup(arena, string, __FILE__, __FUNCTION__, __LINE__)
+
+#define arenaStrndup(arena, string, length) \
+	memory_arenaStrndup(arena, string, length, __FILE__, __FUNCTION__, \
+			__LINE__)
+
+
 // define memory public constants
 
 #define MEMORY_MALLOC_FUNCTION			memory_allocate
@@ -140,6 +206,8 @@ int memory_setState(void *state);
 
 #define MEMORY_STRNDUP_FUNCTION			memory_strndup
 
+#define MEMORY_ARENA_DEFAULT_BLOCK_LENGTH		65536
+
 
 #if defined(__cplusplus)
 };
@@ -20,6 +20,24 @@
 #define PERFORMANCE_TEST_ITERATIONS						131072
 //#define PERFORMANCE_TEST_ITERATIONS						1048576
 
+#define THREAD_CACHE_TEST_THREADS						4
+
+#define THREAD_CACHE_TEST_ITERATIONS					16384
+
+#define ARENA_TEST_BLOCK_LENGTH							4096
+
+#define ARENA_TEST_ITERATIONS							1024
+
+
+// define memory unit test private data types
+
+typedef struct _ThreadCacheTest {
+	int id;
+	int errors;
+	void **array;
+	void **neighbor;
+} ThreadCacheTest;
+
 
 // declare memory unit test private functions
 
@@ -27,6 +45,10 @@ static int memory_basicFunctionalityTest();
 
 static int memory_basicPerformanceTest();
 
+static int memory_threadCacheTest();
+
+static int memory_arenaTest();
+
 
 // main function
 
@@ -49,6 +71,16 @@ int main()
 		return 1;
 	}
 
+	if(memory_threadCacheTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(memory_arenaTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
 	memory_displayStatus();
 	memory_displaySlotProfile();
 
@@ -187,3 +219,297 @@ static int memory_basicPerformanceTest()
 	return 0;
 }
 
+static void *threadCacheWorker(void *argument)
+{
+	int ii = 0;
+	int nn = 0;
+	int length = 0;
+	unsigned char *memory = NULL;
+	ThreadCacheTest *test = NULL;
+
+	test = (ThreadCacheTest *)argument;
+
+	// free the blocks allocated by the neighboring thread, handing them off
+
+	if(test->neighbor != NULL) {
+		for(ii = 0; ii < THREAD_CACHE_TEST_ITERATIONS; ii++) {
+			if(test->neighbor[ii] != NULL) {
+				free(test->neighbor[ii]);
+				test->neighbor[ii] = NULL;
+			}
+		}
+	}
+
+	for(ii = 0; ii < THREAD_CACHE_TEST_ITERATIONS; ii++) {
+		length = (((ii * 7) + test->id) % 8192) + 1;
+
+		memory = (unsigned char *)malloc(length);
+		for(nn = 0; nn < length; nn++) {
+			if(memory[nn] != 0) {
+				test->errors += 1;
+				break;
+			}
+		}
+		memset(memory, (test->id + 1), length);
+
+		if((ii % 3) == 0) {
+			free(memory);
+			test->array[ii] = NULL;
+		}
+		else {
+			test->array[ii] = memory;
+		}
+	}
+
+	for(ii = 0; ii < THREAD_CACHE_TEST_ITERATIONS; ii++) {
+		if(test->array[ii] == NULL) {
+			continue;
+		}
+
+		length = (((ii * 7) + test->id) % 8192) + 1;
+		memory = (unsigned char *)test->array[ii];
+
+		for(nn = 0; nn < length; nn++) {
+			if(memory[nn] != (unsigned char)(test->id + 1)) {
+				test->errors += 1;
+				break;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static int memory_threadCacheTest()
+{
+	int ii = 0;
+	int nn = 0;
+	int pass = 0;
+	Thread threads[THREAD_CACHE_TEST_THREADS];
+	ThreadCacheTest tests[THREAD_CACHE_TEST_THREADS];
+
+	printf("[unit]\t memory thread cache test...\n");
+
+	for(ii = 0; ii < THREAD_CACHE_TEST_THREADS; ii++) {
+		tests[ii].id = ii;
+		tests[ii].errors = 0;
+		tests[ii].array = (void **)malloc(sizeof(void *) *
+				THREAD_CACHE_TEST_ITERATIONS);
+		tests[ii].neighbor = NULL;
+	}
+
+	for(pass = 0; pass < 2; pass++) {
+		for(ii = 0; ii < THREAD_CACHE_TEST_THREADS; ii++) {
+			if(pass > 0) {
+				nn = ((ii + 1) % THREAD_CACHE_TEST_THREADS);
+				tests[ii].neighbor = tests[nn].array;
+				tests[nn].array = (void **)malloc(sizeof(void *) *
+						THREAD_CACHE_TEST_ITERATIONS);
+			}
+		}
+
+		for(ii = 0; ii < THREAD_CACHE_TEST_THREADS; ii++) {
+			thread_init(&threads[ii]);
+			thread_create(&threads[ii], threadCacheWorker,
+					(void *)&tests[ii]);
+		}
+
+		for(ii = 0; ii < THREAD_CACHE_TEST_THREADS; ii++) {
+			thread_join(&threads[ii], NULL);
+
+			if(tests[ii].errors > 0) {
+				printf("[unit]\t\t ...ERROR, thread %i detected %i "
+						"corrupted blocks, aborting.\n", ii,
+						tests[ii].errors);
+				return -1;
+			}
+		}
+
+		for(ii = 0; ii < THREAD_CACHE_TEST_THREADS; ii++) {
+			if(tests[ii].neighbor != NULL) {
+				free(tests[ii].neighbor);
+				tests[ii].neighbor = NULL;
+			}
+		}
+	}
+
+	for(ii = 0; ii < THREAD_CACHE_TEST_THREADS; ii++) {
+		for(nn = 0; nn < THREAD_CACHE_TEST_ITERATIONS; nn++) {
+			if(tests[ii].array[nn] != NULL) {
+				free(tests[ii].array[nn]);
+			}
+		}
+		free(tests[ii].array);
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int memory_arenaTest()
+{
+	int ii = 0;
+	int nn = 0;
+	int length = 0;
+	int blockCount = 0;
+	char *string = NULL;
+	unsigned char *memory = NULL;
+	unsigned char *previous = NULL;
+	MemoryArena arena;
+
+	printf("[unit]\t memory arena test...\n");
+
+	if(memory_arenaInit(&arena, ARENA_TEST_BLOCK_LENGTH) < 0) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < ARENA_TEST_ITERATIONS; ii++) {
+		if((ii % 64) == 0) {
+			length = (ARENA_TEST_BLOCK_LENGTH * 2);
+		}
+		else {
+			length = (((ii * 13) % 512) + 1);
+		}
+
+		if((memory = (unsigned char *)arenaMalloc(&arena, length)) == NULL) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		if(((unsigned long)memory % 8) != 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+
+		for(nn = 0; nn < length; nn++) {
+			if(memory[nn] != 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+
+		memset(memory, 0xff, length);
+	}
+
+	// reallocate the most recent allocation in place
+
+	previous = (unsigned char *)arenaMalloc(&arena, 16);
+	memset(previous, 'a', 16);
+
+	if((memory = (unsigned char *)arenaRealloc(&arena, previous, 32)) !=
+			previous) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(nn = 0; nn < 32; nn++) {
+		if(((nn < 16) && (memory[nn] != 'a')) ||
+				((nn >= 16) && (memory[nn] != 0))) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	// reallocate an older allocation, forcing a copy
+
+	string = arenaStrdup(&arena, "arena test string");
+	arenaMalloc(&arena, 8);
+
+	if(((string = (char *)arenaRealloc(&arena, string, 64)) == NULL) ||
+			(strcmp(string, "arena test string"))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	// release the most recent allocation, and reclaim its space
+
+	previous = (unsigned char *)arenaMalloc(&arena, 128);
+	arenaFree(&arena, previous);
+
+	if((memory = (unsigned char *)arenaMalloc(&arena, 128)) != previous) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	for(nn = 0; nn < 128; nn++) {
+		if(memory[nn] != 0) {
+			printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+					__LINE__);
+			return -1;
+		}
+	}
+
+	if(((string = arenaStrndup(&arena, "abcdef", 3)) == NULL) ||
+			(strcmp(string, "abc"))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t\t arena blocks         : %i\n", arena.blockCount);
+	printf("[unit]\t\t arena allocations    : %lli\n",
+			(long long int)arena.allocations);
+	printf("[unit]\t\t arena peak memory    : %lli bytes\n",
+			(long long int)arena.peakMemory);
+
+	// reset the arena, releasing oversized blocks and retaining the rest
+
+	blockCount = arena.blockCount;
+
+	memory_arenaReset(&arena);
+
+	if((arena.blockCount < 1) || (arena.blockCount >= blockCount) ||
+			(arena.usedMemory != 0) || (arena.resets != 1)) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	blockCount = arena.blockCount;
+
+	for(ii = 0; ii < ARENA_TEST_ITERATIONS; ii++) {
+		memory = (unsigned char *)arenaMalloc(&arena, 8);
+		for(nn = 0; nn < 8; nn++) {
+			if(memory[nn] != 0) {
+				printf("[unit]\t\t ...ERROR, failed at line %i, "
+						"aborting.\n", __LINE__);
+				return -1;
+			}
+		}
+	}
+
+	if(arena.blockCount > blockCount) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	memory_arenaFree(&arena);
+
+	// a NULL arena falls back to the heap
+
+	if(((string = arenaStrdup(NULL, "heap string")) == NULL) ||
+			(strcmp(string, "heap string"))) {
+		printf("[unit]\t\t ...ERROR, failed at line %i, aborting.\n",
+				__LINE__);
+		return -1;
+	}
+
+	string = (char *)arenaRealloc(NULL, string, 128);
+	arenaFree(NULL, string);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
@@ -80,6 +80,112 @@ static int setSocketOption(Socket *socket, int type, int option, int value)
 }
 
 
+#if defined(__linux__)
+static int sendVectors(int sd, struct iovec *vectors, int vectorCount,
+		aboolean hasMore)
+{
+	int ii = 0;
+	int flags = MSG_NOSIGNAL;
+	ssize_t rc = 0;
+
+	struct msghdr message;
+
+	// sendmsg() rather than writev(), since only the former takes
+	// MSG_NOSIGNAL
+
+	if(hasMore) {
+		flags |= MSG_MORE;
+	}
+
+	while(vectorCount > 0) {
+		memset(&message, 0, (int)sizeof(struct msghdr));
+
+		message.msg_iov = vectors;
+		message.msg_iovlen = (size_t)vectorCount;
+
+		if((rc = sendmsg(sd, &message, flags)) < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+
+		// step past whatever the kernel accepted, and resume from there
+
+		for(ii = 0; ((ii < vectorCount) &&
+					((size_t)rc >= vectors[ii].iov_len)); ii++) {
+			rc -= (ssize_t)vectors[ii].iov_len;
+		}
+
+		vectors += ii;
+		vectorCount -= ii;
+
+		if(vectorCount > 0) {
+			vectors[0].iov_base = ((char *)vectors[0].iov_base + rc);
+			vectors[0].iov_len -= (size_t)rc;
+		}
+	}
+
+	return 0;
+}
+
+static int sendFileSegment(int sd, SocketSegment *segment)
+{
+	int result = 0;
+	ssize_t rc = 0;
+	off_t offset = 0;
+	alint remaining = 0;
+
+	sigset_t pipeSet;
+	sigset_t previousSet;
+	struct timespec noWait;
+
+	/*
+	 * sendfile() has no MSG_NOSIGNAL, so keep SIGPIPE blocked on this thread
+	 * for the transfer and discard one raised by a departed peer.
+	 *
+	 * Note: the file position is never used, so a cached file handle may be
+	 * sent by several threads at once.
+	 */
+
+	sigemptyset(&pipeSet);
+	sigaddset(&pipeSet, SIGPIPE);
+
+	pthread_sigmask(SIG_BLOCK, &pipeSet, &previousSet);
+
+	offset = (off_t)segment->fileOffset;
+	remaining = segment->length;
+
+	while(remaining > 0) {
+		if((rc = sendfile(sd, fileno(segment->file), &offset,
+						(size_t)remaining)) < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			if((errno == EPIPE) && (!sigismember(&previousSet, SIGPIPE))) {
+				noWait.tv_sec = 0;
+				noWait.tv_nsec = 0;
+				sigtimedwait(&pipeSet, NULL, &noWait);
+			}
+			result = -1;
+			break;
+		}
+		else if(rc == 0) {
+			// the file is shorter than the segment claims
+			result = -1;
+			break;
+		}
+
+		remaining -= (alint)rc;
+	}
+
+	pthread_sigmask(SIG_SETMASK, &previousSet, NULL);
+
+	return result;
+}
+#endif // __linux__
+
+
 // define socket (linux plugin) public functions
 
 int socket_initLinux(Socket *socket)
@@ -459,6 +565,48 @@ int socket_sendLinux(Socket *socket, int sd, char *value, int valueLength)
 	return 0;
 }
 
+#if defined(__linux__)
+int socket_sendSegmentsLinux(Socket *socket, int sd, SocketSegment *segments,
+		int segmentCount)
+{
+	int ii = 0;
+	int vectorCount = 0;
+
+	struct iovec vectors[SOCKET_MAX_SEGMENTS];
+
+	if((socket == NULL) || (socket->plugin == NULL) || (segments == NULL) ||
+			(segmentCount < 1) || (segmentCount > SOCKET_MAX_SEGMENTS)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	while(ii < segmentCount) {
+		if(segments[ii].file != NULL) {
+			if(sendFileSegment(sd, &segments[ii]) < 0) {
+				return -1;
+			}
+			ii++;
+			continue;
+		}
+
+		// gather the run of memory segments ahead of the next file segment
+
+		for(vectorCount = 0; ((ii < segmentCount) &&
+					(segments[ii].file == NULL)); ii++, vectorCount++) {
+			vectors[vectorCount].iov_base = (void *)segments[ii].value;
+			vectors[vectorCount].iov_len = (size_t)segments[ii].length;
+		}
+
+		if(sendVectors(sd, vectors, vectorCount,
+					(aboolean)(ii < segmentCount)) < 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+#endif // __linux__
+
 int socket_receiveLinux(Socket *socket, int sd, char *value,
 		int valueLength, double timeoutSeconds)
 {
@@ -534,6 +682,10 @@ int socket_receiveLinux(Socket *socket, int sd, char *value,
 			}
 			break;
 		}
+		else if(rc == 0) {
+			// the peer performed an orderly shutdown
+			break;
+		}
 
 		bytesReceived += rc;
 
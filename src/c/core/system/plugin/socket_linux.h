@@ -56,6 +56,11 @@ char *socket_getPeerNameLinux(Socket *socket, int sd);
 
 int socket_sendLinux(Socket *socket, int sd, char *value, int valueLength);
 
+#if defined(__linux__)
+int socket_sendSegmentsLinux(Socket *socket, int sd, SocketSegment *segments,
+		int segmentCount);
+#endif // __linux__
+
 int socket_receiveLinux(Socket *socket, int sd, char *value,
 		int valueLength, double timeoutSeconds);
 
@@ -556,6 +556,10 @@ int socket_receiveWindows(Socket *socket, int sd, char *value,
 			}
 			break;
 		}
+		else if(rc == 0) {
+			// the peer performed an orderly shutdown
+			break;
+		}
 
 		bytesReceived += rc;
 
@@ -19,6 +19,91 @@
 #include "core/system/plugin/socket_windows.h"
 
 
+// define socket private functions
+
+static int sendValue(Socket *socket, int sd, char *value, int valueLength)
+{
+#if defined(__linux__) || defined(__APPLE__) || defined(MINGW)
+	return socket_sendLinux(socket, sd, value, valueLength);
+#elif defined(WIN32)
+	return socket_sendWindows(socket, sd, value, valueLength);
+#else // - no plugin available -
+	return -1;
+#endif // - plugins -
+}
+
+static int sendSegmentsInChunks(Socket *socket, int sd,
+		SocketSegment *segments, int segmentCount)
+{
+	int ii = 0;
+	int rc = 0;
+	int chunkLength = 0;
+	alint offset = 0;
+	alint remaining = 0;
+	char *chunk = NULL;
+
+	for(ii = 0; ((rc == 0) && (ii < segmentCount)); ii++) {
+		if(segments[ii].file == NULL) {
+			if(segments[ii].length > 0) {
+				rc = sendValue(socket, sd, segments[ii].value,
+						(int)segments[ii].length);
+			}
+			continue;
+		}
+
+		if(chunk == NULL) {
+			chunk = (char *)malloc(sizeof(char) *
+					SOCKET_DEFAULT_CHUNK_LENGTH);
+		}
+
+		offset = segments[ii].fileOffset;
+		remaining = segments[ii].length;
+
+		while(remaining > 0) {
+			chunkLength = SOCKET_DEFAULT_CHUNK_LENGTH;
+			if(remaining < (alint)chunkLength) {
+				chunkLength = (int)remaining;
+			}
+
+			// the file handle may be shared, so hold it across the seek and
+			// the read
+
+#if defined(WIN32)
+			_lock_file(segments[ii].file);
+#else // !WIN32
+			flockfile(segments[ii].file);
+#endif // WIN32
+
+			if((fseeko(segments[ii].file, offset, SEEK_SET) != 0) ||
+					(fread(chunk, sizeof(char), chunkLength,
+						   segments[ii].file) != (size_t)chunkLength)) {
+				rc = -1;
+			}
+
+#if defined(WIN32)
+			_unlock_file(segments[ii].file);
+#else // !WIN32
+			funlockfile(segments[ii].file);
+#endif // WIN32
+
+			if((rc < 0) ||
+					((rc = sendValue(socket, sd, chunk, chunkLength)) < 0)) {
+				break;
+			}
+
+			offset += (alint)chunkLength;
+			remaining -= (alint)chunkLength;
+		}
+	}
+
+	if(chunk != NULL) {
+		free(chunk);
+	}
+
+	return rc;
+}
+
+
 // define socket public functions
 
 int socket_init(Socket *socket, SocketMode mode, SocketProtocol protocol,
@@ -885,6 +970,88 @@ int socket_send(Socket *socket, int sd, char *value, int valueLength)
 	return rc;
 }
 
+int socket_sendSegments(Socket *socket, int sd, SocketSegment *segments,
+		int segmentCount)
+{
+	int ii = 0;
+	int rc = 0;
+	alint totalLength = 0;
+	double timer = 0.0;
+	double elapsedTime = 0.0;
+	double sleepTime = 0.0;
+
+	if((socket == NULL) || (socket->state != SOCKET_STATE_OPEN) ||
+			(sd < 0) || (segments == NULL) || (segmentCount < 1) ||
+			(segmentCount > SOCKET_MAX_SEGMENTS)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	for(ii = 0; ii < segmentCount; ii++) {
+		if((segments[ii].length < 0) || (segments[ii].fileOffset < 0) ||
+				((segments[ii].value == NULL) &&
+				 (segments[ii].file == NULL)) ||
+				((segments[ii].value != NULL) &&
+				 (segments[ii].file != NULL))) {
+			DISPLAY_INVALID_ARGS;
+			return -1;
+		}
+
+		totalLength += segments[ii].length;
+	}
+
+	if(totalLength < 1) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	timer = time_getTimeMus();
+
+	mutex_lock(&socket->metrics.mutex);
+	socket->metrics.writesAttempted += 1;
+	mutex_unlock(&socket->metrics.mutex);
+
+	/*
+	 * Linux hands the segments to the kernel as they are, gathering memory
+	 * with sendmsg() and sending files with sendfile(); everything else sends
+	 * them one at a time, reading file segments through a bounce buffer.
+	 */
+
+#if defined(__linux__)
+	if(socket->protocol == SOCKET_PROTOCOL_TCPIP) {
+		rc = socket_sendSegmentsLinux(socket, sd, segments, segmentCount);
+	}
+	else {
+		rc = sendSegmentsInChunks(socket, sd, segments, segmentCount);
+	}
+#else // !__linux__
+	rc = sendSegmentsInChunks(socket, sd, segments, segmentCount);
+#endif // __linux__
+
+	elapsedTime = time_getElapsedMusInSeconds(timer);
+
+	mutex_lock(&socket->metrics.mutex);
+
+	if(rc == 0) {
+		socket->metrics.bytesSent += totalLength;
+		socket->metrics.writesCompleted += 1;
+	}
+
+	socket->metrics.totalWriteTime += elapsedTime;
+
+	mutex_unlock(&socket->metrics.mutex);
+
+	if((rc == 0) && (socket->config.useSocketWriteSync)) {
+		sleepTime = ((double)socket->config.timeoutMillis -
+				(elapsedTime * 1000.0));
+		if(sleepTime > 0.0) {
+			time_usleep((int)(sleepTime * 1000.0));
+		}
+	}
+
+	return rc;
+}
+
 int socket_receive(Socket *socket, int sd, char *value, int valueLength,
 		double timeoutSeconds)
 {
@@ -66,6 +66,8 @@ typedef enum _SocketProtocol {
 
 #define SOCKET_DEFAULT_MAX_RECEIVE_LENGTH			16777216
 
+#define SOCKET_MAX_SEGMENTS							16
+
 
 // define socket public data types
 
@@ -93,6 +95,19 @@ typedef struct _SocketMetrics {
 	Mutex mutex;
 } SocketMetrics;
 
+/*
+ * A segment is either a run of memory (value), or a range of an open file
+ * (file, fileOffset), sent in order by socket_sendSegments() without first
+ * being copied into a single contiguous buffer.
+ */
+
+typedef struct _SocketSegment {
+	alint length;
+	alint fileOffset;
+	char *value;
+	FILE *file;
+} SocketSegment;
+
 typedef struct _Socket {
 	int port;
 	char *hostname;
@@ -189,6 +204,9 @@ int socket_getPeerName(Socket *socket, int sd, char **peerName);
 
 int socket_send(Socket *socket, int sd, char *value, int valueLength);
 
+int socket_sendSegments(Socket *socket, int sd, SocketSegment *segments,
+		int segmentCount);
+
 int socket_receive(Socket *socket, int sd, char *value, int valueLength,
 		double timeoutSeconds);
 
@@ -786,7 +786,7 @@ int authSystem_init(AuthSystem *system, Log *log)
 		return -1;
 	}
 
-	if(managedIndex_init(&system->tokens, atrue) < 0) {
+	if(managedIndex_init(&system->tokens, atrue, afalse) < 0) {
 		return -1;
 	}
 
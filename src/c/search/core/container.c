@@ -2183,6 +2183,89 @@ Json *container_containerToJson(Container *container)
 	return result;
 }
 
+int container_writeJson(Container *container, JsonWriter *writer)
+{
+	ContainerIterator iterator;
+
+	if((container == NULL) || (writer == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	/*
+	 * note: the members are written into the writer's current object, in the
+	 * same form as container_containerToJson(), so that the caller may append
+	 * members of its own before closing it
+	 */
+
+	if(spinlock_readLock(&container->lock) < 0) {
+		return -1;
+	}
+
+	if(containerIterator_init(container, &iterator) < 0) {
+		spinlock_readUnlock(&container->lock);
+		return -1;
+	}
+
+	jsonWriter_writeName(writer, "containerMetaData");
+	jsonWriter_beginObject(writer);
+
+	jsonWriter_writeName(writer, "uid");
+	jsonWriter_writeNumber(writer, (double)container->uid);
+	jsonWriter_writeName(writer, "timestamp");
+	jsonWriter_writeNumber(writer, container->timestamp);
+	jsonWriter_writeName(writer, "age");
+	jsonWriter_writeNumber(writer,
+			time_getElapsedMusInSeconds(container->timestamp));
+
+	if(container->name != NULL) {
+		jsonWriter_writeName(writer, "name");
+		jsonWriter_writeString(writer, container->name,
+				strlen(container->name));
+	}
+
+	jsonWriter_endObject(writer);
+
+	while(containerIterator_next(&iterator) == CONTAINER_ITERATOR_OK) {
+		if((strstr(iterator.entity.name, "relevancyIndex") != NULL) ||
+				(strstr(iterator.entity.name, "searchd_domainKey") != NULL)) {
+			continue;
+		}
+
+		jsonWriter_writeName(writer, iterator.entity.name);
+
+		switch(iterator.entity.type) {
+			case CONTAINER_TYPE_BOOLEAN:
+				jsonWriter_writeBoolean(writer, iterator.entity.bValue);
+				break;
+
+			case CONTAINER_TYPE_INTEGER:
+				jsonWriter_writeNumber(writer,
+						(double)iterator.entity.iValue);
+				break;
+
+			case CONTAINER_TYPE_DOUBLE:
+				jsonWriter_writeNumber(writer, iterator.entity.dValue);
+				break;
+
+			case CONTAINER_TYPE_STRING:
+				jsonWriter_writeString(writer, iterator.entity.sValue,
+						strlen(iterator.entity.sValue));
+				break;
+
+			case CONTAINER_TYPE_END_OF_LIST:
+			default:
+				jsonWriter_writeString(writer, "(unknown)", 9);
+		}
+	}
+
+	containerIterator_free(&iterator);
+
+	spinlock_readUnlock(&container->lock);
+
+	return 0;
+}
+
 Container *container_combine(Container *oldContainer, Container *newContainer,
 		char flags, char **errorMessage)
 {
@@ -190,6 +190,8 @@ Container *container_jsonToContainer(Json *object);
 
 Json *container_containerToJson(Container *container);
 
+int container_writeJson(Container *container, JsonWriter *writer);
+
 Container *container_combine(Container *oldContainer, Container *newContainer,
 		char flags, char **errorMessage);
 
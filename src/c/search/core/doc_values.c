@@ -0,0 +1,506 @@
+/*
+ * doc_values.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * A library component for the search-engine to maintain a columnar store of
+ * attribute values by container UID, for sorting and faceting without
+ * accessing the containers.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#include "search/search.h"
+#define _SEARCH_CORE_COMPONENT
+#include "search/core/doc_values.h"
+
+
+// declare doc values private functions
+
+static void freeNothing(void *memory);
+
+static char *copyValue(char *value, int valueLength);
+
+static DocValuesEntry *getEntry(DocValues *docValues, char *value,
+		int valueLength);
+
+static DocValuesEntry *newEntry(DocValues *docValues, char *value,
+		int valueLength);
+
+static void freeEntries(DocValues *docValues);
+
+
+// define doc values private functions
+
+static void freeNothing(void *memory)
+{
+	if(memory == NULL) {
+		DISPLAY_INVALID_ARGS;
+	}
+}
+
+static char *copyValue(char *value, int valueLength)
+{
+	char *result = NULL;
+
+	result = (char *)malloc(sizeof(char) * (valueLength + 1));
+
+	if(valueLength > 0) {
+		memcpy(result, value, valueLength);
+	}
+
+	result[valueLength] = '\0';
+
+	return result;
+}
+
+static DocValuesEntry *getEntry(DocValues *docValues, char *value,
+		int valueLength)
+{
+	DocValuesEntry *result = NULL;
+
+	// note: the dictionary cannot hold zero-length keys
+
+	if(valueLength < 1) {
+		return docValues->emptyEntry;
+	}
+
+	if(bptree_get(&docValues->dictionary, value, valueLength,
+				((void *)&result)) < 0) {
+		return NULL;
+	}
+
+	return result;
+}
+
+static DocValuesEntry *newEntry(DocValues *docValues, char *value,
+		int valueLength)
+{
+	DocValuesEntry *result = NULL;
+
+	result = (DocValuesEntry *)malloc(sizeof(DocValuesEntry));
+
+	result->ordinal = docValues->entryLength;
+	result->references = 0;
+	result->length = valueLength;
+	result->relevancyLength = 0;
+	result->relevancyArrayLength = 0;
+	result->value = copyValue(value, valueLength);
+	result->relevancy = NULL;
+
+	if(valueLength < 1) {
+		docValues->emptyEntry = result;
+	}
+	else if(bptree_put(&docValues->dictionary, result->value, valueLength,
+				(void *)result) < 0) {
+		free(result->value);
+		free(result);
+		return NULL;
+	}
+
+	if(docValues->entryLength >= docValues->entryCapacity) {
+		docValues->entryCapacity *= 2;
+		docValues->entries = (DocValuesEntry **)realloc(docValues->entries,
+				(sizeof(DocValuesEntry *) * docValues->entryCapacity));
+	}
+
+	docValues->entries[docValues->entryLength] = result;
+	docValues->entryLength += 1;
+
+	return result;
+}
+
+static void freeEntries(DocValues *docValues)
+{
+	int ii = 0;
+
+	for(ii = 0; ii < docValues->entryLength; ii++) {
+		if(docValues->entries[ii]->value != NULL) {
+			free(docValues->entries[ii]->value);
+		}
+
+		if(docValues->entries[ii]->relevancy != NULL) {
+			free(docValues->entries[ii]->relevancy);
+		}
+
+		free(docValues->entries[ii]);
+	}
+
+	docValues->entryLength = 0;
+	docValues->emptyEntry = NULL;
+}
+
+
+// define doc values public functions
+
+int docValues_init(DocValues *docValues)
+{
+	if(docValues == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(docValues, 0, (int)(sizeof(DocValues)));
+
+	docValues->isEnabled = atrue;
+	docValues->uidLength = DOC_VALUES_DEFAULT_UID_LENGTH;
+	docValues->entryLength = 0;
+	docValues->entryCapacity = DOC_VALUES_DEFAULT_ENTRY_LENGTH;
+	docValues->ordinals = (int *)malloc(sizeof(int) * docValues->uidLength);
+	docValues->emptyEntry = NULL;
+	docValues->entries = (DocValuesEntry **)malloc(sizeof(DocValuesEntry *) *
+			docValues->entryCapacity);
+
+	memset(docValues->ordinals, 0,
+			(int)(sizeof(int) * docValues->uidLength));
+
+	if(bptree_init(&docValues->dictionary) < 0) {
+		return -1;
+	}
+
+	if(bptree_setFreeFunction(&docValues->dictionary, freeNothing) < 0) {
+		return -1;
+	}
+
+	if(spinlock_init(&docValues->lock) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+DocValues *docValues_new()
+{
+	DocValues *result = NULL;
+
+	result = (DocValues *)malloc(sizeof(DocValues));
+
+	if(docValues_init(result) < 0) {
+		docValues_freePtr(result);
+		return NULL;
+	}
+
+	return result;
+}
+
+int docValues_free(DocValues *docValues)
+{
+	if(docValues == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&docValues->lock) < 0) {
+		return -1;
+	}
+
+	bptree_free(&docValues->dictionary);
+
+	freeEntries(docValues);
+
+	if(docValues->entries != NULL) {
+		free(docValues->entries);
+	}
+
+	if(docValues->ordinals != NULL) {
+		free(docValues->ordinals);
+	}
+
+	spinlock_writeUnlock(&docValues->lock);
+
+	spinlock_free(&docValues->lock);
+
+	memset(docValues, 0, (int)(sizeof(DocValues)));
+
+	return 0;
+}
+
+int docValues_freePtr(DocValues *docValues)
+{
+	if(docValues == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(docValues_free(docValues) < 0) {
+		return -1;
+	}
+
+	free(docValues);
+
+	return 0;
+}
+
+aboolean docValues_isEnabled(DocValues *docValues)
+{
+	if(docValues == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	return docValues->isEnabled;
+}
+
+int docValues_setEnabled(DocValues *docValues, aboolean isEnabled)
+{
+	if(docValues == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&docValues->lock) < 0) {
+		return -1;
+	}
+
+	docValues->isEnabled = isEnabled;
+
+	spinlock_writeUnlock(&docValues->lock);
+
+	return 0;
+}
+
+int docValues_reset(DocValues *docValues)
+{
+	if(docValues == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&docValues->lock) < 0) {
+		return -1;
+	}
+
+	bptree_clear(&docValues->dictionary);
+
+	freeEntries(docValues);
+
+	memset(docValues->ordinals, 0,
+			(int)(sizeof(int) * docValues->uidLength));
+
+	spinlock_writeUnlock(&docValues->lock);
+
+	return 0;
+}
+
+int docValues_put(DocValues *docValues, int uid, char *value,
+		int valueLength, char *relevancy, int relevancyLength,
+		int relevancyArrayLength)
+{
+	int length = 0;
+
+	DocValuesEntry *entry = NULL;
+
+	if((docValues == NULL) || (uid < 1) || (value == NULL) ||
+			(valueLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&docValues->lock) < 0) {
+		return -1;
+	}
+
+	// grow the column to cover the UID
+
+	if(uid >= docValues->uidLength) {
+		length = (docValues->uidLength * 2);
+
+		if(uid >= length) {
+			length = (uid + 1);
+		}
+
+		docValues->ordinals = (int *)realloc(docValues->ordinals,
+				(sizeof(int) * length));
+
+		memset((docValues->ordinals + docValues->uidLength), 0,
+				(int)(sizeof(int) * (length - docValues->uidLength)));
+
+		docValues->uidLength = length;
+	}
+
+	// obtain the dictionary entry for the value
+
+	if(((entry = getEntry(docValues, value, valueLength)) == NULL) &&
+			((entry = newEntry(docValues, value, valueLength)) == NULL)) {
+		spinlock_writeUnlock(&docValues->lock);
+		return -1;
+	}
+
+	if((entry->relevancy == NULL) && (relevancy != NULL) &&
+			(relevancyLength > 0) && (relevancyArrayLength > 0)) {
+		entry->relevancyLength = relevancyLength;
+		entry->relevancyArrayLength = relevancyArrayLength;
+		entry->relevancy = copyValue(relevancy, relevancyLength);
+	}
+
+	// assign the entry to the UID
+
+	if(docValues->ordinals[uid] > 0) {
+		docValues->entries[(docValues->ordinals[uid] - 1)]->references -= 1;
+	}
+
+	docValues->ordinals[uid] = (entry->ordinal + 1);
+
+	entry->references += 1;
+
+	spinlock_writeUnlock(&docValues->lock);
+
+	return 0;
+}
+
+int docValues_remove(DocValues *docValues, int uid, char *value,
+		int valueLength)
+{
+	DocValuesEntry *entry = NULL;
+
+	if((docValues == NULL) || (uid < 1) || (value == NULL) ||
+			(valueLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&docValues->lock) < 0) {
+		return -1;
+	}
+
+	// only clear the UID if it still holds the value being removed
+
+	if((uid < docValues->uidLength) && (docValues->ordinals[uid] > 0)) {
+		entry = docValues->entries[(docValues->ordinals[uid] - 1)];
+
+		if((entry->length == valueLength) &&
+				((valueLength < 1) ||
+				 (!memcmp(entry->value, value, valueLength)))) {
+			entry->references -= 1;
+			docValues->ordinals[uid] = 0;
+		}
+	}
+
+	spinlock_writeUnlock(&docValues->lock);
+
+	return 0;
+}
+
+int docValues_collect(DocValues *docValues, int *uids, int uidLength,
+		int *valueIds, DocValuesValue **values)
+{
+	int ii = 0;
+	int ordinal = 0;
+	int result = 0;
+	int *idMap = NULL;
+	int *ordinals = NULL;
+
+	DocValuesEntry *entry = NULL;
+
+	if((docValues == NULL) || (uids == NULL) || (uidLength < 0) ||
+			(valueIds == NULL) || (values == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	*values = NULL;
+
+	if(spinlock_readLock(&docValues->lock) < 0) {
+		return -1;
+	}
+
+	if(!docValues->isEnabled) {
+		spinlock_readUnlock(&docValues->lock);
+		return -1;
+	}
+
+	if((uidLength < 1) || (docValues->entryLength < 1)) {
+		for(ii = 0; ii < uidLength; ii++) {
+			valueIds[ii] = -1;
+		}
+
+		spinlock_readUnlock(&docValues->lock);
+		return 0;
+	}
+
+	// assign a dense value id to each distinct ordinal in the UID set
+
+	idMap = (int *)malloc(sizeof(int) * docValues->entryLength);
+	ordinals = (int *)malloc(sizeof(int) * uidLength);
+
+	memset(idMap, 0, (int)(sizeof(int) * docValues->entryLength));
+
+	for(ii = 0; ii < uidLength; ii++) {
+		if((uids[ii] < 1) || (uids[ii] >= docValues->uidLength) ||
+				((ordinal = docValues->ordinals[uids[ii]]) < 1)) {
+			valueIds[ii] = -1;
+			continue;
+		}
+
+		if(idMap[(ordinal - 1)] == 0) {
+			ordinals[result] = (ordinal - 1);
+			result++;
+			idMap[(ordinal - 1)] = result;
+		}
+
+		valueIds[ii] = (idMap[(ordinal - 1)] - 1);
+	}
+
+	// copy the distinct values out of the dictionary
+
+	if(result > 0) {
+		*values = (DocValuesValue *)malloc(sizeof(DocValuesValue) * result);
+
+		for(ii = 0; ii < result; ii++) {
+			entry = docValues->entries[ordinals[ii]];
+
+			(*values)[ii].count = 0;
+			(*values)[ii].length = entry->length;
+			(*values)[ii].relevancyLength = entry->relevancyLength;
+			(*values)[ii].relevancyArrayLength = entry->relevancyArrayLength;
+			(*values)[ii].value = copyValue(entry->value, entry->length);
+
+			if(entry->relevancy != NULL) {
+				(*values)[ii].relevancy = copyValue(entry->relevancy,
+						entry->relevancyLength);
+			}
+			else {
+				(*values)[ii].relevancy = NULL;
+			}
+		}
+	}
+
+	spinlock_readUnlock(&docValues->lock);
+
+	for(ii = 0; ii < uidLength; ii++) {
+		if(valueIds[ii] >= 0) {
+			(*values)[valueIds[ii]].count += 1;
+		}
+	}
+
+	free(idMap);
+	free(ordinals);
+
+	return result;
+}
+
+void docValues_freeValues(DocValuesValue *values, int valueLength)
+{
+	int ii = 0;
+
+	if(values == NULL) {
+		return;
+	}
+
+	for(ii = 0; ii < valueLength; ii++) {
+		if(values[ii].value != NULL) {
+			free(values[ii].value);
+		}
+
+		if(values[ii].relevancy != NULL) {
+			free(values[ii].relevancy);
+		}
+	}
+
+	free(values);
+}
+
@@ -0,0 +1,112 @@
+/*
+ * doc_values.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * A library component for the search-engine to maintain a columnar store of
+ * attribute values by container UID, for sorting and faceting without
+ * accessing the containers, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_SEARCH_CORE_DOC_VALUES_H)
+
+#define _SEARCH_CORE_DOC_VALUES_H
+
+#if !defined(_SEARCH_H) && !defined(_SEARCH_CORE_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _SEARCH_H || _SEARCH_CORE_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define doc values public constants
+
+#define DOC_VALUES_DEFAULT_UID_LENGTH					1024
+
+#define DOC_VALUES_DEFAULT_ENTRY_LENGTH					128
+
+
+// define doc values public data types
+
+/*
+ * A dictionary entry holds one distinct attribute value, along with the
+ * serialized relevancy token array the engine calculated for that value.
+ */
+
+typedef struct _DocValuesEntry {
+	int ordinal;
+	int references;
+	int length;
+	int relevancyLength;
+	int relevancyArrayLength;
+	char *value;
+	char *relevancy;
+} DocValuesEntry;
+
+/*
+ * A value collected for a set of UIDs, copied out of the dictionary so that
+ * callers may use it without holding the column lock.
+ */
+
+typedef struct _DocValuesValue {
+	int count;
+	int length;
+	int relevancyLength;
+	int relevancyArrayLength;
+	char *value;
+	char *relevancy;
+} DocValuesValue;
+
+typedef struct _DocValues {
+	aboolean isEnabled;
+	int uidLength;
+	int entryLength;
+	int entryCapacity;
+	int *ordinals;
+	DocValuesEntry *emptyEntry;
+	DocValuesEntry **entries;
+	Bptree dictionary;
+	Spinlock lock;
+} DocValues;
+
+
+// delcare doc values public functions
+
+int docValues_init(DocValues *docValues);
+
+DocValues *docValues_new();
+
+int docValues_free(DocValues *docValues);
+
+int docValues_freePtr(DocValues *docValues);
+
+aboolean docValues_isEnabled(DocValues *docValues);
+
+int docValues_setEnabled(DocValues *docValues, aboolean isEnabled);
+
+int docValues_reset(DocValues *docValues);
+
+int docValues_put(DocValues *docValues, int uid, char *value,
+		int valueLength, char *relevancy, int relevancyLength,
+		int relevancyArrayLength);
+
+int docValues_remove(DocValues *docValues, int uid, char *value,
+		int valueLength);
+
+int docValues_collect(DocValues *docValues, int *uids, int uidLength,
+		int *valueIds, DocValuesValue **values);
+
+void docValues_freeValues(DocValuesValue *values, int valueLength);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _SEARCH_CORE_DOC_VALUES_H
+
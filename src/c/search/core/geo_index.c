@@ -0,0 +1,481 @@
+/*
+ * geo_index.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * A library component for the search-engine to maintain a grid-cell index of
+ * geographic coordinates, for radius searches over a small set of covering
+ * cells.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#include "search/search.h"
+#define _SEARCH_CORE_COMPONENT
+#include "search/core/geo_index.h"
+
+
+// declare geo index private functions
+
+static int toGrid(double value, double minimum, double span);
+
+static aulint interleave(int longitude, int latitude, int bits);
+
+static int toCellValue(aulint code);
+
+static int compareCellRanges(const void *left, const void *right);
+
+static int compareIntegers(const void *left, const void *right);
+
+
+// define geo index private functions
+
+static int toGrid(double value, double minimum, double span)
+{
+	int result = 0;
+
+	result = (int)(((value - minimum) / span) *
+			(double)(1 << GEO_INDEX_CELL_BITS));
+
+	if(result < 0) {
+		result = 0;
+	}
+	else if(result >= (1 << GEO_INDEX_CELL_BITS)) {
+		result = ((1 << GEO_INDEX_CELL_BITS) - 1);
+	}
+
+	return result;
+}
+
+static aulint interleave(int longitude, int latitude, int bits)
+{
+	int ii = 0;
+	aulint result = 0;
+
+	// longitude takes the higher bit of each pair, as with a geohash
+
+	for(ii = (bits - 1); ii >= 0; ii--) {
+		result = ((result << 2) |
+				((aulint)((longitude >> ii) & 0x01) << 1) |
+				(aulint)((latitude >> ii) & 0x01));
+	}
+
+	return result;
+}
+
+static int toCellValue(aulint code)
+{
+	return (int)((unsigned int)code ^ 0x80000000);
+}
+
+static int compareCellRanges(const void *left, const void *right)
+{
+	GeoIndexCellRange *alpha = NULL;
+	GeoIndexCellRange *beta = NULL;
+
+	alpha = (GeoIndexCellRange *)left;
+	beta = (GeoIndexCellRange *)right;
+
+	if(alpha->minValue < beta->minValue) {
+		return -1;
+	}
+	else if(alpha->minValue > beta->minValue) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static int compareIntegers(const void *left, const void *right)
+{
+	if(*((int *)left) < *((int *)right)) {
+		return -1;
+	}
+	else if(*((int *)left) > *((int *)right)) {
+		return 1;
+	}
+
+	return 0;
+}
+
+
+// define geo index public functions
+
+int geoIndex_init(GeoIndex *geo, char *name)
+{
+	if((geo == NULL) || (name == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(geo, 0, (int)(sizeof(GeoIndex)));
+
+	geo->uidLength = GEO_INDEX_DEFAULT_UID_LENGTH;
+	geo->uids = (GeoIndexPoints *)malloc(sizeof(GeoIndexPoints) *
+			geo->uidLength);
+
+	memset(geo->uids, 0, (int)(sizeof(GeoIndexPoints) * geo->uidLength));
+
+	if(rangeIndex_init(&geo->cells, name) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+int geoIndex_free(GeoIndex *geo)
+{
+	int ii = 0;
+
+	if(geo == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	rangeIndex_free(&geo->cells);
+
+	if(geo->uids != NULL) {
+		for(ii = 0; ii < geo->uidLength; ii++) {
+			if(geo->uids[ii].points != NULL) {
+				free(geo->uids[ii].points);
+			}
+		}
+
+		free(geo->uids);
+	}
+
+	memset(geo, 0, (int)(sizeof(GeoIndex)));
+
+	return 0;
+}
+
+int geoIndex_encodeCell(double latitude, double longitude)
+{
+	return toCellValue(interleave(
+				toGrid(longitude, -180.0, 360.0),
+				toGrid(latitude, -90.0, 180.0),
+				GEO_INDEX_CELL_BITS));
+}
+
+GeoIndexCellRange *geoIndex_buildCovering(double latitude, double longitude,
+		double miles, int *length)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int level = 0;
+	int shift = 0;
+	int count = 0;
+	int minX = 0;
+	int maxX = 0;
+	int minY = 0;
+	int maxY = 0;
+	aulint code = 0;
+	double cosine = 0.0;
+	double degrees = 0.0;
+	double minLatitude = 0.0;
+	double maxLatitude = 0.0;
+	double minLongitude = 0.0;
+	double maxLongitude = 0.0;
+
+	GeoIndexCellRange *result = NULL;
+
+	if((latitude < -90.0) || (latitude > 90.0) ||
+			(longitude < -180.0) || (longitude > 180.0) ||
+			(miles <= 0.0) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	*length = 0;
+
+	// determine the bounding box of the search radius, with the longitude
+	// span taken at the latitude furthest from the equator
+
+	degrees = (miles * GEOCOORD_DEGREES_PER_MILE);
+
+	if((minLatitude = (latitude - degrees)) < -90.0) {
+		minLatitude = -90.0;
+	}
+
+	if((maxLatitude = (latitude + degrees)) > 90.0) {
+		maxLatitude = 90.0;
+	}
+
+	if(fabs(minLatitude) > fabs(maxLatitude)) {
+		cosine = cos(geocoord_degreesToRadians(minLatitude));
+	}
+	else {
+		cosine = cos(geocoord_degreesToRadians(maxLatitude));
+	}
+
+	if(cosine > 0.000001) {
+		degrees = (miles / (GEOCOORD_MILES_PER_DEGREE * cosine));
+
+		if((minLongitude = (longitude - degrees)) < -180.0) {
+			minLongitude = -180.0;
+		}
+
+		if((maxLongitude = (longitude + degrees)) > 180.0) {
+			maxLongitude = 180.0;
+		}
+	}
+	else {
+		minLongitude = -180.0;
+		maxLongitude = 180.0;
+	}
+
+	minX = toGrid(minLongitude, -180.0, 360.0);
+	maxX = toGrid(maxLongitude, -180.0, 360.0);
+	minY = toGrid(minLatitude, -90.0, 180.0);
+	maxY = toGrid(maxLatitude, -90.0, 180.0);
+
+	// select the finest level at which a handful of cells covers the box
+
+	for(level = GEO_INDEX_CELL_BITS; level > 0; level--) {
+		shift = (GEO_INDEX_CELL_BITS - level);
+
+		count = ((((maxX >> shift) - (minX >> shift)) + 1) *
+				(((maxY >> shift) - (minY >> shift)) + 1));
+
+		if(count <= GEO_INDEX_MAX_COVERING_CELLS) {
+			break;
+		}
+	}
+
+	shift = (GEO_INDEX_CELL_BITS - level);
+
+	count = ((((maxX >> shift) - (minX >> shift)) + 1) *
+			(((maxY >> shift) - (minY >> shift)) + 1));
+
+	result = (GeoIndexCellRange *)malloc(sizeof(GeoIndexCellRange) * count);
+
+	for(ii = (minY >> shift); ii <= (maxY >> shift); ii++) {
+		for(nn = (minX >> shift); nn <= (maxX >> shift); nn++) {
+			code = (interleave(nn, ii, level) << (shift * 2));
+
+			result[ref].minValue = toCellValue(code);
+			result[ref].maxValue = toCellValue(code |
+					(((aulint)1 << (shift * 2)) - 1));
+			ref++;
+		}
+	}
+
+	// neighbouring cells are often adjacent in z-order, merge their ranges
+
+	qsort((void *)result, ref, sizeof(GeoIndexCellRange), compareCellRanges);
+
+	for(ii = 1, nn = 0; ii < ref; ii++) {
+		if(((alint)result[nn].maxValue + 1) == (alint)result[ii].minValue) {
+			result[nn].maxValue = result[ii].maxValue;
+			continue;
+		}
+
+		nn++;
+		result[nn].minValue = result[ii].minValue;
+		result[nn].maxValue = result[ii].maxValue;
+	}
+
+	*length = (nn + 1);
+
+	return result;
+}
+
+int geoIndex_put(GeoIndex *geo, double latitude, double longitude, int uid)
+{
+	int length = 0;
+
+	GeoIndexPoints *entry = NULL;
+
+	if((geo == NULL) || (latitude < -90.0) || (latitude > 90.0) ||
+			(longitude < -180.0) || (longitude > 180.0) || (uid < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(rangeIndex_put(&geo->cells, geoIndex_encodeCell(latitude, longitude),
+				uid) < 0) {
+		return -1;
+	}
+
+	// grow the coordinate table to cover the UID
+
+	if(uid >= geo->uidLength) {
+		length = (geo->uidLength * 2);
+
+		if(uid >= length) {
+			length = (uid + 1);
+		}
+
+		geo->uids = (GeoIndexPoints *)realloc(geo->uids,
+				(sizeof(GeoIndexPoints) * length));
+
+		memset((geo->uids + geo->uidLength), 0,
+				(int)(sizeof(GeoIndexPoints) * (length - geo->uidLength)));
+
+		geo->uidLength = length;
+	}
+
+	entry = &(geo->uids[uid]);
+
+	if(entry->points == NULL) {
+		entry->length = 0;
+		entry->points = (GeoIndexPoint *)malloc(sizeof(GeoIndexPoint));
+	}
+	else {
+		entry->points = (GeoIndexPoint *)realloc(entry->points,
+				(sizeof(GeoIndexPoint) * (entry->length + 1)));
+	}
+
+	entry->points[entry->length].latitude = latitude;
+	entry->points[entry->length].longitude = longitude;
+	entry->length += 1;
+
+	return 0;
+}
+
+int geoIndex_remove(GeoIndex *geo, double latitude, double longitude,
+		int uid)
+{
+	int ii = 0;
+	int result = 0;
+
+	GeoIndexPoints *entry = NULL;
+
+	if((geo == NULL) || (uid < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	result = rangeIndex_remove(&geo->cells,
+			geoIndex_encodeCell(latitude, longitude), uid);
+
+	if(uid >= geo->uidLength) {
+		return result;
+	}
+
+	entry = &(geo->uids[uid]);
+
+	for(ii = 0; ii < entry->length; ii++) {
+		if((entry->points[ii].latitude != latitude) ||
+				(entry->points[ii].longitude != longitude)) {
+			continue;
+		}
+
+		if(ii < (entry->length - 1)) {
+			memmove(&(entry->points[ii]), &(entry->points[(ii + 1)]),
+					(sizeof(GeoIndexPoint) * (entry->length - (ii + 1))));
+		}
+
+		entry->length -= 1;
+		break;
+	}
+
+	if(entry->length < 1) {
+		if(entry->points != NULL) {
+			free(entry->points);
+		}
+
+		entry->length = 0;
+		entry->points = NULL;
+	}
+
+	return result;
+}
+
+GeoIndexPoint *geoIndex_getPoints(GeoIndex *geo, int uid, int *length)
+{
+	GeoIndexPoint *result = NULL;
+
+	if((geo == NULL) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	*length = 0;
+
+	if((uid < 0) || (uid >= geo->uidLength) ||
+			(geo->uids[uid].length < 1)) {
+		return NULL;
+	}
+
+	result = (GeoIndexPoint *)malloc(sizeof(GeoIndexPoint) *
+			geo->uids[uid].length);
+
+	memcpy(result, geo->uids[uid].points,
+			(sizeof(GeoIndexPoint) * geo->uids[uid].length));
+
+	*length = geo->uids[uid].length;
+
+	return result;
+}
+
+int *geoIndex_search(GeoIndex *geo, double latitude, double longitude,
+		double miles, int *length)
+{
+	int ii = 0;
+	int cellLength = 0;
+	int rangeLength = 0;
+	int resultLength = 0;
+	int *uids = NULL;
+	int *result = NULL;
+
+	GeoIndexCellRange *ranges = NULL;
+
+	if((geo == NULL) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(length != NULL) {
+			*length = 0;
+		}
+
+		return NULL;
+	}
+
+	*length = 0;
+
+	if((ranges = geoIndex_buildCovering(latitude, longitude, miles,
+					&rangeLength)) == NULL) {
+		return NULL;
+	}
+
+	// the cells are disjoint, so the candidates are the union of each range
+
+	for(ii = 0; ii < rangeLength; ii++) {
+		if((uids = rangeIndex_search(&geo->cells, RANGE_INDEX_SEARCH_BETWEEN,
+						ranges[ii].minValue, ranges[ii].maxValue,
+						&cellLength)) == NULL) {
+			continue;
+		}
+
+		if(result == NULL) {
+			result = uids;
+			resultLength = cellLength;
+			continue;
+		}
+
+		result = (int *)realloc(result,
+				(sizeof(int) * (resultLength + cellLength)));
+
+		memcpy((result + resultLength), uids, (sizeof(int) * cellLength));
+
+		resultLength += cellLength;
+
+		free(uids);
+	}
+
+	free(ranges);
+
+	if(resultLength > 1) {
+		qsort((void *)result, resultLength, sizeof(int), compareIntegers);
+	}
+
+	*length = resultLength;
+
+	return result;
+}
+
@@ -0,0 +1,97 @@
+/*
+ * geo_index.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * A library component for the search-engine to maintain a grid-cell index of
+ * geographic coordinates, for radius searches over a small set of covering
+ * cells, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_SEARCH_CORE_GEO_INDEX_H)
+
+#define _SEARCH_CORE_GEO_INDEX_H
+
+#if !defined(_SEARCH_H) && !defined(_SEARCH_CORE_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _SEARCH_H || _SEARCH_CORE_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define geo index public constants
+
+#define GEO_INDEX_CELL_BITS								16
+
+#define GEO_INDEX_MAX_COVERING_CELLS					16
+
+#define GEO_INDEX_DEFAULT_UID_LENGTH					1024
+
+
+// define geo index public data types
+
+/*
+ * A cell is the interleaved (z-order) bits of the grid longitude & latitude,
+ * the integer form of a geohash, stored with its top bit flipped so that the
+ * signed cell values of the range index keep the same order. Every cell of a
+ * coarser level is therefore a single contiguous range of values.
+ *
+ * The exact coordinates of each UID are kept alongside the cells, so that
+ * distances may be calculated without accessing the containers.
+ */
+
+typedef struct _GeoIndexPoint {
+	double latitude;
+	double longitude;
+} GeoIndexPoint;
+
+typedef struct _GeoIndexPoints {
+	int length;
+	GeoIndexPoint *points;
+} GeoIndexPoints;
+
+typedef struct _GeoIndexCellRange {
+	int minValue;
+	int maxValue;
+} GeoIndexCellRange;
+
+typedef struct _GeoIndex {
+	int uidLength;
+	GeoIndexPoints *uids;
+	RangeIndex cells;
+} GeoIndex;
+
+
+// delcare geo index public functions
+
+int geoIndex_init(GeoIndex *geo, char *name);
+
+int geoIndex_free(GeoIndex *geo);
+
+int geoIndex_encodeCell(double latitude, double longitude);
+
+GeoIndexCellRange *geoIndex_buildCovering(double latitude, double longitude,
+		double miles, int *length);
+
+int geoIndex_put(GeoIndex *geo, double latitude, double longitude, int uid);
+
+int geoIndex_remove(GeoIndex *geo, double latitude, double longitude,
+		int uid);
+
+GeoIndexPoint *geoIndex_getPoints(GeoIndex *geo, int uid, int *length);
+
+int *geoIndex_search(GeoIndex *geo, double latitude, double longitude,
+		double miles, int *length);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _SEARCH_CORE_GEO_INDEX_H
+
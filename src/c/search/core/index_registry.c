@@ -95,6 +95,7 @@ static IndexRegistryIndex *indexNew(IndexRegistryTypes type, int uid,
 	result->settings.isOverrideIndexing = afalse;
 	result->settings.isIndexFullString = afalse;
 	result->settings.isIndexTokenizedString = afalse;
+	result->settings.isDocValues = afalse;
 	result->settings.minStringLength = 0;
 	result->settings.maxStringLength = 0;
 	result->settings.delimitersLength = 0;
@@ -256,6 +257,10 @@ char *indexRegistry_typeToString(IndexRegistryTypes type)
 			result = "User Key";
 			break;
 
+		case INDEX_REGISTRY_TYPE_GEO:
+			result = "Geo";
+			break;
+
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			result = "Unknown";
@@ -285,6 +290,9 @@ IndexRegistryTypes indexRegistry_stringToType(char *string)
 	else if(!strcasecmp(string, "User Key")) {
 		result = INDEX_REGISTRY_TYPE_USER_KEY;
 	}
+	else if(!strcasecmp(string, "Geo")) {
+		result = INDEX_REGISTRY_TYPE_GEO;
+	}
 
 	return result;
 }
@@ -351,7 +359,8 @@ int indexRegistry_put(IndexRegistry *registry, IndexRegistryTypes type,
 			((type != INDEX_REGISTRY_TYPE_EXACT) &&
 			 (type != INDEX_REGISTRY_TYPE_WILDCARD) &&
 			 (type != INDEX_REGISTRY_TYPE_RANGE) &&
-			 (type != INDEX_REGISTRY_TYPE_USER_KEY)) ||
+			 (type != INDEX_REGISTRY_TYPE_USER_KEY) &&
+			 (type != INDEX_REGISTRY_TYPE_GEO)) ||
 			(key == NULL) ||
 			((keyLength = strlen(key)) < 1) ||
 			(name == NULL) ||
@@ -454,7 +463,8 @@ int indexRegistry_reset(IndexRegistry *registry, char *key,
 			((newType != INDEX_REGISTRY_TYPE_EXACT) &&
 			 (newType != INDEX_REGISTRY_TYPE_WILDCARD) &&
 			 (newType != INDEX_REGISTRY_TYPE_RANGE) &&
-			 (newType != INDEX_REGISTRY_TYPE_USER_KEY)) ||
+			 (newType != INDEX_REGISTRY_TYPE_USER_KEY) &&
+			 (newType != INDEX_REGISTRY_TYPE_GEO)) ||
 			(newKey == NULL) ||
 			((newKeyLength = strlen(newKey)) < 1) ||
 			(newName == NULL) ||
@@ -670,6 +680,41 @@ int indexRegistry_setStringIndexing(IndexRegistry *registry, char *key,
 	return 0;
 }
 
+int indexRegistry_setDocValues(IndexRegistry *registry, char *key,
+		aboolean isDocValues)
+{
+	int rc = 0;
+	int keyLength = 0;
+
+	IndexRegistryIndex *result = NULL;
+
+	if((registry == NULL) || (key == NULL) || ((keyLength = strlen(key)) < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_readLock(&registry->lock) < 0) {
+		return -1;
+	}
+
+	rc = bptree_get(&registry->index, key, keyLength, ((void *)&result));
+
+	spinlock_readUnlock(&registry->lock);
+
+	if((rc == 0) && (result != NULL)) {
+		mutex_lock(&result->settings.mutex);
+
+		result->settings.isDocValues = isDocValues;
+
+		mutex_unlock(&result->settings.mutex);
+	}
+	else {
+		return -1;
+	}
+
+	return 0;
+}
+
 // helper functions
 
 int indexRegistry_updateConfigContext(IndexRegistry *registry, char *key,
@@ -728,6 +773,11 @@ int indexRegistry_updateConfigContext(IndexRegistry *registry, char *key,
 					result->settings.isIndexTokenizedString);
 		}
 
+		if(result->settings.isDocValues) {
+			config_putBoolean(config, section, "isDocValues",
+					result->settings.isDocValues);
+		}
+
 		mutex_unlock(&result->settings.mutex);
 	}
 	else {
@@ -742,6 +792,7 @@ int indexRegistry_updateSettingsFromConfig(IndexRegistry *registry, char *key,
 {
 	aboolean isIndexFullString = afalse;
 	aboolean isIndexTokenizedString = afalse;
+	aboolean isDocValues = afalse;
 	int rc = 0;
 	int iValue = 0;
 	int iValueTwo = 0;
@@ -807,6 +858,13 @@ int indexRegistry_updateSettingsFromConfig(IndexRegistry *registry, char *key,
 			indexRegistry_setStringIndexing(registry, key, isIndexFullString,
 					isIndexTokenizedString);
 		}
+
+		if(config_exists(config, section, "isDocValues")) {
+			config_getBoolean(config, section, "isDocValues", afalse,
+					&isDocValues);
+
+			indexRegistry_setDocValues(registry, key, isDocValues);
+		}
 	}
 	else {
 		return -1;
@@ -30,6 +30,7 @@ typedef enum _IndexRegistryTypes {
 	INDEX_REGISTRY_TYPE_WILDCARD,
 	INDEX_REGISTRY_TYPE_RANGE,
 	INDEX_REGISTRY_TYPE_USER_KEY,
+	INDEX_REGISTRY_TYPE_GEO,
 	INDEX_REGISTRY_TYPE_END_OF_LIST = -1
 } IndexRegistryTypes;
 
@@ -43,6 +44,7 @@ typedef struct _IndexRegistryIndexSetting {
 	aboolean isOverrideIndexing;
 	aboolean isIndexFullString;
 	aboolean isIndexTokenizedString;
+	aboolean isDocValues;
 	int minStringLength;
 	int maxStringLength;
 	int delimitersLength;
@@ -115,6 +117,9 @@ int indexRegistry_loadExcludedWords(IndexRegistry *registry, char *key,
 int indexRegistry_setStringIndexing(IndexRegistry *registry, char *key,
 		aboolean isIndexFullString, aboolean isIndexTokenizedString);
 
+int indexRegistry_setDocValues(IndexRegistry *registry, char *key,
+		aboolean isDocValues);
+
 // helper functions
 
 int indexRegistry_updateConfigContext(IndexRegistry *registry, char *key,
@@ -158,6 +158,8 @@ static int container_basicUnitTest()
 	char buffer[1024];
 
 	Json *object = NULL;
+	Json *writtenObject = NULL;
+	JsonWriter writer;
 	Json *jsonObject = NULL;
 	Container container;
 	Container newContainer;
@@ -1147,6 +1149,33 @@ static int container_basicUnitTest()
 
 	free(string);
 
+	// write the container directly, and compare with the JSON object
+
+	jsonWriter_init(&writer);
+	jsonWriter_beginObject(&writer);
+
+	if(container_writeJson(&container, &writer) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	jsonWriter_endObject(&writer);
+
+	if(((writtenObject = json_newFromString(writer.buffer)) == NULL) ||
+			(writtenObject->elementLength != object->elementLength) ||
+			(json_getNumber(json_getObject(writtenObject,
+								"containerMetaData"), "uid") !=
+			 (double)container.uid)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	json_freePtr(writtenObject);
+
+	jsonWriter_free(&writer);
+
 	// convert JSON to a container
 
 	if((serialContainer = container_jsonToContainer(object)) == NULL) {
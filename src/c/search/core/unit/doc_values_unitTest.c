@@ -0,0 +1,349 @@
+/*
+ * doc_values_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * A library component for the search-engine to maintain a columnar store of
+ * attribute values by container UID, for sorting and faceting without
+ * accessing the containers, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define doc values unit test constants
+
+#define BASIC_UNIT_TEST_LENGTH							4096
+
+#define BASIC_UNIT_TEST_VALUE_LENGTH					16
+
+
+// declare doc values unit test private functions
+
+static int docValues_basicUnitTest();
+
+static int docValues_removeUnitTest();
+
+static int docValues_relevancyUnitTest();
+
+
+// main
+
+int main()
+{
+	signal_registerDefault();
+
+	printf("[unit] Doc Values unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	if(docValues_basicUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(docValues_removeUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(docValues_relevancyUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define doc values unit test private functions
+
+static int docValues_basicUnitTest()
+{
+	int ii = 0;
+	int valueLength = 0;
+	int *uids = NULL;
+	int *valueIds = NULL;
+	char buffer[128];
+
+	DocValues docValues;
+	DocValuesValue *values = NULL;
+
+	printf("[unit]\t doc values basic unit test...\n");
+
+	if(docValues_init(&docValues) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// put a value on every uid, cycling through a small dictionary
+
+	for(ii = 1; ii <= BASIC_UNIT_TEST_LENGTH; ii++) {
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "value%03i",
+				(ii % BASIC_UNIT_TEST_VALUE_LENGTH));
+
+		if(docValues_put(&docValues, ii, buffer, strlen(buffer), NULL, 0,
+					0) < 0) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	if(docValues.entryLength != BASIC_UNIT_TEST_VALUE_LENGTH) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// collect every uid, plus one which was never put
+
+	uids = (int *)malloc(sizeof(int) * (BASIC_UNIT_TEST_LENGTH + 1));
+	valueIds = (int *)malloc(sizeof(int) * (BASIC_UNIT_TEST_LENGTH + 1));
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		uids[ii] = (ii + 1);
+	}
+
+	uids[BASIC_UNIT_TEST_LENGTH] = (BASIC_UNIT_TEST_LENGTH * 2);
+
+	if((valueLength = docValues_collect(&docValues, uids,
+					(BASIC_UNIT_TEST_LENGTH + 1), valueIds,
+					&values)) != BASIC_UNIT_TEST_VALUE_LENGTH) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "value%03i",
+				(uids[ii] % BASIC_UNIT_TEST_VALUE_LENGTH));
+
+		if((valueIds[ii] < 0) || (valueIds[ii] >= valueLength) ||
+				(values[valueIds[ii]].length != strlen(buffer)) ||
+				(strcmp(values[valueIds[ii]].value, buffer))) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	if(valueIds[BASIC_UNIT_TEST_LENGTH] != -1) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < valueLength; ii++) {
+		if(values[ii].count !=
+				(BASIC_UNIT_TEST_LENGTH / BASIC_UNIT_TEST_VALUE_LENGTH)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	docValues_freeValues(values, valueLength);
+
+	// an empty value is a value, distinct from a missing one
+
+	if(docValues_put(&docValues, 1, "", 0, NULL, 0, 0) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((valueLength = docValues_collect(&docValues, uids, 1, valueIds,
+					&values)) != 1) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((valueIds[0] != 0) || (values[0].length != 0) ||
+			(values[0].count != 1)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	docValues_freeValues(values, valueLength);
+
+	// a disabled column refuses to collect, and a reset column is empty
+
+	docValues_setEnabled(&docValues, afalse);
+
+	if(docValues_collect(&docValues, uids, BASIC_UNIT_TEST_LENGTH, valueIds,
+				&values) != -1) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	docValues_setEnabled(&docValues, atrue);
+
+	if(docValues_reset(&docValues) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(docValues_collect(&docValues, uids, BASIC_UNIT_TEST_LENGTH, valueIds,
+				&values) != 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		if(valueIds[ii] != -1) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	free(uids);
+	free(valueIds);
+
+	if(docValues_free(&docValues) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int docValues_removeUnitTest()
+{
+	int valueLength = 0;
+	int uids[3];
+	int valueIds[3];
+
+	DocValues *docValues = NULL;
+	DocValuesValue *values = NULL;
+
+	printf("[unit]\t doc values remove unit test...\n");
+
+	if((docValues = docValues_new()) == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	docValues_put(docValues, 1, "alpha", 5, NULL, 0, 0);
+	docValues_put(docValues, 2, "beta", 4, NULL, 0, 0);
+	docValues_put(docValues, 3, "alpha", 5, NULL, 0, 0);
+
+	// replacing a value moves the uid to the new dictionary entry
+
+	docValues_put(docValues, 3, "gamma", 5, NULL, 0, 0);
+
+	// removing a stale value must not clear the uid
+
+	docValues_remove(docValues, 3, "alpha", 5);
+
+	// removing the current value clears the uid
+
+	docValues_remove(docValues, 2, "beta", 4);
+
+	uids[0] = 1;
+	uids[1] = 2;
+	uids[2] = 3;
+
+	if((valueLength = docValues_collect(docValues, uids, 3, valueIds,
+					&values)) != 2) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((valueIds[0] < 0) || (strcmp(values[valueIds[0]].value, "alpha")) ||
+			(valueIds[1] != -1) ||
+			(valueIds[2] < 0) || (strcmp(values[valueIds[2]].value, "gamma"))) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	docValues_freeValues(values, valueLength);
+
+	if(docValues_freePtr(docValues) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int docValues_relevancyUnitTest()
+{
+	int uid = 0;
+	int valueId = 0;
+	int valueLength = 0;
+	char relevancy[] = "\0\0\0\0token";
+
+	DocValues docValues;
+	DocValuesValue *values = NULL;
+
+	printf("[unit]\t doc values relevancy unit test...\n");
+
+	if(docValues_init(&docValues) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// the relevancy is copied with the value, and kept for later puts
+
+	docValues_put(&docValues, 1, "token", 5, relevancy,
+			(int)(sizeof(relevancy) - 1), 1);
+	docValues_put(&docValues, 2, "token", 5, NULL, 0, 0);
+
+	uid = 2;
+
+	if((valueLength = docValues_collect(&docValues, &uid, 1, &valueId,
+					&values)) != 1) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((values[0].relevancy == NULL) ||
+			(values[0].relevancy == relevancy) ||
+			(values[0].relevancyLength != (int)(sizeof(relevancy) - 1)) ||
+			(values[0].relevancyArrayLength != 1) ||
+			(memcmp(values[0].relevancy, relevancy,
+					values[0].relevancyLength))) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	docValues_freeValues(values, valueLength);
+
+	if(docValues_free(&docValues) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
@@ -0,0 +1,328 @@
+/*
+ * geo_index_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * A library component for the search-engine to maintain a grid-cell index of
+ * geographic coordinates, for radius searches over a small set of covering
+ * cells, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define geo index unit test constants
+
+#define BASIC_UNIT_TEST_LENGTH							8192
+
+#define BASIC_UNIT_TEST_SEARCH_LENGTH					64
+
+
+// declare geo index unit test private functions
+
+static double randomCoordinate(double minimum, double maximum);
+
+static int geoIndex_coveringUnitTest();
+
+static int geoIndex_searchUnitTest();
+
+static int geoIndex_removeUnitTest();
+
+
+// main
+
+int main()
+{
+	signal_registerDefault();
+
+	printf("[unit] Geo Index unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	srand(time(NULL));
+
+	if(geoIndex_coveringUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(geoIndex_searchUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(geoIndex_removeUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define geo index unit test private functions
+
+static double randomCoordinate(double minimum, double maximum)
+{
+	return (minimum + (((double)rand() / (double)RAND_MAX) *
+				(maximum - minimum)));
+}
+
+static int geoIndex_coveringUnitTest()
+{
+	int ii = 0;
+	int nn = 0;
+	int cell = 0;
+	int length = 0;
+	double latitude = 0.0;
+	double longitude = 0.0;
+	aboolean isCovered = afalse;
+
+	GeoIndexCellRange *ranges = NULL;
+
+	printf("[unit]\t geo index covering unit test...\n");
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_SEARCH_LENGTH; ii++) {
+		latitude = randomCoordinate(-80.0, 80.0);
+		longitude = randomCoordinate(-170.0, 170.0);
+
+		if(((ranges = geoIndex_buildCovering(latitude, longitude, 25.0,
+							&length)) == NULL) ||
+				(length < 1) ||
+				(length > GEO_INDEX_MAX_COVERING_CELLS)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		// the ranges are sorted, and never overlap
+
+		for(nn = 1; nn < length; nn++) {
+			if(ranges[nn].minValue <= ranges[(nn - 1)].maxValue) {
+				fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+						__FUNCTION__, __LINE__);
+				return -1;
+			}
+		}
+
+		// the cell of the center is always covered
+
+		cell = geoIndex_encodeCell(latitude, longitude);
+		isCovered = afalse;
+
+		for(nn = 0; nn < length; nn++) {
+			if((cell >= ranges[nn].minValue) &&
+					(cell <= ranges[nn].maxValue)) {
+				isCovered = atrue;
+				break;
+			}
+		}
+
+		free(ranges);
+
+		if(!isCovered) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int geoIndex_searchUnitTest()
+{
+	int ii = 0;
+	int nn = 0;
+	int kk = 0;
+	int length = 0;
+	int *uids = NULL;
+	double miles = 0.0;
+	double latitude = 0.0;
+	double longitude = 0.0;
+	aboolean isFound = afalse;
+
+	GeoIndexPoint *points = NULL;
+	GeoIndex geo;
+
+	printf("[unit]\t geo index search unit test...\n");
+
+	points = (GeoIndexPoint *)malloc(sizeof(GeoIndexPoint) *
+			(BASIC_UNIT_TEST_LENGTH + 1));
+
+	if(geoIndex_init(&geo, "unitTestGeoIndex") < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// put a point on every uid, clustered so that searches have results
+
+	for(ii = 1; ii <= BASIC_UNIT_TEST_LENGTH; ii++) {
+		points[ii].latitude = randomCoordinate(30.0, 40.0);
+		points[ii].longitude = randomCoordinate(-110.0, -100.0);
+
+		if(geoIndex_put(&geo, points[ii].latitude, points[ii].longitude,
+					ii) < 0) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	// the results of each search must contain every point within the radius
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_SEARCH_LENGTH; ii++) {
+		latitude = randomCoordinate(30.0, 40.0);
+		longitude = randomCoordinate(-110.0, -100.0);
+		miles = randomCoordinate(1.0, 100.0);
+
+		uids = geoIndex_search(&geo, latitude, longitude, miles, &length);
+
+		for(nn = 1; nn <= BASIC_UNIT_TEST_LENGTH; nn++) {
+			if(searchSort_calculateGeoCoordDistanceMiles(latitude, longitude,
+						points[nn].latitude, points[nn].longitude) > miles) {
+				continue;
+			}
+
+			isFound = afalse;
+
+			for(kk = 0; kk < length; kk++) {
+				if(uids[kk] == nn) {
+					isFound = atrue;
+					break;
+				}
+			}
+
+			if(!isFound) {
+				fprintf(stderr, "[%s():%i] error - failed to locate uid %i "
+						"within %0.4f miles of (%0.6f, %0.6f).\n",
+						__FUNCTION__, __LINE__, nn, miles, latitude,
+						longitude);
+				return -1;
+			}
+		}
+
+		// the results are sorted and unique
+
+		for(kk = 1; kk < length; kk++) {
+			if(uids[kk] <= uids[(kk - 1)]) {
+				fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+						__FUNCTION__, __LINE__);
+				return -1;
+			}
+		}
+
+		if(uids != NULL) {
+			free(uids);
+		}
+	}
+
+	if(geoIndex_free(&geo) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(points);
+
+	return 0;
+}
+
+static int geoIndex_removeUnitTest()
+{
+	int length = 0;
+	int *uids = NULL;
+
+	GeoIndexPoint *points = NULL;
+	GeoIndex geo;
+
+	printf("[unit]\t geo index remove unit test...\n");
+
+	if(geoIndex_init(&geo, "unitTestGeoIndex") < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// put two points on a single uid
+
+	if((geoIndex_put(&geo, 37.7749, -122.4194, 42) < 0) ||
+			(geoIndex_put(&geo, 40.7128, -74.0060, 42) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(((points = geoIndex_getPoints(&geo, 42, &length)) == NULL) ||
+			(length != 2) ||
+			(points[0].latitude != 37.7749) ||
+			(points[1].longitude != -74.0060)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(points);
+
+	// remove one point, the uid remains searchable by the other
+
+	if(geoIndex_remove(&geo, 37.7749, -122.4194, 42) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	uids = geoIndex_search(&geo, 37.7749, -122.4194, 10.0, &length);
+
+	if(length != 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(uids != NULL) {
+		free(uids);
+	}
+
+	if(((uids = geoIndex_search(&geo, 40.7128, -74.0060, 10.0,
+							&length)) == NULL) ||
+			(length != 1) ||
+			(uids[0] != 42)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(uids);
+
+	// remove the last point
+
+	if(geoIndex_remove(&geo, 40.7128, -74.0060, 42) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((points = geoIndex_getPoints(&geo, 42, &length)) != NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(geoIndex_free(&geo) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
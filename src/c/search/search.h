@@ -77,11 +77,16 @@ typedef enum _SearchJsonValidationType {
 #include "search/core/common.h"
 #include "search/core/container.h"
 #include "search/core/index_registry.h"
+#include "search/core/doc_values.h"
+#include "search/core/geo_index.h"
 #include "search/core/authentication.h"
 
 // search system packages
 
+#include "search/system/search_segment.h"
 #include "search/system/search_index.h"
+#include "search/system/search_executor.h"
+#include "search/system/search_wal.h"
 #include "search/system/search_engine.h"
 #include "search/system/search_sort.h"
 #include "search/system/search_compiler.h"
@@ -29,9 +29,14 @@ typedef struct _SearchdConfig {
 	/*
 	 * logging properties
 	 */
+	aboolean logIsAsync;
 	int logLevel;
 	int logOutput;
+	int logAsyncRingLength;
+	int logRotateSeconds;
+	alint logRotateFileBytes;
 	char *logFilename;
+	LogOverflow logAsyncOverflow;
 
 	/*
 	 * http protocol
@@ -46,8 +51,10 @@ typedef struct _SearchdConfig {
 	 * server threading properties
 	 */
 	aboolean threadIsThreadPoolShrinkEnabled;
+	aboolean threadIsEventModeEnabled;
 	int threadMinThreadPoolLength;
 	int threadMaxThreadPoolLength;
+	int threadMaxConnectionLength;
 
 	/*
 	 * server packets properties
@@ -63,19 +70,32 @@ typedef struct _SearchdConfig {
 	 */
 	char *socketHostname;
 	int socketPort;
+	double socketIdleTimeoutSeconds;
+
+	/*
+	 * server profiler properties
+	 */
+	aboolean profilerIsEnabled;
+	int profilerSamplingFrequency;
 
 	/*
 	 * search engine properties
 	 */
+	aboolean searchIsWalEnabled;
 	SearchJsonValidationType validationType;
+	SearchWalSyncTypes searchWalSyncType;
 	alint searchMaxContainerCount;
 	alint searchMaxContainerMemoryLength;
 	double searchContainerTimeout;
 	double searchStateWriteThresholdSeconds;
 	double searchContainerWriteThresholdSeconds;
+	double searchWalSyncIntervalSeconds;
+	double searchCheckpointThresholdSeconds;
 	int searchMinStringLength;
 	int searchMaxStringLength;
 	alint maxSortOperationMemoryLength;
+	int searchQueryThreadPoolSize;
+	int searchShardCount;
 	char *searchStringDelimiters;
 	char *searchStatePath;
 	char *searchContainerPath;
@@ -87,6 +107,9 @@ typedef struct _SearchdHandlerArgs {
 	Log *jsonMessageLog;
 	Log *sqlMessageLog;
 	SearchEngine *engine;
+	Pfs *pfs;
+	FifoStack arenaPool;
+	Mutex arenaMutex;
 } SearchdHandlerArgs;
 
 
@@ -101,6 +124,21 @@ static char *buildErrorResponse(char *errorName);
 
 static char *getUrlFromMessage(char *message, int messageLength);
 
+static HttpTransactionManagerSend *buildJsonResponse(char *resultString,
+		int resultStringLength, int *memorySizeOfResponse);
+
+static char *writeCompilerResponse(SearchCompiler *compiler, double timer,
+		int *resultStringLength);
+
+// request arena functions
+
+static MemoryArena *searchd_acquireArena(SearchdHandlerArgs *args);
+
+static void searchd_releaseArena(SearchdHandlerArgs *args,
+		MemoryArena *arena);
+
+static void searchd_freeArena(void *memory);
+
 // handlers
 
 static void *searchd_handleDefault(void *context, void *request,
@@ -112,6 +150,9 @@ static void *searchd_handleGetApacheServerStatus(void *context, void *request,
 static void *searchd_handleGetServerStatus(void *context, void *request,
 		int *memorySizeOfResponse);
 
+static void *searchd_handleGetProfile(void *context, void *request,
+		int *memorySizeOfResponse);
+
 static void *searchd_handleJsonMessage(void *context, void *request,
 		int *memorySizeOfResponse);
 
@@ -322,6 +363,113 @@ static char *getUrlFromMessage(char *message, int messageLength)
 	return result;
 }
 
+static HttpTransactionManagerSend *buildJsonResponse(char *resultString,
+		int resultStringLength, int *memorySizeOfResponse)
+{
+	HttpTransactionManagerSend *result = NULL;
+
+	// only the headers are formatted, the JSON string is handed over as the
+	// response body and sent from where it was built
+
+	result = (HttpTransactionManagerSend *)malloc(
+			sizeof(HttpTransactionManagerSend));
+
+	result->payloadLength = 256;
+	result->payload = (char *)malloc(sizeof(char) *
+			(result->payloadLength + 1));
+
+	result->payloadLength = snprintf(result->payload,
+			result->payloadLength,
+			"HTTP/1.1 200 OK\x0d\x0a"
+			"Server: Search Daemon (Asgard Ver %s on %s)\x0d\x0a"
+			"Content-Length: %i\x0d\x0a"
+			"\x0d\x0a",
+			ASGARD_VERSION,
+			ASGARD_DATE,
+			resultStringLength
+		);
+
+	result->bodyLength = resultStringLength;
+	result->body = resultString;
+	result->bodyFilename = NULL;
+
+	*memorySizeOfResponse = (result->payloadLength + result->bodyLength);
+
+	return result;
+}
+
+static char *writeCompilerResponse(SearchCompiler *compiler, double timer,
+		int *resultStringLength)
+{
+	char *result = NULL;
+
+	JsonWriter writer;
+
+	// write the compact response directly, rather than building, serializing
+	// and then minimizing it
+
+	jsonWriter_init(&writer);
+
+	jsonWriter_beginObject(&writer);
+
+	searchCompiler_writeResponse(compiler, &writer);
+
+	jsonWriter_writeName(&writer, "execTimeSeconds");
+	jsonWriter_writeNumber(&writer, time_getElapsedMusInSeconds(timer));
+
+	jsonWriter_endObject(&writer);
+
+	result = jsonWriter_release(&writer, resultStringLength);
+
+	jsonWriter_free(&writer);
+
+	return result;
+}
+
+// request arena functions
+
+static MemoryArena *searchd_acquireArena(SearchdHandlerArgs *args)
+{
+	MemoryArena *result = NULL;
+
+	mutex_lock(&args->arenaMutex);
+
+	if(fifostack_pop(&args->arenaPool, (void **)&result) < 0) {
+		result = NULL;
+	}
+
+	mutex_unlock(&args->arenaMutex);
+
+	if(result == NULL) {
+		result = (MemoryArena *)malloc(sizeof(MemoryArena));
+
+		memory_arenaInit(result, MEMORY_ARENA_DEFAULT_BLOCK_LENGTH);
+	}
+
+	return result;
+}
+
+static void searchd_releaseArena(SearchdHandlerArgs *args,
+		MemoryArena *arena)
+{
+	memory_arenaReset(arena);
+
+	mutex_lock(&args->arenaMutex);
+
+	fifostack_push(&args->arenaPool, arena);
+
+	mutex_unlock(&args->arenaMutex);
+}
+
+static void searchd_freeArena(void *memory)
+{
+	MemoryArena *arena = (MemoryArena *)memory;
+
+	memory_arenaFree(arena);
+
+	free(arena);
+}
+
 // handlers
 
 static void *searchd_handleDefault(void *context, void *request,
@@ -356,6 +504,9 @@ static void *searchd_handleDefault(void *context, void *request,
 	result->payloadLength = 2048;
 	result->payload = (char *)malloc(sizeof(char) *
 			(result->payloadLength + 1));
+	result->bodyLength = 0;
+	result->body = NULL;
+	result->bodyFilename = NULL;
 
 	result->payloadLength = snprintf(result->payload,
 			result->payloadLength,
@@ -500,6 +651,9 @@ static void *searchd_handleGetApacheServerStatus(void *context, void *request,
 	result->payloadLength = (strlen(TEMPLATE) + strlen(scoreboard) + 512);
 	result->payload = (char *)malloc(sizeof(char) *
 			(result->payloadLength + 1));
+	result->bodyLength = 0;
+	result->body = NULL;
+	result->bodyFilename = NULL;
 
 	result->payloadLength = snprintf(result->payload, result->payloadLength,
 			TEMPLATE,
@@ -528,8 +682,13 @@ static void *searchd_handleGetApacheServerStatus(void *context, void *request,
 static void *searchd_handleGetServerStatus(void *context, void *request,
 		int *memorySizeOfResponse)
 {
+	int resultStringLength = 0;
+	char *url = NULL;
+	char *resultString = NULL;
+
 	Json *result = NULL;
 	Json *object = NULL;
+	JsonWriter writer;
 
 	Server *server = NULL;
 	ServerStatus *entry = NULL;
@@ -559,6 +718,29 @@ static void *searchd_handleGetServerStatus(void *context, void *request,
 		fprintf(stdout, "\n\n--------\n%s\n--------\n", receive->payload);
 	}
 
+	// the Prometheus text exposition format is selected by the query string,
+	// e.g. '/asgard-server-status?format=prometheus'
+
+	if(((url = getUrlFromMessage(receive->payload,
+						receive->payloadLength)) != NULL) &&
+			(strstr(url, "format=prometheus") != NULL)) {
+		free(url);
+
+		if((resultString = server_getPrometheusStatus(server,
+						&resultStringLength)) == NULL) {
+			log_logf(server->log, LOG_LEVEL_ERROR, "{SEARCHD} "
+					"failed to obtain status from server context");
+			return NULL;
+		}
+
+		return buildJsonResponse(resultString, resultStringLength,
+				memorySizeOfResponse);
+	}
+
+	if(url != NULL) {
+		free(url);
+	}
+
 	// convert current server status to a JSON object
 
 	result = json_new();
@@ -590,29 +772,95 @@ static void *searchd_handleGetServerStatus(void *context, void *request,
 
 	// build response
 
-	response = (HttpTransactionManagerSend *)malloc(
-			sizeof(HttpTransactionManagerSend));
+	if(SEARCHD_DEVELOPER_MODE) {
+		resultString = json_toString(result, &resultStringLength);
+	}
+	else {
+		jsonWriter_init(&writer);
+		jsonWriter_writeJson(&writer, result);
 
-	response->payload = json_toString(result, &response->payloadLength);
+		resultString = jsonWriter_release(&writer, &resultStringLength);
 
-	if(!SEARCHD_DEVELOPER_MODE) {
-		response->payloadLength = json_minimizeJsonString(response->payload,
-				response->payloadLength, atrue);
+		jsonWriter_free(&writer);
 	}
 
+	response = buildJsonResponse(resultString, resultStringLength,
+			memorySizeOfResponse);
+
 	// cleanup
 
 	json_freePtr(result);
 
-	*memorySizeOfResponse = response->payloadLength;
-
 	return response;
 }
 
+static void *searchd_handleGetProfile(void *context, void *request,
+		int *memorySizeOfResponse)
+{
+	int resultStringLength = 0;
+	char *url = NULL;
+	char *resultString = NULL;
+
+	PfsReportTypes reportType = PFS_REPORT_FLAT;
+	SearchdHandlerArgs *args = NULL;
+
+	HttpTransactionManagerReceive *receive = NULL;
+
+	if((context == NULL) || (request == NULL) ||
+			(memorySizeOfResponse == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(memorySizeOfResponse != NULL) {
+			*memorySizeOfResponse = 0;
+		}
+
+		return NULL;
+	}
+
+	*memorySizeOfResponse = 0;
+
+	args = (SearchdHandlerArgs *)context;
+	receive = (HttpTransactionManagerReceive *)request;
+
+	if(args->pfs == NULL) {
+		resultString = strdup("profiler is disabled\n");
+
+		return buildJsonResponse(resultString, (int)strlen(resultString),
+				memorySizeOfResponse);
+	}
+
+	// the collapsed stacks, e.g. for flame graphs, are selected by the query
+	// string, e.g. '/asgard-profile?format=collapsed'
+
+	if((url = getUrlFromMessage(receive->payload,
+					receive->payloadLength)) != NULL) {
+		if(strstr(url, "format=collapsed") != NULL) {
+			reportType = PFS_REPORT_COLLAPSED;
+		}
+		else if(strstr(url, "format=samples") != NULL) {
+			reportType = PFS_REPORT_SAMPLES;
+		}
+
+		free(url);
+	}
+
+	if(pfs_buildReport(args->pfs, reportType, &resultString,
+				&resultStringLength) < 0) {
+		log_logf(args->engine->log, LOG_LEVEL_ERROR, "{SEARCHD} "
+				"failed to build the profiler report");
+		return NULL;
+	}
+
+	return buildJsonResponse(resultString, resultStringLength,
+			memorySizeOfResponse);
+}
+
 static void *searchd_handleJsonMessage(void *context, void *request,
 		int *memorySizeOfResponse)
 {
 	aboolean hasError = afalse;
+	aboolean isCompiled = afalse;
+	int messageLength = 0;
 	int resultStringLength = 0;
 	double timer = 0.0;
 	char *ptr = NULL;
@@ -622,11 +870,13 @@ static void *searchd_handleJsonMessage(void *context, void *request,
 
 	Json *requestObject = NULL;
 	Json *responseObject = NULL;
+	JsonReader reader;
 
 	HttpTransactionManagerReceive *receive = NULL;
 	HttpTransactionManagerSend *result = NULL;
 
 	Log *jsonMessageLog = NULL;
+	MemoryArena *arena = NULL;
 	SearchEngine *engine = NULL;
 	SearchCompiler compiler;
 	SearchdHandlerArgs *args = NULL;
@@ -651,6 +901,10 @@ static void *searchd_handleJsonMessage(void *context, void *request,
 
 	receive = (HttpTransactionManagerReceive *)request;
 
+	PFS_BEGIN(args->pfs);
+
+	arena = searchd_acquireArena(args);
+
 /*	if(SEARCHD_DEVELOPER_MODE) {
 		common_display(stdout, receive->payload, receive->payloadLength);
 		fprintf(stdout, "\n\n--------\n%s\n--------\n", receive->payload);
@@ -659,7 +913,17 @@ static void *searchd_handleJsonMessage(void *context, void *request,
 	if((ptr = strncasestr(receive->payload, receive->payloadLength,
 					"SearchEngineDaemonMessage",
 					25)) != NULL) {
-		if((requestObject = json_newFromString(ptr + 26)) != NULL) {
+		ptr += 26;
+		messageLength = (receive->payloadLength -
+				(int)(ptr - receive->payload));
+
+		if(messageLength < 0) {
+			messageLength = 0;
+		}
+
+		jsonReader_init(&reader, ptr, messageLength);
+
+		if((requestObject = json_newFromReader(&reader, arena)) != NULL) {
 			if((messageName = json_getString(requestObject,
 							"messageName")) == NULL) {
 				messageName = "unknown";
@@ -680,39 +944,57 @@ static void *searchd_handleJsonMessage(void *context, void *request,
 	}
 
 	if(!hasError) {
-		resultString = json_toString(requestObject, &resultStringLength);
-
-		resultStringLength = json_minimizeJsonString(resultString,
-				resultStringLength, afalse);
+		// log the message as received, rather than re-serializing the tree
 
 		if(SEARCHD_DEVELOPER_MODE) {
-			fprintf(stdout, "{JSON} length %i, '%s'\n", resultStringLength,
-					resultString);
+			fprintf(stdout, "{JSON} length %i, '%.*s'\n", messageLength,
+					messageLength, ptr);
 		}
 
-		log_logf(jsonMessageLog, LOG_LEVEL_INFO, "%s", resultString);
-
-		free(resultString);
+		log_logf(jsonMessageLog, LOG_LEVEL_INFO, "%.*s", messageLength, ptr);
 
 		timer = time_getTimeMus();
 
-		if(searchCompiler_compileJson(&compiler,
+		PFS_BEGIN_NAMED(args->pfs, "searchCompiler_compileJson");
+
+		if(searchCompiler_compileJsonWithArena(&compiler,
+					arena,
 					engine->log,
 					receive->ipAddress,
 					engine->settings.validationType,
 					requestObject) == 0) {
+			isCompiled = atrue;
+		}
+
+		PFS_END(args->pfs);
+
+		if(isCompiled) {
+			PFS_BEGIN_NAMED(args->pfs, "searchCompiler_execute");
+
 			searchCompiler_execute(&compiler, engine);
+
+			PFS_END(args->pfs);
 		}
 
-		responseObject = searchCompiler_buildResponse(&compiler);
+		PFS_BEGIN_NAMED(args->pfs, "searchd_writeResponse");
 
-		searchCompiler_free(&compiler);
+		if(SEARCHD_DEVELOPER_MODE) {
+			responseObject = searchCompiler_buildResponse(&compiler);
 
-		json_addNumber(responseObject, "execTimeSeconds",
-				time_getElapsedMusInSeconds(timer));
+			json_addNumber(responseObject, "execTimeSeconds",
+					time_getElapsedMusInSeconds(timer));
+		}
+		else {
+			resultString = writeCompilerResponse(&compiler, timer,
+					&resultStringLength);
+		}
+
+		PFS_END(args->pfs);
+
+		searchCompiler_free(&compiler);
 	}
 
-	if(responseObject == NULL) {
+	if((responseObject == NULL) && (resultString == NULL)) {
 		responseObject = json_new();
 
 		json_addString(responseObject, "messageName", messageName);
@@ -721,41 +1003,24 @@ static void *searchd_handleJsonMessage(void *context, void *request,
 		resultString = buildErrorResponse(errorMessage);
 
 		json_addString(responseObject, "errorMessage", resultString);
-	}
 
-	resultString = json_toString(responseObject, &resultStringLength);
-
-	if(!SEARCHD_DEVELOPER_MODE) {
-		resultStringLength = json_minimizeJsonString(resultString,
-				resultStringLength, atrue);
+		free(resultString);
 	}
 
-	result = (HttpTransactionManagerSend *)malloc(
-			sizeof(HttpTransactionManagerSend));
+	if(responseObject != NULL) {
+		resultString = json_toString(responseObject, &resultStringLength);
 
-	result->payloadLength = (resultStringLength + 256);
-	result->payload = (char *)malloc(sizeof(char) *
-			(result->payloadLength + 1));
+		if(!SEARCHD_DEVELOPER_MODE) {
+			resultStringLength = json_minimizeJsonString(resultString,
+					resultStringLength, atrue);
+		}
+	}
 
-	result->payloadLength = snprintf(result->payload,
-			result->payloadLength,
-			"HTTP/1.1 200 OK\x0d\x0a"
-			"Server: Search Daemon (Asgard Ver %s on %s)\x0d\x0a"
-			"Content-Length: %i\x0d\x0a"
-			"\x0d\x0a"
-			"%s",
-			ASGARD_VERSION,
-			ASGARD_DATE,
-			resultStringLength,
-			resultString
-		);
+	result = buildJsonResponse(resultString, resultStringLength,
+			memorySizeOfResponse);
 
 	// cleanup
 
-	if(resultString != NULL) {
-		free(resultString);
-	}
-
 	if(requestObject != NULL) {
 		json_freePtr(requestObject);
 	}
@@ -764,9 +1029,9 @@ static void *searchd_handleJsonMessage(void *context, void *request,
 		json_freePtr(responseObject);
 	}
 
-	// setup results
+	searchd_releaseArena(args, arena);
 
-	*memorySizeOfResponse = result->payloadLength;
+	PFS_END(args->pfs);
 
 	return result;
 }
@@ -775,6 +1040,7 @@ static void *searchd_handleSqlMessage(void *context, void *request,
 		int *memorySizeOfResponse)
 {
 	aboolean hasError = afalse;
+	aboolean isCompiled = afalse;
 	int resultStringLength = 0;
 	double timer = 0.0;
 	char *query = NULL;
@@ -817,6 +1083,8 @@ static void *searchd_handleSqlMessage(void *context, void *request,
 		fprintf(stdout, "\n\n--------\n%s\n--------\n", receive->payload);
 	}
 
+	PFS_BEGIN(args->pfs);
+
 	timer = time_getTimeMus();
 
 	if((query = getUrlFromMessage(receive->payload,
@@ -827,18 +1095,37 @@ static void *searchd_handleSqlMessage(void *context, void *request,
 	else {
 		log_logf(sqlMessageLog, LOG_LEVEL_INFO, "%s", query);
 
+		PFS_BEGIN_NAMED(args->pfs, "searchCompiler_compileSql");
+
 		if(searchCompiler_compileSql(&compiler, engine->log, query) == 0) {
+			isCompiled = atrue;
+		}
+
+		PFS_END(args->pfs);
+
+		if(isCompiled) {
+			PFS_BEGIN_NAMED(args->pfs, "searchCompiler_execute");
+
 			searchCompiler_execute(&compiler, engine);
+
+			PFS_END(args->pfs);
+		}
+
+		PFS_BEGIN_NAMED(args->pfs, "searchd_writeResponse");
+
+		if(SEARCHD_DEVELOPER_MODE) {
+			responseObject = searchCompiler_buildResponse(&compiler);
+		}
+		else {
+			resultString = writeCompilerResponse(&compiler, timer,
+					&resultStringLength);
 		}
 
-		responseObject = searchCompiler_buildResponse(&compiler);
+		PFS_END(args->pfs);
 
 		searchCompiler_free(&compiler);
 	}
 
-	json_addNumber(responseObject, "execTimeSeconds",
-			time_getElapsedMusInSeconds(timer));
-
 	if(hasError) {
 		responseObject = json_new();
 
@@ -852,47 +1139,28 @@ static void *searchd_handleSqlMessage(void *context, void *request,
 		free(resultString);
 	}
 
-	json_addNumber(responseObject, "execTimeSeconds",
-			time_getElapsedMusInSeconds(timer));
+	if(responseObject != NULL) {
+		json_addNumber(responseObject, "execTimeSeconds",
+				time_getElapsedMusInSeconds(timer));
 
-	resultString = json_toString(responseObject, &resultStringLength);
+		resultString = json_toString(responseObject, &resultStringLength);
 
-	if(!SEARCHD_DEVELOPER_MODE) {
-		resultStringLength = json_minimizeJsonString(resultString,
-				resultStringLength, atrue);
+		if(!SEARCHD_DEVELOPER_MODE) {
+			resultStringLength = json_minimizeJsonString(resultString,
+					resultStringLength, atrue);
+		}
 	}
 
-	result = (HttpTransactionManagerSend *)malloc(
-			sizeof(HttpTransactionManagerSend));
-
-	result->payloadLength = (resultStringLength + 256);
-	result->payload = (char *)malloc(sizeof(char) *
-			(result->payloadLength + 1));
-
-	result->payloadLength = snprintf(result->payload,
-			result->payloadLength,
-			"HTTP/1.1 200 OK\x0d\x0a"
-			"Server: Search Daemon (Asgard Ver %s on %s)\x0d\x0a"
-			"\x0d\x0a"
-			"%s",
-			ASGARD_VERSION,
-			ASGARD_DATE,
-			resultString
-		);
+	result = buildJsonResponse(resultString, resultStringLength,
+			memorySizeOfResponse);
 
 	// cleanup
 
-	if(resultString != NULL) {
-		free(resultString);
-	}
-
 	if(responseObject != NULL) {
 		json_freePtr(responseObject);
 	}
 
-	// setup results
-
-	*memorySizeOfResponse = result->payloadLength;
+	PFS_END(args->pfs);
 
 	return result;
 }
@@ -982,6 +1250,28 @@ static int searchd_loadConfiguration(SearchdConfig *searchdConfig,
 		searchdConfig->logLevel = LOG_LEVEL_DEBUG;
 	}
 
+	config_getBoolean(&config, "log", "isAsync", afalse,
+			&searchdConfig->logIsAsync);
+
+	config_getInteger(&config, "log", "asyncRingLength",
+			LOG_ASYNC_DEFAULT_RING_LENGTH,
+			&searchdConfig->logAsyncRingLength);
+
+	config_getString(&config, "log", "asyncOverflow", "drop", &sValue);
+
+	if(!strcasecmp(sValue, "block")) {
+		searchdConfig->logAsyncOverflow = LOG_OVERFLOW_BLOCK;
+	}
+	else {
+		searchdConfig->logAsyncOverflow = LOG_OVERFLOW_DROP;
+	}
+
+	config_getBigInteger(&config, "log", "rotateFileBytes", 0,
+			&searchdConfig->logRotateFileBytes);
+
+	config_getInteger(&config, "log", "rotateSeconds", 0,
+			&searchdConfig->logRotateSeconds);
+
 	// http protocol
 
 	config_getBoolean(&config, "http.protocol", "isTempFileMode", afalse,
@@ -1012,6 +1302,13 @@ static int searchd_loadConfiguration(SearchdConfig *searchdConfig,
 	config_getInteger(&config, "server.threading", "maxThreadPoolLength",
 			8, &searchdConfig->threadMaxThreadPoolLength);
 
+	config_getBoolean(&config, "server.threading", "isEventModeEnabled",
+			afalse, &searchdConfig->threadIsEventModeEnabled);
+
+	config_getInteger(&config, "server.threading", "maxConnectionLength",
+			SERVER_DEFAULT_MAX_CONNECTION_LENGTH,
+			&searchdConfig->threadMaxConnectionLength);
+
 	// server packets properties
 
 	config_getBoolean(&config, "server.packets", "isDumpPacketsEnabled",
@@ -1043,6 +1340,18 @@ static int searchd_loadConfiguration(SearchdConfig *searchdConfig,
 	config_getInteger(&config, "server.socket", "port",
 			8080, &searchdConfig->socketPort);
 
+	config_getDouble(&config, "server.socket", "idleTimeoutSeconds",
+			SERVER_DEFAULT_IDLE_TIMEOUT_SECONDS,
+			&searchdConfig->socketIdleTimeoutSeconds);
+
+	// server profiler properties
+
+	config_getBoolean(&config, "server.profiler", "isEnabled", afalse,
+			&searchdConfig->profilerIsEnabled);
+
+	config_getInteger(&config, "server.profiler", "samplingFrequency", 0,
+			&searchdConfig->profilerSamplingFrequency);
+
 	// search engine properties
 
 	config_getBigInteger(&config, "search.engine",
@@ -1073,6 +1382,14 @@ static int searchd_loadConfiguration(SearchdConfig *searchdConfig,
 			SEARCH_ENGINE_DEFAULT_MAX_SORT_OPERATION_LENGTH,
 			&searchdConfig->maxSortOperationMemoryLength);
 
+	config_getInteger(&config, "search.engine", "queryThreadPoolSize",
+			SEARCH_ENGINE_DEFAULT_QUERY_THREAD_POOL_SIZE,
+			&searchdConfig->searchQueryThreadPoolSize);
+
+	config_getInteger(&config, "search.engine", "shardCount",
+			SEARCH_ENGINE_DEFAULT_SHARD_COUNT,
+			&searchdConfig->searchShardCount);
+
 	config_getString(&config, "search.engine",
 			"stringDelimiters",
 			SEARCH_ENGINE_DEFAULT_DELIMITERS,
@@ -1104,6 +1421,30 @@ static int searchd_loadConfiguration(SearchdConfig *searchdConfig,
 
 	searchdConfig->searchContainerPath = strdup(sValue);
 
+	config_getBoolean(&config, "search.engine.backup", "isWalEnabled",
+			afalse, &searchdConfig->searchIsWalEnabled);
+
+	config_getString(&config, "search.engine.backup",
+			"walSyncType",
+			SEARCH_WAL_DEFAULT_SYNC_TYPE_STRING,
+			&sValue);
+
+	searchdConfig->searchWalSyncType = searchWal_stringToSyncType(sValue);
+
+	if(searchdConfig->searchWalSyncType == SEARCH_WAL_SYNC_TYPE_UNKNOWN) {
+		searchdConfig->searchWalSyncType = SEARCH_WAL_DEFAULT_SYNC_TYPE;
+	}
+
+	config_getDouble(&config, "search.engine.backup",
+			"walSyncIntervalSeconds",
+			SEARCH_WAL_DEFAULT_SYNC_INTERVAL_SECONDS,
+			&searchdConfig->searchWalSyncIntervalSeconds);
+
+	config_getDouble(&config, "search.engine.backup",
+			"checkpointThresholdSeconds",
+			SEARCH_WAL_DEFAULT_CHECKPOINT_SECONDS,
+			&searchdConfig->searchCheckpointThresholdSeconds);
+
 	config_getString(&config, "search.engine.exclusions",
 			"excludedWordConfigFilename",
 			SEARCH_ENGINE_DEFAULT_EXCLUDED_WORDS_CONFIG,
@@ -1134,6 +1475,9 @@ static int searchd_loadConfiguration(SearchdConfig *searchdConfig,
 
 static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 {
+	int pfsReportLength = 0;
+	char *pfsReport = NULL;
+
 	Log log;
 	Log jsonMessageLog;
 	Log sqlMessageLog;
@@ -1141,6 +1485,7 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 	TransactionManager manager;
 	Server server;
 	SearchEngine engine;
+	Pfs pfs;
 	SearchdHandlerArgs args;
 
 	ArrayList *serverStatus = NULL;
@@ -1178,6 +1523,23 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 		log_enablePeriodicFlush(&sqlMessageLog, 128);
 	}
 
+	if(config->logIsAsync) {
+		log_enableAsync(&log, config->logAsyncRingLength,
+				config->logAsyncOverflow);
+		log_setRotation(&log, config->logRotateFileBytes,
+				config->logRotateSeconds);
+
+		log_enableAsync(&jsonMessageLog, config->logAsyncRingLength,
+				config->logAsyncOverflow);
+		log_setRotation(&jsonMessageLog, config->logRotateFileBytes,
+				config->logRotateSeconds);
+
+		log_enableAsync(&sqlMessageLog, config->logAsyncRingLength,
+				config->logAsyncOverflow);
+		log_setRotation(&sqlMessageLog, config->logRotateFileBytes,
+				config->logRotateSeconds);
+	}
+
 	// configure http protocol
 
 	http_protocol_init(&protocol,
@@ -1188,11 +1550,33 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 			config->httpTempFileBasePath
 		);
 
+	http_protocol_setIdleTimeout(&protocol, config->socketIdleTimeoutSeconds);
+
 	// configure transaction manager
 
 	args.jsonMessageLog = &jsonMessageLog;
 	args.sqlMessageLog = &sqlMessageLog;
 	args.engine = &engine;
+	args.pfs = NULL;
+
+	if(config->profilerIsEnabled) {
+		pfs_init(&pfs, afalse, NULL);
+
+		args.pfs = &pfs;
+
+		if((config->profilerSamplingFrequency > 0) &&
+				(pfs_startSampling(&pfs,
+					config->profilerSamplingFrequency) < 0)) {
+			log_logf(&log, LOG_LEVEL_ERROR,
+					"failed to start the profiler sampling at %i Hz",
+					config->profilerSamplingFrequency);
+		}
+	}
+
+	fifostack_init(&args.arenaPool);
+	fifostack_setFreeFunction(&args.arenaPool, searchd_freeArena);
+
+	mutex_init(&args.arenaMutex);
 
 	transactionManager_init(&manager, &log);
 
@@ -1200,6 +1584,10 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 			&protocol,
 			http_protocol_transactionManagerReceive);
 
+	transactionManager_setReceiveBufferFunction(&manager,
+			&protocol,
+			http_protocol_transactionManagerReceiveBuffer);
+
 	transactionManager_setRecvFreeFunction(&manager,
 			http_protocol_transactionManagerReceiveFree);
 
@@ -1210,52 +1598,63 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 	transactionManager_setSendFreeFunction(&manager,
 			http_protocol_transactionManagerSendFree);
 
+	transactionManager_setKeepAliveFunction(&manager,
+			&protocol,
+			http_protocol_transactionManagerKeepAliveFunction);
+
 	transactionManager_setIdFunction(&manager,
 			&protocol,
 			http_protocol_transactionManagerIdFunction);
 
 	transactionManager_addHandler(&manager,
-			afalse,				// is socket left open
+			atrue,				// is socket left open
 			"default",
 			"searchd_handleDefault",
 			searchd_handleDefault,
 			&protocol);
 
 	transactionManager_addHandler(&manager,
-			afalse,				// is socket left open
+			atrue,				// is socket left open
 			"/",
 			"searchd_handleDefault",
 			searchd_handleDefault,
 			&protocol);
 
 	transactionManager_addHandler(&manager,
-			afalse,				// is socket left open
+			atrue,				// is socket left open
 			"/server-status",
 			"searchd_handleGetApacheServerStatus",
 			searchd_handleGetApacheServerStatus,
 			&server);
 
 	transactionManager_addHandler(&manager,
-			afalse,				// is socket left open
+			atrue,				// is socket left open
 			"/asgard-server-status",
 			"searchd_handleGetServerStatus",
 			searchd_handleGetServerStatus,
 			&server);
 
 	transactionManager_addHandler(&manager,
-			afalse,				// is socket left open
+			atrue,				// is socket left open
 			"/json-api",
 			"searchd_handleJsonMessage",
 			searchd_handleJsonMessage,
 			&args);
 
 	transactionManager_addHandler(&manager,
-			afalse,				// is socket left open
+			atrue,				// is socket left open
 			"/sql-api",
 			"searchd_handleSqlMessage",
 			searchd_handleSqlMessage,
 			&args);
 
+	transactionManager_addHandler(&manager,
+			atrue,				// is socket left open
+			"/asgard-profile",
+			"searchd_handleGetProfile",
+			searchd_handleGetProfile,
+			&args);
+
 	// configure server
 
 	server_init(&server, &log);
@@ -1265,6 +1664,14 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 			config->threadMinThreadPoolLength,
 			config->threadMaxThreadPoolLength);
 
+	server_setIdleTimeout(&server, config->socketIdleTimeoutSeconds);
+
+	if(config->threadIsEventModeEnabled) {
+		server_setServerMode(&server, SERVER_MODE_EVENT);
+		server_setMaxConnectionLength(&server,
+				config->threadMaxConnectionLength);
+	}
+
 	if(config->packetsIsDumpPacketsEnabled) {
 		server_setDumpPacketsOptions(&server,
 				config->packetsUseIndividualFiles,
@@ -1290,6 +1697,15 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 
 	searchEngine_init(&engine, &log);
 
+	if(config->searchShardCount > 1) {
+		if(searchEngine_setShardCount(&engine,
+					config->searchShardCount) < 0) {
+			log_logf(&log, LOG_LEVEL_ERROR,
+					"failed to shard the search engine across %i shard(s)",
+					config->searchShardCount);
+		}
+	}
+
 	searchEngine_setMaxContainerCount(&engine,
 			config->searchMaxContainerCount);
 
@@ -1313,6 +1729,13 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 	searchEngine_setMaxSortOperationMemoryLength(&engine,
 			config->maxSortOperationMemoryLength);
 
+	if(searchEngine_setQueryThreadPoolSize(&engine,
+				config->searchQueryThreadPoolSize) < 0) {
+		log_logf(&log, LOG_LEVEL_ERROR,
+				"failed to start the search query thread pool with %i "
+				"thread(s)", config->searchQueryThreadPoolSize);
+	}
+
 	searchEngine_setStringDelimiters(&engine,
 			config->searchStringDelimiters,
 			strlen(config->searchStringDelimiters));
@@ -1344,6 +1767,25 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 			config->searchContainerWriteThresholdSeconds,
 			config->searchContainerPath);
 
+	if(config->searchIsWalEnabled) {
+		if(searchEngine_setWalAttributes(&engine,
+					config->searchWalSyncType,
+					config->searchWalSyncIntervalSeconds,
+					config->searchCheckpointThresholdSeconds) < 0) {
+			log_logf(&log, LOG_LEVEL_ERROR,
+					"failed to open the write-ahead log in '%s'",
+					config->searchContainerPath);
+		}
+
+		log_logf(&log, LOG_LEVEL_INFO,
+				"{SEARCHD} write-ahead log settings "
+				"{ '%s' sync, %0.6f sync interval seconds, "
+				"%0.6f checkpoint threshold seconds }",
+				searchWal_syncTypeToString(config->searchWalSyncType),
+				config->searchWalSyncIntervalSeconds,
+				config->searchCheckpointThresholdSeconds);
+	}
+
 	searchEngine_loadExcludedWords(&engine,
 			config->searchExcludedWordConfigFilename);
 
@@ -1445,6 +1887,18 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 		fprintf(stdout, "OK.\n");
 	}
 
+	// log the profiler report
+
+	if(args.pfs != NULL) {
+		pfs_stopSampling(args.pfs);
+
+		if(pfs_buildReport(args.pfs, PFS_REPORT_FLAT, &pfsReport,
+					&pfsReportLength) == 0) {
+			log_logf(&log, LOG_LEVEL_INFO, "%s", pfsReport);
+			free(pfsReport);
+		}
+	}
+
 	// flush logs
 
 	fprintf(stdout, "Flushing logs...");
@@ -1496,6 +1950,13 @@ static int searchd_execute(SearchdConfig *config, SearchdOptions *options)
 
 	http_protocol_free(&protocol);
 
+	fifostack_free(&args.arenaPool);
+	mutex_free(&args.arenaMutex);
+
+	if(args.pfs != NULL) {
+		pfs_free(args.pfs);
+	}
+
 	log_free(&log);
 	log_free(&jsonMessageLog);
 	log_free(&sqlMessageLog);
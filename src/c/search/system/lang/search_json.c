@@ -34,6 +34,13 @@ static void buildDisplayFacets(SearchEngine *engine, char *domainKey,
 static void buildSearchResultFacets(SearchActionSearch *action,
 		char *attribute, Json *object);
 
+static Json *buildSearchResultHeader(SearchCompiler *compiler);
+
+static void beginSearchResultEntry(JsonWriter *writer, int counter);
+
+static int buildSearchResultSet(SearchCompiler *compiler, Json *result,
+		JsonWriter *writer);
+
 static aboolean compileSearchCondition(SearchCompiler *compiler,
 		SearchActionSearch *action, Json *condition,
 		SearchJsonValidationType validationType,
@@ -200,622 +207,657 @@ static void buildSearchResultFacets(SearchActionSearch *action,
 	free(facets);
 }
 
-static aboolean compileSearchCondition(SearchCompiler *compiler,
-		SearchActionSearch *action, Json *condition,
-		SearchJsonValidationType validationType,
-		SearchActionSearchCondition *searchCondition,
-		aboolean isRootCondition)
+static Json *buildSearchResultHeader(SearchCompiler *compiler)
 {
+	int rc = 0;
+	int ii = 0;
+	int nn = 0;
+	int counter = 0;
+	int domainListLength = 0;
+	double timer = 0.0;
+	double elapsedTime = 0.0;
 	char *string = NULL;
+	char **domainList = NULL;
 
-	const char *TEMPLATE = "failed to create search (condition) with '%s'";
+	Json *result = NULL;
+	SearchActionSearch *action = NULL;
 
-	if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-				"type", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((string = json_getString(condition, "type")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain (condition) 'type' parameter");
-		return afalse;
-	}
+	action = (SearchActionSearch *)compiler->action;
 
-	if(!strcasecmp(string, "wildcard")) {
-		searchCondition->type =
-			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD;
-	}
-	else if(!strcasecmp(string, "exact")) {
-		searchCondition->type =
-			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_EXACT;
-	}
-	else if(!strcasecmp(string, "user")) {
-		searchCondition->type =
-			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_USER;
-	}
-	else if(!strcasecmp(string, "range")) {
-		searchCondition->type =
-			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_RANGE;
+	result = json_newWithArena(compiler->arena);
 
-		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-					"rangeType", validationType, TEMPLATE)) {
-			return afalse;
-		}
-		else if((string = json_getString(condition, "rangeType")) == NULL) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to obtain (condition) 'rangeType' parameter");
-			return afalse;
-		}
+	json_addString(result, "messageName", "searchResponse");
 
-		if(!strcasecmp(string, "greater-than")) {
-			searchCondition->rangeType =
-				RANGE_INDEX_SEARCH_GREATER_THAN;
-		}
-		else if(!strcasecmp(string, "less-than")) {
-			searchCondition->rangeType =
-				RANGE_INDEX_SEARCH_LESS_THAN;
-		}
-		else if(!strcasecmp(string, "between")) {
-			searchCondition->rangeType =
-				RANGE_INDEX_SEARCH_BETWEEN;
-		}
-		else {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"unknown (condition) 'rangeType' parameter");
-			return afalse;
-		}
-	}
-	else if(!strcasecmp(string, "geocoord")) {
-		searchCondition->type =
-			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_GEO_COORD;
+	if(compiler->errorCode != 0) {
+		string = itoa(compiler->errorCode);
 
-		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-					"geoCoordType", validationType, TEMPLATE)) {
-			return afalse;
-		}
-		else if((string = json_getString(condition, "geoCoordType")) == NULL) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to obtain (condition) 'geoCoordType' "
-					"parameter");
-			return afalse;
-		}
+		json_addString(result, "resultCode", string);
 
-		if(!strcasecmp(string, "miles")) {
-			searchCondition->geoCoordType =
-				SEARCH_ENGINE_GEO_COORD_TYPE_MILES;
-		}
-		else if(!strcasecmp(string, "yards")) {
-			searchCondition->geoCoordType =
-				SEARCH_ENGINE_GEO_COORD_TYPE_YARDS;
-		}
-		else if(!strcasecmp(string, "feet")) {
-			searchCondition->geoCoordType =
-				SEARCH_ENGINE_GEO_COORD_TYPE_FEET;
-		}
-		else if(!strcasecmp(string, "kilometers")) {
-			searchCondition->geoCoordType =
-				SEARCH_ENGINE_GEO_COORD_TYPE_KILOMETERS;
+		free(string);
+
+		if(compiler->errorMessage != NULL) {
+			json_addString(result, "errorMessage", compiler->errorMessage);
 		}
-		else if(!strcasecmp(string, "meters")) {
-			searchCondition->geoCoordType =
-				SEARCH_ENGINE_GEO_COORD_TYPE_METERS;
+		else if(!compiler->isCompileComplete) {
+			json_addString(result, "errorMessage",
+					"compile failed to complete");
 		}
-		else {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"unknown (condition) 'geoCoordType' parameter");
-			return afalse;
+		else if(!compiler->isExecutionComplete) {
+			json_addString(result, "errorMessage",
+					"execution failed to complete");
 		}
-	}
-	else {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"unknown (condition) 'type' parameter");
-		return afalse;
+
+		return result;
 	}
 
-	switch(searchCondition->type) {
-		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD:
-		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_EXACT:
-		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_USER:
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-						"attribute", validationType, TEMPLATE)) {
-				return afalse;
-			}
-			else if((string = json_getString(condition, "attribute")) == NULL) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"failed to obtain (condition) 'attribute' "
-						"parameter");
-				return afalse;
-			}
+	json_addString(result, "resultCode", "0");
 
-			searchCondition->attribute = strdup(string);
+	// build the index summary or facets
 
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-						"value", validationType, TEMPLATE)) {
-				return afalse;
-			}
-			else if((string = json_getString(condition, "value")) == NULL) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"failed to obtain (condition) 'value' parameter");
-				return afalse;
-			}
+	if((action->facets.hasResultFacets) &&
+			((action->facets.isDisplayIndexSummary) ||
+			 (action->facets.isDisplayFacets))) {
+		timer = time_getTimeMus();
 
-			searchCondition->value = strdup(string);
-			break;
+		if(action->facets.isDisplayIndexSummary) {
+			json_addArray(result, "indexSummary");
+		}
 
-		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_RANGE:
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-						"attribute", validationType, TEMPLATE)) {
-				return afalse;
-			}
-			else if((string = json_getString(condition, "attribute")) == NULL) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"failed to obtain (condition) 'attribute' "
-						"parameter");
-				return afalse;
-			}
+		counter = 0;
 
-			searchCondition->attribute = strdup(string);
+		if(!action->settings.isGlobalSearch) {
+			for(ii = 0; ii < action->facets.attributesLength; ii++) {
+				for(nn = 0; nn < action->domainKeysLength; nn++) {
+					if(action->facets.isDisplayIndexSummary) {
+						buildIndexSummary(action->engine,
+								action->domainKeys[nn],
+								action->facets.attributes[ii],
+								result);
+						counter++;
+					}
+				}
 
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
-						"minValue", validationType, TEMPLATE)) {
-				return afalse;
+				if(action->facets.isDisplayFacets) {
+					buildSearchResultFacets(action,
+							action->facets.attributes[ii], result);
+				}
 			}
+		}
+		else if((domainList = searchEngine_listDomains(action->engine,
+						&domainListLength, &rc)) != NULL) {
+			for(ii = 0; ii < action->facets.attributesLength; ii++) {
+				for(nn = 0; nn < domainListLength; nn++) {
+					if(domainList[nn] == NULL) {
+						continue;
+					}
 
-			searchCondition->minValue = (int)json_getNumber(
-					condition, "minValue");
+					if(action->facets.isDisplayIndexSummary) {
+						buildIndexSummary(action->engine,
+								domainList[nn],
+								action->facets.attributes[ii],
+								result);
+						counter++;
+					}
+				}
 
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
-						"maxValue", validationType, TEMPLATE)) {
-				return afalse;
+				if(action->facets.isDisplayFacets) {
+					buildSearchResultFacets(action,
+							action->facets.attributes[ii], result);
+				}
 			}
 
-			searchCondition->maxValue = (int)json_getNumber(
-					condition, "maxValue");
-			break;
-
-		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_GEO_COORD:
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
-						"latitude", validationType, TEMPLATE)) {
-				return afalse;
+			for(ii = 0; ii < domainListLength; ii++) {
+				if(domainList[ii] != NULL) {
+					free(domainList[ii]);
+				}
 			}
 
-			searchCondition->latitude = json_getNumber(condition,
-					"latitude");
+			free(domainList);
+		}
 
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
-						"longitude", validationType, TEMPLATE)) {
-				return afalse;
-			}
+		elapsedTime = time_getElapsedMusInSeconds(timer);
 
-			searchCondition->longitude = json_getNumber(condition,
-					"longitude");
+		log_logf(compiler->log, LOG_LEVEL_DEBUG,
+				"{SEARCH} constructed %i index summary items in "
+				"%0.6f (%0.6f avg) seconds",
+				counter, elapsedTime, (elapsedTime / (double)counter));
+	}
 
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
-						"distance", validationType, TEMPLATE)) {
-				return afalse;
-			}
+	return result;
+}
 
-			searchCondition->distance = json_getNumber(condition,
-					"distance");
-			break;
+static void beginSearchResultEntry(JsonWriter *writer, int counter)
+{
+	if(counter == 0) {
+		jsonWriter_writeName(writer, "resultSet");
+		jsonWriter_beginArray(writer);
+	}
 
-		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_ERROR:
-		default:
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"detected invalid condition type");
-				return afalse;
-	}
-
-	if((isRootCondition) &&
-			((string = json_getString(condition, "intersect")) != NULL) &&
-			(!strcasecmp(string, "or"))) {
-		action->settings.isAndIntersection = afalse;
-	}
-
-	if(json_elementExists(condition, "isNotEqualTo")) {
-		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_BOOLEAN,
-					"isNotEqualTo", validationType, TEMPLATE)) {
-			return afalse;
-		}
-
-		searchCondition->isNotEqualTo =
-			json_getBoolean(condition, "isNotEqualTo");
-	}
-	else {
-		searchCondition->isNotEqualTo = afalse;
-	}
-
-	return atrue;
+	jsonWriter_beginObject(writer);
 }
 
-
-// define search compiler json language public functions
-
-char *searchJson_validationTypeToString(SearchJsonValidationType type)
+static int buildSearchResultSet(SearchCompiler *compiler, Json *result,
+		JsonWriter *writer)
 {
-	char *result = "unknown";
-
-	switch(type) {
-		case SEARCH_JSON_VALIDATION_TYPE_IGNORE:
-			result = "ignore";
-			break;
+	aboolean isAddLatitude = afalse;
+	aboolean isAddLongitude = afalse;
+	int rc = 0;
+	int ii = 0;
+	int nn = 0;
+	int limit = 0;
+	int offset = 0;
+	int counter = 0;
+	int stringLength = 0;
+	double timer = 0.0;
+	double elapsedTime = 0.0;
+	double latitude = 0.0;
+	double longitude = 0.0;
+	double distance = 0.0;
+	char *string = NULL;
 
-		case SEARCH_JSON_VALIDATION_TYPE_WARNING:
-			result = "warning";
-			break;
+	Json *entry = NULL;
+	Container *container = NULL;
+	SearchActionSearch *action = NULL;
 
-		case SEARCH_JSON_VALIDATION_TYPE_STRICT:
-			result = "strict";
-			break;
+	action = (SearchActionSearch *)compiler->action;
 
-		case SEARCH_JSON_VALIDATION_TYPE_UNKNOWN:
-		default:
-			result = "unknown";
-	}
+	/*
+	 * note: rows are either added to the result object, or, when a writer is
+	 * supplied, written from each container directly into its buffer, so that
+	 * no per-row object is built
+	 */
 
-	return result;
-}
+	timer = time_getTimeMus();
 
-SearchJsonValidationType searchJson_stringToValidationType(char *string)
-{
-	SearchJsonValidationType result = SEARCH_JSON_VALIDATION_TYPE_UNKNOWN;
+	offset = 0;
+	limit = action->intersect.result.length;
 
-	if(string == NULL) {
-		DISPLAY_INVALID_ARGS;
-		return SEARCH_JSON_VALIDATION_TYPE_UNKNOWN;
-	}
+	if(action->options.hasResultOptions) {
+		if(action->options.offset > 0) {
+			offset = action->options.offset;
+		}
 
-	if(!strcasecmp(string, "ignore")) {
-		result = SEARCH_JSON_VALIDATION_TYPE_IGNORE;
-	}
-	else if(!strcasecmp(string, "warning")) {
-		result = SEARCH_JSON_VALIDATION_TYPE_WARNING;
-	}
-	else if(!strcasecmp(string, "strict")) {
-		result = SEARCH_JSON_VALIDATION_TYPE_STRICT;
+		if(action->options.limit > 0) {
+			limit = action->options.limit;
+		}
 	}
 
-	return result;
-}
+	for(ii = offset, counter = 0;
+			((ii < action->intersect.result.length) && (counter < limit));
+			ii++) {
+		if(action->intersect.result.array[ii] == 0) {
+			continue;
+		}
 
-aboolean searchJson_compileNewDomain(SearchCompiler *compiler,
-		SearchJsonValidationType validationType, Json *message)
-{
-	char *domainKey = NULL;
-	char *domainName = NULL;
+		if((container = searchEngine_get(action->engine,
+						action->intersect.result.array[ii],
+						&rc)) == NULL) {
+			log_logf(compiler->log, LOG_LEVEL_WARNING,
+					"{SEARCH} failed to locate container #%i from search "
+					"intersection %i with '%s'",
+					action->intersect.result.array[ii], ii,
+					searchEngine_errorCodeToString(rc));
 
-	SearchActionNewDomain *action = NULL;
+			continue;
+		}
+		else if(action->settings.isEntireContainer) {
+			if(writer != NULL) {
+				beginSearchResultEntry(writer, counter);
+				container_writeJson(container, writer);
+			}
+			else {
+				entry = container_containerToJson(container);
+			}
 
-	const char *TEMPLATE = "failed to create new domain with '%s'";
+			searchEngine_unlockGet(action->engine, container);
 
-	if((compiler == NULL) || (message == NULL)) {
-		DISPLAY_INVALID_ARGS;
-		if(compiler != NULL) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"invalid or missing argument(s)");
+			if(action->options.isIncludeDistances) {
+				searchSort_determineGeoCoordsOnEntity(action->engine,
+						action->options.latitude,
+						action->options.longitude,
+						ii,
+						action->intersect.result.array,
+						action->intersect.result.length,
+						&latitude,
+						&longitude,
+						&distance);
+			}
 		}
-		return afalse;
-	}
-
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"domainKey", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'domainKey' parameter");
-		return afalse;
-	}
+		else {
+			isAddLatitude = afalse;
+			isAddLongitude = afalse;
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"domainName", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((domainName = json_getString(message, "domainName")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'domainName' parameter");
-		return afalse;
-	}
+			if(writer != NULL) {
+				beginSearchResultEntry(writer, counter);
 
-	action = (SearchActionNewDomain *)malloc(sizeof(SearchActionNewDomain));
+				jsonWriter_writeName(writer, "uid");
+				jsonWriter_writeNumber(writer, (double)container->uid);
+			}
+			else {
+				entry = json_newWithArena(compiler->arena);
 
-	action->key = strdup(domainKey);
-	action->name = strdup(domainName);
+				json_addNumber(entry, "uid", (double)container->uid);
+			}
 
-	compiler->type = SEARCH_COMPILER_ACTION_NEW_DOMAIN;
-	compiler->action = (void *)action;
+			for(nn = 0; nn < action->requestAttributesLength; nn++) {
+				if(!strcmp(action->requestAttributes[nn], "latitude")) {
+					isAddLatitude = atrue;
+					continue;
+				}
+				else if(!strcmp(action->requestAttributes[nn], "longitude")) {
+					isAddLongitude = atrue;
+					continue;
+				}
+				else if(!strcmp(action->requestAttributes[nn], "uid")) {
+					continue;
+				}
+				else if((string = container_getString(container,
+								action->requestAttributes[nn],
+								strlen(action->requestAttributes[nn]),
+								&stringLength)) == NULL) {
+					continue;
+				}
 
-	return atrue;
-}
+				if(writer != NULL) {
+					jsonWriter_writeName(writer,
+							action->requestAttributes[nn]);
+					jsonWriter_writeString(writer, string, stringLength);
+				}
+				else {
+					json_addString(entry, action->requestAttributes[nn],
+							string);
+				}
 
-Json *searchJson_buildNewDomainResult(SearchCompiler *compiler)
-{
-	char *string = NULL;
+				free(string);
+			}
 
-	Json *result = NULL;
+			searchEngine_unlockGet(action->engine, container);
 
-	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_NEW_DOMAIN)) {
-		DISPLAY_INVALID_ARGS;
-		return NULL;
-	}
+			if((isAddLatitude) ||
+					(isAddLongitude) ||
+					(action->options.isIncludeDistances)) {
+				searchSort_determineGeoCoordsOnEntity(action->engine,
+						action->options.latitude,
+						action->options.longitude,
+						ii,
+						action->intersect.result.array,
+						action->intersect.result.length,
+						&latitude,
+						&longitude,
+						&distance);
 
-	result = json_new();
+				if(isAddLatitude) {
+					string = (char *)malloc(sizeof(char) * 128);
+					snprintf(string, ((int)(sizeof(char) * 128) - 1), "%0.6f",
+							latitude);
 
-	json_addString(result, "messageName", "newDomainResponse");
+					if(writer != NULL) {
+						jsonWriter_writeName(writer, "latitude");
+						jsonWriter_writeString(writer, string,
+								strlen(string));
+					}
+					else {
+						json_addString(entry, "latitude", string);
+					}
 
-	if(compiler->errorCode != 0) {
-		string = itoa(compiler->errorCode);
+					free(string);
+				}
 
-		json_addString(result, "resultCode", string);
+				if(isAddLongitude) {
+					string = (char *)malloc(sizeof(char) * 128);
+					snprintf(string, ((int)(sizeof(char) * 128) - 1), "%0.6f",
+							longitude);
 
-		free(string);
+					if(writer != NULL) {
+						jsonWriter_writeName(writer, "longitude");
+						jsonWriter_writeString(writer, string,
+								strlen(string));
+					}
+					else {
+						json_addString(entry, "longitude", string);
+					}
 
-		if(compiler->errorMessage != NULL) {
-			json_addString(result, "errorMessage", compiler->errorMessage);
-		}
-		else if(!compiler->isCompileComplete) {
-			json_addString(result, "errorMessage",
-					"compile failed to complete");
+					free(string);
+				}
+			}
 		}
-		else if(!compiler->isExecutionComplete) {
-			json_addString(result, "errorMessage",
-					"execution failed to complete");
+
+		if((writer == NULL) && (entry == NULL)) {
+			continue;
 		}
-	}
-	else {
-		json_addString(result, "resultCode", "0");
-	}
 
-	return result;
-}
-
-aboolean searchJson_compileNewIndex(SearchCompiler *compiler,
-		SearchJsonValidationType validationType, Json *message)
-{
-	int indexType = 0;
-	char *string = NULL;
-	char *indexKey = NULL;
-	char *indexName = NULL;
-
-	SearchActionNewIndex *action = NULL;
-
-	const char *TEMPLATE = "failed to create new index with '%s'";
-
-	if((compiler == NULL) || (message == NULL)) {
-		DISPLAY_INVALID_ARGS;
-		if(compiler != NULL) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"invalid or missing argument(s)");
-		}
-		return afalse;
-	}
-
-	if(!json_elementExists(message, "indexType")) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to locate 'indexType' parameter");
-		return afalse;
-	}
-	else {
-		if((string = json_getString(message, "indexType")) == NULL) {
-			indexType = (int)json_getNumber(message, "indexType");
+		if(action->options.isIncludeDistances) {
+			distance = searchSort_calculateGeoCoordDistanceMiles(
+					action->options.latitude, action->options.longitude,
+					latitude, longitude);
 
-			if((indexType != INDEX_REGISTRY_TYPE_EXACT) &&
-					(indexType != INDEX_REGISTRY_TYPE_WILDCARD) &&
-					(indexType != INDEX_REGISTRY_TYPE_RANGE) &&
-					(indexType != INDEX_REGISTRY_TYPE_USER_KEY)) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"unrecognized 'indexType' parameter");
-				return afalse;
+			if(writer != NULL) {
+				jsonWriter_writeName(writer, "distanceInMiles");
+				jsonWriter_writeNumber(writer, distance);
+			}
+			else {
+				json_addNumber(entry, "distanceInMiles", distance);
 			}
 		}
-		else if(!strcasecmp(string, "exact")) {
-			indexType = INDEX_REGISTRY_TYPE_EXACT;
-		}
-		else if(!strcasecmp(string, "wildcard")) {
-			indexType = INDEX_REGISTRY_TYPE_WILDCARD;
-		}
-		else if(!strcasecmp(string, "range")) {
-			indexType = INDEX_REGISTRY_TYPE_RANGE;
-		}
-		else if(!strcasecmp(string, "user")) {
-			indexType = INDEX_REGISTRY_TYPE_USER_KEY;
+
+		if(writer != NULL) {
+			jsonWriter_endObject(writer);
 		}
 		else {
-			indexType = (int)json_getNumber(message, "indexType");
-
-			if((indexType != INDEX_REGISTRY_TYPE_EXACT) &&
-					(indexType != INDEX_REGISTRY_TYPE_WILDCARD) &&
-					(indexType != INDEX_REGISTRY_TYPE_RANGE) &&
-					(indexType != INDEX_REGISTRY_TYPE_USER_KEY)) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"unrecognized 'indexType' parameter");
-				return afalse;
+			if(counter == 0) {
+				json_addArray(result, "resultSet");
 			}
+
+			json_addObjectToArray(result, "resultSet", entry);
 		}
-	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"indexKey", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((indexKey = json_getString(message, "indexKey")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'indexKey' parameter");
-		return afalse;
+		counter++;
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"indexName", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((indexName = json_getString(message, "indexName")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'indexName' parameter");
-		return afalse;
+	if((writer != NULL) && (counter > 0)) {
+		jsonWriter_endArray(writer);
 	}
 
-	action = (SearchActionNewIndex *)malloc(sizeof(SearchActionNewIndex));
-
-	action->type = indexType;
-	action->key = strdup(indexKey);
-	action->name = strdup(indexName);
+	if(counter > 0) {
+		elapsedTime = time_getElapsedMusInSeconds(timer);
 
-	compiler->type = SEARCH_COMPILER_ACTION_NEW_INDEX;
-	compiler->action = (void *)action;
+		log_logf(compiler->log, LOG_LEVEL_DEBUG,
+				"{SEARCH} constructed %i search-result containers in "
+				"%0.6f (%0.6f avg) seconds",
+				counter, elapsedTime, (elapsedTime / (double)counter));
+	}
 
-	return atrue;
+	return counter;
 }
 
-Json *searchJson_buildNewIndexResult(SearchCompiler *compiler)
+static aboolean compileSearchCondition(SearchCompiler *compiler,
+		SearchActionSearch *action, Json *condition,
+		SearchJsonValidationType validationType,
+		SearchActionSearchCondition *searchCondition,
+		aboolean isRootCondition)
 {
 	char *string = NULL;
 
-	Json *result = NULL;
+	const char *TEMPLATE = "failed to create search (condition) with '%s'";
 
-	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_NEW_INDEX)) {
-		DISPLAY_INVALID_ARGS;
-		return NULL;
+	if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+				"type", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((string = json_getString(condition, "type")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain (condition) 'type' parameter");
+		return afalse;
 	}
 
-	result = json_new();
-
-	json_addString(result, "messageName", "newIndexResponse");
-
-	if(compiler->errorCode != 0) {
-		string = itoa(compiler->errorCode);
-
-		json_addString(result, "resultCode", string);
+	if(!strcasecmp(string, "wildcard")) {
+		searchCondition->type =
+			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD;
+	}
+	else if(!strcasecmp(string, "exact")) {
+		searchCondition->type =
+			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_EXACT;
+	}
+	else if(!strcasecmp(string, "user")) {
+		searchCondition->type =
+			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_USER;
+	}
+	else if(!strcasecmp(string, "range")) {
+		searchCondition->type =
+			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_RANGE;
 
-		free(string);
+		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+					"rangeType", validationType, TEMPLATE)) {
+			return afalse;
+		}
+		else if((string = json_getString(condition, "rangeType")) == NULL) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to obtain (condition) 'rangeType' parameter");
+			return afalse;
+		}
 
-		if(compiler->errorMessage != NULL) {
-			json_addString(result, "errorMessage", compiler->errorMessage);
+		if(!strcasecmp(string, "greater-than")) {
+			searchCondition->rangeType =
+				RANGE_INDEX_SEARCH_GREATER_THAN;
 		}
-		else if(!compiler->isCompileComplete) {
-			json_addString(result, "errorMessage",
-					"compile failed to complete");
+		else if(!strcasecmp(string, "less-than")) {
+			searchCondition->rangeType =
+				RANGE_INDEX_SEARCH_LESS_THAN;
 		}
-		else if(!compiler->isExecutionComplete) {
-			json_addString(result, "errorMessage",
-					"execution failed to complete");
+		else if(!strcasecmp(string, "between")) {
+			searchCondition->rangeType =
+				RANGE_INDEX_SEARCH_BETWEEN;
+		}
+		else {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"unknown (condition) 'rangeType' parameter");
+			return afalse;
 		}
 	}
-	else {
-		json_addString(result, "resultCode", "0");
-	}
-
-	return result;
-}
-
-aboolean searchJson_compileGet(SearchCompiler *compiler,
-		SearchJsonValidationType validationType, Json *message)
-{
-	int uid = 0;
-
-	SearchActionGet *action = NULL;
-
-	const char *TEMPLATE = "failed to create get with '%s'";
+	else if(!strcasecmp(string, "geocoord")) {
+		searchCondition->type =
+			SEARCH_COMPILER_SEARCH_CONDITION_TYPE_GEO_COORD;
 
-	if((compiler == NULL) || (message == NULL)) {
-		DISPLAY_INVALID_ARGS;
-		if(compiler != NULL) {
+		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+					"geoCoordType", validationType, TEMPLATE)) {
+			return afalse;
+		}
+		else if((string = json_getString(condition, "geoCoordType")) == NULL) {
 			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"invalid or missing argument(s)");
+					"failed to obtain (condition) 'geoCoordType' "
+					"parameter");
+			return afalse;
 		}
-		return afalse;
-	}
 
-	if(!json_elementExists(message, "uid")) {
-		if(!searchJson_compileGetByAttribute(compiler, validationType,
-					message)) {
+		if(!strcasecmp(string, "miles")) {
+			searchCondition->geoCoordType =
+				SEARCH_ENGINE_GEO_COORD_TYPE_MILES;
+		}
+		else if(!strcasecmp(string, "yards")) {
+			searchCondition->geoCoordType =
+				SEARCH_ENGINE_GEO_COORD_TYPE_YARDS;
+		}
+		else if(!strcasecmp(string, "feet")) {
+			searchCondition->geoCoordType =
+				SEARCH_ENGINE_GEO_COORD_TYPE_FEET;
+		}
+		else if(!strcasecmp(string, "kilometers")) {
+			searchCondition->geoCoordType =
+				SEARCH_ENGINE_GEO_COORD_TYPE_KILOMETERS;
+		}
+		else if(!strcasecmp(string, "meters")) {
+			searchCondition->geoCoordType =
+				SEARCH_ENGINE_GEO_COORD_TYPE_METERS;
+		}
+		else {
 			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to locate 'uid' parameter");
+					"unknown (condition) 'geoCoordType' parameter");
 			return afalse;
 		}
-		return atrue;
 	}
-
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_NUMBER,
-				"uid", validationType, TEMPLATE)) {
+	else {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"unknown (condition) 'type' parameter");
 		return afalse;
 	}
 
-	uid = (int)json_getNumber(message, "uid");
-
-	action = (SearchActionGet *)malloc(sizeof(SearchActionGet));
-
-	action->uid = uid;
+	switch(searchCondition->type) {
+		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD:
+		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_EXACT:
+		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_USER:
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+						"attribute", validationType, TEMPLATE)) {
+				return afalse;
+			}
+			else if((string = json_getString(condition, "attribute")) == NULL) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"failed to obtain (condition) 'attribute' "
+						"parameter");
+				return afalse;
+			}
 
-	compiler->type = SEARCH_COMPILER_ACTION_GET;
-	compiler->action = (void *)action;
+			searchCondition->attribute = arenaStrdup(compiler->arena,
+					string);
 
-	return atrue;
-}
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+						"value", validationType, TEMPLATE)) {
+				return afalse;
+			}
+			else if((string = json_getString(condition, "value")) == NULL) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"failed to obtain (condition) 'value' parameter");
+				return afalse;
+			}
 
-Json *searchJson_buildGetResult(SearchCompiler *compiler)
-{
-	char *string = NULL;
+			searchCondition->value = arenaStrdup(compiler->arena, string);
+			break;
 
-	Json *result = NULL;
-	Json *containerObject = NULL;
-	SearchActionGet *action = NULL;
+		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_RANGE:
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+						"attribute", validationType, TEMPLATE)) {
+				return afalse;
+			}
+			else if((string = json_getString(condition, "attribute")) == NULL) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"failed to obtain (condition) 'attribute' "
+						"parameter");
+				return afalse;
+			}
 
-	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_GET)) {
-		DISPLAY_INVALID_ARGS;
-		return NULL;
-	}
+			searchCondition->attribute = arenaStrdup(compiler->arena,
+					string);
 
-	action = (SearchActionGet *)compiler->action;
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
+						"minValue", validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-	result = json_new();
+			searchCondition->minValue = (int)json_getNumber(
+					condition, "minValue");
 
-	json_addString(result, "messageName", "getResponse");
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
+						"maxValue", validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-	if(compiler->errorCode != 0) {
-		string = itoa(compiler->errorCode);
+			searchCondition->maxValue = (int)json_getNumber(
+					condition, "maxValue");
+			break;
 
-		json_addString(result, "resultCode", string);
+		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_GEO_COORD:
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
+						"latitude", validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-		free(string);
+			searchCondition->latitude = json_getNumber(condition,
+					"latitude");
 
-		if(compiler->errorMessage != NULL) {
-			json_addString(result, "errorMessage", compiler->errorMessage);
-		}
-		else if(!compiler->isCompileComplete) {
-			json_addString(result, "errorMessage",
-					"compile failed to complete");
-		}
-		else if(!compiler->isExecutionComplete) {
-			json_addString(result, "errorMessage",
-					"execution failed to complete");
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
+						"longitude", validationType, TEMPLATE)) {
+				return afalse;
+			}
+
+			searchCondition->longitude = json_getNumber(condition,
+					"longitude");
+
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_NUMBER,
+						"distance", validationType, TEMPLATE)) {
+				return afalse;
+			}
+
+			searchCondition->distance = json_getNumber(condition,
+					"distance");
+			break;
+
+		case SEARCH_COMPILER_SEARCH_CONDITION_TYPE_ERROR:
+		default:
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"detected invalid condition type");
+				return afalse;
+	}
+
+	if((isRootCondition) &&
+			((string = json_getString(condition, "intersect")) != NULL) &&
+			(!strcasecmp(string, "or"))) {
+		action->settings.isAndIntersection = afalse;
+	}
+
+	if(json_elementExists(condition, "isNotEqualTo")) {
+		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_BOOLEAN,
+					"isNotEqualTo", validationType, TEMPLATE)) {
+			return afalse;
 		}
+
+		searchCondition->isNotEqualTo =
+			json_getBoolean(condition, "isNotEqualTo");
 	}
 	else {
-		json_addString(result, "resultCode", "0");
+		searchCondition->isNotEqualTo = afalse;
+	}
 
-		if((containerObject = container_containerToJson(
-						action->container)) == NULL) {
-			containerObject = json_new();
-		}
+	return atrue;
+}
 
-		json_addObject(result, "payload", containerObject);
+
+// define search compiler json language public functions
+
+char *searchJson_validationTypeToString(SearchJsonValidationType type)
+{
+	char *result = "unknown";
+
+	switch(type) {
+		case SEARCH_JSON_VALIDATION_TYPE_IGNORE:
+			result = "ignore";
+			break;
+
+		case SEARCH_JSON_VALIDATION_TYPE_WARNING:
+			result = "warning";
+			break;
+
+		case SEARCH_JSON_VALIDATION_TYPE_STRICT:
+			result = "strict";
+			break;
+
+		case SEARCH_JSON_VALIDATION_TYPE_UNKNOWN:
+		default:
+			result = "unknown";
 	}
 
 	return result;
 }
 
-aboolean searchJson_compileGetByAttribute(SearchCompiler *compiler,
+SearchJsonValidationType searchJson_stringToValidationType(char *string)
+{
+	SearchJsonValidationType result = SEARCH_JSON_VALIDATION_TYPE_UNKNOWN;
+
+	if(string == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_JSON_VALIDATION_TYPE_UNKNOWN;
+	}
+
+	if(!strcasecmp(string, "ignore")) {
+		result = SEARCH_JSON_VALIDATION_TYPE_IGNORE;
+	}
+	else if(!strcasecmp(string, "warning")) {
+		result = SEARCH_JSON_VALIDATION_TYPE_WARNING;
+	}
+	else if(!strcasecmp(string, "strict")) {
+		result = SEARCH_JSON_VALIDATION_TYPE_STRICT;
+	}
+
+	return result;
+}
+
+aboolean searchJson_compileNewDomain(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
-	char *attribute = NULL;
-	char *value = NULL;
+	char *domainKey = NULL;
+	char *domainName = NULL;
 
-	SearchActionGet *getAction = NULL;
-	SearchActionGetByAttribute *action = NULL;
+	SearchActionNewDomain *action = NULL;
 
-	const char *TEMPLATE = "failed to create get by attribute with '%s'";
+	const char *TEMPLATE = "failed to create new domain with '%s'";
 
 	if((compiler == NULL) || (message == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -827,67 +869,51 @@ aboolean searchJson_compileGetByAttribute(SearchCompiler *compiler,
 	}
 
 	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"attribute", validationType, TEMPLATE)) {
+				"domainKey", validationType, TEMPLATE)) {
 		return afalse;
 	}
-	else if((attribute = json_getString(message, "attribute")) == NULL) {
+	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'attribute' parameter");
+				"failed to obtain 'domainKey' parameter");
 		return afalse;
 	}
 
 	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"value", validationType, TEMPLATE)) {
+				"domainName", validationType, TEMPLATE)) {
 		return afalse;
 	}
-	else if((value = json_getString(message, "value")) == NULL) {
+	else if((domainName = json_getString(message, "domainName")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'value' parameter");
+				"failed to obtain 'domainName' parameter");
 		return afalse;
 	}
 
-	if(!strcasecmp(attribute, "uid")) {
-		getAction = (SearchActionGet *)malloc(sizeof(SearchActionGet));
-
-		getAction->uid = atoi(value);
-
-		compiler->type = SEARCH_COMPILER_ACTION_GET;
-		compiler->action = (void *)getAction;
-
-		return atrue;
-	}
-
-	action = (SearchActionGetByAttribute *)malloc(
-			sizeof(SearchActionGetByAttribute));
+	action = (SearchActionNewDomain *)malloc(sizeof(SearchActionNewDomain));
 
-	action->attribute = strdup(attribute);
-	action->value = strdup(value);
+	action->key = strdup(domainKey);
+	action->name = strdup(domainName);
 
-	compiler->type = SEARCH_COMPILER_ACTION_GET_BY_ATTRIBUTE;
+	compiler->type = SEARCH_COMPILER_ACTION_NEW_DOMAIN;
 	compiler->action = (void *)action;
 
 	return atrue;
 }
 
-Json *searchJson_buildGetByAttributeResult(SearchCompiler *compiler)
+Json *searchJson_buildNewDomainResult(SearchCompiler *compiler)
 {
 	char *string = NULL;
 
 	Json *result = NULL;
-	Json *containerObject = NULL;
-	SearchActionGetByAttribute *action = NULL;
 
 	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_GET_BY_ATTRIBUTE)) {
+			(compiler->type != SEARCH_COMPILER_ACTION_NEW_DOMAIN)) {
 		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	action = (SearchActionGetByAttribute *)compiler->action;
-
-	result = json_new();
+	result = json_newWithArena(compiler->arena);
 
-	json_addString(result, "messageName", "getResponse");
+	json_addString(result, "messageName", "newDomainResponse");
 
 	if(compiler->errorCode != 0) {
 		string = itoa(compiler->errorCode);
@@ -910,29 +936,22 @@ Json *searchJson_buildGetByAttributeResult(SearchCompiler *compiler)
 	}
 	else {
 		json_addString(result, "resultCode", "0");
-
-		if((containerObject = container_containerToJson(
-						action->container)) == NULL) {
-			containerObject = json_new();
-		}
-
-		json_addObject(result, "payload", containerObject);
 	}
 
 	return result;
 }
 
-aboolean searchJson_compilePut(SearchCompiler *compiler,
+aboolean searchJson_compileNewIndex(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
-	aboolean isImmediate = atrue;
-	char *domainKey = NULL;
+	int indexType = 0;
+	char *string = NULL;
+	char *indexKey = NULL;
+	char *indexName = NULL;
 
-	Json *payload = NULL;
-	Container *container = NULL;
-	SearchActionPut *action = NULL;
+	SearchActionNewIndex *action = NULL;
 
-	const char *TEMPLATE = "failed to create put with '%s'";
+	const char *TEMPLATE = "failed to create new index with '%s'";
 
 	if((compiler == NULL) || (message == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -943,69 +962,102 @@ aboolean searchJson_compilePut(SearchCompiler *compiler,
 		return afalse;
 	}
 
-	if(json_elementExists(message, "isImmediate")) {
-		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_BOOLEAN,
-					"isImmediate", validationType, TEMPLATE)) {
-			return afalse;
-		}
-		isImmediate = json_getBoolean(message, "isImmediate");
-	}
-
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"domainKey", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
+	if(!json_elementExists(message, "indexType")) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'domainKey' parameter");
+				"failed to locate 'indexType' parameter");
 		return afalse;
 	}
+	else {
+		if((string = json_getString(message, "indexType")) == NULL) {
+			indexType = (int)json_getNumber(message, "indexType");
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_OBJECT,
-				"payload", validationType, TEMPLATE)) {
-		return afalse;
+			if((indexType != INDEX_REGISTRY_TYPE_EXACT) &&
+					(indexType != INDEX_REGISTRY_TYPE_WILDCARD) &&
+					(indexType != INDEX_REGISTRY_TYPE_RANGE) &&
+					(indexType != INDEX_REGISTRY_TYPE_USER_KEY) &&
+					(indexType != INDEX_REGISTRY_TYPE_GEO)) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"unrecognized 'indexType' parameter");
+				return afalse;
+			}
+		}
+		else if(!strcasecmp(string, "exact")) {
+			indexType = INDEX_REGISTRY_TYPE_EXACT;
+		}
+		else if(!strcasecmp(string, "wildcard")) {
+			indexType = INDEX_REGISTRY_TYPE_WILDCARD;
+		}
+		else if(!strcasecmp(string, "range")) {
+			indexType = INDEX_REGISTRY_TYPE_RANGE;
+		}
+		else if(!strcasecmp(string, "user")) {
+			indexType = INDEX_REGISTRY_TYPE_USER_KEY;
+		}
+		else if(!strcasecmp(string, "geo")) {
+			indexType = INDEX_REGISTRY_TYPE_GEO;
+		}
+		else {
+			indexType = (int)json_getNumber(message, "indexType");
+
+			if((indexType != INDEX_REGISTRY_TYPE_EXACT) &&
+					(indexType != INDEX_REGISTRY_TYPE_WILDCARD) &&
+					(indexType != INDEX_REGISTRY_TYPE_RANGE) &&
+					(indexType != INDEX_REGISTRY_TYPE_USER_KEY) &&
+					(indexType != INDEX_REGISTRY_TYPE_GEO)) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"unrecognized 'indexType' parameter");
+				return afalse;
+			}
+		}
 	}
-	else if((payload = json_getObject(message, "payload")) == NULL) {
+
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+				"indexKey", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((indexKey = json_getString(message, "indexKey")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'payload' parameter");
+				"failed to obtain 'indexKey' parameter");
 		return afalse;
 	}
-	else if((container = container_jsonToContainer(payload)) == NULL) {
+
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+				"indexName", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((indexName = json_getString(message, "indexName")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to decode 'payload' object");
+				"failed to obtain 'indexName' parameter");
 		return afalse;
 	}
 
-	action = (SearchActionPut *)malloc(sizeof(SearchActionPut));
+	action = (SearchActionNewIndex *)malloc(sizeof(SearchActionNewIndex));
 
-	action->isImmediate = isImmediate;
-	action->domainKey = strdup(domainKey);
-	action->container = container;
+	action->type = indexType;
+	action->key = strdup(indexKey);
+	action->name = strdup(indexName);
 
-	compiler->type = SEARCH_COMPILER_ACTION_PUT;
+	compiler->type = SEARCH_COMPILER_ACTION_NEW_INDEX;
 	compiler->action = (void *)action;
 
 	return atrue;
 }
 
-Json *searchJson_buildPutResult(SearchCompiler *compiler)
+Json *searchJson_buildNewIndexResult(SearchCompiler *compiler)
 {
 	char *string = NULL;
 
 	Json *result = NULL;
-	SearchActionPut *action = NULL;
 
 	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_PUT)) {
+			(compiler->type != SEARCH_COMPILER_ACTION_NEW_INDEX)) {
 		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	action = (SearchActionPut *)compiler->action;
-
-	result = json_new();
+	result = json_newWithArena(compiler->arena);
 
-	json_addString(result, "messageName", "putResponse");
+	json_addString(result, "messageName", "newIndexResponse");
 
 	if(compiler->errorCode != 0) {
 		string = itoa(compiler->errorCode);
@@ -1028,25 +1080,19 @@ Json *searchJson_buildPutResult(SearchCompiler *compiler)
 	}
 	else {
 		json_addString(result, "resultCode", "0");
-		json_addNumber(result, "uid", (double)action->uid);
 	}
 
 	return result;
 }
 
-aboolean searchJson_compileUpdate(SearchCompiler *compiler,
+aboolean searchJson_compileGet(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
-	aboolean isImmediate = atrue;
-	char flags = (char)0;
-	char *domainKey = NULL;
-	char *messageName = NULL;
+	int uid = 0;
 
-	Json *payload = NULL;
-	Container *container = NULL;
-	SearchActionUpdate *action = NULL;
+	SearchActionGet *action = NULL;
 
-	const char *TEMPLATE = "failed to create update with '%s'";
+	const char *TEMPLATE = "failed to create get with '%s'";
 
 	if((compiler == NULL) || (message == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -1057,116 +1103,52 @@ aboolean searchJson_compileUpdate(SearchCompiler *compiler,
 		return afalse;
 	}
 
-	if(json_elementExists(message, "attribute")) {
-		return searchJson_compileUpdateByAttribute(compiler, validationType,
-				message);
-	}
-
-	if((messageName = json_getString(message, "messageName")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'messageName' parameter");
-		return afalse;
-	}
-
-	if(!strcasecmp(messageName, "update")) {
-		flags = CONTAINER_FLAG_UPDATE;
-	}
-	else if(!strcasecmp(messageName, "append")) {
-		flags = CONTAINER_FLAG_APPEND;
-	}
-	else if(!strcasecmp(messageName, "uppend")) {
-		flags = CONTAINER_FLAG_UPPEND;
-	}
-	else if(!strcasecmp(messageName, "replace")) {
-		flags = CONTAINER_FLAG_REPLACE;
-	}
-	else {
-		flags = CONTAINER_FLAG_UPDATE;
-	}
-
-	if(json_elementExists(message, "isImmediate")) {
-		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_BOOLEAN,
-					"isImmediate", validationType, TEMPLATE)) {
+	if(!json_elementExists(message, "uid")) {
+		if(!searchJson_compileGetByAttribute(compiler, validationType,
+					message)) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to locate 'uid' parameter");
 			return afalse;
 		}
-		isImmediate = json_getBoolean(message, "isImmediate");
+		return atrue;
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"domainKey", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'domainKey' parameter");
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_NUMBER,
+				"uid", validationType, TEMPLATE)) {
 		return afalse;
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_OBJECT,
-				"payload", validationType, TEMPLATE)) {
-		return afalse;
-	}
-	else if((payload = json_getObject(message, "payload")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'payload' parameter");
-		return afalse;
-	}
-	else if((container = container_jsonToContainer(payload)) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to decode 'payload' object");
-		return afalse;
-	}
+	uid = (int)json_getNumber(message, "uid");
 
-	action = (SearchActionUpdate *)malloc(sizeof(SearchActionUpdate));
+	action = (SearchActionGet *)malloc(sizeof(SearchActionGet));
 
-	action->isImmediate = isImmediate;
-	action->flags = flags;
-	action->domainKey = strdup(domainKey);
-	action->container = container;
+	action->uid = uid;
 
-	compiler->type = SEARCH_COMPILER_ACTION_UPDATE;
+	compiler->type = SEARCH_COMPILER_ACTION_GET;
 	compiler->action = (void *)action;
 
 	return atrue;
 }
 
-Json *searchJson_buildUpdateResult(SearchCompiler *compiler)
+Json *searchJson_buildGetResult(SearchCompiler *compiler)
 {
 	char *string = NULL;
 
 	Json *result = NULL;
-	SearchActionUpdate *action = NULL;
+	Json *containerObject = NULL;
+	SearchActionGet *action = NULL;
 
 	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_UPDATE)) {
+			(compiler->type != SEARCH_COMPILER_ACTION_GET)) {
 		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	action = (SearchActionUpdate *)compiler->action;
-
-	result = json_new();
-
-	switch(action->flags) {
-		case CONTAINER_FLAG_UPDATE:
-			json_addString(result, "messageName", "updateResponse");
-			break;
-
-		case CONTAINER_FLAG_APPEND:
-			json_addString(result, "messageName", "appendResponse");
-			break;
-
-		case CONTAINER_FLAG_UPPEND:
-			json_addString(result, "messageName", "uppendResponse");
-			break;
+	action = (SearchActionGet *)compiler->action;
 
-		case CONTAINER_FLAG_REPLACE:
-			json_addString(result, "messageName", "replaceResponse");
-			break;
+	result = json_newWithArena(compiler->arena);
 
-		default:
-			json_addString(result, "messageName", "updateResponse");
-	}
+	json_addString(result, "messageName", "getResponse");
 
 	if(compiler->errorCode != 0) {
 		string = itoa(compiler->errorCode);
@@ -1189,29 +1171,28 @@ Json *searchJson_buildUpdateResult(SearchCompiler *compiler)
 	}
 	else {
 		json_addString(result, "resultCode", "0");
-		json_addNumber(result, "uid", (double)action->uid);
+
+		if((containerObject = container_containerToJson(
+						action->container)) == NULL) {
+			containerObject = json_newWithArena(compiler->arena);
+		}
+
+		json_addObject(result, "payload", containerObject);
 	}
 
 	return result;
 }
 
-aboolean searchJson_compileUpdateByAttribute(SearchCompiler *compiler,
+aboolean searchJson_compileGetByAttribute(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
-	aboolean isImmediate = atrue;
-	char flags = (char)0;
-	int attributeLength = 0;
-	char *value = NULL;
 	char *attribute = NULL;
-	char *domainKey = NULL;
-	char *messageName = NULL;
+	char *value = NULL;
 
-	Json *payload = NULL;
-	Container *container = NULL;
-	SearchActionUpdate *updateAction = NULL;
-	SearchActionUpdateByAttribute *action = NULL;
+	SearchActionGet *getAction = NULL;
+	SearchActionGetByAttribute *action = NULL;
 
-	const char *TEMPLATE = "failed to create update by attribute with '%s'";
+	const char *TEMPLATE = "failed to create get by attribute with '%s'";
 
 	if((compiler == NULL) || (message == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -1222,36 +1203,6 @@ aboolean searchJson_compileUpdateByAttribute(SearchCompiler *compiler,
 		return afalse;
 	}
 
-	if((messageName = json_getString(message, "messageName")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'messageName' parameter");
-		return afalse;
-	}
-
-	if(strcasestr(messageName, "update") != NULL) {
-		flags = CONTAINER_FLAG_UPDATE;
-	}
-	else if(strcasestr(messageName, "append") != NULL) {
-		flags = CONTAINER_FLAG_APPEND;
-	}
-	else if(strcasestr(messageName, "uppend") != NULL) {
-		flags = CONTAINER_FLAG_UPPEND;
-	}
-	else if(strcasestr(messageName, "replace") != NULL) {
-		flags = CONTAINER_FLAG_REPLACE;
-	}
-	else {
-		flags = CONTAINER_FLAG_UPDATE;
-	}
-
-	if(json_elementExists(message, "isImmediate")) {
-		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_BOOLEAN,
-					"isImmediate", validationType, TEMPLATE)) {
-			return afalse;
-		}
-		isImmediate = json_getBoolean(message, "isImmediate");
-	}
-
 	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
 				"attribute", validationType, TEMPLATE)) {
 		return afalse;
@@ -1263,119 +1214,57 @@ aboolean searchJson_compileUpdateByAttribute(SearchCompiler *compiler,
 	}
 
 	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"domainKey", validationType, TEMPLATE)) {
+				"value", validationType, TEMPLATE)) {
 		return afalse;
 	}
-	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
+	else if((value = json_getString(message, "value")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'domainKey' parameter");
+				"failed to obtain 'value' parameter");
 		return afalse;
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_OBJECT,
-				"payload", validationType, TEMPLATE)) {
-		return afalse;
+	if(!strcasecmp(attribute, "uid")) {
+		getAction = (SearchActionGet *)malloc(sizeof(SearchActionGet));
+
+		getAction->uid = atoi(value);
+
+		compiler->type = SEARCH_COMPILER_ACTION_GET;
+		compiler->action = (void *)getAction;
+
+		return atrue;
 	}
-	else if((payload = json_getObject(message, "payload")) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'payload' parameter");
-		return afalse;
-	}
-	else if((container = container_jsonToContainer(payload)) == NULL) {
-		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to decode 'payload' object");
-		return afalse;
-	}
-
-	if(json_elementExists(message, "value")) {
-		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-					"value", validationType, TEMPLATE)) {
-			return afalse;
-		}
-		value = json_getString(message, "value");
-	}
-
-	attributeLength = strlen(attribute);
-
-	if((value != NULL) && (!strcasecmp(attribute, "uid"))) {
-		container_setUid(container, atoi(value));
-
-		updateAction = (SearchActionUpdate *)malloc(sizeof(SearchActionUpdate));
-
-		updateAction->isImmediate = isImmediate;
-		updateAction->flags = flags;
-		updateAction->domainKey = strdup(domainKey);
-		updateAction->container = container;
-
-		compiler->type = SEARCH_COMPILER_ACTION_UPDATE;
-		compiler->action = (void *)updateAction;
 
-		return atrue;
-	}
-
-	if(value != NULL) {
-		if(!container_exists(container, attribute, attributeLength)) {
-			container_putString(container, attribute, attributeLength, value,
-					strlen(value));
-		}
-		else {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"attribute already exists in payload");
-		}
-	}
-
-	action = (SearchActionUpdateByAttribute *)malloc(
-			sizeof(SearchActionUpdateByAttribute));
+	action = (SearchActionGetByAttribute *)malloc(
+			sizeof(SearchActionGetByAttribute));
 
-	action->isImmediate = isImmediate;
-	action->flags = flags;
-	action->attribute = strndup(attribute, attributeLength);
-	action->domainKey = strdup(domainKey);
-	action->container = container;
+	action->attribute = strdup(attribute);
+	action->value = strdup(value);
 
-	compiler->type = SEARCH_COMPILER_ACTION_UPDATE_BY_ATTRIBUTE;
+	compiler->type = SEARCH_COMPILER_ACTION_GET_BY_ATTRIBUTE;
 	compiler->action = (void *)action;
 
 	return atrue;
 }
 
-Json *searchJson_buildUpdateByAttributeResult(SearchCompiler *compiler)
+Json *searchJson_buildGetByAttributeResult(SearchCompiler *compiler)
 {
 	char *string = NULL;
 
 	Json *result = NULL;
-	SearchActionUpdateByAttribute *action = NULL;
+	Json *containerObject = NULL;
+	SearchActionGetByAttribute *action = NULL;
 
 	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_UPDATE_BY_ATTRIBUTE)) {
+			(compiler->type != SEARCH_COMPILER_ACTION_GET_BY_ATTRIBUTE)) {
 		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	action = (SearchActionUpdateByAttribute *)compiler->action;
-
-	result = json_new();
-
-	switch(action->flags) {
-		case CONTAINER_FLAG_UPDATE:
-			json_addString(result, "messageName", "updateResponse");
-			break;
-
-		case CONTAINER_FLAG_APPEND:
-			json_addString(result, "messageName", "appendResponse");
-			break;
-
-		case CONTAINER_FLAG_UPPEND:
-			json_addString(result, "messageName", "uppendResponse");
-			break;
+	action = (SearchActionGetByAttribute *)compiler->action;
 
-		case CONTAINER_FLAG_REPLACE:
-			json_addString(result, "messageName", "replaceResponse");
-			break;
+	result = json_newWithArena(compiler->arena);
 
-		default:
-			json_addString(result, "messageName", "updateResponse");
-	}
+	json_addString(result, "messageName", "getResponse");
 
 	if(compiler->errorCode != 0) {
 		string = itoa(compiler->errorCode);
@@ -1398,20 +1287,29 @@ Json *searchJson_buildUpdateByAttributeResult(SearchCompiler *compiler)
 	}
 	else {
 		json_addString(result, "resultCode", "0");
-		json_addNumber(result, "uid", (double)action->uid);
+
+		if((containerObject = container_containerToJson(
+						action->container)) == NULL) {
+			containerObject = json_newWithArena(compiler->arena);
+		}
+
+		json_addObject(result, "payload", containerObject);
 	}
 
 	return result;
 }
 
-aboolean searchJson_compileDelete(SearchCompiler *compiler,
+aboolean searchJson_compilePut(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
-	int uid = 0;
+	aboolean isImmediate = atrue;
+	char *domainKey = NULL;
 
-	SearchActionDelete *action = NULL;
+	Json *payload = NULL;
+	Container *container = NULL;
+	SearchActionPut *action = NULL;
 
-	const char *TEMPLATE = "failed to create delete with '%s'";
+	const char *TEMPLATE = "failed to create put with '%s'";
 
 	if((compiler == NULL) || (message == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -1422,48 +1320,69 @@ aboolean searchJson_compileDelete(SearchCompiler *compiler,
 		return afalse;
 	}
 
-	if(!json_elementExists(message, "uid")) {
-		if(!searchJson_compileDeleteByAttribute(compiler, validationType,
-					message)) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to locate 'uid' parameter");
+	if(json_elementExists(message, "isImmediate")) {
+		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_BOOLEAN,
+					"isImmediate", validationType, TEMPLATE)) {
 			return afalse;
 		}
-		return atrue;
+		isImmediate = json_getBoolean(message, "isImmediate");
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_NUMBER,
-				"uid", validationType, TEMPLATE)) {
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+				"domainKey", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain 'domainKey' parameter");
 		return afalse;
 	}
 
-	uid = (int)json_getNumber(message, "uid");
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_OBJECT,
+				"payload", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((payload = json_getObject(message, "payload")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain 'payload' parameter");
+		return afalse;
+	}
+	else if((container = container_jsonToContainer(payload)) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to decode 'payload' object");
+		return afalse;
+	}
 
-	action = (SearchActionDelete *)malloc(sizeof(SearchActionDelete));
+	action = (SearchActionPut *)malloc(sizeof(SearchActionPut));
 
-	action->uid = uid;
+	action->isImmediate = isImmediate;
+	action->domainKey = strdup(domainKey);
+	action->container = container;
 
-	compiler->type = SEARCH_COMPILER_ACTION_DELETE;
+	compiler->type = SEARCH_COMPILER_ACTION_PUT;
 	compiler->action = (void *)action;
 
 	return atrue;
 }
 
-Json *searchJson_buildDeleteResult(SearchCompiler *compiler)
+Json *searchJson_buildPutResult(SearchCompiler *compiler)
 {
 	char *string = NULL;
 
 	Json *result = NULL;
+	SearchActionPut *action = NULL;
 
 	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_DELETE)) {
+			(compiler->type != SEARCH_COMPILER_ACTION_PUT)) {
 		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	result = json_new();
+	action = (SearchActionPut *)compiler->action;
 
-	json_addString(result, "messageName", "deleteResponse");
+	result = json_newWithArena(compiler->arena);
+
+	json_addString(result, "messageName", "putResponse");
 
 	if(compiler->errorCode != 0) {
 		string = itoa(compiler->errorCode);
@@ -1486,21 +1405,25 @@ Json *searchJson_buildDeleteResult(SearchCompiler *compiler)
 	}
 	else {
 		json_addString(result, "resultCode", "0");
+		json_addNumber(result, "uid", (double)action->uid);
 	}
 
 	return result;
 }
 
-aboolean searchJson_compileDeleteByAttribute(SearchCompiler *compiler,
+aboolean searchJson_compileUpdate(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
-	char *value = NULL;
-	char *attribute = NULL;
+	aboolean isImmediate = atrue;
+	char flags = (char)0;
+	char *domainKey = NULL;
+	char *messageName = NULL;
 
-	SearchActionDelete *deleteAction = NULL;
-	SearchActionDeleteByAttribute *action = NULL;
+	Json *payload = NULL;
+	Container *container = NULL;
+	SearchActionUpdate *action = NULL;
 
-	const char *TEMPLATE = "failed to create delete by attribute with '%s'";
+	const char *TEMPLATE = "failed to create update with '%s'";
 
 	if((compiler == NULL) || (message == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -1511,68 +1434,116 @@ aboolean searchJson_compileDeleteByAttribute(SearchCompiler *compiler,
 		return afalse;
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"attribute", validationType, TEMPLATE)) {
-		return afalse;
+	if(json_elementExists(message, "attribute")) {
+		return searchJson_compileUpdateByAttribute(compiler, validationType,
+				message);
 	}
-	else if((attribute = json_getString(message, "attribute")) == NULL) {
+
+	if((messageName = json_getString(message, "messageName")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'attribute' parameter");
+				"failed to obtain 'messageName' parameter");
 		return afalse;
 	}
 
+	if(!strcasecmp(messageName, "update")) {
+		flags = CONTAINER_FLAG_UPDATE;
+	}
+	else if(!strcasecmp(messageName, "append")) {
+		flags = CONTAINER_FLAG_APPEND;
+	}
+	else if(!strcasecmp(messageName, "uppend")) {
+		flags = CONTAINER_FLAG_UPPEND;
+	}
+	else if(!strcasecmp(messageName, "replace")) {
+		flags = CONTAINER_FLAG_REPLACE;
+	}
+	else {
+		flags = CONTAINER_FLAG_UPDATE;
+	}
+
+	if(json_elementExists(message, "isImmediate")) {
+		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_BOOLEAN,
+					"isImmediate", validationType, TEMPLATE)) {
+			return afalse;
+		}
+		isImmediate = json_getBoolean(message, "isImmediate");
+	}
+
 	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
-				"value", validationType, TEMPLATE)) {
+				"domainKey", validationType, TEMPLATE)) {
 		return afalse;
 	}
-	else if((value = json_getString(message, "value")) == NULL) {
+	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain 'value' parameter");
+				"failed to obtain 'domainKey' parameter");
 		return afalse;
 	}
 
-	if(!strcasecmp(attribute, "uid")) {
-		deleteAction = (SearchActionDelete *)malloc(sizeof(SearchActionDelete));
-
-		deleteAction->uid = atoi(value);
-
-		compiler->type = SEARCH_COMPILER_ACTION_DELETE;
-		compiler->action = (void *)deleteAction;
-
-		return atrue;
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_OBJECT,
+				"payload", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((payload = json_getObject(message, "payload")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain 'payload' parameter");
+		return afalse;
+	}
+	else if((container = container_jsonToContainer(payload)) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to decode 'payload' object");
+		return afalse;
 	}
 
-	action = (SearchActionDeleteByAttribute *)malloc(
-			sizeof(SearchActionDeleteByAttribute));
+	action = (SearchActionUpdate *)malloc(sizeof(SearchActionUpdate));
 
-	action->uid = 0;
-	action->attribute = strdup(attribute);
-	action->value = strdup(value);
+	action->isImmediate = isImmediate;
+	action->flags = flags;
+	action->domainKey = strdup(domainKey);
+	action->container = container;
 
-	compiler->type = SEARCH_COMPILER_ACTION_DELETE_BY_ATTRIBUTE;
+	compiler->type = SEARCH_COMPILER_ACTION_UPDATE;
 	compiler->action = (void *)action;
 
 	return atrue;
 }
 
-Json *searchJson_buildDeleteByAttributeResult(SearchCompiler *compiler)
+Json *searchJson_buildUpdateResult(SearchCompiler *compiler)
 {
 	char *string = NULL;
 
 	Json *result = NULL;
-	SearchActionDeleteByAttribute *action = NULL;
+	SearchActionUpdate *action = NULL;
 
 	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_DELETE_BY_ATTRIBUTE)) {
+			(compiler->type != SEARCH_COMPILER_ACTION_UPDATE)) {
 		DISPLAY_INVALID_ARGS;
 		return NULL;
 	}
 
-	action = (SearchActionDeleteByAttribute *)compiler->action;
+	action = (SearchActionUpdate *)compiler->action;
 
-	result = json_new();
+	result = json_newWithArena(compiler->arena);
 
-	json_addString(result, "messageName", "deleteResponse");
+	switch(action->flags) {
+		case CONTAINER_FLAG_UPDATE:
+			json_addString(result, "messageName", "updateResponse");
+			break;
+
+		case CONTAINER_FLAG_APPEND:
+			json_addString(result, "messageName", "appendResponse");
+			break;
+
+		case CONTAINER_FLAG_UPPEND:
+			json_addString(result, "messageName", "uppendResponse");
+			break;
+
+		case CONTAINER_FLAG_REPLACE:
+			json_addString(result, "messageName", "replaceResponse");
+			break;
+
+		default:
+			json_addString(result, "messageName", "updateResponse");
+	}
 
 	if(compiler->errorCode != 0) {
 		string = itoa(compiler->errorCode);
@@ -1601,27 +1572,23 @@ Json *searchJson_buildDeleteByAttributeResult(SearchCompiler *compiler)
 	return result;
 }
 
-aboolean searchJson_compileSearch(SearchCompiler *compiler,
+aboolean searchJson_compileUpdateByAttribute(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
-	aboolean hasGroups = afalse;
-	aboolean isIncludeDistances = afalse;
-	int ii = 0;
-	int nn = 0;
-	int jj = 0;
-	int groupId = 0;
-	int rootConditionsLength = 0;
-	char *string = NULL;
+	aboolean isImmediate = atrue;
+	char flags = (char)0;
+	int attributeLength = 0;
+	char *value = NULL;
+	char *attribute = NULL;
+	char *domainKey = NULL;
+	char *messageName = NULL;
 
-	Json *condition = NULL;
-	Json *groupCondition = NULL;
-	Json *sortOptions = NULL;
-	Json *sortDirective = NULL;
-	Json *resultOptions = NULL;
-	Json *facetOptions = NULL;
-	SearchActionSearch *action = NULL;
+	Json *payload = NULL;
+	Container *container = NULL;
+	SearchActionUpdate *updateAction = NULL;
+	SearchActionUpdateByAttribute *action = NULL;
 
-	const char *TEMPLATE = "failed to create search with '%s'";
+	const char *TEMPLATE = "failed to create update by attribute with '%s'";
 
 	if((compiler == NULL) || (message == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -1632,852 +1599,1015 @@ aboolean searchJson_compileSearch(SearchCompiler *compiler,
 		return afalse;
 	}
 
-	action = (SearchActionSearch *)malloc(sizeof(SearchActionSearch));
-
-	compiler->action = (void *)action;
+	if((messageName = json_getString(message, "messageName")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain 'messageName' parameter");
+		return afalse;
+	}
 
-	// determine if primary required attributes exist, and check them
+	if(strcasestr(messageName, "update") != NULL) {
+		flags = CONTAINER_FLAG_UPDATE;
+	}
+	else if(strcasestr(messageName, "append") != NULL) {
+		flags = CONTAINER_FLAG_APPEND;
+	}
+	else if(strcasestr(messageName, "uppend") != NULL) {
+		flags = CONTAINER_FLAG_UPPEND;
+	}
+	else if(strcasestr(messageName, "replace") != NULL) {
+		flags = CONTAINER_FLAG_REPLACE;
+	}
+	else {
+		flags = CONTAINER_FLAG_UPDATE;
+	}
 
-	if(json_elementExists(message, "requestAttributes")) {
-		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_ARRAY,
-					"requestAttributes", validationType, TEMPLATE)) {
+	if(json_elementExists(message, "isImmediate")) {
+		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_BOOLEAN,
+					"isImmediate", validationType, TEMPLATE)) {
 			return afalse;
 		}
+		isImmediate = json_getBoolean(message, "isImmediate");
+	}
 
-		action->requestAttributesLength = json_getArrayLength(message,
-				"requestAttributes");
-
-		if(action->requestAttributesLength < 0) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to obtain valid value for 'requestAttributes' "
-					"array length");
-			return afalse;
-		}
-		else if(action->requestAttributesLength < 1) {
-			action->requestAttributesLength = 0;
-		}
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+				"attribute", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((attribute = json_getString(message, "attribute")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain 'attribute' parameter");
+		return afalse;
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_ARRAY,
-				"domainKeys", validationType, TEMPLATE)) {
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+				"domainKey", validationType, TEMPLATE)) {
 		return afalse;
 	}
-	else if((action->domainKeysLength = json_getArrayLength(message,
-					"domainKeys")) < 1) {
+	else if((domainKey = json_getString(message, "domainKey")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain value 'domainKeys' array length");
+				"failed to obtain 'domainKey' parameter");
 		return afalse;
 	}
 
-	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_ARRAY,
-				"conditions", validationType, TEMPLATE)) {
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_OBJECT,
+				"payload", validationType, TEMPLATE)) {
 		return afalse;
 	}
-	else if((rootConditionsLength = json_getArrayLength(message,
-					"conditions")) < 1) {
+	else if((payload = json_getObject(message, "payload")) == NULL) {
 		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-				"failed to obtain value 'conditions' array length");
+				"failed to obtain 'payload' parameter");
+		return afalse;
+	}
+	else if((container = container_jsonToContainer(payload)) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to decode 'payload' object");
 		return afalse;
 	}
 
-	// allocate & initialize request attributes
+	if(json_elementExists(message, "value")) {
+		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+					"value", validationType, TEMPLATE)) {
+			return afalse;
+		}
+		value = json_getString(message, "value");
+	}
 
-	if(action->requestAttributesLength > 0) {
-		action->requestAttributes = (char **)malloc(sizeof(char *) *
-				action->requestAttributesLength);
+	attributeLength = strlen(attribute);
 
-		for(ii = 0; ii < action->requestAttributesLength; ii++) {
-			if((string = json_getStringFromArray(message,
-							"requestAttributes", ii)) == NULL) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"failed to locate value in 'requestAttributes' array");
-				return afalse;
-			}
+	if((value != NULL) && (!strcasecmp(attribute, "uid"))) {
+		container_setUid(container, atoi(value));
 
-			action->requestAttributes[ii] = strdup(string);
+		updateAction = (SearchActionUpdate *)malloc(sizeof(SearchActionUpdate));
 
-			if((!action->settings.isEntireContainer) &&
-					(!strcasecmp(action->requestAttributes[ii], "*"))) {
-				action->settings.isEntireContainer = atrue;
-			}
-		}
-	}
+		updateAction->isImmediate = isImmediate;
+		updateAction->flags = flags;
+		updateAction->domainKey = strdup(domainKey);
+		updateAction->container = container;
 
-	// allocate & initialize domain keys
+		compiler->type = SEARCH_COMPILER_ACTION_UPDATE;
+		compiler->action = (void *)updateAction;
 
-	action->domainKeys = (char **)malloc(sizeof(char *) *
-			action->domainKeysLength);
+		return atrue;
+	}
 
-	for(ii = 0; ii < action->domainKeysLength; ii++) {
-		if((string = json_getStringFromArray(message,
-						"domainKeys", ii)) == NULL) {
+	if(value != NULL) {
+		if(!container_exists(container, attribute, attributeLength)) {
+			container_putString(container, attribute, attributeLength, value,
+					strlen(value));
+		}
+		else {
 			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to locate value in 'domainKeys' array");
-			return afalse;
+					"attribute already exists in payload");
 		}
+	}
+
+	action = (SearchActionUpdateByAttribute *)malloc(
+			sizeof(SearchActionUpdateByAttribute));
 
-		action->domainKeys[ii] = strdup(string);
+	action->isImmediate = isImmediate;
+	action->flags = flags;
+	action->attribute = strndup(attribute, attributeLength);
+	action->domainKey = strdup(domainKey);
+	action->container = container;
 
-		if((!action->settings.isGlobalSearch) &&
-				(!strcasecmp(action->domainKeys[ii], "*"))) {
-			action->settings.isGlobalSearch = atrue;
-		}
+	compiler->type = SEARCH_COMPILER_ACTION_UPDATE_BY_ATTRIBUTE;
+	compiler->action = (void *)action;
+
+	return atrue;
+}
+
+Json *searchJson_buildUpdateByAttributeResult(SearchCompiler *compiler)
+{
+	char *string = NULL;
+
+	Json *result = NULL;
+	SearchActionUpdateByAttribute *action = NULL;
+
+	if((compiler == NULL) ||
+			(compiler->type != SEARCH_COMPILER_ACTION_UPDATE_BY_ATTRIBUTE)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
 	}
 
-	// allocate & initialize search conditions
+	action = (SearchActionUpdateByAttribute *)compiler->action;
 
-	action->settings.isAndIntersection = atrue;
-	action->groupsLength = 0;
+	result = json_newWithArena(compiler->arena);
 
-	for(ii = 0; ii < rootConditionsLength; ii++) {
-		if((condition = json_getObjectFromArray(message,
-						"conditions", ii)) == NULL) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to locate value in 'conditions' array");
-			return afalse;
-		}
+	switch(action->flags) {
+		case CONTAINER_FLAG_UPDATE:
+			json_addString(result, "messageName", "updateResponse");
+			break;
 
-		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-					"type", validationType, TEMPLATE)) {
-			return afalse;
-		}
+		case CONTAINER_FLAG_APPEND:
+			json_addString(result, "messageName", "appendResponse");
+			break;
 
-		if((string = json_getString(condition, "type")) == NULL) {
-			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to obtain (condition) 'type' parameter");
-			return afalse;
-		}
+		case CONTAINER_FLAG_UPPEND:
+			json_addString(result, "messageName", "uppendResponse");
+			break;
 
-		if(!strcasecmp(string, "group")) {
-			hasGroups = atrue;
+		case CONTAINER_FLAG_REPLACE:
+			json_addString(result, "messageName", "replaceResponse");
 			break;
-		}
-	}
 
-	if(hasGroups) {
-		action->groupsLength = rootConditionsLength;
-	}
-	else {
-		action->groupsLength = 1;
+		default:
+			json_addString(result, "messageName", "updateResponse");
 	}
 
-	action->groups = (SearchActionSearchConditionGroup *)malloc(
-			sizeof(SearchActionSearchConditionGroup) * action->groupsLength);
+	if(compiler->errorCode != 0) {
+		string = itoa(compiler->errorCode);
 
-	if(!hasGroups) {
-		action->groups[0].isAndIntersection = atrue;
-		action->groups[0].conditionsLength = rootConditionsLength;
-		action->groups[0].conditions = (SearchActionSearchCondition *)malloc(
-			sizeof(SearchActionSearchCondition) *
-			action->groups[0].conditionsLength);
-	}
+		json_addString(result, "resultCode", string);
 
-	for(ii = 0, groupId = 0; ii < rootConditionsLength; ii++) {
-		if((condition = json_getObjectFromArray(message,
-						"conditions", ii)) == NULL) {
+		free(string);
+
+		if(compiler->errorMessage != NULL) {
+			json_addString(result, "errorMessage", compiler->errorMessage);
+		}
+		else if(!compiler->isCompileComplete) {
+			json_addString(result, "errorMessage",
+					"compile failed to complete");
+		}
+		else if(!compiler->isExecutionComplete) {
+			json_addString(result, "errorMessage",
+					"execution failed to complete");
+		}
+	}
+	else {
+		json_addString(result, "resultCode", "0");
+		json_addNumber(result, "uid", (double)action->uid);
+	}
+
+	return result;
+}
+
+aboolean searchJson_compileDelete(SearchCompiler *compiler,
+		SearchJsonValidationType validationType, Json *message)
+{
+	int uid = 0;
+
+	SearchActionDelete *action = NULL;
+
+	const char *TEMPLATE = "failed to create delete with '%s'";
+
+	if((compiler == NULL) || (message == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		if(compiler != NULL) {
 			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-					"failed to locate value in 'conditions' array");
+					"invalid or missing argument(s)");
+		}
+		return afalse;
+	}
+
+	if(!json_elementExists(message, "uid")) {
+		if(!searchJson_compileDeleteByAttribute(compiler, validationType,
+					message)) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to locate 'uid' parameter");
 			return afalse;
 		}
+		return atrue;
+	}
 
-		if(hasGroups) {
-			if(groupId >= action->groupsLength) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"aborting on detection of invalid group length");
-				return afalse;
-			}
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_NUMBER,
+				"uid", validationType, TEMPLATE)) {
+		return afalse;
+	}
 
-			action->groups[groupId].isAndIntersection = atrue;
+	uid = (int)json_getNumber(message, "uid");
 
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
-						"type", validationType, TEMPLATE)) {
-				return afalse;
-			}
+	action = (SearchActionDelete *)malloc(sizeof(SearchActionDelete));
 
-			if((string = json_getString(condition, "type")) == NULL) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"failed to obtain (condition) 'type' parameter");
-				return afalse;
-			}
+	action->uid = uid;
 
-			if(!strcasecmp(string, "groupOptions")) {
-				if(((string = json_getString(condition,
-									"intersect")) != NULL) &&
-						(!strcasecmp(string, "or"))) {
-					action->settings.isAndIntersection = afalse;
-				}
-				else {
-					action->settings.isAndIntersection = atrue;
-				}
-				continue;
-			}
-			else if(strcasecmp(string, "group")) {
-				action->groups[groupId].conditionsLength = 1;
-				action->groups[groupId].conditions =
-					(SearchActionSearchCondition *)malloc(
-							sizeof(SearchActionSearchCondition) *
-							action->groups[groupId].conditionsLength);
+	compiler->type = SEARCH_COMPILER_ACTION_DELETE;
+	compiler->action = (void *)action;
 
-				if(!compileSearchCondition(compiler, action, condition,
-							validationType,
-							&action->groups[groupId].conditions[0], atrue)) {
-					return afalse;
-				}
+	return atrue;
+}
 
-				groupId++;
-				continue;
-			}
+Json *searchJson_buildDeleteResult(SearchCompiler *compiler)
+{
+	char *string = NULL;
 
-			if(((string = json_getString(condition, "intersect")) != NULL) &&
-					(!strcasecmp(string, "or"))) {
-				action->groups[groupId].isAndIntersection = afalse;
-			}
+	Json *result = NULL;
 
-			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_ARRAY,
-						"conditions", validationType, TEMPLATE)) {
-				return afalse;
-			}
+	if((compiler == NULL) ||
+			(compiler->type != SEARCH_COMPILER_ACTION_DELETE)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
 
-			if((action->groups[groupId].conditionsLength = json_getArrayLength(
-							condition,
-							"conditions")) < 1) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"failed to obtain value 'conditions' array length");
-				return afalse;
-			}
+	result = json_newWithArena(compiler->arena);
 
-			action->groups[groupId].conditions =
-				(SearchActionSearchCondition *)malloc(
-						sizeof(SearchActionSearchCondition) *
-						action->groups[groupId].conditionsLength);
+	json_addString(result, "messageName", "deleteResponse");
 
-			for(nn = 0; nn < action->groups[groupId].conditionsLength; nn++) {
-				if((groupCondition = json_getObjectFromArray(condition,
-								"conditions", nn)) == NULL) {
-					searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-							"failed to locate value in 'conditions' array");
-					return afalse;
-				}
+	if(compiler->errorCode != 0) {
+		string = itoa(compiler->errorCode);
 
-				if(!compileSearchCondition(compiler, action, groupCondition,
-							validationType,
-							&action->groups[groupId].conditions[nn], afalse)) {
-					return afalse;
-				}
-			}
+		json_addString(result, "resultCode", string);
 
-			groupId++;
-		}
-		else {
-			if(!compileSearchCondition(compiler, action, condition,
-						validationType,
-						&action->groups[0].conditions[ii], atrue)) {
-				return afalse;
-			}
+		free(string);
 
-			if(((string = json_getString(condition, "intersect")) != NULL) &&
-					(!strcasecmp(string, "or"))) {
-				action->groups[0].isAndIntersection = afalse;
-			}
+		if(compiler->errorMessage != NULL) {
+			json_addString(result, "errorMessage", compiler->errorMessage);
+		}
+		else if(!compiler->isCompileComplete) {
+			json_addString(result, "errorMessage",
+					"compile failed to complete");
+		}
+		else if(!compiler->isExecutionComplete) {
+			json_addString(result, "errorMessage",
+					"execution failed to complete");
 		}
 	}
+	else {
+		json_addString(result, "resultCode", "0");
+	}
 
-	// determine if sorting options were specified
+	return result;
+}
 
-	if((sortOptions = json_getObject(message, "sortOptions")) != NULL) {
-		action->sort.isSorted = atrue;
+aboolean searchJson_compileDeleteByAttribute(SearchCompiler *compiler,
+		SearchJsonValidationType validationType, Json *message)
+{
+	char *value = NULL;
+	char *attribute = NULL;
 
-		if(((string = json_getString(sortOptions, "type")) != NULL) &&
-				(!strcasecmp(string, "multivalue"))) {
-			if(!checkJsonParameter(compiler, sortOptions, JSON_VALUE_TYPE_ARRAY,
-						"directives", validationType, TEMPLATE)) {
-				return afalse;
-			}
+	SearchActionDelete *deleteAction = NULL;
+	SearchActionDeleteByAttribute *action = NULL;
 
-			action->sort.directiveLength = json_getArrayLength(sortOptions,
-					"directives");
+	const char *TEMPLATE = "failed to create delete by attribute with '%s'";
 
-			sortDirective = json_getObjectFromArray(sortOptions,
-					"directives", 0);
-		}
-		else {
-			action->sort.directiveLength = 1;
-			sortDirective = sortOptions;
+	if((compiler == NULL) || (message == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		if(compiler != NULL) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"invalid or missing argument(s)");
 		}
+		return afalse;
+	}
 
-		action->sort.directives = (SearchActionSearchSortDirective *)malloc(
-				sizeof(SearchActionSearchSortDirective) *
-				action->sort.directiveLength);
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+				"attribute", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((attribute = json_getString(message, "attribute")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain 'attribute' parameter");
+		return afalse;
+	}
 
-		ii = 0;
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_STRING,
+				"value", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((value = json_getString(message, "value")) == NULL) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain 'value' parameter");
+		return afalse;
+	}
 
-		do {
-			if(sortDirective == NULL) {
-				break;
-			}
+	if(!strcasecmp(attribute, "uid")) {
+		deleteAction = (SearchActionDelete *)malloc(sizeof(SearchActionDelete));
 
-			if(json_elementExists(sortDirective, "direction")) {
-				if(!checkJsonParameter(compiler, sortDirective,
-							JSON_VALUE_TYPE_STRING, "direction",
-							validationType, TEMPLATE)) {
-					return afalse;
-				}
-			}
+		deleteAction->uid = atoi(value);
 
-			if(((string = json_getString(sortDirective,
-								"direction")) != NULL) &&
-					(!strcasecmp(string, "asc"))) {
-				action->sort.directives[ii].isStandardSortOrder = afalse;
-			}
-			else {
-				action->sort.directives[ii].isStandardSortOrder = atrue;
-			}
-	
-			action->sort.directives[ii].type =
-				SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN;
+		compiler->type = SEARCH_COMPILER_ACTION_DELETE;
+		compiler->action = (void *)deleteAction;
 
-			if(json_elementExists(sortDirective, "type")) {
-				if(!checkJsonParameter(compiler, sortDirective,
-							JSON_VALUE_TYPE_STRING, "type",
-							validationType, TEMPLATE)) {
-					return afalse;
-				}
-			}
-	
-			if((string = json_getString(sortDirective, "type")) != NULL) {
-				if(!strcasecmp(string, "attribute")) {
-					if(!checkJsonParameter(compiler, sortDirective,
-								JSON_VALUE_TYPE_STRING, "attribute",
-								validationType, TEMPLATE)) {
-						return afalse;
-					}
+		return atrue;
+	}
 
-					if((string = json_getString(sortDirective,
-									"attribute")) != NULL) {
-						action->sort.directives[ii].type =
-							SEARCH_COMPILER_SEARCH_SORT_TYPE_ATTRIBUTE;
-						action->sort.directives[ii].attribute = strdup(string);
-					}
-					else {
-						action->sort.directives[ii].type =
-							SEARCH_COMPILER_SEARCH_SORT_TYPE_ERROR;
-					}
-				}
-				else if(!strcasecmp(string, "geocoord")) {
-					if(!checkJsonParameter(compiler, sortDirective,
-								JSON_VALUE_TYPE_NUMBER, "latitude",
-								validationType, TEMPLATE)) {
-						return afalse;
-					}
+	action = (SearchActionDeleteByAttribute *)malloc(
+			sizeof(SearchActionDeleteByAttribute));
 
-					if(!checkJsonParameter(compiler, sortDirective,
-								JSON_VALUE_TYPE_NUMBER, "longitude",
-								validationType, TEMPLATE)) {
-						return afalse;
-					}
+	action->uid = 0;
+	action->attribute = strdup(attribute);
+	action->value = strdup(value);
 
-					if((json_elementExists(sortDirective, "latitude")) &&
-							(json_elementExists(sortDirective, "longitude"))) {
-						action->sort.directives[ii].type =
-							SEARCH_COMPILER_SEARCH_SORT_TYPE_GEO_COORD;
-						action->sort.directives[ii].latitude =
-							json_getNumber(sortDirective,
-								"latitude");
-						action->sort.directives[ii].longitude =
-							json_getNumber(sortDirective,
-								"longitude");
-					}
-					else {
-						action->sort.directives[ii].type =
-							SEARCH_COMPILER_SEARCH_SORT_TYPE_ERROR;
-					}
-				}
-				else if(!strcasecmp(string, "relevancy")) {
-					action->sort.directives[ii].type =
-						SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY;
-				}
-			}
+	compiler->type = SEARCH_COMPILER_ACTION_DELETE_BY_ATTRIBUTE;
+	compiler->action = (void *)action;
 
-			if((action->sort.directives[ii].type ==
-					 SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY) ||
-					(action->sort.directives[ii].type ==
-					 SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN)) {
-				action->sort.directives[ii].type =
-					SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN;
+	return atrue;
+}
 
-				for(nn = 0; nn < action->groupsLength; nn++) {
-					for(jj = 0;
-							jj < action->groups[nn].conditionsLength;
-							jj++) {
-						if((action->groups[nn].conditions[jj].type ==
-							 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
-							(action->groups[nn].conditions[jj].type ==
-							 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
-							(action->groups[nn].conditions[jj].type ==
-							 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD)) {
-							action->sort.directives[ii].type =
-								SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY;
-							break;
-						}
-					}
-				}
-			}
-	
-			if(action->sort.directives[ii].type ==
-					SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN) {
-				action->sort.isSorted = afalse;
-				break;
-			}
+Json *searchJson_buildDeleteByAttributeResult(SearchCompiler *compiler)
+{
+	char *string = NULL;
 
-			ii++;
-			if(ii >= action->sort.directiveLength) {
-				break;
-			}
+	Json *result = NULL;
+	SearchActionDeleteByAttribute *action = NULL;
 
-			sortDirective = json_getObjectFromArray(sortOptions,
-					"directives", ii);
-		} while(sortDirective != NULL);
+	if((compiler == NULL) ||
+			(compiler->type != SEARCH_COMPILER_ACTION_DELETE_BY_ATTRIBUTE)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	action = (SearchActionDeleteByAttribute *)compiler->action;
+
+	result = json_newWithArena(compiler->arena);
+
+	json_addString(result, "messageName", "deleteResponse");
+
+	if(compiler->errorCode != 0) {
+		string = itoa(compiler->errorCode);
+
+		json_addString(result, "resultCode", string);
+
+		free(string);
+
+		if(compiler->errorMessage != NULL) {
+			json_addString(result, "errorMessage", compiler->errorMessage);
+		}
+		else if(!compiler->isCompileComplete) {
+			json_addString(result, "errorMessage",
+					"compile failed to complete");
+		}
+		else if(!compiler->isExecutionComplete) {
+			json_addString(result, "errorMessage",
+					"execution failed to complete");
+		}
 	}
 	else {
-		for(ii = 0; ii < action->groupsLength; ii++) {
-			for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
-				if((action->groups[ii].conditions[nn].type ==
-						 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
-						(action->groups[ii].conditions[nn].type ==
-						 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
-						(action->groups[ii].conditions[nn].type ==
-						 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD)) {
-					action->sort.isSorted = atrue;
-					action->sort.directiveLength = 1;
-					action->sort.directives =
-						(SearchActionSearchSortDirective *)malloc(
-								sizeof(SearchActionSearchSortDirective) *
-								action->sort.directiveLength);
-					action->sort.directives[0].type =
-						SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY;
-					break;
-				}
-			}
+		json_addString(result, "resultCode", "0");
+		json_addNumber(result, "uid", (double)action->uid);
+	}
+
+	return result;
+}
+
+aboolean searchJson_compileSearch(SearchCompiler *compiler,
+		SearchJsonValidationType validationType, Json *message)
+{
+	aboolean hasGroups = afalse;
+	aboolean isIncludeDistances = afalse;
+	int ii = 0;
+	int nn = 0;
+	int jj = 0;
+	int groupId = 0;
+	int rootConditionsLength = 0;
+	char *string = NULL;
+
+	Json *condition = NULL;
+	Json *groupCondition = NULL;
+	Json *sortOptions = NULL;
+	Json *sortDirective = NULL;
+	Json *resultOptions = NULL;
+	Json *facetOptions = NULL;
+	SearchActionSearch *action = NULL;
+
+	const char *TEMPLATE = "failed to create search with '%s'";
+
+	if((compiler == NULL) || (message == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		if(compiler != NULL) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"invalid or missing argument(s)");
 		}
+		return afalse;
 	}
 
-	// determine if result options were specified
+	action = (SearchActionSearch *)arenaMalloc(compiler->arena,
+			sizeof(SearchActionSearch));
 
-	if((resultOptions = json_getObject(message, "resultOptions")) != NULL) {
-		if(json_elementExists(resultOptions, "offset")) {
-			if(!checkJsonParameter(compiler, resultOptions,
-						JSON_VALUE_TYPE_NUMBER, "offset",
-						validationType, TEMPLATE)) {
-				return afalse;
-			}
+	compiler->action = (void *)action;
 
-			if((action->options.offset = (int)json_getNumber(resultOptions,
-							"offset")) < 0) {
-				action->options.offset = 0;
-			}
+	// determine if primary required attributes exist, and check them
+
+	if(json_elementExists(message, "requestAttributes")) {
+		if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_ARRAY,
+					"requestAttributes", validationType, TEMPLATE)) {
+			return afalse;
 		}
 
-		if(json_elementExists(resultOptions, "limit")) {
-			if(!checkJsonParameter(compiler, resultOptions,
-						JSON_VALUE_TYPE_NUMBER, "limit",
-						validationType, TEMPLATE)) {
-				return afalse;
-			}
+		action->requestAttributesLength = json_getArrayLength(message,
+				"requestAttributes");
 
-			if((action->options.limit = (int)json_getNumber(resultOptions,
-							"limit")) < 0) {
-				action->options.limit = 0;
-			}
+		if(action->requestAttributesLength < 0) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to obtain valid value for 'requestAttributes' "
+					"array length");
+			return afalse;
+		}
+		else if(action->requestAttributesLength < 1) {
+			action->requestAttributesLength = 0;
 		}
+	}
 
-		if(json_elementExists(resultOptions, "includeDistances")) {
-			if(!checkJsonParameter(compiler, resultOptions,
-						JSON_VALUE_TYPE_BOOLEAN, "includeDistances",
-						validationType, TEMPLATE)) {
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_ARRAY,
+				"domainKeys", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((action->domainKeysLength = json_getArrayLength(message,
+					"domainKeys")) < 1) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain value 'domainKeys' array length");
+		return afalse;
+	}
+
+	if(!checkJsonParameter(compiler, message, JSON_VALUE_TYPE_ARRAY,
+				"conditions", validationType, TEMPLATE)) {
+		return afalse;
+	}
+	else if((rootConditionsLength = json_getArrayLength(message,
+					"conditions")) < 1) {
+		searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+				"failed to obtain value 'conditions' array length");
+		return afalse;
+	}
+
+	// allocate & initialize request attributes
+
+	if(action->requestAttributesLength > 0) {
+		action->requestAttributes = (char **)arenaMalloc(compiler->arena,
+				(sizeof(char *) * action->requestAttributesLength));
+
+		for(ii = 0; ii < action->requestAttributesLength; ii++) {
+			if((string = json_getStringFromArray(message,
+							"requestAttributes", ii)) == NULL) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"failed to locate value in 'requestAttributes' array");
 				return afalse;
 			}
 
-			isIncludeDistances = json_getBoolean(resultOptions,
-					"includeDistances");
+			action->requestAttributes[ii] = arenaStrdup(compiler->arena,
+					string);
 
-			if(isIncludeDistances) {
-				if(!checkJsonParameter(compiler, resultOptions,
-							JSON_VALUE_TYPE_NUMBER, "latitude",
-							validationType, TEMPLATE)) {
-					return afalse;
-				}
-
-				if(!checkJsonParameter(compiler, resultOptions,
-							JSON_VALUE_TYPE_NUMBER, "longitude",
-							validationType, TEMPLATE)) {
-					return afalse;
-				}
+			if((!action->settings.isEntireContainer) &&
+					(!strcasecmp(action->requestAttributes[ii], "*"))) {
+				action->settings.isEntireContainer = atrue;
 			}
 		}
+	}
 
-		if(isIncludeDistances) {
-			action->options.isIncludeDistances = isIncludeDistances;
+	// allocate & initialize domain keys
 
-			action->options.latitude = json_getNumber(resultOptions,
-					"latitude");
+	action->domainKeys = (char **)arenaMalloc(compiler->arena,
+			(sizeof(char *) * action->domainKeysLength));
 
-			action->options.longitude = json_getNumber(resultOptions,
-					"longitude");
+	for(ii = 0; ii < action->domainKeysLength; ii++) {
+		if((string = json_getStringFromArray(message,
+						"domainKeys", ii)) == NULL) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to locate value in 'domainKeys' array");
+			return afalse;
 		}
 
-		action->options.hasResultOptions = atrue;
+		action->domainKeys[ii] = arenaStrdup(compiler->arena, string);
+
+		if((!action->settings.isGlobalSearch) &&
+				(!strcasecmp(action->domainKeys[ii], "*"))) {
+			action->settings.isGlobalSearch = atrue;
+		}
 	}
 
-	// determine if facet options were specified
+	// allocate & initialize search conditions
 
-	if((facetOptions = json_getObject(message, "facetOptions")) != NULL) {
-		if(json_elementExists(facetOptions, "displayIndexSummary")) {
-			if(!checkJsonParameter(compiler, facetOptions,
-						JSON_VALUE_TYPE_BOOLEAN, "displayIndexSummary",
-						validationType, TEMPLATE)) {
-				return afalse;
-			}
+	action->settings.isAndIntersection = atrue;
+	action->groupsLength = 0;
 
-			action->facets.isDisplayIndexSummary = json_getBoolean(
-					facetOptions, "displayIndexSummary");
+	for(ii = 0; ii < rootConditionsLength; ii++) {
+		if((condition = json_getObjectFromArray(message,
+						"conditions", ii)) == NULL) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to locate value in 'conditions' array");
+			return afalse;
 		}
 
-		if(json_elementExists(facetOptions, "displayFacets")) {
-			if(!checkJsonParameter(compiler, facetOptions,
-						JSON_VALUE_TYPE_BOOLEAN, "displayFacets",
-						validationType, TEMPLATE)) {
-				return afalse;
-			}
+		if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+					"type", validationType, TEMPLATE)) {
+			return afalse;
+		}
 
-			action->facets.isDisplayFacets =
-				json_getBoolean(facetOptions, "displayFacets");
+		if((string = json_getString(condition, "type")) == NULL) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to obtain (condition) 'type' parameter");
+			return afalse;
 		}
 
-		// allocate & initialize facet attributes
+		if(!strcasecmp(string, "group")) {
+			hasGroups = atrue;
+			break;
+		}
+	}
 
-		if((action->facets.isDisplayIndexSummary) ||
-				(action->facets.isDisplayFacets)) {
-			if(!checkJsonParameter(compiler, facetOptions,
-						JSON_VALUE_TYPE_ARRAY, "attributes",
-						validationType, TEMPLATE)) {
-				return afalse;
-			}
-			else if((action->facets.attributesLength = json_getArrayLength(
-							facetOptions, "attributes")) < 1) {
-				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-						"failed to obtain value 'facetOptions->attributes' "
-						"array length");
-				return afalse;
-			}
+	if(hasGroups) {
+		action->groupsLength = rootConditionsLength;
+	}
+	else {
+		action->groupsLength = 1;
+	}
 
-			action->facets.attributes = (char **)malloc(sizeof(char *) *
-					action->facets.attributesLength);
+	action->groups = (SearchActionSearchConditionGroup *)arenaMalloc(
+			compiler->arena,
+			(sizeof(SearchActionSearchConditionGroup) * action->groupsLength));
 
-			for(ii = 0; ii < action->facets.attributesLength; ii++) {
-				if((string = json_getStringFromArray(facetOptions,
-								"attributes", ii)) == NULL) {
-					searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
-							"failed to locate value in "
-							"'facetOptions->attributes' array");
-					return afalse;
-				}
+	if(!hasGroups) {
+		action->groups[0].isAndIntersection = atrue;
+		action->groups[0].conditionsLength = rootConditionsLength;
+		action->groups[0].conditions =
+			(SearchActionSearchCondition *)arenaMalloc(compiler->arena,
+					(sizeof(SearchActionSearchCondition) *
+					 action->groups[0].conditionsLength));
+	}
 
-				action->facets.attributes[ii] = strdup(string);
-			}
+	for(ii = 0, groupId = 0; ii < rootConditionsLength; ii++) {
+		if((condition = json_getObjectFromArray(message,
+						"conditions", ii)) == NULL) {
+			searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+					"failed to locate value in 'conditions' array");
+			return afalse;
 		}
 
-		action->facets.hasResultFacets = atrue;
-	}
-
-	// finish initialization
+		if(hasGroups) {
+			if(groupId >= action->groupsLength) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"aborting on detection of invalid group length");
+				return afalse;
+			}
 
-	intersect_init(&action->intersect);
+			action->groups[groupId].isAndIntersection = atrue;
 
-	compiler->type = SEARCH_COMPILER_ACTION_SEARCH;
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_STRING,
+						"type", validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-	return atrue;
-}
+			if((string = json_getString(condition, "type")) == NULL) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"failed to obtain (condition) 'type' parameter");
+				return afalse;
+			}
 
-Json *searchJson_buildSearchResult(SearchCompiler *compiler)
-{
-	aboolean isAddLatitude = afalse;
-	aboolean isAddLongitude = afalse;
-	int rc = 0;
-	int ii = 0;
-	int nn = 0;
-	int limit = 0;
-	int offset = 0;
-	int counter = 0;
-	int stringLength = 0;
-	int domainListLength = 0;
-	double timer = 0.0;
-	double elapsedTime = 0.0;
-	double latitude = 0.0;
-	double longitude = 0.0;
-	double distance = 0.0;
-	char *string = NULL;
-	char **domainList = NULL;
+			if(!strcasecmp(string, "groupOptions")) {
+				if(((string = json_getString(condition,
+									"intersect")) != NULL) &&
+						(!strcasecmp(string, "or"))) {
+					action->settings.isAndIntersection = afalse;
+				}
+				else {
+					action->settings.isAndIntersection = atrue;
+				}
+				continue;
+			}
+			else if(strcasecmp(string, "group")) {
+				action->groups[groupId].conditionsLength = 1;
+				action->groups[groupId].conditions =
+					(SearchActionSearchCondition *)arenaMalloc(
+							compiler->arena,
+							(sizeof(SearchActionSearchCondition) *
+							 action->groups[groupId].conditionsLength));
 
-	Json *entry = NULL;
-	Json *result = NULL;
-	Container *container = NULL;
-	SearchActionSearch *action = NULL;
+				if(!compileSearchCondition(compiler, action, condition,
+							validationType,
+							&action->groups[groupId].conditions[0], atrue)) {
+					return afalse;
+				}
 
-	if((compiler == NULL) ||
-			(compiler->type != SEARCH_COMPILER_ACTION_SEARCH)) {
-		DISPLAY_INVALID_ARGS;
-		return NULL;
-	}
+				groupId++;
+				continue;
+			}
 
-	action = (SearchActionSearch *)compiler->action;
+			if(((string = json_getString(condition, "intersect")) != NULL) &&
+					(!strcasecmp(string, "or"))) {
+				action->groups[groupId].isAndIntersection = afalse;
+			}
 
-	result = json_new();
+			if(!checkJsonParameter(compiler, condition, JSON_VALUE_TYPE_ARRAY,
+						"conditions", validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-	json_addString(result, "messageName", "searchResponse");
+			if((action->groups[groupId].conditionsLength = json_getArrayLength(
+							condition,
+							"conditions")) < 1) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"failed to obtain value 'conditions' array length");
+				return afalse;
+			}
 
-	if(compiler->errorCode != 0) {
-		string = itoa(compiler->errorCode);
+			action->groups[groupId].conditions =
+				(SearchActionSearchCondition *)arenaMalloc(
+						compiler->arena,
+						(sizeof(SearchActionSearchCondition) *
+						 action->groups[groupId].conditionsLength));
 
-		json_addString(result, "resultCode", string);
+			for(nn = 0; nn < action->groups[groupId].conditionsLength; nn++) {
+				if((groupCondition = json_getObjectFromArray(condition,
+								"conditions", nn)) == NULL) {
+					searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+							"failed to locate value in 'conditions' array");
+					return afalse;
+				}
 
-		free(string);
+				if(!compileSearchCondition(compiler, action, groupCondition,
+							validationType,
+							&action->groups[groupId].conditions[nn], afalse)) {
+					return afalse;
+				}
+			}
 
-		if(compiler->errorMessage != NULL) {
-			json_addString(result, "errorMessage", compiler->errorMessage);
-		}
-		else if(!compiler->isCompileComplete) {
-			json_addString(result, "errorMessage",
-					"compile failed to complete");
-		}
-		else if(!compiler->isExecutionComplete) {
-			json_addString(result, "errorMessage",
-					"execution failed to complete");
+			groupId++;
 		}
+		else {
+			if(!compileSearchCondition(compiler, action, condition,
+						validationType,
+						&action->groups[0].conditions[ii], atrue)) {
+				return afalse;
+			}
 
-		return result;
+			if(((string = json_getString(condition, "intersect")) != NULL) &&
+					(!strcasecmp(string, "or"))) {
+				action->groups[0].isAndIntersection = afalse;
+			}
+		}
 	}
 
-	json_addString(result, "resultCode", "0");
+	// determine if sorting options were specified
 
-	// build the index summary or facets
+	if((sortOptions = json_getObject(message, "sortOptions")) != NULL) {
+		action->sort.isSorted = atrue;
 
-	if((action->facets.hasResultFacets) &&
-			((action->facets.isDisplayIndexSummary) ||
-			 (action->facets.isDisplayFacets))) {
-		timer = time_getTimeMus();
+		if(((string = json_getString(sortOptions, "type")) != NULL) &&
+				(!strcasecmp(string, "multivalue"))) {
+			if(!checkJsonParameter(compiler, sortOptions, JSON_VALUE_TYPE_ARRAY,
+						"directives", validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-		if(action->facets.isDisplayIndexSummary) {
-			json_addArray(result, "indexSummary");
+			action->sort.directiveLength = json_getArrayLength(sortOptions,
+					"directives");
+
+			sortDirective = json_getObjectFromArray(sortOptions,
+					"directives", 0);
+		}
+		else {
+			action->sort.directiveLength = 1;
+			sortDirective = sortOptions;
 		}
 
-		counter = 0;
+		action->sort.directives =
+			(SearchActionSearchSortDirective *)arenaMalloc(compiler->arena,
+					(sizeof(SearchActionSearchSortDirective) *
+					 action->sort.directiveLength));
 
-		if(!action->settings.isGlobalSearch) {
-			for(ii = 0; ii < action->facets.attributesLength; ii++) {
-				for(nn = 0; nn < action->domainKeysLength; nn++) {
-					if(action->facets.isDisplayIndexSummary) {
-						buildIndexSummary(action->engine,
-								action->domainKeys[nn],
-								action->facets.attributes[ii],
-								result);
-						counter++;
-					}
+		ii = 0;
+
+		do {
+			if(sortDirective == NULL) {
+				break;
+			}
+
+			if(json_elementExists(sortDirective, "direction")) {
+				if(!checkJsonParameter(compiler, sortDirective,
+							JSON_VALUE_TYPE_STRING, "direction",
+							validationType, TEMPLATE)) {
+					return afalse;
 				}
+			}
 
-				if(action->facets.isDisplayFacets) {
-					buildSearchResultFacets(action,
-							action->facets.attributes[ii], result);
+			if(((string = json_getString(sortDirective,
+								"direction")) != NULL) &&
+					(!strcasecmp(string, "asc"))) {
+				action->sort.directives[ii].isStandardSortOrder = afalse;
+			}
+			else {
+				action->sort.directives[ii].isStandardSortOrder = atrue;
+			}
+	
+			action->sort.directives[ii].type =
+				SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN;
+
+			if(json_elementExists(sortDirective, "type")) {
+				if(!checkJsonParameter(compiler, sortDirective,
+							JSON_VALUE_TYPE_STRING, "type",
+							validationType, TEMPLATE)) {
+					return afalse;
 				}
 			}
-		}
-		else if((domainList = searchEngine_listDomains(action->engine,
-						&domainListLength, &rc)) != NULL) {
-			for(ii = 0; ii < action->facets.attributesLength; ii++) {
-				for(nn = 0; nn < domainListLength; nn++) {
-					if(domainList[nn] == NULL) {
-						continue;
+	
+			if((string = json_getString(sortDirective, "type")) != NULL) {
+				if(!strcasecmp(string, "attribute")) {
+					if(!checkJsonParameter(compiler, sortDirective,
+								JSON_VALUE_TYPE_STRING, "attribute",
+								validationType, TEMPLATE)) {
+						return afalse;
 					}
 
-					if(action->facets.isDisplayIndexSummary) {
-						buildIndexSummary(action->engine,
-								domainList[nn],
-								action->facets.attributes[ii],
-								result);
-						counter++;
+					if((string = json_getString(sortDirective,
+									"attribute")) != NULL) {
+						action->sort.directives[ii].type =
+							SEARCH_COMPILER_SEARCH_SORT_TYPE_ATTRIBUTE;
+						action->sort.directives[ii].attribute = arenaStrdup(
+								compiler->arena, string);
+					}
+					else {
+						action->sort.directives[ii].type =
+							SEARCH_COMPILER_SEARCH_SORT_TYPE_ERROR;
 					}
 				}
+				else if(!strcasecmp(string, "geocoord")) {
+					if(!checkJsonParameter(compiler, sortDirective,
+								JSON_VALUE_TYPE_NUMBER, "latitude",
+								validationType, TEMPLATE)) {
+						return afalse;
+					}
 
-				if(action->facets.isDisplayFacets) {
-					buildSearchResultFacets(action,
-							action->facets.attributes[ii], result);
+					if(!checkJsonParameter(compiler, sortDirective,
+								JSON_VALUE_TYPE_NUMBER, "longitude",
+								validationType, TEMPLATE)) {
+						return afalse;
+					}
+
+					if((json_elementExists(sortDirective, "latitude")) &&
+							(json_elementExists(sortDirective, "longitude"))) {
+						action->sort.directives[ii].type =
+							SEARCH_COMPILER_SEARCH_SORT_TYPE_GEO_COORD;
+						action->sort.directives[ii].latitude =
+							json_getNumber(sortDirective,
+								"latitude");
+						action->sort.directives[ii].longitude =
+							json_getNumber(sortDirective,
+								"longitude");
+					}
+					else {
+						action->sort.directives[ii].type =
+							SEARCH_COMPILER_SEARCH_SORT_TYPE_ERROR;
+					}
+				}
+				else if(!strcasecmp(string, "relevancy")) {
+					action->sort.directives[ii].type =
+						SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY;
 				}
 			}
 
-			for(ii = 0; ii < domainListLength; ii++) {
-				if(domainList[ii] != NULL) {
-					free(domainList[ii]);
+			if((action->sort.directives[ii].type ==
+					 SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY) ||
+					(action->sort.directives[ii].type ==
+					 SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN)) {
+				action->sort.directives[ii].type =
+					SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN;
+
+				for(nn = 0; nn < action->groupsLength; nn++) {
+					for(jj = 0;
+							jj < action->groups[nn].conditionsLength;
+							jj++) {
+						if((action->groups[nn].conditions[jj].type ==
+							 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
+							(action->groups[nn].conditions[jj].type ==
+							 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
+							(action->groups[nn].conditions[jj].type ==
+							 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD)) {
+							action->sort.directives[ii].type =
+								SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY;
+							break;
+						}
+					}
+				}
+			}
+	
+			if(action->sort.directives[ii].type ==
+					SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN) {
+				action->sort.isSorted = afalse;
+				break;
+			}
+
+			ii++;
+			if(ii >= action->sort.directiveLength) {
+				break;
+			}
+
+			sortDirective = json_getObjectFromArray(sortOptions,
+					"directives", ii);
+		} while(sortDirective != NULL);
+	}
+	else {
+		for(ii = 0; ii < action->groupsLength; ii++) {
+			for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
+				if((action->groups[ii].conditions[nn].type ==
+						 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
+						(action->groups[ii].conditions[nn].type ==
+						 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD) ||
+						(action->groups[ii].conditions[nn].type ==
+						 SEARCH_COMPILER_SEARCH_CONDITION_TYPE_WILDCARD)) {
+					action->sort.isSorted = atrue;
+					action->sort.directiveLength = 1;
+					action->sort.directives =
+						(SearchActionSearchSortDirective *)arenaMalloc(
+								compiler->arena,
+								sizeof(SearchActionSearchSortDirective) *
+								action->sort.directiveLength);
+					action->sort.directives[0].type =
+						SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY;
+					break;
 				}
 			}
-
-			free(domainList);
 		}
-
-		elapsedTime = time_getElapsedMusInSeconds(timer);
-
-		log_logf(compiler->log, LOG_LEVEL_DEBUG,
-				"{SEARCH} constructed %i index summary items in "
-				"%0.6f (%0.6f avg) seconds",
-				counter, elapsedTime, (elapsedTime / (double)counter));
 	}
 
-	// build a set of response objects resulting from the search
-
-	timer = time_getTimeMus();
+	// determine if result options were specified
 
-	offset = 0;
-	limit = action->intersect.result.length;
+	if((resultOptions = json_getObject(message, "resultOptions")) != NULL) {
+		if(json_elementExists(resultOptions, "offset")) {
+			if(!checkJsonParameter(compiler, resultOptions,
+						JSON_VALUE_TYPE_NUMBER, "offset",
+						validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-	if(action->options.hasResultOptions) {
-		if(action->options.offset > 0) {
-			offset = action->options.offset;
+			if((action->options.offset = (int)json_getNumber(resultOptions,
+							"offset")) < 0) {
+				action->options.offset = 0;
+			}
 		}
 
-		if(action->options.limit > 0) {
-			limit = action->options.limit;
-		}
-	}
+		if(json_elementExists(resultOptions, "limit")) {
+			if(!checkJsonParameter(compiler, resultOptions,
+						JSON_VALUE_TYPE_NUMBER, "limit",
+						validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-	for(ii = offset, counter = 0;
-			((ii < action->intersect.result.length) && (counter < limit));
-			ii++) {
-		if(action->intersect.result.array[ii] == 0) {
-			continue;
+			if((action->options.limit = (int)json_getNumber(resultOptions,
+							"limit")) < 0) {
+				action->options.limit = 0;
+			}
 		}
 
-		if((container = searchEngine_get(action->engine,
-						action->intersect.result.array[ii],
-						&rc)) == NULL) {
-			log_logf(compiler->log, LOG_LEVEL_WARNING,
-					"{SEARCH} failed to locate container #%i from search "
-					"intersection %i with '%s'",
-					action->intersect.result.array[ii], ii,
-					searchEngine_errorCodeToString(rc));
+		if(json_elementExists(resultOptions, "includeDistances")) {
+			if(!checkJsonParameter(compiler, resultOptions,
+						JSON_VALUE_TYPE_BOOLEAN, "includeDistances",
+						validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-			continue;
-		}
-		else if(action->settings.isEntireContainer) {
-			entry = container_containerToJson(container);
+			isIncludeDistances = json_getBoolean(resultOptions,
+					"includeDistances");
 
-			searchEngine_unlockGet(action->engine, container);
+			if(isIncludeDistances) {
+				if(!checkJsonParameter(compiler, resultOptions,
+							JSON_VALUE_TYPE_NUMBER, "latitude",
+							validationType, TEMPLATE)) {
+					return afalse;
+				}
 
-			if(action->options.isIncludeDistances) {
-				searchSort_determineGeoCoordsOnEntity(action->engine,
-						action->options.latitude,
-						action->options.longitude,
-						ii,
-						action->intersect.result.array,
-						action->intersect.result.length,
-						&latitude,
-						&longitude,
-						&distance);
+				if(!checkJsonParameter(compiler, resultOptions,
+							JSON_VALUE_TYPE_NUMBER, "longitude",
+							validationType, TEMPLATE)) {
+					return afalse;
+				}
 			}
 		}
-		else {
-			isAddLatitude = afalse;
-			isAddLongitude = afalse;
 
-			entry = json_new();
+		if(isIncludeDistances) {
+			action->options.isIncludeDistances = isIncludeDistances;
 
-			json_addNumber(entry, "uid", (double)container->uid);
+			action->options.latitude = json_getNumber(resultOptions,
+					"latitude");
 
-			for(nn = 0; nn < action->requestAttributesLength; nn++) {
-				if(!strcmp(action->requestAttributes[nn], "latitude")) {
-					isAddLatitude = atrue;
-					continue;
-				}
-				else if(!strcmp(action->requestAttributes[nn], "longitude")) {
-					isAddLongitude = atrue;
-					continue;
-				}
-				else if((string = container_getString(container,
-								action->requestAttributes[nn],
-								strlen(action->requestAttributes[nn]),
-								&stringLength)) == NULL) {
-					continue;
-				}
+			action->options.longitude = json_getNumber(resultOptions,
+					"longitude");
+		}
 
-				json_addString(entry, action->requestAttributes[nn], string);
+		action->options.hasResultOptions = atrue;
+	}
 
-				free(string);
-			}
+	// determine if facet options were specified
 
-			searchEngine_unlockGet(action->engine, container);
+	if((facetOptions = json_getObject(message, "facetOptions")) != NULL) {
+		if(json_elementExists(facetOptions, "displayIndexSummary")) {
+			if(!checkJsonParameter(compiler, facetOptions,
+						JSON_VALUE_TYPE_BOOLEAN, "displayIndexSummary",
+						validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-			if((isAddLatitude) ||
-					(isAddLongitude) ||
-					(action->options.isIncludeDistances)) {
-				searchSort_determineGeoCoordsOnEntity(action->engine,
-						action->options.latitude,
-						action->options.longitude,
-						ii,
-						action->intersect.result.array,
-						action->intersect.result.length,
-						&latitude,
-						&longitude,
-						&distance);
+			action->facets.isDisplayIndexSummary = json_getBoolean(
+					facetOptions, "displayIndexSummary");
+		}
 
-				if(isAddLatitude) {
-					string = (char *)malloc(sizeof(char) * 128);
-					snprintf(string, ((int)(sizeof(char) * 128) - 1), "%0.6f",
-							latitude);
+		if(json_elementExists(facetOptions, "displayFacets")) {
+			if(!checkJsonParameter(compiler, facetOptions,
+						JSON_VALUE_TYPE_BOOLEAN, "displayFacets",
+						validationType, TEMPLATE)) {
+				return afalse;
+			}
 
-					json_addString(entry, "latitude", string);
+			action->facets.isDisplayFacets =
+				json_getBoolean(facetOptions, "displayFacets");
+		}
 
-					free(string);
-				}
+		// allocate & initialize facet attributes
 
-				if(isAddLongitude) {
-					string = (char *)malloc(sizeof(char) * 128);
-					snprintf(string, ((int)(sizeof(char) * 128) - 1), "%0.6f",
-							longitude);
+		if((action->facets.isDisplayIndexSummary) ||
+				(action->facets.isDisplayFacets)) {
+			if(!checkJsonParameter(compiler, facetOptions,
+						JSON_VALUE_TYPE_ARRAY, "attributes",
+						validationType, TEMPLATE)) {
+				return afalse;
+			}
+			else if((action->facets.attributesLength = json_getArrayLength(
+							facetOptions, "attributes")) < 1) {
+				searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+						"failed to obtain value 'facetOptions->attributes' "
+						"array length");
+				return afalse;
+			}
 
-					json_addString(entry, "longitude", string);
+			action->facets.attributes = (char **)arenaMalloc(compiler->arena,
+					(sizeof(char *) * action->facets.attributesLength));
 
-					free(string);
+			for(ii = 0; ii < action->facets.attributesLength; ii++) {
+				if((string = json_getStringFromArray(facetOptions,
+								"attributes", ii)) == NULL) {
+					searchCompiler_buildErrorMessage(compiler, TEMPLATE, -1,
+							"failed to locate value in "
+							"'facetOptions->attributes' array");
+					return afalse;
 				}
+
+				action->facets.attributes[ii] = arenaStrdup(compiler->arena,
+						string);
 			}
 		}
 
-		if(entry == NULL) {
-			continue;
-		}
+		action->facets.hasResultFacets = atrue;
+	}
 
-		if(action->options.isIncludeDistances) {
-			distance = searchSort_calculateGeoCoordDistanceMiles(
-					action->options.latitude, action->options.longitude,
-					latitude, longitude);
+	// finish initialization
 
-			json_addNumber(entry, "distanceInMiles", distance);
-		}
+	intersect_initWithArena(&action->intersect, compiler->arena);
 
-		if(counter == 0) {
-			json_addArray(result, "resultSet");
-		}
+	compiler->type = SEARCH_COMPILER_ACTION_SEARCH;
+
+	return atrue;
+}
 
-		json_addObjectToArray(result, "resultSet", entry);
+Json *searchJson_buildSearchResult(SearchCompiler *compiler)
+{
+	int counter = 0;
 
-		counter++;
+	Json *result = NULL;
+	SearchActionSearch *action = NULL;
+
+	if((compiler == NULL) ||
+			(compiler->type != SEARCH_COMPILER_ACTION_SEARCH)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
 	}
 
-	if(counter > 0) {
-		elapsedTime = time_getElapsedMusInSeconds(timer);
+	action = (SearchActionSearch *)compiler->action;
 
-		log_logf(compiler->log, LOG_LEVEL_DEBUG,
-				"{SEARCH} constructed %i search-result containers in "
-				"%0.6f (%0.6f avg) seconds",
-				counter, elapsedTime, (elapsedTime / (double)counter));
+	result = buildSearchResultHeader(compiler);
+
+	if(compiler->errorCode != 0) {
+		return result;
 	}
 
+	counter = buildSearchResultSet(compiler, result, NULL);
+
 	json_addNumber(result, "resultSetLength", counter);
 
 	json_addNumber(result, "resultSetTotalLength",
@@ -2486,6 +2616,43 @@ Json *searchJson_buildSearchResult(SearchCompiler *compiler)
 	return result;
 }
 
+int searchJson_writeSearchResult(SearchCompiler *compiler, JsonWriter *writer)
+{
+	int counter = 0;
+
+	Json *header = NULL;
+	SearchActionSearch *action = NULL;
+
+	if((compiler == NULL) ||
+			(compiler->type != SEARCH_COMPILER_ACTION_SEARCH) ||
+			(writer == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	action = (SearchActionSearch *)compiler->action;
+
+	header = buildSearchResultHeader(compiler);
+
+	jsonWriter_writeJsonMembers(writer, header);
+
+	json_freePtr(header);
+
+	if(compiler->errorCode != 0) {
+		return 0;
+	}
+
+	counter = buildSearchResultSet(compiler, NULL, writer);
+
+	jsonWriter_writeName(writer, "resultSetLength");
+	jsonWriter_writeNumber(writer, (double)counter);
+
+	jsonWriter_writeName(writer, "resultSetTotalLength");
+	jsonWriter_writeNumber(writer, (double)action->intersect.result.length);
+
+	return 0;
+}
+
 aboolean searchJson_compileList(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message)
 {
@@ -2591,7 +2758,7 @@ Json *searchJson_buildListResult(SearchCompiler *compiler)
 
 	action = (SearchActionList *)compiler->action;
 
-	result = json_new();
+	result = json_newWithArena(compiler->arena);
 
 	json_addString(result, "messageName", "listResponse");
 
@@ -2638,7 +2805,7 @@ Json *searchJson_buildListResult(SearchCompiler *compiler)
 	if((action->isListIndexDetails) &&
 			(action->indexCount > 0) &&
 			(action->indexUniqueValueCount > 0)) {
-		entry = json_new();
+		entry = json_newWithArena(compiler->arena);
 
 		json_addString(entry, "indexKey", action->indexKey);
 		json_addString(entry, "indexType", action->indexType);
@@ -2784,6 +2951,9 @@ aboolean searchJson_compileCommand(SearchCompiler *compiler,
 						else if(!strcasecmp(string, "user")) {
 							indexType = INDEX_REGISTRY_TYPE_USER_KEY;
 						}
+						else if(!strcasecmp(string, "geo")) {
+							indexType = INDEX_REGISTRY_TYPE_GEO;
+						}
 						else {
 							indexType = (int)json_getNumber(message,
 									"indexType");
@@ -2795,7 +2965,9 @@ aboolean searchJson_compileCommand(SearchCompiler *compiler,
 									(indexType !=
 									 INDEX_REGISTRY_TYPE_RANGE) &&
 									(indexType !=
-									 INDEX_REGISTRY_TYPE_USER_KEY)) {
+									 INDEX_REGISTRY_TYPE_USER_KEY) &&
+									(indexType !=
+									 INDEX_REGISTRY_TYPE_GEO)) {
 								searchCompiler_buildErrorMessage(compiler,
 										TEMPLATE, -1,
 										"unrecognized 'indexType' parameter");
@@ -2831,6 +3003,18 @@ aboolean searchJson_compileCommand(SearchCompiler *compiler,
 						command->isOverrideIndexing = atrue;
 					}
 
+					if(json_elementExists(message, "isDocValues")) {
+						if(!checkJsonParameter(compiler, message,
+									JSON_VALUE_TYPE_BOOLEAN,
+									"isDocValues",
+									validationType, TEMPLATE)) {
+							return afalse;
+						}
+						command->isDocValues = json_getBoolean(message,
+								"isDocValues");
+						command->isOverrideDocValues = atrue;
+					}
+
 					if(json_elementExists(message, "minStringLength")) {
 						if(!checkJsonParameter(compiler, message,
 									JSON_VALUE_TYPE_NUMBER,
@@ -3221,7 +3405,7 @@ Json *searchJson_buildCommandResult(SearchCompiler *compiler)
 
 	action = (SearchActionCommand *)compiler->action;
 
-	result = json_new();
+	result = json_newWithArena(compiler->arena);
 
 	json_addString(result, "messageName", "commandResponse");
 	json_addString(result, "type", searchCompiler_commandTypeToString(
@@ -3321,7 +3505,7 @@ Json *searchJson_buildLoginResult(SearchCompiler *compiler)
 
 	action = (SearchActionLogin *)compiler->action;
 
-	result = json_new();
+	result = json_newWithArena(compiler->arena);
 
 	json_addString(result, "messageName", "loginResponse");
 
@@ -3409,7 +3593,7 @@ Json *searchJson_buildLogoutResult(SearchCompiler *compiler)
 
 	action = (SearchActionLogout *)compiler->action;
 
-	result = json_new();
+	result = json_newWithArena(compiler->arena);
 
 	json_addString(result, "messageName", "logoutResponse");
 
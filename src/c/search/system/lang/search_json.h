@@ -79,6 +79,8 @@ aboolean searchJson_compileSearch(SearchCompiler *compiler,
 
 Json *searchJson_buildSearchResult(SearchCompiler *compiler);
 
+int searchJson_writeSearchResult(SearchCompiler *compiler, JsonWriter *writer);
+
 aboolean searchJson_compileList(SearchCompiler *compiler,
 		SearchJsonValidationType validationType, Json *message);
 
@@ -27,6 +27,38 @@ typedef struct _PruneByDistance {
 	double distance;
 } PruneByDistance;
 
+typedef struct _SearchConditionTask {
+	SearchCompiler *compiler;
+	SearchEngine *engine;
+	SearchActionSearch *action;
+	SearchActionSearchCondition *condition;
+	Intersect intersect;
+} SearchConditionTask;
+
+typedef struct _SearchGroupTask {
+	int groupId;
+	SearchCompiler *compiler;
+	SearchActionSearchConditionGroup *group;
+	SearchConditionTask *conditions;
+} SearchGroupTask;
+
+/*
+ * A search of one shard of a sharded engine; the shard's group results are
+ * kept until every shard has searched them, since a group which matched on no
+ * shard is left out of the final intersection, as it is when unsharded.
+ */
+
+typedef struct _SearchShardTask {
+	int result;
+	int candidateLength;
+	aboolean *isGroupEmpty;
+	SearchCompiler *compiler;
+	SearchEngine *engine;
+	SearchActionSearch *action;
+	Intersect *groups;
+	Intersect intersect;
+} SearchShardTask;
+
 
 // define search compiler private functions
 
@@ -1121,6 +1153,153 @@ static void search_executeSearchRelevancySort(SearchActionSearch *action,
 	}
 }
 
+static int search_executeSort(SearchCompiler *compiler, SearchEngine *engine,
+		SearchActionSearch *action, Intersect *intersect)
+{
+	int ii = 0;
+	int result = 0;
+	int sortLimit = 0;
+	alint sortMemoryLength = 0;
+	double timer = 0.0;
+
+	SearchSort sort;
+
+	if((action->sort.isSorted) &&
+			(intersect->result.length > 1) &&
+			(action->sort.directiveLength > 0) &&
+			(action->sort.directives != NULL)) {
+		timer = time_getTimeMus();
+
+		if(engine->settings.maxSortOperationMemoryLength > 0) {
+			sortMemoryLength = searchSort_calculateMvInitMemoryLength(
+					intersect);
+		}
+
+		searchSort_mvInit(&sort, engine, intersect);
+
+		// only the requested page, and the results before it, need ordering
+
+		if((action->options.hasResultOptions) &&
+				(action->options.limit > 0) &&
+				(action->options.offset <
+				 (intersect->result.length -
+				  action->options.limit))) {
+			sortLimit = (action->options.offset + action->options.limit);
+
+			searchSort_mvSetLimit(&sort, sortLimit);
+		}
+
+		for(ii = 0; ii < action->sort.directiveLength; ii++) {
+			switch(action->sort.directives[ii].type) {
+				case SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY:
+					if(engine->settings.maxSortOperationMemoryLength > 0) {
+						sortMemoryLength +=
+						searchSort_calculateMvAddSortByRelevancyMemoryLength(
+								&sort);
+					}
+
+					if((engine->settings.maxSortOperationMemoryLength == 0) ||
+							((engine->settings.maxSortOperationMemoryLength >
+							  0) &&
+							 (sortMemoryLength <=
+							  engine->settings.maxSortOperationMemoryLength))) {
+						search_executeSearchRelevancySort(action, &sort);
+					}
+					else {
+						log_logf(compiler->log, LOG_LEVEL_WARNING,
+								"{SEARCHD} aborted sort operation due to "
+								"required memory higher than current limits "
+								"(%lli vs %lli)",
+								sortMemoryLength,
+							  	engine->settings.maxSortOperationMemoryLength);
+
+						result = SEARCH_COMPILER_ERROR_EXEC_SORT_OUT_OF_MEMORY;
+					}
+					break;
+
+				case SEARCH_COMPILER_SEARCH_SORT_TYPE_ATTRIBUTE:
+					if(engine->settings.maxSortOperationMemoryLength > 0) {
+						sortMemoryLength +=
+					searchSort_calculateMvAddSortByAttributeNameMemoryLength(
+							&sort, action->sort.directives[ii].attribute,
+							engine->settings.maxSortOperationMemoryLength);
+					}
+
+					if((engine->settings.maxSortOperationMemoryLength == 0) ||
+							((engine->settings.maxSortOperationMemoryLength >
+							  0) &&
+							 (sortMemoryLength <=
+							  engine->settings.maxSortOperationMemoryLength))) {
+						searchSort_mvAddSortByAttributeName(&sort,
+							action->sort.directives[ii].attribute,
+							action->sort.directives[ii].isStandardSortOrder);
+					}
+					else {
+						log_logf(compiler->log, LOG_LEVEL_WARNING,
+								"{SEARCHD} aborted sort operation due to "
+								"required memory higher than current limits "
+								"(%lli vs %lli)",
+								sortMemoryLength,
+							  	engine->settings.maxSortOperationMemoryLength);
+
+						result = SEARCH_COMPILER_ERROR_EXEC_SORT_OUT_OF_MEMORY;
+					}
+					break;
+
+				case SEARCH_COMPILER_SEARCH_SORT_TYPE_GEO_COORD:
+					if(engine->settings.maxSortOperationMemoryLength > 0) {
+						sortMemoryLength +=
+							searchSort_calculateMvAddSortByDistanceMemoryLength(
+									&sort);
+					}
+
+					if((engine->settings.maxSortOperationMemoryLength == 0) ||
+							((engine->settings.maxSortOperationMemoryLength >
+							  0) &&
+							 (sortMemoryLength <=
+							  engine->settings.maxSortOperationMemoryLength))) {
+						searchSort_mvAddSortByDistance(engine,
+							&sort,
+							action->sort.directives[ii].latitude,
+							action->sort.directives[ii].longitude,
+							action->sort.directives[ii].isStandardSortOrder);
+					}
+					else {
+						log_logf(compiler->log, LOG_LEVEL_WARNING,
+								"{SEARCHD} aborted sort operation due to "
+								"required memory higher than current limits "
+								"(%lli vs %lli)",
+								sortMemoryLength,
+							  	engine->settings.maxSortOperationMemoryLength);
+
+						result = SEARCH_COMPILER_ERROR_EXEC_SORT_OUT_OF_MEMORY;
+					}
+					break;
+
+				case SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN:
+				case SEARCH_COMPILER_SEARCH_SORT_TYPE_ERROR:
+				default:
+					log_logf(compiler->log, LOG_LEVEL_WARNING,
+							"unknown sort type %i, aborting sort",
+							action->sort.directives[ii].type);
+			}
+		}
+
+		searchSort_mvExecute(&sort);
+		searchSort_mvFree(&sort);
+
+		log_logf(compiler->log, LOG_LEVEL_DEBUG,
+				"{SEARCH} performed %ix sort on %i results (limit %i) in "
+				"%0.6f seconds",
+				action->sort.directiveLength,
+				intersect->result.length,
+				sortLimit,
+				time_getElapsedMusInSeconds(timer));
+	}
+
+	return result;
+}
+
 // action functions
 
 // new domain
@@ -1583,283 +1762,581 @@ static void action_freeDeleteByAttribute(SearchCompiler *compiler)
 
 // search
 
-static int action_executeSearch(SearchCompiler *compiler,
-		SearchEngine *engine)
+static void search_intersectGroup(SearchCompiler *compiler, int groupId,
+		aboolean isAndIntersection, Intersect *intersect)
 {
-	int ii = 0;
-	int nn = 0;
-	int result = 0;
-	alint sortMemoryLength = 0;
 	double timer = 0.0;
-	char *domainKey = NULL;
-
-	SearchSort sort;
-	SearchActionSearch *action = NULL;
-
-	if(compiler->action == NULL) {
-		return -1;
-	}
-
-	action = (SearchActionSearch *)compiler->action;
 
-	action->engine = engine;
+	timer = time_getTimeMus();
 
-	if(authSystem_isEnabled(&engine->auth)) {
-		for(ii = 0; ii < action->domainKeysLength; ii++) {
-			if(!strcmp(action->domainKeys[ii], "*")) {
-				domainKey = NULL;
-			}
-			else {
-				domainKey = action->domainKeys[ii];
-			}
+	if(isAndIntersection) {
+		intersect_execAnd(intersect, atrue);
 
-			if(!authSystem_isPermitted(&engine->auth,
-						compiler->token,
-						domainKey,
-						compiler->ipAddress,
-						AUTHENTICATION_PERMISSIONS_SEARCH)) {
-				return SEARCH_COMPILER_ERROR_EXEC_PERMISSION_DENIED;
-			}
-		}
+		log_logf(compiler->log, LOG_LEVEL_DEBUG,
+				"{SEARCH} obtained %i results from AND intersection "
+				"on group %i in %0.6f seconds",
+				intersect->result.length, groupId,
+				time_getElapsedMusInSeconds(timer));
 	}
+	else {
+		intersect_execOr(intersect);
 
-	// perform search
+		log_logf(compiler->log, LOG_LEVEL_DEBUG,
+				"{SEARCH} obtained %i results from OR intersection "
+				"on group %i in %0.6f seconds",
+				intersect->result.length, groupId,
+				time_getElapsedMusInSeconds(timer));
+	}
 
-	for(ii = 0; ii < action->groupsLength; ii++) {
-		if(action->groups[ii].conditionsLength < 1) {
-			intersect_init(&action->groups[ii].intersect);
-			continue;
-		}
+/*
+	intersect_display(stdout, intersect);
+ */
+}
 
-		timer = time_getTimeMus();
+static void search_executeConditionTask(void *argument)
+{
+	SearchConditionTask *task = NULL;
 
-		intersect_init(&action->groups[ii].intersect);
+	task = (SearchConditionTask *)argument;
 
-		for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
-			search_executeSearchCondition(compiler,
-					engine,
-					action,
-					&action->groups[ii].conditions[nn],
-					&action->groups[ii].intersect);
-		}
+	search_executeSearchCondition(task->compiler,
+			task->engine,
+			task->action,
+			task->condition,
+			&task->intersect);
+}
 
-		log_logf(compiler->log, LOG_LEVEL_DEBUG,
-				"{SEARCH} performed group %i search in %0.6f seconds",
-				ii, time_getElapsedMusInSeconds(timer));
+static void search_executeGroupTask(void *argument)
+{
+	int ii = 0;
 
-		timer = time_getTimeMus();
+	SearchGroupTask *task = NULL;
 
-		if(action->groups[ii].isAndIntersection) {
-			intersect_execAnd(&action->groups[ii].intersect, atrue);
+	task = (SearchGroupTask *)argument;
 
-			log_logf(compiler->log, LOG_LEVEL_DEBUG,
-					"{SEARCH} obtained %i results from AND intersection "
-					"on group %i in %0.6f seconds",
-					action->groups[ii].intersect.result.length, ii,
-					time_getElapsedMusInSeconds(timer));
-		}
-		else {
-			intersect_execOr(&action->groups[ii].intersect);
+	/*
+	 * note: the compiler's memory arena is not thread-safe, so groups merged
+	 * on the executor use heap-allocated intersects
+	 */
 
-			log_logf(compiler->log, LOG_LEVEL_DEBUG,
-					"{SEARCH} obtained %i results from OR intersection "
-					"on group %i in %0.6f seconds",
-					action->groups[ii].intersect.result.length, ii,
-					time_getElapsedMusInSeconds(timer));
-		}
+	intersect_init(&task->group->intersect);
 
-/*
-		intersect_display(stdout, &action->groups[ii].intersect);
- */
+	for(ii = 0; ii < task->group->conditionsLength; ii++) {
+		intersect_moveBuffers(&task->group->intersect,
+				&task->conditions[ii].intersect);
+		intersect_free(&task->conditions[ii].intersect);
 	}
 
-	// perform intersection
+	search_intersectGroup(task->compiler, task->groupId,
+			task->group->isAndIntersection, &task->group->intersect);
+}
+
+static void search_executeSearchInParallel(SearchCompiler *compiler,
+		SearchEngine *engine, SearchActionSearch *action,
+		int conditionsLength)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int groupsLength = 0;
+	double timer = 0.0;
+	void **arguments = NULL;
+
+	SearchConditionTask *conditions = NULL;
+	SearchGroupTask *groups = NULL;
 
 	timer = time_getTimeMus();
 
-	intersect_init(&action->intersect);
+	conditions = (SearchConditionTask *)malloc(sizeof(SearchConditionTask) *
+			conditionsLength);
+	groups = (SearchGroupTask *)malloc(sizeof(SearchGroupTask) *
+			action->groupsLength);
+	arguments = (void **)malloc(sizeof(void *) * conditionsLength);
 
-	for(ii = 0; ii < action->groupsLength; ii++) {
+	// fan every condition of every group out to the executor
+
+	for(ii = 0, ref = 0; ii < action->groupsLength; ii++) {
 		if(action->groups[ii].conditionsLength < 1) {
+			intersect_initWithArena(&action->groups[ii].intersect,
+					compiler->arena);
 			continue;
 		}
 
-		intersect_putArray(&action->intersect,
-				action->groups[ii].intersect.result.isSorted,
-				action->groups[ii].intersect.result.array,
-				action->groups[ii].intersect.result.length);
-	}
+		groups[groupsLength].groupId = ii;
+		groups[groupsLength].compiler = compiler;
+		groups[groupsLength].group = &action->groups[ii];
+		groups[groupsLength].conditions = &conditions[ref];
+		groupsLength++;
 
-	if(action->settings.isAndIntersection) {
-		intersect_execAnd(&action->intersect, atrue);
+		for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
+			conditions[ref].compiler = compiler;
+			conditions[ref].engine = engine;
+			conditions[ref].action = action;
+			conditions[ref].condition = &action->groups[ii].conditions[nn];
 
-		log_logf(compiler->log, LOG_LEVEL_DEBUG,
-				"{SEARCH} obtained %i results from AND intersection "
-				"in %0.6f seconds",
-				action->intersect.result.length,
-				time_getElapsedMusInSeconds(timer));
-	}
-	else {
-		intersect_execOr(&action->intersect);
+			intersect_init(&conditions[ref].intersect);
 
-		log_logf(compiler->log, LOG_LEVEL_DEBUG,
-				"{SEARCH} obtained %i results from OR intersection "
-				"in %0.6f seconds",
-				action->intersect.result.length,
-				time_getElapsedMusInSeconds(timer));
+			arguments[ref] = (void *)&conditions[ref];
+			ref++;
+		}
 	}
 
-/*
-	intersect_display(stdout, &action->intersect);
-*/
+	searchExecutor_execute(&engine->executor, search_executeConditionTask,
+			arguments, conditionsLength);
 
-	// determine if any geocoord search pruning is required
+	log_logf(compiler->log, LOG_LEVEL_DEBUG,
+			"{SEARCH} performed %i condition searches across %i group(s) "
+			"in parallel in %0.6f seconds",
+			conditionsLength, groupsLength,
+			time_getElapsedMusInSeconds(timer));
 
-	timer = time_getTimeMus();
+	// merge and intersect each group on the executor
 
-	for(ii = 0; ii < action->groupsLength; ii++) {
-		for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
-			if(action->groups[ii].conditions[nn].type ==
-					SEARCH_COMPILER_SEARCH_CONDITION_TYPE_GEO_COORD) {
-				search_pruneByDistance(compiler,
-						engine,
-						action->groups[ii].conditions[ii].latitude,
-						action->groups[ii].conditions[ii].longitude,
-						action->groups[ii].conditions[ii].distance,
-						&action->intersect);
-			}
-		}
+	for(ii = 0; ii < groupsLength; ii++) {
+		arguments[ii] = (void *)&groups[ii];
 	}
 
-	log_logf(compiler->log, LOG_LEVEL_DEBUG,
-			"{SEARCH} distance-prune check completed in %0.6f seconds",
-			time_getElapsedMusInSeconds(timer));
+	searchExecutor_execute(&engine->executor, search_executeGroupTask,
+			arguments, groupsLength);
 
-	// perform sorting
+	free(arguments);
+	free(groups);
+	free(conditions);
+}
+
+static void search_executeShardGroupsTask(void *argument)
+{
+	int ii = 0;
+	int nn = 0;
+
+	SearchShardTask *task = NULL;
+	SearchActionSearch *action = NULL;
+
+	task = (SearchShardTask *)argument;
+	action = task->action;
+
+	/*
+	 * note: the compiler's memory arena is not thread-safe, so shards search
+	 * into heap-allocated intersects
+	 */
+
+	task->groups = (Intersect *)malloc(sizeof(Intersect) *
+			(action->groupsLength + 1));
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		intersect_init(&task->groups[ii]);
+
+		if(action->groups[ii].conditionsLength < 1) {
+			continue;
+		}
+
+		for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
+			search_executeSearchCondition(task->compiler,
+					task->engine,
+					action,
+					&action->groups[ii].conditions[nn],
+					&task->groups[ii]);
+		}
+
+		search_intersectGroup(task->compiler, ii,
+				action->groups[ii].isAndIntersection,
+				&task->groups[ii]);
+	}
+}
+
+static void search_executeShardTask(void *argument)
+{
+	aboolean isEmpty = afalse;
+	int ii = 0;
+	int nn = 0;
+
+	SearchShardTask *task = NULL;
+	SearchActionSearch *action = NULL;
+
+	task = (SearchShardTask *)argument;
+	action = task->action;
+
+	intersect_init(&task->intersect);
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		if((action->groups[ii].conditionsLength < 1) ||
+				(task->isGroupEmpty[ii])) {
+			continue;
+		}
+
+		// a group which matched only on the other shards empties an AND
+
+		if(task->groups[ii].result.length < 1) {
+			if(action->settings.isAndIntersection) {
+				isEmpty = atrue;
+			}
+			continue;
+		}
+
+		intersect_putArray(&task->intersect,
+				task->groups[ii].result.isSorted,
+				task->groups[ii].result.array,
+				task->groups[ii].result.length);
+	}
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		intersect_free(&task->groups[ii]);
+	}
+
+	free(task->groups);
+
+	task->groups = NULL;
+
+	if(isEmpty) {
+		intersect_free(&task->intersect);
+		intersect_init(&task->intersect);
+		return;
+	}
+
+	if(action->settings.isAndIntersection) {
+		intersect_execAnd(&task->intersect, atrue);
+	}
+	else {
+		intersect_execOr(&task->intersect);
+	}
+
+	// determine if any geocoord search pruning is required
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
+			if(action->groups[ii].conditions[nn].type ==
+					SEARCH_COMPILER_SEARCH_CONDITION_TYPE_GEO_COORD) {
+				search_pruneByDistance(task->compiler,
+						task->engine,
+						action->groups[ii].conditions[nn].latitude,
+						action->groups[ii].conditions[nn].longitude,
+						action->groups[ii].conditions[nn].distance,
+						&task->intersect);
+			}
+		}
+	}
+
+	// when only a page of results is requested, the page can only come from
+	// the first offset + limit results of each shard, so the shard orders
+	// just those for the router to merge
+
+	task->candidateLength = task->intersect.result.length;
 
 	if((action->sort.isSorted) &&
-			(action->intersect.result.length > 1) &&
-			(action->sort.directiveLength > 0) &&
-			(action->sort.directives != NULL)) {
+			(action->options.hasResultOptions) &&
+			(action->options.limit > 0) &&
+			(action->options.offset <
+			 (task->intersect.result.length - action->options.limit))) {
+		task->result = search_executeSort(task->compiler, task->engine,
+				action, &task->intersect);
+		task->candidateLength = (action->options.offset +
+				action->options.limit);
+	}
+}
+
+static int search_executeSearchSharded(SearchCompiler *compiler,
+		SearchEngine *engine, SearchActionSearch *action)
+{
+	int ii = 0;
+	int nn = 0;
+	int rc = 0;
+	int ref = 0;
+	int result = 0;
+	double timer = 0.0;
+	aboolean *isGroupEmpty = NULL;
+	void **arguments = NULL;
+
+	Intersect candidates;
+	SearchShardTask *tasks = NULL;
+
+	timer = time_getTimeMus();
+
+	tasks = (SearchShardTask *)malloc(sizeof(SearchShardTask) *
+			engine->shardLength);
+	arguments = (void **)malloc(sizeof(void *) * engine->shardLength);
+	isGroupEmpty = (aboolean *)malloc(sizeof(aboolean) *
+			(action->groupsLength + 1));
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		tasks[ii].result = 0;
+		tasks[ii].candidateLength = 0;
+		tasks[ii].isGroupEmpty = isGroupEmpty;
+		tasks[ii].compiler = compiler;
+		tasks[ii].engine = engine->shards[ii];
+		tasks[ii].action = action;
+		tasks[ii].groups = NULL;
+
+		arguments[ii] = (void *)&tasks[ii];
+	}
+
+	// scatter the groups to every shard, then the final intersection
+
+	searchExecutor_execute(&engine->executor, search_executeShardGroupsTask,
+			arguments, engine->shardLength);
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		isGroupEmpty[ii] = atrue;
+
+		for(nn = 0; nn < engine->shardLength; nn++) {
+			if(tasks[nn].groups[ii].result.length > 0) {
+				isGroupEmpty[ii] = afalse;
+				break;
+			}
+		}
+	}
+
+	searchExecutor_execute(&engine->executor, search_executeShardTask,
+			arguments, engine->shardLength);
+
+	log_logf(compiler->log, LOG_LEVEL_DEBUG,
+			"{SEARCH} searched %i shard(s) in %0.6f seconds",
+			engine->shardLength, time_getElapsedMusInSeconds(timer));
+
+	// gather the shard results, which are disjoint by UID
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		intersect_initWithArena(&action->groups[ii].intersect,
+				compiler->arena);
+	}
+
+	intersect_initWithArena(&action->intersect, compiler->arena);
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if(tasks[ii].result < 0) {
+			result = tasks[ii].result;
+		}
+
+		if(tasks[ii].intersect.result.length < 1) {
+			continue;
+		}
+
+		intersect_putArray(&action->intersect,
+				((tasks[ii].candidateLength ==
+				  tasks[ii].intersect.result.length) &&
+				 (tasks[ii].intersect.result.isSorted)),
+				tasks[ii].intersect.result.array,
+				tasks[ii].intersect.result.length);
+	}
+
+	intersect_execOr(&action->intersect);
+
+	// merge the sorted candidates of each shard, ahead of the remainder of
+	// the results, which fall outside of the requested page
+
+	if((action->sort.isSorted) && (action->intersect.result.length > 1)) {
 		timer = time_getTimeMus();
 
-		if(engine->settings.maxSortOperationMemoryLength > 0) {
-			sortMemoryLength = searchSort_calculateMvInitMemoryLength(
-					&action->intersect);
+		intersect_init(&candidates);
+
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if(tasks[ii].candidateLength < 1) {
+				continue;
+			}
+
+			intersect_putArray(&candidates,
+					((tasks[ii].candidateLength ==
+					  tasks[ii].intersect.result.length) &&
+					 (tasks[ii].intersect.result.isSorted)),
+					tasks[ii].intersect.result.array,
+					tasks[ii].candidateLength);
 		}
 
-		searchSort_mvInit(&sort, engine, &action->intersect);
+		intersect_execOr(&candidates);
 
-		for(ii = 0; ii < action->sort.directiveLength; ii++) {
-			switch(action->sort.directives[ii].type) {
-				case SEARCH_COMPILER_SEARCH_SORT_TYPE_RELEVANCY:
-					if(engine->settings.maxSortOperationMemoryLength > 0) {
-						sortMemoryLength +=
-						searchSort_calculateMvAddSortByRelevancyMemoryLength(
-								&sort);
-					}
+		if((rc = search_executeSort(compiler, engine, action,
+						&candidates)) < 0) {
+			result = rc;
+		}
 
-					if((engine->settings.maxSortOperationMemoryLength == 0) ||
-							((engine->settings.maxSortOperationMemoryLength >
-							  0) &&
-							 (sortMemoryLength <=
-							  engine->settings.maxSortOperationMemoryLength))) {
-						search_executeSearchRelevancySort(action, &sort);
-					}
-					else {
-						log_logf(compiler->log, LOG_LEVEL_WARNING,
-								"{SEARCHD} aborted sort operation due to "
-								"required memory higher than current limits "
-								"(%lli vs %lli)",
-								sortMemoryLength,
-							  	engine->settings.maxSortOperationMemoryLength);
+		ref = 0;
 
-						result = SEARCH_COMPILER_ERROR_EXEC_SORT_OUT_OF_MEMORY;
-					}
-					break;
+		for(ii = 0; ((ii < candidates.result.length) &&
+					(ref < action->intersect.result.length)); ii++) {
+			action->intersect.result.array[ref] = candidates.result.array[ii];
+			ref++;
+		}
 
-				case SEARCH_COMPILER_SEARCH_SORT_TYPE_ATTRIBUTE:
-					if(engine->settings.maxSortOperationMemoryLength > 0) {
-						sortMemoryLength +=
-					searchSort_calculateMvAddSortByAttributeNameMemoryLength(
-							&sort, action->sort.directives[ii].attribute,
-							engine->settings.maxSortOperationMemoryLength);
-					}
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			for(nn = tasks[ii].candidateLength;
+					((nn < tasks[ii].intersect.result.length) &&
+					 (ref < action->intersect.result.length)); nn++) {
+				action->intersect.result.array[ref] =
+					tasks[ii].intersect.result.array[nn];
+				ref++;
+			}
+		}
 
-					if((engine->settings.maxSortOperationMemoryLength == 0) ||
-							((engine->settings.maxSortOperationMemoryLength >
-							  0) &&
-							 (sortMemoryLength <=
-							  engine->settings.maxSortOperationMemoryLength))) {
-						searchSort_mvAddSortByAttributeName(&sort,
-							action->sort.directives[ii].attribute,
-							action->sort.directives[ii].isStandardSortOrder);
-					}
-					else {
-						log_logf(compiler->log, LOG_LEVEL_WARNING,
-								"{SEARCHD} aborted sort operation due to "
-								"required memory higher than current limits "
-								"(%lli vs %lli)",
-								sortMemoryLength,
-							  	engine->settings.maxSortOperationMemoryLength);
+		intersect_free(&candidates);
 
-						result = SEARCH_COMPILER_ERROR_EXEC_SORT_OUT_OF_MEMORY;
-					}
-					break;
+		log_logf(compiler->log, LOG_LEVEL_DEBUG,
+				"{SEARCH} merged the sorted results of %i shard(s) in "
+				"%0.6f seconds",
+				engine->shardLength, time_getElapsedMusInSeconds(timer));
+	}
 
-				case SEARCH_COMPILER_SEARCH_SORT_TYPE_GEO_COORD:
-					if(engine->settings.maxSortOperationMemoryLength > 0) {
-						sortMemoryLength +=
-							searchSort_calculateMvAddSortByDistanceMemoryLength(
-									&sort);
-					}
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		intersect_free(&tasks[ii].intersect);
+	}
 
-					if((engine->settings.maxSortOperationMemoryLength == 0) ||
-							((engine->settings.maxSortOperationMemoryLength >
-							  0) &&
-							 (sortMemoryLength <=
-							  engine->settings.maxSortOperationMemoryLength))) {
-						searchSort_mvAddSortByDistance(engine,
-							&sort,
-							action->sort.directives[ii].latitude,
-							action->sort.directives[ii].longitude,
-							action->sort.directives[ii].isStandardSortOrder);
-					}
-					else {
-						log_logf(compiler->log, LOG_LEVEL_WARNING,
-								"{SEARCHD} aborted sort operation due to "
-								"required memory higher than current limits "
-								"(%lli vs %lli)",
-								sortMemoryLength,
-							  	engine->settings.maxSortOperationMemoryLength);
+	free(isGroupEmpty);
+	free(arguments);
+	free(tasks);
 
-						result = SEARCH_COMPILER_ERROR_EXEC_SORT_OUT_OF_MEMORY;
-					}
-					break;
+	return result;
+}
 
-				case SEARCH_COMPILER_SEARCH_SORT_TYPE_UNKNOWN:
-				case SEARCH_COMPILER_SEARCH_SORT_TYPE_ERROR:
-				default:
-					log_logf(compiler->log, LOG_LEVEL_WARNING,
-							"unknown sort type %i, aborting sort",
-							action->sort.directives[ii].type);
+static int action_executeSearch(SearchCompiler *compiler,
+		SearchEngine *engine)
+{
+	int ii = 0;
+	int nn = 0;
+	int conditionsLength = 0;
+	double timer = 0.0;
+	char *domainKey = NULL;
+
+	SearchActionSearch *action = NULL;
+
+	if(compiler->action == NULL) {
+		return -1;
+	}
+
+	action = (SearchActionSearch *)compiler->action;
+
+	action->engine = engine;
+
+	if(authSystem_isEnabled(&engine->auth)) {
+		for(ii = 0; ii < action->domainKeysLength; ii++) {
+			if(!strcmp(action->domainKeys[ii], "*")) {
+				domainKey = NULL;
+			}
+			else {
+				domainKey = action->domainKeys[ii];
+			}
+
+			if(!authSystem_isPermitted(&engine->auth,
+						compiler->token,
+						domainKey,
+						compiler->ipAddress,
+						AUTHENTICATION_PERMISSIONS_SEARCH)) {
+				return SEARCH_COMPILER_ERROR_EXEC_PERMISSION_DENIED;
 			}
 		}
+	}
 
-		searchSort_mvExecute(&sort);
-		searchSort_mvFree(&sort);
+	// a sharded engine searches, and orders, each of its shards in parallel
+
+	if(engine->shardLength > 0) {
+		return search_executeSearchSharded(compiler, engine, action);
+	}
+
+	// perform search
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		conditionsLength += action->groups[ii].conditionsLength;
+	}
+
+	if((engine->executor.threadPoolSize > 0) && (conditionsLength > 1)) {
+		search_executeSearchInParallel(compiler, engine, action,
+				conditionsLength);
+	}
+	else {
+		for(ii = 0; ii < action->groupsLength; ii++) {
+			intersect_initWithArena(&action->groups[ii].intersect,
+					compiler->arena);
+
+			if(action->groups[ii].conditionsLength < 1) {
+				continue;
+			}
+
+			timer = time_getTimeMus();
+
+			for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
+				search_executeSearchCondition(compiler,
+						engine,
+						action,
+						&action->groups[ii].conditions[nn],
+						&action->groups[ii].intersect);
+			}
+
+			log_logf(compiler->log, LOG_LEVEL_DEBUG,
+					"{SEARCH} performed group %i search in %0.6f seconds",
+					ii, time_getElapsedMusInSeconds(timer));
+
+			search_intersectGroup(compiler, ii,
+					action->groups[ii].isAndIntersection,
+					&action->groups[ii].intersect);
+		}
+	}
+
+	// perform intersection
+
+	timer = time_getTimeMus();
+
+	intersect_initWithArena(&action->intersect, compiler->arena);
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		if(action->groups[ii].conditionsLength < 1) {
+			continue;
+		}
+
+		intersect_putArray(&action->intersect,
+				action->groups[ii].intersect.result.isSorted,
+				action->groups[ii].intersect.result.array,
+				action->groups[ii].intersect.result.length);
+	}
+
+	if(action->settings.isAndIntersection) {
+		intersect_execAnd(&action->intersect, atrue);
 
 		log_logf(compiler->log, LOG_LEVEL_DEBUG,
-				"{SEARCH} performed %ix sort on %i results in %0.6f seconds",
-				action->sort.directiveLength,
+				"{SEARCH} obtained %i results from AND intersection "
+				"in %0.6f seconds",
 				action->intersect.result.length,
 				time_getElapsedMusInSeconds(timer));
 	}
+	else {
+		intersect_execOr(&action->intersect);
 
-	return result;
+		log_logf(compiler->log, LOG_LEVEL_DEBUG,
+				"{SEARCH} obtained %i results from OR intersection "
+				"in %0.6f seconds",
+				action->intersect.result.length,
+				time_getElapsedMusInSeconds(timer));
+	}
+
+/*
+	intersect_display(stdout, &action->intersect);
+*/
+
+	// determine if any geocoord search pruning is required
+
+	timer = time_getTimeMus();
+
+	for(ii = 0; ii < action->groupsLength; ii++) {
+		for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
+			if(action->groups[ii].conditions[nn].type ==
+					SEARCH_COMPILER_SEARCH_CONDITION_TYPE_GEO_COORD) {
+				search_pruneByDistance(compiler,
+						engine,
+						action->groups[ii].conditions[nn].latitude,
+						action->groups[ii].conditions[nn].longitude,
+						action->groups[ii].conditions[nn].distance,
+						&action->intersect);
+			}
+		}
+	}
+
+	log_logf(compiler->log, LOG_LEVEL_DEBUG,
+			"{SEARCH} distance-prune check completed in %0.6f seconds",
+			time_getElapsedMusInSeconds(timer));
+
+	// perform sorting
+
+	return search_executeSort(compiler, engine, action, &action->intersect);
 }
 
-static void action_freeSearchContext(SearchActionSearch *action)
+static void action_freeSearchContext(MemoryArena *arena,
+		SearchActionSearch *action)
 {
 	int ii = 0;
 	int nn = 0;
@@ -1867,21 +2344,21 @@ static void action_freeSearchContext(SearchActionSearch *action)
 	if(action->requestAttributes != NULL) {
 		for(ii = 0; ii < action->requestAttributesLength; ii++) {
 			if(action->requestAttributes[ii] != NULL) {
-				free(action->requestAttributes[ii]);
+				arenaFree(arena, action->requestAttributes[ii]);
 			}
 		}
 
-		free(action->requestAttributes);
+		arenaFree(arena, action->requestAttributes);
 	}
 
 	if(action->domainKeys != NULL) {
 		for(ii = 0; ii < action->domainKeysLength; ii++) {
 			if(action->domainKeys[ii] != NULL) {
-				free(action->domainKeys[ii]);
+				arenaFree(arena, action->domainKeys[ii]);
 			}
 		}
 
-		free(action->domainKeys);
+		arenaFree(arena, action->domainKeys);
 	}
 
 	intersect_free(&action->intersect);
@@ -1893,41 +2370,43 @@ static void action_freeSearchContext(SearchActionSearch *action)
 			if(action->groups[ii].conditions != NULL) {
 				for(nn = 0; nn < action->groups[ii].conditionsLength; nn++) {
 					if(action->groups[ii].conditions[nn].attribute != NULL) {
-						free(action->groups[ii].conditions[nn].attribute);
+						arenaFree(arena,
+								action->groups[ii].conditions[nn].attribute);
 					}
 					if(action->groups[ii].conditions[nn].value != NULL) {
-						free(action->groups[ii].conditions[nn].value);
+						arenaFree(arena,
+								action->groups[ii].conditions[nn].value);
 					}
 				}
 	
-				free(action->groups[ii].conditions);
+				arenaFree(arena, action->groups[ii].conditions);
 			}
 		}
 
-		free(action->groups);
+		arenaFree(arena, action->groups);
 	}
 
 	if(action->sort.directives != NULL) {
 		for(ii = 0; ii < action->sort.directiveLength; ii++) {
 			if(action->sort.directives[ii].attribute != NULL) {
-				free(action->sort.directives[ii].attribute);
+				arenaFree(arena, action->sort.directives[ii].attribute);
 			}
 		}
 
-		free(action->sort.directives);
+		arenaFree(arena, action->sort.directives);
 	}
 
 	if(action->facets.attributes != NULL) {
 		for(ii = 0; ii < action->facets.attributesLength; ii++) {
 			if(action->facets.attributes[ii] != NULL) {
-				free(action->facets.attributes[ii]);
+				arenaFree(arena, action->facets.attributes[ii]);
 			}
 		}
 
-		free(action->facets.attributes);
+		arenaFree(arena, action->facets.attributes);
 	}
 
-	free(action);
+	arenaFree(arena, action);
 }
 
 static void action_freeSearch(SearchCompiler *compiler)
@@ -1936,7 +2415,8 @@ static void action_freeSearch(SearchCompiler *compiler)
 		return;
 	}
 
-	action_freeSearchContext((SearchActionSearch *)compiler->action);
+	action_freeSearchContext(compiler->arena,
+			(SearchActionSearch *)compiler->action);
 }
 
 static void action_displaySearch(void *stream, SearchCompiler *compiler)
@@ -2280,6 +2760,21 @@ static int action_executeCommand(SearchCompiler *compiler,
 						}
 					}
 
+					if(action->isOverrideDocValues) {
+						log_logf(engine->log, LOG_LEVEL_INFO,
+								"{COMPILER} calling set doc values for '%s' "
+								"to %i",
+								action->indexKey,
+								(int)action->isDocValues);
+
+						if((rc = searchEngine_setIndexDocValues(engine,
+										string,
+										action->isDocValues)) < 0) {
+							free(string);
+							return rc;
+						}
+					}
+
 					if((action->minStringLength > 0) &&
 							(action->maxStringLength > 0) &&
 							(action->minStringLength <=
@@ -2352,6 +2847,15 @@ static int action_executeCommand(SearchCompiler *compiler,
 						}
 					}
 
+					// settings made on the router's registry are copied to
+					// the registries of its shards
+
+					if((rc = searchEngine_syncIndexSettings(engine,
+									string)) < 0) {
+						free(string);
+						return rc;
+					}
+
 					free(string);
 					break;
 
@@ -2666,6 +3170,14 @@ static void action_freeLogout(SearchCompiler *compiler)
 int searchCompiler_compileJson(SearchCompiler *compiler, Log *log,
 		char *ipAddress, SearchJsonValidationType validationType,
 		Json *message)
+{
+	return searchCompiler_compileJsonWithArena(compiler, NULL, log, ipAddress,
+			validationType, message);
+}
+
+int searchCompiler_compileJsonWithArena(SearchCompiler *compiler,
+		MemoryArena *arena, Log *log, char *ipAddress,
+		SearchJsonValidationType validationType, Json *message)
 {
 	char *string = NULL;
 	char *messageName = NULL;
@@ -2677,6 +3189,8 @@ int searchCompiler_compileJson(SearchCompiler *compiler, Log *log,
 
 	memset(compiler, 0, (int)(sizeof(SearchCompiler)));
 
+	compiler->arena = arena;
+
 	if(ipAddress == NULL) {
 		compiler->ipAddress = strndup("0.0.0.0", 7);
 	}
@@ -2762,7 +3276,7 @@ int searchCompiler_compileJson(SearchCompiler *compiler, Log *log,
 	else if(!strcmp(messageName, "search")) {
 		if(!searchJson_compileSearch(compiler, validationType, message)) {
 			if(compiler->action != NULL) {
-				action_freeSearchContext(compiler->action);
+				action_freeSearchContext(compiler->arena, compiler->action);
 				compiler->action = NULL;
 			}
 			return returnError(compiler,
@@ -3274,7 +3788,7 @@ Json *searchCompiler_buildResponse(SearchCompiler *compiler)
 	}
 
 	if(result == NULL) {
-		result = json_new();
+		result = json_newWithArena(compiler->arena);
 
 		json_addString(result, "messageName", "errorMessage");
 
@@ -3321,6 +3835,49 @@ Json *searchCompiler_buildResponse(SearchCompiler *compiler)
 	return result;
 }
 
+int searchCompiler_writeResponse(SearchCompiler *compiler, JsonWriter *writer)
+{
+	int rc = 0;
+
+	Json *result = NULL;
+
+	if((compiler == NULL) || (writer == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	/*
+	 * note: the response members are written into the writer's current
+	 * object; search results are streamed from their containers, and all
+	 * other (small) responses are built, and then written
+	 */
+
+	if((compiler->type == SEARCH_COMPILER_ACTION_SEARCH) &&
+			(compiler->errorCode == 0)) {
+		if(searchJson_writeSearchResult(compiler, writer) < 0) {
+			return -1;
+		}
+
+		if(compiler->errorMessage != NULL) {
+			jsonWriter_writeName(writer, "warningMessage");
+			jsonWriter_writeString(writer, compiler->errorMessage,
+					strlen(compiler->errorMessage));
+		}
+
+		return 0;
+	}
+
+	if((result = searchCompiler_buildResponse(compiler)) == NULL) {
+		return -1;
+	}
+
+	rc = jsonWriter_writeJsonMembers(writer, result);
+
+	json_freePtr(result);
+
+	return rc;
+}
+
 // helper functions for compiler extensions
 
 void searchCompiler_buildErrorMessage(SearchCompiler *compiler,
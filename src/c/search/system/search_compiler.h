@@ -254,6 +254,8 @@ typedef struct _SearchActionCommand {
 	aboolean isOverrideIndexing;
 	aboolean isIndexFullString;
 	aboolean isIndexTokenizedString;
+	aboolean isOverrideDocValues;
+	aboolean isDocValues;
 	int minStringLength;
 	int maxStringLength;
 	char *indexKey;
@@ -287,6 +289,7 @@ typedef struct _SearchCompiler {
 	char *ipAddress;
 	char *errorMessage;
 	Log *log;
+	MemoryArena *arena;
 	void *action;
 } SearchCompiler;
 
@@ -297,6 +300,10 @@ int searchCompiler_compileJson(SearchCompiler *compiler, Log *log,
 		char *ipAddress, SearchJsonValidationType validationType,
 		Json *message);
 
+int searchCompiler_compileJsonWithArena(SearchCompiler *compiler,
+		MemoryArena *arena, Log *log, char *ipAddress,
+		SearchJsonValidationType validationType, Json *message);
+
 int searchCompiler_compileSql(SearchCompiler *compiler, Log *log, char *query);
 
 void searchCompiler_free(SearchCompiler *compiler);
@@ -305,6 +312,8 @@ int searchCompiler_execute(SearchCompiler *compiler, SearchEngine *engine);
 
 Json *searchCompiler_buildResponse(SearchCompiler *compiler);
 
+int searchCompiler_writeResponse(SearchCompiler *compiler, JsonWriter *writer);
+
 // helper functions for compiler extensions
 
 void searchCompiler_buildErrorMessage(SearchCompiler *compiler,
@@ -25,18 +25,49 @@ typedef enum _SearchEngineQueueCommands {
 	SEARCH_ENGINE_QUEUE_COMMAND_FREE = 1,
 	SEARCH_ENGINE_QUEUE_COMMAND_PUT,
 	SEARCH_ENGINE_QUEUE_COMMAND_UPDATE,
+	SEARCH_ENGINE_QUEUE_COMMAND_REPLACE,
+	SEARCH_ENGINE_QUEUE_COMMAND_DELETE,
+	SEARCH_ENGINE_QUEUE_COMMAND_LOAD,
 	SEARCH_ENGINE_QUEUE_COMMAND_ERROR = -1
 } SearchEngineQueueCommands;
 
+#define SEARCH_ENGINE_QUEUE_BATCH_LENGTH				1024
+
+#define SEARCH_ENGINE_WORKER_MIN_NAP_MICROS				64
+
+#define SEARCH_ENGINE_WORKER_MAX_NAP_MICROS				1024
+
+#define SEARCH_ENGINE_WORKER_MAX_NAP_SECONDS			1.0
+
 
 // define search engine private data types
 
 typedef struct _SearchEngineQueueEntry {
 	SearchEngineQueueCommands type;
+	aboolean isPrepared;
+	aboolean isLogged;
 	char flags;
+	int uid;
+	alint ticket;
 	void *payload;
+	SearchEngine *engine;
 } SearchEngineQueueEntry;
 
+typedef struct _SearchEnginePipelineShard {
+	int shardRef;
+	int shardLength;
+	SearchEngine *engine;
+} SearchEnginePipelineShard;
+
+typedef struct _SearchEngineShardBulk {
+	int result;
+	int containerLength;
+	int *refs;
+	char *domainKey;
+	Container **containers;
+	SearchEngine *engine;
+} SearchEngineShardBulk;
+
 
 // declare search engine private functions
 
@@ -46,8 +77,14 @@ static void freeNothing(void *memory);
 
 static void freeIndex(void *memory);
 
+static void freeContainerIndexes(SearchEngine *engine, Container *container);
+
 static void freeContainer(void *argument, void *memory);
 
+static void freeDocValues(void *memory);
+
+static void freeCount(void *memory);
+
 // queue functions
 
 SearchEngineQueueEntry *queue_buildEntry(SearchEngineQueueCommands type,
@@ -58,27 +95,74 @@ static void queue_freeEntry(void *memory);
 static int queue_executeAddition(SearchEngine *engine,
 		SearchEngineQueueEntry *entry);
 
+static int queue_executeRemoval(SearchEngine *engine,
+		SearchEngineQueueEntry *entry);
+
+static int queue_executeEntry(SearchEngine *engine,
+		SearchEngineQueueEntry *entry);
+
+static void queue_prepareEntry(void *argument);
+
+static int queue_executeBatch(SearchEngine *engine,
+		SearchEngineQueueEntry **entries, int entryLength);
+
+// pipeline functions
+
+static int pipeline_addJob(SearchEngine *engine, Container *container,
+		char *domainKey);
+
+static aboolean pipeline_dropJob(SearchEngine *engine, Container *container);
+
+static void pipeline_addPosting(SearchEngineIndexJob *job,
+		SearchEnginePostingTypes type, IndexRegistryIndex *indexType,
+		char *token, int tokenLength, int value);
+
+static void pipeline_addGeoCoordPosting(SearchEngineIndexJob *job,
+		IndexRegistryIndex *indexType, double latitude, double longitude);
+
+static void pipeline_buildJob(void *argument);
+
+static void pipeline_applyShard(void *argument);
+
+static int pipeline_flush(SearchEngine *engine);
+
 // index functions
 
 static int index_updateFullString(SearchEngine *engine, aboolean isPut,
 		SearchIndex *searchIndex, IndexRegistryIndex *indexType, char *string,
-		int stringLength, int uid);
+		int stringLength, int uid, SearchEngineIndexJob *job);
 
 static int index_updateTokenizedString(SearchEngine *engine, aboolean isPut,
 		SearchIndex *searchIndex, IndexRegistryIndex *indexType, char *string,
-		int stringLength, int uid);
+		int stringLength, int uid, SearchEngineIndexJob *job);
 
 static int index_updateString(SearchEngine *engine, aboolean isPut,
 		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
-		ContainerIterator *iterator, int uid);
+		ContainerIterator *iterator, int uid, SearchEngineIndexJob *job);
 
 static int index_updateInteger(SearchEngine *engine, aboolean isPut,
 		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
-		ContainerIterator *iterator, int uid);
+		ContainerIterator *iterator, int uid, SearchEngineIndexJob *job);
+
+static int index_updateGeoCoord(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
+		Container *container, char *latitudeName, int latitudeNameLength,
+		char *longitudeName, int longitudeNameLength,
+		SearchEngineIndexJob *job);
+
+static int index_updateGeoCoords(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
+		Container *container, SearchEngineIndexJob *job);
 
 static int index_reindexContainers(SearchEngine *engine,
 		IndexRegistryIndex *indexType);
 
+static DocValues *index_getDocValues(SearchEngine *engine, char *key,
+		int keyLength, aboolean isCreate);
+
+static int index_fillDocValues(SearchEngine *engine,
+		IndexRegistryIndex *indexType, DocValues *docValues);
+
 // container functions
 
 static int container_reindex(SearchEngine *engine,
@@ -86,7 +170,15 @@ static int container_reindex(SearchEngine *engine,
 		Container *container);
 
 static int container_updateIndexes(SearchEngine *engine, aboolean isPut,
-		SearchIndex *searchIndex, Container *container);
+		SearchIndex *searchIndex, Container *container,
+		SearchEngineIndexJob *job);
+
+static int container_loadDocValues(SearchEngine *engine,
+		Container *container);
+
+static void container_updateDocValues(SearchEngine *engine, aboolean isPut,
+		IndexRegistryIndex *indexType, DocValues *docValues,
+		Container *container, char *name, int nameLength);
 
 static char *container_buildRelevancyStringArray(SearchEngine *engine,
 		IndexRegistryIndex *indexType, ContainerIterator *iterator,
@@ -95,19 +187,76 @@ static char *container_buildRelevancyStringArray(SearchEngine *engine,
 static int container_calculateRelevancy(SearchEngine *engine,
 		Container *container);
 
+// geocoord functions
+
+static double geocoord_toMiles(SearchEngineGeoCoordTypes type,
+		double distance);
+
+static IndexRegistryIndex *geocoord_getIndex(SearchEngine *engine);
+
+static int geocoord_search(SearchEngine *engine, SearchIndex *searchIndex,
+		IndexRegistryIndex *indexType, double latitude, double longitude,
+		double miles, Intersect *intersect);
+
+// write-ahead log functions
+
+static alint wal_appendContainer(SearchEngine *engine,
+		SearchWalRecordTypes type, Container *container);
+
+static alint wal_appendDelete(SearchEngine *engine, int uid);
+
+static int wal_replayRecord(void *context, SearchWalRecordTypes type,
+		int uid, char *payload, int payloadLength);
+
+// shard functions
+
+static SearchEngine *shard_getEngine(SearchEngine *engine, int uid);
+
+static char *shard_buildContainerPath(SearchEngine *engine,
+		char *containerPath, int shardId);
+
+static int shard_checkUserKeyIndexes(SearchEngine *engine, char *domainKey,
+		SearchEngine *owner, Container *container);
+
+static void shard_putBulkTask(void *argument);
+
+static int shard_putBulk(SearchEngine *engine, char *domainKey,
+		Container **containers, int containerLength);
+
+static int shard_locateUidByAttribute(SearchEngine *engine, char *attribute,
+		char *value);
+
+static int shard_restoreData(SearchEngine *engine, char *filename);
+
+static int shard_buildIndexValueSummary(SearchEngine *engine, char *domainKey,
+		char *indexKey, SearchIndexSummary *summary);
+
 // thread functions
 
 char *thread_buildStateFilename(SearchEngine *engine, int type);
 
 char *thread_buildContainerFilename(SearchEngine *engine, int type);
 
+char *thread_buildSegmentFilename(SearchEngine *engine, int type);
+
 static int thread_writeStateToFile(SearchEngine *engine);
 
 static int thread_readStateFromFile(SearchEngine *engine, char *filename);
 
-static int thread_writeContainersToFile(SearchEngine *engine);
+static int *thread_cutGeneration(SearchEngine *engine, aboolean isWorker,
+		int *generation, int *uidLength);
+
+static int thread_writeCheckpoint(SearchEngine *engine, aboolean isWorker);
+
+static int thread_writeContainersToFile(SearchEngine *engine,
+		aboolean isWorker);
 
-static int thread_readContainersFromFile(SearchEngine *engine, char *filename);
+static int thread_readContainersFromFile(SearchEngine *engine, char *filename,
+		int *generation);
+
+static int thread_writeSegmentToFile(SearchEngine *engine, int generation);
+
+static int thread_openSegment(SearchEngine *engine, char *filename);
 
 static void *thread_searchEngineWorker(void *threadContext, void *argument);
 
@@ -137,25 +286,12 @@ static void freeIndex(void *memory)
 	searchIndex_freePtr(index);
 }
 
-static void freeContainer(void *argument, void *memory)
+static void freeContainerIndexes(SearchEngine *engine, Container *container)
 {
 	int domainKeyLength = 0;
 	char *domainKey = NULL;
 
-	Container *container = NULL;
 	SearchIndex *searchIndex = NULL;
-	SearchEngine *engine = NULL;
-	SearchEngineQueueEntry *entry = NULL;
-
-	if((argument == NULL) || (memory == NULL)) {
-		DISPLAY_INVALID_ARGS;
-		return;
-	}
-
-	engine = (SearchEngine *)argument;
-	container = (Container *)memory;
-
-	// remove the container indexes
 
 	if(container_lock(container) < 0) {
 		log_logf(engine->log, LOG_LEVEL_ERROR,
@@ -177,7 +313,7 @@ static void freeContainer(void *argument, void *memory)
 							((void *)&searchIndex)) == 0) &&
 					(searchIndex != NULL)) {
 				if(container_updateIndexes(engine, afalse, searchIndex,
-							container) < 0) {
+							container, NULL) < 0) {
 					log_logf(engine->log, LOG_LEVEL_ERROR,
 							"failed to remove indexes for container #%i",
 							container_getUid(container));
@@ -203,6 +339,32 @@ static void freeContainer(void *argument, void *memory)
 	if(domainKey != NULL) {
 		free(domainKey);
 	}
+}
+
+static void freeContainer(void *argument, void *memory)
+{
+	Container *container = NULL;
+	SearchEngine *engine = NULL;
+	SearchEngineQueueEntry *entry = NULL;
+
+	if((argument == NULL) || (memory == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	engine = (SearchEngine *)argument;
+	container = (Container *)memory;
+
+	/*
+	 * note: this may be called from the managed index's eviction thread, so
+	 * rather than flushing the pipeline here, on the executor shared with the
+	 * queries, a job still pending for this container is dropped; such a
+	 * container was never indexed, so it has no indexes to remove
+	 */
+
+	if(!pipeline_dropJob(engine, container)) {
+		freeContainerIndexes(engine, container);
+	}
 
 	// construct the queue entry & add it to the queue
 
@@ -217,6 +379,26 @@ static void freeContainer(void *argument, void *memory)
 	mutex_unlock(&engine->queueMutex);
 }
 
+static void freeDocValues(void *memory)
+{
+	if(memory == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	docValues_freePtr((DocValues *)memory);
+}
+
+static void freeCount(void *memory)
+{
+	if(memory == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return;
+	}
+
+	free(memory);
+}
+
 // queue functions
 
 SearchEngineQueueEntry *queue_buildEntry(SearchEngineQueueCommands type,
@@ -249,6 +431,9 @@ static void queue_freeEntry(void *memory)
 
 		case SEARCH_ENGINE_QUEUE_COMMAND_PUT:
 		case SEARCH_ENGINE_QUEUE_COMMAND_UPDATE:
+		case SEARCH_ENGINE_QUEUE_COMMAND_REPLACE:
+		case SEARCH_ENGINE_QUEUE_COMMAND_DELETE:
+		case SEARCH_ENGINE_QUEUE_COMMAND_LOAD:
 			/*
 			 * do nothing
 			 */
@@ -274,20 +459,23 @@ static int queue_executeAddition(SearchEngine *engine,
 	Container *container = NULL;
 	Container *localContainer = NULL;
 	Container *updatedContainer = NULL;
-	SearchIndex *searchIndex = NULL;
 
 	if((entry == NULL) ||
 			((entry->type != SEARCH_ENGINE_QUEUE_COMMAND_PUT) &&
-			 (entry->type != SEARCH_ENGINE_QUEUE_COMMAND_UPDATE))) {
+			 (entry->type != SEARCH_ENGINE_QUEUE_COMMAND_UPDATE) &&
+			 (entry->type != SEARCH_ENGINE_QUEUE_COMMAND_REPLACE) &&
+			 (entry->type != SEARCH_ENGINE_QUEUE_COMMAND_LOAD))) {
 		DISPLAY_INVALID_ARGS;
 		return -1;
 	}
 
 	container = (Container *)entry->payload;
 
-	// calculate container relevancy
+	// calculate container relevancy, unless done ahead for the batch
 
-	container_calculateRelevancy(engine, container);
+	if(!entry->isPrepared) {
+		container_calculateRelevancy(engine, container);
+	}
 
 	// read-lock the container
 
@@ -334,7 +522,8 @@ static int queue_executeAddition(SearchEngine *engine,
 
 	if(managedIndex_get(&engine->containers, key, keyLength,
 				((void *)&localContainer)) == 0) {
-		if(entry->type == SEARCH_ENGINE_QUEUE_COMMAND_PUT) {
+		if((entry->type == SEARCH_ENGINE_QUEUE_COMMAND_PUT) ||
+				(entry->type == SEARCH_ENGINE_QUEUE_COMMAND_LOAD)) {
 			log_logf(engine->log, LOG_LEVEL_ERROR,
 					"unable to put container container #%i domain '%s', "
 					"already exists",
@@ -346,13 +535,36 @@ static int queue_executeAddition(SearchEngine *engine,
 			return -1;
 		}
 
-		// combine the containers
-
 		if(container_lock(localContainer) < 0) {
 			log_logf(engine->log, LOG_LEVEL_WARNING,
 					"failed to obtain container read lock for removal");
 		}
 
+		// a replayed container replaces the existing one as a whole
+
+		if(entry->type == SEARCH_ENGINE_QUEUE_COMMAND_REPLACE) {
+			if(managedIndex_remove(&engine->containers, key, keyLength) < 0) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to remove container #%i "
+						"domain '%s' from master index",
+						container_getUid(localContainer),
+						domainKey);
+				free(domainKey);
+				container_unlock(container);
+				container_freePtr(container);
+				container_unlock(localContainer);
+				return -1;
+			}
+
+			container_unlock(localContainer);
+
+			localContainer = NULL;
+		}
+	}
+
+	if(localContainer != NULL) {
+		// combine the containers
+
 		if((updatedContainer = container_combine(localContainer,
 						container, entry->flags, &errorMessage)) == NULL) {
 			log_logf(engine->log, LOG_LEVEL_ERROR,
@@ -412,623 +624,516 @@ static int queue_executeAddition(SearchEngine *engine,
 		return -1;
 	}
 
-	// update the container indexes
+	// a bulk put logs each container once it is in the managed index
 
-	if(spinlock_readLock(&engine->lock) < 0) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"failed to obtain spinlock for domain "
-				"lookup from %s()", __FUNCTION__);
+	if(entry->isLogged) {
+		entry->ticket = wal_appendContainer(engine,
+				SEARCH_WAL_RECORD_TYPE_PUT, container);
 	}
-	else {
-		if((bptree_get(&engine->indexes,
-						domainKey,
-						domainKeyLength,
-						((void *)&searchIndex)) == 0) &&
-				(searchIndex != NULL)) {
-			if(container_updateIndexes(engine,
-						atrue, // is put
-						searchIndex,
-						container) < 0) {
-				log_logf(engine->log, LOG_LEVEL_ERROR,
-						"failed to add indexes for container #%i",
-						container_getUid(container));
-			}
-		}
-		else {
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"unable to locate domain '%s' to add container #%i",
-					domainKey, container_getUid(container));
-		}
 
-		spinlock_readUnlock(&engine->lock);
+	// a container loaded alongside the index segment is already indexed
+
+	if(entry->type == SEARCH_ENGINE_QUEUE_COMMAND_LOAD) {
+		container_loadDocValues(engine, container);
+		container_unlock(container);
+		free(domainKey);
+		return 0;
 	}
 
 	container_unlock(container);
 
-	// cleanup
+	// defer the container indexes to the pipeline, which takes the domain key
 
-	if(domainKey != NULL) {
-		free(domainKey);
-	}
+	pipeline_addJob(engine, container, domainKey);
 
 	return 0;
 }
 
-// index functions
-
-static int index_updateFullString(SearchEngine *engine, aboolean isPut,
-		SearchIndex *searchIndex, IndexRegistryIndex *indexType, char *string,
-		int stringLength, int uid)
+static int queue_executeRemoval(SearchEngine *engine,
+		SearchEngineQueueEntry *entry)
 {
-	int length = 0;
-	int resultLength = 0;
-	int allocatedLength = 0;
-	int minStringLength = 0;
-	int maxStringLength = 0;
-	char *buffer = NULL;
-	char *localString = NULL;
+	int keyLength = 0;
+	char key[128];
 
-	SearchEngineDataTypes dataType = SEARCH_ENGINE_DATA_TYPE_ERROR;
+	Container *localContainer = NULL;
 
-	// determine if this index allows this type of indexing
+	if((entry == NULL) || (entry->type != SEARCH_ENGINE_QUEUE_COMMAND_DELETE)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
 
-	if((indexType->settings.isOverrideIndexing) &&
-			(!indexType->settings.isIndexFullString)) {
-		return 0;
+	if(searchEngineCommon_buildUidKey(entry->uid, key, &keyLength) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to build index key for container #%i", entry->uid);
+		return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_BUILD_UID_KEY;
 	}
 
-	length = stringLength;
-	allocatedLength = stringLength;
-	localString = strndup(string, length);
+	// a replayed delete may refer to a container which was never restored
 
-	// determine the data type
+	if(managedIndex_get(&engine->containers, key, keyLength,
+				((void *)&localContainer)) < 0) {
+		return 0;
+	}
 
-	if((dataType = searchEngineCommon_determineDataType(localString,
-					length)) == SEARCH_ENGINE_DATA_TYPE_ERROR) {
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"update-full-string { #%i->'%s' } unknown data type",
-				uid, indexType->key);
-		free(localString);
-		return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_DETERMINE_DATA_TYPE;
+	if(container_lock(localContainer) < 0) {
+		log_logf(engine->log, LOG_LEVEL_WARNING,
+				"failed to obtain container read lock for delete");
 	}
 
-	// perform normalization
+	if(managedIndex_remove(&engine->containers, key, keyLength) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to remove container #%i from master index",
+				entry->uid);
+		container_unlock(localContainer);
+		return -1;
+	}
 
-	if((dataType == SEARCH_ENGINE_DATA_TYPE_STRING) ||
-			(dataType == SEARCH_ENGINE_DATA_TYPE_BINARY)) {
-		if(searchEngineCommon_normalizeString(localString, length,
-					&resultLength) < 0) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-full-string { #%i->'%s' } normalization failed",
-					uid, indexType->key);
-			free(localString);
-			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_NORMALIZE_STRING;
-		}
+	container_unlock(localContainer);
 
-		length = resultLength;
-	}
+	return 0;
+}
 
-	// determine string length thresholds
+static int queue_executeEntry(SearchEngine *engine,
+		SearchEngineQueueEntry *entry)
+{
+	int result = 0;
 
-	if(indexType->settings.isOverrideStringLengths) {
-		minStringLength = indexType->settings.minStringLength;
-		maxStringLength = indexType->settings.maxStringLength;
-	}
-	else {
-		minStringLength = engine->settings.minStringLength;
-		maxStringLength = engine->settings.maxStringLength;
+	switch(entry->type) {
+		case SEARCH_ENGINE_QUEUE_COMMAND_FREE:
+			container_freePtr(entry->payload);
+			break;
+
+		case SEARCH_ENGINE_QUEUE_COMMAND_PUT:
+		case SEARCH_ENGINE_QUEUE_COMMAND_UPDATE:
+		case SEARCH_ENGINE_QUEUE_COMMAND_REPLACE:
+		case SEARCH_ENGINE_QUEUE_COMMAND_LOAD:
+			result = queue_executeAddition(engine, entry);
+			break;
+
+		case SEARCH_ENGINE_QUEUE_COMMAND_DELETE:
+			result = queue_executeRemoval(engine, entry);
+			break;
+
+		case SEARCH_ENGINE_QUEUE_COMMAND_ERROR:
+		default:
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"unknown queue command %i",
+					entry->type);
+			result = -1;
 	}
 
-	// pad a short string
+	free(entry);
 
-	if(length < minStringLength) {
-		if(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-full-string { #%i->'%s' } unable to pad "
-					"string '%s' for wildcard index",
-					uid, indexType->key, localString);
-			free(localString);
-			return 0;
-		}
+	return result;
+}
 
-		if(allocatedLength < (minStringLength * 2)) {
-			allocatedLength = (minStringLength * 2);
+static void queue_prepareEntry(void *argument)
+{
+	SearchEngineQueueEntry *entry = NULL;
 
-			localString = (char *)realloc(localString,
-					(sizeof(char) * allocatedLength));
-		}
+	entry = (SearchEngineQueueEntry *)argument;
 
-		if(searchEngineCommong_padString(localString,
-					length,
-					allocatedLength,
-					minStringLength,
-					&resultLength) < 0) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-full-string { #%i->'%s' } pad string failed",
-					uid, indexType->key);
-			free(localString);
-			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_PAD_STRING;
-		}
+	container_calculateRelevancy(entry->engine, (Container *)entry->payload);
 
-		length = resultLength;
-	}
+	entry->isPrepared = atrue;
+}
 
-	if(length < minStringLength) {
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"update-full-string { #%i->'%s' } pad string fell short",
-				uid, indexType->key);
-		free(localString);
-		return -1;
+static int queue_executeBatch(SearchEngine *engine,
+		SearchEngineQueueEntry **entries, int entryLength)
+{
+	int ii = 0;
+	int prepareLength = 0;
+	void **arguments = NULL;
+
+	if(entryLength < 1) {
+		return 0;
 	}
 
-	// update the string in the search index for exact & user-key indexes
+	// calculate the relevancy of the added containers in parallel
 
-	buffer = (char *)malloc(sizeof(char) * (maxStringLength + 1));
+	arguments = (void **)malloc(sizeof(void *) * entryLength);
 
-	if(length > maxStringLength) {
-		strncpy(buffer, localString, maxStringLength);
+	for(ii = 0; ii < entryLength; ii++) {
+		if((entries[ii]->type == SEARCH_ENGINE_QUEUE_COMMAND_PUT) ||
+				(entries[ii]->type == SEARCH_ENGINE_QUEUE_COMMAND_UPDATE) ||
+				(entries[ii]->type == SEARCH_ENGINE_QUEUE_COMMAND_REPLACE) ||
+				(entries[ii]->type == SEARCH_ENGINE_QUEUE_COMMAND_LOAD)) {
+			entries[ii]->engine = engine;
+			arguments[prepareLength] = (void *)entries[ii];
+			prepareLength++;
+		}
 	}
-	else {
-		strcpy(buffer, localString);
+
+	searchExecutor_execute(&engine->executor, queue_prepareEntry, arguments,
+			prepareLength);
+
+	free(arguments);
+
+	// execute the commands in order, which defers the indexing of the added
+	// containers to the pipeline, then index the batch
+
+	for(ii = 0; ii < entryLength; ii++) {
+		queue_executeEntry(engine, entries[ii]);
 	}
 
-	if(isPut) {
-		searchIndex_putString(searchIndex, indexType, buffer, uid);
+	pipeline_flush(engine);
+
+	mutex_lock(&engine->queueMutex);
+
+	engine->queueExecutedCount += entryLength;
+
+	mutex_unlock(&engine->queueMutex);
+
+	return 0;
+}
+
+// pipeline functions
+
+static int pipeline_addJob(SearchEngine *engine, Container *container,
+		char *domainKey)
+{
+	SearchEngineIndexJob *job = NULL;
+
+	mutex_lock(&engine->pipeline.mutex);
+
+	if(engine->pipeline.jobs == NULL) {
+		engine->pipeline.jobLength = SEARCH_ENGINE_QUEUE_BATCH_LENGTH;
+		engine->pipeline.jobs = (SearchEngineIndexJob *)malloc(
+				sizeof(SearchEngineIndexJob) * engine->pipeline.jobLength);
 	}
-	else {
-		searchIndex_removeString(searchIndex, indexType, buffer, uid);
+	else if(engine->pipeline.jobRef >= engine->pipeline.jobLength) {
+		engine->pipeline.jobLength *= 2;
+		engine->pipeline.jobs = (SearchEngineIndexJob *)realloc(
+				engine->pipeline.jobs,
+				(sizeof(SearchEngineIndexJob) * engine->pipeline.jobLength));
 	}
 
-	free(buffer);
+	job = &(engine->pipeline.jobs[engine->pipeline.jobRef]);
 
-	// cleanup
+	memset(job, 0, (int)(sizeof(SearchEngineIndexJob)));
 
-	free(localString);
+	job->uid = container_getUid(container);
+	job->domainKey = domainKey;
+	job->engine = (void *)engine;
+	job->container = container;
+
+	engine->pipeline.jobRef += 1;
+
+	mutex_unlock(&engine->pipeline.mutex);
 
 	return 0;
 }
 
-static int index_updateTokenizedString(SearchEngine *engine, aboolean isPut,
-		SearchIndex *searchIndex, IndexRegistryIndex *indexType, char *string,
-		int stringLength, int uid)
+static aboolean pipeline_dropJob(SearchEngine *engine, Container *container)
 {
+	aboolean result = afalse;
 	int ii = 0;
-	int length = 0;
-	int tokenCount = 0;
-	int resultLength = 0;
-	int minStringLength = 0;
-	int maxStringLength = 0;
-	int delimitersLength = 0;
-	int tokenResultLength = 0;
-	int *tokenLengths = NULL;
-	char *token = NULL;
-	char *delimiters = NULL;
-	char *localString = NULL;
-	char *excludedWord = NULL;
-	char **tokenList = NULL;
 
-	// determine if this index allows this type of indexing
+	SearchEngineIndexJob *job = NULL;
 
-	if((indexType->settings.isOverrideIndexing) &&
-			(!indexType->settings.isIndexTokenizedString)) {
-		return 0;
-	}
+	mutex_lock(&engine->pipeline.mutex);
 
-	// check to see if the string has a vowel or a alphabetic character
+	for(ii = 0; ii < engine->pipeline.jobRef; ii++) {
+		job = &(engine->pipeline.jobs[ii]);
 
-	if((!cstring_containsVowel(string, stringLength)) ||
-			(!cstring_containsAlphabetic(string, stringLength))) {
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"update-tokenized-string { #%i->'%s' } string contains no "
-				"alphas or vowels", uid, indexType->key);
-		return 0;
+		if(job->container != container) {
+			continue;
+		}
+
+		// the postings of a job are only built by a flush
+
+		free(job->domainKey);
+
+		engine->pipeline.jobRef -= 1;
+
+		if(ii < engine->pipeline.jobRef) {
+			memmove(job, &(engine->pipeline.jobs[(ii + 1)]),
+					(sizeof(SearchEngineIndexJob) *
+					 (engine->pipeline.jobRef - ii)));
+		}
+
+		result = atrue;
+		break;
 	}
 
-	// determine string length thresholds
+	mutex_unlock(&engine->pipeline.mutex);
 
-	if(indexType->settings.isOverrideStringLengths) {
-		minStringLength = indexType->settings.minStringLength;
-		maxStringLength = indexType->settings.maxStringLength;
+	return result;
+}
+
+static void pipeline_addPosting(SearchEngineIndexJob *job,
+		SearchEnginePostingTypes type, IndexRegistryIndex *indexType,
+		char *token, int tokenLength, int value)
+{
+	SearchEnginePosting *posting = NULL;
+
+	if(job->postings == NULL) {
+		job->postingLength = 16;
+		job->postings = (SearchEnginePosting *)malloc(
+				sizeof(SearchEnginePosting) * job->postingLength);
 	}
-	else {
-		minStringLength = engine->settings.minStringLength;
-		maxStringLength = engine->settings.maxStringLength;
+	else if(job->postingRef >= job->postingLength) {
+		job->postingLength *= 2;
+		job->postings = (SearchEnginePosting *)realloc(job->postings,
+				(sizeof(SearchEnginePosting) * job->postingLength));
 	}
 
-	// determine string delimiters
+	posting = &(job->postings[job->postingRef]);
 
-	if(indexType->settings.isOverrideDelimiters) {
-		delimiters = indexType->settings.delimiters;
-		delimitersLength = indexType->settings.delimitersLength;
+	posting->type = type;
+	posting->value = value;
+	posting->tokenLength = tokenLength;
+	posting->indexType = indexType;
+
+	if(token != NULL) {
+		posting->token = strndup(token, tokenLength);
 	}
 	else {
-		delimiters = engine->settings.delimiters;
-		delimitersLength = engine->settings.delimitersLength;
+		posting->token = NULL;
 	}
 
-	// tokenize string
+	job->postingRef += 1;
+}
 
-	if(strtotokens(string,
-				stringLength,
-				delimiters,
-				delimitersLength,
-				minStringLength,
-				&tokenList,
-				&tokenLengths,
-				&tokenCount) < 0) {
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"update-tokenized-string { #%i->'%s' } tokenization failed",
-				uid, indexType->key);
-		return -1;
-	}
+static void pipeline_addGeoCoordPosting(SearchEngineIndexJob *job,
+		IndexRegistryIndex *indexType, double latitude, double longitude)
+{
+	SearchEnginePosting *posting = NULL;
 
-	if((tokenList == NULL) || (tokenLengths == NULL) || (tokenCount < 1)) {
-		if(tokenLengths != NULL) {
-			free(tokenLengths);
-		}
+	pipeline_addPosting(job, SEARCH_ENGINE_POSTING_TYPE_GEO_COORD, indexType,
+			NULL, 0, 0);
 
-		if(tokenList != NULL) {
-			for(ii = 0; ii < tokenCount; ii++) {
-				if(tokenList[ii] != NULL) {
-					free(tokenList[ii]);
-				}
-			}
+	posting = &(job->postings[(job->postingRef - 1)]);
 
-			free(tokenList);
-		}
+	posting->latitude = latitude;
+	posting->longitude = longitude;
+}
 
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"update-tokenized-string { #%i->'%s' } tokenization "
-				"returned no results", uid, indexType->key);
+static void pipeline_buildJob(void *argument)
+{
+	SearchEngine *engine = NULL;
+	SearchEngineIndexJob *job = NULL;
 
-		return -1;
+	job = (SearchEngineIndexJob *)argument;
+	engine = (SearchEngine *)job->engine;
+
+	if(job->searchIndex == NULL) {
+		return;
 	}
 
-	// iterate token list & update indexes
+	if(container_lock(job->container) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to obtain container read lock for indexing");
+		return;
+	}
 
-	for(ii = 0; ii < tokenCount; ii++) {
-		if(tokenList[ii] == NULL) {
-			continue;
-		}
+	if(container_updateIndexes(engine, atrue, NULL, job->container,
+				job) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to add indexes for container #%i", job->uid);
+	}
 
-		localString = tokenList[ii];
-		length = tokenLengths[ii];
-		resultLength = 0;
+	container_unlock(job->container);
+}
 
-		if(length < minStringLength) {
-			free(localString);
-			continue;
-		}
+static void pipeline_applyShard(void *argument)
+{
+	int ii = 0;
+	int nn = 0;
 
-		if(searchEngineCommon_normalizeString(localString, length,
-					&resultLength) < 0) {
-			free(localString);
-			continue;
-		}
+	SearchEngine *engine = NULL;
+	SearchEngineIndexJob *job = NULL;
+	SearchEnginePosting *posting = NULL;
+	SearchEnginePipelineShard *shard = NULL;
+	DocValues *docValues = NULL;
 
-		length = resultLength;
+	shard = (SearchEnginePipelineShard *)argument;
+	engine = shard->engine;
 
-		if(length < minStringLength) {
-			free(localString);
+	/*
+	 * note: each index belongs to exactly one shard, so the postings of an
+	 * index are applied by a single task, in the order of the batch
+	 */
+
+	for(ii = 0; ii < engine->pipeline.jobRef; ii++) {
+		job = &(engine->pipeline.jobs[ii]);
+
+		if(job->searchIndex == NULL) {
 			continue;
 		}
 
-		if((cstring_containsVowel(localString, length)) ||
-				(cstring_containsAlphabetic(localString, length))) {
-			if(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) {
-				if((token = esa_stemToken(&engine->esa, localString,
-								length, &tokenResultLength)) == NULL) {
-					free(localString);
-					continue;
-				}
-
-				if(tokenResultLength > maxStringLength) {
-					free(token);
-					free(localString);
-					continue;
-				}
+		for(nn = 0; nn < job->postingRef; nn++) {
+			posting = &(job->postings[nn]);
 
-				length = tokenResultLength;
-			}
-			else {
-				token = strndup(localString, length);
+			if(((unsigned int)posting->indexType->uid %
+						(unsigned int)shard->shardLength) !=
+					(unsigned int)shard->shardRef) {
+				continue;
 			}
 
-			if(indexType->settings.isOverrideExcludedWords) {
-				if(bptree_get(indexType->settings.excludedWords, token,
-							length, ((void *)&excludedWord)) == 0) {
-					free(token);
-					free(localString);
-					continue;
-				}
-			}
-			else {
-				if(bptree_get(&engine->excludedWords, token, length,
-							((void *)&excludedWord)) == 0) {
-					free(token);
-					free(localString);
-					continue;
-				}
-			}
-		}
-		else {
-			token = strndup(localString, length);
-		}
+			switch(posting->type) {
+				case SEARCH_ENGINE_POSTING_TYPE_STRING:
+					searchIndex_putString(job->searchIndex,
+							posting->indexType, posting->token, job->uid);
+					break;
 
-		if(isPut) {
-			searchIndex_putString(searchIndex, indexType, token, uid);
-		}
-		else {
-			searchIndex_removeString(searchIndex, indexType, token, uid);
-		}
+				case SEARCH_ENGINE_POSTING_TYPE_INTEGER:
+					searchIndex_putInteger(job->searchIndex,
+							posting->indexType, posting->value, job->uid);
+					break;
 
-		free(token);
-		free(tokenList[ii]);
-	}
+				case SEARCH_ENGINE_POSTING_TYPE_GEO_COORD:
+					searchIndex_putGeoCoord(job->searchIndex,
+							posting->indexType, posting->latitude,
+							posting->longitude, job->uid);
+					break;
 
-	free(tokenList);
-	free(tokenLengths);
+				case SEARCH_ENGINE_POSTING_TYPE_DOC_VALUES:
+					if((docValues = index_getDocValues(engine,
+									posting->indexType->key,
+									posting->indexType->keyLength,
+									atrue)) != NULL) {
+						container_updateDocValues(engine, atrue,
+								posting->indexType, docValues,
+								job->container, posting->token,
+								posting->tokenLength);
+					}
+					break;
 
-	return 0;
+				case SEARCH_ENGINE_POSTING_TYPE_ERROR:
+				default:
+					break;
+			}
+		}
+	}
 }
 
-static int index_updateString(SearchEngine *engine, aboolean isPut,
-		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
-		ContainerIterator *iterator, int uid)
+static int pipeline_flush(SearchEngine *engine)
 {
-	aboolean isIndexFullString = afalse;
-	aboolean isIndexTokenizedString = afalse;
-	int stringLength = 0;
-	int minStringLength = 0;
-	char *string = NULL;
+	int ii = 0;
+	int nn = 0;
+	int jobLength = 0;
+	int shardLength = 0;
+	double timer = 0.0;
+	void **arguments = NULL;
 
-	// determine string length thresholds
+	SearchEngineIndexJob *job = NULL;
+	SearchEnginePipelineShard *shards = NULL;
 
-	if(indexType->settings.isOverrideStringLengths) {
-		minStringLength = indexType->settings.minStringLength;
+	mutex_lock(&engine->pipeline.mutex);
+
+	if((jobLength = engine->pipeline.jobRef) < 1) {
+		mutex_unlock(&engine->pipeline.mutex);
+		return 0;
 	}
-	else {
-		minStringLength = engine->settings.minStringLength;
-	}
-
-	// setup local string value
 
-	if(iterator->entity.type == CONTAINER_TYPE_STRING) {
-		// copy the string from the iterator entity
+	timer = time_getTimeMus();
 
-		if((stringLength = iterator->entity.valueLength) < minStringLength) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-string { #%i->'%s' } length %i invalid",
-					uid, indexType->key, stringLength);
-			return -1;
-		}
+	// hold the engine lock until the postings are applied, so that the
+	// domains of the jobs remain in place
 
-		string = strndup(iterator->entity.sValue, stringLength);
+	if(spinlock_readLock(&engine->lock) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to obtain spinlock for domain "
+				"lookup from %s()", __FUNCTION__);
 	}
 	else {
-		// perform type conversion using the container API
-
-		if((string = container_getString(iterator->container,
-						iterator->entity.name,
-						iterator->entity.nameLength,
-						&stringLength)) == NULL) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-string { #%i->'%s' } does not exist",
-					uid, indexType->key);
-			return -1;
-		}
-
-		if(stringLength < minStringLength) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-string { #%i->'%s' } length %i invalid",
-					uid, indexType->key, stringLength);
-			free(string);
-			return -1;
+		for(ii = 0; ii < jobLength; ii++) {
+			job = &(engine->pipeline.jobs[ii]);
+
+			if((bptree_get(&engine->indexes,
+							job->domainKey,
+							strlen(job->domainKey),
+							((void *)&job->searchIndex)) < 0) ||
+					(job->searchIndex == NULL)) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"unable to locate domain '%s' to add container #%i",
+						job->domainKey, job->uid);
+				job->searchIndex = NULL;
+			}
 		}
-	}
-
-	// determine indexing logic
 
-	if(indexType->settings.isOverrideIndexing) {
-		isIndexFullString = indexType->settings.isIndexFullString;
-		isIndexTokenizedString = indexType->settings.isIndexTokenizedString;
-	}
-	else {
-		isIndexFullString = atrue;
+		shardLength = (engine->executor.threadPoolSize + 1);
 
-		if(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY) {
-			isIndexTokenizedString = afalse;
+		if(jobLength > shardLength) {
+			arguments = (void **)malloc(sizeof(void *) * jobLength);
 		}
 		else {
-			isIndexTokenizedString = atrue;
-		}
-	}
-
-	// update the full-length string
-
-	if(isIndexFullString) {
-		if(index_updateFullString(engine, isPut, searchIndex, indexType, string,
-					stringLength, uid) < 0) {
-			free(string);
-			return -1;
+			arguments = (void **)malloc(sizeof(void *) * shardLength);
 		}
-	}
 
-	// perform wildcard indexing of string tokens
+		// tokenize the containers in parallel
 
-	if(isIndexTokenizedString) {
-		if(index_updateTokenizedString(engine, isPut, searchIndex, indexType,
-					string, stringLength, uid) < 0) {
-			free(string);
-			return -1;
+		for(ii = 0; ii < jobLength; ii++) {
+			arguments[ii] = (void *)&(engine->pipeline.jobs[ii]);
 		}
-	}
-
-	// cleanup
-
-	free(string);
-
-	return 0;
-}
 
-static int index_updateInteger(SearchEngine *engine, aboolean isPut,
-		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
-		ContainerIterator *iterator, int uid)
-{
-	int iValue = 0;
+		searchExecutor_execute(&engine->executor, pipeline_buildJob,
+				arguments, jobLength);
 
-	// setup local integer value
+		// apply the postings in parallel, one task per shard of the indexes
 
-	if(iterator->entity.type == CONTAINER_TYPE_INTEGER) {
-		iValue = iterator->entity.iValue;
-	}
-	else {
-		// perform latitude & longitude decimal conversion
+		shards = (SearchEnginePipelineShard *)malloc(
+				sizeof(SearchEnginePipelineShard) * shardLength);
 
-		if(((!strcasecmp(indexType->key, "latitude")) ||
-					(!strcasecmp(indexType->key, "longitude"))) &&
-				(iterator->entity.type == CONTAINER_TYPE_DOUBLE)) {
-			iValue = (iterator->entity.dValue * GEOCOORD_INTEGER_CONVERSION);
+		for(ii = 0; ii < shardLength; ii++) {
+			shards[ii].shardRef = ii;
+			shards[ii].shardLength = shardLength;
+			shards[ii].engine = engine;
+			arguments[ii] = (void *)&(shards[ii]);
 		}
-		else {
-			// perform type conversion using the container API
 
-			iValue = container_getInteger(iterator->container,
-					iterator->entity.name, iterator->entity.nameLength);
-		}
-	}
+		searchExecutor_execute(&engine->executor, pipeline_applyShard,
+				arguments, shardLength);
 
-	// update the range index
+		spinlock_readUnlock(&engine->lock);
 
-	if(isPut) {
-		searchIndex_putInteger(searchIndex, indexType, iValue, uid);
-	}
-	else {
-		searchIndex_removeInteger(searchIndex, indexType, iValue, uid);
+		free(shards);
+		free(arguments);
 	}
 
-	return 0;
-}
-
-static int index_reindexContainers(SearchEngine *engine,
-		IndexRegistryIndex *indexType)
-{
-	int keyLength = 0;
-	int counter = 0;
-	int domainKeyLength = 0;
-	double timer = 0.0;
-	char key[128];
-	char *domainKey = NULL;
-
-	Container *container = NULL;
-	SearchIndex *searchIndex = NULL;
-
-	// start a timer
-
-	timer = time_getTimeMus();
-
-	// iterate the managed containers index & write them to a file
-
-	log_logf(engine->log, LOG_LEVEL_INFO,
-			"reindexing search engine containers for '%s'",
-			indexType->key);
-
-	keyLength = 1;
-	memset(key, 0, (int)(sizeof(key)));
-
-	while((managedIndex_getNext(&engine->containers, key, keyLength,
-					((void *)&container)) == 0) &&
-			(container != NULL)) {
-		searchEngineCommon_buildUidKey(container_getUid(container), key,
-				&keyLength);
-
-		if(container_lock(container) < 0) {
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to obtain container read lock for reindex");
-			continue;
-		}
-
-		if(!container_exists(container, indexType->key,
-					indexType->keyLength)) {
-			container_unlock(container);
-			continue;
-		}
-
-		domainKey = container_getString(container, SEARCHD_DOMAIN_KEY,
-				SEARCHD_DOMAIN_KEY_LENGTH, &domainKeyLength);
-
-		if((domainKey == NULL) || (domainKeyLength < 1)) {
-			if(domainKey != NULL) {
-				free(domainKey);
-			}
-
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to locate '%s' in container #%i",
-					SEARCHD_DOMAIN_KEY, container_getUid(container));
-
-			container_unlock(container);
+	// cleanup
 
-			continue;
-		}
+	for(ii = 0; ii < jobLength; ii++) {
+		job = &(engine->pipeline.jobs[ii]);
 
-		if(spinlock_readLock(&engine->lock) < 0) {
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to obtain spinlock for domain lookup from %s()",
-					__FUNCTION__);
-		}
-		else {
-			if((bptree_get(&engine->indexes, domainKey, domainKeyLength,
-							((void *)&searchIndex)) == 0) &&
-					(searchIndex != NULL)) {
-				if(container_reindex(engine, indexType, searchIndex,
-							container) < 0) {
-					log_logf(engine->log, LOG_LEVEL_ERROR,
-							"failed to reindex container #%i for '%s'",
-							container_getUid(container), indexType->key);
+		if(job->postings != NULL) {
+			for(nn = 0; nn < job->postingRef; nn++) {
+				if(job->postings[nn].token != NULL) {
+					free(job->postings[nn].token);
 				}
-				else {
-					log_logf(engine->log, LOG_LEVEL_DEBUG,
-							"reindexed container #%i for '%s' on "
-							"domain '%s' ('%s')",
-							container_getUid(container), indexType->key,
-							searchIndex->key, searchIndex->name);
-				}
-			}
-			else {
-				log_logf(engine->log, LOG_LEVEL_ERROR,
-						"unable to locate domain '%s' to reindex container #%i",
-						domainKey, container_getUid(container));
 			}
 
-			spinlock_readUnlock(&engine->lock);
+			free(job->postings);
 		}
 
-		container_unlock(container);
+		free(job->domainKey);
+	}
 
-		free(domainKey);
+	engine->pipeline.jobRef = 0;
+	engine->pipeline.jobsApplied += jobLength;
+	engine->pipeline.flushesApplied += 1;
 
-		counter++;
-	}
+	mutex_unlock(&engine->pipeline.mutex);
 
-	log_logf(engine->log, LOG_LEVEL_INFO,
-			"reindexed %i search engine containers for '%s' in %0.6f seconds",
-			counter, indexType->key, time_getElapsedMusInSeconds(timer));
+	log_logf(engine->log, LOG_LEVEL_DEBUG,
+			"indexed %i containers across %i shards in %0.6f seconds",
+			jobLength, shardLength, time_getElapsedMusInSeconds(timer));
 
 	return 0;
 }
 
-static int index_checkFullString(SearchEngine *engine,
+// index functions
+
+static int index_updateFullString(SearchEngine *engine, aboolean isPut,
 		SearchIndex *searchIndex, IndexRegistryIndex *indexType, char *string,
-		int stringLength, int uid)
+		int stringLength, int uid, SearchEngineIndexJob *job)
 {
-	int rc = 0;
 	int length = 0;
 	int resultLength = 0;
-	int resultSetLength = 0;
 	int allocatedLength = 0;
 	int minStringLength = 0;
 	int maxStringLength = 0;
-	int *resultSet = NULL;
 	char *buffer = NULL;
 	char *localString = NULL;
 
@@ -1050,7 +1155,7 @@ static int index_checkFullString(SearchEngine *engine,
 	if((dataType = searchEngineCommon_determineDataType(localString,
 					length)) == SEARCH_ENGINE_DATA_TYPE_ERROR) {
 		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"check-full-string { #%i->'%s' } unknown data type",
+				"update-full-string { #%i->'%s' } unknown data type",
 				uid, indexType->key);
 		free(localString);
 		return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_DETERMINE_DATA_TYPE;
@@ -1063,7 +1168,7 @@ static int index_checkFullString(SearchEngine *engine,
 		if(searchEngineCommon_normalizeString(localString, length,
 					&resultLength) < 0) {
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"check-full-string { #%i->'%s' } normalization failed",
+					"update-full-string { #%i->'%s' } normalization failed",
 					uid, indexType->key);
 			free(localString);
 			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_NORMALIZE_STRING;
@@ -1088,7 +1193,7 @@ static int index_checkFullString(SearchEngine *engine,
 	if(length < minStringLength) {
 		if(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) {
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"check-full-string { #%i->'%s' } unable to pad "
+					"update-full-string { #%i->'%s' } unable to pad "
 					"string '%s' for wildcard index",
 					uid, indexType->key, localString);
 			free(localString);
@@ -1108,7 +1213,7 @@ static int index_checkFullString(SearchEngine *engine,
 					minStringLength,
 					&resultLength) < 0) {
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"check-full-string { #%i->'%s' } pad string failed",
+					"update-full-string { #%i->'%s' } pad string failed",
 					uid, indexType->key);
 			free(localString);
 			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_PAD_STRING;
@@ -1119,13 +1224,13 @@ static int index_checkFullString(SearchEngine *engine,
 
 	if(length < minStringLength) {
 		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"check-full-string { #%i->'%s' } pad string fell short",
+				"update-full-string { #%i->'%s' } pad string fell short",
 				uid, indexType->key);
 		free(localString);
 		return -1;
 	}
 
-	// check the string in the search index for exact & user-key indexes
+	// update the string in the search index for exact & user-key indexes
 
 	buffer = (char *)malloc(sizeof(char) * (maxStringLength + 1));
 
@@ -1136,10 +1241,15 @@ static int index_checkFullString(SearchEngine *engine,
 		strcpy(buffer, localString);
 	}
 
-	if((resultSet = searchIndex_getString(searchIndex, indexType, buffer,
-					&resultSetLength)) != NULL) {
-		free(resultSet);
-		rc = 1;
+	if(job != NULL) {
+		pipeline_addPosting(job, SEARCH_ENGINE_POSTING_TYPE_STRING, indexType,
+				buffer, strlen(buffer), 0);
+	}
+	else if(isPut) {
+		searchIndex_putString(searchIndex, indexType, buffer, uid);
+	}
+	else {
+		searchIndex_removeString(searchIndex, indexType, buffer, uid);
 	}
 
 	free(buffer);
@@ -1148,24 +1258,213 @@ static int index_checkFullString(SearchEngine *engine,
 
 	free(localString);
 
-	return rc;
+	return 0;
 }
 
-static int index_checkIfStringExists(SearchEngine *engine,
-		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
-		ContainerIterator *iterator, int uid)
+static int index_updateTokenizedString(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType, char *string,
+		int stringLength, int uid, SearchEngineIndexJob *job)
 {
-	int rc = 0;
-	int stringLength = 0;
+	int ii = 0;
+	int length = 0;
+	int tokenCount = 0;
+	int resultLength = 0;
 	int minStringLength = 0;
-	char *string = NULL;
+	int maxStringLength = 0;
+	int delimitersLength = 0;
+	int tokenResultLength = 0;
+	int *tokenLengths = NULL;
+	char *token = NULL;
+	char *delimiters = NULL;
+	char *localString = NULL;
+	char *excludedWord = NULL;
+	char **tokenList = NULL;
 
-	// determine string length thresholds
+	// determine if this index allows this type of indexing
 
-	if(indexType->settings.isOverrideStringLengths) {
-		minStringLength = indexType->settings.minStringLength;
-	}
-	else {
+	if((indexType->settings.isOverrideIndexing) &&
+			(!indexType->settings.isIndexTokenizedString)) {
+		return 0;
+	}
+
+	// check to see if the string has a vowel or a alphabetic character
+
+	if((!cstring_containsVowel(string, stringLength)) ||
+			(!cstring_containsAlphabetic(string, stringLength))) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"update-tokenized-string { #%i->'%s' } string contains no "
+				"alphas or vowels", uid, indexType->key);
+		return 0;
+	}
+
+	// determine string length thresholds
+
+	if(indexType->settings.isOverrideStringLengths) {
+		minStringLength = indexType->settings.minStringLength;
+		maxStringLength = indexType->settings.maxStringLength;
+	}
+	else {
+		minStringLength = engine->settings.minStringLength;
+		maxStringLength = engine->settings.maxStringLength;
+	}
+
+	// determine string delimiters
+
+	if(indexType->settings.isOverrideDelimiters) {
+		delimiters = indexType->settings.delimiters;
+		delimitersLength = indexType->settings.delimitersLength;
+	}
+	else {
+		delimiters = engine->settings.delimiters;
+		delimitersLength = engine->settings.delimitersLength;
+	}
+
+	// tokenize string
+
+	if(strtotokens(string,
+				stringLength,
+				delimiters,
+				delimitersLength,
+				minStringLength,
+				&tokenList,
+				&tokenLengths,
+				&tokenCount) < 0) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"update-tokenized-string { #%i->'%s' } tokenization failed",
+				uid, indexType->key);
+		return -1;
+	}
+
+	if((tokenList == NULL) || (tokenLengths == NULL) || (tokenCount < 1)) {
+		if(tokenLengths != NULL) {
+			free(tokenLengths);
+		}
+
+		if(tokenList != NULL) {
+			for(ii = 0; ii < tokenCount; ii++) {
+				if(tokenList[ii] != NULL) {
+					free(tokenList[ii]);
+				}
+			}
+
+			free(tokenList);
+		}
+
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"update-tokenized-string { #%i->'%s' } tokenization "
+				"returned no results", uid, indexType->key);
+
+		return -1;
+	}
+
+	// iterate token list & update indexes
+
+	for(ii = 0; ii < tokenCount; ii++) {
+		if(tokenList[ii] == NULL) {
+			continue;
+		}
+
+		localString = tokenList[ii];
+		length = tokenLengths[ii];
+		resultLength = 0;
+
+		if(length < minStringLength) {
+			free(localString);
+			continue;
+		}
+
+		if(searchEngineCommon_normalizeString(localString, length,
+					&resultLength) < 0) {
+			free(localString);
+			continue;
+		}
+
+		length = resultLength;
+
+		if(length < minStringLength) {
+			free(localString);
+			continue;
+		}
+
+		if((cstring_containsVowel(localString, length)) ||
+				(cstring_containsAlphabetic(localString, length))) {
+			if(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) {
+				if((token = esa_stemToken(&engine->esa, localString,
+								length, &tokenResultLength)) == NULL) {
+					free(localString);
+					continue;
+				}
+
+				if(tokenResultLength > maxStringLength) {
+					free(token);
+					free(localString);
+					continue;
+				}
+
+				length = tokenResultLength;
+			}
+			else {
+				token = strndup(localString, length);
+			}
+
+			if(indexType->settings.isOverrideExcludedWords) {
+				if(bptree_get(indexType->settings.excludedWords, token,
+							length, ((void *)&excludedWord)) == 0) {
+					free(token);
+					free(localString);
+					continue;
+				}
+			}
+			else {
+				if(bptree_get(&engine->excludedWords, token, length,
+							((void *)&excludedWord)) == 0) {
+					free(token);
+					free(localString);
+					continue;
+				}
+			}
+		}
+		else {
+			token = strndup(localString, length);
+		}
+
+		if(job != NULL) {
+			pipeline_addPosting(job, SEARCH_ENGINE_POSTING_TYPE_STRING,
+					indexType, token, length, 0);
+		}
+		else if(isPut) {
+			searchIndex_putString(searchIndex, indexType, token, uid);
+		}
+		else {
+			searchIndex_removeString(searchIndex, indexType, token, uid);
+		}
+
+		free(token);
+		free(tokenList[ii]);
+	}
+
+	free(tokenList);
+	free(tokenLengths);
+
+	return 0;
+}
+
+static int index_updateString(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
+		ContainerIterator *iterator, int uid, SearchEngineIndexJob *job)
+{
+	aboolean isIndexFullString = afalse;
+	aboolean isIndexTokenizedString = afalse;
+	int stringLength = 0;
+	int minStringLength = 0;
+	char *string = NULL;
+
+	// determine string length thresholds
+
+	if(indexType->settings.isOverrideStringLengths) {
+		minStringLength = indexType->settings.minStringLength;
+	}
+	else {
 		minStringLength = engine->settings.minStringLength;
 	}
 
@@ -1176,7 +1475,7 @@ static int index_checkIfStringExists(SearchEngine *engine,
 
 		if((stringLength = iterator->entity.valueLength) < minStringLength) {
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"check-string { #%i->'%s' } length %i invalid",
+					"update-string { #%i->'%s' } length %i invalid",
 					uid, indexType->key, stringLength);
 			return -1;
 		}
@@ -1191,583 +1490,1958 @@ static int index_checkIfStringExists(SearchEngine *engine,
 						iterator->entity.nameLength,
 						&stringLength)) == NULL) {
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"check-string { #%i->'%s' } does not exist",
+					"update-string { #%i->'%s' } does not exist",
 					uid, indexType->key);
 			return -1;
 		}
 
 		if(stringLength < minStringLength) {
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"check-string { #%i->'%s' } length %i invalid",
+					"update-string { #%i->'%s' } length %i invalid",
 					uid, indexType->key, stringLength);
 			free(string);
 			return -1;
 		}
 	}
 
-	// check the full-length string
-
-	rc = index_checkFullString(engine, searchIndex, indexType,
-			string, stringLength, uid);
-
-	// cleanup
-
-	free(string);
-
-	return rc;
-}
-
-// container functions
-
-static int container_reindex(SearchEngine *engine,
-		IndexRegistryIndex *indexType, SearchIndex *searchIndex,
-		Container *container)
-{
-	int iValue = 0;
-	int stringLength = 0;
-	int minStringLength = 0;
-	char *string = NULL;
+	// determine indexing logic
 
-	if((indexType->type == INDEX_REGISTRY_TYPE_EXACT) ||
-			(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) ||
-			(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY)) {
-		// determine string length thresholds
+	if(indexType->settings.isOverrideIndexing) {
+		isIndexFullString = indexType->settings.isIndexFullString;
+		isIndexTokenizedString = indexType->settings.isIndexTokenizedString;
+	}
+	else {
+		isIndexFullString = atrue;
 
-		if(indexType->settings.isOverrideStringLengths) {
-			minStringLength = indexType->settings.minStringLength;
+		if(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY) {
+			isIndexTokenizedString = afalse;
 		}
 		else {
-			minStringLength = engine->settings.minStringLength;
+			isIndexTokenizedString = atrue;
 		}
+	}
 
-		// perform type conversion using the container API
-
-		if((string = container_getString(container, indexType->key,
-						indexType->keyLength, &stringLength)) == NULL) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-string { #%i->'%s' } does not exist",
-					container_getUid(container), indexType->key);
-			return -1;
-		}
+	// update the full-length string
 
-		if(stringLength < minStringLength) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"update-string { #%i->'%s' } length %i invalid",
-					container_getUid(container), indexType->key, stringLength);
+	if(isIndexFullString) {
+		if(index_updateFullString(engine, isPut, searchIndex, indexType, string,
+					stringLength, uid, job) < 0) {
 			free(string);
 			return -1;
 		}
+	}
 
-		// update the full-length string
+	// perform wildcard indexing of string tokens
 
-		if(index_updateFullString(engine, atrue, searchIndex, indexType, string,
-					stringLength, container_getUid(container)) < 0) {
+	if(isIndexTokenizedString) {
+		if(index_updateTokenizedString(engine, isPut, searchIndex, indexType,
+					string, stringLength, uid, job) < 0) {
 			free(string);
 			return -1;
 		}
+	}
 
-		// if a user-key index, update is complete
-
-		if(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY) {
-			free(string);
-			return 0;
-		}
+	// cleanup
 
-		// perform wildcard indexing of string tokens
+	free(string);
 
-		if(index_updateTokenizedString(engine, atrue, searchIndex, indexType,
-					string, stringLength, container_getUid(container)) < 0) {
-			free(string);
-			return -1;
-		}
+	return 0;
+}
 
-		// cleanup
+static int index_updateInteger(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
+		ContainerIterator *iterator, int uid, SearchEngineIndexJob *job)
+{
+	int iValue = 0;
 
-		free(string);
+	// setup local integer value
+
+	if(iterator->entity.type == CONTAINER_TYPE_INTEGER) {
+		iValue = iterator->entity.iValue;
 	}
-	else if(indexType->type == INDEX_REGISTRY_TYPE_RANGE) {
+	else {
 		// perform latitude & longitude decimal conversion
 
 		if(((!strcasecmp(indexType->key, "latitude")) ||
 					(!strcasecmp(indexType->key, "longitude"))) &&
-				(container_getType(container, indexType->key,
-								   indexType->keyLength) ==
-				 CONTAINER_TYPE_DOUBLE)) {
-			iValue = (container_getDouble(container, indexType->key,
-						indexType->keyLength) *
-					GEOCOORD_INTEGER_CONVERSION);
+				(iterator->entity.type == CONTAINER_TYPE_DOUBLE)) {
+			iValue = (iterator->entity.dValue * GEOCOORD_INTEGER_CONVERSION);
 		}
 		else {
 			// perform type conversion using the container API
 
-			iValue = container_getInteger(container, indexType->key,
-					indexType->keyLength);
+			iValue = container_getInteger(iterator->container,
+					iterator->entity.name, iterator->entity.nameLength);
 		}
+	}
 
-		// update the range index
+	// update the range index
 
-		searchIndex_putInteger(searchIndex, indexType, iValue,
-				container_getUid(container));
+	if(job != NULL) {
+		pipeline_addPosting(job, SEARCH_ENGINE_POSTING_TYPE_INTEGER, indexType,
+				NULL, 0, iValue);
+	}
+	else if(isPut) {
+		searchIndex_putInteger(searchIndex, indexType, iValue, uid);
+	}
+	else {
+		searchIndex_removeInteger(searchIndex, indexType, iValue, uid);
 	}
 
 	return 0;
 }
 
-static int container_checkUserKeyIndexes(SearchEngine *engine,
-		SearchIndex *searchIndex, Container *container)
+static int index_updateGeoCoord(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
+		Container *container, char *latitudeName, int latitudeNameLength,
+		char *longitudeName, int longitudeNameLength,
+		SearchEngineIndexJob *job)
 {
-	int rc = 0;
-	int result = 0;
-	int indexNameLength = 0;
-	int indexNameResultLength = 0;
-	char *indexName = NULL;
-
-	ContainerIterator iterator;
-	IndexRegistryIndex *indexType = NULL;
+	int uid = 0;
+	double latitude = 0.0;
+	double longitude = 0.0;
 
-	if(containerIterator_init(container, &iterator) < 0) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"failed to initialize iterator on container #%i",
-				container_getUid(container));
+	if((!container_exists(container, latitudeName, latitudeNameLength)) ||
+			(!container_exists(container, longitudeName,
+							   longitudeNameLength))) {
 		return -1;
 	}
 
-	while((rc = containerIterator_next(&iterator)) == CONTAINER_ITERATOR_OK) {
-		if(iterator.entity.nameLength < 1) {
+	uid = container_getUid(container);
+
+	latitude = container_getDouble(container, latitudeName,
+			latitudeNameLength);
+	longitude = container_getDouble(container, longitudeName,
+			longitudeNameLength);
+
+	if((latitude < -90.0) || (latitude > 90.0) ||
+			(longitude < -180.0) || (longitude > 180.0)) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"update-geocoord { #%i->'%s' } (%0.6f, %0.6f) invalid",
+				uid, latitudeName, latitude, longitude);
+		return 0;
+	}
+
+	// update the geo index
+
+	if(job != NULL) {
+		pipeline_addGeoCoordPosting(job, indexType, latitude, longitude);
+	}
+	else if(isPut) {
+		searchIndex_putGeoCoord(searchIndex, indexType, latitude, longitude,
+				uid);
+	}
+	else {
+		searchIndex_removeGeoCoord(searchIndex, indexType, latitude,
+				longitude, uid);
+	}
+
+	return 0;
+}
+
+static int index_updateGeoCoords(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
+		Container *container, SearchEngineIndexJob *job)
+{
+	int ii = 0;
+	int failCounter = 0;
+	int latitudeNameLength = 0;
+	int longitudeNameLength = 0;
+	char latitudeName[128];
+	char longitudeName[128];
+
+	// locate the coordinate pairs in the same manner as the distance sort
+
+	index_updateGeoCoord(engine, isPut, searchIndex, indexType, container,
+			"latitude", 8, "longitude", 9, job);
+
+	for(ii = 0, failCounter = 0; ((ii < 1000) && (failCounter < 3)); ii++) {
+		latitudeNameLength = snprintf(latitudeName,
+				((int)sizeof(latitudeName) - 1), "latitude%03i", ii);
+		longitudeNameLength = snprintf(longitudeName,
+				((int)sizeof(longitudeName) - 1), "longitude%03i", ii);
+
+		if(index_updateGeoCoord(engine, isPut, searchIndex, indexType,
+					container, latitudeName, latitudeNameLength,
+					longitudeName, longitudeNameLength, job) < 0) {
+			failCounter++;
+		}
+	}
+
+	return 0;
+}
+
+static int index_reindexContainers(SearchEngine *engine,
+		IndexRegistryIndex *indexType)
+{
+	int keyLength = 0;
+	int counter = 0;
+	int domainKeyLength = 0;
+	double timer = 0.0;
+	char key[128];
+	char *domainKey = NULL;
+
+	Container *container = NULL;
+	SearchIndex *searchIndex = NULL;
+
+	// start a timer
+
+	timer = time_getTimeMus();
+
+	// iterate the managed containers index & write them to a file
+
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"reindexing search engine containers for '%s'",
+			indexType->key);
+
+	keyLength = 1;
+	memset(key, 0, (int)(sizeof(key)));
+
+	while((managedIndex_getNext(&engine->containers, key, keyLength,
+					((void *)&container)) == 0) &&
+			(container != NULL)) {
+		searchEngineCommon_buildUidKey(container_getUid(container), key,
+				&keyLength);
+
+		if(container_lock(container) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to obtain container read lock for reindex");
 			continue;
 		}
 
-		indexName = strndup(iterator.entity.name, iterator.entity.nameLength);
-		indexNameLength = iterator.entity.nameLength;
+		if((indexType->type != INDEX_REGISTRY_TYPE_GEO) &&
+				(!container_exists(container, indexType->key,
+								   indexType->keyLength))) {
+			container_unlock(container);
+			continue;
+		}
+
+		domainKey = container_getString(container, SEARCHD_DOMAIN_KEY,
+				SEARCHD_DOMAIN_KEY_LENGTH, &domainKeyLength);
+
+		if((domainKey == NULL) || (domainKeyLength < 1)) {
+			if(domainKey != NULL) {
+				free(domainKey);
+			}
+
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to locate '%s' in container #%i",
+					SEARCHD_DOMAIN_KEY, container_getUid(container));
+
+			container_unlock(container);
 
-		if((searchEngineCommon_buildIndexString(indexName, indexNameLength,
-						&indexNameResultLength) < 0) ||
-				(indexNameResultLength < 1)) {
-			free(indexName);
 			continue;
 		}
 
-		if((indexType = indexRegistry_get(&engine->registry,
-						indexName)) == NULL) {
-			free(indexName);
+		if(spinlock_readLock(&engine->lock) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to obtain spinlock for domain lookup from %s()",
+					__FUNCTION__);
+		}
+		else {
+			if((bptree_get(&engine->indexes, domainKey, domainKeyLength,
+							((void *)&searchIndex)) == 0) &&
+					(searchIndex != NULL)) {
+				if(container_reindex(engine, indexType, searchIndex,
+							container) < 0) {
+					log_logf(engine->log, LOG_LEVEL_ERROR,
+							"failed to reindex container #%i for '%s'",
+							container_getUid(container), indexType->key);
+				}
+				else {
+					log_logf(engine->log, LOG_LEVEL_DEBUG,
+							"reindexed container #%i for '%s' on "
+							"domain '%s' ('%s')",
+							container_getUid(container), indexType->key,
+							searchIndex->key, searchIndex->name);
+				}
+			}
+			else {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"unable to locate domain '%s' to reindex container #%i",
+						domainKey, container_getUid(container));
+			}
+
+			spinlock_readUnlock(&engine->lock);
+		}
+
+		container_unlock(container);
+
+		free(domainKey);
+
+		counter++;
+	}
+
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"reindexed %i search engine containers for '%s' in %0.6f seconds",
+			counter, indexType->key, time_getElapsedMusInSeconds(timer));
+
+	return 0;
+}
+
+static DocValues *index_getDocValues(SearchEngine *engine, char *key,
+		int keyLength, aboolean isCreate)
+{
+	DocValues *result = NULL;
+
+	/*
+	 * note: columns are never removed until the engine is freed, so callers
+	 * may keep the returned pointer without holding the mutex
+	 */
+
+	// the shards share the router's columns, which are keyed by UID
+
+	if(engine->router != NULL) {
+		engine = engine->router;
+	}
+
+	mutex_lock(&engine->docValuesMutex);
+
+	if((bptree_get(&engine->docValues, key, keyLength,
+					((void *)&result)) < 0) &&
+			(isCreate)) {
+		if((result = docValues_new()) != NULL) {
+			if(bptree_put(&engine->docValues, key, keyLength,
+						(void *)result) < 0) {
+				docValues_freePtr(result);
+				result = NULL;
+			}
+		}
+	}
+
+	mutex_unlock(&engine->docValuesMutex);
+
+	return result;
+}
+
+static int index_fillDocValues(SearchEngine *engine,
+		IndexRegistryIndex *indexType, DocValues *docValues)
+{
+	int keyLength = 0;
+	int counter = 0;
+	double timer = 0.0;
+	char key[128];
+
+	Container *container = NULL;
+
+	// start a timer
+
+	timer = time_getTimeMus();
+
+	// iterate the managed containers index & fill the column
+
+	keyLength = 1;
+	memset(key, 0, (int)(sizeof(key)));
+
+	while((managedIndex_getNext(&engine->containers, key, keyLength,
+					((void *)&container)) == 0) &&
+			(container != NULL)) {
+		searchEngineCommon_buildUidKey(container_getUid(container), key,
+				&keyLength);
+
+		if(container_lock(container) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to obtain container read lock for doc values");
 			continue;
 		}
 
-		if(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY) {
-			if(index_checkIfStringExists(engine, searchIndex, indexType,
-						&iterator, container_getUid(container)) == 1) {
-				result = 1;
-			}
-		}
+		if(container_exists(container, indexType->key,
+					indexType->keyLength)) {
+			container_updateDocValues(engine, atrue, indexType, docValues,
+					container, indexType->key, indexType->keyLength);
+			counter++;
+		}
+
+		container_unlock(container);
+	}
+
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"filled doc values from %i search engine containers for '%s' "
+			"in %0.6f seconds",
+			counter, indexType->key, time_getElapsedMusInSeconds(timer));
+
+	return 0;
+}
+
+static int index_checkFullString(SearchEngine *engine,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType, char *string,
+		int stringLength, int uid)
+{
+	int rc = 0;
+	int length = 0;
+	int resultLength = 0;
+	int resultSetLength = 0;
+	int allocatedLength = 0;
+	int minStringLength = 0;
+	int maxStringLength = 0;
+	int *resultSet = NULL;
+	char *buffer = NULL;
+	char *localString = NULL;
+
+	SearchEngineDataTypes dataType = SEARCH_ENGINE_DATA_TYPE_ERROR;
+
+	// determine if this index allows this type of indexing
+
+	if((indexType->settings.isOverrideIndexing) &&
+			(!indexType->settings.isIndexFullString)) {
+		return 0;
+	}
+
+	length = stringLength;
+	allocatedLength = stringLength;
+	localString = strndup(string, length);
+
+	// determine the data type
+
+	if((dataType = searchEngineCommon_determineDataType(localString,
+					length)) == SEARCH_ENGINE_DATA_TYPE_ERROR) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"check-full-string { #%i->'%s' } unknown data type",
+				uid, indexType->key);
+		free(localString);
+		return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_DETERMINE_DATA_TYPE;
+	}
+
+	// perform normalization
+
+	if((dataType == SEARCH_ENGINE_DATA_TYPE_STRING) ||
+			(dataType == SEARCH_ENGINE_DATA_TYPE_BINARY)) {
+		if(searchEngineCommon_normalizeString(localString, length,
+					&resultLength) < 0) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"check-full-string { #%i->'%s' } normalization failed",
+					uid, indexType->key);
+			free(localString);
+			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_NORMALIZE_STRING;
+		}
+
+		length = resultLength;
+	}
+
+	// determine string length thresholds
+
+	if(indexType->settings.isOverrideStringLengths) {
+		minStringLength = indexType->settings.minStringLength;
+		maxStringLength = indexType->settings.maxStringLength;
+	}
+	else {
+		minStringLength = engine->settings.minStringLength;
+		maxStringLength = engine->settings.maxStringLength;
+	}
+
+	// pad a short string
+
+	if(length < minStringLength) {
+		if(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"check-full-string { #%i->'%s' } unable to pad "
+					"string '%s' for wildcard index",
+					uid, indexType->key, localString);
+			free(localString);
+			return 0;
+		}
+
+		if(allocatedLength < (minStringLength * 2)) {
+			allocatedLength = (minStringLength * 2);
+
+			localString = (char *)realloc(localString,
+					(sizeof(char) * allocatedLength));
+		}
+
+		if(searchEngineCommong_padString(localString,
+					length,
+					allocatedLength,
+					minStringLength,
+					&resultLength) < 0) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"check-full-string { #%i->'%s' } pad string failed",
+					uid, indexType->key);
+			free(localString);
+			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_PAD_STRING;
+		}
+
+		length = resultLength;
+	}
+
+	if(length < minStringLength) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"check-full-string { #%i->'%s' } pad string fell short",
+				uid, indexType->key);
+		free(localString);
+		return -1;
+	}
+
+	// check the string in the search index for exact & user-key indexes
+
+	buffer = (char *)malloc(sizeof(char) * (maxStringLength + 1));
+
+	if(length > maxStringLength) {
+		strncpy(buffer, localString, maxStringLength);
+	}
+	else {
+		strcpy(buffer, localString);
+	}
+
+	if((resultSet = searchIndex_getString(searchIndex, indexType, buffer,
+					&resultSetLength)) != NULL) {
+		free(resultSet);
+		rc = 1;
+	}
+
+	free(buffer);
+
+	// cleanup
+
+	free(localString);
+
+	return rc;
+}
+
+static int index_checkIfStringExists(SearchEngine *engine,
+		SearchIndex *searchIndex, IndexRegistryIndex *indexType,
+		ContainerIterator *iterator, int uid)
+{
+	int rc = 0;
+	int stringLength = 0;
+	int minStringLength = 0;
+	char *string = NULL;
+
+	// determine string length thresholds
+
+	if(indexType->settings.isOverrideStringLengths) {
+		minStringLength = indexType->settings.minStringLength;
+	}
+	else {
+		minStringLength = engine->settings.minStringLength;
+	}
+
+	// setup local string value
+
+	if(iterator->entity.type == CONTAINER_TYPE_STRING) {
+		// copy the string from the iterator entity
+
+		if((stringLength = iterator->entity.valueLength) < minStringLength) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"check-string { #%i->'%s' } length %i invalid",
+					uid, indexType->key, stringLength);
+			return -1;
+		}
+
+		string = strndup(iterator->entity.sValue, stringLength);
+	}
+	else {
+		// perform type conversion using the container API
+
+		if((string = container_getString(iterator->container,
+						iterator->entity.name,
+						iterator->entity.nameLength,
+						&stringLength)) == NULL) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"check-string { #%i->'%s' } does not exist",
+					uid, indexType->key);
+			return -1;
+		}
+
+		if(stringLength < minStringLength) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"check-string { #%i->'%s' } length %i invalid",
+					uid, indexType->key, stringLength);
+			free(string);
+			return -1;
+		}
+	}
+
+	// check the full-length string
+
+	rc = index_checkFullString(engine, searchIndex, indexType,
+			string, stringLength, uid);
+
+	// cleanup
+
+	free(string);
+
+	return rc;
+}
+
+// container functions
+
+static int container_reindex(SearchEngine *engine,
+		IndexRegistryIndex *indexType, SearchIndex *searchIndex,
+		Container *container)
+{
+	int iValue = 0;
+	int stringLength = 0;
+	int minStringLength = 0;
+	char *string = NULL;
+
+	if((indexType->type == INDEX_REGISTRY_TYPE_EXACT) ||
+			(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) ||
+			(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY)) {
+		// determine string length thresholds
+
+		if(indexType->settings.isOverrideStringLengths) {
+			minStringLength = indexType->settings.minStringLength;
+		}
+		else {
+			minStringLength = engine->settings.minStringLength;
+		}
+
+		// perform type conversion using the container API
+
+		if((string = container_getString(container, indexType->key,
+						indexType->keyLength, &stringLength)) == NULL) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"update-string { #%i->'%s' } does not exist",
+					container_getUid(container), indexType->key);
+			return -1;
+		}
+
+		if(stringLength < minStringLength) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"update-string { #%i->'%s' } length %i invalid",
+					container_getUid(container), indexType->key, stringLength);
+			free(string);
+			return -1;
+		}
+
+		// update the full-length string
+
+		if(index_updateFullString(engine, atrue, searchIndex, indexType, string,
+					stringLength, container_getUid(container), NULL) < 0) {
+			free(string);
+			return -1;
+		}
+
+		// if a user-key index, update is complete
+
+		if(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY) {
+			free(string);
+			return 0;
+		}
+
+		// perform wildcard indexing of string tokens
+
+		if(index_updateTokenizedString(engine, atrue, searchIndex, indexType,
+					string, stringLength, container_getUid(container),
+					NULL) < 0) {
+			free(string);
+			return -1;
+		}
+
+		// cleanup
+
+		free(string);
+	}
+	else if(indexType->type == INDEX_REGISTRY_TYPE_RANGE) {
+		// perform latitude & longitude decimal conversion
+
+		if(((!strcasecmp(indexType->key, "latitude")) ||
+					(!strcasecmp(indexType->key, "longitude"))) &&
+				(container_getType(container, indexType->key,
+								   indexType->keyLength) ==
+				 CONTAINER_TYPE_DOUBLE)) {
+			iValue = (container_getDouble(container, indexType->key,
+						indexType->keyLength) *
+					GEOCOORD_INTEGER_CONVERSION);
+		}
+		else {
+			// perform type conversion using the container API
+
+			iValue = container_getInteger(container, indexType->key,
+					indexType->keyLength);
+		}
+
+		// update the range index
+
+		searchIndex_putInteger(searchIndex, indexType, iValue,
+				container_getUid(container));
+	}
+	else if(indexType->type == INDEX_REGISTRY_TYPE_GEO) {
+		index_updateGeoCoords(engine, atrue, searchIndex, indexType, container,
+				NULL);
+	}
+
+	return 0;
+}
+
+static int container_checkUserKeyIndexes(SearchEngine *engine,
+		SearchIndex *searchIndex, Container *container)
+{
+	int rc = 0;
+	int result = 0;
+	int indexNameLength = 0;
+	int indexNameResultLength = 0;
+	char *indexName = NULL;
+
+	ContainerIterator iterator;
+	IndexRegistryIndex *indexType = NULL;
+
+	if(containerIterator_init(container, &iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to initialize iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	while((rc = containerIterator_next(&iterator)) == CONTAINER_ITERATOR_OK) {
+		if(iterator.entity.nameLength < 1) {
+			continue;
+		}
+
+		indexName = strndup(iterator.entity.name, iterator.entity.nameLength);
+		indexNameLength = iterator.entity.nameLength;
+
+		if((searchEngineCommon_buildIndexString(indexName, indexNameLength,
+						&indexNameResultLength) < 0) ||
+				(indexNameResultLength < 1)) {
+			free(indexName);
+			continue;
+		}
+
+		if((indexType = indexRegistry_get(&engine->registry,
+						indexName)) == NULL) {
+			free(indexName);
+			continue;
+		}
+
+		if(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY) {
+			if(index_checkIfStringExists(engine, searchIndex, indexType,
+						&iterator, container_getUid(container)) == 1) {
+				result = 1;
+			}
+		}
+
+		free(indexName);
+	}
+
+	if(rc == CONTAINER_ITERATOR_ERROR) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"encountered error while iterating container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	if(containerIterator_free(&iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	return result;
+}
+
+static int container_updateIndexes(SearchEngine *engine, aboolean isPut,
+		SearchIndex *searchIndex, Container *container,
+		SearchEngineIndexJob *job)
+{
+	int rc = 0;
+	int indexNameLength = 0;
+	int indexNameResultLength = 0;
+	char *domainKey = NULL;
+	char *indexName = NULL;
+
+	ContainerIterator iterator;
+	IndexRegistryIndex *indexType = NULL;
+	DocValues *docValues = NULL;
+
+	if(containerIterator_init(container, &iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to initialize iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	// a job collects the postings of the container for the pipeline
+
+	if(job != NULL) {
+		domainKey = job->domainKey;
+	}
+	else {
+		domainKey = searchIndex->key;
+	}
+
+	while((rc = containerIterator_next(&iterator)) == CONTAINER_ITERATOR_OK) {
+		if(iterator.entity.nameLength < 1) {
+			continue;
+		}
+
+		indexName = strndup(iterator.entity.name, iterator.entity.nameLength);
+		indexNameLength = iterator.entity.nameLength;
+
+		if((searchEngineCommon_buildIndexString(indexName, indexNameLength,
+						&indexNameResultLength) < 0) ||
+				(indexNameResultLength < 1)) {
+			free(indexName);
+			continue;
+		}
+
+		if((indexType = indexRegistry_get(&engine->registry,
+						indexName)) == NULL) {
+			free(indexName);
+			continue;
+		}
+
+		if((indexType->type == INDEX_REGISTRY_TYPE_EXACT) ||
+				(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) ||
+				(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY)) {
+			if(index_updateString(engine, isPut, searchIndex, indexType,
+						&iterator, container_getUid(container), job) < 0) {
+				log_logf(engine->log, LOG_LEVEL_DEBUG,
+						"container update-index failed on '%s' type '%s' "
+						"for '%s'",
+						domainKey,
+						indexRegistry_typeToString(indexType->type),
+						indexName);
+			}
+		}
+		else if(indexType->type == INDEX_REGISTRY_TYPE_RANGE) {
+			if(index_updateInteger(engine, isPut, searchIndex, indexType,
+						&iterator, container_getUid(container), job) < 0) {
+				log_logf(engine->log, LOG_LEVEL_DEBUG,
+						"container update-index failed on '%s' type '%s' "
+						"for '%s'",
+						domainKey,
+						indexRegistry_typeToString(indexType->type),
+						indexName);
+			}
+		}
+
+		if((indexType->settings.isDocValues) && (job != NULL)) {
+			pipeline_addPosting(job, SEARCH_ENGINE_POSTING_TYPE_DOC_VALUES,
+					indexType, iterator.entity.name,
+					iterator.entity.nameLength, 0);
+		}
+		else if((indexType->settings.isDocValues) &&
+				((docValues = index_getDocValues(engine, indexType->key,
+						indexType->keyLength, isPut)) != NULL)) {
+			container_updateDocValues(engine, isPut, indexType, docValues,
+					container, iterator.entity.name,
+					iterator.entity.nameLength);
+		}
+
+		free(indexName);
+	}
+
+	if(rc == CONTAINER_ITERATOR_ERROR) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"encountered error while iterating container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	if(containerIterator_free(&iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	// the geo index is built from the coordinate pairs of the container,
+	// rather than from any one attribute
+
+	if((indexType = geocoord_getIndex(engine)) != NULL) {
+		index_updateGeoCoords(engine, isPut, searchIndex, indexType,
+				container, job);
+	}
+
+	return 0;
+}
+
+static int container_loadDocValues(SearchEngine *engine,
+		Container *container)
+{
+	int rc = 0;
+	int indexNameLength = 0;
+	int indexNameResultLength = 0;
+	char *indexName = NULL;
+
+	ContainerIterator iterator;
+	IndexRegistryIndex *indexType = NULL;
+	DocValues *docValues = NULL;
+
+	if(containerIterator_init(container, &iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to initialize iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	while((rc = containerIterator_next(&iterator)) == CONTAINER_ITERATOR_OK) {
+		if(iterator.entity.nameLength < 1) {
+			continue;
+		}
+
+		indexName = strndup(iterator.entity.name, iterator.entity.nameLength);
+		indexNameLength = iterator.entity.nameLength;
+
+		if((searchEngineCommon_buildIndexString(indexName, indexNameLength,
+						&indexNameResultLength) < 0) ||
+				(indexNameResultLength < 1) ||
+				((indexType = indexRegistry_get(&engine->registry,
+						indexName)) == NULL)) {
+			free(indexName);
+			continue;
+		}
+
+		if((indexType->settings.isDocValues) &&
+				((docValues = index_getDocValues(engine, indexType->key,
+						indexType->keyLength, atrue)) != NULL)) {
+			container_updateDocValues(engine, atrue, indexType, docValues,
+					container, iterator.entity.name,
+					iterator.entity.nameLength);
+		}
+
+		free(indexName);
+	}
+
+	if(rc == CONTAINER_ITERATOR_ERROR) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"encountered error while iterating container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	if(containerIterator_free(&iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	return 0;
+}
+
+static void container_updateDocValues(SearchEngine *engine, aboolean isPut,
+		IndexRegistryIndex *indexType, DocValues *docValues,
+		Container *container, char *name, int nameLength)
+{
+	int valueLength = 0;
+	int relevancyLength = 0;
+	int relevancyArrayLength = 0;
+	char *value = NULL;
+	char *relevancy = NULL;
+	char *relevancyKey = NULL;
+	char *relevancyLengthKey = NULL;
+
+	if((value = container_getString(container, name, nameLength,
+					&valueLength)) == NULL) {
+		return;
+	}
+
+	if(!isPut) {
+		docValues_remove(docValues, container_getUid(container), value,
+				valueLength);
+		free(value);
+		return;
+	}
+
+	// carry the relevancy calculated for the value into the dictionary
+
+	if((indexType->type == INDEX_REGISTRY_TYPE_EXACT) ||
+			(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD)) {
+		relevancyKey = searchEngineCommon_buildRelevancyKey(indexType->key,
+				indexType->keyLength);
+		relevancyLengthKey = searchEngineCommon_buildRelevancyLengthKey(
+				indexType->key, indexType->keyLength);
+
+		relevancy = container_getString(container, relevancyKey,
+				strlen(relevancyKey), &relevancyLength);
+		relevancyArrayLength = container_getInteger(container,
+				relevancyLengthKey, strlen(relevancyLengthKey));
+
+		free(relevancyKey);
+		free(relevancyLengthKey);
+	}
+
+	if(docValues_put(docValues, container_getUid(container), value,
+				valueLength, relevancy, relevancyLength,
+				relevancyArrayLength) < 0) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"failed to put doc value '%s' for container #%i",
+				indexType->key, container_getUid(container));
+	}
+
+	if(relevancy != NULL) {
+		free(relevancy);
+	}
+
+	free(value);
+}
+
+static char *container_buildRelevancyStringArray(SearchEngine *engine,
+		IndexRegistryIndex *indexType, ContainerIterator *iterator,
+		int *resultStringLength, int *resultArrayLength)
+{
+	int ii = 0;
+	int tokenCount = 0;
+	int stringLength = 0;
+	int minStringLength = 0;
+	int delimitersLength = 0;
+	int *tokenLengths = NULL;
+	char *result = NULL;
+	char *string = NULL;
+	char *delimiters = NULL;
+	char **tokenList = NULL;
+
+	*resultStringLength = 0;
+	*resultArrayLength = 0;
+
+	// determine string length thresholds
+
+	if(indexType->settings.isOverrideStringLengths) {
+		minStringLength = indexType->settings.minStringLength;
+	}
+	else {
+		minStringLength = engine->settings.minStringLength;
+	}
+
+	// setup local string value
+
+	if(iterator->entity.type == CONTAINER_TYPE_STRING) {
+		// copy the string from the iterator entity
+
+		if((stringLength = iterator->entity.valueLength) < minStringLength) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"relevancy-string '%s' from #%i length %i invalid",
+					iterator->entity.name,
+					container_getUid(iterator->container),
+					stringLength);
+			return NULL;
+		}
+
+		string = strndup(iterator->entity.sValue, stringLength);
+	}
+	else {
+		// perform type conversion using the container API
+
+		if((string = container_getString(iterator->container,
+						iterator->entity.name,
+						iterator->entity.nameLength,
+						&stringLength)) == NULL) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"relevancy-string '%s' from #%i does not exist",
+					iterator->entity.name,
+					container_getUid(iterator->container));
+			return NULL;
+		}
+
+		if(stringLength < minStringLength) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"relevancy-string '%s' from #%i length %i invalid",
+					iterator->entity.name,
+					container_getUid(iterator->container),
+					stringLength);
+			free(string);
+			return NULL;
+		}
+	}
+
+	// determine string delimiters
+
+	if(indexType->settings.isOverrideDelimiters) {
+		delimiters = indexType->settings.delimiters;
+		delimitersLength = indexType->settings.delimitersLength;
+	}
+	else {
+		delimiters = engine->settings.delimiters;
+		delimitersLength = engine->settings.delimitersLength;
+	}
+
+	// tokenize relevancy string value
+
+	tokenList = searchEngineCommon_stringToTokens(
+			minStringLength,
+			delimiters,
+			delimitersLength,
+			&engine->esa,
+			string,
+			stringLength,
+			&tokenLengths,
+			&tokenCount);
+
+	if((tokenList == NULL) || (tokenLengths == NULL) || (tokenCount < 1)) {
+		if(tokenLengths != NULL) {
+			free(tokenLengths);
+		}
+
+		if(tokenList != NULL) {
+			for(ii = 0; ii < tokenCount; ii++) {
+				if(tokenList[ii] != NULL) {
+					free(tokenList[ii]);
+				}
+			}
+
+			free(tokenList);
+		}
+
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"failed to tokenize relevancy-string '%s' value '%s'",
+				iterator->entity.name,
+				string);
+
+		free(string);
+
+		return NULL;
+	}
+
+	free(string);
+
+	// serialize the array of tokens
+
+	if((result = serializeArray(tokenList, tokenLengths, tokenCount,
+					resultStringLength)) == NULL) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"failed to serialize relevancy-string '%s' array",
+				iterator->entity.name);
+	}
+	else if((*resultStringLength) < 1) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"invalid serialized relevancy-string-array '%s' length %i",
+				iterator->entity.name, (*resultStringLength));
+		free(result);
+		result = NULL;
+	}
+	else {
+		*resultArrayLength = tokenCount;
+	}
+
+	// cleanup
+
+	for(ii = 0; ii < tokenCount; ii++) {
+		if(tokenList[ii] != NULL) {
+			free(tokenList[ii]);
+		}
+	}
+
+	free(tokenList);
+	free(tokenLengths);
+
+	return result;
+}
+
+static int container_calculateRelevancy(SearchEngine *engine,
+		Container *container)
+{
+	aboolean calculatedRelevancy = afalse;
+	int rc = 0;
+	int relevancyArrayLength = 0;
+	int relevancyStringLength = 0;
+	int indexNameLength = 0;
+	int indexNameResultLength = 0;
+	double timer = 0.0;
+	char *indexName = NULL;
+	char *relevancy = NULL;
+	char *relevancyKey = NULL;
+	char *relevancyLengthKey = NULL;
+
+	ContainerIterator iterator;
+	IndexRegistryIndex *indexType = NULL;
+
+	// start a timer
+
+	timer = time_getTimeMus();
+
+	// iterate container and check for relevancy arrays
+
+	if(containerIterator_init(container, &iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to initialize iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	calculatedRelevancy = afalse;
+
+	while((rc = containerIterator_next(&iterator)) == CONTAINER_ITERATOR_OK) {
+		if(iterator.entity.nameLength < 1) {
+			continue;
+		}
+
+		indexName = strndup(iterator.entity.name, iterator.entity.nameLength);
+		indexNameLength = iterator.entity.nameLength;
+
+		if((searchEngineCommon_buildIndexString(indexName, indexNameLength,
+						&indexNameResultLength) < 0) ||
+				(indexNameResultLength < 1)) {
+			free(indexName);
+			continue;
+		}
+
+		if((indexType = indexRegistry_get(&engine->registry,
+						indexName)) == NULL) {
+			free(indexName);
+			continue;
+		}
+
+		free(indexName);
+
+		if((indexType->type != INDEX_REGISTRY_TYPE_EXACT) &&
+				(indexType->type != INDEX_REGISTRY_TYPE_WILDCARD)) {
+			continue;
+		}
+
+		relevancyKey = searchEngineCommon_buildRelevancyKey(indexType->key,
+				indexType->keyLength);
+
+		if(container_exists(container, relevancyKey, strlen(relevancyKey))) {
+			free(relevancyKey);
+			continue;
+		}
+
+		if((relevancy = container_buildRelevancyStringArray(engine,
+						indexType,
+						&iterator,
+						&relevancyStringLength,
+						&relevancyArrayLength)) != NULL) {
+			relevancyLengthKey = searchEngineCommon_buildRelevancyLengthKey(
+					indexType->key, indexType->keyLength);
+
+			if(container_unlock(container) < 0) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to unlock container for relevancy-put");
+				free(relevancy);
+				free(relevancyLengthKey);
+				free(relevancyKey);
+				break;
+			}
+
+			if(container_putString(container,
+						relevancyKey,
+						strlen(relevancyKey),
+						relevancy,
+						relevancyStringLength) < 0) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to put relevancy attribute '%s' in container",
+						relevancyKey);
+				free(relevancy);
+				free(relevancyLengthKey);
+				free(relevancyKey);
+				break;
+			}
+
+			if(container_putInteger(container,
+						relevancyLengthKey,
+						strlen(relevancyLengthKey),
+						relevancyArrayLength) < 0) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to put relevancy attribute '%s' in container",
+						relevancyLengthKey);
+				free(relevancy);
+				free(relevancyLengthKey);
+				free(relevancyKey);
+				break;
+			}
+
+			if(container_lock(container) < 0) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to lock container after relevancy-put");
+				free(relevancy);
+				free(relevancyLengthKey);
+				free(relevancyKey);
+				break;
+			}
+
+			free(relevancy);
+			free(relevancyLengthKey);
+
+			containerIterator_rewind(&iterator);
+		}
+
+		calculatedRelevancy = atrue;
+
+		free(relevancyKey);
+	}
+
+	if(rc == CONTAINER_ITERATOR_ERROR) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"encountered error while iterating container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	if(containerIterator_free(&iterator) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free iterator on container #%i",
+				container_getUid(container));
+		return -1;
+	}
+
+	if(calculatedRelevancy) {
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"examined container and calculated relevancy in %0.6f seconds",
+				time_getElapsedMusInSeconds(timer));
+	}
+
+	return 0;
+}
+
+// geocoord functions
+
+static double geocoord_toMiles(SearchEngineGeoCoordTypes type,
+		double distance)
+{
+	double result = 0.0;
+
+	switch(type) {
+		case SEARCH_ENGINE_GEO_COORD_TYPE_MILES:
+			result = distance;
+			break;
+
+		case SEARCH_ENGINE_GEO_COORD_TYPE_YARDS:
+			result = (distance * 1760.0);
+			break;
+
+		case SEARCH_ENGINE_GEO_COORD_TYPE_FEET:
+			result = (distance * 5280.0);
+			break;
+
+		case SEARCH_ENGINE_GEO_COORD_TYPE_KILOMETERS:
+			result = (distance * 0.621371192);
+			break;
+
+		case SEARCH_ENGINE_GEO_COORD_TYPE_METERS:
+			result = ((distance * 0.621371192) * 1000.0);
+			break;
+
+		case SEARCH_ENGINE_GEO_COORD_TYPE_UNKNOWN:
+		default:
+			result = -1.0;
+	}
+
+	return result;
+}
+
+static IndexRegistryIndex *geocoord_getIndex(SearchEngine *engine)
+{
+	IndexRegistryIndex *result = NULL;
+
+	if(((result = indexRegistry_get(&engine->registry,
+						SEARCH_ENGINE_GEO_COORD_INDEX_KEY)) == NULL) ||
+			(result->type != INDEX_REGISTRY_TYPE_GEO)) {
+		return NULL;
+	}
+
+	return result;
+}
+
+static int geocoord_search(SearchEngine *engine, SearchIndex *searchIndex,
+		IndexRegistryIndex *indexType, double latitude, double longitude,
+		double miles, Intersect *intersect)
+{
+	int ii = 0;
+	int resultSetLength = 0;
+	int *resultSet = NULL;
+
+	Intersect localIntersect;
+
+	/*
+	 * note: the covering cells are a superset of the radius, in the same
+	 * manner as the latitude & longitude strips, and the exact distances are
+	 * pruned by the distance sort
+	 */
+
+	if(searchIndex != NULL) {
+		resultSet = searchIndex_getGeoCoord(searchIndex, indexType, latitude,
+				longitude, miles, &resultSetLength);
+
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"obtained %i results from domain '%s' for geocoord search "
+				"(%0.6f, %0.6f) within %0.4f miles",
+				resultSetLength, searchIndex->name, latitude, longitude,
+				miles);
+
+		if((resultSet == NULL) || (resultSetLength < 1)) {
+			if(resultSet != NULL) {
+				free(resultSet);
+			}
+			intersect_put(intersect, intersect->length, 0);
+		}
+		else {
+			intersect_putArrayStatic(intersect, atrue, resultSet,
+					resultSetLength);
+		}
+
+		return SEARCH_ENGINE_ERROR_OK;
+	}
+
+	// execute search across all domains
+
+	intersect_init(&localIntersect);
+
+	if(spinlock_readLock(&engine->lock) < 0) {
+		intersect_free(&localIntersect);
+		return SEARCH_ENGINE_ERROR_CORE_READ_LOCK_FAILURE;
+	}
+
+	for(ii = 0; ii < engine->domainLength; ii++) {
+		if(engine->domains[ii] == NULL) {
+			continue;
+		}
+
+		resultSet = searchIndex_getGeoCoord(engine->domains[ii], indexType,
+				latitude, longitude, miles, &resultSetLength);
+
+		log_logf(engine->log, LOG_LEVEL_DEBUG,
+				"obtained %i results from domain '%s' for geocoord search "
+				"(%0.6f, %0.6f) within %0.4f miles",
+				resultSetLength, engine->domains[ii]->name, latitude,
+				longitude, miles);
+
+		if((resultSet == NULL) || (resultSetLength < 1)) {
+			if(resultSet != NULL) {
+				free(resultSet);
+			}
+			intersect_put(&localIntersect, localIntersect.length, 0);
+		}
+		else {
+			intersect_putArrayStatic(&localIntersect, atrue, resultSet,
+					resultSetLength);
+		}
+	}
+
+	spinlock_readUnlock(&engine->lock);
+
+	intersect_execOr(&localIntersect);
+
+	intersect_putArray(intersect,
+			localIntersect.result.isSorted,
+			localIntersect.result.array,
+			localIntersect.result.length);
+
+	// cleanup
+
+	intersect_free(&localIntersect);
+
+	return SEARCH_ENGINE_ERROR_OK;
+}
+
+// write-ahead log functions
+
+/*
+ * the append functions return the ticket of the logged record, zero when the
+ * log is not open, or -1 when the log is open but the append failed
+ */
+
+static alint wal_appendContainer(SearchEngine *engine,
+		SearchWalRecordTypes type, Container *container)
+{
+	int bufferLength = 0;
+	alint result = 0;
+	char *buffer = NULL;
+
+	if(!searchWal_isOpen(&engine->wal)) {
+		return 0;
+	}
+
+	if(((buffer = container_serialize(container, &bufferLength)) == NULL) ||
+			(bufferLength < 1)) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to serialize container #%i for write-ahead log",
+				container_getUid(container));
+		if(buffer != NULL) {
+			free(buffer);
+		}
+		return -1;
+	}
+
+	if(searchWal_append(&engine->wal, type, container_getUid(container),
+				buffer, bufferLength, &result) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to append container #%i to write-ahead log",
+				container_getUid(container));
+		result = -1;
+	}
+
+	free(buffer);
+
+	return result;
+}
+
+static alint wal_appendDelete(SearchEngine *engine, int uid)
+{
+	alint result = 0;
+
+	if(!searchWal_isOpen(&engine->wal)) {
+		return 0;
+	}
+
+	if(searchWal_append(&engine->wal, SEARCH_WAL_RECORD_TYPE_DELETE, uid,
+				NULL, 0, &result) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to append delete of container #%i to write-ahead log",
+				uid);
+		result = -1;
+	}
+
+	return result;
+}
+
+static int wal_replayRecord(void *context, SearchWalRecordTypes type,
+		int uid, char *payload, int payloadLength)
+{
+	int ii = 0;
+
+	SearchEngine *engine = NULL;
+	Container *container = NULL;
+	SearchEngineQueueEntry *entry = NULL;
+
+	engine = (SearchEngine *)context;
+
+	// a replayed container is re-indexed from the log, so its values in the
+	// index segment are masked (the engine is read-locked by the restore)
+
+	if(searchSegment_isOpen(&engine->segment)) {
+		for(ii = 0; ii < engine->domainLength; ii++) {
+			if(engine->domains[ii] != NULL) {
+				searchIndex_maskUid(engine->domains[ii], uid);
+			}
+		}
+	}
+
+	// replayed records are queued behind the restored containers, so that
+	// they apply in the order they were written
+
+	switch(type) {
+		case SEARCH_WAL_RECORD_TYPE_PUT:
+		case SEARCH_WAL_RECORD_TYPE_UPDATE:
+			if((container = container_deserialize(payload,
+							payloadLength)) == NULL) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to deserialize container #%i from "
+						"write-ahead log", uid);
+				return -1;
+			}
+
+			entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_REPLACE,
+					container);
+			break;
+
+		case SEARCH_WAL_RECORD_TYPE_DELETE:
+			entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_DELETE, NULL);
+			break;
+
+		case SEARCH_WAL_RECORD_TYPE_UNKNOWN:
+		default:
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"unknown write-ahead log record type %i", (int)type);
+			return -1;
+	}
+
+	entry->uid = uid;
+
+	mutex_lock(&engine->queueMutex);
+
+	if(fifostack_push(&engine->queue, entry) < 0) {
+		if(container != NULL) {
+			container_freePtr(container);
+		}
+		free(entry);
+	}
+
+	mutex_unlock(&engine->queueMutex);
+
+	// keep the UID counter ahead of every replayed container
+
+	mutex_lock(&engine->settings.mutex);
+
+	if(uid >= engine->settings.uidCounter) {
+		engine->settings.uidCounter = (uid + 1);
+	}
+
+	mutex_unlock(&engine->settings.mutex);
+
+	return 0;
+}
+
+// shard functions
+
+static SearchEngine *shard_getEngine(SearchEngine *engine, int uid)
+{
+	return engine->shards[(uid % engine->shardLength)];
+}
+
+static char *shard_buildContainerPath(SearchEngine *engine,
+		char *containerPath, int shardId)
+{
+	aboolean exists = afalse;
+	int length = 0;
+	char *result = NULL;
+
+	length = (strlen(containerPath) + strlen("/shard.") + 32);
 
-		free(indexName);
-	}
+	result = (char *)malloc(sizeof(char) * (length + 1));
 
-	if(rc == CONTAINER_ITERATOR_ERROR) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"encountered error while iterating container #%i",
-				container_getUid(container));
-		return -1;
-	}
+	snprintf(result, length, "%s/shard.%02i", containerPath, shardId);
 
-	if(containerIterator_free(&iterator) < 0) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"failed to free iterator on container #%i",
-				container_getUid(container));
-		return -1;
+	// each shard keeps its snapshots & write-ahead log in its own directory
+
+	if((system_dirExists(containerPath, &exists) == 0) && (exists) &&
+			(system_dirExists(result, &exists) == 0) && (!exists)) {
+		if(system_dirCreate(result) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to create shard directory '%s'", result);
+		}
 	}
 
 	return result;
 }
 
-static int container_updateIndexes(SearchEngine *engine, aboolean isPut,
-		SearchIndex *searchIndex, Container *container)
+static int shard_checkUserKeyIndexes(SearchEngine *engine, char *domainKey,
+		SearchEngine *owner, Container *container)
 {
-	int rc = 0;
-	int indexNameLength = 0;
-	int indexNameResultLength = 0;
-	char *indexName = NULL;
+	int ii = 0;
+	int result = 0;
+	int domainKeyLength = 0;
 
-	ContainerIterator iterator;
-	IndexRegistryIndex *indexType = NULL;
+	SearchIndex *searchIndex = NULL;
 
-	if(containerIterator_init(container, &iterator) < 0) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"failed to initialize iterator on container #%i",
-				container_getUid(container));
-		return -1;
-	}
+	domainKeyLength = strlen(domainKey);
 
-	while((rc = containerIterator_next(&iterator)) == CONTAINER_ITERATOR_OK) {
-		if(iterator.entity.nameLength < 1) {
+	// the owning shard checks its own indexes as part of the put
+
+	for(ii = 0; ((ii < engine->shardLength) && (result == 0)); ii++) {
+		if(engine->shards[ii] == owner) {
 			continue;
 		}
 
-		indexName = strndup(iterator.entity.name, iterator.entity.nameLength);
-		indexNameLength = iterator.entity.nameLength;
-
-		if((searchEngineCommon_buildIndexString(indexName, indexNameLength,
-						&indexNameResultLength) < 0) ||
-				(indexNameResultLength < 1)) {
-			free(indexName);
-			continue;
+		if(spinlock_readLock(&engine->shards[ii]->lock) < 0) {
+			return -1;
 		}
 
-		if((indexType = indexRegistry_get(&engine->registry,
-						indexName)) == NULL) {
-			free(indexName);
+		if((bptree_get(&engine->shards[ii]->indexes, domainKey,
+						domainKeyLength, ((void *)&searchIndex)) < 0) ||
+				(searchIndex == NULL)) {
+			spinlock_readUnlock(&engine->shards[ii]->lock);
 			continue;
 		}
 
-		if((indexType->type == INDEX_REGISTRY_TYPE_EXACT) ||
-				(indexType->type == INDEX_REGISTRY_TYPE_WILDCARD) ||
-				(indexType->type == INDEX_REGISTRY_TYPE_USER_KEY)) {
-			if(index_updateString(engine, isPut, searchIndex, indexType,
-						&iterator, container_getUid(container)) < 0) {
-				log_logf(engine->log, LOG_LEVEL_DEBUG,
-						"container update-index failed on '%s' type '%s' "
-						"for '%s'",
-						searchIndex->key,
-						indexRegistry_typeToString(indexType->type),
-						indexName);
-			}
-		}
-		else if(indexType->type == INDEX_REGISTRY_TYPE_RANGE) {
-			if(index_updateInteger(engine, isPut, searchIndex, indexType,
-						&iterator, container_getUid(container)) < 0) {
-				log_logf(engine->log, LOG_LEVEL_DEBUG,
-						"container update-index failed on '%s' type '%s' "
-						"for '%s'",
-						searchIndex->key,
-						indexRegistry_typeToString(indexType->type),
-						indexName);
-			}
+		spinlock_readUnlock(&engine->shards[ii]->lock);
+
+		if(container_lock(container) < 0) {
+			return -1;
 		}
 
-		free(indexName);
-	}
+		result = container_checkUserKeyIndexes(engine->shards[ii],
+				searchIndex, container);
 
-	if(rc == CONTAINER_ITERATOR_ERROR) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"encountered error while iterating container #%i",
-				container_getUid(container));
-		return -1;
+		container_unlock(container);
 	}
 
-	if(containerIterator_free(&iterator) < 0) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"failed to free iterator on container #%i",
-				container_getUid(container));
-		return -1;
-	}
+	return result;
+}
 
-	return 0;
+static void shard_putBulkTask(void *argument)
+{
+	SearchEngineShardBulk *bulk = NULL;
+
+	bulk = (SearchEngineShardBulk *)argument;
+
+	bulk->result = searchEngine_putBulk(bulk->engine, bulk->domainKey,
+			bulk->containers, bulk->containerLength);
 }
 
-static char *container_buildRelevancyStringArray(SearchEngine *engine,
-		IndexRegistryIndex *indexType, ContainerIterator *iterator,
-		int *resultStringLength, int *resultArrayLength)
+static int shard_putBulk(SearchEngine *engine, char *domainKey,
+		Container **containers, int containerLength)
 {
 	int ii = 0;
-	int tokenCount = 0;
-	int stringLength = 0;
-	int minStringLength = 0;
-	int delimitersLength = 0;
-	int *tokenLengths = NULL;
-	char *result = NULL;
-	char *string = NULL;
-	char *delimiters = NULL;
-	char **tokenList = NULL;
+	int nn = 0;
+	int result = 0;
+	int bulkLength = 0;
+	void **arguments = NULL;
 
-	*resultStringLength = 0;
-	*resultArrayLength = 0;
+	Container *container = NULL;
+	SearchEngine *shard = NULL;
+	SearchEngineShardBulk *bulk = NULL;
+	SearchEngineShardBulk *bulks = NULL;
 
-	// determine string length thresholds
+	bulks = (SearchEngineShardBulk *)malloc(sizeof(SearchEngineShardBulk) *
+			engine->shardLength);
+	arguments = (void **)malloc(sizeof(void *) * engine->shardLength);
 
-	if(indexType->settings.isOverrideStringLengths) {
-		minStringLength = indexType->settings.minStringLength;
-	}
-	else {
-		minStringLength = engine->settings.minStringLength;
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		bulks[ii].result = 0;
+		bulks[ii].containerLength = 0;
+		bulks[ii].refs = (int *)malloc(sizeof(int) * containerLength);
+		bulks[ii].domainKey = domainKey;
+		bulks[ii].containers = (Container **)malloc(sizeof(Container *) *
+				containerLength);
+		bulks[ii].engine = engine->shards[ii];
 	}
 
-	// setup local string value
+	// assign each container a UID, and with it a shard
 
-	if(iterator->entity.type == CONTAINER_TYPE_STRING) {
-		// copy the string from the iterator entity
+	for(ii = 0; ii < containerLength; ii++) {
+		container = containers[ii];
 
-		if((stringLength = iterator->entity.valueLength) < minStringLength) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"relevancy-string '%s' from #%i length %i invalid",
-					iterator->entity.name,
-					container_getUid(iterator->container),
-					stringLength);
-			return NULL;
-		}
+		if(container_getUid(container) == 0) {
+			mutex_lock(&engine->settings.mutex);
 
-		string = strndup(iterator->entity.sValue, stringLength);
-	}
-	else {
-		// perform type conversion using the container API
+			engine->settings.uidCounter += 1;
 
-		if((string = container_getString(iterator->container,
-						iterator->entity.name,
-						iterator->entity.nameLength,
-						&stringLength)) == NULL) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"relevancy-string '%s' from #%i does not exist",
-					iterator->entity.name,
-					container_getUid(iterator->container));
-			return NULL;
+			container_setUid(container, engine->settings.uidCounter);
+
+			mutex_unlock(&engine->settings.mutex);
 		}
 
-		if(stringLength < minStringLength) {
-			log_logf(engine->log, LOG_LEVEL_DEBUG,
-					"relevancy-string '%s' from #%i length %i invalid",
-					iterator->entity.name,
-					container_getUid(iterator->container),
-					stringLength);
-			free(string);
-			return NULL;
+		shard = shard_getEngine(engine, container_getUid(container));
+
+		if(shard_checkUserKeyIndexes(engine, domainKey, shard,
+					container) == 1) {
+			log_logf(engine->log, LOG_LEVEL_INFO,
+					"container #%i contains duplicate user-key index "
+					"values, rejecting",
+					container_getUid(container));
+			container_freePtr(container);
+			containers[ii] = NULL;
+			continue;
 		}
-	}
 
-	// determine string delimiters
+		bulk = &bulks[(container_getUid(container) % engine->shardLength)];
 
-	if(indexType->settings.isOverrideDelimiters) {
-		delimiters = indexType->settings.delimiters;
-		delimitersLength = indexType->settings.delimitersLength;
-	}
-	else {
-		delimiters = engine->settings.delimiters;
-		delimitersLength = engine->settings.delimitersLength;
+		bulk->refs[bulk->containerLength] = ii;
+		bulk->containers[bulk->containerLength] = container;
+		bulk->containerLength += 1;
 	}
 
-	// tokenize relevancy string value
-
-	tokenList = searchEngineCommon_stringToTokens(
-			minStringLength,
-			delimiters,
-			delimitersLength,
-			&engine->esa,
-			string,
-			stringLength,
-			&tokenLengths,
-			&tokenCount);
+	// put each shard's containers in parallel
 
-	if((tokenList == NULL) || (tokenLengths == NULL) || (tokenCount < 1)) {
-		if(tokenLengths != NULL) {
-			free(tokenLengths);
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if(bulks[ii].containerLength > 0) {
+			arguments[bulkLength] = (void *)&bulks[ii];
+			bulkLength++;
 		}
+	}
 
-		if(tokenList != NULL) {
-			for(ii = 0; ii < tokenCount; ii++) {
-				if(tokenList[ii] != NULL) {
-					free(tokenList[ii]);
-				}
-			}
+	searchExecutor_execute(&engine->executor, shard_putBulkTask, arguments,
+			bulkLength);
 
-			free(tokenList);
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if(bulks[ii].result > 0) {
+			result += bulks[ii].result;
 		}
 
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"failed to tokenize relevancy-string '%s' value '%s'",
-				iterator->entity.name,
-				string);
-
-		free(string);
+		for(nn = 0; nn < bulks[ii].containerLength; nn++) {
+			if(bulks[ii].containers[nn] == NULL) {
+				containers[(bulks[ii].refs[nn])] = NULL;
+			}
+		}
 
-		return NULL;
+		free(bulks[ii].refs);
+		free(bulks[ii].containers);
 	}
 
-	free(string);
+	free(bulks);
+	free(arguments);
 
-	// serialize the array of tokens
+	return result;
+}
 
-	if((result = serializeArray(tokenList, tokenLengths, tokenCount,
-					resultStringLength)) == NULL) {
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"failed to serialize relevancy-string '%s' array",
-				iterator->entity.name);
-	}
-	else if((*resultStringLength) < 1) {
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"invalid serialized relevancy-string-array '%s' length %i",
-				iterator->entity.name, (*resultStringLength));
-		free(result);
-		result = NULL;
-	}
-	else {
-		*resultArrayLength = tokenCount;
-	}
+static int shard_locateUidByAttribute(SearchEngine *engine, char *attribute,
+		char *value)
+{
+	int ii = 0;
+	int rc = 0;
+	int result = 0;
 
-	// cleanup
+	Container *container = NULL;
 
-	for(ii = 0; ii < tokenCount; ii++) {
-		if(tokenList[ii] != NULL) {
-			free(tokenList[ii]);
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((container = searchEngine_getByAttribute(engine->shards[ii],
+						attribute, value, &rc)) == NULL) {
+			if(rc < 0) {
+				return rc;
+			}
+			continue;
 		}
+
+		result = container_getUid(container);
+
+		searchEngine_unlockGet(engine->shards[ii], container);
+
+		break;
 	}
 
-	free(tokenList);
-	free(tokenLengths);
+	if(result <= 0) {
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_UID;
+	}
 
 	return result;
 }
 
-static int container_calculateRelevancy(SearchEngine *engine,
-		Container *container)
+static int shard_restoreData(SearchEngine *engine, char *filename)
 {
-	aboolean calculatedRelevancy = afalse;
+	int ii = 0;
 	int rc = 0;
-	int relevancyArrayLength = 0;
-	int relevancyStringLength = 0;
-	int indexNameLength = 0;
-	int indexNameResultLength = 0;
-	double timer = 0.0;
-	char *indexName = NULL;
-	char *relevancy = NULL;
-	char *relevancyKey = NULL;
-	char *relevancyLengthKey = NULL;
+	int uid = 0;
+	int length = 0;
+	int result = 0;
+	char *basename = NULL;
+	char *shardFilename = NULL;
 
-	ContainerIterator iterator;
-	IndexRegistryIndex *indexType = NULL;
+	SearchEngine *shard = NULL;
 
-	// start a timer
+	// each shard restores the snapshot of the same name from its directory
 
-	timer = time_getTimeMus();
+	if((basename = strrchr(filename, '/')) != NULL) {
+		basename++;
+	}
+	else {
+		basename = filename;
+	}
 
-	// iterate container and check for relevancy arrays
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		shard = engine->shards[ii];
 
-	if(containerIterator_init(container, &iterator) < 0) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"failed to initialize iterator on container #%i",
-				container_getUid(container));
-		return -1;
-	}
+		mutex_lock(&shard->settings.mutex);
 
-	calculatedRelevancy = afalse;
+		length = (strlen(shard->settings.containerPath) + strlen(basename) +
+				8);
 
-	while((rc = containerIterator_next(&iterator)) == CONTAINER_ITERATOR_OK) {
-		if(iterator.entity.nameLength < 1) {
-			continue;
-		}
+		shardFilename = (char *)malloc(sizeof(char) * (length + 1));
 
-		indexName = strndup(iterator.entity.name, iterator.entity.nameLength);
-		indexNameLength = iterator.entity.nameLength;
+		snprintf(shardFilename, length, "%s/%s",
+				shard->settings.containerPath, basename);
 
-		if((searchEngineCommon_buildIndexString(indexName, indexNameLength,
-						&indexNameResultLength) < 0) ||
-				(indexNameResultLength < 1)) {
-			free(indexName);
-			continue;
-		}
+		mutex_unlock(&shard->settings.mutex);
 
-		if((indexType = indexRegistry_get(&engine->registry,
-						indexName)) == NULL) {
-			free(indexName);
-			continue;
+		if((rc = searchEngine_restoreData(shard, shardFilename)) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to restore search engine shard #%i from '%s'",
+					ii, shardFilename);
+			result = rc;
 		}
 
-		free(indexName);
+		free(shardFilename);
 
-		if((indexType->type != INDEX_REGISTRY_TYPE_EXACT) &&
-				(indexType->type != INDEX_REGISTRY_TYPE_WILDCARD)) {
-			continue;
+		// keep the router's UID counter ahead of every shard's
+
+		mutex_lock(&shard->settings.mutex);
+
+		uid = shard->settings.uidCounter;
+
+		mutex_unlock(&shard->settings.mutex);
+
+		mutex_lock(&engine->settings.mutex);
+
+		if(uid > engine->settings.uidCounter) {
+			engine->settings.uidCounter = uid;
 		}
 
-		relevancyKey = searchEngineCommon_buildRelevancyKey(indexType->key,
-				indexType->keyLength);
+		mutex_unlock(&engine->settings.mutex);
+	}
 
-		if(container_exists(container, relevancyKey, strlen(relevancyKey))) {
-			free(relevancyKey);
-			continue;
+	return result;
+}
+
+static int shard_buildIndexValueSummary(SearchEngine *engine, char *domainKey,
+		char *indexKey, SearchIndexSummary *summary)
+{
+	int ii = 0;
+	int nn = 0;
+	int rc = 0;
+	int keyLength = 0;
+	int arrayLength = 0;
+	int *count = NULL;
+	int *keyLengths = NULL;
+	char **keys = NULL;
+	void **values = NULL;
+
+	Bptree tree;
+	SearchIndexSummary local;
+
+	/*
+	 * note: a value held by more than one shard is counted once, with the
+	 * sum of its counts; range index values are binary integer keys, and are
+	 * merged in the range index's own key order
+	 */
+
+	bptree_init(&tree);
+	bptree_setFreeFunction(&tree, freeCount);
+
+	memset(summary, 0, (int)(sizeof(SearchIndexSummary)));
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_getIndexUniqueValueSummary(engine->shards[ii],
+						domainKey, indexKey, &local)) < 0) {
+			bptree_free(&tree);
+			return rc;
 		}
 
-		if((relevancy = container_buildRelevancyStringArray(engine,
-						indexType,
-						&iterator,
-						&relevancyStringLength,
-						&relevancyArrayLength)) != NULL) {
-			relevancyLengthKey = searchEngineCommon_buildRelevancyLengthKey(
-					indexType->key, indexType->keyLength);
+		if((ii == 0) && (local.type != NULL) &&
+				((!strcmp(local.type, indexRegistry_typeToString(
+							INDEX_REGISTRY_TYPE_RANGE))) ||
+				 (!strcmp(local.type, indexRegistry_typeToString(
+							INDEX_REGISTRY_TYPE_GEO))))) {
+			bptree_setKeyMode(&tree, BPTREE_KEY_MODE_INTEGER);
+		}
 
-			if(container_unlock(container) < 0) {
-				log_logf(engine->log, LOG_LEVEL_ERROR,
-						"failed to unlock container for relevancy-put");
-				free(relevancy);
-				free(relevancyLengthKey);
-				free(relevancyKey);
-				break;
+		for(nn = 0; nn < local.length; nn++) {
+			if(local.keys[nn] == NULL) {
+				continue;
 			}
 
-			if(container_putString(container,
-						relevancyKey,
-						strlen(relevancyKey),
-						relevancy,
-						relevancyStringLength) < 0) {
-				log_logf(engine->log, LOG_LEVEL_ERROR,
-						"failed to put relevancy attribute '%s' in container",
-						relevancyKey);
-				free(relevancy);
-				free(relevancyLengthKey);
-				free(relevancyKey);
-				break;
+			if(tree.keyMode == BPTREE_KEY_MODE_INTEGER) {
+				keyLength = SIZEOF_INT;
+			}
+			else if((keyLength = strlen(local.keys[nn])) < 1) {
+				free(local.keys[nn]);
+				continue;
 			}
 
-			if(container_putInteger(container,
-						relevancyLengthKey,
-						strlen(relevancyLengthKey),
-						relevancyArrayLength) < 0) {
-				log_logf(engine->log, LOG_LEVEL_ERROR,
-						"failed to put relevancy attribute '%s' in container",
-						relevancyLengthKey);
-				free(relevancy);
-				free(relevancyLengthKey);
-				free(relevancyKey);
-				break;
+			if(bptree_get(&tree, local.keys[nn], keyLength,
+						((void *)&count)) == 0) {
+				*count += local.valueCounts[nn];
 			}
+			else {
+				count = (int *)malloc(sizeof(int));
 
-			if(container_lock(container) < 0) {
-				log_logf(engine->log, LOG_LEVEL_ERROR,
-						"failed to lock container after relevancy-put");
-				free(relevancy);
-				free(relevancyLengthKey);
-				free(relevancyKey);
-				break;
+				*count = local.valueCounts[nn];
+
+				if(bptree_put(&tree, local.keys[nn], keyLength,
+							(void *)count) < 0) {
+					free(count);
+				}
 			}
 
-			free(relevancy);
-			free(relevancyLengthKey);
+			free(local.keys[nn]);
+		}
 
-			containerIterator_rewind(&iterator);
+		if(summary->type == NULL) {
+			summary->type = local.type;
+		}
+		else {
+			free(local.type);
 		}
 
-		calculatedRelevancy = atrue;
+		free(local.valueCounts);
+		free(local.keys);
+	}
 
-		free(relevancyKey);
+	if(bptree_toArray(&tree, &arrayLength, &keyLengths, &keys,
+				&values) < 0) {
+		arrayLength = 0;
 	}
 
-	if(rc == CONTAINER_ITERATOR_ERROR) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"encountered error while iterating container #%i",
-				container_getUid(container));
-		return -1;
+	summary->length = arrayLength;
+	summary->valueCounts = (int *)malloc(sizeof(int) *
+			(summary->length + 1));
+	summary->keys = keys;
+
+	for(ii = 0; ii < arrayLength; ii++) {
+		summary->valueCounts[ii] = *((int *)values[ii]);
 	}
 
-	if(containerIterator_free(&iterator) < 0) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"failed to free iterator on container #%i",
-				container_getUid(container));
-		return -1;
+	if(keyLengths != NULL) {
+		free(keyLengths);
 	}
 
-	if(calculatedRelevancy) {
-		log_logf(engine->log, LOG_LEVEL_DEBUG,
-				"examined container and calculated relevancy in %0.6f seconds",
-				time_getElapsedMusInSeconds(timer));
+	if(values != NULL) {
+		free(values);
 	}
 
+	bptree_free(&tree);
+
 	return 0;
 }
 
@@ -1817,6 +3491,28 @@ char *thread_buildContainerFilename(SearchEngine *engine, int type)
 	return result;
 }
 
+char *thread_buildSegmentFilename(SearchEngine *engine, int type)
+{
+	int length = 0;
+	char *result = NULL;
+
+	mutex_lock(&engine->settings.mutex);
+
+	length = (strlen(engine->settings.containerPath) +
+			strlen("searchd..indexes") +
+			32);
+
+	result = (char *)malloc(sizeof(char) * (length + 1));
+
+	length = snprintf(result, length, "%s/searchd.%02i.indexes",
+			engine->settings.containerPath,
+			type);
+
+	mutex_unlock(&engine->settings.mutex);
+
+	return result;
+}
+
 static int thread_writeStateToFile(SearchEngine *engine)
 {
 	aboolean exists = afalse;
@@ -2058,6 +3754,7 @@ static int thread_readStateFromFile(SearchEngine *engine, char *filename)
 		if(searchEngine_newIndex(engine, indexType, indexKey, indexName) == 0) {
 			indexRegistry_updateSettingsFromConfig(&engine->registry,
 					indexKey, &config, section, engine->log, &engine->esa);
+			searchEngine_syncIndexSettings(engine, indexKey);
 		}
 	}
 
@@ -2091,86 +3788,253 @@ static int thread_readStateFromFile(SearchEngine *engine, char *filename)
 
 	searchEngine_setMaxContainerMemoryLength(engine, lValue);
 
-	config_getDouble(&config, "search.engine", "containerTimeout",
-			SEARCH_ENGINE_DEFAULT_CONTAINER_TIMEOUT, &dValue);
+	config_getDouble(&config, "search.engine", "containerTimeout",
+			SEARCH_ENGINE_DEFAULT_CONTAINER_TIMEOUT, &dValue);
+
+	searchEngine_setContainerTimeout(engine, dValue);
+
+	config_getInteger(&config, "search.engine", "minStringLength",
+			SEARCH_ENGINE_DEFAULT_MIN_STRING_LENGTH,
+			&iValue);
+
+	config_getInteger(&config, "search.engine", "maxStringLength",
+			SEARCH_ENGINE_DEFAULT_MAX_STRING_LENGTH,
+			&iValueTwo);
+
+	searchEngine_setStringIndexThresholds(engine, iValue, iValueTwo);
+
+	config_getBigInteger(&config, "search.engine",
+			"maxSortOperationMemoryLength",
+			SEARCH_ENGINE_DEFAULT_MAX_SORT_OPERATION_LENGTH,
+			&lValue);
+
+	searchEngine_setMaxSortOperationMemoryLength(engine, lValue);
+
+	config_getString(&config, "search.engine", "stringDelimiters",
+			SEARCH_ENGINE_DEFAULT_DELIMITERS,
+			&sValue);
+
+	searchEngine_setStringDelimiters(engine, sValue, strlen(sValue));
+
+	config_getDouble(&config, "search.engine.backup",
+			"stateWriteThresholdSeconds",
+			SEARCH_ENGINE_DEFAULT_STATE_BACKUP_SECONDS, &dValue);
+
+	config_getString(&config, "search.engine.backup", "statePath",
+			SEARCH_ENGINE_DEFAULT_STATE_BACKUP_PATH, &sValue);
+
+	searchEngine_setStateBackupAttributes(engine, dValue, sValue);
+
+	config_getDouble(&config, "search.engine.backup",
+			"containerWriteThresholdSeconds",
+			SEARCH_ENGINE_DEFAULT_DATA_BACKUP_SECONDS, &dValue);
+
+	config_getString(&config, "search.engine.backup", "containerPath",
+			SEARCH_ENGINE_DEFAULT_DATA_BACKUP_PATH, &sValue);
+
+	searchEngine_setIndexBackupAttributes(engine, dValue, sValue);
+
+	config_getString(&config, "search.engine.exclusions",
+			"excludedWordConfigFilename",
+			SEARCH_ENGINE_DEFAULT_EXCLUDED_WORDS_CONFIG,
+			&sValue);
+
+	searchEngine_loadExcludedWords(engine, sValue);
+
+	config_getString(&config, "search.engine.authentication",
+			"authenticationConfigFilename",
+			SEARCH_ENGINE_DEFAULT_AUTHENTICATION_CONFIG,
+			&sValue);
+
+	searchEngine_loadAuthentication(engine, sValue);
+
+	config_getString(&config, "search.engine.lang.json",
+			"typeCheckLevel",
+			SEARCH_ENGINE_DEFAULT_VALIDATION_TYPE_STRING,
+			&sValue);
+
+	engine->settings.validationType = searchJson_stringToValidationType(sValue);
+
+	// cleanup
+
+	config_free(&config);
+
+	return 0;
+}
+
+static int *thread_cutGeneration(SearchEngine *engine, aboolean isWorker,
+		int *generation, int *uidLength)
+{
+	int entryLength = 0;
+	alint target = 0;
+	alint executed = 0;
+	alint queueLength = 0;
+	int *result = NULL;
+
+	SearchEngineQueueEntry *entry = NULL;
+	SearchEngineQueueEntry **entries = NULL;
+
+	// rotate the log under the queue mutex, so that every record in the
+	// closed generation is already on the queue
+
+	mutex_lock(&engine->queueMutex);
+
+	result = searchWal_rotate(&engine->wal, generation, uidLength);
+
+	fifostack_getItemCount(&engine->queue, &queueLength);
+
+	target = (engine->queueExecutedCount + queueLength);
+
+	mutex_unlock(&engine->queueMutex);
+
+	if(result == NULL) {
+		return NULL;
+	}
+
+	// apply the queued operations of the closed generation, or wait on the
+	// worker thread to apply them
+
+	if(isWorker) {
+		entries = (SearchEngineQueueEntry **)malloc(
+				sizeof(SearchEngineQueueEntry *) *
+				SEARCH_ENGINE_QUEUE_BATCH_LENGTH);
+
+		do {
+			entryLength = 0;
+
+			while((queueLength > 0) &&
+					(entryLength < SEARCH_ENGINE_QUEUE_BATCH_LENGTH) &&
+					(fifostack_pop(&engine->queue, ((void *)&entry)) == 0) &&
+					(entry != NULL)) {
+				entries[entryLength] = entry;
+				entryLength++;
+				queueLength--;
+			}
+
+			queue_executeBatch(engine, entries, entryLength);
+		} while((queueLength > 0) && (entryLength > 0));
+
+		free(entries);
+	}
+	else {
+		do {
+			mutex_lock(&engine->queueMutex);
+			executed = engine->queueExecutedCount;
+			mutex_unlock(&engine->queueMutex);
+
+			if(executed < target) {
+				time_usleep(1024);
+			}
+		} while(executed < target);
+	}
 
-	searchEngine_setContainerTimeout(engine, dValue);
+	return result;
+}
 
-	config_getInteger(&config, "search.engine", "minStringLength",
-			SEARCH_ENGINE_DEFAULT_MIN_STRING_LENGTH,
-			&iValue);
+static int thread_writeCheckpoint(SearchEngine *engine, aboolean isWorker)
+{
+	aboolean isRestoring = afalse;
+	int ii = 0;
+	int counter = 0;
+	int keyLength = 0;
+	int generation = 0;
+	int uidLength = 0;
+	int bufferLength = 0;
+	int *uids = NULL;
+	alint bytesWritten = 0;
+	double timer = 0.0;
+	char key[128];
+	char *buffer = NULL;
 
-	config_getInteger(&config, "search.engine", "maxStringLength",
-			SEARCH_ENGINE_DEFAULT_MAX_STRING_LENGTH,
-			&iValueTwo);
+	Container *container = NULL;
+	FileHandle fh;
 
-	searchEngine_setStringIndexThresholds(engine, iValue, iValueTwo);
+	mutex_lock(&engine->settings.mutex);
 
-	config_getBigInteger(&config, "search.engine",
-			"maxSortOperationMemoryLength",
-			SEARCH_ENGINE_DEFAULT_MAX_SORT_OPERATION_LENGTH,
-			&lValue);
+	isRestoring = engine->settings.isRestoring;
 
-	searchEngine_setMaxSortOperationMemoryLength(engine, lValue);
+	mutex_unlock(&engine->settings.mutex);
 
-	config_getString(&config, "search.engine", "stringDelimiters",
-			SEARCH_ENGINE_DEFAULT_DELIMITERS,
-			&sValue);
+	if((isRestoring) || (!searchWal_isOpen(&engine->wal))) {
+		return -1;
+	}
 
-	searchEngine_setStringDelimiters(engine, sValue, strlen(sValue));
+	// an idle generation is left open, rather than cut to an empty segment
 
-	config_getDouble(&config, "search.engine.backup",
-			"stateWriteThresholdSeconds",
-			SEARCH_ENGINE_DEFAULT_STATE_BACKUP_SECONDS, &dValue);
+	if(!searchWal_isDirty(&engine->wal)) {
+		return 0;
+	}
 
-	config_getString(&config, "search.engine.backup", "statePath",
-			SEARCH_ENGINE_DEFAULT_STATE_BACKUP_PATH, &sValue);
+	timer = time_getTimeMus();
 
-	searchEngine_setStateBackupAttributes(engine, dValue, sValue);
+	if((uids = thread_cutGeneration(engine, isWorker, &generation,
+					&uidLength)) == NULL) {
+		return -1;
+	}
 
-	config_getDouble(&config, "search.engine.backup",
-			"containerWriteThresholdSeconds",
-			SEARCH_ENGINE_DEFAULT_DATA_BACKUP_SECONDS, &dValue);
+	if(searchWal_writeSegmentBegin(&engine->wal, generation, &fh) < 0) {
+		free(uids);
+		return -1;
+	}
 
-	config_getString(&config, "search.engine.backup", "containerPath",
-			SEARCH_ENGINE_DEFAULT_DATA_BACKUP_PATH, &sValue);
+	// write the current state of each container changed in the generation,
+	// or its removal
 
-	searchEngine_setIndexBackupAttributes(engine, dValue, sValue);
+	for(ii = 0; ii < uidLength; ii++) {
+		searchEngineCommon_buildUidKey(uids[ii], key, &keyLength);
 
-	config_getString(&config, "search.engine.exclusions",
-			"excludedWordConfigFilename",
-			SEARCH_ENGINE_DEFAULT_EXCLUDED_WORDS_CONFIG,
-			&sValue);
+		if((managedIndex_get(&engine->containers, key, keyLength,
+						((void *)&container)) < 0) ||
+				(container == NULL)) {
+			bytesWritten += searchWal_writeSegmentRecord(&fh,
+					SEARCH_WAL_RECORD_TYPE_DELETE, uids[ii], NULL, 0);
+			counter++;
+			continue;
+		}
 
-	searchEngine_loadExcludedWords(engine, sValue);
+		if(((buffer = container_serialize(container,
+							&bufferLength)) == NULL) ||
+				(bufferLength < 1)) {
+			if(buffer != NULL) {
+				free(buffer);
+			}
+			continue;
+		}
 
-	config_getString(&config, "search.engine.authentication",
-			"authenticationConfigFilename",
-			SEARCH_ENGINE_DEFAULT_AUTHENTICATION_CONFIG,
-			&sValue);
+		bytesWritten += searchWal_writeSegmentRecord(&fh,
+				SEARCH_WAL_RECORD_TYPE_PUT, uids[ii], buffer, bufferLength);
 
-	searchEngine_loadAuthentication(engine, sValue);
+		free(buffer);
 
-	config_getString(&config, "search.engine.lang.json",
-			"typeCheckLevel",
-			SEARCH_ENGINE_DEFAULT_VALIDATION_TYPE_STRING,
-			&sValue);
+		counter++;
+	}
 
-	engine->settings.validationType = searchJson_stringToValidationType(sValue);
+	free(uids);
 
-	// cleanup
+	if(searchWal_writeSegmentEnd(&engine->wal, generation, &fh) < 0) {
+		return -1;
+	}
 
-	config_free(&config);
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"wrote checkpoint of %i containers (%lli bytes) for write-ahead "
+			"log generation %i in %0.6f seconds",
+			counter, bytesWritten, generation,
+			time_getElapsedMusInSeconds(timer));
 
 	return 0;
 }
 
-static int thread_writeContainersToFile(SearchEngine *engine)
+static int thread_writeContainersToFile(SearchEngine *engine,
+		aboolean isWorker)
 {
 	aboolean exists = afalse;
+	aboolean isRestoring = afalse;
 	int hash = 0;
 	int keyLength = 0;
+	int generation = 0;
+	int uidLength = 0;
 	int bufferLength = 0;
+	int *uids = NULL;
 	alint bytesWritten = 0;
 	char key[128];
 	char *buffer = NULL;
@@ -2193,8 +4057,26 @@ static int thread_writeContainersToFile(SearchEngine *engine)
 		return -1;
 	}
 
+	isRestoring = engine->settings.isRestoring;
+
 	mutex_unlock(&engine->settings.mutex);
 
+	// cut the write-ahead log, so that the snapshot covers every generation
+	// up to and including the one closed here
+
+	if(searchWal_isOpen(&engine->wal)) {
+		if(isRestoring) {
+			log_logf(engine->log, LOG_LEVEL_DEBUG,
+					"unable to write containers - restore in progress");
+			return -1;
+		}
+
+		if((uids = thread_cutGeneration(engine, isWorker, &generation,
+						&uidLength)) != NULL) {
+			free(uids);
+		}
+	}
+
 	// backup old container files
 
 	filename = thread_buildContainerFilename(engine, 1);
@@ -2284,6 +4166,17 @@ static int thread_writeContainersToFile(SearchEngine *engine)
 
 	bytesWritten += SIZEOF_INT;
 
+	// record the log generation the snapshot covers, after the trailing
+	// magic number where older readers will not look for it
+
+	if(generation > 0) {
+		file_writeInt(&fh, generation);
+
+		bytesWritten += SIZEOF_INT;
+
+		searchWal_syncFileHandle(&fh);
+	}
+
 	log_logf(engine->log, LOG_LEVEL_INFO,
 			"wrote %lli bytes to search engine container file '%s'",
 			bytesWritten, filename);
@@ -2294,10 +4187,20 @@ static int thread_writeContainersToFile(SearchEngine *engine)
 
 	free(filename);
 
+	// write the index segment matching the snapshot, after which the
+	// checkpoint segments & logs covered by the snapshot are obsolete
+
+	if(generation > 0) {
+		thread_writeSegmentToFile(engine, generation);
+
+		searchWal_removeGenerations(&engine->wal, generation);
+	}
+
 	return 0;
 }
 
-static int thread_readContainersFromFile(SearchEngine *engine, char *filename)
+static int thread_readContainersFromFile(SearchEngine *engine, char *filename,
+		int *generation)
 {
 	aboolean hasError = afalse;
 	int uid = 0;
@@ -2318,10 +4221,12 @@ static int thread_readContainersFromFile(SearchEngine *engine, char *filename)
 			"reading search engine containers from file '%s'",
 			filename);
 
+	*generation = 0;
+
 	if(file_init(&fh, filename, "rb", 0) < 0) {
 		log_logf(engine->log, LOG_LEVEL_ERROR,
 				"failed to open container file '%s'", filename);
-		free(filename);
+		file_free(&fh);
 		return -1;
 	}
 
@@ -2361,6 +4266,9 @@ static int thread_readContainersFromFile(SearchEngine *engine, char *filename)
 		hash = iValue;
 
 		if(hash == SEARCH_ENGINE_CONTAINER_FILE_MAGIC_NUMBER) { // end of file
+			if(file_readInt(&fh, &iValue) == 0) {
+				*generation = iValue;
+			}
 			break;
 		}
 
@@ -2427,44 +4335,265 @@ static int thread_readContainersFromFile(SearchEngine *engine, char *filename)
 			loadUidReference = uid;
 		}
 
-		entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_PUT, container);
+		if(searchSegment_isOpen(&engine->segment)) {
+			entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_LOAD,
+					container);
+		}
+		else {
+			entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_PUT,
+					container);
+		}
+
+		mutex_lock(&engine->queueMutex);
+
+		if(fifostack_push(&engine->queue, entry) < 0) {
+			free(entry);
+		}
+
+		mutex_unlock(&engine->queueMutex);
+
+		counter++;
+	}
+
+	// update search engine UID settings, if needed
+
+	mutex_lock(&engine->settings.mutex);
+
+	if(loadUidReference >= engine->settings.uidCounter) {
+		engine->settings.uidCounter = (loadUidReference + 1);
+	}
+
+	mutex_unlock(&engine->settings.mutex);
+
+	// cleanup
+
+	file_free(&fh);
+
+	free(buffer);
+
+	// return result status
+
+	if(hasError) {
+		return -1;
+	}
+
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"restored %i search engine containers from container file '%s'",
+			counter, filename);
+
+	return 0;
+}
+
+static int thread_writeSegmentToFile(SearchEngine *engine, int generation)
+{
+	aboolean exists = afalse;
+	int ii = 0;
+	int rc = 0;
+	double timer = 0.0;
+	char *filename = NULL;
+	char *backupFilename = NULL;
+
+	SearchSegmentWriter writer;
+
+	timer = time_getTimeMus();
+
+	// index any containers still pending from a bulk put, so the segment
+	// covers every container of its generation
+
+	pipeline_flush(engine);
+
+	// backup old index segment files, as with the container files
+
+	filename = thread_buildSegmentFilename(engine, 1);
+	backupFilename = thread_buildSegmentFilename(engine, 2);
+
+	if((system_fileExists(filename, &exists) == 0) && (exists)) {
+		if((system_fileExists(backupFilename, &exists) == 0) && (exists)) {
+			system_fileDelete(backupFilename);
+		}
+
+		system_fileMove(filename, backupFilename);
+	}
+
+	free(backupFilename);
+
+	backupFilename = filename;
+	filename = thread_buildSegmentFilename(engine, 0);
+
+	if((system_fileExists(filename, &exists) == 0) && (exists)) {
+		if((system_fileExists(backupFilename, &exists) == 0) && (exists)) {
+			system_fileDelete(backupFilename);
+		}
+
+		system_fileMove(filename, backupFilename);
+	}
+
+	free(backupFilename);
+
+	// write every index of every domain
+
+	if(searchSegmentWriter_init(&writer, filename, generation) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to open index segment file '%s'", filename);
+		free(filename);
+		return -1;
+	}
+
+	if(spinlock_readLock(&engine->lock) < 0) {
+		searchSegmentWriter_free(&writer, afalse);
+		free(filename);
+		return -1;
+	}
+
+	for(ii = 0; ii < engine->domainLength; ii++) {
+		if(engine->domains[ii] == NULL) {
+			continue;
+		}
+
+		if((rc = searchIndex_writeSegment(engine->domains[ii],
+						&writer)) < 0) {
+			break;
+		}
+	}
+
+	spinlock_readUnlock(&engine->lock);
+
+	if(searchSegmentWriter_free(&writer, (rc == 0)) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to write index segment file '%s'", filename);
+		free(filename);
+		return -1;
+	}
+
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"wrote index segment file '%s' for write-ahead log generation "
+			"%i in %0.6f seconds",
+			filename, generation, time_getElapsedMusInSeconds(timer));
+
+	free(filename);
+
+	return 0;
+}
+
+static int thread_openSegment(SearchEngine *engine, char *filename)
+{
+	int ii = 0;
+	int iValue = 0;
+	int length = 0;
+	int generation = 0;
+	int missingLength = 0;
+	int leafCount = 0;
+	alint fileLength = 0;
+	char *segmentFilename = NULL;
+
+	FileHandle fh;
+
+	// the segment only stands in for indexing on a cold start with the
+	// write-ahead log enabled
+
+	if((!searchWal_isOpen(&engine->wal)) ||
+			(searchSegment_isOpen(&engine->segment)) ||
+			(managedIndex_getLeafCount(&engine->containers,
+									   &leafCount) < 0) ||
+			(leafCount > 0)) {
+		return -1;
+	}
+
+	length = strlen(filename);
+
+	if((length <= (int)strlen(".containers")) ||
+			(strcmp((filename + (length - strlen(".containers"))),
+					".containers"))) {
+		return -1;
+	}
+
+	// read the log generation from the tail of the container file
+
+	if((system_fileLength(filename, &fileLength) < 0) ||
+			(fileLength < (SIZEOF_INT * 3))) {
+		return -1;
+	}
+
+	if(file_init(&fh, filename, "rb", 0) < 0) {
+		file_free(&fh);
+		return -1;
+	}
+
+	if((file_seek(&fh, (fileLength - (SIZEOF_INT * 2))) < 0) ||
+			(file_readInt(&fh, &iValue) < 0) ||
+			(iValue != SEARCH_ENGINE_CONTAINER_FILE_MAGIC_NUMBER) ||
+			(file_readInt(&fh, &generation) < 0) ||
+			(generation < 1)) {
+		file_free(&fh);
+		return -1;
+	}
 
-		mutex_lock(&engine->queueMutex);
+	file_free(&fh);
 
-		if(fifostack_push(&engine->queue, entry) < 0) {
-			free(entry);
-		}
+	// map the segment beside the container file
 
-		mutex_unlock(&engine->queueMutex);
+	length -= strlen(".containers");
 
-		counter++;
-	}
+	segmentFilename = (char *)malloc(sizeof(char) *
+			(length + strlen(".indexes") + 1));
 
-	// update search engine UID settings, if needed
+	memcpy(segmentFilename, filename, length);
+	strcpy((segmentFilename + length), ".indexes");
 
-	mutex_lock(&engine->settings.mutex);
+	if(searchSegment_open(&engine->segment, segmentFilename) < 0) {
+		log_logf(engine->log, LOG_LEVEL_INFO,
+				"no usable index segment '%s', indexing from containers",
+				segmentFilename);
+		free(segmentFilename);
+		return -1;
+	}
 
-	if(loadUidReference >= engine->settings.uidCounter) {
-		engine->settings.uidCounter = (loadUidReference + 1);
+	if(engine->segment.generation != generation) {
+		log_logf(engine->log, LOG_LEVEL_INFO,
+				"index segment '%s' generation %i does not match container "
+				"file generation %i, indexing from containers",
+				segmentFilename, engine->segment.generation, generation);
+		searchSegment_free(&engine->segment);
+		free(segmentFilename);
+		return -1;
 	}
 
-	mutex_unlock(&engine->settings.mutex);
+	// every index must be covered, or the containers are indexed as usual
 
-	// cleanup
+	for(ii = 0; ii < engine->domainLength; ii++) {
+		if(engine->domains[ii] == NULL) {
+			continue;
+		}
 
-	file_free(&fh);
+		if((iValue = searchIndex_attachSegment(engine->domains[ii],
+						&engine->segment)) != 0) {
+			missingLength += ((iValue > 0) ? iValue : 1);
+		}
+	}
 
-	free(buffer);
+	if(missingLength > 0) {
+		for(ii = 0; ii < engine->domainLength; ii++) {
+			if(engine->domains[ii] != NULL) {
+				searchIndex_detachSegment(engine->domains[ii]);
+			}
+		}
 
-	// return result status
+		log_logf(engine->log, LOG_LEVEL_INFO,
+				"index segment '%s' is missing %i indexes, indexing from "
+				"containers", segmentFilename, missingLength);
 
-	if(hasError) {
+		searchSegment_free(&engine->segment);
+		free(segmentFilename);
 		return -1;
 	}
 
 	log_logf(engine->log, LOG_LEVEL_INFO,
-			"restored %i search engine containers from container file '%s'",
-			counter, filename);
+			"mapped index segment '%s' (%lli bytes, %i indexes) for "
+			"write-ahead log generation %i",
+			segmentFilename, engine->segment.length,
+			engine->segment.header->sectionLength, generation);
+
+	free(segmentFilename);
 
 	return 0;
 }
@@ -2472,19 +4601,23 @@ static int thread_readContainersFromFile(SearchEngine *engine, char *filename)
 static void *thread_searchEngineWorker(void *threadContext, void *argument)
 {
 	int counter = 0;
+	int napMicros = 0;
 	int putCounter = 0;
 	int freeCounter = 0;
 	int updateCounter = 0;
+	int deleteCounter = 0;
 	alint queueLength = 0;
 	double timer = 0.0;
 	double elapsedTime = 0.0;
 	double lastStateWriteTime = 0.0;
 	double lastContainerWriteTime = 0.0;
+	double lastCheckpointTime = 0.0;
 
 	TmfThread *thread = NULL;
 	SearchEngine *engine = NULL;
 
 	SearchEngineQueueEntry *entry = NULL;
+	SearchEngineQueueEntry **entries = NULL;
 
 	if((threadContext == NULL) || (argument == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -2500,6 +4633,11 @@ static void *thread_searchEngineWorker(void *threadContext, void *argument)
 
 	lastStateWriteTime = time_getTimeMus();
 	lastContainerWriteTime = time_getTimeMus();
+	lastCheckpointTime = time_getTimeMus();
+
+	entries = (SearchEngineQueueEntry **)malloc(
+			sizeof(SearchEngineQueueEntry *) *
+			SEARCH_ENGINE_QUEUE_BATCH_LENGTH);
 
 	while((thread->state == THREAD_STATE_RUNNING) &&
 			(thread->signal == THREAD_SIGNAL_OK)) {
@@ -2516,11 +4654,23 @@ static void *thread_searchEngineWorker(void *threadContext, void *argument)
 			lastStateWriteTime = time_getTimeMus();
 		}
 
-		if((engine->settings.containerWriteThresholdSeconds > 0.0) &&
+		// a router holds no containers, its shards back up their own
+
+		if((engine->shardLength == 0) &&
+				(engine->settings.containerWriteThresholdSeconds > 0.0) &&
 				(time_getElapsedMusInSeconds(lastContainerWriteTime) >
 				 engine->settings.containerWriteThresholdSeconds)) {
-			thread_writeContainersToFile(engine);
+			thread_writeContainersToFile(engine, atrue);
 			lastContainerWriteTime = time_getTimeMus();
+			lastCheckpointTime = time_getTimeMus();
+		}
+
+		if((engine->shardLength == 0) &&
+				(engine->settings.checkpointThresholdSeconds > 0.0) &&
+				(time_getElapsedMusInSeconds(lastCheckpointTime) >
+				 engine->settings.checkpointThresholdSeconds)) {
+			thread_writeCheckpoint(engine, atrue);
+			lastCheckpointTime = time_getTimeMus();
 		}
 
 		if((thread->state != THREAD_STATE_RUNNING) ||
@@ -2528,88 +4678,106 @@ static void *thread_searchEngineWorker(void *threadContext, void *argument)
 			break;
 		}
 
-		// iterate & execute the command queue
+		// take a batch of commands from the queue & execute it
 
 		counter = 0;
 		putCounter = 0;
 		freeCounter = 0;
 		updateCounter = 0;
+		deleteCounter = 0;
 
 		timer = time_getTimeMus();
 
 		while((thread->state == THREAD_STATE_RUNNING) &&
 				(thread->signal == THREAD_SIGNAL_OK) &&
-				(counter < 1024) &&
+				(counter < SEARCH_ENGINE_QUEUE_BATCH_LENGTH) &&
 				(fifostack_pop(&engine->queue, ((void *)&entry)) == 0) &&
 				(entry != NULL)) {
 			switch(entry->type) {
 				case SEARCH_ENGINE_QUEUE_COMMAND_FREE:
-					container_freePtr(entry->payload);
 					freeCounter++;
 					break;
 
 				case SEARCH_ENGINE_QUEUE_COMMAND_PUT:
+				case SEARCH_ENGINE_QUEUE_COMMAND_REPLACE:
+				case SEARCH_ENGINE_QUEUE_COMMAND_LOAD:
 					putCounter++;
-					queue_executeAddition(engine, entry);
 					break;
 
 				case SEARCH_ENGINE_QUEUE_COMMAND_UPDATE:
 					updateCounter++;
-					queue_executeAddition(engine, entry);
+					break;
+
+				case SEARCH_ENGINE_QUEUE_COMMAND_DELETE:
+					deleteCounter++;
 					break;
 
 				case SEARCH_ENGINE_QUEUE_COMMAND_ERROR:
 				default:
-					log_logf(engine->log, LOG_LEVEL_ERROR,
-							"unknown queue command %i",
-							entry->type);
+					break;
 			}
 
-			free(entry);
+			entries[counter] = entry;
 
 			counter++;
 		}
 
+		queue_executeBatch(engine, entries, counter);
+
 		elapsedTime = time_getElapsedMusInSeconds(timer);
 
 		if(counter > 0) {
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
 					"executed %i commands from the queue "
-					"(%i free, %i put, %i update) "
+					"(%i free, %i put, %i update, %i delete) "
 					"in %0.6f seconds (%0.6f avg)",
 					counter,
-					freeCounter, putCounter, updateCounter,
+					freeCounter, putCounter, updateCounter, deleteCounter,
 					elapsedTime, (elapsedTime / (double)counter));
 		}
 
+		// group-commit the write-ahead log records of the batch
+
+		searchWal_flush(&engine->wal);
+
 		if((thread->state != THREAD_STATE_RUNNING) ||
 				(thread->signal != THREAD_SIGNAL_OK)) {
 			break;
 		}
 
-		// take a nap
+		// keep draining a backlog, otherwise nap until the queue has work,
+		// backing off from a short nap so that a new batch starts promptly
+
+		if(counter >= SEARCH_ENGINE_QUEUE_BATCH_LENGTH) {
+			continue;
+		}
 
 		mutex_lock(thread->mutex);
 		thread->status = THREAD_STATUS_NAPPING;
 		mutex_unlock(thread->mutex);
 
-		counter = 0;
+		timer = time_getTimeMus();
+		napMicros = SEARCH_ENGINE_WORKER_MIN_NAP_MICROS;
 		queueLength = 0;
 
 		do {
-			time_usleep(1024);
+			time_usleep(napMicros);
 
-			if((counter % 8) == 0) {
-				fifostack_getItemCount(&engine->queue, &queueLength);
+			if(napMicros < SEARCH_ENGINE_WORKER_MAX_NAP_MICROS) {
+				napMicros *= 2;
 			}
 
-			counter++;
-		} while((counter < 1024) &&
-				(queueLength < 1) &&
+			fifostack_getItemCount(&engine->queue, &queueLength);
+			searchWal_flush(&engine->wal);
+		} while((queueLength < 1) &&
+				(time_getElapsedMusInSeconds(timer) <
+				 SEARCH_ENGINE_WORKER_MAX_NAP_SECONDS) &&
 				(thread->state == THREAD_STATE_RUNNING) &&
 				(thread->signal == THREAD_SIGNAL_OK));
 	}
 
+	free(entries);
+
 	log_logf(engine->log, LOG_LEVEL_INFO,
 			"search engine worker thread #%i (%i) shut down",
 			thread->uid, thread->systemId);
@@ -2644,9 +4812,17 @@ int searchEngine_init(SearchEngine *engine, Log *log)
 		return -1;
 	}
 
+	if(bptree_init(&engine->docValues) < 0) {
+		return -1;
+	}
+
+	if(bptree_setFreeFunction(&engine->docValues, freeDocValues) < 0) {
+		return -1;
+	}
+
 	engine->domains = NULL;
 
-	if(managedIndex_init(&engine->containers, atrue) < 0) {
+	if(managedIndex_init(&engine->containers, atrue, atrue) < 0) {
 		return -1;
 	}
 
@@ -2671,6 +4847,9 @@ int searchEngine_init(SearchEngine *engine, Log *log)
 		SEARCH_ENGINE_DEFAULT_DATA_BACKUP_SECONDS;
 	engine->settings.containerPath = strdup(
 			SEARCH_ENGINE_DEFAULT_DATA_BACKUP_PATH);
+	engine->settings.checkpointThresholdSeconds =
+		SEARCH_WAL_DEFAULT_CHECKPOINT_SECONDS;
+	engine->settings.isRestoring = afalse;
 	engine->settings.excludedWordConfigFilename = strdup(
 			SEARCH_ENGINE_DEFAULT_EXCLUDED_WORDS_CONFIG);
 	engine->settings.authenticationConfigFilename = strdup(
@@ -2705,7 +4884,17 @@ int searchEngine_init(SearchEngine *engine, Log *log)
 		return -1;
 	}
 
+	if(searchWal_init(&engine->wal, engine->log) < 0) {
+		return -1;
+	}
+
+	if(searchSegment_init(&engine->segment) < 0) {
+		return -1;
+	}
+
 	mutex_init(&engine->queueMutex);
+	mutex_init(&engine->docValuesMutex);
+	mutex_init(&engine->pipeline.mutex);
 
 	if(spinlock_init(&engine->lock) < 0) {
 		return -1;
@@ -2722,6 +4911,12 @@ int searchEngine_init(SearchEngine *engine, Log *log)
 		return -1;
 	}
 
+	if(searchExecutor_init(&engine->executor,
+				SEARCH_ENGINE_DEFAULT_QUERY_THREAD_POOL_SIZE,
+				engine->log) < 0) {
+		return -1;
+	}
+
 	return SEARCH_ENGINE_ERROR_OK;
 }
 
@@ -2741,11 +4936,30 @@ SearchEngine *searchEngine_new(Log *log)
 
 int searchEngine_free(SearchEngine *engine)
 {
+	int ii = 0;
+
 	if(engine == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	// free the shards first, since they put to the router's doc values
+
+	if(engine->shards != NULL) {
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if(searchEngine_freePtr(engine->shards[ii]) < 0) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to free search engine shard #%i", ii);
+				return -1;
+			}
+		}
+
+		free(engine->shards);
+
+		engine->shards = NULL;
+		engine->shardLength = 0;
+	}
+
 	if(tmf_free(&engine->tmf) < 0) {
 		log_logf(engine->log, LOG_LEVEL_ERROR,
 				"failed to free the thread-management framework");
@@ -2755,6 +4969,21 @@ int searchEngine_free(SearchEngine *engine)
 	log_logf(engine->log, LOG_LEVEL_DEBUG,
 			"search engine thread pool shutdown");
 
+	if(searchWal_free(&engine->wal) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free the write-ahead log");
+		return -1;
+	}
+
+	log_logf(engine->log, LOG_LEVEL_DEBUG,
+			"search engine write-ahead log closed");
+
+	if(searchExecutor_free(&engine->executor) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free the search executor");
+		return -1;
+	}
+
 	if(spinlock_readLock(&engine->lock) < 0) {
 		log_logf(engine->log, LOG_LEVEL_ERROR,
 				"failed to obtain read lock on engine spinlock");
@@ -2804,6 +5033,16 @@ int searchEngine_free(SearchEngine *engine)
 	log_logf(engine->log, LOG_LEVEL_DEBUG,
 			"search engine indexes freed");
 
+	if(searchSegment_free(&engine->segment) < 0) {
+		spinlock_readUnlock(&engine->lock);
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free the index segment");
+		return -1;
+	}
+
+	log_logf(engine->log, LOG_LEVEL_DEBUG,
+			"search engine index segment freed");
+
 	if(bptree_free(&engine->excludedWords) < 0) {
 		log_logf(engine->log, LOG_LEVEL_ERROR,
 				"failed to free the excluded word index");
@@ -2813,6 +5052,17 @@ int searchEngine_free(SearchEngine *engine)
 	log_logf(engine->log, LOG_LEVEL_DEBUG,
 			"search engine excluded words freed");
 
+	if(bptree_free(&engine->docValues) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to free the doc values");
+		return -1;
+	}
+
+	mutex_free(&engine->docValuesMutex);
+
+	log_logf(engine->log, LOG_LEVEL_DEBUG,
+			"search engine doc values freed");
+
 	if(engine->domains != NULL) {
 		free(engine->domains);
 	}
@@ -2868,6 +5118,12 @@ int searchEngine_free(SearchEngine *engine)
 	mutex_unlock(&engine->queueMutex);
 	mutex_free(&engine->queueMutex);
 
+	if(engine->pipeline.jobs != NULL) {
+		free(engine->pipeline.jobs);
+	}
+
+	mutex_free(&engine->pipeline.mutex);
+
 	esa_free(&engine->esa);
 
 	if(engine->settings.isLogInternallyAllocated) {
@@ -2971,6 +5227,10 @@ char *searchEngine_errorCodeToString(SearchEngineErrorCodes code)
 			result = "invalid geographical coordinate distance type";
 			break;
 
+		case SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE:
+			result = "write-ahead log write failure";
+			break;
+
 		case SEARCH_ENGINE_ERROR_CORE_CONTAINER_DOES_NOT_EXIST:
 			result = "container does not exist";
 			break;
@@ -3214,14 +5474,109 @@ int searchEngine_unlock(SearchEngine *engine)
 	return spinlock_readUnlock(&engine->lock);
 }
 
+int searchEngine_setShardCount(SearchEngine *engine, int shardLength)
+{
+	int ii = 0;
+	char *containerPath = NULL;
+
+	SearchEngine *shard = NULL;
+
+	if((engine == NULL) || (shardLength < 0) ||
+			(shardLength > SEARCH_ENGINE_MAX_SHARD_COUNT)) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	/*
+	 * note: the shards are created empty & with the default settings, so this
+	 * must be called before the engine is configured, or holds any index,
+	 * domain or container
+	 */
+
+	if((engine->router != NULL) || (engine->shardLength > 0) ||
+			(engine->domainLength > 0)) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"unable to shard a search engine which is already in use");
+		return SEARCH_ENGINE_ERROR_DEFAULT_ERROR;
+	}
+
+	if(shardLength < 2) {
+		return SEARCH_ENGINE_ERROR_OK;
+	}
+
+	engine->shards = (SearchEngine **)malloc(sizeof(SearchEngine *) *
+			shardLength);
+
+	for(ii = 0; ii < shardLength; ii++) {
+		if((shard = searchEngine_new(engine->log)) == NULL) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to create search engine shard #%i", ii);
+
+			while(ii > 0) {
+				ii--;
+				searchEngine_freePtr(engine->shards[ii]);
+			}
+
+			free(engine->shards);
+
+			engine->shards = NULL;
+
+			return SEARCH_ENGINE_ERROR_DEFAULT_ERROR;
+		}
+
+		shard->router = engine;
+
+		// the router writes the state for every shard
+
+		mutex_lock(&engine->settings.mutex);
+
+		containerPath = shard_buildContainerPath(engine,
+				engine->settings.containerPath, ii);
+
+		mutex_unlock(&engine->settings.mutex);
+
+		mutex_lock(&shard->settings.mutex);
+
+		shard->settings.stateWriteThresholdSeconds = 0.0;
+
+		free(shard->settings.containerPath);
+
+		shard->settings.containerPath = containerPath;
+
+		mutex_unlock(&shard->settings.mutex);
+
+		engine->shards[ii] = shard;
+	}
+
+	engine->shardLength = shardLength;
+
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"search engine sharded by UID across %i shards", shardLength);
+
+	return SEARCH_ENGINE_ERROR_OK;
+}
+
 int searchEngine_setMaxContainerCount(SearchEngine *engine,
 		alint maxCachedItemCount)
 {
+	int ii = 0;
+	int rc = 0;
+
 	if((engine == NULL) || (maxCachedItemCount < 1)) {
 		DISPLAY_INVALID_ARGS;
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	// the limit is shared evenly between the shards
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_setMaxContainerCount(engine->shards[ii],
+						((maxCachedItemCount + engine->shardLength - 1) /
+						 engine->shardLength))) < 0) {
+			return rc;
+		}
+	}
+
 	return managedIndex_setMaxCachedItemCount(&engine->containers,
 			maxCachedItemCount);
 }
@@ -3229,11 +5584,24 @@ int searchEngine_setMaxContainerCount(SearchEngine *engine,
 int searchEngine_setMaxContainerMemoryLength(SearchEngine *engine,
 		alint maxCachedMemoryLength)
 {
+	int ii = 0;
+	int rc = 0;
+
 	if((engine == NULL) || (maxCachedMemoryLength < 1)) {
 		DISPLAY_INVALID_ARGS;
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	// the limit is shared evenly between the shards
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_setMaxContainerMemoryLength(engine->shards[ii],
+						((maxCachedMemoryLength + engine->shardLength - 1) /
+						 engine->shardLength))) < 0) {
+			return rc;
+		}
+	}
+
 	return managedIndex_setMaxCachedMemoryLength(&engine->containers,
 			maxCachedMemoryLength);
 }
@@ -3241,17 +5609,29 @@ int searchEngine_setMaxContainerMemoryLength(SearchEngine *engine,
 int searchEngine_setContainerTimeout(SearchEngine *engine,
 		double timeoutSeconds)
 {
+	int ii = 0;
+	int rc = 0;
+
 	if((engine == NULL) || (timeoutSeconds < 0.0)) {
 		DISPLAY_INVALID_ARGS;
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_setContainerTimeout(engine->shards[ii],
+						timeoutSeconds)) < 0) {
+			return rc;
+		}
+	}
+
 	return managedIndex_setTimeout(&engine->containers, timeoutSeconds);
 }
 
 int searchEngine_setStringIndexThresholds(SearchEngine *engine,
 		int minStringLength, int maxStringLength)
 {
+	int ii = 0;
+
 	if((engine == NULL) ||
 			(minStringLength < 1) ||
 			(maxStringLength < 1) ||
@@ -3261,6 +5641,11 @@ int searchEngine_setStringIndexThresholds(SearchEngine *engine,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		searchEngine_setStringIndexThresholds(engine->shards[ii],
+				minStringLength, maxStringLength);
+	}
+
 	mutex_lock(&engine->settings.mutex);
 
 	engine->settings.minStringLength = minStringLength;
@@ -3274,11 +5659,18 @@ int searchEngine_setStringIndexThresholds(SearchEngine *engine,
 int searchEngine_setMaxSortOperationMemoryLength(SearchEngine *engine,
 		alint maxSortOperationMemoryLength)
 {
+	int ii = 0;
+
 	if((engine == NULL) || (maxSortOperationMemoryLength < 0)) {
 		DISPLAY_INVALID_ARGS;
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		searchEngine_setMaxSortOperationMemoryLength(engine->shards[ii],
+				maxSortOperationMemoryLength);
+	}
+
 	mutex_lock(&engine->settings.mutex);
 
 	engine->settings.maxSortOperationMemoryLength =
@@ -3289,14 +5681,57 @@ int searchEngine_setMaxSortOperationMemoryLength(SearchEngine *engine,
 	return SEARCH_ENGINE_ERROR_OK;
 }
 
+int searchEngine_setQueryThreadPoolSize(SearchEngine *engine,
+		int threadPoolSize)
+{
+	int result = 0;
+
+	if((engine == NULL) || (threadPoolSize < 0) ||
+			(threadPoolSize > SEARCH_EXECUTOR_MAX_THREAD_POOL_SIZE)) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	/*
+	 * note: the executor is rebuilt in place, so this must be called before
+	 * the engine begins serving queries or indexing containers; the shards of
+	 * a sharded engine keep no pool of their own, and run their work on the
+	 * router's pool as it scatters to them
+	 */
+
+	mutex_lock(&engine->settings.mutex);
+
+	if(engine->executor.threadPoolSize != threadPoolSize) {
+		searchExecutor_free(&engine->executor);
+
+		result = searchExecutor_init(&engine->executor, threadPoolSize,
+				engine->log);
+	}
+
+	mutex_unlock(&engine->settings.mutex);
+
+	if(result < 0) {
+		return -1;
+	}
+
+	return SEARCH_ENGINE_ERROR_OK;
+}
+
 int searchEngine_setStringDelimiters(SearchEngine *engine, char *delimiters,
 		int delimitersLength)
 {
+	int ii = 0;
+
 	if((engine == NULL) || (delimiters == NULL) || (delimitersLength < 1)) {
 		DISPLAY_INVALID_ARGS;
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		searchEngine_setStringDelimiters(engine->shards[ii], delimiters,
+				delimitersLength);
+	}
+
 	mutex_lock(&engine->settings.mutex);
 
 	if(engine->settings.delimiters != NULL) {
@@ -3346,6 +5781,9 @@ int searchEngine_setIndexBackupAttributes(SearchEngine *engine,
 		double containerWriteThresholdSeconds, char *containerPath)
 {
 	aboolean exists = afalse;
+	int ii = 0;
+	int rc = 0;
+	char *shardPath = NULL;
 
 	if((engine == NULL) || (containerWriteThresholdSeconds < 0.0) ||
 			(containerPath == NULL)) {
@@ -3353,23 +5791,93 @@ int searchEngine_setIndexBackupAttributes(SearchEngine *engine,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
-	if((system_dirExists(containerPath, &exists) < 0) || (!exists)) {
-		log_logf(engine->log, LOG_LEVEL_ERROR,
-				"unable to locate directory '%s'", containerPath);
+	if((system_dirExists(containerPath, &exists) < 0) || (!exists)) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"unable to locate directory '%s'", containerPath);
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_DIRECTORY;
+	}
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		shardPath = shard_buildContainerPath(engine, containerPath, ii);
+
+		rc = searchEngine_setIndexBackupAttributes(engine->shards[ii],
+				containerWriteThresholdSeconds, shardPath);
+
+		free(shardPath);
+
+		if(rc < 0) {
+			return rc;
+		}
+	}
+
+	mutex_lock(&engine->settings.mutex);
+
+	if(engine->settings.containerPath != NULL) {
+		free(engine->settings.containerPath);
+	}
+
+	engine->settings.containerWriteThresholdSeconds =
+		containerWriteThresholdSeconds;
+	engine->settings.containerPath = strdup(containerPath);
+
+	mutex_unlock(&engine->settings.mutex);
+
+	return SEARCH_ENGINE_ERROR_OK;
+}
+
+int searchEngine_setWalAttributes(SearchEngine *engine,
+		SearchWalSyncTypes syncType, double syncIntervalSeconds,
+		double checkpointThresholdSeconds)
+{
+	int ii = 0;
+	int rc = 0;
+	char *containerPath = NULL;
+
+	if((engine == NULL) || (syncIntervalSeconds < 0.0) ||
+			(checkpointThresholdSeconds < 0.0)) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_setWalAttributes(engine->shards[ii], syncType,
+						syncIntervalSeconds,
+						checkpointThresholdSeconds)) < 0) {
+			return rc;
+		}
+	}
+
+	if(searchWal_setSyncType(&engine->wal, syncType,
+				syncIntervalSeconds) < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	mutex_lock(&engine->settings.mutex);
+
+	engine->settings.checkpointThresholdSeconds = checkpointThresholdSeconds;
+
+	if(engine->settings.containerPath != NULL) {
+		containerPath = strdup(engine->settings.containerPath);
+	}
+
+	mutex_unlock(&engine->settings.mutex);
+
+	if(containerPath == NULL) {
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_DIRECTORY;
 	}
 
-	mutex_lock(&engine->settings.mutex);
+	// the log lives alongside the container snapshots it is replayed over,
+	// and a router has neither
 
-	if(engine->settings.containerPath != NULL) {
-		free(engine->settings.containerPath);
+	if((engine->shardLength == 0) && (!searchWal_isOpen(&engine->wal))) {
+		rc = searchWal_open(&engine->wal, containerPath);
 	}
 
-	engine->settings.containerWriteThresholdSeconds =
-		containerWriteThresholdSeconds;
-	engine->settings.containerPath = strdup(containerPath);
+	free(containerPath);
 
-	mutex_unlock(&engine->settings.mutex);
+	if(rc < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_DATA_WRITE_FAILURE;
+	}
 
 	return SEARCH_ENGINE_ERROR_OK;
 }
@@ -3393,6 +5901,7 @@ int searchEngine_setJsonLangValidationType(SearchEngine *engine,
 
 int searchEngine_loadExcludedWords(SearchEngine *engine, char *filename)
 {
+	int ii = 0;
 	int rc = 0;
 
 	if((engine == NULL) || (filename == NULL)) {
@@ -3400,6 +5909,13 @@ int searchEngine_loadExcludedWords(SearchEngine *engine, char *filename)
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_loadExcludedWords(engine->shards[ii],
+						filename)) < 0) {
+			return rc;
+		}
+	}
+
 	// lock the engine & load the excluded words from a config file
 
 	if(spinlock_writeLock(&engine->lock) < 0) {
@@ -3529,22 +6045,31 @@ int searchEngine_restoreState(SearchEngine *engine, char *filename)
 
 int searchEngine_backupData(SearchEngine *engine)
 {
+	int ii = 0;
+	int rc = 0;
+
 	if(engine == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
-	if(spinlock_readLock(&engine->lock) < 0) {
-		return SEARCH_ENGINE_ERROR_CORE_READ_LOCK_FAILURE;
+	if(engine->shardLength > 0) {
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if((rc = searchEngine_backupData(engine->shards[ii])) < 0) {
+				return rc;
+			}
+		}
+
+		return SEARCH_ENGINE_ERROR_OK;
 	}
 
-	if(thread_writeContainersToFile(engine) < 0) {
-		spinlock_readUnlock(&engine->lock);
+	// no engine lock is taken, since cutting the write-ahead log waits on
+	// the worker thread, which may itself be waiting on the engine lock
+
+	if(thread_writeContainersToFile(engine, afalse) < 0) {
 		return SEARCH_ENGINE_ERROR_CORE_DATA_WRITE_FAILURE;
 	}
 
-	spinlock_readUnlock(&engine->lock);
-
 	return SEARCH_ENGINE_ERROR_OK;
 }
 
@@ -3555,17 +6080,76 @@ int searchEngine_restoreData(SearchEngine *engine, char *filename)
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	int rc = 0;
+	int generation = 0;
+
+	if(engine->shardLength > 0) {
+		return shard_restoreData(engine, filename);
+	}
+
 	if(spinlock_readLock(&engine->lock) < 0) {
 		return SEARCH_ENGINE_ERROR_CORE_READ_LOCK_FAILURE;
 	}
 
-	if(thread_readContainersFromFile(engine, filename) < 0) {
-		spinlock_readUnlock(&engine->lock);
-		return SEARCH_ENGINE_ERROR_CORE_DATA_READ_FAILURE;
+	mutex_lock(&engine->settings.mutex);
+
+	engine->settings.isRestoring = atrue;
+
+	mutex_unlock(&engine->settings.mutex);
+
+	thread_openSegment(engine, filename);
+
+	rc = thread_readContainersFromFile(engine, filename, &generation);
+
+	// replay the write-ahead log generations written after the snapshot, or
+	// every generation on disk when there is no snapshot
+
+	if(searchWal_isOpen(&engine->wal)) {
+		if(searchWal_replay(&engine->wal, generation, wal_replayRecord,
+					(void *)engine) < 0) {
+			rc = -1;
+		}
 	}
 
+	mutex_lock(&engine->settings.mutex);
+
+	engine->settings.isRestoring = afalse;
+
+	mutex_unlock(&engine->settings.mutex);
+
 	spinlock_readUnlock(&engine->lock);
 
+	if(rc < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_DATA_READ_FAILURE;
+	}
+
+	return SEARCH_ENGINE_ERROR_OK;
+}
+
+int searchEngine_checkpointData(SearchEngine *engine)
+{
+	int ii = 0;
+	int rc = 0;
+
+	if(engine == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	if(engine->shardLength > 0) {
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if((rc = searchEngine_checkpointData(engine->shards[ii])) < 0) {
+				return rc;
+			}
+		}
+
+		return SEARCH_ENGINE_ERROR_OK;
+	}
+
+	if(thread_writeCheckpoint(engine, afalse) < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_DATA_WRITE_FAILURE;
+	}
+
 	return SEARCH_ENGINE_ERROR_OK;
 }
 
@@ -3573,6 +6157,7 @@ int searchEngine_newIndex(SearchEngine *engine, IndexRegistryTypes type,
 		char *key, char *name)
 {
 	int ii = 0;
+	int rc = 0;
 	int keyLength = 0;
 	int keyResultLength = 0;
 	char *localKey = NULL;
@@ -3585,6 +6170,24 @@ int searchEngine_newIndex(SearchEngine *engine, IndexRegistryTypes type,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	// a geo index is built from the coordinate pairs of each container, and
+	// so is only registered under the geocoord key
+
+	if((type == INDEX_REGISTRY_TYPE_GEO) &&
+			(strcasecmp(key, SEARCH_ENGINE_GEO_COORD_INDEX_KEY))) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"unable to create geo index '%s', must be keyed '%s'",
+				key, SEARCH_ENGINE_GEO_COORD_INDEX_KEY);
+		return SEARCH_ENGINE_ERROR_INDEX_TYPE_INVALID;
+	}
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_newIndex(engine->shards[ii], type, key,
+						name)) < 0) {
+			return rc;
+		}
+	}
+
 	localKey = strndup(key, keyLength);
 
 	if(searchEngineCommon_buildIndexString(localKey, keyLength,
@@ -3696,6 +6299,7 @@ int searchEngine_newUserIndex(SearchEngine *engine, char *key, char *name)
 int searchEngine_removeIndex(SearchEngine *engine, char *key)
 {
 	int ii = 0;
+	int rc = 0;
 	int keyLength = 0;
 	int keyResultLength = 0;
 	char *localKey = NULL;
@@ -3707,6 +6311,12 @@ int searchEngine_removeIndex(SearchEngine *engine, char *key)
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_removeIndex(engine->shards[ii], key)) < 0) {
+			return rc;
+		}
+	}
+
 	localKey = strndup(key, keyLength);
 
 	if(searchEngineCommon_buildIndexString(localKey, keyLength,
@@ -3791,6 +6401,7 @@ int searchEngine_renameIndex(SearchEngine *engine, char *key, char *newKey,
 		char *newName)
 {
 	int ii = 0;
+	int rc = 0;
 	int keyLength = 0;
 	int newKeyLength = 0;
 	int keyResultLength = 0;
@@ -3810,6 +6421,13 @@ int searchEngine_renameIndex(SearchEngine *engine, char *key, char *newKey,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_renameIndex(engine->shards[ii], key, newKey,
+						newName)) < 0) {
+			return rc;
+		}
+	}
+
 	localKey = strndup(key, keyLength);
 
 	if(searchEngineCommon_buildIndexString(localKey, keyLength,
@@ -3945,6 +6563,7 @@ int searchEngine_setIndexStringThresholds(SearchEngine *engine, char *key,
 		int minStringLength, int maxStringLength)
 {
 	int ii = 0;
+	int rc = 0;
 	int keyLength = 0;
 	int keyResultLength = 0;
 	char *localKey = NULL;
@@ -3961,6 +6580,13 @@ int searchEngine_setIndexStringThresholds(SearchEngine *engine, char *key,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_setIndexStringThresholds(engine->shards[ii],
+						key, minStringLength, maxStringLength)) < 0) {
+			return rc;
+		}
+	}
+
 	localKey = strndup(key, keyLength);
 
 	if(searchEngineCommon_buildIndexString(localKey, keyLength,
@@ -4052,21 +6678,249 @@ int searchEngine_setIndexStringThresholds(SearchEngine *engine, char *key,
 		}
 	}
 
-	log_logf(engine->log, LOG_LEVEL_INFO,
-			"set index '%s' string thresholds to (min %i, max %i) "
-			"{ type '%s', key '%s', name '%s' }",
-			localKey,
-			minStringLength,
-			maxStringLength,
-			indexRegistry_typeToString(indexType->type),
-			indexType->key,
-			indexType->name);
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"set index '%s' string thresholds to (min %i, max %i) "
+			"{ type '%s', key '%s', name '%s' }",
+			localKey,
+			minStringLength,
+			maxStringLength,
+			indexRegistry_typeToString(indexType->type),
+			indexType->key,
+			indexType->name);
+
+	spinlock_writeUnlock(&engine->lock);
+
+	free(localKey);
+
+	return SEARCH_ENGINE_ERROR_OK;
+}
+
+int searchEngine_setIndexDocValues(SearchEngine *engine, char *key,
+		aboolean isDocValues)
+{
+	int ii = 0;
+	int keyLength = 0;
+	int keyResultLength = 0;
+	char *localKey = NULL;
+
+	DocValues *docValues = NULL;
+	IndexRegistryIndex *indexType = NULL;
+
+	if((engine == NULL) || (key == NULL) || ((keyLength = strlen(key)) < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	localKey = strndup(key, keyLength);
+
+	if(searchEngineCommon_buildIndexString(localKey, keyLength,
+				&keyResultLength) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"normalized index registry key '%s' is invalid",
+				localKey);
+		free(localKey);
+		return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_BUILD_INDEX_STRING;
+	}
+
+	if(spinlock_writeLock(&engine->lock) < 0) {
+		free(localKey);
+		return SEARCH_ENGINE_ERROR_CORE_WRITE_LOCK_FAILURE;
+	}
+
+	if((indexType = indexRegistry_get(&engine->registry, localKey)) == NULL) {
+		spinlock_writeUnlock(&engine->lock);
+
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to locate registry for set index doc values "
+				"{ key '%s' }",
+				localKey);
+
+		free(localKey);
+
+		return SEARCH_ENGINE_ERROR_INDEX_FAILED_TO_LOCATE;
+	}
+
+	free(localKey);
+
+	if(indexRegistry_setDocValues(&engine->registry, indexType->key,
+				isDocValues) < 0) {
+		spinlock_writeUnlock(&engine->lock);
+
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to set registry for index doc values "
+				"{ type '%s', key '%s', name '%s' }",
+				indexRegistry_typeToString(indexType->type),
+				indexType->key, indexType->name);
+
+		return SEARCH_ENGINE_ERROR_INDEX_RESET_FAILURE;
+	}
+
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if(spinlock_writeLock(&engine->shards[ii]->lock) < 0) {
+			continue;
+		}
+
+		indexRegistry_setDocValues(&engine->shards[ii]->registry,
+				indexType->key, isDocValues);
+
+		spinlock_writeUnlock(&engine->shards[ii]->lock);
+	}
+
+	/*
+	 * note: the column is rebuilt from the containers whenever it is enabled,
+	 * since puts made while it was disabled were not recorded, and is not
+	 * used for sorting until the rebuild is complete
+	 */
+
+	docValues = index_getDocValues(engine, indexType->key,
+			indexType->keyLength, isDocValues);
+
+	if(docValues != NULL) {
+		docValues_setEnabled(docValues, afalse);
+		docValues_reset(docValues);
+	}
+
+	spinlock_writeUnlock(&engine->lock);
+
+	if(isDocValues) {
+		if(docValues == NULL) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to create doc values for index "
+					"{ type '%s', key '%s', name '%s' }",
+					indexRegistry_typeToString(indexType->type),
+					indexType->key, indexType->name);
+			return SEARCH_ENGINE_ERROR_INDEX_FAILED_TO_CREATE;
+		}
+
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if(index_fillDocValues(engine->shards[ii], indexType,
+						docValues) < 0) {
+				break;
+			}
+		}
+
+		if((ii < engine->shardLength) ||
+				((engine->shardLength == 0) &&
+				 (index_fillDocValues(engine, indexType, docValues) < 0))) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to fill doc values for index "
+					"{ type '%s', key '%s', name '%s' }",
+					indexRegistry_typeToString(indexType->type),
+					indexType->key, indexType->name);
+			return SEARCH_ENGINE_ERROR_INDEX_FAILED_TO_REINDEX;
+		}
+
+		docValues_setEnabled(docValues, atrue);
+	}
+
+	log_logf(engine->log, LOG_LEVEL_INFO,
+			"set index doc values %s "
+			"{ type '%s', key '%s', name '%s' }",
+			(isDocValues ? "enabled" : "disabled"),
+			indexRegistry_typeToString(indexType->type),
+			indexType->key, indexType->name);
+
+	return SEARCH_ENGINE_ERROR_OK;
+}
+
+int searchEngine_syncIndexSettings(SearchEngine *engine, char *key)
+{
+	int ii = 0;
+	int rc = 0;
+	int keyLength = 0;
+	int keyResultLength = 0;
+	char *localKey = NULL;
+	char section[128];
+
+	Config config;
+
+	if((engine == NULL) || (key == NULL) || ((keyLength = strlen(key)) < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	if(engine->shardLength < 1) {
+		return SEARCH_ENGINE_ERROR_OK;
+	}
+
+	localKey = strndup(key, keyLength);
+
+	if(searchEngineCommon_buildIndexString(localKey, keyLength,
+				&keyResultLength) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"normalized index registry key '%s' is invalid",
+				localKey);
+		free(localKey);
+		return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_BUILD_INDEX_STRING;
+	}
+
+	// copy the router's index settings to each shard's registry by way of an
+	// in-memory configuration section
+
+	config_init(&config, NULL);
+
+	snprintf(section, (int)(sizeof(section) - 1), "indexRegistry.shard");
+
+	if(indexRegistry_updateConfigContext(&engine->registry, localKey,
+				&config, section) < 0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to locate registry for index settings sync "
+				"{ key '%s' }",
+				localKey);
+		rc = SEARCH_ENGINE_ERROR_INDEX_FAILED_TO_LOCATE;
+	}
+	else {
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			indexRegistry_updateSettingsFromConfig(
+					&engine->shards[ii]->registry, localKey, &config, section,
+					engine->shards[ii]->log, &engine->shards[ii]->esa);
+		}
+	}
+
+	config_free(&config);
+
+	free(localKey);
+
+	return rc;
+}
+
+DocValues *searchEngine_getDocValues(SearchEngine *engine, char *attribute)
+{
+	int keyLength = 0;
+	int keyResultLength = 0;
+	char *localKey = NULL;
+
+	DocValues *result = NULL;
+	IndexRegistryIndex *indexType = NULL;
+
+	if((engine == NULL) || (attribute == NULL) ||
+			((keyLength = strlen(attribute)) < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	localKey = strndup(attribute, keyLength);
 
-	spinlock_writeUnlock(&engine->lock);
+	if(searchEngineCommon_buildIndexString(localKey, keyLength,
+				&keyResultLength) < 0) {
+		free(localKey);
+		return NULL;
+	}
+
+	if(((indexType = indexRegistry_get(&engine->registry,
+						localKey)) != NULL) &&
+			(indexType->settings.isDocValues)) {
+		result = index_getDocValues(engine, indexType->key,
+				indexType->keyLength, afalse);
+	}
 
 	free(localKey);
 
-	return SEARCH_ENGINE_ERROR_OK;
+	if((result != NULL) && (!docValues_isEnabled(result))) {
+		result = NULL;
+	}
+
+	return result;
 }
 
 int searchEngine_resetIndex(SearchEngine *engine, char *key,
@@ -4255,6 +7109,8 @@ int searchEngine_getIndexType(SearchEngine *engine, char *indexKey)
 int searchEngine_getIndexCount(SearchEngine *engine, char *domainKey,
 		char *indexKey)
 {
+	int ii = 0;
+	int rc = 0;
 	int keyLength = 0;
 	int stringLength = 0;
 	int stringResultLength = 0;
@@ -4262,6 +7118,7 @@ int searchEngine_getIndexCount(SearchEngine *engine, char *domainKey,
 
 	SearchIndex *searchIndex = NULL;
 	IndexRegistryIndex *indexType = NULL;
+	SearchIndexSummary summary;
 
 	if((engine == NULL) || (domainKey == NULL) ||
 			((keyLength = strlen(domainKey)) < 1) || (indexKey == NULL)) {
@@ -4313,6 +7170,33 @@ int searchEngine_getIndexCount(SearchEngine *engine, char *domainKey,
 
 	free(string);
 
+	// count the values once across the shards, from a merged summary
+
+	if(engine->shardLength > 0) {
+		if((rc = shard_buildIndexValueSummary(engine, domainKey, indexKey,
+						&summary)) < 0) {
+			return rc;
+		}
+
+		for(ii = 0; ii < summary.length; ii++) {
+			if(summary.keys[ii] != NULL) {
+				free(summary.keys[ii]);
+			}
+		}
+
+		if(summary.keys != NULL) {
+			free(summary.keys);
+		}
+
+		if(summary.type != NULL) {
+			free(summary.type);
+		}
+
+		free(summary.valueCounts);
+
+		return summary.length;
+	}
+
 	// obtain the index count for this domain & index
 
 	return searchIndex_getIndexCount(searchIndex, indexType);
@@ -4321,6 +7205,9 @@ int searchEngine_getIndexCount(SearchEngine *engine, char *domainKey,
 int searchEngine_getIndexDepth(SearchEngine *engine, char *domainKey,
 		char *indexKey)
 {
+	int ii = 0;
+	int rc = 0;
+	int result = 0;
 	int keyLength = 0;
 	int stringLength = 0;
 	int stringResultLength = 0;
@@ -4379,6 +7266,23 @@ int searchEngine_getIndexDepth(SearchEngine *engine, char *domainKey,
 
 	free(string);
 
+	// the depth of a sharded index is that of its deepest shard
+
+	if(engine->shardLength > 0) {
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if((rc = searchEngine_getIndexDepth(engine->shards[ii], domainKey,
+							indexKey)) < 0) {
+				return rc;
+			}
+
+			if(rc > result) {
+				result = rc;
+			}
+		}
+
+		return result;
+	}
+
 	// obtain the index depth for this domain & index
 
 	return searchIndex_getIndexDepth(searchIndex, indexType);
@@ -4387,6 +7291,9 @@ int searchEngine_getIndexDepth(SearchEngine *engine, char *domainKey,
 int searchEngine_getIndexUniqueValueCount(SearchEngine *engine,
 		char *domainKey, char *indexKey)
 {
+	int ii = 0;
+	int rc = 0;
+	int result = 0;
 	int keyLength = 0;
 	int stringLength = 0;
 	int stringResultLength = 0;
@@ -4445,6 +7352,21 @@ int searchEngine_getIndexUniqueValueCount(SearchEngine *engine,
 
 	free(string);
 
+	// the shards hold disjoint sets of UIDs, so their counts are summed
+
+	if(engine->shardLength > 0) {
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if((rc = searchEngine_getIndexUniqueValueCount(engine->shards[ii],
+							domainKey, indexKey)) < 0) {
+				return rc;
+			}
+
+			result += rc;
+		}
+
+		return result;
+	}
+
 	// obtain the index depth for this domain & index
 
 	return searchIndex_getIndexValueCount(searchIndex, indexType);
@@ -4512,6 +7434,11 @@ int searchEngine_getIndexUniqueValueSummary(SearchEngine *engine,
 
 	free(string);
 
+	if(engine->shardLength > 0) {
+		return shard_buildIndexValueSummary(engine, domainKey, indexKey,
+				summary);
+	}
+
 	// obtain the index depth for this domain & index
 
 	return searchIndex_buildIndexValueSummary(searchIndex, indexType, summary);
@@ -4519,6 +7446,8 @@ int searchEngine_getIndexUniqueValueSummary(SearchEngine *engine,
 
 int searchEngine_newDomain(SearchEngine *engine, char *key, char *name)
 {
+	int ii = 0;
+	int rc = 0;
 	int ref = 0;
 	int keyLength = 0;
 	int typeKeyLength = 0;
@@ -4533,6 +7462,12 @@ int searchEngine_newDomain(SearchEngine *engine, char *key, char *name)
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_newDomain(engine->shards[ii], key, name)) < 0) {
+			return rc;
+		}
+	}
+
 	if(spinlock_writeLock(&engine->lock) < 0) {
 		return SEARCH_ENGINE_ERROR_CORE_WRITE_LOCK_FAILURE;
 	}
@@ -4649,6 +7584,8 @@ int searchEngine_newDomain(SearchEngine *engine, char *key, char *name)
 int searchEngine_renameDomain(SearchEngine *engine, char *domainKey,
 		char *newKey, char *newName)
 {
+	int ii = 0;
+	int rc = 0;
 	int newKeyLength = 0;
 	int domainKeyLength = 0;
 
@@ -4664,6 +7601,13 @@ int searchEngine_renameDomain(SearchEngine *engine, char *domainKey,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_renameDomain(engine->shards[ii], domainKey,
+						newKey, newName)) < 0) {
+			return rc;
+		}
+	}
+
 	if(spinlock_writeLock(&engine->lock) < 0) {
 		return SEARCH_ENGINE_ERROR_CORE_WRITE_LOCK_FAILURE;
 	}
@@ -4739,6 +7683,7 @@ int searchEngine_removeDomain(SearchEngine *engine, char *domainKey)
 {
 	aboolean isFound = afalse;
 	int ii = 0;
+	int rc = 0;
 	int domainKeyLength = 0;
 
 	SearchIndex *searchIndex = NULL;
@@ -4750,6 +7695,13 @@ int searchEngine_removeDomain(SearchEngine *engine, char *domainKey)
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	for(ii = 0; ii < engine->shardLength; ii++) {
+		if((rc = searchEngine_removeDomain(engine->shards[ii],
+						domainKey)) < 0) {
+			return rc;
+		}
+	}
+
 	if(spinlock_writeLock(&engine->lock) < 0) {
 		return SEARCH_ENGINE_ERROR_CORE_WRITE_LOCK_FAILURE;
 	}
@@ -4857,6 +7809,10 @@ Container *searchEngine_get(SearchEngine *engine, int uid, int *errorCode)
 
 	*errorCode = SEARCH_ENGINE_ERROR_OK;
 
+	if(engine->shardLength > 0) {
+		return searchEngine_get(shard_getEngine(engine, uid), uid, errorCode);
+	}
+
 	if(searchEngineCommon_buildUidKey(uid, key, &keyLength) < 0) {
 		log_logf(engine->log, LOG_LEVEL_ERROR,
 				"failed to build index key for uid %i", uid);
@@ -4907,6 +7863,18 @@ Container *searchEngine_getByAttribute(SearchEngine *engine, char *attribute,
 
 	*errorCode = SEARCH_ENGINE_ERROR_OK;
 
+	if(engine->shardLength > 0) {
+		for(ii = 0; ii < engine->shardLength; ii++) {
+			if(((result = searchEngine_getByAttribute(engine->shards[ii],
+								attribute, value, errorCode)) != NULL) ||
+					(*errorCode < 0)) {
+				break;
+			}
+		}
+
+		return result;
+	}
+
 	// determine if an index exists for this attribute
 
 	stringLength = strlen(attribute);
@@ -5019,6 +7987,11 @@ int searchEngine_unlockGet(SearchEngine *engine, Container *container)
 		return SEARCH_ENGINE_ERROR_CORE_MISSING_UID;
 	}
 
+	if(engine->shardLength > 0) {
+		return searchEngine_unlockGet(shard_getEngine(engine, uid),
+				container);
+	}
+
 	if(searchEngineCommon_buildUidKey(uid, key, &keyLength) < 0) {
 		log_logf(engine->log, LOG_LEVEL_ERROR,
 				"failed to build index key for uid %i", uid);
@@ -5050,8 +8023,10 @@ int searchEngine_put(SearchEngine *engine, char *domainKey,
 	int uid = 0;
 	int keyLength = 0;
 	int domainKeyLength = 0;
+	alint ticket = 0;
 	char key[128];
 
+	SearchEngine *shard = NULL;
 	SearchIndex *searchIndex = NULL;
 	Container *localContainer = NULL;
 	SearchEngineQueueEntry *entry = NULL;
@@ -5112,6 +8087,23 @@ int searchEngine_put(SearchEngine *engine, char *domainKey,
 		hasUid = atrue;
 	}
 
+	// route the container to its shard, which must not find its user-keys
+	// on any other shard
+
+	if(engine->shardLength > 0) {
+		shard = shard_getEngine(engine, uid);
+
+		if(shard_checkUserKeyIndexes(engine, domainKey, shard,
+					container) == 1) {
+			log_logf(engine->log, LOG_LEVEL_INFO,
+					"container contains duplicate user-key index values, "
+					"rejecting");
+			return SEARCH_ENGINE_ERROR_CORE_CONTAINER_HAS_DUPLICATE_USER_KEY_INDEX;
+		}
+
+		return searchEngine_put(shard, domainKey, container, isImmediate);
+	}
+
 	// read-lock the container
 
 	if(container_lock(container) < 0) {
@@ -5120,100 +8112,334 @@ int searchEngine_put(SearchEngine *engine, char *domainKey,
 		return SEARCH_ENGINE_ERROR_CORE_CONTAINER_LOCK_FAILURE;
 	}
 
-	// build the container UID key
+	// build the container UID key
+
+	if((hasUid) || (isImmediate)) {
+		if(searchEngineCommon_buildUidKey(container_getUid(container),
+					key, &keyLength) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to build index key for container #%i domain '%s'",
+					container_getUid(container), domainKey);
+			container_unlock(container);
+			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_BUILD_UID_KEY;
+		}
+	}
+
+	// determine if the container cannot be added due to duplicate user-key
+
+	if(container_checkUserKeyIndexes(engine, searchIndex, container) == 1) {
+		log_logf(engine->log, LOG_LEVEL_INFO,
+				"container contains duplicate user-key index values, "
+				"rejecting");
+		container_unlock(container);
+		return SEARCH_ENGINE_ERROR_CORE_CONTAINER_HAS_DUPLICATE_USER_KEY_INDEX;
+	}
+
+	// determine if the container already exists
+
+	if(hasUid) {
+		if(managedIndex_get(&engine->containers, key, keyLength,
+					((void *)&localContainer)) == 0) {
+			if(container_lock(localContainer) < 0) {
+				log_logf(engine->log, LOG_LEVEL_WARNING,
+						"failed to obtain container read lock for removal");
+			}
+
+			// remove the old container from the system (note that this
+			// automatically places the container on the queue for deletion,
+			// which in turn removes the existing indexes)
+
+			if(managedIndex_remove(&engine->containers, key, keyLength) < 0) {
+				log_logf(engine->log, LOG_LEVEL_ERROR,
+						"failed to remove container #%i domain '%s' from "
+						"master index",
+						container_getUid(localContainer), domainKey);
+				container_unlock(container);
+				container_unlock(localContainer);
+				return SEARCH_ENGINE_ERROR_CORE_FAILED_TO_DELETE_CONTAINER;
+			}
+
+			container_unlock(localContainer);
+		}
+	}
+
+	// unlock the container
+
+	container_unlock(container);
+
+	// update the container with reserved entities
+
+	container_putString(container, SEARCHD_DOMAIN_KEY,
+			SEARCHD_DOMAIN_KEY_LENGTH, domainKey, domainKeyLength);
+
+	// add the container to the system
+
+	if(isImmediate) {
+		container_calculateRelevancy(engine, container);
+
+		if(managedIndex_put(&engine->containers, key, keyLength, container,
+					container_calculateMemoryLength(container)) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to put container #%i in master index for "
+					"domain '%s'",
+					container_getUid(container), domainKey);
+			return SEARCH_ENGINE_ERROR_CORE_FAILED_TO_PUT_CONTAINER;
+		}
+
+		if(container_updateIndexes(engine, atrue, searchIndex, container,
+					NULL) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to put indexes for container #%i domain '%s'",
+					container_getUid(container), domainKey);
+			return SEARCH_ENGINE_ERROR_CORE_FAILED_TO_UPDATE_CONTAINER_INDEXES;
+		}
+
+		ticket = wal_appendContainer(engine, SEARCH_WAL_RECORD_TYPE_PUT,
+				container);
+	}
+	else {
+		entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_PUT, container);
+
+		// log & queue together, so a log rotation never separates the two
+
+		mutex_lock(&engine->queueMutex);
+
+		ticket = wal_appendContainer(engine, SEARCH_WAL_RECORD_TYPE_PUT,
+				container);
+
+		if(fifostack_push(&engine->queue, entry) < 0) {
+			free(entry);
+		}
+
+		mutex_unlock(&engine->queueMutex);
+	}
+
+	// a write is only acknowledged once it is durable in the log
+
+	if(ticket < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+	}
+	else if(ticket > 0) {
+		if(searchWal_sync(&engine->wal, ticket) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to sync write-ahead log for container #%i",
+					uid);
+			return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+		}
+	}
+
+	return uid;
+}
+
+int searchEngine_putBulk(SearchEngine *engine, char *domainKey,
+		Container **containers, int containerLength)
+{
+	aboolean isLogFailed = afalse;
+	int ii = 0;
+	int nn = 0;
+	int result = 0;
+	int entryLength = 0;
+	int prepareLength = 0;
+	int domainKeyLength = 0;
+	alint ticket = 0;
+	double timer = 0.0;
+	void **arguments = NULL;
+
+	Container *container = NULL;
+	SearchIndex *searchIndex = NULL;
+	SearchEngineQueueEntry *entries = NULL;
+
+	if((engine == NULL) ||
+			(domainKey == NULL) ||
+			((domainKeyLength = strlen(domainKey)) < 1) ||
+			(containers == NULL) ||
+			(containerLength < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+	}
+
+	/*
+	 * note: the engine takes every container; one which is rejected is freed
+	 * and its place in the array set to NULL
+	 */
+
+	// check the containers for reserved entities
+
+	for(ii = 0; ii < containerLength; ii++) {
+		if(containers[ii] == NULL) {
+			DISPLAY_INVALID_ARGS;
+			return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
+		}
+
+		if(container_exists(containers[ii], SEARCHD_DOMAIN_KEY,
+					SEARCHD_DOMAIN_KEY_LENGTH)) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"unable to use container #%i, contains '%s' entity",
+					container_getUid(containers[ii]),
+					SEARCHD_DOMAIN_KEY);
+			return SEARCH_ENGINE_ERROR_CORE_CONTAINER_HAS_RESERVED_KEY;
+		}
+	}
+
+	// determine if domain exists
+
+	if(spinlock_readLock(&engine->lock) < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_READ_LOCK_FAILURE;
+	}
+
+	if((bptree_get(&engine->indexes, domainKey, domainKeyLength,
+					((void *)&searchIndex)) < 0) ||
+			(searchIndex == NULL)) {
+		spinlock_readUnlock(&engine->lock);
+
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"unable to locate domain '%s' to bulk-put %i containers",
+				domainKey, containerLength);
+
+		return SEARCH_ENGINE_ERROR_DOMAIN_FAILED_TO_LOCATE;
+	}
+
+	spinlock_readUnlock(&engine->lock);
+
+	if(engine->shardLength > 0) {
+		return shard_putBulk(engine, domainKey, containers, containerLength);
+	}
+
+	timer = time_getTimeMus();
+
+	entries = (SearchEngineQueueEntry *)malloc(
+			sizeof(SearchEngineQueueEntry) *
+			SEARCH_ENGINE_QUEUE_BATCH_LENGTH);
+	arguments = (void **)malloc(sizeof(void *) *
+			SEARCH_ENGINE_QUEUE_BATCH_LENGTH);
+
+	// execute the containers in batches, without the command queue
+
+	for(ii = 0; ii < containerLength; ii += entryLength) {
+		entryLength = (containerLength - ii);
+
+		if(entryLength > SEARCH_ENGINE_QUEUE_BATCH_LENGTH) {
+			entryLength = SEARCH_ENGINE_QUEUE_BATCH_LENGTH;
+		}
+
+		memset(entries, 0,
+				(int)(sizeof(SearchEngineQueueEntry) * entryLength));
+
+		prepareLength = 0;
 
-	if((hasUid) || (isImmediate)) {
-		if(searchEngineCommon_buildUidKey(container_getUid(container),
-					key, &keyLength) < 0) {
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to build index key for container #%i domain '%s'",
-					container_getUid(container), domainKey);
-			container_unlock(container);
-			return SEARCH_ENGINE_ERROR_COMMON_FAILED_TO_BUILD_UID_KEY;
-		}
-	}
+		for(nn = 0; nn < entryLength; nn++) {
+			container = containers[(ii + nn)];
 
-	// determine if the container cannot be added due to duplicate user-key
+			entries[nn].type = SEARCH_ENGINE_QUEUE_COMMAND_ERROR;
 
-	if(container_checkUserKeyIndexes(engine, searchIndex, container) == 1) {
-		log_logf(engine->log, LOG_LEVEL_INFO,
-				"container contains duplicate user-key index values, "
-				"rejecting");
-		container_unlock(container);
-		return SEARCH_ENGINE_ERROR_CORE_CONTAINER_HAS_DUPLICATE_USER_KEY_INDEX;
-	}
+			// set UID on container, if required
 
-	// determine if the container already exists
+			if(container_getUid(container) == 0) {
+				mutex_lock(&engine->settings.mutex);
 
-	if(hasUid) {
-		if(managedIndex_get(&engine->containers, key, keyLength,
-					((void *)&localContainer)) == 0) {
-			if(container_lock(localContainer) < 0) {
-				log_logf(engine->log, LOG_LEVEL_WARNING,
-						"failed to obtain container read lock for removal");
-			}
+				engine->settings.uidCounter += 1;
 
-			// remove the old container from the system (note that this
-			// automatically places the container on the queue for deletion,
-			// which in turn removes the existing indexes)
+				container_setUid(container, engine->settings.uidCounter);
 
-			if(managedIndex_remove(&engine->containers, key, keyLength) < 0) {
+				mutex_unlock(&engine->settings.mutex);
+			}
+
+			if(container_lock(container) < 0) {
 				log_logf(engine->log, LOG_LEVEL_ERROR,
-						"failed to remove container #%i domain '%s' from "
-						"master index",
-						container_getUid(localContainer), domainKey);
+						"failed to obtain container read lock for bulk-put");
+				container_freePtr(container);
+				containers[(ii + nn)] = NULL;
+				continue;
+			}
+
+			// determine if the container cannot be added due to duplicate
+			// user-key
+
+			if(container_checkUserKeyIndexes(engine, searchIndex,
+						container) == 1) {
+				log_logf(engine->log, LOG_LEVEL_INFO,
+						"container #%i contains duplicate user-key index "
+						"values, rejecting",
+						container_getUid(container));
 				container_unlock(container);
-				container_unlock(localContainer);
-				return SEARCH_ENGINE_ERROR_CORE_FAILED_TO_DELETE_CONTAINER;
+				container_freePtr(container);
+				containers[(ii + nn)] = NULL;
+				continue;
 			}
 
-			container_unlock(localContainer);
+			container_unlock(container);
+
+			// update the container with reserved entities
+
+			container_putString(container, SEARCHD_DOMAIN_KEY,
+					SEARCHD_DOMAIN_KEY_LENGTH, domainKey, domainKeyLength);
+
+			// a container replaces any existing one of the same UID as the
+			// batch is applied, in order, including one earlier in the batch
+
+			entries[nn].type = SEARCH_ENGINE_QUEUE_COMMAND_REPLACE;
+			entries[nn].isLogged = atrue;
+			entries[nn].payload = (void *)container;
+			entries[nn].engine = engine;
+
+			arguments[prepareLength] = (void *)&(entries[nn]);
+			prepareLength++;
 		}
-	}
 
-	// unlock the container
+		// calculate the relevancy of the batch in parallel
 
-	container_unlock(container);
+		searchExecutor_execute(&engine->executor, queue_prepareEntry,
+				arguments, prepareLength);
 
-	// update the container with reserved entities
+		// add the containers in order, then index the batch
 
-	container_putString(container, SEARCHD_DOMAIN_KEY,
-			SEARCHD_DOMAIN_KEY_LENGTH, domainKey, domainKeyLength);
+		for(nn = 0; nn < entryLength; nn++) {
+			if(entries[nn].type != SEARCH_ENGINE_QUEUE_COMMAND_REPLACE) {
+				continue;
+			}
 
-	// add the container to the system
+			if(queue_executeAddition(engine, &(entries[nn])) < 0) {
+				containers[(ii + nn)] = NULL;
+				continue;
+			}
 
-	if(isImmediate) {
-		container_calculateRelevancy(engine, container);
+			if(entries[nn].ticket < 0) {
+				isLogFailed = atrue;
+			}
+			else if(entries[nn].ticket > ticket) {
+				ticket = entries[nn].ticket;
+			}
 
-		if(managedIndex_put(&engine->containers, key, keyLength, container,
-					container_calculateMemoryLength(container)) < 0) {
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to put container #%i in master index for "
-					"domain '%s'",
-					container_getUid(container), domainKey);
-			return SEARCH_ENGINE_ERROR_CORE_FAILED_TO_PUT_CONTAINER;
+			result++;
 		}
 
-		if(container_updateIndexes(engine, atrue, searchIndex, container) < 0) {
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to put indexes for container #%i domain '%s'",
-					container_getUid(container), domainKey);
-			return SEARCH_ENGINE_ERROR_CORE_FAILED_TO_UPDATE_CONTAINER_INDEXES;
-		}
+		pipeline_flush(engine);
 	}
-	else {
-		entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_PUT, container);
 
-		mutex_lock(&engine->queueMutex);
+	free(entries);
+	free(arguments);
 
-		if(fifostack_push(&engine->queue, entry) < 0) {
-			free(entry);
-		}
+	// sync the write-ahead log once for the whole bulk-put, which is only
+	// acknowledged once all of it is durable in the log
 
-		mutex_unlock(&engine->queueMutex);
+	if(isLogFailed) {
+		return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+	}
+	else if(ticket > 0) {
+		if(searchWal_sync(&engine->wal, ticket) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to sync write-ahead log for bulk-put of "
+					"%i containers", result);
+			return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+		}
 	}
 
-	return uid;
+	log_logf(engine->log, LOG_LEVEL_DEBUG,
+			"bulk-put %i of %i containers in domain '%s' in %0.6f seconds",
+			result, containerLength, domainKey,
+			time_getElapsedMusInSeconds(timer));
+
+	return result;
 }
 
 int searchEngine_update(SearchEngine *engine, char *domainKey,
@@ -5223,6 +8449,7 @@ int searchEngine_update(SearchEngine *engine, char *domainKey,
 	int keyLength = 0;
 	int nameLength = 0;
 	int domainKeyLength = 0;
+	alint ticket = 0;
 	char *errorMessage = NULL;
 	char key[128];
 
@@ -5279,6 +8506,11 @@ int searchEngine_update(SearchEngine *engine, char *domainKey,
 		return SEARCH_ENGINE_ERROR_CORE_MISSING_UID;
 	}
 
+	if(engine->shardLength > 0) {
+		return searchEngine_update(shard_getEngine(engine, uid), domainKey,
+				container, isImmediate, flags);
+	}
+
 	// read-lock the container
 
 	if(container_lock(container) < 0) {
@@ -5373,12 +8605,15 @@ int searchEngine_update(SearchEngine *engine, char *domainKey,
 		}
 
 		if(container_updateIndexes(engine, atrue, searchIndex,
-					updatedContainer) < 0) {
+					updatedContainer, NULL) < 0) {
 			log_logf(engine->log, LOG_LEVEL_ERROR,
 					"failed to put indexes for container #%i domain '%s'",
 					container_getUid(updatedContainer), domainKey);
 			return SEARCH_ENGINE_ERROR_CORE_FAILED_TO_UPDATE_CONTAINER_INDEXES;
 		}
+
+		ticket = wal_appendContainer(engine, SEARCH_WAL_RECORD_TYPE_UPDATE,
+				updatedContainer);
 	}
 	else {
 		entry = queue_buildEntry(SEARCH_ENGINE_QUEUE_COMMAND_UPDATE,
@@ -5388,6 +8623,9 @@ int searchEngine_update(SearchEngine *engine, char *domainKey,
 
 		mutex_lock(&engine->queueMutex);
 
+		ticket = wal_appendContainer(engine, SEARCH_WAL_RECORD_TYPE_UPDATE,
+				updatedContainer);
+
 		if(fifostack_push(&engine->queue, entry) < 0) {
 			free(entry);
 		}
@@ -5395,6 +8633,20 @@ int searchEngine_update(SearchEngine *engine, char *domainKey,
 		mutex_unlock(&engine->queueMutex);
 	}
 
+	// a write is only acknowledged once it is durable in the log
+
+	if(ticket < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+	}
+	else if(ticket > 0) {
+		if(searchWal_sync(&engine->wal, ticket) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to sync write-ahead log for container #%i",
+					uid);
+			return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+		}
+	}
+
 	return uid;
 }
 
@@ -5428,6 +8680,32 @@ int searchEngine_updateByAttribute(SearchEngine *engine, char *domainKey,
 				flags);
 	}
 
+	// locate the container's UID on its shard, then update it there
+
+	if(engine->shardLength > 0) {
+		if((string = container_getString(container, attribute,
+						strlen(attribute), &stringLength)) == NULL) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to obtain attribute '%s' value from "
+					"container #%i domain '%s'", attribute,
+					container_getUid(container), domainKey);
+			return SEARCH_ENGINE_ERROR_CORE_CONTAINER_MISSING_ATTRIBUTE;
+		}
+
+		uid = shard_locateUidByAttribute(engine, attribute, string);
+
+		free(string);
+
+		if(uid < 0) {
+			return uid;
+		}
+
+		container_setUid(container, uid);
+
+		return searchEngine_update(engine, domainKey, container,
+				isImmediate, flags);
+	}
+
 	// determine if an index exists for this attribute
 
 	attributeLength = strlen(attribute);
@@ -5542,6 +8820,7 @@ int searchEngine_updateByAttribute(SearchEngine *engine, char *domainKey,
 int searchEngine_delete(SearchEngine *engine, int uid)
 {
 	int keyLength = 0;
+	alint ticket = 0;
 	char key[128];
 
 	Container *localContainer = NULL;
@@ -5551,6 +8830,10 @@ int searchEngine_delete(SearchEngine *engine, int uid)
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	if(engine->shardLength > 0) {
+		return searchEngine_delete(shard_getEngine(engine, uid), uid);
+	}
+
 	// build the container UID key
 
 	if(searchEngineCommon_buildUidKey(uid, key, &keyLength) < 0) {
@@ -5587,6 +8870,20 @@ int searchEngine_delete(SearchEngine *engine, int uid)
 
 	container_unlock(localContainer);
 
+	// a delete is only acknowledged once it is durable in the log
+
+	if((ticket = wal_appendDelete(engine, uid)) < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+	}
+	else if(ticket > 0) {
+		if(searchWal_sync(&engine->wal, ticket) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to sync write-ahead log for container #%i",
+					uid);
+			return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+		}
+	}
+
 	return uid;
 }
 
@@ -5600,6 +8897,7 @@ int searchEngine_deleteByAttribute(SearchEngine *engine, char *attribute,
 	int resultSetLength = 0;
 	int stringResultLength = 0;
 	int *resultSet = NULL;
+	alint ticket = 0;
 	char *string = NULL;
 	char key[128];
 
@@ -5611,6 +8909,15 @@ int searchEngine_deleteByAttribute(SearchEngine *engine, char *attribute,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	if(engine->shardLength > 0) {
+		if((uid = shard_locateUidByAttribute(engine, attribute,
+						value)) < 0) {
+			return uid;
+		}
+
+		return searchEngine_delete(engine, uid);
+	}
+
 	// determine if an index exists for this attribute
 
 	stringLength = strlen(attribute);
@@ -5732,6 +9039,20 @@ int searchEngine_deleteByAttribute(SearchEngine *engine, char *attribute,
 
 	container_unlock(localContainer);
 
+	// a delete is only acknowledged once it is durable in the log
+
+	if((ticket = wal_appendDelete(engine, uid)) < 0) {
+		return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+	}
+	else if(ticket > 0) {
+		if(searchWal_sync(&engine->wal, ticket) < 0) {
+			log_logf(engine->log, LOG_LEVEL_ERROR,
+					"failed to sync write-ahead log for container #%i",
+					uid);
+			return SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE;
+		}
+	}
+
 	return uid;
 }
 
@@ -5888,13 +9209,13 @@ int searchEngine_search(SearchEngine *engine, char *domainKey, char *attribute,
 	int minStringLength = 0;
 	int delimitersLength = 0;
 	int *tokenLengths = NULL;
-	int *resultSet = NULL;
 	char *string = NULL;
 	char *delimiters = NULL;
 	char **tokenList = NULL;
 
 	SearchIndex *searchIndex = NULL;
 	IndexRegistryIndex *indexType = NULL;
+	PostingView *view = NULL;
 
 	if((engine == NULL) || (domainKey == NULL) ||
 			((keyLength = strlen(domainKey)) < 1) || (attribute == NULL) ||
@@ -5974,8 +9295,8 @@ int searchEngine_search(SearchEngine *engine, char *domainKey, char *attribute,
 
 		stringLength = stringResultLength;
 
-		resultSet = searchIndex_getString(searchIndex, indexType,
-				string, &resultSetLength);
+		view = searchIndex_getStringView(searchIndex, indexType, string);
+		resultSetLength = ((view != NULL) ? view->length : 0);
 
 		log_logf(engine->log, LOG_LEVEL_DEBUG,
 				"obtained %i results from domain '%s' for "
@@ -5983,15 +9304,11 @@ int searchEngine_search(SearchEngine *engine, char *domainKey, char *attribute,
 				resultSetLength, searchIndex->name,
 				string, indexType->name);
 
-		if((resultSet == NULL) || (resultSetLength < 1)) {
-			if(resultSet != NULL) {
-				free(resultSet);
-			}
+		if(view == NULL) {
 			intersect_put(intersect, intersect->length, 0);
 		}
 		else {
-			intersect_putArrayStatic(intersect, atrue, resultSet,
-					resultSetLength);
+			intersect_putView(intersect, view);
 		}
 
 		free(string);
@@ -6059,8 +9376,9 @@ int searchEngine_search(SearchEngine *engine, char *domainKey, char *attribute,
 			continue;
 		}
 
-		resultSet = searchIndex_getString(searchIndex, indexType,
-				tokenList[ii], &resultSetLength);
+		view = searchIndex_getStringView(searchIndex, indexType,
+				tokenList[ii]);
+		resultSetLength = ((view != NULL) ? view->length : 0);
 
 		log_logf(engine->log, LOG_LEVEL_DEBUG,
 				"obtained %i results from domain '%s' for "
@@ -6068,16 +9386,13 @@ int searchEngine_search(SearchEngine *engine, char *domainKey, char *attribute,
 				resultSetLength, searchIndex->name,
 				tokenList[ii], indexType->name);
 
-		if((resultSet == NULL) || (resultSetLength < 1)) {
-			if(resultSet != NULL) {
-				free(resultSet);
-			}
+		if(view == NULL) {
 			free(tokenList[ii]);
 			intersect_put(intersect, intersect->length, 0);
 			continue;
 		}
 
-		intersect_putArrayStatic(intersect, atrue, resultSet, resultSetLength);
+		intersect_putView(intersect, view);
 
 		free(tokenList[ii]);
 	}
@@ -6100,13 +9415,13 @@ int searchEngine_searchGlobal(SearchEngine *engine, char *attribute,
 	int minStringLength = 0;
 	int delimitersLength = 0;
 	int *tokenLengths = NULL;
-	int *resultSet = NULL;
 	char *string = NULL;
 	char *delimiters = NULL;
 	char **tokenList = NULL;
 
 	Intersect localIntersect;
 	IndexRegistryIndex *indexType = NULL;
+	PostingView *view = NULL;
 
 	if((engine == NULL) || (attribute == NULL) || (value == NULL) ||
 			(intersect == NULL)) {
@@ -6178,8 +9493,9 @@ int searchEngine_searchGlobal(SearchEngine *engine, char *attribute,
 				continue;
 			}
 
-			resultSet = searchIndex_getString(engine->domains[ii],
-					indexType, string, &resultSetLength);
+			view = searchIndex_getStringView(engine->domains[ii],
+					indexType, string);
+			resultSetLength = ((view != NULL) ? view->length : 0);
 
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
 					"obtained %i results from domain '%s' for "
@@ -6187,16 +9503,12 @@ int searchEngine_searchGlobal(SearchEngine *engine, char *attribute,
 					resultSetLength, engine->domains[ii]->name,
 					string, indexType->name);
 
-			if((resultSet == NULL) || (resultSetLength < 1)) {
-				if(resultSet != NULL) {
-					free(resultSet);
-				}
+			if(view == NULL) {
 				intersect_put(&localIntersect, localIntersect.length, 0);
 				continue;
 			}
-	
-			intersect_putArrayStatic(&localIntersect, atrue, resultSet,
-					resultSetLength);
+
+			intersect_putView(&localIntersect, view);
 		}
 
 		spinlock_readUnlock(&engine->lock);
@@ -6299,8 +9611,9 @@ int searchEngine_searchGlobal(SearchEngine *engine, char *attribute,
 				continue;
 			}
 
-			resultSet = searchIndex_getString(engine->domains[ii], indexType,
-					tokenList[nn], &resultSetLength);
+			view = searchIndex_getStringView(engine->domains[ii], indexType,
+					tokenList[nn]);
+			resultSetLength = ((view != NULL) ? view->length : 0);
 
 			log_logf(engine->log, LOG_LEVEL_DEBUG,
 					"obtained %i results from domain '%s' for "
@@ -6308,16 +9621,12 @@ int searchEngine_searchGlobal(SearchEngine *engine, char *attribute,
 					resultSetLength, engine->domains[ii]->name,
 					tokenList[nn], indexType->name);
 
-			if((resultSet == NULL) || (resultSetLength < 1)) {
-				if(resultSet != NULL) {
-					free(resultSet);
-				}
+			if(view == NULL) {
 				intersect_put(&localIntersect, localIntersect.length, 0);
 				continue;
 			}
 
-			intersect_putArrayStatic(&localIntersect, atrue, resultSet,
-					resultSetLength);
+			intersect_putView(&localIntersect, view);
 		}
 	}
 
@@ -6600,6 +9909,21 @@ int searchEngine_searchRangeGeocoord(SearchEngine *engine, char *domainKey,
 
 	spinlock_readUnlock(&engine->lock);
 
+	// convert distance to miles
+
+	if((miles = geocoord_toMiles(type, distance)) < 0.0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to convert distance units to miles");
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_GEO_COORD_DISTANCE_TYPE;
+	}
+
+	// search the covering cells of the geo index, when one exists
+
+	if((indexType = geocoord_getIndex(engine)) != NULL) {
+		return geocoord_search(engine, searchIndex, indexType, latitude,
+				longitude, miles, intersect);
+	}
+
 	// determine if the latitude and longitude indexes exist
 
 	attribute = "latitude";
@@ -6664,36 +9988,6 @@ int searchEngine_searchRangeGeocoord(SearchEngine *engine, char *domainKey,
 		return SEARCH_ENGINE_ERROR_INDEX_TYPE_INVALID;
 	}
 
-	// convert distance to miles
-
-	switch(type) {
-		case SEARCH_ENGINE_GEO_COORD_TYPE_MILES:
-			miles = distance;
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_YARDS:
-			miles = (distance * 1760.0);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_FEET:
-			miles = (distance * 5280.0);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_KILOMETERS:
-			miles = (distance * 0.621371192);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_METERS:
-			miles = ((distance * 0.621371192) * 1000.0);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_UNKNOWN:
-		default:
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to convert distance units to miles");
-			return SEARCH_ENGINE_ERROR_CORE_INVALID_GEO_COORD_DISTANCE_TYPE;
-	}
-
 	// execute search
 
 	intersect_init(&localIntersect);
@@ -6711,7 +10005,7 @@ int searchEngine_searchRangeGeocoord(SearchEngine *engine, char *domainKey,
 					RANGE_INDEX_SEARCH_GREATER_THAN,
 					(int)(localLatitude * GEOCOORD_INTEGER_CONVERSION),
 					0.0,
-					intersect)) < 0) {
+					&localIntersect)) < 0) {
 		intersect_free(&localIntersect);
 		return rc;
 	}
@@ -6727,7 +10021,7 @@ int searchEngine_searchRangeGeocoord(SearchEngine *engine, char *domainKey,
 					RANGE_INDEX_SEARCH_LESS_THAN,
 					(int)(localLatitude * GEOCOORD_INTEGER_CONVERSION),
 					0.0,
-					intersect)) < 0) {
+					&localIntersect)) < 0) {
 		intersect_free(&localIntersect);
 		return rc;
 	}
@@ -6750,7 +10044,7 @@ int searchEngine_searchRangeGeocoord(SearchEngine *engine, char *domainKey,
 					RANGE_INDEX_SEARCH_GREATER_THAN,
 					(int)(localLongitude * GEOCOORD_INTEGER_CONVERSION),
 					0.0,
-					intersect)) < 0) {
+					&localIntersect)) < 0) {
 		intersect_free(&localIntersect);
 		return rc;
 	}
@@ -6766,7 +10060,7 @@ int searchEngine_searchRangeGeocoord(SearchEngine *engine, char *domainKey,
 					RANGE_INDEX_SEARCH_LESS_THAN,
 					(int)(localLongitude * GEOCOORD_INTEGER_CONVERSION),
 					0.0,
-					intersect)) < 0) {
+					&localIntersect)) < 0) {
 		intersect_free(&localIntersect);
 		return rc;
 	}
@@ -6817,6 +10111,21 @@ int searchEngine_searchRangeGeocoordGlobal(SearchEngine *engine,
 		return SEARCH_ENGINE_ERROR_CORE_INVALID_ARGUMENTS;
 	}
 
+	// convert distance to miles
+
+	if((miles = geocoord_toMiles(type, distance)) < 0.0) {
+		log_logf(engine->log, LOG_LEVEL_ERROR,
+				"failed to convert distance units to miles");
+		return SEARCH_ENGINE_ERROR_CORE_INVALID_GEO_COORD_DISTANCE_TYPE;
+	}
+
+	// search the covering cells of the geo index, when one exists
+
+	if((indexType = geocoord_getIndex(engine)) != NULL) {
+		return geocoord_search(engine, NULL, indexType, latitude, longitude,
+				miles, intersect);
+	}
+
 	// determine if the latitude and longitude indexes exist
 
 	attribute = "latitude";
@@ -6881,36 +10190,6 @@ int searchEngine_searchRangeGeocoordGlobal(SearchEngine *engine,
 		return SEARCH_ENGINE_ERROR_INDEX_TYPE_INVALID;
 	}
 
-	// convert distance to miles
-
-	switch(type) {
-		case SEARCH_ENGINE_GEO_COORD_TYPE_MILES:
-			miles = distance;
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_YARDS:
-			miles = (distance * 1760.0);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_FEET:
-			miles = (distance * 5280.0);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_KILOMETERS:
-			miles = (distance * 0.621371192);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_METERS:
-			miles = ((distance * 0.621371192) * 1000.0);
-			break;
-
-		case SEARCH_ENGINE_GEO_COORD_TYPE_UNKNOWN:
-		default:
-			log_logf(engine->log, LOG_LEVEL_ERROR,
-					"failed to convert distance units to miles");
-			return SEARCH_ENGINE_ERROR_CORE_INVALID_GEO_COORD_DISTANCE_TYPE;
-	}
-
 	// execute search
 
 	intersect_init(&localIntersect);
@@ -6998,3 +10277,47 @@ int searchEngine_searchRangeGeocoordGlobal(SearchEngine *engine,
 	return SEARCH_ENGINE_ERROR_OK;
 }
 
+GeoIndexPoint *searchEngine_getGeoCoords(SearchEngine *engine, int uid,
+		int *length)
+{
+	int ii = 0;
+
+	GeoIndexPoint *result = NULL;
+	IndexRegistryIndex *indexType = NULL;
+
+	if((engine == NULL) || (uid < 1) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	*length = 0;
+
+	if(engine->shardLength > 0) {
+		return searchEngine_getGeoCoords(shard_getEngine(engine, uid), uid,
+				length);
+	}
+
+	if((indexType = geocoord_getIndex(engine)) == NULL) {
+		return NULL;
+	}
+
+	if(spinlock_readLock(&engine->lock) < 0) {
+		return NULL;
+	}
+
+	for(ii = 0; ii < engine->domainLength; ii++) {
+		if(engine->domains[ii] == NULL) {
+			continue;
+		}
+
+		if((result = searchIndex_getGeoCoordPoints(engine->domains[ii],
+						indexType, uid, length)) != NULL) {
+			break;
+		}
+	}
+
+	spinlock_readUnlock(&engine->lock);
+
+	return result;
+}
+
@@ -41,6 +41,7 @@ typedef enum _SearchEngineErrorCodes {
 	SEARCH_ENGINE_ERROR_CORE_DATA_WRITE_FAILURE = -111,
 	SEARCH_ENGINE_ERROR_CORE_DATA_READ_FAILURE = -112,
 	SEARCH_ENGINE_ERROR_CORE_INVALID_GEO_COORD_DISTANCE_TYPE = -113,
+	SEARCH_ENGINE_ERROR_CORE_WAL_WRITE_FAILURE = -114,
 	SEARCH_ENGINE_ERROR_CORE_CONTAINER_DOES_NOT_EXIST = -120,
 	SEARCH_ENGINE_ERROR_CORE_CONTAINER_ALREADY_EXISTS = -121,
 	SEARCH_ENGINE_ERROR_CORE_CONTAINER_LOCK_FAILURE = -122,
@@ -82,6 +83,14 @@ typedef enum _SearchEngineErrorCodes {
 	SEARCH_ENGINE_ERROR_UNKNOWN = -1024
 } SearchEngineErrorCodes;
 
+typedef enum _SearchEnginePostingTypes {
+	SEARCH_ENGINE_POSTING_TYPE_STRING = 1,
+	SEARCH_ENGINE_POSTING_TYPE_INTEGER,
+	SEARCH_ENGINE_POSTING_TYPE_DOC_VALUES,
+	SEARCH_ENGINE_POSTING_TYPE_GEO_COORD,
+	SEARCH_ENGINE_POSTING_TYPE_ERROR = -1
+} SearchEnginePostingTypes;
+
 typedef enum _SearchEngineGeoCoordTypes {
 	SEARCH_ENGINE_GEO_COORD_TYPE_MILES = 1,
 	SEARCH_ENGINE_GEO_COORD_TYPE_YARDS,
@@ -93,6 +102,8 @@ typedef enum _SearchEngineGeoCoordTypes {
 
 #define SEARCH_ENGINE_CONTAINER_FILE_MAGIC_NUMBER		53468721
 
+#define SEARCH_ENGINE_GEO_COORD_INDEX_KEY				"geocoord"
+
 #define SEARCH_ENGINE_DEFAULT_MAX_CONTAINERS			65536
 
 #define SEARCH_ENGINE_DEFAULT_MAX_CONTAINER_MEMORY		65536
@@ -106,6 +117,12 @@ typedef enum _SearchEngineGeoCoordTypes {
 #define SEARCH_ENGINE_DEFAULT_MAX_SORT_OPERATION_LENGTH	\
 	8388608
 
+#define SEARCH_ENGINE_DEFAULT_QUERY_THREAD_POOL_SIZE	0
+
+#define SEARCH_ENGINE_DEFAULT_SHARD_COUNT				0
+
+#define SEARCH_ENGINE_MAX_SHARD_COUNT					64
+
 #define SEARCH_ENGINE_DEFAULT_DELIMITERS				" |~,;:.][)(}{*@!&-_"
 
 #define SEARCH_ENGINE_DEFAULT_STATE_BACKUP_SECONDS		1200.0
@@ -133,6 +150,7 @@ typedef enum _SearchEngineGeoCoordTypes {
 typedef struct _SearchEngineSettings {
 	aboolean isLogInternallyAllocated;
 	SearchJsonValidationType validationType;
+	aboolean isRestoring;
 	int workerThreadId;
 	int minStringLength;
 	int maxStringLength;
@@ -141,6 +159,7 @@ typedef struct _SearchEngineSettings {
 	alint maxSortOperationMemoryLength;
 	double stateWriteThresholdSeconds;
 	double containerWriteThresholdSeconds;
+	double checkpointThresholdSeconds;
 	char *delimiters;
 	char *statePath;
 	char *containerPath;
@@ -149,21 +168,83 @@ typedef struct _SearchEngineSettings {
 	Mutex mutex;
 } SearchEngineSettings;
 
+/*
+ * Added containers are indexed in batches. The queue worker, or a bulk put,
+ * applies each container operation in order and defers the indexing of the
+ * container to a job; flushing the pipeline tokenizes the pending jobs in
+ * parallel on the executor, then applies their postings with one task per
+ * shard of the indexes, so that no two tasks contend on an index. Removing a
+ * container whose job is still pending drops the job, since the container
+ * was never indexed, which keeps the index operations of each container in
+ * order without a flush on the thread which frees the container.
+ */
+
+typedef struct _SearchEnginePosting {
+	SearchEnginePostingTypes type;
+	int value;
+	int tokenLength;
+	double latitude;
+	double longitude;
+	char *token;
+	IndexRegistryIndex *indexType;
+} SearchEnginePosting;
+
+typedef struct _SearchEngineIndexJob {
+	int uid;
+	int postingRef;
+	int postingLength;
+	char *domainKey;
+	void *engine;
+	Container *container;
+	SearchIndex *searchIndex;
+	SearchEnginePosting *postings;
+} SearchEngineIndexJob;
+
+typedef struct _SearchEnginePipeline {
+	int jobRef;
+	int jobLength;
+	alint jobsApplied;
+	alint flushesApplied;
+	SearchEngineIndexJob *jobs;
+	Mutex mutex;
+} SearchEnginePipeline;
+
+/*
+ * A sharded engine (see searchEngine_setShardCount()) is a router over a set
+ * of child engines, each with its own indexes, containers, worker thread and
+ * write-ahead log. The router owns the metadata (index registry, domains,
+ * authentication & state) and broadcasts changes to it to every shard, routes
+ * each container to the shard of its UID (uid % shardLength), and holds the
+ * doc-values columns, which are shared by the shards. Searches are scattered
+ * to the shards by the compiler, so the search functions of this API must be
+ * called on a shard, not on the router.
+ */
+
 typedef struct _SearchEngine {
 	int domainLength;
+	int shardLength;
+	alint queueExecutedCount;
 	IndexRegistry registry;
 	AuthSystem auth;
 	Bptree indexes;
 	Bptree excludedWords;
+	Bptree docValues;
 	SearchIndex **domains;
 	ManagedIndex containers;
 	SearchEngineSettings settings;
 	FifoStack queue;
 	TmfContext tmf;
+	SearchExecutor executor;
+	SearchEnginePipeline pipeline;
+	SearchWal wal;
+	SearchSegment segment;
 	Esa esa;
 	Log *log;
 	Mutex queueMutex;
+	Mutex docValuesMutex;
 	Spinlock lock;
+	struct _SearchEngine *router;
+	struct _SearchEngine **shards;
 } SearchEngine;
 
 
@@ -189,6 +270,8 @@ int searchEngine_lock(SearchEngine *engine);
 
 int searchEngine_unlock(SearchEngine *engine);
 
+int searchEngine_setShardCount(SearchEngine *engine, int shardLength);
+
 int searchEngine_setMaxContainerCount(SearchEngine *engine,
 		alint maxCachedItemCount);
 
@@ -204,6 +287,9 @@ int searchEngine_setStringIndexThresholds(SearchEngine *engine,
 int searchEngine_setMaxSortOperationMemoryLength(SearchEngine *engine,
 		alint maxSortOperationMemoryLength);
 
+int searchEngine_setQueryThreadPoolSize(SearchEngine *engine,
+		int threadPoolSize);
+
 int searchEngine_setStringDelimiters(SearchEngine *engine, char *delimiters,
 		int delimitersLength);
 
@@ -213,6 +299,10 @@ int searchEngine_setStateBackupAttributes(SearchEngine *engine,
 int searchEngine_setIndexBackupAttributes(SearchEngine *engine,
 		double containerWriteThresholdSeconds, char *containerPath);
 
+int searchEngine_setWalAttributes(SearchEngine *engine,
+		SearchWalSyncTypes syncType, double syncIntervalSeconds,
+		double checkpointThresholdSeconds);
+
 int searchEngine_setJsonLangValidationType(SearchEngine *engine,
 		SearchJsonValidationType validationType);
 
@@ -230,6 +320,8 @@ int searchEngine_backupData(SearchEngine *engine);
 
 int searchEngine_restoreData(SearchEngine *engine, char *filename);
 
+int searchEngine_checkpointData(SearchEngine *engine);
+
 int searchEngine_newIndex(SearchEngine *engine, IndexRegistryTypes type,
 		char *key, char *name);
 
@@ -243,6 +335,13 @@ int searchEngine_renameIndex(SearchEngine *engine, char *key, char *newKey,
 int searchEngine_setIndexStringThresholds(SearchEngine *engine, char *key,
 		int minStringLength, int maxStringLength);
 
+int searchEngine_setIndexDocValues(SearchEngine *engine, char *key,
+		aboolean isDocValues);
+
+int searchEngine_syncIndexSettings(SearchEngine *engine, char *key);
+
+DocValues *searchEngine_getDocValues(SearchEngine *engine, char *attribute);
+
 int searchEngine_resetIndex(SearchEngine *engine, char *key,
 		IndexRegistryTypes newType, char *newKey, char *newName);
 
@@ -288,6 +387,9 @@ int searchEngine_unlockGet(SearchEngine *engine, Container *container);
 int searchEngine_put(SearchEngine *engine, char *domainKey,
 		Container *container, aboolean isImmediate);
 
+int searchEngine_putBulk(SearchEngine *engine, char *domainKey,
+		Container **containers, int containerLength);
+
 int searchEngine_update(SearchEngine *engine, char *domainKey,
 		Container *container, aboolean isImmediate, char flags);
 
@@ -327,6 +429,9 @@ int searchEngine_searchRangeGeocoordGlobal(SearchEngine *engine,
 		SearchEngineGeoCoordTypes type, double latitude, double longitude,
 		double distance, Intersect *intersect);
 
+GeoIndexPoint *searchEngine_getGeoCoords(SearchEngine *engine, int uid,
+		int *length);
+
 
 #if defined(__cplusplus)
 };
@@ -0,0 +1,313 @@
+/*
+ * search_executor.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The query executor component for the search-engine, a shared thread pool
+ * which runs the independent parts of a query in parallel.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+
+#include "core/core.h"
+#include "search/search.h"
+#define _SEARCH_SYSTEM_COMPONENT
+#include "search/system/search_executor.h"
+
+
+// define search executor private constants
+
+#define SEARCH_EXECUTOR_MIN_NAP_MICROS					64
+
+#define SEARCH_EXECUTOR_MAX_NAP_MICROS					2048
+
+#define SEARCH_EXECUTOR_WAIT_MICROS						32
+
+
+// declare search executor private functions
+
+static SearchExecutorBatch *claimTask(SearchExecutor *executor,
+		SearchExecutorBatch *batch, int *index);
+
+static void completeTask(SearchExecutor *executor,
+		SearchExecutorBatch *batch, aboolean isStolen);
+
+static void *thread_searchExecutorWorker(void *threadContext,
+		void *argument);
+
+
+// define search executor private functions
+
+static SearchExecutorBatch *claimTask(SearchExecutor *executor,
+		SearchExecutorBatch *batch, int *index)
+{
+	SearchExecutorBatch *result = NULL;
+
+	// claim from the given batch, or from any open batch when stealing
+
+	mutex_lock(&executor->mutex);
+
+	if(batch != NULL) {
+		if(batch->claimed < batch->length) {
+			result = batch;
+		}
+	}
+	else {
+		for(result = executor->batches; result != NULL;
+				result = result->next) {
+			if(result->claimed < result->length) {
+				break;
+			}
+		}
+	}
+
+	if(result != NULL) {
+		*index = result->claimed;
+		result->claimed += 1;
+	}
+
+	mutex_unlock(&executor->mutex);
+
+	return result;
+}
+
+static void completeTask(SearchExecutor *executor,
+		SearchExecutorBatch *batch, aboolean isStolen)
+{
+	mutex_lock(&executor->mutex);
+
+	batch->completed += 1;
+
+	executor->tasksExecuted += 1;
+
+	if(isStolen) {
+		executor->tasksStolen += 1;
+	}
+
+	mutex_unlock(&executor->mutex);
+}
+
+static void *thread_searchExecutorWorker(void *threadContext,
+		void *argument)
+{
+	aboolean isNapping = afalse;
+	int index = 0;
+	int napMicros = 0;
+
+	TmfThread *thread = NULL;
+	SearchExecutor *executor = NULL;
+	SearchExecutorBatch *batch = NULL;
+
+	if((threadContext == NULL) || (argument == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	thread = (TmfThread *)threadContext;
+	executor = (SearchExecutor *)argument;
+
+	log_logf(executor->log, LOG_LEVEL_DEBUG,
+			"search executor thread #%i (%i) started",
+			thread->uid, thread->systemId);
+
+	napMicros = SEARCH_EXECUTOR_MIN_NAP_MICROS;
+
+	while((thread->state == THREAD_STATE_RUNNING) &&
+			(thread->signal == THREAD_SIGNAL_OK)) {
+		if((batch = claimTask(executor, NULL, &index)) == NULL) {
+			if(!isNapping) {
+				mutex_lock(thread->mutex);
+				thread->status = THREAD_STATUS_NAPPING;
+				mutex_unlock(thread->mutex);
+
+				isNapping = atrue;
+			}
+
+			time_usleep(napMicros);
+
+			if(napMicros < SEARCH_EXECUTOR_MAX_NAP_MICROS) {
+				napMicros *= 2;
+			}
+
+			continue;
+		}
+
+		if(isNapping) {
+			mutex_lock(thread->mutex);
+			thread->status = THREAD_STATUS_BUSY;
+			mutex_unlock(thread->mutex);
+
+			isNapping = afalse;
+		}
+
+		napMicros = SEARCH_EXECUTOR_MIN_NAP_MICROS;
+
+		batch->function(batch->arguments[index]);
+
+		completeTask(executor, batch, atrue);
+	}
+
+	log_logf(executor->log, LOG_LEVEL_DEBUG,
+			"search executor thread #%i (%i) shut down",
+			thread->uid, thread->systemId);
+
+	return NULL;
+}
+
+
+// define search executor public functions
+
+int searchExecutor_init(SearchExecutor *executor, int threadPoolSize,
+		Log *log)
+{
+	int ii = 0;
+
+	if((executor == NULL) || (threadPoolSize < 0) ||
+			(threadPoolSize > SEARCH_EXECUTOR_MAX_THREAD_POOL_SIZE) ||
+			(log == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(executor, 0, (int)(sizeof(SearchExecutor)));
+
+	executor->threadPoolSize = threadPoolSize;
+	executor->tasksExecuted = 0;
+	executor->tasksStolen = 0;
+	executor->batches = NULL;
+	executor->log = log;
+
+	mutex_init(&executor->mutex);
+
+	if(tmf_init(&executor->tmf) < 0) {
+		return -1;
+	}
+
+	if(threadPoolSize < 1) {
+		return 0;
+	}
+
+	executor->threadIds = (int *)malloc(sizeof(int) * threadPoolSize);
+
+	for(ii = 0; ii < threadPoolSize; ii++) {
+		if(tmf_spawnThread(&executor->tmf,
+					thread_searchExecutorWorker,
+					(void *)executor,
+					&executor->threadIds[ii]) < 0) {
+			log_logf(log, LOG_LEVEL_ERROR,
+					"failed to spawn search executor thread %i of %i",
+					(ii + 1), threadPoolSize);
+			executor->threadPoolSize = ii;
+			return -1;
+		}
+	}
+
+	log_logf(log, LOG_LEVEL_INFO,
+			"search executor started with %i thread(s)", threadPoolSize);
+
+	return 0;
+}
+
+int searchExecutor_free(SearchExecutor *executor)
+{
+	int result = 0;
+
+	if(executor == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(tmf_free(&executor->tmf) < 0) {
+		result = -1;
+	}
+
+	if(executor->threadIds != NULL) {
+		free(executor->threadIds);
+	}
+
+	mutex_free(&executor->mutex);
+
+	memset(executor, 0, (int)(sizeof(SearchExecutor)));
+
+	return result;
+}
+
+int searchExecutor_execute(SearchExecutor *executor,
+		SearchExecutorTaskFunction function, void **arguments, int length)
+{
+	aboolean isComplete = afalse;
+	int ii = 0;
+	int index = 0;
+
+	SearchExecutorBatch batch;
+	SearchExecutorBatch **link = NULL;
+
+	if((executor == NULL) || (function == NULL) || (arguments == NULL) ||
+			(length < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	// without a pool, or without enough work to share, run in place
+
+	if((executor->threadPoolSize < 1) || (length < 2)) {
+		for(ii = 0; ii < length; ii++) {
+			function(arguments[ii]);
+		}
+
+		return 0;
+	}
+
+	memset(&batch, 0, (int)(sizeof(SearchExecutorBatch)));
+
+	batch.length = length;
+	batch.claimed = 0;
+	batch.completed = 0;
+	batch.arguments = arguments;
+	batch.function = function;
+
+	mutex_lock(&executor->mutex);
+
+	batch.next = executor->batches;
+	executor->batches = &batch;
+
+	mutex_unlock(&executor->mutex);
+
+	while(claimTask(executor, &batch, &index) != NULL) {
+		function(arguments[index]);
+
+		completeTask(executor, &batch, afalse);
+	}
+
+	// every task is claimed, so withdraw the batch from the pool and wait
+	// for any stolen tasks still running
+
+	mutex_lock(&executor->mutex);
+
+	for(link = &executor->batches; *link != NULL; link = &(*link)->next) {
+		if(*link == &batch) {
+			*link = batch.next;
+			break;
+		}
+	}
+
+	mutex_unlock(&executor->mutex);
+
+	while(!isComplete) {
+		mutex_lock(&executor->mutex);
+		isComplete = (aboolean)(batch.completed >= batch.length);
+		mutex_unlock(&executor->mutex);
+
+		if(!isComplete) {
+			time_usleep(SEARCH_EXECUTOR_WAIT_MICROS);
+		}
+	}
+
+	return 0;
+}
+
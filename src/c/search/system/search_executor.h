@@ -0,0 +1,78 @@
+/*
+ * search_executor.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The query executor component for the search-engine, a shared thread pool
+ * which runs the independent parts of a query in parallel, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_SEARCH_SYSTEM_SEARCH_EXECUTOR_H)
+
+#define _SEARCH_SYSTEM_SEARCH_EXECUTOR_H
+
+#if !defined(_SEARCH_H) && !defined(_SEARCH_SYSTEM_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _SEARCH_H || _SEARCH_SYSTEM_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define search executor public constants
+
+#define SEARCH_EXECUTOR_MAX_THREAD_POOL_SIZE			256
+
+
+// define search executor public data types
+
+typedef void (*SearchExecutorTaskFunction)(void *argument);
+
+/*
+ * A batch is the set of tasks from one call to searchExecutor_execute(); the
+ * calling thread works through its own batch while idle pool threads steal
+ * tasks from it, so a batch never waits on the pool to make progress.
+ */
+
+typedef struct _SearchExecutorBatch {
+	int length;
+	int claimed;
+	int completed;
+	void **arguments;
+	SearchExecutorTaskFunction function;
+	struct _SearchExecutorBatch *next;
+} SearchExecutorBatch;
+
+typedef struct _SearchExecutor {
+	int threadPoolSize;
+	int *threadIds;
+	alint tasksExecuted;
+	alint tasksStolen;
+	SearchExecutorBatch *batches;
+	TmfContext tmf;
+	Log *log;
+	Mutex mutex;
+} SearchExecutor;
+
+
+// delcare search executor public functions
+
+int searchExecutor_init(SearchExecutor *executor, int threadPoolSize,
+		Log *log);
+
+int searchExecutor_free(SearchExecutor *executor);
+
+int searchExecutor_execute(SearchExecutor *executor,
+		SearchExecutorTaskFunction function, void **arguments, int length);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _SEARCH_SYSTEM_SEARCH_EXECUTOR_H
+
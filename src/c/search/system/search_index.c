@@ -5,7 +5,7 @@
  * intellectual property of Joshua S. English, all rights reserved.
  *
  * A system component for the search-engine to maintain the set of exact,
- * wildcard, and integer indexes for the search-engine system.
+ * wildcard, integer, and geo indexes for the search-engine system.
  *
  * Written by Josh English.
  */
@@ -22,16 +22,16 @@
 
 static void freeUserKeyEntry(void *memory)
 {
-	IntegerArray *entry = NULL;
+	PostingList *entry = NULL;
 
 	if(memory == NULL) {
 		DISPLAY_INVALID_ARGS;
 		return;
 	}
 
-	entry = (IntegerArray *)memory;
+	entry = (PostingList *)memory;
 
-	integer_freePtr(entry);
+	posting_freePtr(entry);
 }
 
 static SearchIndexEntry *indexNew(SearchIndex *index, IndexRegistryIndex *type)
@@ -72,6 +72,11 @@ static SearchIndexEntry *indexNew(SearchIndex *index, IndexRegistryIndex *type)
 			rangeIndex_init(result->index, type->key);
 			break;
 
+		case INDEX_REGISTRY_TYPE_GEO:
+			result->index = (void *)malloc(sizeof(GeoIndex));
+			geoIndex_init(result->index, type->key);
+			break;
+
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			DISPLAY_INVALID_ARGS;
@@ -80,6 +85,10 @@ static SearchIndexEntry *indexNew(SearchIndex *index, IndexRegistryIndex *type)
 	}
 
 	result->key = strdup(type->key);
+	result->segment = NULL;
+	result->section = NULL;
+
+	posting_init(&result->mask);
 
 	mutex_init(&result->mutex);
 
@@ -114,6 +123,10 @@ static void indexFree(void *memory)
 				rangeIndex_free(entry->index);
 				break;
 
+			case INDEX_REGISTRY_TYPE_GEO:
+				geoIndex_free(entry->index);
+				break;
+
 			case INDEX_REGISTRY_TYPE_END_OF_LIST:
 			default:
 				DISPLAY_INVALID_ARGS;
@@ -128,6 +141,8 @@ static void indexFree(void *memory)
 		free(entry->key);
 	}
 
+	posting_free(&entry->mask);
+
 	mutex_unlock(&entry->mutex);
 
 	mutex_free(&entry->mutex);
@@ -144,6 +159,535 @@ static void indexFreeNothing(void *memory)
 	}
 }
 
+static int compareIntegers(const void *left, const void *right)
+{
+	if(*((int *)left) < *((int *)right)) {
+		return -1;
+	}
+	else if(*((int *)left) > *((int *)right)) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static Bptree *indexGetTree(SearchIndexEntry *entry)
+{
+	switch(entry->type) {
+		case INDEX_REGISTRY_TYPE_EXACT:
+		case INDEX_REGISTRY_TYPE_WILDCARD:
+			return &(((WildcardIndex *)entry->index)->index);
+
+		case INDEX_REGISTRY_TYPE_USER_KEY:
+			return ((Bptree *)entry->index);
+
+		case INDEX_REGISTRY_TYPE_RANGE:
+			return &(((RangeIndex *)entry->index)->index);
+
+		case INDEX_REGISTRY_TYPE_GEO:
+			return &(((GeoIndex *)entry->index)->cells.index);
+
+		case INDEX_REGISTRY_TYPE_END_OF_LIST:
+		default:
+			return NULL;
+	}
+}
+
+static int *getRangeUids(SearchIndexEntry *entry, RangeIndex *range,
+		int searchType, int minValue, int maxValue, int *length)
+{
+	int ii = 0;
+	int nn = 0;
+	int first = 0;
+	int last = 0;
+	int resultLength = 0;
+	int deltaLength = 0;
+	int segmentLength = 0;
+	int *result = NULL;
+	int *deltaUids = NULL;
+	int *segmentUids = NULL;
+
+	SearchSegmentTerm *terms = NULL;
+
+	*length = 0;
+
+	if(entry->section == NULL) {
+		return rangeIndex_search(range, searchType, minValue, maxValue,
+				length);
+	}
+
+	deltaUids = rangeIndex_search(range, searchType, minValue, maxValue,
+			&deltaLength);
+
+	// the matching segment terms are contiguous, append their unmasked UIDs
+	// to those of the delta
+
+	if(searchSegment_findRange(entry->segment, entry->section, searchType,
+				minValue, maxValue, &first, &last) > 0) {
+		terms = searchSegment_getTerms(entry->segment, entry->section);
+
+		for(ii = first; ii < last; ii++) {
+			resultLength += terms[ii].postingLength;
+		}
+	}
+
+	if((resultLength + deltaLength) > 0) {
+		result = (int *)malloc(sizeof(int) * (resultLength + deltaLength));
+
+		resultLength = 0;
+
+		for(ii = first; ii < last; ii++) {
+			if((segmentUids = searchSegment_getPosting(entry->segment,
+							&terms[ii], &segmentLength)) == NULL) {
+				continue;
+			}
+
+			for(nn = 0; nn < segmentLength; nn++) {
+				if((entry->mask.length > 0) &&
+						(posting_contains(&entry->mask,
+										  segmentUids[nn]) == 0)) {
+					continue;
+				}
+
+				result[resultLength] = segmentUids[nn];
+				resultLength++;
+			}
+		}
+
+		if(deltaLength > 0) {
+			memcpy((result + resultLength), deltaUids,
+					(sizeof(int) * deltaLength));
+			resultLength += deltaLength;
+		}
+
+		if(resultLength > 1) {
+			qsort((void *)result, resultLength, sizeof(int), compareIntegers);
+		}
+		else if(resultLength < 1) {
+			free(result);
+			result = NULL;
+		}
+	}
+
+	if(deltaUids != NULL) {
+		free(deltaUids);
+	}
+
+	*length = resultLength;
+
+	return result;
+}
+
+static int *mergeUids(int *segmentUids, int segmentLength, PostingList *mask,
+		int *deltaUids, int deltaLength, int *length)
+{
+	int ii = 0;
+	int nn = 0;
+	int uid = 0;
+	int ref = 0;
+	int *result = NULL;
+
+	*length = 0;
+
+	if((segmentLength + deltaLength) < 1) {
+		return NULL;
+	}
+
+	result = (int *)malloc(sizeof(int) * (segmentLength + deltaLength));
+
+	// both arrays are sorted & unique, the merge drops masked segment UIDs
+	// and any UID present in both
+
+	while((ii < segmentLength) || (nn < deltaLength)) {
+		if((nn >= deltaLength) ||
+				((ii < segmentLength) && (segmentUids[ii] < deltaUids[nn]))) {
+			uid = segmentUids[ii];
+			ii++;
+
+			if((mask->length > 0) && (posting_contains(mask, uid) == 0)) {
+				continue;
+			}
+		}
+		else {
+			if((ii < segmentLength) && (segmentUids[ii] == deltaUids[nn])) {
+				ii++;
+			}
+
+			uid = deltaUids[nn];
+			nn++;
+		}
+
+		result[ref] = uid;
+		ref++;
+	}
+
+	if(ref < 1) {
+		free(result);
+		return NULL;
+	}
+
+	*length = ref;
+
+	return result;
+}
+
+static int updateSegmentTerms(SearchIndexEntry *entry, aboolean isAddition)
+{
+	int ii = 0;
+	int result = 0;
+	char *key = NULL;
+
+	SearchSegmentTerm *terms = NULL;
+
+	if((entry->type != INDEX_REGISTRY_TYPE_WILDCARD) ||
+			(entry->section == NULL)) {
+		return 0;
+	}
+
+	// the terms of the segment are found through the wildcard index, which
+	// holds their keys, but not their UIDs
+
+	terms = searchSegment_getTerms(entry->segment, entry->section);
+
+	for(ii = 0; ii < entry->section->termLength; ii++) {
+		if((key = searchSegment_getTermKey(entry->segment,
+						&terms[ii])) == NULL) {
+			continue;
+		}
+
+		if(isAddition) {
+			if(wildcardIndex_putTerm((WildcardIndex *)entry->index, key,
+						terms[ii].keyLength) < 0) {
+				result = -1;
+			}
+		}
+		else if(wildcardIndex_removeTerm((WildcardIndex *)entry->index, key,
+					terms[ii].keyLength) < 0) {
+			result = -1;
+		}
+	}
+
+	return result;
+}
+
+static int *getWildcardUids(SearchIndexEntry *entry, char *value,
+		int *length)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int keyLength = 0;
+	int termLength = 0;
+	int uidLength = 0;
+	int deltaLength = 0;
+	int segmentLength = 0;
+	int resultLength = 0;
+	int *uids = NULL;
+	int *result = NULL;
+	int *deltaUids = NULL;
+	int *segmentUids = NULL;
+	char **terms = NULL;
+
+	PostingList *array = NULL;
+	WildcardIndex *wildcard = NULL;
+	SearchSegmentTerm *term = NULL;
+
+	*length = 0;
+
+	wildcard = (WildcardIndex *)entry->index;
+
+	if((terms = wildcardIndex_getTerms(wildcard, value, &termLength)) ==
+			NULL) {
+		return NULL;
+	}
+
+	// merge the delta & segment UIDs of each matching term, and then the
+	// terms together
+
+	for(ii = 0; ii < termLength; ii++) {
+		keyLength = strlen(terms[ii]);
+
+		deltaUids = NULL;
+		deltaLength = 0;
+		segmentUids = NULL;
+		segmentLength = 0;
+
+		if(bptree_get(&wildcard->index, terms[ii], keyLength,
+					((void *)&array)) == 0) {
+			deltaUids = posting_toArray(array, &deltaLength);
+		}
+
+		if((term = searchSegment_findTerm(entry->segment, entry->section,
+						terms[ii], keyLength)) != NULL) {
+			segmentUids = searchSegment_getPosting(entry->segment, term,
+					&segmentLength);
+		}
+
+		uids = mergeUids(segmentUids, segmentLength, &entry->mask, deltaUids,
+				deltaLength, &uidLength);
+
+		if(deltaUids != NULL) {
+			free(deltaUids);
+		}
+
+		free(terms[ii]);
+
+		if(uids == NULL) {
+			continue;
+		}
+
+		if(result == NULL) {
+			result = uids;
+			resultLength = uidLength;
+			continue;
+		}
+
+		result = (int *)realloc(result,
+				(sizeof(int) * (resultLength + uidLength)));
+
+		memcpy((result + resultLength), uids, (sizeof(int) * uidLength));
+		resultLength += uidLength;
+
+		free(uids);
+	}
+
+	free(terms);
+
+	if((result != NULL) && (resultLength > 1)) {
+		qsort(result, resultLength, sizeof(int), compareIntegers);
+
+		for(nn = 1, ref = 1; nn < resultLength; nn++) {
+			if(result[nn] != result[(ref - 1)]) {
+				result[ref] = result[nn];
+				ref++;
+			}
+		}
+
+		resultLength = ref;
+	}
+
+	*length = resultLength;
+
+	return result;
+}
+
+static int *getSegmentStringUids(SearchIndexEntry *entry, char *value,
+		int *length)
+{
+	int keyLength = 0;
+	int deltaLength = 0;
+	int segmentLength = 0;
+	int *result = NULL;
+	int *deltaUids = NULL;
+	int *segmentUids = NULL;
+	char *key = NULL;
+
+	PostingList *array = NULL;
+	SearchSegmentTerm *term = NULL;
+
+	if(entry->type == INDEX_REGISTRY_TYPE_WILDCARD) {
+		return getWildcardUids(entry, value, length);
+	}
+
+	if(entry->type != INDEX_REGISTRY_TYPE_USER_KEY) {
+		key = wildcardIndex_buildKey((WildcardIndex *)entry->index,
+				value, &keyLength);
+		deltaUids = wildcardIndex_get((WildcardIndex *)entry->index,
+				value, &deltaLength);
+	}
+	else {
+		key = strdup(value);
+		keyLength = strlen(value);
+
+		if(bptree_get((Bptree *)entry->index, value, strlen(value),
+					((void *)&array)) == 0) {
+			deltaUids = posting_toArray(array, &deltaLength);
+		}
+	}
+
+	if((key != NULL) &&
+			((term = searchSegment_findTerm(entry->segment,
+							entry->section, key, keyLength)) != NULL)) {
+		segmentUids = searchSegment_getPosting(entry->segment, term,
+				&segmentLength);
+	}
+
+	result = mergeUids(segmentUids, segmentLength, &entry->mask,
+			deltaUids, deltaLength, length);
+
+	if(key != NULL) {
+		free(key);
+	}
+
+	if(deltaUids != NULL) {
+		free(deltaUids);
+	}
+
+	return result;
+}
+
+static SearchSegmentEntry *buildMergedTerms(SearchIndexEntry *entry,
+		aboolean isCountOnly, int *length)
+{
+	int ii = 0;
+	int nn = 0;
+	int ref = 0;
+	int rc = 0;
+	int value = 0;
+	int keyLength = 0;
+	int uidLength = 0;
+	int deltaLength = 0;
+	int segmentLength = 0;
+	int arrayLength = 0;
+	int termLength = 0;
+	int *uids = NULL;
+	int *deltaUids = NULL;
+	int *segmentUids = NULL;
+	int *keyLengths = NULL;
+	char *key = NULL;
+	char *termKey = NULL;
+	char **keys = NULL;
+	void **values = NULL;
+
+	Bptree *tree = NULL;
+	PostingList *array = NULL;
+	RangeIndexEntry *rangeEntry = NULL;
+	SearchSegmentTerm *terms = NULL;
+	SearchSegmentEntry *result = NULL;
+
+	*length = 0;
+
+	if(((tree = indexGetTree(entry)) == NULL) ||
+			(bptree_toArray(tree, &arrayLength, &keyLengths, &keys,
+							&values) < 0)) {
+		return NULL;
+	}
+
+	if(entry->section != NULL) {
+		terms = searchSegment_getTerms(entry->segment, entry->section);
+		termLength = entry->section->termLength;
+	}
+
+	result = (SearchSegmentEntry *)malloc(sizeof(SearchSegmentEntry) *
+			(arrayLength + termLength + 1));
+
+	// walk the delta tree & the segment terms together, both of which are in
+	// key order (value order, for range & geo indexes)
+
+	while((ii < arrayLength) || (nn < termLength)) {
+		key = NULL;
+		array = NULL;
+		deltaUids = NULL;
+		deltaLength = 0;
+		segmentUids = NULL;
+		segmentLength = 0;
+
+		if(ii < arrayLength) {
+			if((entry->type == INDEX_REGISTRY_TYPE_RANGE) ||
+					(entry->type == INDEX_REGISTRY_TYPE_GEO)) {
+				rangeEntry = (RangeIndexEntry *)values[ii];
+				array = &(rangeEntry->list);
+				value = rangeEntry->value;
+			}
+			else {
+				array = (PostingList *)values[ii];
+				value = 0;
+			}
+		}
+
+		if(nn < termLength) {
+			termKey = searchSegment_getTermKey(entry->segment, &terms[nn]);
+		}
+
+		if(ii >= arrayLength) {
+			rc = 1;
+		}
+		else if(nn >= termLength) {
+			rc = -1;
+		}
+		else if((entry->type == INDEX_REGISTRY_TYPE_RANGE) ||
+				(entry->type == INDEX_REGISTRY_TYPE_GEO)) {
+			rc = ((value < terms[nn].value) ? -1 :
+					((value > terms[nn].value) ? 1 : 0));
+		}
+		else if(termKey == NULL) {
+			rc = -1;
+		}
+		else if((rc = memcmp(keys[ii], termKey,
+						((keyLengths[ii] < terms[nn].keyLength) ?
+						 keyLengths[ii] : terms[nn].keyLength))) == 0) {
+			rc = (keyLengths[ii] - terms[nn].keyLength);
+		}
+
+		if(rc <= 0) {
+			key = keys[ii];
+			keyLength = keyLengths[ii];
+			deltaUids = posting_toArray(array, &deltaLength);
+			ii++;
+		}
+
+		if(rc >= 0) {
+			if((key == NULL) && (termKey != NULL)) {
+				keyLength = terms[nn].keyLength;
+				key = (char *)malloc(sizeof(char) * (keyLength + 1));
+				memcpy(key, termKey, keyLength);
+				value = terms[nn].value;
+			}
+
+			segmentUids = searchSegment_getPosting(entry->segment, &terms[nn],
+					&segmentLength);
+			nn++;
+		}
+
+		uids = mergeUids(segmentUids, segmentLength, &entry->mask, deltaUids,
+				deltaLength, &uidLength);
+
+		if(deltaUids != NULL) {
+			free(deltaUids);
+		}
+
+		if((key == NULL) || (uids == NULL)) {
+			if(key != NULL) {
+				free(key);
+			}
+			if(uids != NULL) {
+				free(uids);
+			}
+			continue;
+		}
+
+		if(isCountOnly) {
+			free(uids);
+			uids = NULL;
+		}
+
+		result[ref].value = value;
+		result[ref].keyLength = keyLength;
+		result[ref].uidLength = uidLength;
+		result[ref].uids = uids;
+		result[ref].key = key;
+		ref++;
+	}
+
+	// cleanup
+
+	if(keys != NULL) {
+		free(keys);
+	}
+
+	if(keyLengths != NULL) {
+		free(keyLengths);
+	}
+
+	if(values != NULL) {
+		free(values);
+	}
+
+	*length = ref;
+
+	return result;
+}
+
 // define search index public functions
 
 int searchIndex_init(SearchIndex *index, int minStringLength,
@@ -360,6 +904,7 @@ int searchIndex_setStringThresholdsindexNew(SearchIndex *index,
 		case INDEX_REGISTRY_TYPE_EXACT:
 		case INDEX_REGISTRY_TYPE_USER_KEY:
 		case INDEX_REGISTRY_TYPE_RANGE:
+		case INDEX_REGISTRY_TYPE_GEO:
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			result = -1;
@@ -383,6 +928,7 @@ int searchIndex_getIndexCount(SearchIndex *index, IndexRegistryIndex *type)
 
 	Bptree *tree = NULL;
 	SearchIndexEntry *entry = NULL;
+	SearchSegmentEntry *entries = NULL;
 
 	if((index == NULL) || (type == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -401,6 +947,18 @@ int searchIndex_getIndexCount(SearchIndex *index, IndexRegistryIndex *type)
 
 	mutex_lock(&entry->mutex);
 
+	// count the distinct values of the delta & the segment together
+
+	if(entry->section != NULL) {
+		entries = buildMergedTerms(entry, atrue, &result);
+		searchSegment_freeEntries(entries, result);
+
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+
+		return result;
+	}
+
 	switch(type->type) {
 		case INDEX_REGISTRY_TYPE_EXACT:
 		case INDEX_REGISTRY_TYPE_WILDCARD:
@@ -415,6 +973,10 @@ int searchIndex_getIndexCount(SearchIndex *index, IndexRegistryIndex *type)
 			tree = &(((RangeIndex *)entry->index)->index);
 			break;
 
+		case INDEX_REGISTRY_TYPE_GEO:
+			tree = &(((GeoIndex *)entry->index)->cells.index);
+			break;
+
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			tree = NULL;
@@ -472,6 +1034,10 @@ int searchIndex_getIndexDepth(SearchIndex *index, IndexRegistryIndex *type)
 			tree = &(((RangeIndex *)entry->index)->index);
 			break;
 
+		case INDEX_REGISTRY_TYPE_GEO:
+			tree = &(((GeoIndex *)entry->index)->cells.index);
+			break;
+
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			tree = NULL;
@@ -496,15 +1062,15 @@ int searchIndex_getIndexValueCount(SearchIndex *index,
 {
 	int ii = 0;
 	int result = 0;
-	int arrayLength = 0;
-	int *keyLengths = NULL;
-	char **keys = NULL;
-	void **values = NULL;
+	int entryLength = 0;
+	void *value = NULL;
 
 	Bptree *tree = NULL;
-	IntegerArray *array = NULL;
+	BptreeCursor cursor;
+	PostingList *array = NULL;
 	RangeIndexEntry *rangeEntry = NULL;
 	SearchIndexEntry *entry = NULL;
+	SearchSegmentEntry *entries = NULL;
 
 	Intersect intersect;
 
@@ -525,13 +1091,37 @@ int searchIndex_getIndexValueCount(SearchIndex *index,
 
 	mutex_lock(&entry->mutex);
 
-	switch(type->type) {
-		case INDEX_REGISTRY_TYPE_EXACT:
-		case INDEX_REGISTRY_TYPE_WILDCARD:
-			tree = &(((WildcardIndex *)entry->index)->index);
-			break;
+	if(entry->section != NULL) {
+		entries = buildMergedTerms(entry, afalse, &entryLength);
 
-		case INDEX_REGISTRY_TYPE_USER_KEY:
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+
+		intersect_init(&intersect);
+
+		for(ii = 0; ii < entryLength; ii++) {
+			intersect_putArray(&intersect, atrue, entries[ii].uids,
+					entries[ii].uidLength);
+		}
+
+		intersect_execOr(&intersect);
+
+		result = intersect.result.length;
+
+		intersect_free(&intersect);
+
+		searchSegment_freeEntries(entries, entryLength);
+
+		return result;
+	}
+
+	switch(type->type) {
+		case INDEX_REGISTRY_TYPE_EXACT:
+		case INDEX_REGISTRY_TYPE_WILDCARD:
+			tree = &(((WildcardIndex *)entry->index)->index);
+			break;
+
+		case INDEX_REGISTRY_TYPE_USER_KEY:
 			tree = ((Bptree *)entry->index);
 			break;
 
@@ -539,6 +1129,10 @@ int searchIndex_getIndexValueCount(SearchIndex *index,
 			tree = &(((RangeIndex *)entry->index)->index);
 			break;
 
+		case INDEX_REGISTRY_TYPE_GEO:
+			tree = &(((GeoIndex *)entry->index)->cells.index);
+			break;
+
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			tree = NULL;
@@ -550,30 +1144,23 @@ int searchIndex_getIndexValueCount(SearchIndex *index,
 		return -1;
 	}
 
-	if(bptree_toArray(tree, &arrayLength, &keyLengths, &keys, &values) < 0) {
-		mutex_unlock(&entry->mutex);
-		spinlock_readUnlock(&index->lock);
-		return -1;
-	}
+	bptree_cursorInit(&cursor, tree);
+	bptree_cursorFirst(&cursor);
 
 	intersect_init(&intersect);
 
-	for(ii = 0; ii < arrayLength; ii++) {
-		if(keys[ii] != NULL) {
-			free(keys[ii]);
-		}
-
+	while(bptree_cursorNext(&cursor, NULL, NULL, &value) == 0) {
 		if((type->type == INDEX_REGISTRY_TYPE_EXACT) ||
 				(type->type == INDEX_REGISTRY_TYPE_WILDCARD) ||
 				(type->type == INDEX_REGISTRY_TYPE_USER_KEY)) {
-			array = (IntegerArray *)values[ii];
+			array = (PostingList *)value;
 		}
 		else {
-			rangeEntry = (RangeIndexEntry *)values[ii];
+			rangeEntry = (RangeIndexEntry *)value;
 			array = &(rangeEntry->list);
 		}
 
-		intersect_putArray(&intersect, atrue, array->array, array->length);
+		intersect_putPosting(&intersect, array);
 	}
 
 	intersect_execOr(&intersect);
@@ -586,9 +1173,7 @@ int searchIndex_getIndexValueCount(SearchIndex *index,
 
 	// cleanup
 
-	free(keys);
-	free(keyLengths);
-	free(values);
+	bptree_cursorFree(&cursor);
 
 	intersect_free(&intersect);
 
@@ -605,9 +1190,10 @@ int searchIndex_buildIndexValueSummary(SearchIndex *index,
 	void **values = NULL;
 
 	Bptree *tree = NULL;
-	IntegerArray *array = NULL;
+	PostingList *array = NULL;
 	RangeIndexEntry *rangeEntry = NULL;
 	SearchIndexEntry *entry = NULL;
+	SearchSegmentEntry *entries = NULL;
 
 	if((index == NULL) || (type == NULL)) {
 		DISPLAY_INVALID_ARGS;
@@ -626,6 +1212,31 @@ int searchIndex_buildIndexValueSummary(SearchIndex *index,
 
 	mutex_lock(&entry->mutex);
 
+	if(entry->section != NULL) {
+		entries = buildMergedTerms(entry, atrue, &arrayLength);
+
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+
+		memset(summary, 0, (int)(sizeof(SearchIndexSummary)));
+
+		summary->length = arrayLength;
+		summary->valueCounts = (int *)malloc(sizeof(int) *
+				(summary->length + 1));
+		summary->type = strdup(indexRegistry_typeToString(type->type));
+		summary->keys = (char **)malloc(sizeof(char *) *
+				(summary->length + 1));
+
+		for(ii = 0; ii < arrayLength; ii++) {
+			summary->keys[ii] = entries[ii].key;
+			summary->valueCounts[ii] = entries[ii].uidLength;
+		}
+
+		free(entries);
+
+		return 0;
+	}
+
 	switch(type->type) {
 		case INDEX_REGISTRY_TYPE_EXACT:
 		case INDEX_REGISTRY_TYPE_WILDCARD:
@@ -640,6 +1251,10 @@ int searchIndex_buildIndexValueSummary(SearchIndex *index,
 			tree = &(((RangeIndex *)entry->index)->index);
 			break;
 
+		case INDEX_REGISTRY_TYPE_GEO:
+			tree = &(((GeoIndex *)entry->index)->cells.index);
+			break;
+
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			tree = NULL;
@@ -668,7 +1283,7 @@ int searchIndex_buildIndexValueSummary(SearchIndex *index,
 		if((type->type == INDEX_REGISTRY_TYPE_EXACT) ||
 				(type->type == INDEX_REGISTRY_TYPE_WILDCARD) ||
 				(type->type == INDEX_REGISTRY_TYPE_USER_KEY)) {
-			array = (IntegerArray *)values[ii];
+			array = (PostingList *)values[ii];
 		}
 		else {
 			rangeEntry = (RangeIndexEntry *)values[ii];
@@ -694,15 +1309,15 @@ int searchIndex_buildAllIndexValueUids(SearchIndex *index,
 		IndexRegistryIndex *type, Intersect *intersect)
 {
 	int ii = 0;
-	int arrayLength = 0;
-	int *keyLengths = NULL;
-	char **keys = NULL;
-	void **values = NULL;
+	int entryLength = 0;
+	void *value = NULL;
 
 	Bptree *tree = NULL;
-	IntegerArray *array = NULL;
+	BptreeCursor cursor;
+	PostingList *array = NULL;
 	RangeIndexEntry *rangeEntry = NULL;
 	SearchIndexEntry *entry = NULL;
+	SearchSegmentEntry *entries = NULL;
 
 	Intersect localIntersect;
 
@@ -723,6 +1338,33 @@ int searchIndex_buildAllIndexValueUids(SearchIndex *index,
 
 	mutex_lock(&entry->mutex);
 
+	if(entry->section != NULL) {
+		entries = buildMergedTerms(entry, afalse, &entryLength);
+
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+
+		intersect_init(&localIntersect);
+
+		for(ii = 0; ii < entryLength; ii++) {
+			intersect_putArray(&localIntersect, atrue, entries[ii].uids,
+					entries[ii].uidLength);
+		}
+
+		searchSegment_freeEntries(entries, entryLength);
+
+		if(entryLength > 0) {
+			intersect_execOr(&localIntersect);
+
+			intersect_putArray(intersect, atrue, localIntersect.result.array,
+					localIntersect.result.length);
+		}
+
+		intersect_free(&localIntersect);
+
+		return 0;
+	}
+
 	switch(type->type) {
 		case INDEX_REGISTRY_TYPE_EXACT:
 		case INDEX_REGISTRY_TYPE_WILDCARD:
@@ -737,6 +1379,10 @@ int searchIndex_buildAllIndexValueUids(SearchIndex *index,
 			tree = &(((RangeIndex *)entry->index)->index);
 			break;
 
+		case INDEX_REGISTRY_TYPE_GEO:
+			tree = &(((GeoIndex *)entry->index)->cells.index);
+			break;
+
 		case INDEX_REGISTRY_TYPE_END_OF_LIST:
 		default:
 			tree = NULL;
@@ -748,44 +1394,37 @@ int searchIndex_buildAllIndexValueUids(SearchIndex *index,
 		return -1;
 	}
 
-	if(bptree_toArray(tree, &arrayLength, &keyLengths, &keys, &values) < 0) {
-		mutex_unlock(&entry->mutex);
-		spinlock_readUnlock(&index->lock);
-		return -1;
-	}
+	bptree_cursorInit(&cursor, tree);
+	bptree_cursorFirst(&cursor);
 
 	intersect_init(&localIntersect);
 
-	for(ii = 0; ii < arrayLength; ii++) {
-		if(keys[ii] != NULL) {
-			free(keys[ii]);
-		}
-
-		if(values[ii] == NULL) {
+	while(bptree_cursorNext(&cursor, NULL, NULL, &value) == 0) {
+		if(value == NULL) {
 			continue;
 		}
 
 		if((type->type == INDEX_REGISTRY_TYPE_EXACT) ||
 				(type->type == INDEX_REGISTRY_TYPE_WILDCARD) ||
 				(type->type == INDEX_REGISTRY_TYPE_USER_KEY)) {
-			array = (IntegerArray *)values[ii];
+			array = (PostingList *)value;
 		}
 		else {
-			rangeEntry = (RangeIndexEntry *)values[ii];
+			rangeEntry = (RangeIndexEntry *)value;
 			array = &(rangeEntry->list);
 		}
 
-		intersect_putArray(&localIntersect, atrue, array->array,
-				array->length);
+		intersect_putPosting(&localIntersect, array);
 	}
 
-	mutex_unlock(&entry->mutex);
+	// intersect all uid values before the lock on the posting lists is
+	// released, and assign them to the master intersection
 
-	spinlock_readUnlock(&index->lock);
+	intersect_execOr(&localIntersect);
 
-	// intersect all uid values and assign them to the master intersection
+	mutex_unlock(&entry->mutex);
 
-	intersect_execOr(&localIntersect);
+	spinlock_readUnlock(&index->lock);
 
 	intersect_putArray(intersect, atrue, localIntersect.result.array,
 			localIntersect.result.length);
@@ -794,9 +1433,7 @@ int searchIndex_buildAllIndexValueUids(SearchIndex *index,
 
 	// cleanup
 
-	free(keys);
-	free(keyLengths);
-	free(values);
+	bptree_cursorFree(&cursor);
 
 	return 0;
 }
@@ -938,10 +1575,9 @@ int searchIndex_renameIndex(SearchIndex *index, char *key,
 int *searchIndex_getString(SearchIndex *index, IndexRegistryIndex *type,
 		char *value, int *length)
 {
-	int resultLength = 0;
 	int *result = NULL;
 
-	IntegerArray *array = NULL;
+	PostingList *array = NULL;
 	SearchIndexEntry *entry = NULL;
 
 	if((index == NULL) || (type == NULL) ||
@@ -978,19 +1614,76 @@ int *searchIndex_getString(SearchIndex *index, IndexRegistryIndex *type,
 		return NULL;
 	}
 
-	if(type->type != INDEX_REGISTRY_TYPE_USER_KEY) {
+	if(entry->section != NULL) {
+		result = getSegmentStringUids(entry, value, length);
+	}
+	else if(type->type != INDEX_REGISTRY_TYPE_USER_KEY) {
 		result = wildcardIndex_get((WildcardIndex *)entry->index, value,
 				length);
 	}
 	else if(bptree_get((Bptree *)entry->index, value, strlen(value),
 				((void *)&array)) == 0) {
-		resultLength = array->length;
+		result = posting_toArray(array, length);
+	}
+
+	mutex_unlock(&entry->mutex);
+
+	spinlock_readUnlock(&index->lock);
+
+	return result;
+}
+
+PostingView *searchIndex_getStringView(SearchIndex *index,
+		IndexRegistryIndex *type, char *value)
+{
+	int length = 0;
+	int *uids = NULL;
+
+	PostingList *array = NULL;
+	PostingView *result = NULL;
+	SearchIndexEntry *entry = NULL;
+
+	if((index == NULL) || (type == NULL) ||
+			((type->type != INDEX_REGISTRY_TYPE_EXACT) &&
+			 (type->type != INDEX_REGISTRY_TYPE_WILDCARD) &&
+			 (type->type != INDEX_REGISTRY_TYPE_USER_KEY)) ||
+			(value == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	if(spinlock_readLock(&index->lock) < 0) {
+		return NULL;
+	}
+
+	if(bptree_get(&index->index, type->key, strlen(type->key),
+				((void *)&entry)) < 0) {
+		spinlock_readUnlock(&index->lock);
+		return NULL;
+	}
+
+	mutex_lock(&entry->mutex);
 
-		result = (int *)malloc(sizeof(int) * resultLength);
+	if(entry->type != type->type) {
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+		return NULL;
+	}
 
-		memcpy(result, array->array, (int)(sizeof(int) * resultLength));
+	// delta postings are pinned rather than copied, merged segment results
+	// are built once and handed over as they are
 
-		*length = resultLength;
+	if(entry->section != NULL) {
+		if((uids = getSegmentStringUids(entry, value, &length)) != NULL) {
+			result = posting_newView(uids, length);
+		}
+	}
+	else if(type->type != INDEX_REGISTRY_TYPE_USER_KEY) {
+		result = wildcardIndex_getView((WildcardIndex *)entry->index, value);
+	}
+	else if(bptree_get((Bptree *)entry->index, value, strlen(value),
+				((void *)&array)) == 0) {
+		result = posting_getView(array);
 	}
 
 	mutex_unlock(&entry->mutex);
@@ -1038,7 +1731,7 @@ int *searchIndex_getRange(SearchIndex *index, IndexRegistryIndex *type,
 		return NULL;
 	}
 
-	result = rangeIndex_search((RangeIndex *)entry->index, searchType,
+	result = getRangeUids(entry, (RangeIndex *)entry->index, searchType,
 			minValue, maxValue, length);
 
 	mutex_unlock(&entry->mutex);
@@ -1048,13 +1741,152 @@ int *searchIndex_getRange(SearchIndex *index, IndexRegistryIndex *type,
 	return result;
 }
 
+int *searchIndex_getGeoCoord(SearchIndex *index, IndexRegistryIndex *type,
+		double latitude, double longitude, double miles, int *length)
+{
+	int ii = 0;
+	int cellLength = 0;
+	int rangeLength = 0;
+	int resultLength = 0;
+	int *uids = NULL;
+	int *result = NULL;
+
+	SearchIndexEntry *entry = NULL;
+	GeoIndexCellRange *ranges = NULL;
+
+	if((index == NULL) || (type == NULL) ||
+			(type->type != INDEX_REGISTRY_TYPE_GEO) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(length != NULL) {
+			*length = 0;
+		}
+
+		return NULL;
+	}
+
+	*length = 0;
+
+	if((ranges = geoIndex_buildCovering(latitude, longitude, miles,
+					&rangeLength)) == NULL) {
+		return NULL;
+	}
+
+	if(spinlock_readLock(&index->lock) < 0) {
+		free(ranges);
+		return NULL;
+	}
+
+	if(bptree_get(&index->index, type->key, strlen(type->key),
+				((void *)&entry)) < 0) {
+		spinlock_readUnlock(&index->lock);
+		free(ranges);
+		return NULL;
+	}
+
+	mutex_lock(&entry->mutex);
+
+	if(entry->type != type->type) {
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+		free(ranges);
+		return NULL;
+	}
+
+	// each covering cell is a contiguous range of cell values
+
+	for(ii = 0; ii < rangeLength; ii++) {
+		if((uids = getRangeUids(entry, &(((GeoIndex *)entry->index)->cells),
+						RANGE_INDEX_SEARCH_BETWEEN, ranges[ii].minValue,
+						ranges[ii].maxValue, &cellLength)) == NULL) {
+			continue;
+		}
+
+		if(result == NULL) {
+			result = uids;
+			resultLength = cellLength;
+			continue;
+		}
+
+		result = (int *)realloc(result,
+				(sizeof(int) * (resultLength + cellLength)));
+
+		memcpy((result + resultLength), uids, (sizeof(int) * cellLength));
+
+		resultLength += cellLength;
+
+		free(uids);
+	}
+
+	mutex_unlock(&entry->mutex);
+
+	spinlock_readUnlock(&index->lock);
+
+	free(ranges);
+
+	if(resultLength > 1) {
+		qsort((void *)result, resultLength, sizeof(int), compareIntegers);
+	}
+
+	*length = resultLength;
+
+	return result;
+}
+
+GeoIndexPoint *searchIndex_getGeoCoordPoints(SearchIndex *index,
+		IndexRegistryIndex *type, int uid, int *length)
+{
+	GeoIndexPoint *result = NULL;
+
+	SearchIndexEntry *entry = NULL;
+
+	if((index == NULL) || (type == NULL) ||
+			(type->type != INDEX_REGISTRY_TYPE_GEO) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(length != NULL) {
+			*length = 0;
+		}
+
+		return NULL;
+	}
+
+	*length = 0;
+
+	if(spinlock_readLock(&index->lock) < 0) {
+		return NULL;
+	}
+
+	if(bptree_get(&index->index, type->key, strlen(type->key),
+				((void *)&entry)) < 0) {
+		spinlock_readUnlock(&index->lock);
+		return NULL;
+	}
+
+	mutex_lock(&entry->mutex);
+
+	if(entry->type == type->type) {
+		result = geoIndex_getPoints((GeoIndex *)entry->index, uid, length);
+	}
+
+	mutex_unlock(&entry->mutex);
+
+	spinlock_readUnlock(&index->lock);
+
+	return result;
+}
+
 int searchIndex_putString(SearchIndex *index, IndexRegistryIndex *type,
 		char *value, int uid)
 {
+	int ii = 0;
 	int result = 0;
+	int uidLength = 0;
+	int *uids = NULL;
 
-	IntegerArray *array = NULL;
+	PostingList *array = NULL;
 	SearchIndexEntry *entry = NULL;
+	SearchSegmentTerm *term = NULL;
 
 	if((index == NULL) || (type == NULL) ||
 			((type->type != INDEX_REGISTRY_TYPE_EXACT) &&
@@ -1065,13 +1897,13 @@ int searchIndex_putString(SearchIndex *index, IndexRegistryIndex *type,
 		return -1;
 	}
 
-	if(spinlock_writeLock(&index->lock) < 0) {
+	if(spinlock_readLock(&index->lock) < 0) {
 		return -1;
 	}
 
 	if(bptree_get(&index->index, type->key, strlen(type->key),
 				((void *)&entry)) < 0) {
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
@@ -1079,7 +1911,7 @@ int searchIndex_putString(SearchIndex *index, IndexRegistryIndex *type,
 
 	if(entry->type != type->type) {
 		mutex_unlock(&entry->mutex);
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
@@ -1099,19 +1931,38 @@ int searchIndex_putString(SearchIndex *index, IndexRegistryIndex *type,
 		if(bptree_get((Bptree *)entry->index, value, strlen(value),
 					((void *)&array)) == 0) {
 			mutex_unlock(&entry->mutex);
-			spinlock_writeUnlock(&index->lock);
+			spinlock_readUnlock(&index->lock);
 			return -1;
 		}
 
-		array = integer_new();
-		integer_put(array, uid);
+		// the key may still be held by an unmasked UID in the segment
+
+		if((entry->section != NULL) &&
+				((term = searchSegment_findTerm(entry->segment,
+								entry->section, value,
+								strlen(value))) != NULL)) {
+			uids = searchSegment_getPosting(entry->segment, term,
+					&uidLength);
+
+			for(ii = 0; ii < uidLength; ii++) {
+				if((uids[ii] != uid) &&
+						(posting_contains(&entry->mask, uids[ii]) < 0)) {
+					mutex_unlock(&entry->mutex);
+					spinlock_readUnlock(&index->lock);
+					return -1;
+				}
+			}
+		}
+
+		array = posting_new();
+		posting_put(array, uid);
 
 		bptree_put((Bptree *)entry->index, value, strlen(value), (void *)array);
 	}
 
 	mutex_unlock(&entry->mutex);
 
-	spinlock_writeUnlock(&index->lock);
+	spinlock_readUnlock(&index->lock);
 
 	return result;
 }
@@ -1129,13 +1980,13 @@ int searchIndex_putInteger(SearchIndex *index, IndexRegistryIndex *type,
 		return -1;
 	}
 
-	if(spinlock_writeLock(&index->lock) < 0) {
+	if(spinlock_readLock(&index->lock) < 0) {
 		return -1;
 	}
 
 	if(bptree_get(&index->index, type->key, strlen(type->key),
 				((void *)&entry)) < 0) {
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
@@ -1143,7 +1994,7 @@ int searchIndex_putInteger(SearchIndex *index, IndexRegistryIndex *type,
 
 	if(entry->type != type->type) {
 		mutex_unlock(&entry->mutex);
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
@@ -1151,7 +2002,7 @@ int searchIndex_putInteger(SearchIndex *index, IndexRegistryIndex *type,
 
 	mutex_unlock(&entry->mutex);
 
-	spinlock_writeUnlock(&index->lock);
+	spinlock_readUnlock(&index->lock);
 
 	return result;
 }
@@ -1172,13 +2023,13 @@ int searchIndex_removeString(SearchIndex *index, IndexRegistryIndex *type,
 		return -1;
 	}
 
-	if(spinlock_writeLock(&index->lock) < 0) {
+	if(spinlock_readLock(&index->lock) < 0) {
 		return -1;
 	}
 
 	if(bptree_get(&index->index, type->key, strlen(type->key),
 				((void *)&entry)) < 0) {
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
@@ -1186,7 +2037,7 @@ int searchIndex_removeString(SearchIndex *index, IndexRegistryIndex *type,
 
 	if(entry->type != type->type) {
 		mutex_unlock(&entry->mutex);
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
@@ -1198,9 +2049,16 @@ int searchIndex_removeString(SearchIndex *index, IndexRegistryIndex *type,
 		result = bptree_remove((Bptree *)entry->index, value, strlen(value));
 	}
 
+	// the UID's values in the segment are hidden behind the mask
+
+	if(entry->section != NULL) {
+		posting_put(&entry->mask, uid);
+		result = 0;
+	}
+
 	mutex_unlock(&entry->mutex);
 
-	spinlock_writeUnlock(&index->lock);
+	spinlock_readUnlock(&index->lock);
 
 	return result;
 }
@@ -1218,13 +2076,13 @@ int searchIndex_removeInteger(SearchIndex *index, IndexRegistryIndex *type,
 		return -1;
 	}
 
-	if(spinlock_writeLock(&index->lock) < 0) {
+	if(spinlock_readLock(&index->lock) < 0) {
 		return -1;
 	}
 
 	if(bptree_get(&index->index, type->key, strlen(type->key),
 				((void *)&entry)) < 0) {
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
@@ -1232,16 +2090,301 @@ int searchIndex_removeInteger(SearchIndex *index, IndexRegistryIndex *type,
 
 	if(entry->type != type->type) {
 		mutex_unlock(&entry->mutex);
-		spinlock_writeUnlock(&index->lock);
+		spinlock_readUnlock(&index->lock);
 		return -1;
 	}
 
 	result = rangeIndex_remove((RangeIndex *)entry->index, value, uid);
 
+	if(entry->section != NULL) {
+		posting_put(&entry->mask, uid);
+		result = 0;
+	}
+
+	mutex_unlock(&entry->mutex);
+
+	spinlock_readUnlock(&index->lock);
+
+	return result;
+}
+
+int searchIndex_putGeoCoord(SearchIndex *index, IndexRegistryIndex *type,
+		double latitude, double longitude, int uid)
+{
+	int result = 0;
+
+	SearchIndexEntry *entry = NULL;
+
+	if((index == NULL) || (type == NULL) ||
+			(type->type != INDEX_REGISTRY_TYPE_GEO)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_readLock(&index->lock) < 0) {
+		return -1;
+	}
+
+	if(bptree_get(&index->index, type->key, strlen(type->key),
+				((void *)&entry)) < 0) {
+		spinlock_readUnlock(&index->lock);
+		return -1;
+	}
+
+	mutex_lock(&entry->mutex);
+
+	if(entry->type != type->type) {
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+		return -1;
+	}
+
+	result = geoIndex_put((GeoIndex *)entry->index, latitude, longitude, uid);
+
 	mutex_unlock(&entry->mutex);
 
+	spinlock_readUnlock(&index->lock);
+
+	return result;
+}
+
+int searchIndex_removeGeoCoord(SearchIndex *index, IndexRegistryIndex *type,
+		double latitude, double longitude, int uid)
+{
+	int result = 0;
+
+	SearchIndexEntry *entry = NULL;
+
+	if((index == NULL) || (type == NULL) ||
+			(type->type != INDEX_REGISTRY_TYPE_GEO)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_readLock(&index->lock) < 0) {
+		return -1;
+	}
+
+	if(bptree_get(&index->index, type->key, strlen(type->key),
+				((void *)&entry)) < 0) {
+		spinlock_readUnlock(&index->lock);
+		return -1;
+	}
+
+	mutex_lock(&entry->mutex);
+
+	if(entry->type != type->type) {
+		mutex_unlock(&entry->mutex);
+		spinlock_readUnlock(&index->lock);
+		return -1;
+	}
+
+	result = geoIndex_remove((GeoIndex *)entry->index, latitude, longitude,
+			uid);
+
+	if(entry->section != NULL) {
+		posting_put(&entry->mask, uid);
+		result = 0;
+	}
+
+	mutex_unlock(&entry->mutex);
+
+	spinlock_readUnlock(&index->lock);
+
+	return result;
+}
+
+int searchIndex_attachSegment(SearchIndex *index, SearchSegment *segment)
+{
+	int result = 0;
+	void *value = NULL;
+
+	BptreeCursor cursor;
+	SearchIndexEntry *entry = NULL;
+
+	if((index == NULL) || (segment == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&index->lock) < 0) {
+		return -1;
+	}
+
+	bptree_cursorInit(&cursor, &index->index);
+	bptree_cursorFirst(&cursor);
+
+	while(bptree_cursorNext(&cursor, NULL, NULL, &value) == 0) {
+		if((entry = (SearchIndexEntry *)value) == NULL) {
+			continue;
+		}
+
+		mutex_lock(&entry->mutex);
+
+		updateSegmentTerms(entry, afalse);
+
+		entry->segment = segment;
+		entry->section = searchSegment_getSection(segment, index->key,
+				entry->key, entry->type);
+
+		posting_free(&entry->mask);
+		posting_init(&entry->mask);
+
+		if(entry->section == NULL) {
+			entry->segment = NULL;
+			result++;
+		}
+		else {
+			updateSegmentTerms(entry, atrue);
+		}
+
+		mutex_unlock(&entry->mutex);
+	}
+
+	bptree_cursorFree(&cursor);
+
 	spinlock_writeUnlock(&index->lock);
 
+	// the number of indexes which the segment does not cover
+
+	return result;
+}
+
+int searchIndex_detachSegment(SearchIndex *index)
+{
+	void *value = NULL;
+
+	BptreeCursor cursor;
+	SearchIndexEntry *entry = NULL;
+
+	if(index == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&index->lock) < 0) {
+		return -1;
+	}
+
+	bptree_cursorInit(&cursor, &index->index);
+	bptree_cursorFirst(&cursor);
+
+	while(bptree_cursorNext(&cursor, NULL, NULL, &value) == 0) {
+		if((entry = (SearchIndexEntry *)value) == NULL) {
+			continue;
+		}
+
+		mutex_lock(&entry->mutex);
+
+		updateSegmentTerms(entry, afalse);
+
+		entry->segment = NULL;
+		entry->section = NULL;
+
+		posting_free(&entry->mask);
+		posting_init(&entry->mask);
+
+		mutex_unlock(&entry->mutex);
+	}
+
+	bptree_cursorFree(&cursor);
+
+	spinlock_writeUnlock(&index->lock);
+
+	return 0;
+}
+
+int searchIndex_maskUid(SearchIndex *index, int uid)
+{
+	void *value = NULL;
+
+	BptreeCursor cursor;
+	SearchIndexEntry *entry = NULL;
+
+	if(index == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_writeLock(&index->lock) < 0) {
+		return -1;
+	}
+
+	bptree_cursorInit(&cursor, &index->index);
+	bptree_cursorFirst(&cursor);
+
+	while(bptree_cursorNext(&cursor, NULL, NULL, &value) == 0) {
+		if((entry = (SearchIndexEntry *)value) == NULL) {
+			continue;
+		}
+
+		mutex_lock(&entry->mutex);
+
+		if(entry->section != NULL) {
+			posting_put(&entry->mask, uid);
+		}
+
+		mutex_unlock(&entry->mutex);
+	}
+
+	bptree_cursorFree(&cursor);
+
+	spinlock_writeUnlock(&index->lock);
+
+	return 0;
+}
+
+int searchIndex_writeSegment(SearchIndex *index, SearchSegmentWriter *writer)
+{
+	int result = 0;
+	int entryLength = 0;
+	void *value = NULL;
+
+	BptreeCursor cursor;
+	SearchIndexEntry *entry = NULL;
+	SearchSegmentEntry *entries = NULL;
+
+	if((index == NULL) || (writer == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(spinlock_readLock(&index->lock) < 0) {
+		return -1;
+	}
+
+	bptree_cursorInit(&cursor, &index->index);
+	bptree_cursorFirst(&cursor);
+
+	while(bptree_cursorNext(&cursor, NULL, NULL, &value) == 0) {
+		if((entry = (SearchIndexEntry *)value) == NULL) {
+			continue;
+		}
+
+		// merge the index under its mutex, and write it out after
+
+		mutex_lock(&entry->mutex);
+
+		entries = buildMergedTerms(entry, afalse, &entryLength);
+
+		mutex_unlock(&entry->mutex);
+
+		if(searchSegmentWriter_putSection(writer, index->key, entry->key,
+					entry->type, entries, entryLength) < 0) {
+			result = -1;
+		}
+
+		searchSegment_freeEntries(entries, entryLength);
+
+		if(result < 0) {
+			break;
+		}
+	}
+
+	bptree_cursorFree(&cursor);
+
+	spinlock_readUnlock(&index->lock);
+
 	return result;
 }
 
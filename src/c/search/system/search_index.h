@@ -5,7 +5,8 @@
  * intellectual property of Joshua S. English, all rights reserved.
  *
  * A system component for the search-engine to maintain the set of exact,
- * wildcard, and integer indexes for the search-engine system, header file.
+ * wildcard, integer, and geo indexes for the search-engine system, header
+ * file.
  *
  * Written by Josh English.
  */
@@ -32,10 +33,23 @@ typedef struct _SearchIndexSummary {
 	char **keys;
 } SearchIndexSummary;
 
+/*
+ * An index with an attached segment section serves the union of its
+ * in-memory (delta) index and the mapped section, less the UIDs in the mask,
+ * which are those removed or re-indexed since the segment was written.
+ *
+ * The spinlock guards the set of entries, and each entry's mutex guards its
+ * contents, so that values may be put to different indexes of one domain
+ * concurrently.
+ */
+
 typedef struct _SearchIndexEntry {
 	IndexRegistryTypes type;
 	char *key;
 	void *index;
+	SearchSegment *segment;
+	SearchSegmentSection *section;
+	PostingList mask;
 	Mutex mutex;
 } SearchIndexEntry;
 
@@ -97,9 +111,18 @@ int searchIndex_renameIndex(SearchIndex *index, char *key,
 int *searchIndex_getString(SearchIndex *index, IndexRegistryIndex *type,
 		char *value, int *length);
 
+PostingView *searchIndex_getStringView(SearchIndex *index,
+		IndexRegistryIndex *type, char *value);
+
 int *searchIndex_getRange(SearchIndex *index, IndexRegistryIndex *type,
 		int searchType, int minValue, int maxValue, int *length);
 
+int *searchIndex_getGeoCoord(SearchIndex *index, IndexRegistryIndex *type,
+		double latitude, double longitude, double miles, int *length);
+
+GeoIndexPoint *searchIndex_getGeoCoordPoints(SearchIndex *index,
+		IndexRegistryIndex *type, int uid, int *length);
+
 int searchIndex_putString(SearchIndex *index, IndexRegistryIndex *type,
 		char *value, int uid);
 
@@ -112,6 +135,20 @@ int searchIndex_removeString(SearchIndex *index, IndexRegistryIndex *type,
 int searchIndex_removeInteger(SearchIndex *index, IndexRegistryIndex *type,
 		int value, int uid);
 
+int searchIndex_putGeoCoord(SearchIndex *index, IndexRegistryIndex *type,
+		double latitude, double longitude, int uid);
+
+int searchIndex_removeGeoCoord(SearchIndex *index, IndexRegistryIndex *type,
+		double latitude, double longitude, int uid);
+
+int searchIndex_attachSegment(SearchIndex *index, SearchSegment *segment);
+
+int searchIndex_detachSegment(SearchIndex *index);
+
+int searchIndex_maskUid(SearchIndex *index, int uid);
+
+int searchIndex_writeSegment(SearchIndex *index, SearchSegmentWriter *writer);
+
 
 #if defined(__cplusplus)
 };
@@ -0,0 +1,764 @@
+/*
+ * search_segment.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The index segment component for the search-engine, an immutable on-disk
+ * snapshot of the search indexes which is memory-mapped and searched in
+ * place.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#include "core/core.h"
+#include "search/search.h"
+#define _SEARCH_SYSTEM_COMPONENT
+#include "search/system/search_segment.h"
+
+
+// define search segment private constants
+
+#define SEARCH_SEGMENT_ALIGNMENT						8
+
+
+// declare search segment private functions
+
+static int compareKeys(char *left, int leftLength, char *right,
+		int rightLength);
+
+static int compareEntryKeys(const void *left, const void *right);
+
+static int compareEntryValues(const void *left, const void *right);
+
+static int findValue(SearchSegmentTerm *terms, int termLength, int value,
+		aboolean isInclusive);
+
+static int writeData(SearchSegmentWriter *writer, char *data, alint length);
+
+static int writePadding(SearchSegmentWriter *writer);
+
+
+// define search segment private functions
+
+static int compareKeys(char *left, int leftLength, char *right,
+		int rightLength)
+{
+	int result = 0;
+
+	if((result = memcmp(left, right,
+					((leftLength < rightLength) ?
+					 leftLength : rightLength))) == 0) {
+		result = (leftLength - rightLength);
+	}
+
+	return result;
+}
+
+static int compareEntryKeys(const void *left, const void *right)
+{
+	SearchSegmentEntry *leftEntry = (SearchSegmentEntry *)left;
+	SearchSegmentEntry *rightEntry = (SearchSegmentEntry *)right;
+
+	return compareKeys(leftEntry->key, leftEntry->keyLength,
+			rightEntry->key, rightEntry->keyLength);
+}
+
+static int compareEntryValues(const void *left, const void *right)
+{
+	SearchSegmentEntry *leftEntry = (SearchSegmentEntry *)left;
+	SearchSegmentEntry *rightEntry = (SearchSegmentEntry *)right;
+
+	if(leftEntry->value < rightEntry->value) {
+		return -1;
+	}
+	else if(leftEntry->value > rightEntry->value) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static int findValue(SearchSegmentTerm *terms, int termLength, int value,
+		aboolean isInclusive)
+{
+	int low = 0;
+	int high = 0;
+	int middle = 0;
+
+	// the first term at or beyond the value when inclusive, otherwise the
+	// first term beyond it
+
+	low = 0;
+	high = termLength;
+
+	while(low < high) {
+		middle = (low + ((high - low) / 2));
+
+		if((terms[middle].value < value) ||
+				((!isInclusive) && (terms[middle].value == value))) {
+			low = (middle + 1);
+		}
+		else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+static int writeData(SearchSegmentWriter *writer, char *data, alint length)
+{
+	int chunk = 0;
+
+	while(length > 0) {
+		chunk = (int)((length > 1048576) ? 1048576 : length);
+
+		if(file_write(&writer->fh, data, chunk) < 0) {
+			return -1;
+		}
+
+		data += chunk;
+		length -= chunk;
+		writer->position += chunk;
+	}
+
+	return 0;
+}
+
+static int writePadding(SearchSegmentWriter *writer)
+{
+	int length = 0;
+	char padding[SEARCH_SEGMENT_ALIGNMENT];
+
+	if((length = (int)(writer->position % SEARCH_SEGMENT_ALIGNMENT)) == 0) {
+		return 0;
+	}
+
+	memset(padding, 0, (int)(sizeof(padding)));
+
+	return writeData(writer, padding, (SEARCH_SEGMENT_ALIGNMENT - length));
+}
+
+
+// define search segment public functions
+
+int searchSegment_init(SearchSegment *segment)
+{
+	if(segment == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(segment, 0, (int)(sizeof(SearchSegment)));
+
+	segment->isOpen = afalse;
+	segment->isMapped = afalse;
+	segment->generation = 0;
+	segment->length = 0;
+	segment->filename = NULL;
+	segment->data = NULL;
+	segment->header = NULL;
+	segment->sections = NULL;
+
+	return 0;
+}
+
+int searchSegment_free(SearchSegment *segment)
+{
+	if(segment == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(segment->data != NULL) {
+#if !defined(WIN32)
+		if(segment->isMapped) {
+			munmap(segment->data, (size_t)segment->length);
+		}
+		else {
+			free(segment->data);
+		}
+#else // WIN32
+		free(segment->data);
+#endif // !WIN32
+	}
+
+	if(segment->filename != NULL) {
+		free(segment->filename);
+	}
+
+	memset(segment, 0, (int)(sizeof(SearchSegment)));
+
+	return 0;
+}
+
+int searchSegment_open(SearchSegment *segment, char *filename)
+{
+	aboolean exists = afalse;
+	int ii = 0;
+	int iValue = 0;
+	alint length = 0;
+	char *data = NULL;
+
+	FileHandle fh;
+	SearchSegmentHeader *header = NULL;
+	SearchSegmentSection *section = NULL;
+
+	if((segment == NULL) || (filename == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(segment->isOpen) {
+		return -1;
+	}
+
+	if((system_fileExists(filename, &exists) < 0) || (!exists) ||
+			(system_fileLength(filename, &length) < 0) ||
+			(length < (alint)(sizeof(SearchSegmentHeader) + SIZEOF_INT))) {
+		return -1;
+	}
+
+	if(file_init(&fh, filename, "rb", 0) < 0) {
+		file_free(&fh);
+		return -1;
+	}
+
+	// map the file where the platform allows, otherwise read it into memory
+
+#if !defined(WIN32)
+	if((data = (char *)mmap(NULL, (size_t)length, PROT_READ, MAP_SHARED,
+					fileno(fh.fd), 0)) == (char *)MAP_FAILED) {
+		data = NULL;
+	}
+	else {
+		segment->isMapped = atrue;
+	}
+#endif // !WIN32
+
+	if(data == NULL) {
+		if(length > (alint)INT_MAX) {
+			file_free(&fh);
+			return -1;
+		}
+
+		data = (char *)malloc(sizeof(char) * length);
+
+		if(file_read(&fh, data, (int)length) != (int)length) {
+			free(data);
+			file_free(&fh);
+			return -1;
+		}
+	}
+
+	file_free(&fh);
+
+	segment->data = data;
+	segment->length = length;
+
+	// validate the header, the section table & the trailing magic number
+
+	header = (SearchSegmentHeader *)data;
+
+	memcpy(&iValue, (data + (length - SIZEOF_INT)), SIZEOF_INT);
+
+	if((header->magicNumber != SEARCH_SEGMENT_FILE_MAGIC_NUMBER) ||
+			(header->version != SEARCH_SEGMENT_FILE_VERSION) ||
+			(header->fileLength != length) ||
+			(header->sectionLength < 0) ||
+			(header->sectionOffset < (alint)sizeof(SearchSegmentHeader)) ||
+			((header->sectionOffset % SEARCH_SEGMENT_ALIGNMENT) != 0) ||
+			((header->sectionOffset +
+			  ((alint)header->sectionLength *
+			   (alint)sizeof(SearchSegmentSection))) >
+			 (length - SIZEOF_INT)) ||
+			(iValue != SEARCH_SEGMENT_FILE_MAGIC_NUMBER)) {
+		searchSegment_free(segment);
+		return -1;
+	}
+
+	segment->header = header;
+	segment->sections = (SearchSegmentSection *)(data +
+			header->sectionOffset);
+
+	for(ii = 0; ii < header->sectionLength; ii++) {
+		section = &segment->sections[ii];
+
+		if((section->termLength < 0) ||
+				(section->domainKeyLength < 1) ||
+				(section->indexKeyLength < 1) ||
+				(section->domainKeyOffset < 0) ||
+				(section->indexKeyOffset < 0) ||
+				(section->termOffset < 0) ||
+				((section->termOffset % SEARCH_SEGMENT_ALIGNMENT) != 0) ||
+				((section->domainKeyOffset + section->domainKeyLength) >
+				 length) ||
+				((section->indexKeyOffset + section->indexKeyLength) >
+				 length) ||
+				((section->termOffset +
+				  ((alint)section->termLength *
+				   (alint)sizeof(SearchSegmentTerm))) > length)) {
+			searchSegment_free(segment);
+			return -1;
+		}
+	}
+
+	segment->isOpen = atrue;
+	segment->generation = header->generation;
+	segment->filename = strdup(filename);
+
+	return 0;
+}
+
+aboolean searchSegment_isOpen(SearchSegment *segment)
+{
+	if(segment == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	return segment->isOpen;
+}
+
+SearchSegmentSection *searchSegment_getSection(SearchSegment *segment,
+		char *domainKey, char *indexKey, IndexRegistryTypes type)
+{
+	int ii = 0;
+	int domainKeyLength = 0;
+	int indexKeyLength = 0;
+
+	SearchSegmentSection *section = NULL;
+
+	if((segment == NULL) || (domainKey == NULL) || (indexKey == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	if(!segment->isOpen) {
+		return NULL;
+	}
+
+	domainKeyLength = strlen(domainKey);
+	indexKeyLength = strlen(indexKey);
+
+	for(ii = 0; ii < segment->header->sectionLength; ii++) {
+		section = &segment->sections[ii];
+
+		if((section->type == (int)type) &&
+				(section->domainKeyLength == domainKeyLength) &&
+				(section->indexKeyLength == indexKeyLength) &&
+				(!memcmp((segment->data + section->domainKeyOffset),
+						 domainKey, domainKeyLength)) &&
+				(!memcmp((segment->data + section->indexKeyOffset),
+						 indexKey, indexKeyLength))) {
+			return section;
+		}
+	}
+
+	return NULL;
+}
+
+SearchSegmentTerm *searchSegment_getTerms(SearchSegment *segment,
+		SearchSegmentSection *section)
+{
+	if((segment == NULL) || (section == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	return (SearchSegmentTerm *)(segment->data + section->termOffset);
+}
+
+char *searchSegment_getTermKey(SearchSegment *segment,
+		SearchSegmentTerm *term)
+{
+	if((segment == NULL) || (term == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	if((term->keyOffset < 0) || (term->keyLength < 0) ||
+			((term->keyOffset + term->keyLength) > segment->length)) {
+		return NULL;
+	}
+
+	return (segment->data + term->keyOffset);
+}
+
+int *searchSegment_getPosting(SearchSegment *segment, SearchSegmentTerm *term,
+		int *length)
+{
+	if((segment == NULL) || (term == NULL) || (length == NULL)) {
+		DISPLAY_INVALID_ARGS;
+
+		if(length != NULL) {
+			*length = 0;
+		}
+
+		return NULL;
+	}
+
+	*length = 0;
+
+	if((term->postingOffset < 0) || (term->postingLength < 1) ||
+			((term->postingOffset % SIZEOF_INT) != 0) ||
+			((term->postingOffset +
+			  ((alint)term->postingLength * (alint)SIZEOF_INT)) >
+			 segment->length)) {
+		return NULL;
+	}
+
+	*length = term->postingLength;
+
+	return (int *)(segment->data + term->postingOffset);
+}
+
+SearchSegmentTerm *searchSegment_findTerm(SearchSegment *segment,
+		SearchSegmentSection *section, char *key, int keyLength)
+{
+	int low = 0;
+	int high = 0;
+	int middle = 0;
+	int result = 0;
+	char *termKey = NULL;
+
+	SearchSegmentTerm *terms = NULL;
+
+	if((segment == NULL) || (section == NULL) || (key == NULL) ||
+			(keyLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	terms = searchSegment_getTerms(segment, section);
+
+	low = 0;
+	high = (section->termLength - 1);
+
+	while(low <= high) {
+		middle = (low + ((high - low) / 2));
+
+		if((termKey = searchSegment_getTermKey(segment,
+						&terms[middle])) == NULL) {
+			return NULL;
+		}
+
+		if((result = compareKeys(termKey, terms[middle].keyLength, key,
+						keyLength)) == 0) {
+			return &terms[middle];
+		}
+		else if(result < 0) {
+			low = (middle + 1);
+		}
+		else {
+			high = (middle - 1);
+		}
+	}
+
+	return NULL;
+}
+
+int searchSegment_findRange(SearchSegment *segment,
+		SearchSegmentSection *section, int searchType, int minValue,
+		int maxValue, int *first, int *last)
+{
+	SearchSegmentTerm *terms = NULL;
+
+	if((segment == NULL) || (section == NULL) || (first == NULL) ||
+			(last == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	terms = searchSegment_getTerms(segment, section);
+
+	// match the bounds of the range index searches
+
+	switch(searchType) {
+		case RANGE_INDEX_SEARCH_GREATER_THAN:
+			*first = findValue(terms, section->termLength, minValue, afalse);
+			*last = section->termLength;
+			break;
+
+		case RANGE_INDEX_SEARCH_LESS_THAN:
+			*first = 0;
+			*last = findValue(terms, section->termLength, minValue, atrue);
+			break;
+
+		case RANGE_INDEX_SEARCH_BETWEEN:
+			*first = findValue(terms, section->termLength, minValue, atrue);
+			*last = findValue(terms, section->termLength, maxValue, afalse);
+			break;
+
+		default:
+			*first = 0;
+			*last = 0;
+			return -1;
+	}
+
+	if(*last < *first) {
+		*last = *first;
+	}
+
+	return (*last - *first);
+}
+
+int searchSegmentWriter_init(SearchSegmentWriter *writer, char *filename,
+		int generation)
+{
+	SearchSegmentHeader header;
+
+	if((writer == NULL) || (filename == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(writer, 0, (int)(sizeof(SearchSegmentWriter)));
+
+	writer->generation = generation;
+	writer->sectionRef = 0;
+	writer->sectionLength = SEARCH_SEGMENT_DEFAULT_SECTION_LENGTH;
+	writer->position = 0;
+	writer->filename = strdup(filename);
+	writer->sections = (SearchSegmentSection *)malloc(
+			sizeof(SearchSegmentSection) * writer->sectionLength);
+
+	if(file_init(&writer->fh, filename, "wb", 0) < 0) {
+		file_free(&writer->fh);
+		free(writer->sections);
+		free(writer->filename);
+		memset(writer, 0, (int)(sizeof(SearchSegmentWriter)));
+		return -1;
+	}
+
+	// the header is rewritten once the file is complete
+
+	memset(&header, 0, (int)(sizeof(SearchSegmentHeader)));
+
+	return writeData(writer, (char *)&header,
+			(alint)sizeof(SearchSegmentHeader));
+}
+
+int searchSegmentWriter_putSection(SearchSegmentWriter *writer,
+		char *domainKey, char *indexKey, IndexRegistryTypes type,
+		SearchSegmentEntry *entries, int entryLength)
+{
+	int ii = 0;
+	alint keyOffset = 0;
+	alint keysLength = 0;
+	alint postingOffset = 0;
+
+	SearchSegmentTerm *terms = NULL;
+	SearchSegmentSection *section = NULL;
+
+	if((writer == NULL) || (writer->sections == NULL) ||
+			(domainKey == NULL) || (indexKey == NULL) ||
+			((entries == NULL) && (entryLength > 0)) || (entryLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(writer->sectionRef >= writer->sectionLength) {
+		writer->sectionLength *= 2;
+		writer->sections = (SearchSegmentSection *)realloc(writer->sections,
+				(sizeof(SearchSegmentSection) * writer->sectionLength));
+	}
+
+	section = &writer->sections[writer->sectionRef];
+
+	memset(section, 0, (int)(sizeof(SearchSegmentSection)));
+
+	section->type = (int)type;
+	section->termLength = entryLength;
+	section->domainKeyLength = strlen(domainKey);
+	section->indexKeyLength = strlen(indexKey);
+
+	// sort the terms as the reader will search them
+
+	if(entryLength > 1) {
+		if((type == INDEX_REGISTRY_TYPE_RANGE) ||
+				(type == INDEX_REGISTRY_TYPE_GEO)) {
+			qsort(entries, entryLength, sizeof(SearchSegmentEntry),
+					compareEntryValues);
+		}
+		else {
+			qsort(entries, entryLength, sizeof(SearchSegmentEntry),
+					compareEntryKeys);
+		}
+	}
+
+	// write the section keys
+
+	section->domainKeyOffset = writer->position;
+
+	if(writeData(writer, domainKey, section->domainKeyLength) < 0) {
+		return -1;
+	}
+
+	section->indexKeyOffset = writer->position;
+
+	if((writeData(writer, indexKey, section->indexKeyLength) < 0) ||
+			(writePadding(writer) < 0)) {
+		return -1;
+	}
+
+	// lay out the term table, followed by the term keys & the postings
+
+	section->termOffset = writer->position;
+
+	for(ii = 0, keysLength = 0; ii < entryLength; ii++) {
+		keysLength += entries[ii].keyLength;
+	}
+
+	keyOffset = (section->termOffset +
+			((alint)entryLength * (alint)sizeof(SearchSegmentTerm)));
+
+	postingOffset = (keyOffset + keysLength);
+
+	if((postingOffset % SEARCH_SEGMENT_ALIGNMENT) != 0) {
+		postingOffset += (SEARCH_SEGMENT_ALIGNMENT -
+				(postingOffset % SEARCH_SEGMENT_ALIGNMENT));
+	}
+
+	if(entryLength > 0) {
+		terms = (SearchSegmentTerm *)malloc(sizeof(SearchSegmentTerm) *
+				entryLength);
+
+		for(ii = 0; ii < entryLength; ii++) {
+			terms[ii].keyOffset = keyOffset;
+			terms[ii].postingOffset = postingOffset;
+			terms[ii].keyLength = entries[ii].keyLength;
+			terms[ii].postingLength = entries[ii].uidLength;
+			terms[ii].value = entries[ii].value;
+			terms[ii].reserved = 0;
+
+			keyOffset += entries[ii].keyLength;
+			postingOffset += ((alint)entries[ii].uidLength *
+					(alint)SIZEOF_INT);
+		}
+
+		if(writeData(writer, (char *)terms,
+					((alint)entryLength *
+					 (alint)sizeof(SearchSegmentTerm))) < 0) {
+			free(terms);
+			return -1;
+		}
+
+		free(terms);
+
+		for(ii = 0; ii < entryLength; ii++) {
+			if(writeData(writer, entries[ii].key,
+						entries[ii].keyLength) < 0) {
+				return -1;
+			}
+		}
+
+		if(writePadding(writer) < 0) {
+			return -1;
+		}
+
+		for(ii = 0; ii < entryLength; ii++) {
+			if(writeData(writer, (char *)entries[ii].uids,
+						((alint)entries[ii].uidLength *
+						 (alint)SIZEOF_INT)) < 0) {
+				return -1;
+			}
+		}
+
+		if(writePadding(writer) < 0) {
+			return -1;
+		}
+	}
+
+	writer->sectionRef += 1;
+
+	return 0;
+}
+
+int searchSegmentWriter_free(SearchSegmentWriter *writer, aboolean isComplete)
+{
+	int result = 0;
+	int iValue = 0;
+
+	SearchSegmentHeader header;
+
+	if(writer == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(writer->filename == NULL) {
+		return -1;
+	}
+
+	// write the section table & trailing magic number, then the header
+
+	if(isComplete) {
+		memset(&header, 0, (int)(sizeof(SearchSegmentHeader)));
+
+		header.magicNumber = SEARCH_SEGMENT_FILE_MAGIC_NUMBER;
+		header.version = SEARCH_SEGMENT_FILE_VERSION;
+		header.generation = writer->generation;
+		header.sectionLength = writer->sectionRef;
+		header.sectionOffset = writer->position;
+
+		iValue = SEARCH_SEGMENT_FILE_MAGIC_NUMBER;
+
+		if(((writer->sectionRef > 0) &&
+					(writeData(writer, (char *)writer->sections,
+							   ((alint)writer->sectionRef *
+								(alint)sizeof(SearchSegmentSection))) < 0)) ||
+				(writeData(writer, (char *)&iValue, SIZEOF_INT) < 0)) {
+			result = -1;
+		}
+
+		header.fileLength = writer->position;
+
+		if((result == 0) &&
+				((file_seek(&writer->fh, 0) < 0) ||
+				 (file_write(&writer->fh, (char *)&header,
+							 (int)sizeof(SearchSegmentHeader)) < 0) ||
+				 (searchWal_syncFileHandle(&writer->fh) < 0))) {
+			result = -1;
+		}
+	}
+
+	file_free(&writer->fh);
+
+	if((!isComplete) || (result < 0)) {
+		system_fileDelete(writer->filename);
+		result = -1;
+	}
+
+	free(writer->sections);
+	free(writer->filename);
+
+	memset(writer, 0, (int)(sizeof(SearchSegmentWriter)));
+
+	return result;
+}
+
+void searchSegment_freeEntries(SearchSegmentEntry *entries, int entryLength)
+{
+	int ii = 0;
+
+	if(entries == NULL) {
+		return;
+	}
+
+	for(ii = 0; ii < entryLength; ii++) {
+		if(entries[ii].key != NULL) {
+			free(entries[ii].key);
+		}
+
+		if(entries[ii].uids != NULL) {
+			free(entries[ii].uids);
+		}
+	}
+
+	free(entries);
+}
+
@@ -0,0 +1,158 @@
+/*
+ * search_segment.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The index segment component for the search-engine, an immutable on-disk
+ * snapshot of the search indexes which is memory-mapped and searched in
+ * place, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_SEARCH_SYSTEM_SEARCH_SEGMENT_H)
+
+#define _SEARCH_SYSTEM_SEARCH_SEGMENT_H
+
+#if !defined(_SEARCH_H) && !defined(_SEARCH_SYSTEM_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _SEARCH_H || _SEARCH_SYSTEM_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define search segment public constants
+
+#define SEARCH_SEGMENT_FILE_MAGIC_NUMBER				53468724
+
+#define SEARCH_SEGMENT_FILE_VERSION						1
+
+#define SEARCH_SEGMENT_DEFAULT_SECTION_LENGTH			16
+
+
+// define search segment public data types
+
+/*
+ * The file is written in native byte order with every structure aligned to
+ * eight bytes, so that it may be used in place once mapped; a file from a
+ * machine of the other byte order fails the magic number check. Offsets are
+ * from the start of the file.
+ *
+ * Each section holds one index of one domain, as a term table sorted by key
+ * (or by value, for range & geo indexes) pointing at sorted UID posting
+ * arrays. The postings of a range section are laid out in value order, so
+ * that any range of values is a single contiguous block of the file.
+ */
+
+typedef struct _SearchSegmentHeader {
+	int magicNumber;
+	int version;
+	int generation;
+	int sectionLength;
+	alint sectionOffset;
+	alint fileLength;
+} SearchSegmentHeader;
+
+typedef struct _SearchSegmentSection {
+	alint domainKeyOffset;
+	alint indexKeyOffset;
+	alint termOffset;
+	int domainKeyLength;
+	int indexKeyLength;
+	int type;
+	int termLength;
+} SearchSegmentSection;
+
+typedef struct _SearchSegmentTerm {
+	alint keyOffset;
+	alint postingOffset;
+	int keyLength;
+	int postingLength;
+	int value;
+	int reserved;
+} SearchSegmentTerm;
+
+typedef struct _SearchSegment {
+	aboolean isOpen;
+	aboolean isMapped;
+	int generation;
+	alint length;
+	char *filename;
+	char *data;
+	SearchSegmentHeader *header;
+	SearchSegmentSection *sections;
+} SearchSegment;
+
+/*
+ * A term handed to the writer, with its UIDs sorted & unique.
+ */
+
+typedef struct _SearchSegmentEntry {
+	int value;
+	int keyLength;
+	int uidLength;
+	int *uids;
+	char *key;
+} SearchSegmentEntry;
+
+typedef struct _SearchSegmentWriter {
+	int generation;
+	int sectionRef;
+	int sectionLength;
+	alint position;
+	char *filename;
+	SearchSegmentSection *sections;
+	FileHandle fh;
+} SearchSegmentWriter;
+
+
+// delcare search segment public functions
+
+int searchSegment_init(SearchSegment *segment);
+
+int searchSegment_free(SearchSegment *segment);
+
+int searchSegment_open(SearchSegment *segment, char *filename);
+
+aboolean searchSegment_isOpen(SearchSegment *segment);
+
+SearchSegmentSection *searchSegment_getSection(SearchSegment *segment,
+		char *domainKey, char *indexKey, IndexRegistryTypes type);
+
+SearchSegmentTerm *searchSegment_getTerms(SearchSegment *segment,
+		SearchSegmentSection *section);
+
+char *searchSegment_getTermKey(SearchSegment *segment,
+		SearchSegmentTerm *term);
+
+int *searchSegment_getPosting(SearchSegment *segment, SearchSegmentTerm *term,
+		int *length);
+
+SearchSegmentTerm *searchSegment_findTerm(SearchSegment *segment,
+		SearchSegmentSection *section, char *key, int keyLength);
+
+int searchSegment_findRange(SearchSegment *segment,
+		SearchSegmentSection *section, int searchType, int minValue,
+		int maxValue, int *first, int *last);
+
+int searchSegmentWriter_init(SearchSegmentWriter *writer, char *filename,
+		int generation);
+
+int searchSegmentWriter_putSection(SearchSegmentWriter *writer,
+		char *domainKey, char *indexKey, IndexRegistryTypes type,
+		SearchSegmentEntry *entries, int entryLength);
+
+int searchSegmentWriter_free(SearchSegmentWriter *writer, aboolean isComplete);
+
+void searchSegment_freeEntries(SearchSegmentEntry *entries, int entryLength);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _SEARCH_SYSTEM_SEARCH_SEGMENT_H
+
@@ -21,8 +21,15 @@
 
 // define search sort private data types
 
+/*
+ * An attribute sort entry either holds a copy of the attribute value, or when
+ * the attribute is served from doc values, the rank of its value among the
+ * distinct values being sorted (otherwise the rank is -1).
+ */
+
 typedef struct _AttributeSort {
 	int uid;
+	int rank;
 	int length;
 	char *value;
 } AttributeSort;
@@ -52,6 +59,13 @@ typedef struct _EntityGeoCoord {
 static char **castSerialStringArray(char *string, int stringLength,
 		int arrayLength);
 
+static void partialSort(void *array, int length, int size, int limit,
+		int (*compare)(const void *left, const void *right));
+
+static void partialSort_siftDown(char *array, int length, int size,
+		int index, char *swap,
+		int (*compare)(const void *left, const void *right));
+
 // attribute functions
 
 static int attribute_compareValues(char *keyAlpha, int keyAlphaLength,
@@ -67,6 +81,12 @@ static alint attribute_calculateBuildEntryMemoryLength(SearchEngine *engine,
 static void attribute_buildEntry(SearchEngine *engine, char *attribute,
 		int uid, AttributeSort *sortEntry);
 
+static DocValues *attribute_getDocValues(SearchEngine *engine,
+		char *attribute);
+
+static int *attribute_rankDocValues(DocValues *docValues, int *uids,
+		int uidLength);
+
 // relevancy functions
 
 static int relevancy_compareAscending(const void *left, const void *right);
@@ -80,6 +100,10 @@ static void relevancy_buildEntry(SearchEngine *engine, char **tokenList,
 		int tokenCount, char *relevancyKey, char *relevancyLengthKey,
 		int uid, RelevancySort *relevancySort);
 
+static double *relevancy_scoreDocValues(SearchEngine *engine,
+		IndexRegistryIndex *indexType, char **tokenList, int tokenCount,
+		int *uids, int uidLength);
+
 // distance functions
 
 static int distance_compareAscending(const void *left, const void *right);
@@ -97,7 +121,8 @@ static int multiValue_compare(const void *left, const void *right);
 
 // facet functions
 
-static SearchSortFacetEntry *facet_new(char *value, int valueLength);
+static SearchSortFacetEntry *facet_new(char *value, int valueLength,
+		int count);
 
 static void facet_free(void *memory);
 
@@ -107,6 +132,10 @@ static void facet_updateIndex(SearchEngine *engine,
 		IndexRegistryIndexSetting *settings, IndexRegistryTypes type,
 		char *attribute, int attributeLength, int uid, Bptree *index);
 
+static void facet_updateIndexValue(SearchEngine *engine,
+		IndexRegistryIndexSetting *settings, IndexRegistryTypes type,
+		char *value, int valueLength, int count, Bptree *index);
+
 
 // define search sort private functions
 
@@ -151,6 +180,74 @@ static char **castSerialStringArray(char *string, int stringLength,
 	return result;
 }
 
+static void partialSort(void *array, int length, int size, int limit,
+		int (*compare)(const void *left, const void *right))
+{
+	int ii = 0;
+	char *base = NULL;
+	char *swap = NULL;
+
+	if((limit < 1) || (limit >= length) ||
+			(limit > (length / SEARCH_SORT_PARTIAL_SORT_RATIO))) {
+		qsort(array, length, size, compare);
+		return;
+	}
+
+	/*
+	 * keep the leading limit entries as a heap with the greatest entry at the
+	 * root, and swap in any later entry which sorts before the root, leaving
+	 * the remaining entries after the limit in no particular order
+	 */
+
+	base = (char *)array;
+	swap = (char *)malloc(sizeof(char) * size);
+
+	for(ii = ((limit / 2) - 1); ii >= 0; ii--) {
+		partialSort_siftDown(base, limit, size, ii, swap, compare);
+	}
+
+	for(ii = limit; ii < length; ii++) {
+		if(compare((const void *)(base + (ii * size)),
+					(const void *)base) < 0) {
+			memcpy(swap, base, size);
+			memcpy(base, (base + (ii * size)), size);
+			memcpy((base + (ii * size)), swap, size);
+
+			partialSort_siftDown(base, limit, size, 0, swap, compare);
+		}
+	}
+
+	free(swap);
+
+	qsort(array, limit, size, compare);
+}
+
+static void partialSort_siftDown(char *array, int length, int size,
+		int index, char *swap,
+		int (*compare)(const void *left, const void *right))
+{
+	int child = 0;
+
+	while((child = ((index * 2) + 1)) < length) {
+		if(((child + 1) < length) &&
+				(compare((const void *)(array + (child * size)),
+						 (const void *)(array + ((child + 1) * size))) < 0)) {
+			child++;
+		}
+
+		if(compare((const void *)(array + (index * size)),
+					(const void *)(array + (child * size))) >= 0) {
+			break;
+		}
+
+		memcpy(swap, (array + (index * size)), size);
+		memcpy((array + (index * size)), (array + (child * size)), size);
+		memcpy((array + (child * size)), swap, size);
+
+		index = child;
+	}
+}
+
 // attribute functions
 
 static int attribute_compareValues(char *keyAlpha, int keyAlphaLength,
@@ -258,6 +355,16 @@ static int attribute_compareAscending(const void *left, const void *right)
 	alpha = (AttributeSort *)((aptrcast)left);
 	beta = (AttributeSort *)((aptrcast)right);
 
+	if((alpha->rank >= 0) && (beta->rank >= 0)) {
+		if(alpha->rank < beta->rank) {
+			return -1;
+		}
+		else if(alpha->rank > beta->rank) {
+			return 1;
+		}
+		return 0;
+	}
+
 	return attribute_compareValues(alpha->value, alpha->length, beta->value,
 			beta->length);
 }
@@ -282,6 +389,16 @@ static int attribute_compareDescending(const void *left, const void *right)
 	alpha = (AttributeSort *)((aptrcast)left);
 	beta = (AttributeSort *)((aptrcast)right);
 
+	if((alpha->rank >= 0) && (beta->rank >= 0)) {
+		if(alpha->rank < beta->rank) {
+			return 1;
+		}
+		else if(alpha->rank > beta->rank) {
+			return -1;
+		}
+		return 0;
+	}
+
 	if((result = attribute_compareValues(alpha->value, alpha->length,
 					beta->value, beta->length)) != 0) {
 		result *= -1;
@@ -345,6 +462,8 @@ static void attribute_buildEntry(SearchEngine *engine, char *attribute,
 
 	Container *container = NULL;
 
+	sortEntry->rank = -1;
+
 	if((uid <= 0) ||
 			((container = searchEngine_get(engine, uid, &rc)) == NULL)) {
 		sortEntry->uid = uid;
@@ -382,6 +501,97 @@ static void attribute_buildEntry(SearchEngine *engine, char *attribute,
 	searchEngine_unlockGet(engine, container);
 }
 
+static DocValues *attribute_getDocValues(SearchEngine *engine,
+		char *attribute)
+{
+	if((!strcasecmp(attribute, SEARCHD_CONTAINER_UID)) ||
+			(!strcasecmp(attribute, SEARCHD_CONTAINER_NAME))) {
+		return NULL;
+	}
+
+	return searchEngine_getDocValues(engine, attribute);
+}
+
+static int *attribute_rankDocValues(DocValues *docValues, int *uids,
+		int uidLength)
+{
+	int ii = 0;
+	int rank = 0;
+	int valueLength = 0;
+	int *ranks = NULL;
+	int *result = NULL;
+	int *valueIds = NULL;
+
+	AttributeSort *sortArray = NULL;
+	DocValuesValue *values = NULL;
+
+	valueIds = (int *)malloc(sizeof(int) * uidLength);
+
+	if((valueLength = docValues_collect(docValues, uids, uidLength,
+					valueIds, &values)) < 0) {
+		free(valueIds);
+		return NULL;
+	}
+
+	/*
+	 * rank the distinct values once, rather than comparing a copy of the
+	 * value for every UID, with the last slot standing in for a missing value
+	 */
+
+	sortArray = (AttributeSort *)malloc(sizeof(AttributeSort) *
+			(valueLength + 1));
+
+	for(ii = 0; ii < valueLength; ii++) {
+		sortArray[ii].uid = ii;
+		sortArray[ii].rank = -1;
+		sortArray[ii].length = values[ii].length;
+		sortArray[ii].value = values[ii].value;
+	}
+
+	sortArray[valueLength].uid = valueLength;
+	sortArray[valueLength].rank = -1;
+	sortArray[valueLength].length = 8;
+	sortArray[valueLength].value = "ZZZZZZZZ";
+
+	qsort((void *)sortArray,
+			(valueLength + 1),
+			(int)sizeof(AttributeSort),
+			attribute_compareAscending);
+
+	ranks = (int *)malloc(sizeof(int) * (valueLength + 1));
+
+	for(ii = 0; ii <= valueLength; ii++) {
+		if((ii > 0) &&
+				(attribute_compareAscending((const void *)&sortArray[ii - 1],
+						(const void *)&sortArray[ii]) != 0)) {
+			rank = ii;
+		}
+
+		ranks[sortArray[ii].uid] = rank;
+	}
+
+	result = (int *)malloc(sizeof(int) * uidLength);
+
+	for(ii = 0; ii < uidLength; ii++) {
+		if(valueIds[ii] < 0) {
+			result[ii] = ranks[valueLength];
+		}
+		else {
+			result[ii] = ranks[valueIds[ii]];
+		}
+	}
+
+	// cleanup
+
+	docValues_freeValues(values, valueLength);
+
+	free(sortArray);
+	free(ranks);
+	free(valueIds);
+
+	return result;
+}
+
 // relevancy functions
 
 static int relevancy_compareAscending(const void *left, const void *right)
@@ -527,6 +737,77 @@ static void relevancy_buildEntry(SearchEngine *engine, char **tokenList,
 	}
 }
 
+static double *relevancy_scoreDocValues(SearchEngine *engine,
+		IndexRegistryIndex *indexType, char **tokenList, int tokenCount,
+		int *uids, int uidLength)
+{
+	int ii = 0;
+	int valueLength = 0;
+	int *valueIds = NULL;
+	double *scores = NULL;
+	double *result = NULL;
+	char **relevancyList = NULL;
+
+	DocValues *docValues = NULL;
+	DocValuesValue *values = NULL;
+
+	if((docValues = searchEngine_getDocValues(engine,
+					indexType->key)) == NULL) {
+		return NULL;
+	}
+
+	valueIds = (int *)malloc(sizeof(int) * uidLength);
+
+	if((valueLength = docValues_collect(docValues, uids, uidLength,
+					valueIds, &values)) < 0) {
+		free(valueIds);
+		return NULL;
+	}
+
+	// score each distinct value once, from its copy of the relevancy array
+
+	scores = (double *)malloc(sizeof(double) * (valueLength + 1));
+
+	for(ii = 0; ii < valueLength; ii++) {
+		if((values[ii].relevancy != NULL) &&
+				(values[ii].relevancyLength > 0) &&
+				(values[ii].relevancyArrayLength > 0)) {
+			relevancyList = castSerialStringArray(values[ii].relevancy,
+					values[ii].relevancyLength,
+					values[ii].relevancyArrayLength);
+
+			scores[ii] = compareArrays(relevancyList,
+					values[ii].relevancyArrayLength, tokenList, tokenCount,
+					4);
+		}
+		else {
+			scores[ii] = 0.0;
+		}
+	}
+
+	scores[valueLength] = 0.0;
+
+	result = (double *)malloc(sizeof(double) * uidLength);
+
+	for(ii = 0; ii < uidLength; ii++) {
+		if(valueIds[ii] < 0) {
+			result[ii] = scores[valueLength];
+		}
+		else {
+			result[ii] = scores[valueIds[ii]];
+		}
+	}
+
+	// cleanup
+
+	docValues_freeValues(values, valueLength);
+
+	free(scores);
+	free(valueIds);
+
+	return result;
+}
+
 // distance functions
 
 static int distance_compareAscending(const void *left, const void *right)
@@ -701,13 +982,14 @@ static int multiValue_compare(const void *left, const void *right)
 
 // facet functions
 
-static SearchSortFacetEntry *facet_new(char *value, int valueLength)
+static SearchSortFacetEntry *facet_new(char *value, int valueLength,
+		int count)
 {
 	SearchSortFacetEntry *result = NULL;
 
 	result = (SearchSortFacetEntry *)malloc(sizeof(SearchSortFacetEntry));
 
-	result->count = 1;
+	result->count = count;
 	result->value = strndup(value, valueLength);
 
 	return result;
@@ -742,21 +1024,10 @@ static void facet_updateIndex(SearchEngine *engine,
 		IndexRegistryIndexSetting *settings, IndexRegistryTypes type,
 		char *attribute, int attributeLength, int uid, Bptree *index)
 {
-	int ii = 0;
 	int rc = 0;
-	int tokenCount = 0;
 	int valueLength = 0;
-	int stringLength = 0;
-	int stringResultLength = 0;
-	int esaStringLength = 0;
-	int *tokenLengths = NULL;
 	char *value = NULL;
-	char *string = NULL;
-	char *esaString = NULL;
-	char *excludedWord = NULL;
-	char **tokenList = NULL;
 
-	SearchSortFacetEntry *entry = NULL;
 	Container *container = NULL;
 
 	if((uid <= 0) ||
@@ -769,10 +1040,34 @@ static void facet_updateIndex(SearchEngine *engine,
 
 	searchEngine_unlockGet(engine, container);
 
-	if((value == NULL) || (valueLength < 1)) {
-		if(value != NULL) {
-			free(value);
-		}
+	if(value == NULL) {
+		return;
+	}
+
+	facet_updateIndexValue(engine, settings, type, value, valueLength, 1,
+			index);
+
+	free(value);
+}
+
+static void facet_updateIndexValue(SearchEngine *engine,
+		IndexRegistryIndexSetting *settings, IndexRegistryTypes type,
+		char *value, int valueLength, int count, Bptree *index)
+{
+	int ii = 0;
+	int tokenCount = 0;
+	int stringLength = 0;
+	int stringResultLength = 0;
+	int esaStringLength = 0;
+	int *tokenLengths = NULL;
+	char *string = NULL;
+	char *esaString = NULL;
+	char *excludedWord = NULL;
+	char **tokenList = NULL;
+
+	SearchSortFacetEntry *entry = NULL;
+
+	if((value == NULL) || (valueLength < 1) || (count < 1)) {
 		return;
 	}
 
@@ -830,14 +1125,14 @@ static void facet_updateIndex(SearchEngine *engine,
 			free(string);
 
 			if(bptree_get(index, value, valueLength, (void *)&entry) < 0) {
-				entry = facet_new(value, valueLength);
+				entry = facet_new(value, valueLength, count);
 
 				if(bptree_put(index, value, valueLength, (void *)entry) < 0) {
 					facet_free(entry);
 				}
 			}
 			else {
-				entry->count += 1;
+				entry->count += count;
 			}
 		} while(afalse);
 	}
@@ -853,7 +1148,6 @@ static void facet_updateIndex(SearchEngine *engine,
 					&tokenList,
 					&tokenLengths,
 					&tokenCount) < 0) {
-			free(value);
 			return;
 		}
 
@@ -876,8 +1170,6 @@ static void facet_updateIndex(SearchEngine *engine,
 				free(tokenList);
 			}
 
-			free(value);
-
 			return;
 		}
 
@@ -941,7 +1233,8 @@ static void facet_updateIndex(SearchEngine *engine,
 
 			if(bptree_get(index, tokenList[ii], tokenLengths[ii],
 						(void *)&entry) < 0) {
-				entry = facet_new(tokenList[ii], tokenLengths[ii]);
+				entry = facet_new(tokenList[ii], tokenLengths[ii],
+						count);
 
 				if(bptree_put(index, tokenList[ii], tokenLengths[ii],
 							(void *)entry) < 0) {
@@ -949,7 +1242,7 @@ static void facet_updateIndex(SearchEngine *engine,
 				}
 			}
 			else {
-				entry->count += 1;
+				entry->count += count;
 			}
 
 			free(tokenList[ii]);
@@ -958,10 +1251,6 @@ static void facet_updateIndex(SearchEngine *engine,
 		free(tokenList);
 		free(tokenLengths);
 	}
-
-	// cleanup
-
-	free(value);
 }
 
 
@@ -971,9 +1260,33 @@ static void facet_updateIndex(SearchEngine *engine,
 
 int searchSort_sortByAttributeName(SearchEngine *engine, char *attribute,
 		Intersect *intersect, aboolean isStandardOrder)
+{
+	return searchSort_partialSortByAttributeName(engine, attribute,
+			intersect, isStandardOrder, 0);
+}
+
+int searchSort_sortByRelevancy(SearchEngine *engine, char *attribute,
+		char *value, Intersect *intersect, aboolean isStandardOrder)
+{
+	return searchSort_partialSortByRelevancy(engine, attribute, value,
+			intersect, isStandardOrder, 0);
+}
+
+int searchSort_sortByDistance(SearchEngine *engine, double latitude,
+		double longitude, Intersect *intersect, aboolean isStandardOrder)
+{
+	return searchSort_partialSortByDistance(engine, latitude, longitude,
+			intersect, isStandardOrder, 0);
+}
+
+int searchSort_partialSortByAttributeName(SearchEngine *engine,
+		char *attribute, Intersect *intersect, aboolean isStandardOrder,
+		int limit)
 {
 	int ii = 0;
+	int *ranks = NULL;
 
+	DocValues *docValues = NULL;
 	AttributeSort *sortArray = NULL;
 
 	if((engine == NULL) || (intersect == NULL) || (attribute == NULL)) {
@@ -985,26 +1298,45 @@ int searchSort_sortByAttributeName(SearchEngine *engine, char *attribute,
 		return 0; // nothing to sort
 	}
 
+	if((docValues = attribute_getDocValues(engine, attribute)) != NULL) {
+		ranks = attribute_rankDocValues(docValues, intersect->result.array,
+				intersect->result.length);
+	}
+
 	sortArray = (AttributeSort *)malloc(sizeof(AttributeSort) *
 			intersect->result.length);
 
 	for(ii = 0; ii < intersect->result.length; ii++) {
+		if(ranks != NULL) {
+			sortArray[ii].uid = intersect->result.array[ii];
+			sortArray[ii].rank = ranks[ii];
+			sortArray[ii].length = 0;
+			sortArray[ii].value = NULL;
+			continue;
+		}
+
 		attribute_buildEntry(engine,
 				attribute,
 				intersect->result.array[ii],
 				&(sortArray[ii]));
 	}
 
+	if(ranks != NULL) {
+		free(ranks);
+	}
+
 	if(isStandardOrder) {
-		qsort((void *)sortArray,
+		partialSort((void *)sortArray,
 				intersect->result.length,
 				(int)sizeof(AttributeSort),
+				limit,
 				attribute_compareDescending);
 	}
 	else {
-		qsort((void *)sortArray,
+		partialSort((void *)sortArray,
 				intersect->result.length,
 				(int)sizeof(AttributeSort),
+				limit,
 				attribute_compareAscending);
 	}
 
@@ -1021,12 +1353,14 @@ int searchSort_sortByAttributeName(SearchEngine *engine, char *attribute,
 	return 0;
 }
 
-int searchSort_sortByRelevancy(SearchEngine *engine, char *attribute,
-		char *value, Intersect *intersect, aboolean isStandardOrder)
+int searchSort_partialSortByRelevancy(SearchEngine *engine, char *attribute,
+		char *value, Intersect *intersect, aboolean isStandardOrder,
+		int limit)
 {
 	int ii = 0;
 	int tokenCount = 0;
 	int *tokenLengths = NULL;
+	double *scores = NULL;
 	char *relevancyKey = NULL;
 	char *relevancyLengthKey = NULL;
 	char **tokenList = NULL;
@@ -1094,7 +1428,16 @@ int searchSort_sortByRelevancy(SearchEngine *engine, char *attribute,
 	relevancySort = (RelevancySort *)malloc(sizeof(RelevancySort) *
 			intersect->result.length);
 
+	scores = relevancy_scoreDocValues(engine, indexType, tokenList,
+			tokenCount, intersect->result.array, intersect->result.length);
+
 	for(ii = 0; ii < intersect->result.length; ii++) {
+		if(scores != NULL) {
+			relevancySort[ii].uid = intersect->result.array[ii];
+			relevancySort[ii].relevancy = scores[ii];
+			continue;
+		}
+
 		relevancy_buildEntry(engine,
 				tokenList,
 				tokenCount,
@@ -1107,15 +1450,17 @@ int searchSort_sortByRelevancy(SearchEngine *engine, char *attribute,
 	// execute sort
 
 	if(isStandardOrder) {
-		qsort((void *)relevancySort,
+		partialSort((void *)relevancySort,
 				intersect->result.length,
 				(int)sizeof(RelevancySort),
+				limit,
 				relevancy_compareDescending);
 	}
 	else {
-		qsort((void *)relevancySort,
+		partialSort((void *)relevancySort,
 				intersect->result.length,
 				(int)sizeof(RelevancySort),
+				limit,
 				relevancy_compareAscending);
 	}
 
@@ -1147,11 +1492,16 @@ int searchSort_sortByRelevancy(SearchEngine *engine, char *attribute,
 
 	free(relevancySort);
 
+	if(scores != NULL) {
+		free(scores);
+	}
+
 	return 0;
 }
 
-int searchSort_sortByDistance(SearchEngine *engine, double latitude,
-		double longitude, Intersect *intersect, aboolean isStandardOrder)
+int searchSort_partialSortByDistance(SearchEngine *engine, double latitude,
+		double longitude, Intersect *intersect, aboolean isStandardOrder,
+		int limit)
 {
 	int ii = 0;
 	double dValueOne = 0.0;
@@ -1193,15 +1543,17 @@ int searchSort_sortByDistance(SearchEngine *engine, double latitude,
 	// execute sort
 
 	if(isStandardOrder) {
-		qsort((void *)distanceSort,
+		partialSort((void *)distanceSort,
 				intersect->result.length,
 				(int)sizeof(DistanceSort),
+				limit,
 				distance_compareDescending);
 	}
 	else {
-		qsort((void *)distanceSort,
+		partialSort((void *)distanceSort,
 				intersect->result.length,
 				(int)sizeof(DistanceSort),
+				limit,
 				distance_compareAscending);
 	}
 
@@ -1234,6 +1586,7 @@ int searchSort_mvInit(SearchSort *sort, SearchEngine *engine,
 	memset(sort, 0, (int)(sizeof(SearchSort)));
 
 	sort->length = 0;
+	sort->limit = 0;
 	sort->configLength = 0;
 	sort->config = NULL;
 	sort->entries = NULL;
@@ -1304,12 +1657,27 @@ int searchSort_mvFree(SearchSort *sort)
 	return 0;
 }
 
+int searchSort_mvSetLimit(SearchSort *sort, int limit)
+{
+	if((sort == NULL) || (limit < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	sort->limit = limit;
+
+	return 0;
+}
+
 int searchSort_mvAddSortByAttributeName(SearchSort *sort, char *attribute,
 		aboolean isStandardOrder)
 {
 	int ii = 0;
 	int id = 0;
+	int *uids = NULL;
+	int *ranks = NULL;
 
+	DocValues *docValues = NULL;
 	AttributeSort *sortItem = NULL;
 
 	if((sort == NULL) || (attribute == NULL)) {
@@ -1321,6 +1689,19 @@ int searchSort_mvAddSortByAttributeName(SearchSort *sort, char *attribute,
 		return 0; // nothing to sort
 	}
 
+	if((docValues = attribute_getDocValues(sort->engine,
+					attribute)) != NULL) {
+		uids = (int *)malloc(sizeof(int) * sort->length);
+
+		for(ii = 0; ii < sort->length; ii++) {
+			uids[ii] = sort->entries[ii].uid;
+		}
+
+		ranks = attribute_rankDocValues(docValues, uids, sort->length);
+
+		free(uids);
+	}
+
 	if(sort->config == NULL) {
 		id = 0;
 		sort->configLength = 1;
@@ -1349,14 +1730,26 @@ int searchSort_mvAddSortByAttributeName(SearchSort *sort, char *attribute,
 
 		sortItem = (AttributeSort *)malloc(sizeof(AttributeSort));
 
-		attribute_buildEntry(sort->engine,
-				attribute,
-				sort->entries[ii].uid,
-				sortItem);
+		if(ranks != NULL) {
+			sortItem->uid = sort->entries[ii].uid;
+			sortItem->rank = ranks[ii];
+			sortItem->length = 0;
+			sortItem->value = NULL;
+		}
+		else {
+			attribute_buildEntry(sort->engine,
+					attribute,
+					sort->entries[ii].uid,
+					sortItem);
+		}
 
 		sort->entries[ii].items[id] = (void *)sortItem;
 	}
 
+	if(ranks != NULL) {
+		free(ranks);
+	}
+
 	return 0;
 }
 
@@ -1366,7 +1759,9 @@ int searchSort_mvAddSortByRelevancy(SearchSort *sort, char *attribute,
 	int ii = 0;
 	int id = 0;
 	int tokenCount = 0;
+	int *uids = NULL;
 	int *tokenLengths = NULL;
+	double *scores = NULL;
 	char *relevancyKey = NULL;
 	char *relevancyLengthKey = NULL;
 	char **tokenList = NULL;
@@ -1449,6 +1844,17 @@ int searchSort_mvAddSortByRelevancy(SearchSort *sort, char *attribute,
 	relevancyLengthKey = searchEngineCommon_buildRelevancyLengthKey(
 			indexType->key, indexType->keyLength);
 
+	uids = (int *)malloc(sizeof(int) * sort->length);
+
+	for(ii = 0; ii < sort->length; ii++) {
+		uids[ii] = sort->entries[ii].uid;
+	}
+
+	scores = relevancy_scoreDocValues(sort->engine, indexType, tokenList,
+			tokenCount, uids, sort->length);
+
+	free(uids);
+
 	for(ii = 0; ii < sort->length; ii++) {
 		if(id == 0) {
 			sort->entries[ii].items = (void **)malloc(sizeof(void *) *
@@ -1461,13 +1867,19 @@ int searchSort_mvAddSortByRelevancy(SearchSort *sort, char *attribute,
 
 		relevancyItem = (RelevancySort *)malloc(sizeof(RelevancySort));
 
-		relevancy_buildEntry(sort->engine,
-				tokenList,
-				tokenCount,
-				relevancyKey,
-				relevancyLengthKey,
-				sort->entries[ii].uid,
-				relevancyItem);
+		if(scores != NULL) {
+			relevancyItem->uid = sort->entries[ii].uid;
+			relevancyItem->relevancy = scores[ii];
+		}
+		else {
+			relevancy_buildEntry(sort->engine,
+					tokenList,
+					tokenCount,
+					relevancyKey,
+					relevancyLengthKey,
+					sort->entries[ii].uid,
+					relevancyItem);
+		}
 
 		sort->entries[ii].items[id] = (void *)relevancyItem;
 	}
@@ -1492,6 +1904,10 @@ int searchSort_mvAddSortByRelevancy(SearchSort *sort, char *attribute,
 
 	free(relevancyLengthKey);
 
+	if(scores != NULL) {
+		free(scores);
+	}
+
 	return 0;
 }
 
@@ -1581,9 +1997,10 @@ int searchSort_mvExecute(SearchSort *sort)
 
 	// execute multi-value sort
 
-	qsort((void *)sort->entries,
+	partialSort((void *)sort->entries,
 			sort->length,
 			(int)sizeof(SearchSortEntry),
+			sort->limit,
 			multiValue_compare);
 
 	// assign sort to intersection results
@@ -1602,13 +2019,17 @@ int searchSort_calculateFacets(SearchEngine *engine, Intersect *intersect,
 {
 	int ii = 0;
 	int rc = 0;
+	int valueLength = 0;
 	int resultLength = 0;
 	int attributeLength = 0;
+	int *valueIds = NULL;
 	int *keyLengths = NULL;
 	char **keys = NULL;
 	void **entries = NULL;
 
 	Bptree index;
+	DocValues *docValues = NULL;
+	DocValuesValue *values = NULL;
 	IndexRegistryIndex *indexType = NULL;
 	IndexRegistryIndexSetting settings;
 
@@ -1687,9 +2108,33 @@ int searchSort_calculateFacets(SearchEngine *engine, Intersect *intersect,
 	bptree_init(&index);
 	bptree_setFreeFunction(&index, facet_free);
 
-	for(ii = 0; ii < intersect->result.length; ii++) {
-		facet_updateIndex(engine, &settings, indexType->type, attribute,
-				attributeLength, intersect->result.array[ii], &index);
+	valueLength = -1;
+
+	if((docValues = searchEngine_getDocValues(engine, attribute)) != NULL) {
+		valueIds = (int *)malloc(sizeof(int) * intersect->result.length);
+
+		valueLength = docValues_collect(docValues, intersect->result.array,
+				intersect->result.length, valueIds, &values);
+
+		free(valueIds);
+	}
+
+	if(valueLength >= 0) {
+		// each distinct value is faceted once, weighted by its UID count
+
+		for(ii = 0; ii < valueLength; ii++) {
+			facet_updateIndexValue(engine, &settings, indexType->type,
+					values[ii].value, values[ii].length, values[ii].count,
+					&index);
+		}
+
+		docValues_freeValues(values, valueLength);
+	}
+	else {
+		for(ii = 0; ii < intersect->result.length; ii++) {
+			facet_updateIndex(engine, &settings, indexType->type, attribute,
+					attributeLength, intersect->result.array[ii], &index);
+		}
 	}
 
 	// convert the facets in the index into an array of facets
@@ -1765,6 +2210,13 @@ alint searchSort_calculateMvAddSortByAttributeNameMemoryLength(
 		return result;
 	}
 
+	// entries built from doc values hold a rank rather than a value copy
+
+	if(attribute_getDocValues(sort->engine, attribute) != NULL) {
+		result += ((alint)sort->length * (alint)(sizeof(int) * 3));
+		return result;
+	}
+
 	for(ii = 0; ii < sort->length; ii++) {
 		result += attribute_calculateBuildEntryMemoryLength(sort->engine,
 				attribute,
@@ -1848,6 +2300,7 @@ aboolean searchSort_determineGeoCoordsOnEntity(SearchEngine *engine,
 	int nameLength = 0;
 	int failCounter = 0;
 	int duplicateCounter = 0;
+	int pointLength = 0;
 	int geoCoordListRef = 0;
 	int geoCoordListLength = 0;
 	double localDistance = 0.0;
@@ -1856,6 +2309,7 @@ aboolean searchSort_determineGeoCoordsOnEntity(SearchEngine *engine,
 	char name[128];
 
 	Container *container = NULL;
+	GeoIndexPoint *points = NULL;
 	EntityGeoCoord *geoCoordList = NULL;
 
 	if((engine == NULL) || (uidListId < 0) || (uidList == NULL) ||
@@ -1874,12 +2328,6 @@ aboolean searchSort_determineGeoCoordsOnEntity(SearchEngine *engine,
 
 	uid = uidList[uidListId];
 
-	// obtain container from search engine
-
-	if((container = searchEngine_get(engine, uid, &rc)) == NULL) {
-		return afalse;
-	}
-
 	// scan UID list for duplicates
 
 	if(uidListId > 0) {
@@ -1890,9 +2338,38 @@ aboolean searchSort_determineGeoCoordsOnEntity(SearchEngine *engine,
 		}
 	}
 
+	// obtain the coordinates held by the geo index, if one exists
+
+	if((points = searchEngine_getGeoCoords(engine, uid,
+					&pointLength)) != NULL) {
+		geoCoordListLength = pointLength;
+		geoCoordListRef = (geoCoordListLength - 1);
+		geoCoordList = (EntityGeoCoord *)malloc(sizeof(EntityGeoCoord) *
+				geoCoordListLength);
+
+		for(ii = 0; ii < pointLength; ii++) {
+			geoCoordList[ii].uid = uid;
+			geoCoordList[ii].distance =
+				searchSort_calculateGeoCoordDistanceMiles(latitude,
+						longitude, points[ii].latitude, points[ii].longitude);
+			geoCoordList[ii].latitude = points[ii].latitude;
+			geoCoordList[ii].longitude = points[ii].longitude;
+		}
+
+		free(points);
+	}
+
+	// otherwise, obtain container from search engine
+
+	if((geoCoordList == NULL) &&
+			((container = searchEngine_get(engine, uid, &rc)) == NULL)) {
+		return afalse;
+	}
+
 	// determine if standard latitude/longtitude entries exist
 
-	if((container_exists(container, "latitude", 8)) &&
+	if((container != NULL) &&
+			(container_exists(container, "latitude", 8)) &&
 			(container_exists(container, "longitude", 9))) {
 		localLatitude = container_getDouble(container, "latitude", 8);
 		localLongitude = container_getDouble(container, "longitude", 9);
@@ -1925,7 +2402,9 @@ aboolean searchSort_determineGeoCoordsOnEntity(SearchEngine *engine,
 
 	// check to see if additional long/lat exist
 
-	for(ii = 0, failCounter = 0; ((ii < 1000) && (failCounter < 3)); ii++) {
+	for(ii = 0, failCounter = 0;
+			((container != NULL) && (ii < 1000) && (failCounter < 3));
+			ii++) {
 		nameLength = snprintf(name, ((int)sizeof(name) - 1),
 				"latitude%03i", ii);
 
@@ -1972,7 +2451,9 @@ aboolean searchSort_determineGeoCoordsOnEntity(SearchEngine *engine,
 		geoCoordList[geoCoordListRef].longitude = localLongitude;
 	}
 
-	searchEngine_unlockGet(engine, container);
+	if(container != NULL) {
+		searchEngine_unlockGet(engine, container);
+	}
 
 	// determine if there are any entries in the geocoord list
 
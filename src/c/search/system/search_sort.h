@@ -24,6 +24,13 @@ extern "C" {
 
 // define search sort public constants
 
+/*
+ * A sort given a limit only orders the leading limit entries, when the limit
+ * is small against the number of results; deeper pages are fully sorted.
+ */
+
+#define SEARCH_SORT_PARTIAL_SORT_RATIO					4
+
 typedef enum _SearchSortTypes {
 	SEARCH_SORT_TYPE_ATTRIBUTE = 1,
 	SEARCH_SORT_TYPE_RELEVANCY,
@@ -52,6 +59,7 @@ typedef struct _SearchSortConfig {
 
 typedef struct _SearchSort {
 	int length;
+	int limit;
 	int configLength;
 	SearchSortConfig *config;
 	SearchSortEntry *entries;
@@ -73,6 +81,18 @@ int searchSort_sortByRelevancy(SearchEngine *engine, char *attribute,
 int searchSort_sortByDistance(SearchEngine *engine, double latitude,
 		double longitude, Intersect *intersect, aboolean isStandardOrder);
 
+int searchSort_partialSortByAttributeName(SearchEngine *engine,
+		char *attribute, Intersect *intersect, aboolean isStandardOrder,
+		int limit);
+
+int searchSort_partialSortByRelevancy(SearchEngine *engine, char *attribute,
+		char *value, Intersect *intersect, aboolean isStandardOrder,
+		int limit);
+
+int searchSort_partialSortByDistance(SearchEngine *engine, double latitude,
+		double longitude, Intersect *intersect, aboolean isStandardOrder,
+		int limit);
+
 // multi-value sort functions
 
 int searchSort_mvInit(SearchSort *sort, SearchEngine *engine,
@@ -80,6 +100,8 @@ int searchSort_mvInit(SearchSort *sort, SearchEngine *engine,
 
 int searchSort_mvFree(SearchSort *sort);
 
+int searchSort_mvSetLimit(SearchSort *sort, int limit);
+
 int searchSort_mvAddSortByAttributeName(SearchSort *sort, char *attribute,
 		aboolean isStandardOrder);
 
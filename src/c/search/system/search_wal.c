@@ -0,0 +1,1183 @@
+/*
+ * search_wal.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The write-ahead log component for the search-engine, an append-only log of
+ * container operations with group commit, and the incremental checkpoint
+ * segments which replace it.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+
+#include "core/core.h"
+#include "search/search.h"
+#define _SEARCH_SYSTEM_COMPONENT
+#include "search/system/search_wal.h"
+
+
+// define search wal private constants
+
+#define SEARCH_WAL_COMMIT_WAIT_MICROS					32
+
+#define SEARCH_WAL_DEFAULT_DIRTY_UID_LENGTH				1024
+
+#define SEARCH_WAL_RECORD_HEADER_LENGTH					(SIZEOF_INT * 4)
+
+
+// declare search wal private functions
+
+static char *buildFilename(SearchWal *wal, int generation, char *extension);
+
+static void encodeRecord(char *record, SearchWalRecordTypes type, int uid,
+		char *payload, int payloadLength);
+
+static int openGeneration(SearchWal *wal);
+
+static int listGenerations(SearchWal *wal, int **generations);
+
+static int compareGenerations(const void *left, const void *right);
+
+static int readFile(SearchWal *wal, char *filename, int magicNumber,
+		SearchWalReplayFunction function, void *context);
+
+
+// define search wal private functions
+
+static char *buildFilename(SearchWal *wal, int generation, char *extension)
+{
+	int length = 0;
+	char *result = NULL;
+
+	length = (strlen(wal->path) + strlen(extension) + 32);
+
+	result = (char *)malloc(sizeof(char) * (length + 1));
+
+	snprintf(result, length, "%s/searchd.%08i.%s", wal->path, generation,
+			extension);
+
+	return result;
+}
+
+static void encodeRecord(char *record, SearchWalRecordTypes type, int uid,
+		char *payload, int payloadLength)
+{
+	serialize_encodeInt(payloadLength, (record + SIZEOF_INT));
+	serialize_encodeInt((int)type, (record + (SIZEOF_INT * 2)));
+	serialize_encodeInt(uid, (record + (SIZEOF_INT * 3)));
+
+	if(payloadLength > 0) {
+		memcpy((record + SEARCH_WAL_RECORD_HEADER_LENGTH), payload,
+				payloadLength);
+	}
+
+	// the record hash covers everything after itself
+
+	serialize_encodeInt((int)crc32_calculateHash((record + SIZEOF_INT),
+				(SEARCH_WAL_RECORD_HEADER_LENGTH - SIZEOF_INT +
+				 payloadLength)), record);
+}
+
+static int openGeneration(SearchWal *wal)
+{
+	char *filename = NULL;
+
+	filename = buildFilename(wal, wal->generation, "wal");
+
+	if(file_init(&wal->fh, filename, "wb", 0) < 0) {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to open write-ahead log file '%s'", filename);
+		file_free(&wal->fh);
+		free(filename);
+		wal->isOpen = afalse;
+		return -1;
+	}
+
+	file_writeInt(&wal->fh, SEARCH_WAL_FILE_MAGIC_NUMBER);
+	file_writeInt(&wal->fh, wal->generation);
+
+	searchWal_syncFileHandle(&wal->fh);
+
+	log_logf(wal->log, LOG_LEVEL_DEBUG,
+			"opened write-ahead log file '%s'", filename);
+
+	free(filename);
+
+	wal->isOpen = atrue;
+
+	return 0;
+}
+
+static int listGenerations(SearchWal *wal, int **generations)
+{
+	aboolean exists = afalse;
+	int ii = 0;
+	int generation = 0;
+	int resultRef = 0;
+	int resultLength = 0;
+	int *result = NULL;
+	char *filename = NULL;
+	char extension[32];
+
+	DirHandle dir;
+
+	*generations = NULL;
+
+	if((system_dirExists(wal->path, &exists) < 0) || (!exists)) {
+		return 0;
+	}
+
+	if(dir_init(&dir, wal->path) < 0) {
+		dir_free(&dir);
+		return 0;
+	}
+
+	resultRef = 0;
+	resultLength = 8;
+	result = (int *)malloc(sizeof(int) * resultLength);
+
+	while(dir_read(&dir, &filename) == 0) {
+		memset(extension, 0, (int)(sizeof(extension)));
+
+		if((sscanf(filename, "searchd.%d.%15s", &generation,
+							extension) == 2) &&
+				(generation > 0) &&
+				((!strcmp(extension, "wal")) ||
+				 (!strcmp(extension, "segment")))) {
+			if(resultRef >= resultLength) {
+				resultLength *= 2;
+				result = (int *)realloc(result,
+						(sizeof(int) * resultLength));
+			}
+
+			result[resultRef] = generation;
+			resultRef++;
+		}
+
+		free(filename);
+	}
+
+	dir_free(&dir);
+
+	if(resultRef < 1) {
+		free(result);
+		return 0;
+	}
+
+	// sort & remove the duplicates of generations with both file types
+
+	qsort(result, resultRef, sizeof(int), compareGenerations);
+
+	for(ii = 1, resultLength = 1; ii < resultRef; ii++) {
+		if(result[ii] != result[(resultLength - 1)]) {
+			result[resultLength] = result[ii];
+			resultLength++;
+		}
+	}
+
+	*generations = result;
+
+	return resultLength;
+}
+
+static int compareGenerations(const void *left, const void *right)
+{
+	return (*((int *)left) - *((int *)right));
+}
+
+static int readFile(SearchWal *wal, char *filename, int magicNumber,
+		SearchWalReplayFunction function, void *context)
+{
+	aboolean isComplete = afalse;
+	int type = 0;
+	int uid = 0;
+	int hash = 0;
+	int iValue = 0;
+	int counter = 0;
+	int recordLength = 0;
+	int bufferLength = 0;
+	alint fileLength = 0;
+	char *buffer = NULL;
+
+	FileHandle fh;
+
+	if(system_fileLength(filename, &fileLength) < 0) {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to determine length of write-ahead log file '%s'",
+				filename);
+		return -1;
+	}
+
+	if(file_init(&fh, filename, "rb", 0) < 0) {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to open write-ahead log file '%s'", filename);
+		file_free(&fh);
+		return -1;
+	}
+
+	if((file_readInt(&fh, &iValue) != 0) || (iValue != magicNumber) ||
+			(file_readInt(&fh, &iValue) != 0)) {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"detected prefix magic number mismatch in write-ahead log "
+				"file '%s'", filename);
+		file_free(&fh);
+		return -1;
+	}
+
+	bufferLength = 1024;
+	buffer = (char *)malloc(sizeof(char) * (bufferLength + 1));
+
+	// a log ends at the first torn or corrupt record, a segment at its
+	// trailing magic number
+
+	while(atrue) {
+		if(file_readInt(&fh, &hash) != 0) {
+			break;
+		}
+
+		if((magicNumber == SEARCH_WAL_SEGMENT_FILE_MAGIC_NUMBER) &&
+				(hash == SEARCH_WAL_SEGMENT_FILE_MAGIC_NUMBER)) {
+			isComplete = atrue;
+			break;
+		}
+
+		if((file_readInt(&fh, &recordLength) != 0) || (recordLength < 0) ||
+				((alint)(recordLength + (SIZEOF_INT * 2)) >
+				 (fileLength - fh.position))) {
+			break;
+		}
+
+		if((recordLength + (SIZEOF_INT * 3)) >= bufferLength) {
+			do {
+				bufferLength *= 2;
+			} while((recordLength + (SIZEOF_INT * 3)) >= bufferLength);
+
+			buffer = (char *)realloc(buffer,
+					(sizeof(char) * (bufferLength + 1)));
+		}
+
+		serialize_encodeInt(recordLength, buffer);
+
+		if(file_read(&fh, (buffer + SIZEOF_INT),
+					(recordLength + (SIZEOF_INT * 2))) !=
+				(recordLength + (SIZEOF_INT * 2))) {
+			break;
+		}
+
+		if((int)crc32_calculateHash(buffer,
+					(recordLength + (SIZEOF_INT * 3))) != hash) {
+			log_logf(wal->log, LOG_LEVEL_WARNING,
+					"detected hash mismatch in write-ahead log file '%s' "
+					"after %i records", filename, counter);
+			break;
+		}
+
+		serialize_decodeInt((buffer + SIZEOF_INT), SIZEOF_INT, &type);
+		serialize_decodeInt((buffer + (SIZEOF_INT * 2)), SIZEOF_INT, &uid);
+
+		if(function(context, (SearchWalRecordTypes)type, uid,
+					(buffer + (SIZEOF_INT * 3)), recordLength) < 0) {
+			break;
+		}
+
+		counter++;
+	}
+
+	file_free(&fh);
+
+	free(buffer);
+
+	if((magicNumber == SEARCH_WAL_SEGMENT_FILE_MAGIC_NUMBER) &&
+			(!isComplete)) {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to read complete checkpoint segment file '%s'",
+				filename);
+		return -1;
+	}
+
+	return counter;
+}
+
+
+// define search wal public functions
+
+int searchWal_init(SearchWal *wal, Log *log)
+{
+	if((wal == NULL) || (log == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	memset(wal, 0, (int)(sizeof(SearchWal)));
+
+	wal->isOpen = afalse;
+	wal->isCommitting = afalse;
+	wal->isFailed = afalse;
+	wal->syncType = SEARCH_WAL_DEFAULT_SYNC_TYPE;
+	wal->generation = 0;
+	wal->bufferRef = 0;
+	wal->bufferLength = SEARCH_WAL_DEFAULT_BUFFER_LENGTH;
+	wal->spareLength = SEARCH_WAL_DEFAULT_BUFFER_LENGTH;
+	wal->dirtyUidRef = 0;
+	wal->dirtyUidLength = SEARCH_WAL_DEFAULT_DIRTY_UID_LENGTH;
+	wal->dirtyUids = (int *)malloc(sizeof(int) * wal->dirtyUidLength);
+	wal->appendTicket = 0;
+	wal->commitTicket = 0;
+	wal->syncTicket = 0;
+	wal->recordsWritten = 0;
+	wal->commitsWritten = 0;
+	wal->syncsWritten = 0;
+	wal->syncIntervalSeconds = SEARCH_WAL_DEFAULT_SYNC_INTERVAL_SECONDS;
+	wal->lastSyncTime = time_getTimeMus();
+	wal->path = NULL;
+	wal->buffer = (char *)malloc(sizeof(char) * wal->bufferLength);
+	wal->spare = (char *)malloc(sizeof(char) * wal->spareLength);
+	wal->log = log;
+
+	mutex_init(&wal->mutex);
+
+	return 0;
+}
+
+int searchWal_free(SearchWal *wal)
+{
+	if(wal == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(wal->isOpen) {
+		searchWal_close(wal);
+	}
+
+	if(wal->dirtyUids != NULL) {
+		free(wal->dirtyUids);
+	}
+
+	if(wal->path != NULL) {
+		free(wal->path);
+	}
+
+	if(wal->buffer != NULL) {
+		free(wal->buffer);
+	}
+
+	if(wal->spare != NULL) {
+		free(wal->spare);
+	}
+
+	mutex_free(&wal->mutex);
+
+	memset(wal, 0, (int)(sizeof(SearchWal)));
+
+	return 0;
+}
+
+char *searchWal_syncTypeToString(SearchWalSyncTypes type)
+{
+	char *result = "unknown";
+
+	switch(type) {
+		case SEARCH_WAL_SYNC_TYPE_NONE:
+			result = "none";
+			break;
+
+		case SEARCH_WAL_SYNC_TYPE_INTERVAL:
+			result = "interval";
+			break;
+
+		case SEARCH_WAL_SYNC_TYPE_ALWAYS:
+			result = "always";
+			break;
+
+		case SEARCH_WAL_SYNC_TYPE_UNKNOWN:
+		default:
+			result = "unknown";
+	}
+
+	return result;
+}
+
+SearchWalSyncTypes searchWal_stringToSyncType(char *string)
+{
+	SearchWalSyncTypes result = SEARCH_WAL_SYNC_TYPE_UNKNOWN;
+
+	if(string == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return SEARCH_WAL_SYNC_TYPE_UNKNOWN;
+	}
+
+	if(!strcasecmp(string, "none")) {
+		result = SEARCH_WAL_SYNC_TYPE_NONE;
+	}
+	else if(!strcasecmp(string, "interval")) {
+		result = SEARCH_WAL_SYNC_TYPE_INTERVAL;
+	}
+	else if(!strcasecmp(string, "always")) {
+		result = SEARCH_WAL_SYNC_TYPE_ALWAYS;
+	}
+
+	return result;
+}
+
+int searchWal_setSyncType(SearchWal *wal, SearchWalSyncTypes syncType,
+		double syncIntervalSeconds)
+{
+	if((wal == NULL) ||
+			((syncType != SEARCH_WAL_SYNC_TYPE_NONE) &&
+			 (syncType != SEARCH_WAL_SYNC_TYPE_INTERVAL) &&
+			 (syncType != SEARCH_WAL_SYNC_TYPE_ALWAYS)) ||
+			(syncIntervalSeconds < 0.0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	wal->syncType = syncType;
+	wal->syncIntervalSeconds = syncIntervalSeconds;
+
+	mutex_unlock(&wal->mutex);
+
+	return 0;
+}
+
+aboolean searchWal_isOpen(SearchWal *wal)
+{
+	aboolean result = afalse;
+
+	if(wal == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	result = wal->isOpen;
+
+	mutex_unlock(&wal->mutex);
+
+	return result;
+}
+
+aboolean searchWal_isDirty(SearchWal *wal)
+{
+	aboolean result = afalse;
+
+	if(wal == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return afalse;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	result = (aboolean)(wal->dirtyUidRef > 0);
+
+	mutex_unlock(&wal->mutex);
+
+	return result;
+}
+
+int searchWal_open(SearchWal *wal, char *path)
+{
+	int generationLength = 0;
+	int *generations = NULL;
+
+	if((wal == NULL) || (path == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	if(wal->isOpen) {
+		mutex_unlock(&wal->mutex);
+		return -1;
+	}
+
+	if(wal->path != NULL) {
+		free(wal->path);
+	}
+
+	wal->path = strdup(path);
+
+	// always start a new generation, after any left on disk for replay
+
+	if((generationLength = listGenerations(wal, &generations)) > 0) {
+		wal->generation = generations[(generationLength - 1)];
+		free(generations);
+	}
+
+	wal->generation += 1;
+
+	if(openGeneration(wal) < 0) {
+		mutex_unlock(&wal->mutex);
+		return -1;
+	}
+
+	wal->isFailed = afalse;
+	wal->lastSyncTime = time_getTimeMus();
+
+	mutex_unlock(&wal->mutex);
+
+	return 0;
+}
+
+int searchWal_close(SearchWal *wal)
+{
+	int result = 0;
+
+	if(wal == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(searchWal_commit(wal, 0, atrue) < 0) {
+		result = -1;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	// a failed log is closed regardless, since it can never commit again
+
+	if((result < 0) && (!wal->isFailed)) {
+		mutex_unlock(&wal->mutex);
+		return -1;
+	}
+
+	// the handle of a generation which failed to open is already freed
+
+	if(wal->isOpen) {
+		if(wal->fh.fd != NULL) {
+			file_free(&wal->fh);
+		}
+		wal->isOpen = afalse;
+	}
+
+	mutex_unlock(&wal->mutex);
+
+	return result;
+}
+
+int searchWal_append(SearchWal *wal, SearchWalRecordTypes type, int uid,
+		char *payload, int payloadLength, alint *ticket)
+{
+	int length = 0;
+	char *record = NULL;
+
+	if((wal == NULL) ||
+			((type != SEARCH_WAL_RECORD_TYPE_PUT) &&
+			 (type != SEARCH_WAL_RECORD_TYPE_UPDATE) &&
+			 (type != SEARCH_WAL_RECORD_TYPE_DELETE)) ||
+			(uid < 1) ||
+			((payload == NULL) && (payloadLength > 0)) ||
+			(payloadLength < 0) || (ticket == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	length = (SEARCH_WAL_RECORD_HEADER_LENGTH + payloadLength);
+
+	mutex_lock(&wal->mutex);
+
+	if((!wal->isOpen) || (wal->isFailed)) {
+		mutex_unlock(&wal->mutex);
+		return -1;
+	}
+
+	if((wal->bufferRef + length) > wal->bufferLength) {
+		do {
+			wal->bufferLength *= 2;
+		} while((wal->bufferRef + length) > wal->bufferLength);
+
+		wal->buffer = (char *)realloc(wal->buffer,
+				(sizeof(char) * wal->bufferLength));
+	}
+
+	record = (wal->buffer + wal->bufferRef);
+
+	encodeRecord(record, type, uid, payload, payloadLength);
+
+	wal->bufferRef += length;
+
+	// track the container as dirty for the next checkpoint
+
+	if(wal->dirtyUidRef >= wal->dirtyUidLength) {
+		wal->dirtyUidLength *= 2;
+		wal->dirtyUids = (int *)realloc(wal->dirtyUids,
+				(sizeof(int) * wal->dirtyUidLength));
+	}
+
+	wal->dirtyUids[wal->dirtyUidRef] = uid;
+	wal->dirtyUidRef++;
+
+	wal->appendTicket += 1;
+
+	*ticket = wal->appendTicket;
+
+	mutex_unlock(&wal->mutex);
+
+	return 0;
+}
+
+int searchWal_commit(SearchWal *wal, alint ticket, aboolean isSync)
+{
+	int result = 0;
+	int length = 0;
+	int capacity = 0;
+	alint target = 0;
+	char *data = NULL;
+
+	if(wal == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	if(ticket < 1) {
+		ticket = wal->appendTicket;
+	}
+
+	// wait for any commit in progress, which may carry this ticket with it
+
+	while(wal->isCommitting) {
+		mutex_unlock(&wal->mutex);
+		time_usleep(SEARCH_WAL_COMMIT_WAIT_MICROS);
+		mutex_lock(&wal->mutex);
+	}
+
+	if(!wal->isOpen) {
+		mutex_unlock(&wal->mutex);
+		return 0;
+	}
+
+	if((wal->commitTicket >= ticket) &&
+			((!isSync) || (wal->syncTicket >= ticket))) {
+		mutex_unlock(&wal->mutex);
+		return 0;
+	}
+
+	// the ticket may have been taken by a commit which failed, and its record
+	// may never reach the log
+
+	if(wal->isFailed) {
+		mutex_unlock(&wal->mutex);
+		return -1;
+	}
+
+	// take every pending record, leaving the spare buffer for appenders
+
+	wal->isCommitting = atrue;
+
+	data = wal->buffer;
+	length = wal->bufferRef;
+	capacity = wal->bufferLength;
+	target = wal->appendTicket;
+
+	wal->buffer = wal->spare;
+	wal->bufferLength = wal->spareLength;
+	wal->bufferRef = 0;
+	wal->spare = NULL;
+	wal->spareLength = 0;
+
+	mutex_unlock(&wal->mutex);
+
+	if(length > 0) {
+		if(file_write(&wal->fh, data, length) < 0) {
+			log_logf(wal->log, LOG_LEVEL_ERROR,
+					"failed to write %i bytes to write-ahead log", length);
+			result = -1;
+		}
+	}
+
+	if(result == 0) {
+		if(isSync) {
+			result = searchWal_syncFileHandle(&wal->fh);
+		}
+		else if(fflush(wal->fh.fd) != 0) {
+			result = -1;
+		}
+	}
+
+	mutex_lock(&wal->mutex);
+
+	wal->spare = data;
+	wal->spareLength = capacity;
+
+	if(result == 0) {
+		wal->recordsWritten += (target - wal->commitTicket);
+		wal->commitsWritten += 1;
+		wal->commitTicket = target;
+
+		if(isSync) {
+			wal->syncsWritten += 1;
+			wal->syncTicket = target;
+			wal->lastSyncTime = time_getTimeMus();
+		}
+	}
+	else {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to commit write-ahead log generation %i, "
+				"refusing further records", wal->generation);
+
+		wal->isFailed = atrue;
+	}
+
+	wal->isCommitting = afalse;
+
+	mutex_unlock(&wal->mutex);
+
+	return result;
+}
+
+int searchWal_sync(SearchWal *wal, alint ticket)
+{
+	aboolean isAlways = afalse;
+
+	if(wal == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	isAlways = (aboolean)(wal->syncType == SEARCH_WAL_SYNC_TYPE_ALWAYS);
+
+	mutex_unlock(&wal->mutex);
+
+	if(!isAlways) {
+		return 0;
+	}
+
+	return searchWal_commit(wal, ticket, atrue);
+}
+
+int searchWal_flush(SearchWal *wal)
+{
+	aboolean isSync = afalse;
+
+	if(wal == NULL) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	mutex_lock(&wal->mutex);
+
+	if(!wal->isOpen) {
+		mutex_unlock(&wal->mutex);
+		return 0;
+	}
+
+	if(wal->syncType == SEARCH_WAL_SYNC_TYPE_ALWAYS) {
+		isSync = atrue;
+	}
+	else if((wal->syncType == SEARCH_WAL_SYNC_TYPE_INTERVAL) &&
+			(wal->syncTicket < wal->appendTicket) &&
+			(time_getElapsedMusInSeconds(wal->lastSyncTime) >=
+			 wal->syncIntervalSeconds)) {
+		isSync = atrue;
+	}
+
+	if((wal->commitTicket >= wal->appendTicket) &&
+			((!isSync) || (wal->syncTicket >= wal->appendTicket))) {
+		mutex_unlock(&wal->mutex);
+		return 0;
+	}
+
+	mutex_unlock(&wal->mutex);
+
+	return searchWal_commit(wal, 0, isSync);
+}
+
+int *searchWal_rotate(SearchWal *wal, int *generation, int *uidLength)
+{
+	int ii = 0;
+	int rc = 0;
+	int length = 0;
+	int *result = NULL;
+
+	if((wal == NULL) || (generation == NULL) || (uidLength == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return NULL;
+	}
+
+	*generation = 0;
+	*uidLength = 0;
+
+	mutex_lock(&wal->mutex);
+
+	while(wal->isCommitting) {
+		mutex_unlock(&wal->mutex);
+		time_usleep(SEARCH_WAL_COMMIT_WAIT_MICROS);
+		mutex_lock(&wal->mutex);
+	}
+
+	if(!wal->isOpen) {
+		mutex_unlock(&wal->mutex);
+		return NULL;
+	}
+
+	// a failed log is never checkpointed, since the records of a failed
+	// commit may never have reached it
+
+	if(wal->isFailed) {
+		mutex_unlock(&wal->mutex);
+		return NULL;
+	}
+
+	// close out the current generation, durable before it is checkpointed
+
+	if(wal->bufferRef > 0) {
+		if(file_write(&wal->fh, wal->buffer, wal->bufferRef) < 0) {
+			log_logf(wal->log, LOG_LEVEL_ERROR,
+					"failed to write %i bytes to write-ahead log",
+					wal->bufferRef);
+			rc = -1;
+		}
+	}
+
+	if((rc == 0) && (searchWal_syncFileHandle(&wal->fh) < 0)) {
+		rc = -1;
+	}
+
+	if(rc < 0) {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to close out write-ahead log generation %i, "
+				"refusing further records", wal->generation);
+
+		wal->isFailed = atrue;
+
+		mutex_unlock(&wal->mutex);
+		return NULL;
+	}
+
+	wal->recordsWritten += (wal->appendTicket - wal->commitTicket);
+	wal->bufferRef = 0;
+
+	file_free(&wal->fh);
+
+	wal->commitTicket = wal->appendTicket;
+	wal->syncTicket = wal->appendTicket;
+	wal->lastSyncTime = time_getTimeMus();
+
+	*generation = wal->generation;
+
+	// hand the dirty containers to the caller
+
+	result = wal->dirtyUids;
+	length = wal->dirtyUidRef;
+
+	wal->dirtyUidRef = 0;
+	wal->dirtyUidLength = SEARCH_WAL_DEFAULT_DIRTY_UID_LENGTH;
+	wal->dirtyUids = (int *)malloc(sizeof(int) * wal->dirtyUidLength);
+
+	wal->generation += 1;
+
+	// the closed generation is durable for replay, but without a new one the
+	// log stays open as failed, so that writes are refused rather than
+	// acknowledged without a record
+
+	if(openGeneration(wal) < 0) {
+		wal->isOpen = atrue;
+		wal->isFailed = atrue;
+
+		mutex_unlock(&wal->mutex);
+
+		free(result);
+
+		return NULL;
+	}
+
+	mutex_unlock(&wal->mutex);
+
+	// sort & remove duplicate UIDs
+
+	if(length > 1) {
+		qsort(result, length, sizeof(int), compareGenerations);
+
+		for(ii = 1, *uidLength = 1; ii < length; ii++) {
+			if(result[ii] != result[(*uidLength - 1)]) {
+				result[*uidLength] = result[ii];
+				*uidLength += 1;
+			}
+		}
+	}
+	else {
+		*uidLength = length;
+	}
+
+	return result;
+}
+
+int searchWal_writeSegmentBegin(SearchWal *wal, int generation,
+		FileHandle *fh)
+{
+	char *filename = NULL;
+
+	if((wal == NULL) || (wal->path == NULL) || (generation < 1) ||
+			(fh == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	filename = buildFilename(wal, generation, "segment.temp");
+
+	if(file_init(fh, filename, "wb", 0) < 0) {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to open checkpoint segment file '%s'", filename);
+		file_free(fh);
+		free(filename);
+		return -1;
+	}
+
+	free(filename);
+
+	file_writeInt(fh, SEARCH_WAL_SEGMENT_FILE_MAGIC_NUMBER);
+	file_writeInt(fh, generation);
+
+	return 0;
+}
+
+int searchWal_writeSegmentRecord(FileHandle *fh, SearchWalRecordTypes type,
+		int uid, char *payload, int payloadLength)
+{
+	int result = 0;
+	int length = 0;
+	char *record = NULL;
+
+	if((fh == NULL) ||
+			((type != SEARCH_WAL_RECORD_TYPE_PUT) &&
+			 (type != SEARCH_WAL_RECORD_TYPE_UPDATE) &&
+			 (type != SEARCH_WAL_RECORD_TYPE_DELETE)) ||
+			(uid < 1) ||
+			((payload == NULL) && (payloadLength > 0)) ||
+			(payloadLength < 0)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	length = (SEARCH_WAL_RECORD_HEADER_LENGTH + payloadLength);
+
+	record = (char *)malloc(sizeof(char) * length);
+
+	encodeRecord(record, type, uid, payload, payloadLength);
+
+	if(file_write(fh, record, length) < 0) {
+		result = -1;
+	}
+	else {
+		result = length;
+	}
+
+	free(record);
+
+	return result;
+}
+
+int searchWal_writeSegmentEnd(SearchWal *wal, int generation,
+		FileHandle *fh)
+{
+	aboolean exists = afalse;
+	int result = 0;
+	char *filename = NULL;
+	char *tempFilename = NULL;
+
+	if((wal == NULL) || (wal->path == NULL) || (generation < 1) ||
+			(fh == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	file_writeInt(fh, SEARCH_WAL_SEGMENT_FILE_MAGIC_NUMBER);
+
+	if(searchWal_syncFileHandle(fh) < 0) {
+		result = -1;
+	}
+
+	file_free(fh);
+
+	tempFilename = buildFilename(wal, generation, "segment.temp");
+	filename = buildFilename(wal, generation, "segment");
+
+	// the segment replaces the generation's log only once it is complete
+
+	if(result == 0) {
+		if((system_fileExists(filename, &exists) == 0) && (exists)) {
+			system_fileDelete(filename);
+		}
+
+		if(system_fileMove(tempFilename, filename) < 0) {
+			result = -1;
+		}
+	}
+	else {
+		system_fileDelete(tempFilename);
+	}
+
+	free(tempFilename);
+	free(filename);
+
+	if(result == 0) {
+		filename = buildFilename(wal, generation, "wal");
+
+		if((system_fileExists(filename, &exists) == 0) && (exists)) {
+			system_fileDelete(filename);
+		}
+
+		free(filename);
+	}
+	else {
+		log_logf(wal->log, LOG_LEVEL_ERROR,
+				"failed to write checkpoint segment for generation %i",
+				generation);
+	}
+
+	return result;
+}
+
+int searchWal_removeGenerations(SearchWal *wal, int generation)
+{
+	aboolean exists = afalse;
+	int ii = 0;
+	int counter = 0;
+	int generationLength = 0;
+	int *generations = NULL;
+	char *filename = NULL;
+
+	if((wal == NULL) || (wal->path == NULL) || (generation < 1)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	generationLength = listGenerations(wal, &generations);
+
+	for(ii = 0; ii < generationLength; ii++) {
+		if((generations[ii] > generation) ||
+				(generations[ii] >= wal->generation)) {
+			break;
+		}
+
+		filename = buildFilename(wal, generations[ii], "segment");
+
+		if((system_fileExists(filename, &exists) == 0) && (exists)) {
+			system_fileDelete(filename);
+		}
+
+		free(filename);
+
+		filename = buildFilename(wal, generations[ii], "wal");
+
+		if((system_fileExists(filename, &exists) == 0) && (exists)) {
+			system_fileDelete(filename);
+		}
+
+		free(filename);
+
+		counter++;
+	}
+
+	if(generations != NULL) {
+		free(generations);
+	}
+
+	return counter;
+}
+
+int searchWal_replay(SearchWal *wal, int generation,
+		SearchWalReplayFunction function, void *context)
+{
+	aboolean exists = afalse;
+	int ii = 0;
+	int rc = 0;
+	int result = 0;
+	int generationLength = 0;
+	int *generations = NULL;
+	char *filename = NULL;
+
+	if((wal == NULL) || (wal->path == NULL) || (generation < 0) ||
+			(function == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	generationLength = listGenerations(wal, &generations);
+
+	// replay each generation after the snapshot in order, from its
+	// checkpoint segment when one was completed, or else from its log
+
+	for(ii = 0; ii < generationLength; ii++) {
+		if((generations[ii] <= generation) ||
+				((wal->isOpen) && (generations[ii] >= wal->generation))) {
+			continue;
+		}
+
+		filename = buildFilename(wal, generations[ii], "segment");
+
+		if((system_fileExists(filename, &exists) == 0) && (exists)) {
+			rc = readFile(wal, filename, SEARCH_WAL_SEGMENT_FILE_MAGIC_NUMBER,
+					function, context);
+		}
+		else {
+			free(filename);
+
+			filename = buildFilename(wal, generations[ii], "wal");
+
+			rc = readFile(wal, filename, SEARCH_WAL_FILE_MAGIC_NUMBER,
+					function, context);
+		}
+
+		if(rc < 0) {
+			log_logf(wal->log, LOG_LEVEL_ERROR,
+					"failed to replay write-ahead log generation %i from '%s'",
+					generations[ii], filename);
+			free(filename);
+			result = -1;
+			break;
+		}
+
+		log_logf(wal->log, LOG_LEVEL_INFO,
+				"replayed %i records from write-ahead log file '%s'",
+				rc, filename);
+
+		free(filename);
+
+		result += rc;
+	}
+
+	if(generations != NULL) {
+		free(generations);
+	}
+
+	return result;
+}
+
+int searchWal_syncFileHandle(FileHandle *fh)
+{
+	if((fh == NULL) || (fh->fd == NULL)) {
+		DISPLAY_INVALID_ARGS;
+		return -1;
+	}
+
+	if(fflush(fh->fd) != 0) {
+		return -1;
+	}
+
+#if defined(WIN32)
+	if(_commit(_fileno(fh->fd)) != 0) {
+		return -1;
+	}
+#else // !WIN32
+	if(fsync(fileno(fh->fd)) != 0) {
+		return -1;
+	}
+#endif // WIN32
+
+	return 0;
+}
+
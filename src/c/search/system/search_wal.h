@@ -0,0 +1,163 @@
+/*
+ * search_wal.h
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The write-ahead log component for the search-engine, an append-only log of
+ * container operations with group commit, and the incremental checkpoint
+ * segments which replace it, header file.
+ *
+ * Written by Josh English.
+ */
+
+#if !defined(_SEARCH_SYSTEM_SEARCH_WAL_H)
+
+#define _SEARCH_SYSTEM_SEARCH_WAL_H
+
+#if !defined(_SEARCH_H) && !defined(_SEARCH_SYSTEM_COMPONENT)
+#	error "Incorrect use of this header file."
+#endif // _SEARCH_H || _SEARCH_SYSTEM_COMPONENT
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+
+// define search wal public constants
+
+typedef enum _SearchWalSyncTypes {
+	SEARCH_WAL_SYNC_TYPE_NONE = 1,
+	SEARCH_WAL_SYNC_TYPE_INTERVAL,
+	SEARCH_WAL_SYNC_TYPE_ALWAYS,
+	SEARCH_WAL_SYNC_TYPE_UNKNOWN = -1
+} SearchWalSyncTypes;
+
+typedef enum _SearchWalRecordTypes {
+	SEARCH_WAL_RECORD_TYPE_PUT = 1,
+	SEARCH_WAL_RECORD_TYPE_UPDATE,
+	SEARCH_WAL_RECORD_TYPE_DELETE,
+	SEARCH_WAL_RECORD_TYPE_UNKNOWN = -1
+} SearchWalRecordTypes;
+
+#define SEARCH_WAL_FILE_MAGIC_NUMBER					53468722
+
+#define SEARCH_WAL_SEGMENT_FILE_MAGIC_NUMBER			53468723
+
+#define SEARCH_WAL_DEFAULT_SYNC_TYPE_STRING				"interval"
+
+#define SEARCH_WAL_DEFAULT_SYNC_TYPE					\
+	SEARCH_WAL_SYNC_TYPE_INTERVAL
+
+#define SEARCH_WAL_DEFAULT_SYNC_INTERVAL_SECONDS		1.0
+
+#define SEARCH_WAL_DEFAULT_CHECKPOINT_SECONDS			60.0
+
+#define SEARCH_WAL_DEFAULT_BUFFER_LENGTH				65536
+
+
+// define search wal public data types
+
+/*
+ * The function called for each record read back from the log, in the order
+ * the records were appended; a negative return stops the replay.
+ */
+
+typedef int (*SearchWalReplayFunction)(void *context,
+		SearchWalRecordTypes type, int uid, char *payload, int payloadLength);
+
+/*
+ * Records are appended to an in-memory buffer under the mutex, and written
+ * to the log file by whichever thread commits first; a committing thread
+ * takes every pending record with it, so concurrent writers waiting on the
+ * same sync share a single write and fsync (group commit).
+ *
+ * A failed write or sync loses the records it took, so it fails the log:
+ * every later append, and every commit not already durable, returns an
+ * error until the log is reopened.
+ */
+
+typedef struct _SearchWal {
+	aboolean isOpen;
+	aboolean isCommitting;
+	aboolean isFailed;
+	SearchWalSyncTypes syncType;
+	int generation;
+	int bufferRef;
+	int bufferLength;
+	int spareLength;
+	int dirtyUidRef;
+	int dirtyUidLength;
+	int *dirtyUids;
+	alint appendTicket;
+	alint commitTicket;
+	alint syncTicket;
+	alint recordsWritten;
+	alint commitsWritten;
+	alint syncsWritten;
+	double syncIntervalSeconds;
+	double lastSyncTime;
+	char *path;
+	char *buffer;
+	char *spare;
+	FileHandle fh;
+	Log *log;
+	Mutex mutex;
+} SearchWal;
+
+
+// delcare search wal public functions
+
+int searchWal_init(SearchWal *wal, Log *log);
+
+int searchWal_free(SearchWal *wal);
+
+char *searchWal_syncTypeToString(SearchWalSyncTypes type);
+
+SearchWalSyncTypes searchWal_stringToSyncType(char *string);
+
+int searchWal_setSyncType(SearchWal *wal, SearchWalSyncTypes syncType,
+		double syncIntervalSeconds);
+
+aboolean searchWal_isOpen(SearchWal *wal);
+
+aboolean searchWal_isDirty(SearchWal *wal);
+
+int searchWal_open(SearchWal *wal, char *path);
+
+int searchWal_close(SearchWal *wal);
+
+int searchWal_append(SearchWal *wal, SearchWalRecordTypes type, int uid,
+		char *payload, int payloadLength, alint *ticket);
+
+int searchWal_commit(SearchWal *wal, alint ticket, aboolean isSync);
+
+int searchWal_sync(SearchWal *wal, alint ticket);
+
+int searchWal_flush(SearchWal *wal);
+
+int *searchWal_rotate(SearchWal *wal, int *generation, int *uidLength);
+
+int searchWal_writeSegmentBegin(SearchWal *wal, int generation,
+		FileHandle *fh);
+
+int searchWal_writeSegmentRecord(FileHandle *fh, SearchWalRecordTypes type,
+		int uid, char *payload, int payloadLength);
+
+int searchWal_writeSegmentEnd(SearchWal *wal, int generation,
+		FileHandle *fh);
+
+int searchWal_removeGenerations(SearchWal *wal, int generation);
+
+int searchWal_replay(SearchWal *wal, int generation,
+		SearchWalReplayFunction function, void *context);
+
+int searchWal_syncFileHandle(FileHandle *fh);
+
+
+#if defined(__cplusplus)
+};
+#endif // __cplusplus
+
+#endif // _SEARCH_SYSTEM_SEARCH_WAL_H
+
@@ -0,0 +1,413 @@
+/*
+ * search_batch_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The batched indexing of the search-engine bulk-put & command queue, unit
+ * test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define search batch unit test constants
+
+#define BATCH_UNIT_TEST_PATH							"assets/data/test/batch"
+
+#define BATCH_UNIT_TEST_CONTAINERS						\
+	BATCH_UNIT_TEST_PATH "/searchd.00.containers"
+
+#define BULK_UNIT_TEST_LENGTH							2500
+
+#define BULK_UNIT_TEST_NAME_RANGE						10
+
+#define BULK_UNIT_TEST_THREAD_POOL_SIZE					4
+
+#define BULK_UNIT_TEST_MAX_CONTAINER_MEMORY				(16 * 1024 * 1024)
+
+#define REPLAY_UNIT_TEST_RECORD_LENGTH					5
+
+#define REPLAY_UNIT_TEST_TIMEOUT_SECONDS				10.0
+
+
+// declare search batch unit test private functions
+
+static int resetPath();
+
+static int buildEngine(SearchEngine *engine, Log *log);
+
+static Container *buildContainer(char *name, int value);
+
+static int countExact(SearchEngine *engine, char *value, int *uid);
+
+static int waitForQueue(SearchEngine *engine, alint target);
+
+static int searchBatch_bulkPutUnitTest(Log *log);
+
+static int searchBatch_replayOrderUnitTest(Log *log);
+
+
+// main
+
+int main()
+{
+	Log log;
+
+	signal_registerDefault();
+
+	printf("[unit] Search Batch unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	log_init(&log, LOG_OUTPUT_STDOUT, NULL, LOG_LEVEL_ERROR);
+
+	if(searchBatch_bulkPutUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchBatch_replayOrderUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	resetPath();
+
+	log_free(&log);
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define search batch unit test private functions
+
+static int resetPath()
+{
+	aboolean exists = afalse;
+	char *filename = NULL;
+	char buffer[1024];
+
+	DirHandle dir;
+
+	if((system_dirExists(BATCH_UNIT_TEST_PATH, &exists) < 0) || (!exists)) {
+		return system_dirCreate(BATCH_UNIT_TEST_PATH);
+	}
+
+	if(dir_init(&dir, BATCH_UNIT_TEST_PATH) < 0) {
+		return -1;
+	}
+
+	while(dir_read(&dir, &filename) == 0) {
+		if(!strncmp(filename, "searchd.", 8)) {
+			snprintf(buffer, ((int)sizeof(buffer) - 1), "%s/%s",
+					BATCH_UNIT_TEST_PATH, filename);
+			system_fileDelete(buffer);
+		}
+
+		free(filename);
+	}
+
+	dir_free(&dir);
+
+	return 0;
+}
+
+static int buildEngine(SearchEngine *engine, Log *log)
+{
+	if(searchEngine_init(engine, log) < 0) {
+		return -1;
+	}
+
+	// hold every container, so that none is evicted from the cache
+
+	if((searchEngine_setMaxContainerCount(engine,
+					(BULK_UNIT_TEST_LENGTH * 2)) < 0) ||
+			(searchEngine_setMaxContainerMemoryLength(engine,
+					BULK_UNIT_TEST_MAX_CONTAINER_MEMORY) < 0)) {
+		return -1;
+	}
+
+	if((searchEngine_newIndex(engine, INDEX_REGISTRY_TYPE_EXACT,
+					"exactIndex", "Exact Index") < 0) ||
+			(searchEngine_newIndex(engine, INDEX_REGISTRY_TYPE_RANGE,
+					"rangeIndex", "Range Index") < 0)) {
+		return -1;
+	}
+
+	if(searchEngine_newDomain(engine, "default", "Default Domain") < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static Container *buildContainer(char *name, int value)
+{
+	Container *result = NULL;
+
+	result = container_newWithName(name, strlen(name));
+
+	container_putString(result, "exactIndex", strlen("exactIndex"), name,
+			strlen(name));
+	container_putInteger(result, "rangeIndex", strlen("rangeIndex"), value);
+
+	return result;
+}
+
+static int countExact(SearchEngine *engine, char *value, int *uid)
+{
+	int result = 0;
+
+	Intersect intersect;
+
+	intersect_init(&intersect);
+
+	if(searchEngine_search(engine, "default", "exactIndex", value,
+				&intersect) < 0) {
+		intersect_free(&intersect);
+		return -1;
+	}
+
+	intersect_execAnd(&intersect, atrue);
+
+	result = intersect.result.length;
+
+	if((uid != NULL) && (result > 0)) {
+		*uid = intersect.result.array[0];
+	}
+
+	intersect_free(&intersect);
+
+	return result;
+}
+
+static int waitForQueue(SearchEngine *engine, alint target)
+{
+	alint executed = 0;
+	double timer = 0.0;
+
+	timer = time_getTimeMus();
+
+	do {
+		mutex_lock(&engine->queueMutex);
+		executed = engine->queueExecutedCount;
+		mutex_unlock(&engine->queueMutex);
+
+		if(executed >= target) {
+			return 0;
+		}
+
+		time_usleep(1024);
+	} while(time_getElapsedMusInSeconds(timer) <
+			REPLAY_UNIT_TEST_TIMEOUT_SECONDS);
+
+	return -1;
+}
+
+static int searchBatch_bulkPutUnitTest(Log *log)
+{
+	int ii = 0;
+	int uid = 0;
+	int nameCount = 0;
+	char buffer[128];
+
+	Intersect intersect;
+	SearchEngine engine;
+	Container **containers = NULL;
+
+	printf("[unit]\t search batch bulk-put unit test...\n");
+
+	if((buildEngine(&engine, log) < 0) ||
+			(searchEngine_setQueryThreadPoolSize(&engine,
+					BULK_UNIT_TEST_THREAD_POOL_SIZE) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// the last container replaces the one before it, within the same batch,
+	// so that the pending index job of the replaced container is dropped
+
+	containers = (Container **)malloc(sizeof(Container *) *
+			(BULK_UNIT_TEST_LENGTH + 1));
+
+	for(ii = 0; ii < BULK_UNIT_TEST_LENGTH; ii++) {
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "name%02i",
+				(ii % BULK_UNIT_TEST_NAME_RANGE));
+
+		containers[ii] = buildContainer(buffer, ii);
+	}
+
+	containers[BULK_UNIT_TEST_LENGTH] = buildContainer("replaced", -1);
+
+	container_setUid(containers[BULK_UNIT_TEST_LENGTH], BULK_UNIT_TEST_LENGTH);
+
+	if(searchEngine_putBulk(&engine, "default", containers,
+				(BULK_UNIT_TEST_LENGTH + 1)) != (BULK_UNIT_TEST_LENGTH + 1)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(containers);
+
+	// every container is searchable once the bulk-put returns
+
+	intersect_init(&intersect);
+
+	if(searchEngine_searchRange(&engine, "default", "rangeIndex",
+				RANGE_INDEX_SEARCH_BETWEEN, -2, BULK_UNIT_TEST_LENGTH,
+				&intersect) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_execAnd(&intersect, atrue);
+
+	if(intersect.result.length != BULK_UNIT_TEST_LENGTH) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_free(&intersect);
+
+	nameCount = (BULK_UNIT_TEST_LENGTH / BULK_UNIT_TEST_NAME_RANGE);
+
+	for(ii = 0; ii < (BULK_UNIT_TEST_NAME_RANGE - 1); ii++) {
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "name%02i", ii);
+
+		if(countExact(&engine, buffer, NULL) != nameCount) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	// the replaced container holds none of the indexes of the first
+
+	snprintf(buffer, ((int)sizeof(buffer) - 1), "name%02i",
+			(BULK_UNIT_TEST_NAME_RANGE - 1));
+
+	if((countExact(&engine, buffer, NULL) != (nameCount - 1)) ||
+			(countExact(&engine, "replaced", &uid) != 1) ||
+			(uid != BULK_UNIT_TEST_LENGTH)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchEngine_free(&engine) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int searchBatch_replayOrderUnitTest(Log *log)
+{
+	int uid = 0;
+
+	SearchEngine engine;
+	Container *container = NULL;
+
+	printf("[unit]\t search batch replay order unit test...\n");
+
+	if(resetPath() < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// write a put, a replacement & a delete of the same UIDs to the log,
+	// behind an empty snapshot
+
+	if((buildEngine(&engine, log) < 0) ||
+			(searchEngine_setIndexBackupAttributes(&engine, 0.0,
+					BATCH_UNIT_TEST_PATH) < 0) ||
+			(searchEngine_setWalAttributes(&engine,
+					SEARCH_WAL_SYNC_TYPE_ALWAYS, 0.0, 0.0) < 0) ||
+			(searchEngine_backupData(&engine) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((searchEngine_put(&engine, "default",
+					buildContainer("alpha", 1), atrue) != 1) ||
+			(searchEngine_put(&engine, "default",
+					buildContainer("gamma", 2), atrue) != 2)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	container = buildContainer("beta", 3);
+
+	container_setUid(container, 1);
+
+	if((searchEngine_put(&engine, "default", container, atrue) != 1) ||
+			(searchEngine_delete(&engine, 2) != 2) ||
+			(searchEngine_put(&engine, "default",
+					buildContainer("delta", 4), atrue) != 3)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchEngine_free(&engine) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// the replayed records are queued together, so that the worker applies
+	// the put, replacement & delete of each UID within a batch
+
+	if((buildEngine(&engine, log) < 0) ||
+			(searchEngine_setIndexBackupAttributes(&engine, 0.0,
+					BATCH_UNIT_TEST_PATH) < 0) ||
+			(searchEngine_setWalAttributes(&engine,
+					SEARCH_WAL_SYNC_TYPE_ALWAYS, 0.0, 0.0) < 0) ||
+			(searchEngine_restoreData(&engine,
+					BATCH_UNIT_TEST_CONTAINERS) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(waitForQueue(&engine, REPLAY_UNIT_TEST_RECORD_LENGTH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((countExact(&engine, "alpha", NULL) != 0) ||
+			(countExact(&engine, "gamma", NULL) != 0) ||
+			(countExact(&engine, "beta", &uid) != 1) ||
+			(uid != 1) ||
+			(countExact(&engine, "delta", &uid) != 1) ||
+			(uid != 3)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchEngine_free(&engine) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	return 0;
+}
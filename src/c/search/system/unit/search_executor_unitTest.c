@@ -0,0 +1,293 @@
+/*
+ * search_executor_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The query executor component for the search-engine, a shared thread pool
+ * which runs the independent parts of a query in parallel, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define search executor unit test constants
+
+#define BASIC_UNIT_TEST_THREAD_POOL_SIZE				4
+
+#define BASIC_UNIT_TEST_LENGTH							1024
+
+#define BASIC_UNIT_TEST_ITERATIONS						32
+
+#define STEAL_UNIT_TEST_LENGTH							64
+
+#define STEAL_UNIT_TEST_TASK_MICROS						1024
+
+
+// declare search executor unit test private functions
+
+static void countTask(void *argument);
+
+static void sleepTask(void *argument);
+
+static int searchExecutor_basicUnitTest(Log *log);
+
+static int searchExecutor_inlineUnitTest(Log *log);
+
+static int searchExecutor_stealUnitTest(Log *log);
+
+
+// main
+
+int main()
+{
+	Log log;
+
+	signal_registerDefault();
+
+	printf("[unit] Search Executor unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	log_init(&log, LOG_OUTPUT_STDOUT, NULL, LOG_LEVEL_INFO);
+
+	if(searchExecutor_basicUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchExecutor_inlineUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchExecutor_stealUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	log_free(&log);
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define search executor unit test private functions
+
+static void countTask(void *argument)
+{
+	int *counter = (int *)argument;
+
+	*counter += 1;
+}
+
+static void sleepTask(void *argument)
+{
+	int *counter = (int *)argument;
+
+	time_usleep(STEAL_UNIT_TEST_TASK_MICROS);
+
+	*counter += 1;
+}
+
+static int searchExecutor_basicUnitTest(Log *log)
+{
+	int ii = 0;
+	int nn = 0;
+	int counters[BASIC_UNIT_TEST_LENGTH];
+	void *arguments[BASIC_UNIT_TEST_LENGTH];
+
+	SearchExecutor executor;
+
+	printf("[unit]\t search executor basic unit test...\n");
+
+	if(searchExecutor_init(&executor, BASIC_UNIT_TEST_THREAD_POOL_SIZE,
+				log) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		counters[ii] = 0;
+		arguments[ii] = (void *)&counters[ii];
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_ITERATIONS; ii++) {
+		if(searchExecutor_execute(&executor, countTask, arguments,
+					BASIC_UNIT_TEST_LENGTH) < 0) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		// every task must have run exactly once, and be complete on return
+
+		for(nn = 0; nn < BASIC_UNIT_TEST_LENGTH; nn++) {
+			if(counters[nn] != (ii + 1)) {
+				fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+						__FUNCTION__, __LINE__);
+				return -1;
+			}
+		}
+	}
+
+	if(executor.tasksExecuted !=
+			(BASIC_UNIT_TEST_LENGTH * BASIC_UNIT_TEST_ITERATIONS)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t\t tasks executed                 : %lli\n",
+			executor.tasksExecuted);
+	printf("[unit]\t\t tasks stolen                   : %lli\n",
+			executor.tasksStolen);
+
+	if(searchExecutor_free(&executor) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchExecutor_inlineUnitTest(Log *log)
+{
+	int ii = 0;
+	int counters[BASIC_UNIT_TEST_LENGTH];
+	void *arguments[BASIC_UNIT_TEST_LENGTH];
+
+	SearchExecutor executor;
+
+	printf("[unit]\t search executor inline unit test...\n");
+
+	if(searchExecutor_init(&executor, 0, log) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		counters[ii] = 0;
+		arguments[ii] = (void *)&counters[ii];
+	}
+
+	if(searchExecutor_execute(&executor, countTask, arguments,
+				BASIC_UNIT_TEST_LENGTH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		if(counters[ii] != 1) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	if(executor.tasksStolen != 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchExecutor_execute(&executor, countTask, arguments, 0) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchExecutor_execute(NULL, countTask, arguments, 1) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchExecutor_free(&executor) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchExecutor_stealUnitTest(Log *log)
+{
+	int ii = 0;
+	int counters[STEAL_UNIT_TEST_LENGTH];
+	double timer = 0.0;
+	void *arguments[STEAL_UNIT_TEST_LENGTH];
+
+	SearchExecutor executor;
+
+	printf("[unit]\t search executor steal unit test...\n");
+
+	if(searchExecutor_init(&executor, BASIC_UNIT_TEST_THREAD_POOL_SIZE,
+				log) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < STEAL_UNIT_TEST_LENGTH; ii++) {
+		counters[ii] = 0;
+		arguments[ii] = (void *)&counters[ii];
+	}
+
+	timer = time_getTimeMus();
+
+	if(searchExecutor_execute(&executor, sleepTask, arguments,
+				STEAL_UNIT_TEST_LENGTH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t\t batch time                     : %0.6f seconds\n",
+			time_getElapsedMusInSeconds(timer));
+
+	for(ii = 0; ii < STEAL_UNIT_TEST_LENGTH; ii++) {
+		if(counters[ii] != 1) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	// with every task sleeping, idle pool threads must have stolen work
+
+	printf("[unit]\t\t tasks stolen                   : %lli\n",
+			executor.tasksStolen);
+
+	if(executor.tasksStolen < 1) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchExecutor_free(&executor) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
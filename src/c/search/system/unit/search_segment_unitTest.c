@@ -0,0 +1,715 @@
+/*
+ * search_segment_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The index segment component for the search-engine, an immutable on-disk
+ * snapshot of the search indexes which is memory-mapped and searched in
+ * place, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define search segment unit test constants
+
+#define SEGMENT_UNIT_TEST_PATH						"assets/data/test/segment"
+
+#define BASIC_UNIT_TEST_LENGTH							256
+
+#define BASIC_UNIT_TEST_GENERATION						7
+
+
+// declare search segment unit test private functions
+
+static int resetPath();
+
+static void buildTypes(IndexRegistryIndex *types);
+
+static int buildIndex(SearchIndex *index, IndexRegistryIndex *types,
+		aboolean isPopulated);
+
+static int updateUid(SearchIndex *index, IndexRegistryIndex *types, int uid,
+		aboolean isPut);
+
+static int compareResults(int *left, int leftLength, int *right,
+		int rightLength);
+
+static int compareIndexes(SearchIndex *expected, SearchIndex *actual,
+		IndexRegistryIndex *types);
+
+static int writeSegment(SearchIndex *index, char *filename, int generation);
+
+static int searchSegment_basicUnitTest();
+
+static int searchSegment_maskUnitTest();
+
+static int searchSegment_invalidFileUnitTest();
+
+
+// main
+
+int main()
+{
+	signal_registerDefault();
+
+	printf("[unit] Search Segment unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	if(resetPath() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchSegment_basicUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchSegment_maskUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchSegment_invalidFileUnitTest() < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	resetPath();
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define search segment unit test private functions
+
+static int resetPath()
+{
+	aboolean exists = afalse;
+	char *filename = NULL;
+	char buffer[1024];
+
+	DirHandle dir;
+
+	if((system_dirExists(SEGMENT_UNIT_TEST_PATH, &exists) < 0) || (!exists)) {
+		return system_dirCreate(SEGMENT_UNIT_TEST_PATH);
+	}
+
+	if(dir_init(&dir, SEGMENT_UNIT_TEST_PATH) < 0) {
+		return -1;
+	}
+
+	while(dir_read(&dir, &filename) == 0) {
+		if(!strncmp(filename, "searchd.", 8)) {
+			snprintf(buffer, ((int)sizeof(buffer) - 1), "%s/%s",
+					SEGMENT_UNIT_TEST_PATH, filename);
+			system_fileDelete(buffer);
+		}
+
+		free(filename);
+	}
+
+	dir_free(&dir);
+
+	return 0;
+}
+
+static void buildTypes(IndexRegistryIndex *types)
+{
+	memset(types, 0, (int)(sizeof(IndexRegistryIndex) * 4));
+
+	types[0].type = INDEX_REGISTRY_TYPE_EXACT;
+	types[0].uid = 0;
+	types[0].key = "exactIndex";
+	types[0].name = "Exact Index";
+
+	types[1].type = INDEX_REGISTRY_TYPE_WILDCARD;
+	types[1].uid = 1;
+	types[1].key = "wildcardIndex";
+	types[1].name = "Wildcard Index";
+
+	types[2].type = INDEX_REGISTRY_TYPE_RANGE;
+	types[2].uid = 2;
+	types[2].key = "rangeIndex";
+	types[2].name = "Range Index";
+
+	types[3].type = INDEX_REGISTRY_TYPE_USER_KEY;
+	types[3].uid = 3;
+	types[3].key = "myUid";
+	types[3].name = "A user-defined UID index";
+}
+
+static int buildIndex(SearchIndex *index, IndexRegistryIndex *types,
+		aboolean isPopulated)
+{
+	int ii = 0;
+
+	if(searchIndex_init(index, 3, 18, "testDomain", "Test Domain") < 0) {
+		return -1;
+	}
+
+	for(ii = 0; ii < 4; ii++) {
+		if(searchIndex_newIndex(index, &(types[ii])) < 0) {
+			return -1;
+		}
+	}
+
+	if(!isPopulated) {
+		return 0;
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		if(updateUid(index, types, ii, atrue) < 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int updateUid(SearchIndex *index, IndexRegistryIndex *types, int uid,
+		aboolean isPut)
+{
+	int result = 0;
+	char exact[64];
+	char wildcard[64];
+	char user[64];
+
+	snprintf(exact, ((int)sizeof(exact) - 1), "exact value %02i", (uid % 16));
+	snprintf(wildcard, ((int)sizeof(wildcard) - 1), "wildcard term %03i",
+			(uid % 32));
+	snprintf(user, ((int)sizeof(user) - 1), "user-%04i", uid);
+
+	if(isPut) {
+		result |= searchIndex_putString(index, &(types[0]), exact, uid);
+		result |= searchIndex_putString(index, &(types[1]), wildcard, uid);
+		result |= searchIndex_putInteger(index, &(types[2]), (uid % 64),
+				uid);
+		result |= searchIndex_putString(index, &(types[3]), user, uid);
+	}
+	else {
+		result |= searchIndex_removeString(index, &(types[0]), exact, uid);
+		result |= searchIndex_removeString(index, &(types[1]), wildcard, uid);
+		result |= searchIndex_removeInteger(index, &(types[2]), (uid % 64),
+				uid);
+		result |= searchIndex_removeString(index, &(types[3]), user, uid);
+	}
+
+	return ((result != 0) ? -1 : 0);
+}
+
+static int compareResults(int *left, int leftLength, int *right,
+		int rightLength)
+{
+	int result = 0;
+
+	if(leftLength != rightLength) {
+		result = -1;
+	}
+	else if((leftLength > 0) &&
+			((left == NULL) || (right == NULL) ||
+			 (memcmp(left, right, (sizeof(int) * leftLength))))) {
+		result = -1;
+	}
+
+	if(left != NULL) {
+		free(left);
+	}
+
+	if(right != NULL) {
+		free(right);
+	}
+
+	return result;
+}
+
+static int compareIndexes(SearchIndex *expected, SearchIndex *actual,
+		IndexRegistryIndex *types)
+{
+	int ii = 0;
+	int leftLength = 0;
+	int rightLength = 0;
+	int *left = NULL;
+	int *right = NULL;
+	char buffer[64];
+
+	// exact & user-key values
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "exact value %02i",
+				(ii % 16));
+
+		left = searchIndex_getString(expected, &(types[0]), buffer,
+				&leftLength);
+		right = searchIndex_getString(actual, &(types[0]), buffer,
+				&rightLength);
+
+		if(compareResults(left, leftLength, right, rightLength) < 0) {
+			fprintf(stderr, "[%s():%i] error - mismatch on '%s'.\n",
+					__FUNCTION__, __LINE__, buffer);
+			return -1;
+		}
+
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "user-%04i", ii);
+
+		left = searchIndex_getString(expected, &(types[3]), buffer,
+				&leftLength);
+		right = searchIndex_getString(actual, &(types[3]), buffer,
+				&rightLength);
+
+		if(compareResults(left, leftLength, right, rightLength) < 0) {
+			fprintf(stderr, "[%s():%i] error - mismatch on '%s'.\n",
+					__FUNCTION__, __LINE__, buffer);
+			return -1;
+		}
+	}
+
+	// wildcard prefixes & suffixes
+
+	for(ii = 0; ii < 32; ii++) {
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "wildcard term %02i",
+				(ii % 4));
+
+		left = searchIndex_getString(expected, &(types[1]), buffer,
+				&leftLength);
+		right = searchIndex_getString(actual, &(types[1]), buffer,
+				&rightLength);
+
+		if(compareResults(left, leftLength, right, rightLength) < 0) {
+			fprintf(stderr, "[%s():%i] error - mismatch on '%s'.\n",
+					__FUNCTION__, __LINE__, buffer);
+			return -1;
+		}
+
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "term %03i", ii);
+
+		left = searchIndex_getString(expected, &(types[1]), buffer,
+				&leftLength);
+		right = searchIndex_getString(actual, &(types[1]), buffer,
+				&rightLength);
+
+		if(compareResults(left, leftLength, right, rightLength) < 0) {
+			fprintf(stderr, "[%s():%i] error - mismatch on '%s'.\n",
+					__FUNCTION__, __LINE__, buffer);
+			return -1;
+		}
+	}
+
+	// ranges
+
+	for(ii = -4; ii < 72; ii += 4) {
+		left = searchIndex_getRange(expected, &(types[2]),
+				RANGE_INDEX_SEARCH_GREATER_THAN, ii, 0, &leftLength);
+		right = searchIndex_getRange(actual, &(types[2]),
+				RANGE_INDEX_SEARCH_GREATER_THAN, ii, 0, &rightLength);
+
+		if(compareResults(left, leftLength, right, rightLength) < 0) {
+			fprintf(stderr, "[%s():%i] error - mismatch on > %i.\n",
+					__FUNCTION__, __LINE__, ii);
+			return -1;
+		}
+
+		left = searchIndex_getRange(expected, &(types[2]),
+				RANGE_INDEX_SEARCH_LESS_THAN, ii, 0, &leftLength);
+		right = searchIndex_getRange(actual, &(types[2]),
+				RANGE_INDEX_SEARCH_LESS_THAN, ii, 0, &rightLength);
+
+		if(compareResults(left, leftLength, right, rightLength) < 0) {
+			fprintf(stderr, "[%s():%i] error - mismatch on < %i.\n",
+					__FUNCTION__, __LINE__, ii);
+			return -1;
+		}
+
+		left = searchIndex_getRange(expected, &(types[2]),
+				RANGE_INDEX_SEARCH_BETWEEN, ii, (ii + 6), &leftLength);
+		right = searchIndex_getRange(actual, &(types[2]),
+				RANGE_INDEX_SEARCH_BETWEEN, ii, (ii + 6), &rightLength);
+
+		if(compareResults(left, leftLength, right, rightLength) < 0) {
+			fprintf(stderr, "[%s():%i] error - mismatch on %i - %i.\n",
+					__FUNCTION__, __LINE__, ii, (ii + 6));
+			return -1;
+		}
+	}
+
+	// index statistics
+
+	for(ii = 0; ii < 4; ii++) {
+		if(searchIndex_getIndexCount(expected, &(types[ii])) !=
+				searchIndex_getIndexCount(actual, &(types[ii]))) {
+			fprintf(stderr, "[%s():%i] error - count mismatch on '%s'.\n",
+					__FUNCTION__, __LINE__, types[ii].key);
+			return -1;
+		}
+
+		if(searchIndex_getIndexValueCount(expected, &(types[ii])) !=
+				searchIndex_getIndexValueCount(actual, &(types[ii]))) {
+			fprintf(stderr, "[%s():%i] error - value count mismatch on "
+					"'%s'.\n", __FUNCTION__, __LINE__, types[ii].key);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int writeSegment(SearchIndex *index, char *filename, int generation)
+{
+	SearchSegmentWriter writer;
+
+	if(searchSegmentWriter_init(&writer, filename, generation) < 0) {
+		return -1;
+	}
+
+	if(searchIndex_writeSegment(index, &writer) < 0) {
+		searchSegmentWriter_free(&writer, afalse);
+		return -1;
+	}
+
+	return searchSegmentWriter_free(&writer, atrue);
+}
+
+static int searchSegment_basicUnitTest()
+{
+	int ii = 0;
+	char filename[1024];
+
+	SearchIndex expected;
+	SearchIndex actual;
+	SearchSegment segment;
+	IndexRegistryIndex types[4];
+
+	printf("[unit]\t search segment basic unit test...\n");
+
+	buildTypes(types);
+
+	snprintf(filename, ((int)sizeof(filename) - 1), "%s/searchd.00.indexes",
+			SEGMENT_UNIT_TEST_PATH);
+
+	// write a segment from a populated index
+
+	if(buildIndex(&expected, types, atrue) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(writeSegment(&expected, filename, BASIC_UNIT_TEST_GENERATION) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// open the segment & check its sections
+
+	searchSegment_init(&segment);
+
+	if(searchSegment_open(&segment, filename) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((!searchSegment_isOpen(&segment)) ||
+			(segment.generation != BASIC_UNIT_TEST_GENERATION) ||
+			(segment.header->sectionLength != 4)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < 4; ii++) {
+		if(searchSegment_getSection(&segment, "testDomain", types[ii].key,
+					types[ii].type) == NULL) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	if((searchSegment_getSection(&segment, "otherDomain", types[0].key,
+					types[0].type) != NULL) ||
+			(searchSegment_getSection(&segment, "testDomain", types[0].key,
+					types[1].type) != NULL)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// an empty index with the segment attached answers as the original
+
+	if(buildIndex(&actual, types, afalse) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchIndex_attachSegment(&actual, &segment) != 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(compareIndexes(&expected, &actual, types) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// cleanup
+
+	searchIndex_free(&actual);
+	searchIndex_free(&expected);
+	searchSegment_free(&segment);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchSegment_maskUnitTest()
+{
+	int ii = 0;
+	int uidLength = 0;
+	int *uids = NULL;
+	char filename[1024];
+	char rewriteFilename[1024];
+
+	SearchIndex expected;
+	SearchIndex actual;
+	SearchIndex rewritten;
+	SearchSegment segment;
+	SearchSegment rewriteSegment;
+	IndexRegistryIndex types[4];
+
+	printf("[unit]\t search segment mask unit test...\n");
+
+	buildTypes(types);
+
+	snprintf(filename, ((int)sizeof(filename) - 1), "%s/searchd.00.indexes",
+			SEGMENT_UNIT_TEST_PATH);
+	snprintf(rewriteFilename, ((int)sizeof(rewriteFilename) - 1),
+			"%s/searchd.01.indexes", SEGMENT_UNIT_TEST_PATH);
+
+	if((buildIndex(&expected, types, atrue) < 0) ||
+			(buildIndex(&actual, types, afalse) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchSegment_init(&segment);
+
+	if((searchSegment_open(&segment, filename) < 0) ||
+			(searchIndex_attachSegment(&actual, &segment) != 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// remove every fourth UID, & re-index every eighth one
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii += 4) {
+		if((updateUid(&expected, types, ii, afalse) < 0) ||
+				(updateUid(&actual, types, ii, afalse) < 0)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii += 8) {
+		if((updateUid(&expected, types, ii, atrue) < 0) ||
+				(updateUid(&actual, types, ii, atrue) < 0)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	if((uids = searchIndex_getString(&actual, &(types[3]), "user-0004",
+					&uidLength)) != NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(((uids = searchIndex_getString(&actual, &(types[3]), "user-0008",
+						&uidLength)) == NULL) ||
+			(uidLength != 1) || (uids[0] != 8)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	free(uids);
+
+	// a user key held by an unmasked segment UID stays unique
+
+	if(searchIndex_putString(&actual, &(types[3]), "user-0001", 1024) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(compareIndexes(&expected, &actual, types) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a segment written from the merged index round-trips
+
+	if(writeSegment(&actual, rewriteFilename,
+				(BASIC_UNIT_TEST_GENERATION + 1)) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchSegment_init(&rewriteSegment);
+
+	if((buildIndex(&rewritten, types, afalse) < 0) ||
+			(searchSegment_open(&rewriteSegment, rewriteFilename) < 0) ||
+			(rewriteSegment.generation != (BASIC_UNIT_TEST_GENERATION + 1)) ||
+			(searchIndex_attachSegment(&rewritten, &rewriteSegment) != 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(compareIndexes(&expected, &rewritten, types) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a detached index is left with its delta alone
+
+	if(searchIndex_detachSegment(&rewritten) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((uids = searchIndex_getString(&rewritten, &(types[3]), "user-0001",
+					&uidLength)) != NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// cleanup
+
+	searchIndex_free(&rewritten);
+	searchIndex_free(&actual);
+	searchIndex_free(&expected);
+	searchSegment_free(&rewriteSegment);
+	searchSegment_free(&segment);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchSegment_invalidFileUnitTest()
+{
+	alint length = 0;
+	char *data = NULL;
+	char filename[1024];
+	char buffer[256];
+
+	FileHandle fh;
+	SearchSegment segment;
+
+	printf("[unit]\t search segment invalid file unit test...\n");
+
+	snprintf(filename, ((int)sizeof(filename) - 1), "%s/searchd.02.indexes",
+			SEGMENT_UNIT_TEST_PATH);
+
+	// a missing file
+
+	searchSegment_init(&segment);
+
+	if(searchSegment_open(&segment, filename) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a file without a valid header
+
+	memset(buffer, 0x5a, (int)(sizeof(buffer)));
+
+	if(file_init(&fh, filename, "wb", 0) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	file_write(&fh, buffer, (int)(sizeof(buffer)));
+	file_free(&fh);
+
+	if(searchSegment_open(&segment, filename) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a truncated segment
+
+	snprintf(buffer, ((int)sizeof(buffer) - 1), "%s/searchd.00.indexes",
+			SEGMENT_UNIT_TEST_PATH);
+
+	if((system_fileLength(buffer, &length) < 0) || (length < 64)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	length -= 16;
+	data = (char *)malloc(sizeof(char) * length);
+
+	if((file_init(&fh, buffer, "rb", 0) < 0) ||
+			(file_read(&fh, data, (int)length) != (int)length)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	file_free(&fh);
+
+	if(file_init(&fh, filename, "wb", 0) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	file_write(&fh, data, (int)length);
+	file_free(&fh);
+
+	free(data);
+
+	if((searchSegment_open(&segment, filename) == 0) ||
+			(searchSegment_isOpen(&segment))) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchSegment_free(&segment);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
@@ -0,0 +1,434 @@
+/*
+ * search_shard_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The sharded search-engine router, scatter-gather & merge, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define search shard unit test constants
+
+#define SHARD_TEST_LENGTH								512
+
+#define SHARD_TEST_SHARD_COUNT							3
+
+#define SHARD_TEST_THREAD_POOL_SIZE						2
+
+#define SHARD_TEST_NAME_RANGE							16
+
+static char *SHARD_TEST_COLORS[] = {
+	"red",
+	"green",
+	"blue",
+	"black",
+	"white"
+};
+
+static int SHARD_TEST_COLORS_LENGTH = (int)(sizeof(SHARD_TEST_COLORS) /
+		sizeof(SHARD_TEST_COLORS[0]));
+
+typedef struct _ShardTestSearch {
+	aboolean isOrdered;
+	char *name;
+	char *message;
+} ShardTestSearch;
+
+static ShardTestSearch SHARD_TEST_SEARCHES[] = {
+	{
+		afalse,
+		"AND conditions",
+		"{\"messageName\":\"search\",\"domainKeys\":[\"default\"],"
+			"\"conditions\":["
+			"{\"type\":\"exact\",\"attribute\":\"exactIndex\","
+			"\"value\":\"name03\"},"
+			"{\"type\":\"range\",\"rangeType\":\"between\","
+			"\"attribute\":\"rangeIndex\",\"minValue\":64,"
+			"\"maxValue\":448}]}"
+	},
+	{
+		afalse,
+		"AND groups",
+		"{\"messageName\":\"search\",\"domainKeys\":[\"default\"],"
+			"\"conditions\":["
+			"{\"type\":\"group\",\"conditions\":["
+			"{\"type\":\"exact\",\"attribute\":\"colorIndex\","
+			"\"value\":\"red\"},"
+			"{\"type\":\"exact\",\"attribute\":\"exactIndex\","
+			"\"value\":\"name07\"}]},"
+			"{\"type\":\"group\",\"conditions\":["
+			"{\"type\":\"range\",\"rangeType\":\"greater-than\","
+			"\"attribute\":\"rangeIndex\",\"minValue\":128,"
+			"\"maxValue\":0}]}]}"
+	},
+	{
+		afalse,
+		"OR groups",
+		"{\"messageName\":\"search\",\"domainKeys\":[\"default\"],"
+			"\"conditions\":["
+			"{\"type\":\"group\",\"intersect\":\"or\",\"conditions\":["
+			"{\"type\":\"exact\",\"attribute\":\"exactIndex\","
+			"\"value\":\"name01\"},"
+			"{\"type\":\"exact\",\"attribute\":\"exactIndex\","
+			"\"value\":\"name02\"}]},"
+			"{\"type\":\"group\",\"conditions\":["
+			"{\"type\":\"exact\",\"attribute\":\"colorIndex\","
+			"\"value\":\"blue\"}]},"
+			"{\"type\":\"groupOptions\",\"intersect\":\"or\"}]}"
+	},
+	{
+		atrue,
+		"paged sort",
+		"{\"messageName\":\"search\",\"domainKeys\":[\"default\"],"
+			"\"conditions\":["
+			"{\"type\":\"range\",\"rangeType\":\"greater-than\","
+			"\"attribute\":\"rangeIndex\",\"minValue\":16,"
+			"\"maxValue\":0}],"
+			"\"sortOptions\":{\"type\":\"attribute\","
+			"\"attribute\":\"rangeIndex\",\"direction\":\"asc\"},"
+			"\"resultOptions\":{\"offset\":40,\"limit\":20}}"
+	},
+	{
+		atrue,
+		"paged reverse sort",
+		"{\"messageName\":\"search\",\"domainKeys\":[\"default\"],"
+			"\"conditions\":["
+			"{\"type\":\"exact\",\"attribute\":\"colorIndex\","
+			"\"value\":\"green\"}],"
+			"\"sortOptions\":{\"type\":\"attribute\","
+			"\"attribute\":\"rangeIndex\",\"direction\":\"desc\"},"
+			"\"resultOptions\":{\"offset\":5,\"limit\":10}}"
+	},
+	{
+		atrue,
+		"facets",
+		"{\"messageName\":\"search\",\"domainKeys\":[\"default\"],"
+			"\"conditions\":["
+			"{\"type\":\"range\",\"rangeType\":\"between\","
+			"\"attribute\":\"rangeIndex\",\"minValue\":32,"
+			"\"maxValue\":320}],"
+			"\"sortOptions\":{\"type\":\"attribute\","
+			"\"attribute\":\"rangeIndex\",\"direction\":\"asc\"},"
+			"\"facetOptions\":{\"displayFacets\":true,"
+			"\"attributes\":[\"colorIndex\",\"exactIndex\"]}}"
+	},
+	{
+		atrue,
+		"geocoord groups",
+		"{\"messageName\":\"search\",\"domainKeys\":[\"default\"],"
+			"\"conditions\":["
+			"{\"type\":\"group\",\"intersect\":\"or\",\"conditions\":["
+			"{\"type\":\"exact\",\"attribute\":\"colorIndex\","
+			"\"value\":\"black\"},"
+			"{\"type\":\"exact\",\"attribute\":\"colorIndex\","
+			"\"value\":\"white\"}]},"
+			"{\"type\":\"group\",\"conditions\":["
+			"{\"type\":\"geocoord\",\"geoCoordType\":\"miles\","
+			"\"latitude\":40.5,\"longitude\":-104.6,\"distance\":20},"
+			"{\"type\":\"range\",\"rangeType\":\"greater-than\","
+			"\"attribute\":\"rangeIndex\",\"minValue\":8,"
+			"\"maxValue\":0}]}],"
+			"\"sortOptions\":{\"type\":\"attribute\","
+			"\"attribute\":\"rangeIndex\",\"direction\":\"asc\"}}"
+	}
+};
+
+static int SHARD_TEST_SEARCHES_LENGTH = (int)(sizeof(SHARD_TEST_SEARCHES) /
+		sizeof(SHARD_TEST_SEARCHES[0]));
+
+
+// declare search shard unit test private functions
+
+static int searchShard_buildEngine(Log *log, SearchEngine *engine,
+		int shardLength);
+
+static int searchShard_executeSearch(Log *log, SearchEngine *engine,
+		char *message, int **uids, int *uidLength, char **response);
+
+static int searchShard_compareUids(const void *left, const void *right);
+
+static int searchShard_equivalenceUnitTest(Log *log);
+
+
+// main
+
+int main()
+{
+	Log log;
+
+	signal_registerDefault();
+
+	system_pickRandomSeed();
+
+	printf("[unit] Search Shard unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	log_init(&log, LOG_OUTPUT_STDOUT, NULL, LOG_LEVEL_ERROR);
+
+	if(searchShard_equivalenceUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	log_free(&log);
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define search shard unit test private functions
+
+static int searchShard_buildEngine(Log *log, SearchEngine *engine,
+		int shardLength)
+{
+	int ii = 0;
+	char buffer[128];
+
+	Container *container = NULL;
+
+	if(searchEngine_init(engine, log) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// the searches are made without an authentication token
+
+	if(authSystem_setIsEnabled(&engine->auth, afalse) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(shardLength > 0) {
+		if((searchEngine_setShardCount(engine, shardLength) < 0) ||
+				(engine->shardLength != shardLength) ||
+				(searchEngine_setQueryThreadPoolSize(engine,
+						SHARD_TEST_THREAD_POOL_SIZE) < 0)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	if((searchEngine_newIndex(engine, INDEX_REGISTRY_TYPE_EXACT,
+					"exactIndex", "Exact Index") < 0) ||
+			(searchEngine_newIndex(engine, INDEX_REGISTRY_TYPE_EXACT,
+					"colorIndex", "Color Index") < 0) ||
+			(searchEngine_newIndex(engine, INDEX_REGISTRY_TYPE_RANGE,
+					"rangeIndex", "Range Index") < 0) ||
+			(searchEngine_newIndex(engine, INDEX_REGISTRY_TYPE_RANGE,
+					"latitude", "Latitude") < 0) ||
+			(searchEngine_newIndex(engine, INDEX_REGISTRY_TYPE_RANGE,
+					"longitude", "Longitude") < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchEngine_newDomain(engine, "default", "Default Domain") < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// the same containers are put, in the same order, into every engine, so
+	// that they receive the same UIDs; the sort attribute is unique, so that
+	// sorted results have no ties
+
+	for(ii = 0; ii < SHARD_TEST_LENGTH; ii++) {
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "name%02i",
+				(ii % SHARD_TEST_NAME_RANGE));
+
+		container = container_newWithName(buffer, strlen(buffer));
+
+		container_putString(container, "exactIndex", strlen("exactIndex"),
+				buffer, strlen(buffer));
+		container_putString(container, "colorIndex", strlen("colorIndex"),
+				SHARD_TEST_COLORS[(ii % SHARD_TEST_COLORS_LENGTH)],
+				strlen(SHARD_TEST_COLORS[(ii % SHARD_TEST_COLORS_LENGTH)]));
+		container_putInteger(container, "rangeIndex", strlen("rangeIndex"),
+				((ii * 37) % SHARD_TEST_LENGTH));
+		container_putDouble(container, "latitude", strlen("latitude"),
+				(40.0 + ((double)(ii % 23) * 0.05)));
+		container_putDouble(container, "longitude", strlen("longitude"),
+				(-105.0 + ((double)(ii % 19) * 0.05)));
+
+		if(searchEngine_put(engine, "default", container, atrue) < 0) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int searchShard_executeSearch(Log *log, SearchEngine *engine,
+		char *message, int **uids, int *uidLength, char **response)
+{
+	int length = 0;
+
+	Json *request = NULL;
+	Json *result = NULL;
+	SearchCompiler compiler;
+	SearchActionSearch *action = NULL;
+
+	*uids = NULL;
+	*uidLength = 0;
+	*response = NULL;
+
+	if((request = json_newFromString(message)) == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((searchCompiler_compileJson(&compiler, log, NULL,
+					SEARCH_ENGINE_DEFAULT_VALIDATION_TYPE, request) < 0) ||
+			(searchCompiler_execute(&compiler, engine) < 0) ||
+			(compiler.errorCode != 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	action = (SearchActionSearch *)compiler.action;
+
+	// keep the UIDs, ordered by value, to compare as a set
+
+	*uidLength = action->intersect.result.length;
+	*uids = (int *)malloc(sizeof(int) * (*uidLength + 1));
+
+	if(*uidLength > 0) {
+		memcpy(*uids, action->intersect.result.array,
+				(sizeof(int) * (*uidLength)));
+
+		qsort(*uids, *uidLength, sizeof(int), searchShard_compareUids);
+	}
+
+	if((result = searchCompiler_buildResponse(&compiler)) == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	*response = json_toString(result, &length);
+
+	json_freePtr(result);
+
+	searchCompiler_free(&compiler);
+
+	json_freePtr(request);
+
+	if(*response == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int searchShard_compareUids(const void *left, const void *right)
+{
+	return (*((int *)left) - *((int *)right));
+}
+
+static int searchShard_equivalenceUnitTest(Log *log)
+{
+	int ii = 0;
+	int nn = 0;
+	int uidLength = 0;
+	int shardUidLength = 0;
+	int *uids = NULL;
+	int *shardUids = NULL;
+	char *response = NULL;
+	char *shardResponse = NULL;
+
+	SearchEngine engine;
+	SearchEngine shardEngine;
+
+	printf("[unit]\t search shard equivalence unit test...\n");
+
+	if((searchShard_buildEngine(log, &engine, 0) < 0) ||
+			(searchShard_buildEngine(log, &shardEngine,
+					SHARD_TEST_SHARD_COUNT) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// every search must return the same results from the scattered shards,
+	// as from a single engine which holds the same containers
+
+	for(ii = 0; ii < SHARD_TEST_SEARCHES_LENGTH; ii++) {
+		printf("[unit]\t\t %s...\n", SHARD_TEST_SEARCHES[ii].name);
+
+		if((searchShard_executeSearch(log, &engine,
+						SHARD_TEST_SEARCHES[ii].message, &uids, &uidLength,
+						&response) < 0) ||
+				(searchShard_executeSearch(log, &shardEngine,
+						SHARD_TEST_SEARCHES[ii].message, &shardUids,
+						&shardUidLength, &shardResponse) < 0)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		if((uidLength < 1) || (uidLength >= SHARD_TEST_LENGTH) ||
+				(uidLength != shardUidLength)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		for(nn = 0; nn < uidLength; nn++) {
+			if(uids[nn] != shardUids[nn]) {
+				fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+						__FUNCTION__, __LINE__);
+				return -1;
+			}
+		}
+
+		if((strstr(SHARD_TEST_SEARCHES[ii].message, "facetOptions") != NULL) &&
+				(strstr(shardResponse, "facetCount") == NULL)) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		// ordered results, pages & facets must match exactly
+
+		if((SHARD_TEST_SEARCHES[ii].isOrdered) &&
+				(strcmp(response, shardResponse))) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		free(uids);
+		free(shardUids);
+		free(response);
+		free(shardResponse);
+	}
+
+	if((searchEngine_free(&engine) < 0) ||
+			(searchEngine_free(&shardEngine) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * search_sort_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The sorting component for the search-engine, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define search sort unit test constants
+
+#define PARTIAL_SORT_TEST_LENGTH						1024
+
+#define PARTIAL_SORT_TEST_VALUE_RANGE					64
+
+#define PARTIAL_SORT_TEST_LIMIT							24
+
+
+// declare search sort unit test private functions
+
+static int searchSort_partialSortUnitTest(Log *log);
+
+
+// main
+
+int main()
+{
+	Log log;
+
+	signal_registerDefault();
+
+	system_pickRandomSeed();
+
+	printf("[unit] Search Sort unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	log_init(&log, LOG_OUTPUT_STDOUT, NULL, LOG_LEVEL_ERROR);
+
+	if(searchSort_partialSortUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	log_free(&log);
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define search sort unit test private functions
+
+static int searchSort_partialSortUnitTest(Log *log)
+{
+	int ii = 0;
+	int uid = 0;
+	int last = 0;
+	int alpha = 0;
+	int beta = 0;
+	int values[PARTIAL_SORT_TEST_LENGTH + 1];
+	int names[PARTIAL_SORT_TEST_LENGTH + 1];
+	char buffer[128];
+
+	Intersect intersect;
+	Intersect partialIntersect;
+	Container *container = NULL;
+	SearchSort sort;
+	SearchEngine engine;
+
+	printf("[unit]\t search sort partial sort unit test...\n");
+
+	if(searchEngine_init(&engine, log) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchEngine_newIndex(&engine,
+				INDEX_REGISTRY_TYPE_EXACT,
+				"exactIndex",
+				"Exact Index") < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchEngine_newIndex(&engine,
+				INDEX_REGISTRY_TYPE_RANGE,
+				"rangeIndex",
+				"Range Index") < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchEngine_newDomain(&engine,
+				"default",
+				"Default Domain") < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// setup containers with a small range of values, so that sorts have ties
+
+	memset(values, 0, (int)(sizeof(values)));
+	memset(names, 0, (int)(sizeof(names)));
+
+	for(ii = 0; ii < PARTIAL_SORT_TEST_LENGTH; ii++) {
+		alpha = (rand() % PARTIAL_SORT_TEST_VALUE_RANGE);
+		beta = (rand() % PARTIAL_SORT_TEST_VALUE_RANGE);
+
+		snprintf(buffer, ((int)sizeof(buffer) - 1), "name%03i", beta);
+
+		container = container_newWithName(buffer, strlen(buffer));
+		container_putString(container, "exactIndex", strlen("exactIndex"),
+				buffer, strlen(buffer));
+		container_putInteger(container, "rangeIndex", strlen("rangeIndex"),
+				alpha);
+
+		if(searchEngine_put(&engine, "default", container, atrue) < 0) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+
+		uid = container_getUid(container);
+
+		values[uid] = alpha;
+		names[uid] = beta;
+	}
+
+	// compare a partial sort against a full sort of the same results
+
+	intersect_init(&intersect);
+	intersect_init(&partialIntersect);
+
+	if((searchEngine_searchRange(&engine, "default", "rangeIndex",
+					RANGE_INDEX_SEARCH_BETWEEN, -1,
+					(PARTIAL_SORT_TEST_VALUE_RANGE + 1), &intersect) < 0) ||
+			(searchEngine_searchRange(&engine, "default", "rangeIndex",
+					RANGE_INDEX_SEARCH_BETWEEN, -1,
+					(PARTIAL_SORT_TEST_VALUE_RANGE + 1),
+					&partialIntersect) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	intersect_execAnd(&intersect, atrue);
+	intersect_execAnd(&partialIntersect, atrue);
+
+	if((intersect.result.length != PARTIAL_SORT_TEST_LENGTH) ||
+			(partialIntersect.result.length != PARTIAL_SORT_TEST_LENGTH)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((searchSort_sortByAttributeName(&engine, "rangeIndex", &intersect,
+					afalse) < 0) ||
+			(searchSort_partialSortByAttributeName(&engine, "rangeIndex",
+					&partialIntersect, afalse,
+					PARTIAL_SORT_TEST_LIMIT) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < PARTIAL_SORT_TEST_LIMIT; ii++) {
+		if(values[intersect.result.array[ii]] !=
+				values[partialIntersect.result.array[ii]]) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	// every result must remain in the partially sorted set
+
+	for(ii = 0, uid = 0; ii < partialIntersect.result.length; ii++) {
+		uid += partialIntersect.result.array[ii];
+		uid -= intersect.result.array[ii];
+	}
+
+	if(uid != 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a limited multi-value sort orders the leading results, with the rest
+	// sorting after them
+
+	if(searchSort_mvInit(&sort, &engine, &partialIntersect) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchSort_mvSetLimit(&sort, PARTIAL_SORT_TEST_LIMIT);
+	searchSort_mvAddSortByAttributeName(&sort, "exactIndex", atrue);
+	searchSort_mvAddSortByAttributeName(&sort, "rangeIndex", afalse);
+
+	if(searchSort_mvExecute(&sort) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchSort_mvFree(&sort);
+
+	last = partialIntersect.result.array[(PARTIAL_SORT_TEST_LIMIT - 1)];
+
+	for(ii = 1; ii < PARTIAL_SORT_TEST_LENGTH; ii++) {
+		if(ii < PARTIAL_SORT_TEST_LIMIT) {
+			alpha = partialIntersect.result.array[(ii - 1)];
+		}
+		else {
+			alpha = last;
+		}
+
+		beta = partialIntersect.result.array[ii];
+
+		if((names[alpha] < names[beta]) ||
+				((names[alpha] == names[beta]) &&
+				 (values[alpha] > values[beta]))) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	intersect_free(&intersect);
+	intersect_free(&partialIntersect);
+
+	// cleanup
+
+	if(searchEngine_free(&engine) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
@@ -0,0 +1,839 @@
+/*
+ * search_wal_unitTest.c
+ *
+ * Copyright (C) 2008 - 2011 by Joshua S. English. This document is the
+ * intellectual property of Joshua S. English, all rights reserved.
+ *
+ * The write-ahead log component for the search-engine, an append-only log of
+ * container operations with group commit, and the incremental checkpoint
+ * segments which replace it, unit test.
+ *
+ * Written by Josh English.
+ */
+
+// preprocessor directives
+
+#define _CORE_COMMON_BYPASS_STD_STREAM
+#include "core/core.h"
+#include "search/search.h"
+
+
+// define search wal unit test constants
+
+#define WAL_UNIT_TEST_PATH								"assets/data/test/wal"
+
+#define BASIC_UNIT_TEST_LENGTH							256
+
+#define GROUP_UNIT_TEST_THREAD_POOL_SIZE				4
+
+#define GROUP_UNIT_TEST_LENGTH							256
+
+
+// define search wal unit test data types
+
+typedef struct _ReplayContext {
+	int counter;
+	int types[BASIC_UNIT_TEST_LENGTH];
+	int uids[BASIC_UNIT_TEST_LENGTH];
+} ReplayContext;
+
+typedef struct _GroupTask {
+	int uid;
+	int result;
+	SearchWal *wal;
+} GroupTask;
+
+
+// declare search wal unit test private functions
+
+static int resetPath();
+
+static int buildPayload(int uid, char *payload);
+
+static int replayFunction(void *context, SearchWalRecordTypes type, int uid,
+		char *payload, int payloadLength);
+
+static void groupTask(void *argument);
+
+static int searchWal_basicUnitTest(Log *log);
+
+static int searchWal_groupCommitUnitTest(Log *log);
+
+static int searchWal_checkpointUnitTest(Log *log);
+
+static int searchWal_tornRecordUnitTest(Log *log);
+
+static int searchWal_failedCommitUnitTest(Log *log);
+
+static int searchWal_failedRotateUnitTest(Log *log);
+
+
+// main
+
+int main()
+{
+	Log log;
+
+	signal_registerDefault();
+
+	printf("[unit] Search WAL unit test, using Ver %s on %s.\n",
+			ASGARD_VERSION, ASGARD_DATE);
+
+	log_init(&log, LOG_OUTPUT_STDOUT, NULL, LOG_LEVEL_INFO);
+
+	if(searchWal_basicUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchWal_groupCommitUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchWal_checkpointUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchWal_tornRecordUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchWal_failedCommitUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	if(searchWal_failedRotateUnitTest(&log) < 0) {
+		printf("[unit]\t ...FAILED\n");
+		return 1;
+	}
+
+	resetPath();
+
+	log_free(&log);
+
+	printf("[unit] ...PASSED\n");
+
+	return 0;
+}
+
+// define search wal unit test private functions
+
+static int resetPath()
+{
+	aboolean exists = afalse;
+	char *filename = NULL;
+	char buffer[1024];
+
+	DirHandle dir;
+
+	if((system_dirExists(WAL_UNIT_TEST_PATH, &exists) < 0) || (!exists)) {
+		return system_dirCreate(WAL_UNIT_TEST_PATH);
+	}
+
+	if(dir_init(&dir, WAL_UNIT_TEST_PATH) < 0) {
+		return -1;
+	}
+
+	while(dir_read(&dir, &filename) == 0) {
+		if(!strncmp(filename, "searchd.", 8)) {
+			snprintf(buffer, ((int)sizeof(buffer) - 1), "%s/%s",
+					WAL_UNIT_TEST_PATH, filename);
+			system_fileDelete(buffer);
+		}
+
+		free(filename);
+	}
+
+	dir_free(&dir);
+
+	return 0;
+}
+
+static int buildPayload(int uid, char *payload)
+{
+	return snprintf(payload, 64, "container payload #%i", uid);
+}
+
+static int replayFunction(void *context, SearchWalRecordTypes type, int uid,
+		char *payload, int payloadLength)
+{
+	char buffer[64];
+
+	ReplayContext *replay = (ReplayContext *)context;
+
+	if(replay->counter >= BASIC_UNIT_TEST_LENGTH) {
+		return -1;
+	}
+
+	if(type != SEARCH_WAL_RECORD_TYPE_DELETE) {
+		if((payloadLength != buildPayload(uid, buffer)) ||
+				(memcmp(payload, buffer, payloadLength))) {
+			return -1;
+		}
+	}
+	else if(payloadLength != 0) {
+		return -1;
+	}
+
+	replay->types[replay->counter] = (int)type;
+	replay->uids[replay->counter] = uid;
+	replay->counter += 1;
+
+	return 0;
+}
+
+static void groupTask(void *argument)
+{
+	int length = 0;
+	alint ticket = 0;
+	char payload[64];
+
+	GroupTask *task = (GroupTask *)argument;
+
+	length = buildPayload(task->uid, payload);
+
+	if(searchWal_append(task->wal, SEARCH_WAL_RECORD_TYPE_PUT, task->uid,
+				payload, length, &ticket) < 0) {
+		task->result = -1;
+		return;
+	}
+
+	task->result = searchWal_sync(task->wal, ticket);
+}
+
+static int searchWal_basicUnitTest(Log *log)
+{
+	int ii = 0;
+	int length = 0;
+	alint ticket = 0;
+	char payload[64];
+
+	SearchWal wal;
+	ReplayContext replay;
+
+	printf("[unit]\t search wal basic unit test...\n");
+
+	if(resetPath() < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_init(&wal, log) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a closed log refuses records
+
+	if(searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, 1, NULL, 0,
+				&ticket) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_open(&wal, WAL_UNIT_TEST_PATH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(wal.generation != 1) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// append a put, update & delete of each uid in turn
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		length = buildPayload(((ii / 3) + 1), payload);
+
+		if(searchWal_append(&wal, (SearchWalRecordTypes)((ii % 3) + 1),
+					((ii / 3) + 1),
+					((ii % 3) == 2) ? NULL : payload,
+					((ii % 3) == 2) ? 0 : length, &ticket) < 0) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	if(ticket != BASIC_UNIT_TEST_LENGTH) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_free(&wal) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// reopening starts a new generation, and replays the previous one
+
+	searchWal_init(&wal, log);
+
+	if(searchWal_open(&wal, WAL_UNIT_TEST_PATH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(wal.generation != 2) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	memset(&replay, 0, (int)(sizeof(ReplayContext)));
+
+	if(searchWal_replay(&wal, 0, replayFunction, (void *)&replay) !=
+			BASIC_UNIT_TEST_LENGTH) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < BASIC_UNIT_TEST_LENGTH; ii++) {
+		if((replay.types[ii] != ((ii % 3) + 1)) ||
+				(replay.uids[ii] != ((ii / 3) + 1))) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	// nothing is replayed from at or before the given generation
+
+	memset(&replay, 0, (int)(sizeof(ReplayContext)));
+
+	if(searchWal_replay(&wal, 1, replayFunction, (void *)&replay) != 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_free(&wal) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchWal_groupCommitUnitTest(Log *log)
+{
+	int ii = 0;
+	void *arguments[GROUP_UNIT_TEST_LENGTH];
+
+	SearchWal wal;
+	SearchExecutor executor;
+	GroupTask tasks[GROUP_UNIT_TEST_LENGTH];
+
+	printf("[unit]\t search wal group commit unit test...\n");
+
+	if(resetPath() < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_init(&wal, log);
+
+	if(searchWal_setSyncType(&wal, SEARCH_WAL_SYNC_TYPE_ALWAYS, 0.0) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_open(&wal, WAL_UNIT_TEST_PATH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchExecutor_init(&executor, GROUP_UNIT_TEST_THREAD_POOL_SIZE,
+				log) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	for(ii = 0; ii < GROUP_UNIT_TEST_LENGTH; ii++) {
+		tasks[ii].uid = (ii + 1);
+		tasks[ii].result = -1;
+		tasks[ii].wal = &wal;
+		arguments[ii] = (void *)&tasks[ii];
+	}
+
+	if(searchExecutor_execute(&executor, groupTask, arguments,
+				GROUP_UNIT_TEST_LENGTH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// every record is durable on return from its sync
+
+	for(ii = 0; ii < GROUP_UNIT_TEST_LENGTH; ii++) {
+		if(tasks[ii].result != 0) {
+			fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+					__FUNCTION__, __LINE__);
+			return -1;
+		}
+	}
+
+	printf("[unit]\t\t records written                : %lli\n",
+			wal.recordsWritten);
+	printf("[unit]\t\t syncs written                  : %lli\n",
+			wal.syncsWritten);
+
+	if((wal.recordsWritten != GROUP_UNIT_TEST_LENGTH) ||
+			(wal.syncTicket != GROUP_UNIT_TEST_LENGTH) ||
+			(wal.syncsWritten < 1) ||
+			(wal.syncsWritten > GROUP_UNIT_TEST_LENGTH)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchExecutor_free(&executor) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_free(&wal) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchWal_checkpointUnitTest(Log *log)
+{
+	aboolean exists = afalse;
+	int ii = 0;
+	int length = 0;
+	int generation = 0;
+	int uidLength = 0;
+	int *uids = NULL;
+	alint ticket = 0;
+	char payload[64];
+
+	SearchWal wal;
+	FileHandle fh;
+	ReplayContext replay;
+
+	printf("[unit]\t search wal checkpoint unit test...\n");
+
+	if(resetPath() < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_init(&wal, log);
+
+	if(searchWal_open(&wal, WAL_UNIT_TEST_PATH) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// uid 2 is put & updated, uid 1 is put & deleted, uid 3 is put
+
+	length = buildPayload(2, payload);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, 2, payload, length,
+			&ticket);
+	length = buildPayload(1, payload);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, 1, payload, length,
+			&ticket);
+	length = buildPayload(2, payload);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_UPDATE, 2, payload, length,
+			&ticket);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_DELETE, 1, NULL, 0,
+			&ticket);
+	length = buildPayload(3, payload);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, 3, payload, length,
+			&ticket);
+
+	// rotation hands back each dirty uid once, in order
+
+	if((uids = searchWal_rotate(&wal, &generation, &uidLength)) == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((generation != 1) || (wal.generation != 2) || (uidLength != 3) ||
+			(uids[0] != 1) || (uids[1] != 2) || (uids[2] != 3)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// the checkpoint holds one record per dirty uid, in place of the log
+
+	if(searchWal_writeSegmentBegin(&wal, generation, &fh) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_writeSegmentRecord(&fh, SEARCH_WAL_RECORD_TYPE_DELETE, uids[0],
+			NULL, 0);
+
+	for(ii = 1; ii < uidLength; ii++) {
+		length = buildPayload(uids[ii], payload);
+		searchWal_writeSegmentRecord(&fh, SEARCH_WAL_RECORD_TYPE_PUT,
+				uids[ii], payload, length);
+	}
+
+	free(uids);
+
+	if(searchWal_writeSegmentEnd(&wal, generation, &fh) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((system_fileExists(WAL_UNIT_TEST_PATH "/searchd.00000001.wal",
+					&exists) < 0) || (exists)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// the next generation replays after the checkpoint
+
+	length = buildPayload(4, payload);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, 4, payload, length,
+			&ticket);
+
+	searchWal_free(&wal);
+
+	searchWal_init(&wal, log);
+	searchWal_open(&wal, WAL_UNIT_TEST_PATH);
+
+	memset(&replay, 0, (int)(sizeof(ReplayContext)));
+
+	if(searchWal_replay(&wal, 0, replayFunction, (void *)&replay) != 4) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if((replay.types[0] != SEARCH_WAL_RECORD_TYPE_DELETE) ||
+			(replay.uids[0] != 1) ||
+			(replay.types[1] != SEARCH_WAL_RECORD_TYPE_PUT) ||
+			(replay.uids[1] != 2) ||
+			(replay.uids[2] != 3) ||
+			(replay.uids[3] != 4)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// a snapshot covering both generations makes them obsolete
+
+	if(searchWal_removeGenerations(&wal, 2) != 2) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	memset(&replay, 0, (int)(sizeof(ReplayContext)));
+
+	if(searchWal_replay(&wal, 0, replayFunction, (void *)&replay) != 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_free(&wal);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchWal_tornRecordUnitTest(Log *log)
+{
+	int ii = 0;
+	int length = 0;
+	alint ticket = 0;
+	char payload[64];
+
+	SearchWal wal;
+	FileHandle fh;
+	ReplayContext replay;
+
+	printf("[unit]\t search wal torn record unit test...\n");
+
+	if(resetPath() < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_init(&wal, log);
+	searchWal_open(&wal, WAL_UNIT_TEST_PATH);
+
+	for(ii = 0; ii < 8; ii++) {
+		length = buildPayload((ii + 1), payload);
+		searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, (ii + 1), payload,
+				length, &ticket);
+	}
+
+	searchWal_free(&wal);
+
+	// simulate a crash part-way through writing the next record
+
+	if(file_init(&fh, WAL_UNIT_TEST_PATH "/searchd.00000001.wal", "ab",
+				0) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	file_writeInt(&fh, 12345);
+	file_writeInt(&fh, 64);
+	file_write(&fh, "torn", 4);
+
+	file_free(&fh);
+
+	searchWal_init(&wal, log);
+	searchWal_open(&wal, WAL_UNIT_TEST_PATH);
+
+	memset(&replay, 0, (int)(sizeof(ReplayContext)));
+
+	if(searchWal_replay(&wal, 0, replayFunction, (void *)&replay) != 8) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_free(&wal);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchWal_failedCommitUnitTest(Log *log)
+{
+	int ii = 0;
+	int length = 0;
+	alint ticket = 0;
+	alint durableTicket = 0;
+	char payload[64];
+
+	FILE *fd = NULL;
+	FILE *readOnlyFd = NULL;
+
+	SearchWal wal;
+	ReplayContext replay;
+
+	printf("[unit]\t search wal failed commit unit test...\n");
+
+	if(resetPath() < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_init(&wal, log);
+	searchWal_setSyncType(&wal, SEARCH_WAL_SYNC_TYPE_ALWAYS, 0.0);
+	searchWal_open(&wal, WAL_UNIT_TEST_PATH);
+
+	length = buildPayload(1, payload);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, 1, payload, length,
+			&durableTicket);
+
+	if(searchWal_commit(&wal, durableTicket, atrue) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// force the next write to fail, by swapping in a read-only stream
+
+	fd = wal.fh.fd;
+
+	if((readOnlyFd = fopen(WAL_UNIT_TEST_PATH "/searchd.00000001.wal",
+					"rb")) == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	wal.fh.fd = readOnlyFd;
+
+	for(ii = 0; ii < 4; ii++) {
+		length = buildPayload((ii + 2), payload);
+		searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, (ii + 2), payload,
+				length, &ticket);
+	}
+
+	if(searchWal_commit(&wal, ticket, atrue) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	wal.fh.fd = fd;
+
+	fclose(readOnlyFd);
+
+	// a waiter on the lost batch is never acknowledged, even once the log
+	// could write again, and the log refuses new records
+
+	if((searchWal_commit(&wal, ticket, afalse) == 0) ||
+			(searchWal_sync(&wal, ticket) == 0) ||
+			(searchWal_flush(&wal) == 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_DELETE, 1, NULL, 0,
+				&ticket) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// what was durable before the failure stays acknowledged
+
+	if(searchWal_commit(&wal, durableTicket, atrue) < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_close(&wal) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	// reopening starts a new generation, which accepts records again
+
+	if((searchWal_open(&wal, WAL_UNIT_TEST_PATH) < 0) ||
+			(searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_DELETE, 1, NULL, 0,
+				&ticket) < 0) ||
+			(searchWal_commit(&wal, ticket, atrue) < 0)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	memset(&replay, 0, (int)(sizeof(ReplayContext)));
+
+	if((searchWal_replay(&wal, 0, replayFunction, (void *)&replay) != 1) ||
+			(replay.uids[0] != 1)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_free(&wal);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+
+static int searchWal_failedRotateUnitTest(Log *log)
+{
+	int length = 0;
+	int generation = 0;
+	int uidLength = 0;
+	int *uids = NULL;
+	alint ticket = 0;
+	char payload[64];
+
+	FILE *fd = NULL;
+	FILE *readOnlyFd = NULL;
+
+	SearchWal wal;
+
+	printf("[unit]\t search wal failed rotate unit test...\n");
+
+	if(resetPath() < 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_init(&wal, log);
+	searchWal_setSyncType(&wal, SEARCH_WAL_SYNC_TYPE_ALWAYS, 0.0);
+	searchWal_open(&wal, WAL_UNIT_TEST_PATH);
+
+	length = buildPayload(1, payload);
+	searchWal_append(&wal, SEARCH_WAL_RECORD_TYPE_PUT, 1, payload, length,
+			&ticket);
+
+	// force the rotation to fail, by swapping in a read-only stream
+
+	fd = wal.fh.fd;
+
+	if((readOnlyFd = fopen(WAL_UNIT_TEST_PATH "/searchd.00000001.wal",
+					"rb")) == NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	wal.fh.fd = readOnlyFd;
+
+	if((uids = searchWal_rotate(&wal, &generation, &uidLength)) != NULL) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	wal.fh.fd = fd;
+
+	fclose(readOnlyFd);
+
+	// the pending record is never acknowledged, and the failed log is never
+	// checkpointed
+
+	if((searchWal_sync(&wal, ticket) == 0) ||
+			((uids = searchWal_rotate(&wal, &generation,
+									  &uidLength)) != NULL)) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	if(searchWal_close(&wal) == 0) {
+		fprintf(stderr, "[%s():%i] error - failed here, aborting.\n",
+				__FUNCTION__, __LINE__);
+		return -1;
+	}
+
+	searchWal_free(&wal);
+
+	printf("[unit]\t ...PASSED\n");
+
+	return 0;
+}
+